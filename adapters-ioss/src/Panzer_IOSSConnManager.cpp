@@ -49,6 +49,7 @@
 #include <array>
 #include <algorithm>
 #include <limits>
+#include <numeric>
 
 // MPI includes
 #include <mpi.h>
@@ -62,6 +63,7 @@
 #include "Teuchos_TestForException.hpp"
 
 // Kokkos includes
+#include "Kokkos_Core.hpp"
 #include "Kokkos_DynRankView.hpp"
 
 // Shards includes
@@ -101,8 +103,9 @@ IOSSConnManager::IOSSConnManager(Ioss::DatabaseIO * iossMeshDB)
    : iossMeshDB_(iossMeshDB), iossRegion_(), iossNodeBlocks_(), iossElementBlocks_(),
 	 iossConnectivity_(), iossToShardsTopology_(), iossElementBlockTopologies_(),
 	 elementBlocks_(), neighborElementBlocks_(),
-	 numUniqueEdges_(0), numUniqueFaces_(0), edgeNodeToEdgeMap_(), faceNodeToFaceMap_(),
-	 elementEdgeNodes_(), elementFaceNodes_(),
+	 numUniqueEdges_(0), numUniqueFaces_(0), edgeKeys_(), faceKeys_(),
+	 edgeGids_(), faceGids_(), elementEdges_(), elementFaces_(),
+	 nodeCoordinatesDim_(-1), nodeIdToCoordinates_(), nodeCoordinates_(),
 	 elmtLidToGid_(), elmtLidToConn_(), connSize_(),
 	 connectivity_(), ownedElementCount_(0), sidesetsToAssociate_(),
 	 sidesetYieldedAssociations_(), elmtToAssociatedElmts_(), placeholder_()
@@ -187,36 +190,42 @@ void IOSSConnManager::getDofCoords(const std::string & blockId,
   localCellIds = getElementBlock(blockId);
   int numElements = localCellIds.size();
 
-  // Get the DOF Coordinates
-  std::vector<int> iossNodeBlockNodeIds;
-  std::vector<double> iossNodeBlockCoordinates;
-  std::vector<double> iossNodeCoordinates(dim);
-  std::map<GlobalOrdinal, std::vector<double>> iossNodeIdToCoordinateMap;
+  // Index the node coordinates once, later calls reuse the index
+  if (nodeCoordinatesDim_ != dim) {
+    std::vector<int> iossNodeBlockNodeIds;
+    std::vector<double> iossNodeBlockCoordinates;
+    nodeIdToCoordinates_.clear();
+    nodeCoordinates_.clear();
     for (Ioss::NodeBlock * NodeBlock : iossNodeBlocks_) {
       NodeBlock->get_field_data("ids", iossNodeBlockNodeIds);
       NodeBlock->get_field_data("mesh_model_coordinates", iossNodeBlockCoordinates);
+      nodeIdToCoordinates_.reserve(nodeIdToCoordinates_.size() + iossNodeBlockNodeIds.size());
       for (size_t node = 0; node < iossNodeBlockNodeIds.size(); ++node) {
-        for (int k = 0; k < dim; ++k) {
-          iossNodeCoordinates[k] = iossNodeBlockCoordinates[node*dim+k];
-        }
-        iossNodeIdToCoordinateMap[GlobalOrdinal(iossNodeBlockNodeIds[node])] = iossNodeCoordinates;
+        nodeIdToCoordinates_[GlobalOrdinal(iossNodeBlockNodeIds[node])] = LocalOrdinal(nodeCoordinates_.size());
+        nodeCoordinates_.insert(nodeCoordinates_.end(), iossNodeBlockCoordinates.begin()+node*dim,
+                                iossNodeBlockCoordinates.begin()+(node+1)*dim);
       }
     }
+    nodeCoordinatesDim_ = dim;
+  }
 
   Teuchos::RCP<std::vector<GlobalOrdinal>> blockConnectivity;
   Kokkos::DynRankView<double,PHX::Device> vertices("vertices",numElements,cornerNodesPerElement,dim);
+  auto vertices_h = Kokkos::create_mirror_view(vertices);
 
   blockConnectivity = iossConnectivity_.find(blockId)->second;
   const Ioss::ElementTopology * iossElementBlockTopology = iossElementBlockTopologies_.find(blockId)->second;
   int iossNodesPerElement = iossElementBlockTopology->number_nodes();
   for (int elmtIdxInBlock = 0; elmtIdxInBlock < numElements; ++elmtIdxInBlock) {
     for (int nodeIdxInElmt = 0; nodeIdxInElmt < cornerNodesPerElement; ++nodeIdxInElmt) {
-      iossNodeCoordinates = iossNodeIdToCoordinateMap[(*(blockConnectivity))[iossNodesPerElement*elmtIdxInBlock + iossElementBlockTopology->element_connectivity()[nodeIdxInElmt]]];
+      const GlobalOrdinal nodeId = (*(blockConnectivity))[iossNodesPerElement*elmtIdxInBlock + iossElementBlockTopology->element_connectivity()[nodeIdxInElmt]];
+      const LocalOrdinal offset = nodeIdToCoordinates_.at(nodeId);
       for (LocalOrdinal k = 0; k < dim; ++k) {
-        vertices(elmtIdxInBlock,nodeIdxInElmt,k) = iossNodeCoordinates[k];
+        vertices_h(elmtIdxInBlock,nodeIdxInElmt,k) = nodeCoordinates_[offset+k];
       }
     }
   }
+  Kokkos::deep_copy(vertices,vertices_h);
 
   // setup output array
   points = Kokkos::DynRankView<double,PHX::Device>("points",numElements,idsPerElement,dim);
@@ -278,16 +287,49 @@ void IOSSConnManager::buildEdgeFaceCornerNodeMapping() {
   std::vector<std::string> elementBlockIds;
   getElementBlockIds(elementBlockIds);
 
+  using Key = SubcellKeys::Key;
+
+  edgeKeys_.clear();
+  faceKeys_.clear();
+  elementEdges_.clear();
+  elementFaces_.clear();
+
   size_t dim;
   int nodesPerElement = 0;
   int edgesPerElement = 0;
   int facesPerElement = 0;
-  int numCornerNodesThisSubcell;
   std::vector<int> numCornerNodesOnEdges, numCornerNodesOnFaces;
   std::vector<std::vector<int>> edgeConnectivities, faceConnectivities;
-  std::vector<GlobalOrdinal> nodesThisElement;
-  std::array<GlobalOrdinal,MAX_SUBCELL_CORNER_NODES_> cornerNodesThisSubcell;
-  std::vector<std::array<GlobalOrdinal,MAX_SUBCELL_CORNER_NODES_>> edgesThisElement, facesThisElement;
+  std::vector<Key> blockKeys;
+
+  // Build the canonical key of every subcell of every element in the block in
+  // parallel, then number the distinct keys serially.
+  auto addBlockKeys = [&](const std::vector<GlobalOrdinal> & blockConnectivity, int numElements,
+                          int subcellsPerElement, const std::vector<int> & numCornerNodes,
+                          const std::vector<std::vector<int>> & subcellConnectivities,
+                          SubcellKeys & table, std::vector<LocalOrdinal> & elementSubcells) {
+    blockKeys.resize(std::size_t(numElements)*subcellsPerElement);
+    Kokkos::parallel_for("IOSSConnManager::buildSubcellKeys",
+                         Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>(0,numElements),
+                         [&](const int elmtIdInBlock) {
+      for (int subcell = 0; subcell < subcellsPerElement; ++subcell) {
+        Key & key = blockKeys[std::size_t(elmtIdInBlock)*subcellsPerElement + subcell];
+        const int numCornerNodesThisSubcell = numCornerNodes[subcell];
+        for (int cornerNode = 0; cornerNode < numCornerNodesThisSubcell; ++cornerNode) {
+          key[cornerNode] = blockConnectivity[std::size_t(nodesPerElement)*elmtIdInBlock + subcellConnectivities[subcell][cornerNode]];
+        }
+        for (int cornerNode = numCornerNodesThisSubcell; cornerNode < MAX_SUBCELL_CORNER_NODES_; ++cornerNode) {
+          key[cornerNode] = -1;
+        }
+        // Sort is necessary to ensure subcell identifiers are unique.
+        std::sort(key.begin(), key.begin()+numCornerNodesThisSubcell);
+      }
+    });
+    elementSubcells.resize(blockKeys.size());
+    for (std::size_t k = 0; k < blockKeys.size(); ++k) {
+      elementSubcells[k] = table.insert(blockKeys[k]);
+    }
+  };
 
   Teuchos::RCP<std::vector<GlobalOrdinal>> blockConnectivity;
   for (std::string elementBlockId : elementBlockIds) {
@@ -295,6 +337,7 @@ void IOSSConnManager::buildEdgeFaceCornerNodeMapping() {
 	int blockConnectivitySize = blockConnectivity->size();
 	if (blockConnectivitySize > 0) {
 	  const Ioss::ElementTopology * top = iossElementBlockTopologies_.find(elementBlockId)->second;
+	  const int numElements = getElementBlock(elementBlockId).size();
 	  dim = top->spatial_dimension();
 	  nodesPerElement = top->number_nodes();
 	  if (dim > 1) {
@@ -304,7 +347,11 @@ void IOSSConnManager::buildEdgeFaceCornerNodeMapping() {
 	    for (int edge = 0; edge < edgesPerElement; ++edge) {
 	      numCornerNodesOnEdges[edge] = top->edge_type(edge)->number_corner_nodes();
 	      edgeConnectivities[edge] = top->edge_connectivity(edge+1);
+	      TEUCHOS_TEST_FOR_EXCEPTION(numCornerNodesOnEdges[edge] > MAX_SUBCELL_CORNER_NODES_, std::logic_error,
+	                  "Error, currently IOSSConnManager only supports element edges with at most " << MAX_SUBCELL_CORNER_NODES_ << " corner nodes.");
 	    }
+	    addBlockKeys(*blockConnectivity, numElements, edgesPerElement, numCornerNodesOnEdges, edgeConnectivities,
+	                 edgeKeys_, elementEdges_[elementBlockId]);
 	    if (dim > 2) {
 	      facesPerElement = top->number_faces();
 	      numCornerNodesOnFaces.resize(facesPerElement);
@@ -312,129 +359,68 @@ void IOSSConnManager::buildEdgeFaceCornerNodeMapping() {
 	      for (int face = 0; face < facesPerElement; ++face) {
 	        numCornerNodesOnFaces[face] = top->face_type(face)->number_corner_nodes();
 	        faceConnectivities[face] = top->face_connectivity(face+1);
+	        TEUCHOS_TEST_FOR_EXCEPTION(numCornerNodesOnFaces[face] > MAX_SUBCELL_CORNER_NODES_, std::logic_error,
+	                    "Error, currently IOSSConnManager only supports element faces with at most " << MAX_SUBCELL_CORNER_NODES_ << " corner nodes.");
 	      }
+	      addBlockKeys(*blockConnectivity, numElements, facesPerElement, numCornerNodesOnFaces, faceConnectivities,
+	                   faceKeys_, elementFaces_[elementBlockId]);
 	    }
 	  }
-	  elementEdgeNodes_[elementBlockId] = rcp(new std::vector<std::vector<std::array<GlobalOrdinal,MAX_SUBCELL_CORNER_NODES_>>>);
-	  elementFaceNodes_[elementBlockId] = rcp(new std::vector<std::vector<std::array<GlobalOrdinal,MAX_SUBCELL_CORNER_NODES_>>>);
-	  nodesThisElement.resize(nodesPerElement);
-	  for(std::size_t elmtIdInBlock=0; elmtIdInBlock < getElementBlock(elementBlockId).size(); ++elmtIdInBlock) {
-	    edgesThisElement.clear();
-	    facesThisElement.clear();
-		for (int node = 0; node < nodesPerElement; ++node) {
-	      nodesThisElement[node] = (*blockConnectivity)[nodesPerElement*elmtIdInBlock + node];
-	    }
-	    if (dim > 1) {
-	      for (int edge = 0; edge < edgesPerElement; ++edge) {
-	        numCornerNodesThisSubcell = numCornerNodesOnEdges[edge];
-	        TEUCHOS_TEST_FOR_EXCEPTION(numCornerNodesThisSubcell > MAX_SUBCELL_CORNER_NODES_, std::logic_error,
-	                    "Error, currently IOSSConnManager only supports element edges with at most " << MAX_SUBCELL_CORNER_NODES_ << " corner nodes.");
-	        //cornerNodesThisSubcell.resize(numCornerNodesThisSubcell);
-	        for (int cornerNode = 0; cornerNode < numCornerNodesThisSubcell; ++cornerNode) {
-	          cornerNodesThisSubcell[cornerNode] = nodesThisElement[ edgeConnectivities[edge][cornerNode] ];
-	        }
-	        for (int cornerNode = numCornerNodesThisSubcell; cornerNode < MAX_SUBCELL_CORNER_NODES_; ++cornerNode) {
-	          cornerNodesThisSubcell[cornerNode] = -1;
-	        }
-	        // Sort is necessary to ensure edge identifiers are unique.
-	        std::sort(cornerNodesThisSubcell.begin(), cornerNodesThisSubcell.begin()+numCornerNodesThisSubcell);
-	        edgeNodeToEdgeMap_[cornerNodesThisSubcell] = -1;
-	        edgesThisElement.push_back(cornerNodesThisSubcell);
-	      }
-	      if (dim > 2) {
-	        for (int face = 0; face < facesPerElement; ++face) {
-	    	  numCornerNodesThisSubcell = numCornerNodesOnFaces[face];
-	    	  TEUCHOS_TEST_FOR_EXCEPTION(numCornerNodesThisSubcell > MAX_SUBCELL_CORNER_NODES_, std::logic_error,
-	    	  	                    "Error, currently IOSSConnManager only supports element faces with at most " << MAX_SUBCELL_CORNER_NODES_ << " corner nodes.");
-	    	  //cornerNodesThisSubcell.resize(numCornerNodesThisSubcell);
-	    	  for (int cornerNode = 0; cornerNode < numCornerNodesThisSubcell; ++cornerNode) {
-	    	    cornerNodesThisSubcell[cornerNode] = nodesThisElement[ faceConnectivities[face][cornerNode] ];
-	    	  }
-	    	  for (int cornerNode = numCornerNodesThisSubcell; cornerNode < MAX_SUBCELL_CORNER_NODES_; ++cornerNode) {
-	    	    cornerNodesThisSubcell[cornerNode] = -1;
-	    	  }
-	    	  // Sort is necessary to ensure edge identifiers are unique.
-	    	  std::sort(cornerNodesThisSubcell.begin(), cornerNodesThisSubcell.begin()+numCornerNodesThisSubcell);
-	    	  faceNodeToFaceMap_[cornerNodesThisSubcell] = -1;
-	    	  facesThisElement.push_back(cornerNodesThisSubcell);
-	    	}
-	      }
-	    }
-	    elementEdgeNodes_[elementBlockId]->push_back(edgesThisElement);
-	    elementFaceNodes_[elementBlockId]->push_back(facesThisElement);
-	  }
 	}
   }
 
   dim = iossElementBlockTopologies_.find(elementBlockIds[0])->second->spatial_dimension();
 
-  std::vector<std::array<GlobalOrdinal,MAX_SUBCELL_CORNER_NODES_>> keys;
-  std::vector<GlobalOrdinal> gids;
-  GlobalOrdinal numEdges = 0;
-  GlobalOrdinal numFaces = 0;
-
-  if (dim > 1) {
-    numEdges = edgeNodeToEdgeMap_.size();
-    if (dim > 2) {
-      numFaces = faceNodeToFaceMap_.size();
-    }
-  }
+  // The distinct keys are numbered in sorted order, as the ordered maps used
+  // to do, so the global ids do not depend on the hash table layout.
+  auto sortedOrder = [](const SubcellKeys & table) {
+    std::vector<std::size_t> order(table.size());
+    std::iota(order.begin(), order.end(), std::size_t(0));
+    const std::vector<Key> & keys = table.keys();
+    std::sort(order.begin(), order.end(),
+              [&keys](std::size_t a, std::size_t b) { return keys[a] < keys[b]; });
+    return order;
+  };
 
 #ifdef HAVE_MPI
   Ioss::ParallelUtils util = iossMeshDB_->util();
   MPI_Comm communicator = util.communicator();
   Teuchos::MpiComm<int> comm(communicator);
 
-  if (dim > 1) {
-	keys.clear();
-	for (auto pair : edgeNodeToEdgeMap_) {
-	  keys.push_back(pair.first);
-	}
-    gids.resize(numEdges);
-    TEUCHOS_TEST_FOR_EXCEPTION(keys.size() != gids.size(), std::logic_error,
-       "Error, keys() != gids.size().");
-    numUniqueEdges_ = Zoltan2::findUniqueGids<std::array<GlobalOrdinal,MAX_SUBCELL_CORNER_NODES_>,GlobalOrdinal>(keys, gids, comm);
-    for (GlobalOrdinal edge = 0; edge < numEdges; ++edge) {
-      edgeNodeToEdgeMap_[keys[edge]] = gids[edge];
+  auto numberKeys = [&](const SubcellKeys & table, std::vector<GlobalOrdinal> & tableGids) {
+    const std::vector<std::size_t> order = sortedOrder(table);
+    std::vector<Key> keys(order.size());
+    for (std::size_t k = 0; k < order.size(); ++k) {
+      keys[k] = table.keys()[order[k]];
     }
-    if (dim > 2) {
-      keys.clear();
-      for (auto pair : faceNodeToFaceMap_) {
-        keys.push_back(pair.first);
-      }
-      gids.resize(numFaces);
-      TEUCHOS_TEST_FOR_EXCEPTION(keys.size() != gids.size(), std::logic_error,
-          		                     "Error, keys() != gids.size().");
-      numUniqueFaces_ = Zoltan2::findUniqueGids<std::array<GlobalOrdinal,MAX_SUBCELL_CORNER_NODES_>,GlobalOrdinal>(keys, gids, comm);
-      for (GlobalOrdinal face = 0; face < numFaces; ++face) {
-        faceNodeToFaceMap_[keys[face]] = gids[face];
-      }
+    std::vector<GlobalOrdinal> gids(order.size());
+    const GlobalOrdinal numUnique = Zoltan2::findUniqueGids<Key,GlobalOrdinal>(keys, gids, comm);
+    tableGids.resize(order.size());
+    for (std::size_t k = 0; k < order.size(); ++k) {
+      tableGids[order[k]] = gids[k];
     }
-  }
-
+    return numUnique;
+  };
 #else
+  auto numberKeys = [&](const SubcellKeys & table, std::vector<GlobalOrdinal> & tableGids) {
+    const std::vector<std::size_t> order = sortedOrder(table);
+    tableGids.resize(order.size());
+    for (std::size_t k = 0; k < order.size(); ++k) {
+      tableGids[order[k]] = GlobalOrdinal(k);
+    }
+    return GlobalOrdinal(order.size());
+  };
+#endif
+
+  edgeGids_.clear();
+  faceGids_.clear();
   if (dim > 1) {
-	keys.clear();
-	for (auto pair : edgeNodeToEdgeMap_) {
-	  keys.push_back(pair.first);
-	}
-	for (GlobalOrdinal edge = 0; edge < numEdges; ++edge) {
-	  edgeNodeToEdgeMap_[keys[edge]] = edge;
-	}
-	if (dim > 2) {
-      keys.clear();
-		for (auto pair : faceNodeToFaceMap_) {
-		  keys.push_back(pair.first);
-		}
-	  for (GlobalOrdinal face = 0; face < numFaces; ++face) {
-	    faceNodeToFaceMap_[keys[face]] = face;
-	  }
-	}
+    numUniqueEdges_ = numberKeys(edgeKeys_, edgeGids_);
+    if (dim > 2) {
+      numUniqueFaces_ = numberKeys(faceKeys_, faceGids_);
+    }
   }
 
-
-#endif
-
 }
 
 void IOSSConnManager::buildConnectivity(const panzer::FieldPattern & fp) {
@@ -678,10 +664,10 @@ typename IOSSConnManager::LocalOrdinal IOSSConnManager::addSubcellConnectivities
 	   }
 	   else {
 	     if (subcellRank == 1) {
-	       subcellId = edgeNodeToEdgeMap_[(*(elementEdgeNodes_[blockId]))[elmtIdInBlock][subcell]];
+	       subcellId = edgeGids_[elementEdges_[blockId][subcellsPerElement*elmtIdInBlock+subcell]];
 	     }
 	     else if (subcellRank == 2) {
-	       subcellId = faceNodeToFaceMap_[(*(elementFaceNodes_[blockId]))[elmtIdInBlock][subcell]];
+	       subcellId = faceGids_[elementFaces_[blockId][subcellsPerElement*elmtIdInBlock+subcell]];
 	     }
 	     else {
 	       TEUCHOS_TEST_FOR_EXCEPTION(false, std::logic_error,
@@ -46,6 +46,7 @@
 #include <string>
 #include <vector>
 #include <array>
+#include <unordered_map>
 
 // Teuchos includes
 #include "Teuchos_RCP.hpp"
@@ -60,6 +61,7 @@
 #include "Panzer_ConnManager.hpp"
 #include "Panzer_FieldPattern.hpp"
 #include "Panzer_IntrepidFieldPattern.hpp"
+#include "Panzer_IOSSSubcellKeyTable.hpp"
 
 // Ioss includes
 #include "Ioss_CodeTypes.h"
@@ -295,11 +297,17 @@ protected:
    std::map<std::string,Teuchos::RCP<std::vector<LocalOrdinal> > > neighborElementBlocks_;
 
    static const int MAX_SUBCELL_CORNER_NODES_ = 6;
+   using SubcellKeys = SubcellKeyTable<LocalOrdinal,GlobalOrdinal,MAX_SUBCELL_CORNER_NODES_>;
    GlobalOrdinal numUniqueEdges_, numUniqueFaces_;
-   std::map<std::array<GlobalOrdinal,MAX_SUBCELL_CORNER_NODES_>,GlobalOrdinal> edgeNodeToEdgeMap_;
-   std::map<std::array<GlobalOrdinal,MAX_SUBCELL_CORNER_NODES_>,GlobalOrdinal> faceNodeToFaceMap_;
-   std::map<std::string,Teuchos::RCP<std::vector<std::vector<std::array<GlobalOrdinal,MAX_SUBCELL_CORNER_NODES_>>>>> elementEdgeNodes_;
-   std::map<std::string,Teuchos::RCP<std::vector<std::vector<std::array<GlobalOrdinal,MAX_SUBCELL_CORNER_NODES_>>>>> elementFaceNodes_;
+   SubcellKeys edgeKeys_, faceKeys_; // distinct edge and face corner node keys
+   std::vector<GlobalOrdinal> edgeGids_, faceGids_; // global edge and face ids, by key index
+   std::map<std::string,std::vector<LocalOrdinal>> elementEdges_; // key index of each element edge, by block
+   std::map<std::string,std::vector<LocalOrdinal>> elementFaces_; // key index of each element face, by block
+
+   // node coordinates, indexed on the first call to getDofCoords()
+   mutable int nodeCoordinatesDim_;
+   mutable std::unordered_map<GlobalOrdinal,LocalOrdinal> nodeIdToCoordinates_;
+   mutable std::vector<double> nodeCoordinates_;
 
    std::vector<GlobalOrdinal> elmtLidToGid_; // element LID to GID map.
    std::vector<LocalOrdinal> elmtLidToConn_; // element LID to starting index in connectivity_
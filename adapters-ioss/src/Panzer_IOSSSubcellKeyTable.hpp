@@ -0,0 +1,149 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#ifndef __Panzer_IOSSSubcellKeyTable_hpp__
+#define __Panzer_IOSSSubcellKeyTable_hpp__
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace panzer_ioss {
+
+/** Open addressing hash table that numbers distinct subcell keys in the
+  * order they are first inserted.
+  *
+  * A key holds the corner node ids of an edge or face, sorted and padded
+  * with -1, so every element sharing the subcell builds the same key.
+  * Keys are stored contiguously and can be handed to Zoltan2 as they are.
+  */
+template <typename LocalOrdinal,typename GlobalOrdinal,int N>
+class SubcellKeyTable {
+public:
+   using Key = std::array<GlobalOrdinal,N>;
+
+   SubcellKeyTable()
+   { clear(); }
+
+   //! Remove all keys.
+   void clear()
+   {
+     keys_.clear();
+     slots_.assign(MIN_CAPACITY_,-1);
+   }
+
+   /** Index of a key, inserting it if it is not in the table yet.
+     *
+     * \param[in] key Canonical subcell key
+     *
+     * \returns Index of the key in <code>keys()</code>
+     */
+   LocalOrdinal insert(const Key & key)
+   {
+     // keep the load factor at or below one half
+     if(2*(keys_.size()+1) > slots_.size())
+       rehash(2*slots_.size());
+
+     const std::size_t slot = find(key);
+     if(slots_[slot] < 0) {
+       slots_[slot] = LocalOrdinal(keys_.size());
+       keys_.push_back(key);
+     }
+     return slots_[slot];
+   }
+
+   /** Index of a key.
+     *
+     * \returns Index of the key in <code>keys()</code>, or -1 if it is not in the table
+     */
+   LocalOrdinal index(const Key & key) const
+   { return slots_[find(key)]; }
+
+   //! Number of distinct keys.
+   std::size_t size() const
+   { return keys_.size(); }
+
+   //! Distinct keys in insertion order.
+   const std::vector<Key> & keys() const
+   { return keys_; }
+
+private:
+
+   static std::size_t hash(const Key & key)
+   {
+     std::uint64_t h = 0;
+     for(const GlobalOrdinal k : key) {
+       // splitmix64 step per corner node
+       h += std::uint64_t(k) + 0x9e3779b97f4a7c15ull;
+       h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+       h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+       h ^= h >> 31;
+     }
+     return std::size_t(h);
+   }
+
+   // slot holding the key, or the empty slot where it would go
+   std::size_t find(const Key & key) const
+   {
+     const std::size_t mask = slots_.size()-1;
+     std::size_t slot = hash(key) & mask;
+     while(slots_[slot] >= 0 && keys_[slots_[slot]] != key)
+       slot = (slot+1) & mask;
+     return slot;
+   }
+
+   void rehash(std::size_t capacity)
+   {
+     slots_.assign(capacity,-1);
+     for(std::size_t k=0; k < keys_.size(); ++k)
+       slots_[find(keys_[k])] = LocalOrdinal(k);
+   }
+
+   static const std::size_t MIN_CAPACITY_ = 16; // a power of two
+
+   std::vector<Key> keys_;
+   std::vector<LocalOrdinal> slots_;
+};
+
+}
+
+#endif
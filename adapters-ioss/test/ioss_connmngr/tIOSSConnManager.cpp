@@ -57,6 +57,7 @@
 #include "PanzerCore_config.hpp"
 #include "PanzerAdaptersIOSS_config.hpp"
 #include "Panzer_IOSSConnManager.hpp"
+#include "Panzer_IOSSSubcellKeyTable.hpp"
 
 #include "Panzer_FieldPattern.hpp"
 #include "Panzer_NodalFieldPattern.hpp"
@@ -397,6 +398,34 @@ TEUCHOS_UNIT_TEST(tIOSSConnManager, basic)
     //Kokkos::finalize();
 }
 
+TEUCHOS_UNIT_TEST(tIOSSConnManager, subcellKeyTable)
+{
+  using Table = SubcellKeyTable<int,long long,4>;
+  Table table;
+
+  // enough keys to force several rehashes, each inserted twice
+  const int numKeys = 1000;
+  for (int pass = 0; pass < 2; ++pass) {
+    for (int k = 0; k < numKeys; ++k) {
+      Table::Key key = {{k, k+1, -1, -1}};
+      TEST_EQUALITY(table.insert(key), k);
+    }
+  }
+  TEST_EQUALITY(table.size(), std::size_t(numKeys));
+
+  for (int k = 0; k < numKeys; ++k) {
+    Table::Key key = {{k, k+1, -1, -1}};
+    TEST_EQUALITY(table.index(key), k);
+    TEST_ASSERT(table.keys()[k] == key);
+  }
+  Table::Key missing = {{1, 0, -1, -1}};
+  TEST_EQUALITY(table.index(missing), -1);
+
+  table.clear();
+  TEST_EQUALITY(table.size(), std::size_t(0));
+  TEST_EQUALITY(table.index(missing), -1);
+}
+
 namespace {
 
   void setCorrectQuad4NodalFP(Teuchos::MpiComm<int> & comm) {
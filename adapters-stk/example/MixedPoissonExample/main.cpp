@@ -457,7 +457,7 @@ int main(int argc,char * argv[])
      if(true) {
         // write to exodus
         // ---------------
-		TianXin::pushSolutionOnFields(*dofManager,*mesh,*Teuchos::rcp_dynamic_cast<panzer::TpetraLinearObjContainer<double,int,panzer::GlobalOrdinal>>(container)->get_x());
+		TianXin::pushSolutionOnFields(dofManager,*mesh,*Teuchos::rcp_dynamic_cast<panzer::TpetraLinearObjContainer<double,int,panzer::GlobalOrdinal>>(container)->get_x());
         // Due to multiple instances of this test being run at the
         // same time (one for each order), we need to differentiate
         // output to prevent race conditions on output file. Multiple
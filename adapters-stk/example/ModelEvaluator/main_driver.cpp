@@ -309,7 +309,7 @@ int main(int argc, char *argv[])
 	//auto gc = physics->getGhostedContainer();
 	//TianXin::write_solution_data(*dofManager,*mesh,*Teuchos::rcp_dynamic_cast<panzer::TpetraLinearObjContainer<double,int,panzer::GlobalOrdinal>>(gc)->get_x());
     //TianXin::write_solution_data(*dofManager,*mesh,*gvec);
-	TianXin::pushSolutionOnFields(*dofManager,*mesh,*gvec);
+	TianXin::pushSolutionOnFields(dofManager,*mesh,*gvec);
     mesh->writeToExodus("output.exo");
   }
   catch (std::exception& e) {
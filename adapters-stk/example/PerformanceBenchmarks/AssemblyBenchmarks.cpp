@@ -0,0 +1,490 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#include "Benchmarks.hpp"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Teuchos_Assert.hpp"
+#include "Teuchos_DefaultMpiComm.hpp"
+#include "Teuchos_FancyOStream.hpp"
+#include "Teuchos_OpaqueWrapper.hpp"
+#include "Teuchos_ParameterList.hpp"
+#include "Teuchos_TimeMonitor.hpp"
+#include "Teuchos_oblackholestream.hpp"
+
+#include "Panzer_STK_Interface.hpp"
+#include "Panzer_STK_SquareQuadMeshFactory.hpp"
+#include "Panzer_STK_CubeHexMeshFactory.hpp"
+#include "Panzer_STK_WorksetFactory.hpp"
+#include "Panzer_STKConnManager.hpp"
+#include "Panzer_WorksetContainer.hpp"
+#include "Panzer_FieldManagerBuilder.hpp"
+#include "Panzer_TpetraLinearObjFactory.hpp"
+#include "Panzer_AssemblyEngine.hpp"
+#include "Panzer_AssemblyEngine_InArgs.hpp"
+#include "Panzer_AssemblyEngine_TemplateManager.hpp"
+#include "Panzer_AssemblyEngine_TemplateBuilder.hpp"
+#include "Panzer_DOFManagerFactory.hpp"
+#include "Panzer_GlobalData.hpp"
+#include "Panzer_Traits.hpp"
+#include "Panzer_PhysicsBlock.hpp"
+#include "Panzer_Workset_Utilities.hpp"
+
+#include "user_app_EquationSetFactory.hpp"
+#include "user_app_ClosureModel_Factory_TemplateBuilder.hpp"
+
+#include "Thyra_TpetraThyraWrappers.hpp"
+#include "Thyra_TpetraVector.hpp"
+#include "Thyra_TpetraVectorSpace.hpp"
+#include "Thyra_LinearOpTester.hpp"
+#include "Thyra_TestingTools.hpp"
+
+namespace panzer_benchmarks {
+
+namespace {
+
+using Teuchos::RCP;
+using Teuchos::rcp;
+
+//! Assembly engine options the volume fill benchmarks switch between
+struct VolumeFillModes {
+  bool concurrent = false;
+  int workers = 4;
+  bool precomputeOffsets = false;
+  bool overlapGhostExchange = false;
+  bool linearDiffusion = false;
+};
+
+struct VolumeSystem {
+  RCP<const Thyra::LinearOpBase<double> > op;
+  RCP<const Thyra::VectorBase<double> > f;
+  std::size_t numColors = 0;
+  double time = 0.0;
+};
+
+//! Residual and Jacobian volume fill of two energy equations on a two block quad mesh,
+//! only the volume fill is timed.
+VolumeSystem buildVolumeSystem(const Options & opts,const VolumeFillModes & modes)
+{
+  RCP<Teuchos::Comm<int> > comm = rcp(new Teuchos::MpiComm<int>(Teuchos::opaqueWrapper(MPI_COMM_WORLD)));
+
+  RCP<Teuchos::ParameterList> pl = rcp(new Teuchos::ParameterList);
+  pl->set("X Blocks",2);
+  pl->set("Y Blocks",1);
+  pl->set("X Elements",std::max(2,3*opts.elements/2));
+  pl->set("Y Elements",opts.elements);
+
+  panzer_stk::SquareQuadMeshFactory factory;
+  factory.setParameterList(pl);
+  RCP<panzer_stk::STK_Interface> mesh = factory.buildMesh(MPI_COMM_WORLD);
+
+  RCP<Teuchos::ParameterList> ipb = Teuchos::parameterList("Physics Blocks");
+  {
+    Teuchos::ParameterList& physics_block = ipb->sublist("test physics");
+    physics_block.set("Material","Cu");
+    const char * prefixes[] = {"",          "ION_"};
+    const char * models[]   = {"solid",     "ion solid"};
+    const char * names[]    = {"a",         "b"};
+    const int orders[]      = {2,           1};
+    for(int e=0;e<2;e++) {
+      Teuchos::ParameterList& p = physics_block.sublist(names[e]);
+      p.set("Type","Energy");
+      p.set("Prefix",prefixes[e]);
+      p.set("Model ID",models[e]);
+      p.set("Basis Type","HGrad");
+      p.set("Basis Order",orders[e]);
+      if(modes.linearDiffusion)
+        p.set("Linear Diffusion","ON");
+    }
+  }
+
+  const std::size_t workset_size = 8;
+  RCP<user_app::MyFactory> eqset_factory = rcp(new user_app::MyFactory);
+  std::vector<RCP<panzer::PhysicsBlock> > physicsBlocks;
+  {
+    std::map<std::string,std::string> block_ids_to_physics_ids;
+    block_ids_to_physics_ids["eblock-0_0"] = "test physics";
+    block_ids_to_physics_ids["eblock-1_0"] = "test physics";
+
+    std::map<std::string,RCP<const shards::CellTopology> > block_ids_to_cell_topo;
+    block_ids_to_cell_topo["eblock-0_0"] = mesh->getCellTopology("eblock-0_0");
+    block_ids_to_cell_topo["eblock-1_0"] = mesh->getCellTopology("eblock-1_0");
+
+    RCP<panzer::GlobalData> gd = panzer::createGlobalData();
+
+    Teuchos::ParameterList material_models("Material");
+    Teuchos::ParameterList& Cu = material_models.sublist("Cu");
+    const char * props[] = {"Thermal Conductivity","Density","Heat Capacity",
+                            "ION_Thermal Conductivity","ION_Density","ION_Heat Capacity"};
+    for(const char * prop : props) {
+      Teuchos::ParameterList& mp = Cu.sublist(prop);
+      mp.set("Value Type","Constant");
+      mp.sublist("Constant").set<Teuchos::Array<double> >("Value",Teuchos::tuple<double>( 1.0 ));
+    }
+    panzer::createAndRegisterFunctor<double>(material_models,gd->functors);
+
+    panzer::buildPhysicsBlocks(block_ids_to_physics_ids,block_ids_to_cell_topo,ipb,1,workset_size,
+                               eqset_factory,gd,false,physicsBlocks);
+  }
+
+  RCP<panzer::WorksetContainer> wkstContainer = rcp(new panzer::WorksetContainer);
+  wkstContainer->setFactory(rcp(new panzer_stk::WorksetFactory(mesh)));
+  for(std::size_t i=0;i<physicsBlocks.size();i++)
+    wkstContainer->setNeeds(physicsBlocks[i]->elementBlockID(),physicsBlocks[i]->getWorksetNeeds());
+  wkstContainer->setWorksetSize(workset_size);
+
+  const RCP<panzer::ConnManager> conn_manager = rcp(new panzer_stk::STKConnManager(mesh));
+  panzer::DOFManagerFactory globalIndexerFactory;
+  RCP<panzer::GlobalIndexer> dofManager
+       = globalIndexerFactory.buildGlobalIndexer(Teuchos::opaqueWrapper(MPI_COMM_WORLD),physicsBlocks,conn_manager);
+
+  RCP<panzer::LinearObjFactory<panzer::Traits> > linObjFactory
+        = rcp(new panzer::TpetraLinearObjFactory<panzer::Traits,double,int,panzer::GlobalOrdinal>(comm,dofManager));
+
+  panzer::ClosureModelFactory_TemplateManager<panzer::Traits> cm_factory;
+  user_app::MyModelFactory_TemplateBuilder cm_builder;
+  cm_factory.buildObjects(cm_builder);
+
+  Teuchos::ParameterList closure_models("Closure Models");
+  closure_models.sublist("solid").sublist("SOURCE_TEMPERATURE").set<double>("Value",1.0);
+  closure_models.sublist("ion solid").sublist("SOURCE_ION_TEMPERATURE").set<double>("Value",1.0);
+
+  Teuchos::ParameterList user_data("User Data");
+  user_data.set("Precompute Jacobian Offsets",modes.precomputeOffsets);
+
+  RCP<panzer::FieldManagerBuilder> fmb = rcp(new panzer::FieldManagerBuilder);
+  fmb->setWorksetContainer(wkstContainer);
+  fmb->setConcurrentVolumeAssembly(modes.concurrent,modes.workers);
+  fmb->setOverlapGhostExchange(modes.overlapGhostExchange);
+  fmb->setupVolumeFieldManagers(physicsBlocks,cm_factory,closure_models,*linObjFactory,user_data);
+
+  panzer::AssemblyEngine_TemplateManager<panzer::Traits> ae_tm;
+  panzer::AssemblyEngine_TemplateBuilder builder(fmb,linObjFactory);
+  ae_tm.buildObjects(builder);
+
+  VolumeSystem system;
+  for(const auto & wd : fmb->getVolumeWorksetDescriptors()) {
+    std::vector<std::vector<std::size_t> > blockColors;
+    panzer::colorWorksets(*dofManager,*wkstContainer->getWorksets(wd),blockColors);
+    system.numColors += blockColors.size();
+  }
+
+  RCP<panzer::LinearObjContainer> ghosted = linObjFactory->buildGhostedLinearObjContainer();
+  RCP<panzer::LinearObjContainer> global = linObjFactory->buildLinearObjContainer();
+  const int mem = panzer::LinearObjContainer::X | panzer::LinearObjContainer::DxDt |
+                  panzer::LinearObjContainer::F | panzer::LinearObjContainer::Mat;
+  linObjFactory->initializeGhostedContainer(mem,*ghosted);
+  linObjFactory->initializeContainer(mem,*global);
+
+  panzer::AssemblyEngineInArgs input(ghosted,global);
+  input.alpha = 0.0;
+  input.beta = 1.0;
+
+  typedef panzer::AssemblyEngine<panzer::Traits::Jacobian>::EvaluationFlags Flags;
+  Teuchos::Time timer("volume fill");
+  for(int r=0;r<opts.repeats;r++) {
+    ghosted->initialize();
+    global->initialize();
+    if(modes.overlapGhostExchange) {
+      // the import is only overlapped when the gather and volume fill are one call
+      Teuchos::TimeMonitor tm(timer);
+      ae_tm.getAsObject<panzer::Traits::Residual>()->evaluate(input,Flags(Flags::Initialize | Flags::VolumetricFill));
+      ae_tm.getAsObject<panzer::Traits::Jacobian>()->evaluate(input,Flags(Flags::Initialize | Flags::VolumetricFill));
+    }
+    else {
+      ae_tm.getAsObject<panzer::Traits::Residual>()->evaluate(input,Flags(Flags::Initialize));
+      ae_tm.getAsObject<panzer::Traits::Jacobian>()->evaluate(input,Flags(Flags::Initialize));
+      Teuchos::TimeMonitor tm(timer);
+      ae_tm.getAsObject<panzer::Traits::Residual>()->evaluate(input,Flags(Flags::VolumetricFill));
+      ae_tm.getAsObject<panzer::Traits::Jacobian>()->evaluate(input,Flags(Flags::VolumetricFill));
+    }
+    ae_tm.getAsObject<panzer::Traits::Jacobian>()->evaluate(input,Flags(Flags::Scatter));
+  }
+  system.time = timer.totalElapsedTime();
+
+  RCP<panzer::TpetraLinearObjContainer<double,int,panzer::GlobalOrdinal> > globalCont
+     = Teuchos::rcp_dynamic_cast<panzer::TpetraLinearObjContainer<double,int,panzer::GlobalOrdinal> >(global,true);
+
+  RCP<const Tpetra::Operator<double,int,panzer::GlobalOrdinal> > baseOp = globalCont->get_A();
+  RCP<const Thyra::VectorSpaceBase<double> > rangeSpace = Thyra::createVectorSpace<double>(baseOp->getRangeMap());
+  RCP<const Thyra::VectorSpaceBase<double> > domainSpace = Thyra::createVectorSpace<double>(baseOp->getDomainMap());
+
+  system.op = Thyra::constTpetraLinearOp<double,int,panzer::GlobalOrdinal>(rangeSpace, domainSpace, baseOp);
+  system.f = Thyra::constTpetraVector<double,int,panzer::GlobalOrdinal>(Thyra::tpetraVectorSpace<double,int,panzer::GlobalOrdinal>(baseOp->getRangeMap()).getConst(),
+                                                                        globalCont->get_f().getConst());
+  return system;
+}
+
+//! Throws unless both code paths assembled the same Jacobian and residual
+void checkSameSystem(const VolumeSystem & a,const VolumeSystem & b)
+{
+  Teuchos::oblackholestream blackhole;
+  Teuchos::FancyOStream fout(Teuchos::rcpFromRef(blackhole));
+
+  Thyra::LinearOpTester<double> tester;
+  tester.set_all_error_tol(1e-12);
+  tester.num_random_vectors(20);
+  TEUCHOS_ASSERT(tester.compare(*a.op,*b.op,Teuchos::ptrFromRef(fout)));
+  TEUCHOS_ASSERT(Thyra::testRelNormDiffErr("a",*a.f,"b",*b.f,
+                                           "linear_properties_error_tol()",1e-12,
+                                           "linear_properties_warning_tol()",1e-12,
+                                           &blackhole));
+}
+
+//! Jacobian volume fill of one energy equation on a hex mesh, returns the time and the derivative dimension
+double hexJacobianFill(const Options & opts,int basisOrder,int & derivativeDimension)
+{
+  RCP<Teuchos::Comm<int> > comm = rcp(new Teuchos::MpiComm<int>(Teuchos::opaqueWrapper(MPI_COMM_WORLD)));
+
+  const int elmts = std::max(2,opts.elements/2);
+  RCP<Teuchos::ParameterList> pl = rcp(new Teuchos::ParameterList);
+  pl->set("X Blocks",1);
+  pl->set("Y Blocks",1);
+  pl->set("Z Blocks",1);
+  pl->set("X Elements",elmts);
+  pl->set("Y Elements",elmts);
+  pl->set("Z Elements",elmts);
+
+  panzer_stk::CubeHexMeshFactory factory;
+  factory.setParameterList(pl);
+  RCP<panzer_stk::STK_Interface> mesh = factory.buildMesh(MPI_COMM_WORLD);
+
+  RCP<Teuchos::ParameterList> ipb = Teuchos::parameterList("Physics Blocks");
+  {
+    Teuchos::ParameterList& physics_block = ipb->sublist("test physics");
+    physics_block.set("Material","Cu");
+    Teuchos::ParameterList& p = physics_block.sublist("a");
+    p.set("Type","Energy");
+    p.set("Prefix","");
+    p.set("Model ID","solid");
+    p.set("Basis Type","HGrad");
+    p.set("Basis Order",basisOrder);
+  }
+
+  const std::size_t workset_size = 64;
+  RCP<user_app::MyFactory> eqset_factory = rcp(new user_app::MyFactory);
+  std::vector<RCP<panzer::PhysicsBlock> > physicsBlocks;
+  {
+    std::map<std::string,std::string> block_ids_to_physics_ids;
+    block_ids_to_physics_ids["eblock-0_0_0"] = "test physics";
+
+    std::map<std::string,RCP<const shards::CellTopology> > block_ids_to_cell_topo;
+    block_ids_to_cell_topo["eblock-0_0_0"] = mesh->getCellTopology("eblock-0_0_0");
+
+    RCP<panzer::GlobalData> gd = panzer::createGlobalData();
+
+    Teuchos::ParameterList material_models("Material");
+    Teuchos::ParameterList& Cu = material_models.sublist("Cu");
+    const char * props[] = {"Thermal Conductivity","Density","Heat Capacity"};
+    for(const char * prop : props) {
+      Teuchos::ParameterList& mp = Cu.sublist(prop);
+      mp.set("Value Type","Constant");
+      mp.sublist("Constant").set<Teuchos::Array<double> >("Value",Teuchos::tuple<double>( 1.0 ));
+    }
+    panzer::createAndRegisterFunctor<double>(material_models,gd->functors);
+
+    panzer::buildPhysicsBlocks(block_ids_to_physics_ids,block_ids_to_cell_topo,ipb,2*basisOrder,workset_size,
+                               eqset_factory,gd,false,physicsBlocks);
+  }
+
+  RCP<panzer::WorksetContainer> wkstContainer = rcp(new panzer::WorksetContainer);
+  wkstContainer->setFactory(rcp(new panzer_stk::WorksetFactory(mesh)));
+  for(std::size_t i=0;i<physicsBlocks.size();i++)
+    wkstContainer->setNeeds(physicsBlocks[i]->elementBlockID(),physicsBlocks[i]->getWorksetNeeds());
+  wkstContainer->setWorksetSize(workset_size);
+
+  const RCP<panzer::ConnManager> conn_manager = rcp(new panzer_stk::STKConnManager(mesh));
+  panzer::DOFManagerFactory globalIndexerFactory;
+  RCP<panzer::GlobalIndexer> dofManager
+       = globalIndexerFactory.buildGlobalIndexer(Teuchos::opaqueWrapper(MPI_COMM_WORLD),physicsBlocks,conn_manager);
+  derivativeDimension = dofManager->getElementBlockGIDCount("eblock-0_0_0");
+
+  RCP<panzer::LinearObjFactory<panzer::Traits> > linObjFactory
+        = rcp(new panzer::TpetraLinearObjFactory<panzer::Traits,double,int,panzer::GlobalOrdinal>(comm,dofManager));
+
+  panzer::ClosureModelFactory_TemplateManager<panzer::Traits> cm_factory;
+  user_app::MyModelFactory_TemplateBuilder cm_builder;
+  cm_factory.buildObjects(cm_builder);
+
+  Teuchos::ParameterList closure_models("Closure Models");
+  closure_models.sublist("solid").sublist("SOURCE_TEMPERATURE").set<double>("Value",1.0);
+
+  Teuchos::ParameterList user_data("User Data");
+
+  RCP<panzer::FieldManagerBuilder> fmb = rcp(new panzer::FieldManagerBuilder);
+  fmb->setWorksetContainer(wkstContainer);
+  fmb->setupVolumeFieldManagers(physicsBlocks,cm_factory,closure_models,*linObjFactory,user_data);
+
+  panzer::AssemblyEngine_TemplateManager<panzer::Traits> ae_tm;
+  panzer::AssemblyEngine_TemplateBuilder builder(fmb,linObjFactory);
+  ae_tm.buildObjects(builder);
+
+  RCP<panzer::LinearObjContainer> ghosted = linObjFactory->buildGhostedLinearObjContainer();
+  RCP<panzer::LinearObjContainer> global = linObjFactory->buildLinearObjContainer();
+  const int mem = panzer::LinearObjContainer::X | panzer::LinearObjContainer::DxDt |
+                  panzer::LinearObjContainer::F | panzer::LinearObjContainer::Mat;
+  linObjFactory->initializeGhostedContainer(mem,*ghosted);
+  linObjFactory->initializeContainer(mem,*global);
+
+  panzer::AssemblyEngineInArgs input(ghosted,global);
+  input.alpha = 0.0;
+  input.beta = 1.0;
+
+  typedef panzer::AssemblyEngine<panzer::Traits::Jacobian>::EvaluationFlags Flags;
+  Teuchos::Time timer("jacobian volume fill");
+  for(int r=0;r<opts.repeats;r++) {
+    ghosted->initialize();
+    global->initialize();
+    ae_tm.getAsObject<panzer::Traits::Jacobian>()->evaluate(input,Flags(Flags::Initialize));
+    {
+      Teuchos::TimeMonitor tm(timer);
+      ae_tm.getAsObject<panzer::Traits::Jacobian>()->evaluate(input,Flags(Flags::VolumetricFill));
+    }
+    ae_tm.getAsObject<panzer::Traits::Jacobian>()->evaluate(input,Flags(Flags::Scatter));
+  }
+
+  return timer.totalElapsedTime();
+}
+
+}
+
+void concurrentVolume(const Options & opts,std::ostream & os)
+{
+  VolumeFillModes serialModes;
+  const VolumeSystem serial = buildVolumeSystem(opts,serialModes);
+
+  os << "Volume fill (" << opts.repeats << " residual+Jacobian evaluations, "
+     << serial.numColors << " workset colors): serial = " << serial.time << " s" << std::endl;
+
+  if(!panzer::FieldManagerBuilder::concurrentVolumeAssemblySupported()) {
+    os << "Concurrent volume assembly is not supported by this Kokkos backend, skipped" << std::endl;
+    return;
+  }
+
+  // workers are capped by the hardware threads, larger counts build no more replicas
+  const int maxWorkers = std::max(2,static_cast<int>(std::thread::hardware_concurrency()));
+  for(int workers=1;workers<=maxWorkers;workers*=2) {
+    VolumeFillModes concurrentModes;
+    concurrentModes.concurrent = true;
+    concurrentModes.workers = workers;
+
+    const VolumeSystem concurrent = buildVolumeSystem(opts,concurrentModes);
+    checkSameSystem(serial,concurrent);
+
+    os << "  " << workers << " workers: concurrent = " << concurrent.time << " s, speedup = "
+       << (concurrent.time>0.0 ? serial.time/concurrent.time : 0.0) << std::endl;
+  }
+}
+
+void precomputedCrsOffsets(const Options & opts,std::ostream & os)
+{
+  VolumeFillModes searchModes, offsetModes;
+  offsetModes.precomputeOffsets = true;
+
+  const VolumeSystem search = buildVolumeSystem(opts,searchModes);
+  const VolumeSystem offset = buildVolumeSystem(opts,offsetModes);
+  checkSameSystem(search,offset);
+
+  // the first fill also resolves the offsets
+  os << "Volume fill (" << opts.repeats << " residual+Jacobian evaluations): sumIntoValues = " << search.time
+     << " s, precomputed offsets = " << offset.time << " s, speedup = "
+     << (offset.time>0.0 ? search.time/offset.time : 0.0) << std::endl;
+}
+
+void overlappedGhostExchange(const Options & opts,std::ostream & os)
+{
+  VolumeFillModes syncModes, overlapModes;
+  overlapModes.overlapGhostExchange = true;
+
+  const VolumeSystem sync = buildVolumeSystem(opts,syncModes);
+  const VolumeSystem overlap = buildVolumeSystem(opts,overlapModes);
+  checkSameSystem(sync,overlap);
+
+  // the synchronous time excludes the import, so this is only a rough comparison
+  os << "Gather+volume fill (" << opts.repeats << " residual+Jacobian evaluations): synchronous volume = " << sync.time
+     << " s, overlapped import+volume = " << overlap.time << " s" << std::endl;
+}
+
+void linearElementMatrices(const Options & opts,std::ostream & os)
+{
+  VolumeFillModes adModes, linearModes;
+  linearModes.linearDiffusion = true;
+
+  const VolumeSystem ad = buildVolumeSystem(opts,adModes);
+  const VolumeSystem linear = buildVolumeSystem(opts,linearModes);
+  checkSameSystem(ad,linear);
+
+  os << "Volume fill (" << opts.repeats << " residual+Jacobian evaluations): AD diffusion = " << ad.time
+     << " s, linear element matrices = " << linear.time << " s, speedup = "
+     << (linear.time>0.0 ? ad.time/linear.time : 0.0) << std::endl;
+}
+
+void jacobianFadCapacity(const Options & opts,std::ostream & os)
+{
+  typedef panzer::FadStaticCapacity<panzer::Traits::FadType> Capacity;
+  const std::string fadType = Capacity::value>0 ? "static capacity "+std::to_string(Capacity::value) : std::string("dynamic");
+
+  // first order elements have the derivative dimension of hex8, second
+  // order ones that of hex27
+  for(int basisOrder=1;basisOrder<=2;basisOrder++) {
+    const int expectedDimension = basisOrder==1 ? 8 : 27;
+    if(Capacity::value>0 && (Capacity::fixed ? Capacity::value!=expectedDimension : Capacity::value<expectedDimension)) {
+      os << "Skipping hex order " << basisOrder << ", the " << fadType << " FadType cannot hold "
+         << expectedDimension << " derivatives" << std::endl;
+      continue;
+    }
+
+    int derivativeDimension = 0;
+    const double time = hexJacobianFill(opts,basisOrder,derivativeDimension);
+    TEUCHOS_ASSERT(derivativeDimension==expectedDimension);
+
+    os << "Jacobian volume fill, hex order " << basisOrder << " (" << derivativeDimension << " derivatives, "
+       << fadType << " FadType, " << opts.repeats << " evaluations): " << time << " s" << std::endl;
+  }
+}
+
+}
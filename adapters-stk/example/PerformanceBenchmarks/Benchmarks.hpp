@@ -0,0 +1,97 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#ifndef __PerformanceBenchmarks_hpp__
+#define __PerformanceBenchmarks_hpp__
+
+#include <ostream>
+
+// Wall clock comparisons of the optimized code paths against the ones they
+// replace. Each benchmark also checks that both paths agree and throws if not,
+// the timings are only printed.
+
+namespace panzer_benchmarks {
+
+struct Options {
+  int elements = 16; // elements per direction of the benchmark meshes, sizes scale with it
+  int repeats = 5;   // timed evaluations per code path
+};
+
+//! Batched device evaluation of a time-only WorksetFunctor against the per-dof host loop
+void worksetFunctor(const Options & opts,std::ostream & os);
+
+//! DOFManager setup, including the entity to dof index, on hex meshes of growing size
+void dofInfoScaling(const Options & opts,std::ostream & os);
+
+//! Speedup of the volume fill with one field manager copy per worker thread over the serial fill, by worker count
+void concurrentVolume(const Options & opts,std::ostream & os);
+
+//! Volume fill through precomputed CRS offsets against sumIntoValues
+void precomputedCrsOffsets(const Options & opts,std::ostream & os);
+
+//! Gather and volume fill with the ghost import overlapping the interior worksets against a synchronous import
+void overlappedGhostExchange(const Options & opts,std::ostream & os);
+
+//! Volume fill with the diffusion Jacobian from linear element matrices against its AD derivatives
+void linearElementMatrices(const Options & opts,std::ostream & os);
+
+//! Jacobian volume fill of first and second order hexahedra with the configured FadType
+void jacobianFadCapacity(const Options & opts,std::ostream & os);
+
+//! Blocked Tpetra Jacobian scatter through precomputed CRS offsets against sumIntoValues
+void blockedCrsOffsets(const Options & opts,std::ostream & os);
+
+//! Bucketed periodic side matching against testing all node pairs
+void periodicMatch(const Options & opts,std::ostream & os);
+
+//! Workset LID span and gather time of the Native, Morton and RCM element orderings
+void elementOrdering(const Options & opts,std::ostream & os);
+
+//! Compiled Expr::Program source term against the Expr::Eval interpreter
+void exprProgram(const Options & opts,std::ostream & os);
+
+//! Throughput by order of the sum-factorized diffusion kernels against the expanded basis gradient arrays
+void sumFactorization(const Options & opts,std::ostream & os);
+
+}
+
+#endif
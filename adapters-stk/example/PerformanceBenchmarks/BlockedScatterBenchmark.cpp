@@ -0,0 +1,279 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#include "Benchmarks.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Teuchos_Assert.hpp"
+#include "Teuchos_DefaultMpiComm.hpp"
+#include "Teuchos_ParameterList.hpp"
+#include "Teuchos_TimeMonitor.hpp"
+
+#include "Panzer_BlockedDOFManager.hpp"
+#include "Panzer_BlockedTpetraLinearObjFactory.hpp"
+#include "Panzer_GlobalData.hpp"
+#include "Panzer_GlobalEvaluationDataContainer.hpp"
+#include "Panzer_IntrepidFieldPattern.hpp"
+#include "Panzer_PhysicsBlock.hpp"
+#include "Panzer_PureBasis.hpp"
+#include "Panzer_Workset.hpp"
+
+#include "Panzer_STK_Interface.hpp"
+#include "Panzer_STK_SquareQuadMeshFactory.hpp"
+#include "Panzer_STK_SetupUtilities.hpp"
+#include "Panzer_STKConnManager.hpp"
+
+#include "Phalanx_FieldManager.hpp"
+
+#include "Thyra_VectorStdOps.hpp"
+#include "Thyra_ProductVectorBase.hpp"
+#include "Thyra_BlockedLinearOpBase.hpp"
+#include "Thyra_TpetraLinearOp.hpp"
+
+#include "user_app_EquationSetFactory.hpp"
+
+namespace panzer_benchmarks {
+
+namespace {
+
+using Teuchos::RCP;
+using Teuchos::rcp;
+
+typedef panzer::BlockedTpetraLinearObjFactory<panzer::Traits,double,panzer::LocalOrdinal,panzer::GlobalOrdinal> BlockedLinObjFactory;
+typedef panzer::BlockedTpetraLinearObjContainer<double,panzer::LocalOrdinal,panzer::GlobalOrdinal> BlockedLinObjContainer;
+
+//! Blocked Jacobian scatter of a U,V (Q1) and B (QEdge1) system, returns the time spent in the scatters
+double assembleBlockedJacobian(const Options & opts,bool precomputeOffsets,RCP<BlockedLinObjContainer> & b_loc)
+{
+  RCP<Teuchos::MpiComm<int> > tComm = rcp(new Teuchos::MpiComm<int>(MPI_COMM_WORLD));
+
+  const std::size_t workset_size = 32;
+  const std::string fieldName1_q1 = "U";
+  const std::string fieldName2_q1 = "V";
+  const std::string fieldName_qedge1 = "B";
+
+  RCP<panzer_stk::STK_Interface> mesh;
+  {
+    RCP<Teuchos::ParameterList> pl = rcp(new Teuchos::ParameterList);
+    pl->set("X Blocks",1);
+    pl->set("Y Blocks",1);
+    pl->set("X Elements",opts.elements);
+    pl->set("Y Elements",opts.elements);
+
+    panzer_stk::SquareQuadMeshFactory factory;
+    factory.setParameterList(pl);
+    mesh = factory.buildMesh(MPI_COMM_WORLD);
+  }
+
+  const std::string eBlockID = "eblock-0_0";
+  panzer::CellData cellData(workset_size,mesh->getCellTopology(eBlockID));
+  RCP<panzer::PureBasis> basis_q1 = rcp(new panzer::PureBasis("Q1",1,cellData));
+  RCP<panzer::PureBasis> basis_qedge1 = rcp(new panzer::PureBasis("QEdge1",1,cellData));
+
+  RCP<Teuchos::ParameterList> ipb = Teuchos::parameterList("test physics");
+  {
+    Teuchos::ParameterList & p = ipb->sublist("a");
+    p.set("Type","Energy");
+    p.set("Prefix","");
+    p.set("Model ID","solid");
+    p.set("Basis Type","HGrad");
+    p.set("Basis Order",1);
+    p.set("Integration Order",1);
+  }
+  {
+    Teuchos::ParameterList & p = ipb->sublist("b");
+    p.set("Type","Energy");
+    p.set("Prefix","ION_");
+    p.set("Model ID","solid");
+    p.set("Basis Type","HCurl");
+    p.set("Basis Order",1);
+    p.set("Integration Order",1);
+  }
+
+  RCP<user_app::MyFactory> eqset_factory = rcp(new user_app::MyFactory);
+  RCP<panzer::GlobalData> gd = panzer::createGlobalData();
+  RCP<panzer::PhysicsBlock> physicsBlock =
+      rcp(new panzer::PhysicsBlock(ipb,eBlockID,1,cellData,eqset_factory,gd,false));
+
+  // one build, so the offset tables are resolved in the first fill and then reused
+  RCP<std::vector<panzer::Workset> > work_sets = panzer_stk::buildWorksets(*mesh,physicsBlock->elementBlockID(),
+                                                                           physicsBlock->getWorksetNeeds());
+  for(std::size_t w=0;w<work_sets->size();++w) {
+    (*work_sets)[w].setIdentifier(w);
+    (*work_sets)[w].setVersion(1);
+  }
+
+  const RCP<panzer::ConnManager> conn_manager = rcp(new panzer_stk::STKConnManager(mesh));
+  RCP<panzer::BlockedDOFManager> dofManager = rcp(new panzer::BlockedDOFManager(conn_manager,MPI_COMM_WORLD));
+
+  dofManager->addField(fieldName1_q1,rcp(new panzer::Intrepid2FieldPattern(basis_q1->getIntrepid2Basis())));
+  dofManager->addField(fieldName2_q1,rcp(new panzer::Intrepid2FieldPattern(basis_q1->getIntrepid2Basis())));
+  dofManager->addField(fieldName_qedge1,rcp(new panzer::Intrepid2FieldPattern(basis_qedge1->getIntrepid2Basis())));
+
+  std::vector<std::vector<std::string> > fieldOrder(3);
+  fieldOrder[0].push_back(fieldName1_q1);
+  fieldOrder[1].push_back(fieldName_qedge1);
+  fieldOrder[2].push_back(fieldName2_q1);
+  dofManager->setFieldOrder(fieldOrder);
+  dofManager->buildGlobalUnknowns();
+
+  RCP<BlockedLinObjFactory> bt_lof = rcp(new BlockedLinObjFactory(tComm.getConst(),dofManager));
+  RCP<panzer::LinearObjFactory<panzer::Traits> > lof = bt_lof;
+  RCP<panzer::LinearObjContainer> loc = bt_lof->buildGhostedLinearObjContainer();
+  bt_lof->initializeGhostedContainer(panzer::LinearObjContainer::X | panzer::LinearObjContainer::F | panzer::LinearObjContainer::Mat,*loc);
+  loc->initialize();
+
+  b_loc = Teuchos::rcp_dynamic_cast<BlockedLinObjContainer>(loc,true);
+
+  // a solution that varies from dof to dof
+  RCP<Thyra::ProductVectorBase<double> > p_vec = Teuchos::rcp_dynamic_cast<Thyra::ProductVectorBase<double> >(b_loc->get_x());
+  Thyra::seed_randomize<double>(12345);
+  for(int blk=0;blk<3;++blk)
+    Thyra::randomize(-1.0,1.0,p_vec->getNonconstVectorBlock(blk).ptr());
+
+  PHX::FieldManager<panzer::Traits> fm;
+
+  RCP<std::map<std::string,std::string> > names_map = rcp(new std::map<std::string,std::string>);
+  names_map->insert(std::make_pair(fieldName1_q1,fieldName1_q1));
+  names_map->insert(std::make_pair(fieldName2_q1,fieldName2_q1));
+  names_map->insert(std::make_pair(fieldName_qedge1,fieldName_qedge1));
+
+  const std::pair<RCP<panzer::PureBasis>,std::vector<std::string> > fields[2] =
+      {{basis_q1,{fieldName1_q1,fieldName2_q1}},{basis_qedge1,{fieldName_qedge1}}};
+  for(const auto & field : fields) {
+    RCP<std::vector<std::string> > names = rcp(new std::vector<std::string>(field.second));
+
+    // scatter the gathered solution itself, its derivatives fill the diagonal blocks
+    Teuchos::ParameterList scatterPl;
+    scatterPl.set("Scatter Name","Scatter"+field.second[0]);
+    scatterPl.set("Basis",field.first.getConst());
+    scatterPl.set("Dependent Names",names);
+    scatterPl.set("Dependent Map",names_map);
+    scatterPl.set("Precompute Jacobian Offsets",precomputeOffsets);
+
+    RCP<PHX::Evaluator<panzer::Traits> > scatter = lof->buildScatter<panzer::Traits::Jacobian>(scatterPl);
+    fm.registerEvaluator<panzer::Traits::Jacobian>(scatter);
+    fm.requireField<panzer::Traits::Jacobian>(*scatter->evaluatedFields()[0]);
+
+    Teuchos::ParameterList gatherPl;
+    gatherPl.set("Basis",field.first);
+    gatherPl.set("DOF Names",names);
+    gatherPl.set("Indexer Names",names);
+
+    fm.registerEvaluator<panzer::Traits::Jacobian>(lof->buildGather<panzer::Traits::Jacobian>(gatherPl));
+  }
+
+  std::vector<PHX::index_size_type> derivative_dimensions;
+  derivative_dimensions.push_back(12);
+  fm.setKokkosExtendedDataTypeDimensions<panzer::Traits::Jacobian>(derivative_dimensions);
+
+  panzer::Traits::SD sd;
+  sd.worksets_ = work_sets;
+  fm.postRegistrationSetup(sd);
+
+  panzer::Traits::PED ped;
+  ped.gedc->addDataObject("Solution Gather Container",loc);
+  ped.gedc->addDataObject("Residual Scatter Container",loc);
+
+  Teuchos::Time timer("blocked scatter");
+  for(int r=0;r<opts.repeats;++r) {
+    loc->initialize();
+    fm.preEvaluate<panzer::Traits::Jacobian>(ped);
+
+    Teuchos::TimeMonitor tm(timer);
+    for(panzer::Workset & workset : *work_sets) {
+      workset.alpha = 0.0;
+      workset.beta = 2.0;
+      workset.time = 0.0;
+      workset.evaluate_transient_terms = false;
+      fm.evaluateFields<panzer::Traits::Jacobian>(workset);
+    }
+    Kokkos::fence();
+  }
+
+  return timer.totalElapsedTime();
+}
+
+}
+
+void blockedCrsOffsets(const Options & opts,std::ostream & os)
+{
+  typedef Tpetra::CrsMatrix<double,panzer::LocalOrdinal,panzer::GlobalOrdinal> CrsMatrixType;
+  typedef Thyra::TpetraLinearOp<double,panzer::LocalOrdinal,panzer::GlobalOrdinal> TpetraLinearOp;
+
+  RCP<BlockedLinObjContainer> searchLoc, offsetLoc;
+  const double searchTime = assembleBlockedJacobian(opts,false,searchLoc);
+  const double offsetTime = assembleBlockedJacobian(opts,true,offsetLoc);
+
+  // both factories build identical graphs, so the value arrays line up
+  const RCP<const Thyra::BlockedLinearOpBase<double> > searchA =
+      Teuchos::rcp_dynamic_cast<const Thyra::BlockedLinearOpBase<double> >(searchLoc->get_A(),true);
+  const RCP<const Thyra::BlockedLinearOpBase<double> > offsetA =
+      Teuchos::rcp_dynamic_cast<const Thyra::BlockedLinearOpBase<double> >(offsetLoc->get_A(),true);
+  for(int row=0;row<3;++row) {
+    for(int col=0;col<3;++col) {
+      const auto searchBlock = Teuchos::rcp_dynamic_cast<const TpetraLinearOp>(searchA->getBlock(row,col));
+      const auto offsetBlock = Teuchos::rcp_dynamic_cast<const TpetraLinearOp>(offsetA->getBlock(row,col));
+      TEUCHOS_ASSERT((searchBlock==Teuchos::null)==(offsetBlock==Teuchos::null));
+      if(searchBlock==Teuchos::null)
+        continue;
+
+      const auto searchValues = Teuchos::rcp_dynamic_cast<const CrsMatrixType>(searchBlock->getConstTpetraOperator(),true)->getLocalMatrixHost().values;
+      const auto offsetValues = Teuchos::rcp_dynamic_cast<const CrsMatrixType>(offsetBlock->getConstTpetraOperator(),true)->getLocalMatrixHost().values;
+      TEUCHOS_ASSERT(searchValues.extent(0)==offsetValues.extent(0));
+      for(std::size_t k=0;k<searchValues.extent(0);++k)
+        TEUCHOS_ASSERT(std::abs(searchValues(k)-offsetValues(k))<=1e-12*std::max(1.0,std::abs(searchValues(k))));
+    }
+  }
+
+  // the first fill also resolves the offsets
+  os << "Blocked Jacobian scatter (" << opts.repeats << " fills): sumIntoValues = " << searchTime
+     << " s, precomputed offsets = " << offsetTime << " s, speedup = "
+     << (offsetTime>0.0 ? searchTime/offsetTime : 0.0) << std::endl;
+}
+
+}
@@ -0,0 +1,139 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#include "Benchmarks.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+#include "Teuchos_Assert.hpp"
+#include "Teuchos_DefaultMpiComm.hpp"
+#include "Teuchos_ParameterList.hpp"
+#include "Teuchos_TimeMonitor.hpp"
+
+#include "Panzer_IntrepidFieldPattern.hpp"
+#include "Panzer_DOFManager.hpp"
+#include "Panzer_STK_CubeHexMeshFactory.hpp"
+#include "Panzer_STKConnManager.hpp"
+
+#include "Intrepid2_HGRAD_HEX_C1_FEM.hpp"
+#include "Intrepid2_HGRAD_HEX_C2_FEM.hpp"
+#include "Intrepid2_HCURL_HEX_I1_FEM.hpp"
+#include "Intrepid2_HDIV_HEX_I1_FEM.hpp"
+
+namespace panzer_benchmarks {
+
+namespace {
+
+using Teuchos::RCP;
+using Teuchos::rcp;
+
+template <typename IntrepidBasisType>
+RCP<const panzer::FieldPattern> buildFieldPattern()
+{
+  // build a field pattern from a single basis
+  RCP<Intrepid2::Basis<PHX::Device::execution_space,double,double> > basis = rcp(new IntrepidBasisType);
+  return rcp(new panzer::Intrepid2FieldPattern(basis));
+}
+
+}
+
+void dofInfoScaling(const Options & opts,std::ostream & os)
+{
+  // buildGlobalUnknowns, including the entity to dof index, on hex meshes of
+  // half, one and two times the requested size
+  Teuchos::MpiComm<int> comm(MPI_COMM_WORLD);
+
+  RCP<const panzer::FieldPattern> pattern_U = buildFieldPattern<Intrepid2::Basis_HGRAD_HEX_C2_FEM<PHX::Device::execution_space,double,double>>();
+  RCP<const panzer::FieldPattern> pattern_P = buildFieldPattern<Intrepid2::Basis_HGRAD_HEX_C1_FEM<PHX::Device::execution_space,double,double>>();
+  RCP<const panzer::FieldPattern> pattern_B = buildFieldPattern<Intrepid2::Basis_HDIV_HEX_I1_FEM<PHX::Device::execution_space,double,double>>();
+  RCP<const panzer::FieldPattern> pattern_E = buildFieldPattern<Intrepid2::Basis_HCURL_HEX_I1_FEM<PHX::Device::execution_space,double,double>>();
+
+  os << std::setw(10) << "elements" << std::setw(14) << "nodes(UX)" << std::setw(14) << "edges(E)"
+     << std::setw(14) << "faces(B)" << std::setw(16) << "setup [s]" << std::endl;
+
+  for(int n=std::max(2,opts.elements/2);n<=2*opts.elements;n*=2) {
+    Teuchos::ParameterList pl;
+    pl.set<int>("X Elements",n);
+    pl.set<int>("Y Elements",n);
+    pl.set<int>("Z Elements",n);
+
+    panzer_stk::CubeHexMeshFactory meshFact;
+    meshFact.setParameterList(Teuchos::rcpFromRef(pl));
+    RCP<panzer_stk::STK_Interface> mesh = meshFact.buildMesh(MPI_COMM_WORLD);
+
+    RCP<const panzer::DOFManager> dofManager;
+    Teuchos::Time timer("DofInfoScaling");
+    for(int r=0;r<opts.repeats;r++) {
+      RCP<panzer::DOFManager> dof = rcp(new panzer::DOFManager);
+      dof->useNeighbors(true);
+      dof->setConnManager(rcp(new panzer_stk::STKConnManager(mesh)),MPI_COMM_WORLD);
+
+      dof->addField("UX",pattern_U);
+      dof->addField("UY",pattern_U);
+      dof->addField("UZ",pattern_U);
+      dof->addField("PRESSURE",pattern_P);
+      dof->addField("B",pattern_B);
+      dof->addField("E",pattern_E);
+
+      comm.barrier();
+      {
+        Teuchos::TimeMonitor tm(timer);
+        dof->buildGlobalUnknowns();
+      }
+      dofManager = dof;
+    }
+
+    const panzer::EntityDofIndex * nodes = dofManager->getEntityDofIndex(dofManager->getFieldNum("UX"),0);
+    const panzer::EntityDofIndex * edges = dofManager->getEntityDofIndex(dofManager->getFieldNum("E"),1);
+    const panzer::EntityDofIndex * faces = dofManager->getEntityDofIndex(dofManager->getFieldNum("B"),2);
+    TEUCHOS_ASSERT(nodes!=nullptr && edges!=nullptr && faces!=nullptr);
+
+    os << std::setw(10) << n*n*n
+       << std::setw(14) << nodes->numEntities()
+       << std::setw(14) << edges->numEntities()
+       << std::setw(14) << faces->numEntities()
+       << std::setw(16) << timer.totalElapsedTime()/opts.repeats << std::endl;
+  }
+}
+
+}
@@ -0,0 +1,136 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#include "Benchmarks.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "Kokkos_Core.hpp"
+
+#include "Teuchos_Assert.hpp"
+#include "Teuchos_TimeMonitor.hpp"
+
+#include "Panzer_ExprEval_impl.hpp"
+#include "Panzer_ExprProgram_impl.hpp"
+
+namespace panzer_benchmarks {
+
+namespace {
+
+using view_type = Kokkos::View<double**>;
+using const_view_type = Kokkos::View<double const**>;
+
+view_type fill(std::string const& name, int num_cells, int num_points, double offset) {
+  view_type x(name, num_cells, num_points);
+  Kokkos::parallel_for(name, Kokkos::MDRangePolicy<Kokkos::Rank<2>>({0, 0}, {num_cells, num_points}),
+      KOKKOS_LAMBDA(int cell, int point) {
+    x(cell, point) = offset + 0.001 * cell + 0.01 * point;
+  });
+  return x;
+}
+
+const_view_type eval_reference(std::string const& expr, view_type x, view_type y, double t) {
+  panzer::Expr::Eval<double**> eval;
+  panzer::Expr::set_cmath_functions(eval);
+  eval.set("x", x);
+  eval.set("y", y);
+  eval.set("t", t);
+  Teuchos::any result;
+  eval.read_string(result, expr, expr);
+  return Teuchos::any_cast<const_view_type>(result);
+}
+
+double max_difference(const_view_type a, const_view_type b) {
+  auto h_a = Kokkos::create_mirror_view(a);
+  auto h_b = Kokkos::create_mirror_view(b);
+  Kokkos::deep_copy(h_a, a);
+  Kokkos::deep_copy(h_b, b);
+  double diff = 0.0;
+  for (std::size_t i = 0; i < h_a.extent(0); ++i)
+    for (std::size_t j = 0; j < h_a.extent(1); ++j)
+      diff = std::max(diff, std::abs(h_a(i, j) - h_b(i, j)));
+  return diff;
+}
+
+}
+
+void exprProgram(const Options & opts,std::ostream & os)
+{
+  // 1M points at the default size
+  int const num_cells = std::max(1, 1000 * opts.elements / 16);
+  int const num_points = 1000;
+  std::string const source = "r2 = x^2 + y^2;\nk = 1 + 0.5 * r2;\n-k * sin(x) * cos(y) + exp(-t * r2)";
+  auto x = fill("x", num_cells, num_points, 0.0);
+  auto y = fill("y", num_cells, num_points, 0.5);
+  view_type result("result", num_cells, num_points);
+  const_view_type reference;
+
+  // parse and one temporary view per operator, every call
+  Teuchos::Time eval_timer("Expr::Eval");
+  for (int r = 0; r < opts.repeats; ++r) {
+    Teuchos::TimeMonitor tm(eval_timer);
+    reference = eval_reference(source, x, y, 0.1 * r);
+    Kokkos::fence();
+  }
+
+  // parse once, one fused kernel per call
+  Teuchos::Time program_timer("Expr::Program");
+  {
+    Teuchos::TimeMonitor tm(program_timer);
+    panzer::Expr::Program<double**> program(source);
+    program.set("x", x);
+    program.set("y", y);
+    for (int r = 0; r < opts.repeats; ++r) {
+      program.set("t", 0.1 * r);
+      program.evaluate(result);
+    }
+    Kokkos::fence();
+  }
+  TEUCHOS_ASSERT(max_difference(result, reference) <= 1.0e-12);
+
+  os << "Source term over " << num_cells * num_points << " points (" << opts.repeats << " evaluations): Expr::Eval = "
+     << eval_timer.totalElapsedTime() << " s, Expr::Program = " << program_timer.totalElapsedTime() << " s" << std::endl;
+}
+
+}
@@ -0,0 +1,216 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#include "Benchmarks.hpp"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Teuchos_Assert.hpp"
+#include "Teuchos_ParameterList.hpp"
+#include "Teuchos_TimeMonitor.hpp"
+#include "Teuchos_Tuple.hpp"
+
+#include "Panzer_IntrepidFieldPattern.hpp"
+#include "Panzer_DOFManager.hpp"
+#include "Panzer_STK_CubeHexMeshFactory.hpp"
+#include "Panzer_STK_ElementOrdering.hpp"
+#include "Panzer_STK_PeriodicBC_Matcher.hpp"
+#include "Panzer_STK_PeriodicBC_MatchConditions.hpp"
+#include "Panzer_STKConnManager.hpp"
+
+#include "Intrepid2_HGRAD_HEX_C1_FEM.hpp"
+
+namespace panzer_benchmarks {
+
+namespace {
+
+using Teuchos::RCP;
+using Teuchos::rcp;
+
+// Forwards to a matcher, but hides its type so all pairs are tested
+template <typename Matcher>
+struct AllPairsMatcher {
+  Matcher matcher;
+  bool operator()(const Teuchos::Tuple<double,3> & a,const Teuchos::Tuple<double,3> & b) const
+  { return matcher(a,b); }
+};
+
+// Nodes of a n x n grid in the plane normal to direction normal at offset
+void buildPlaneSide(int n,int normal,double offset,std::size_t firstId,
+                    std::vector<std::size_t> & ids,std::vector<Teuchos::Tuple<double,3> > & coords)
+{
+  ids.clear(); coords.clear();
+  for(int i=0;i<n;i++) {
+    for(int j=0;j<n;j++) {
+      Teuchos::Tuple<double,3> x;
+      x[normal] = offset;
+      x[(normal+1)%3] = double(i)/(n-1);
+      x[(normal+2)%3] = double(j)/(n-1);
+      coords.push_back(x);
+      ids.push_back(firstId+i*n+j);
+    }
+  }
+}
+
+RCP<panzer_stk::STK_Interface> buildOrderedHexMesh(int elmts,panzer_stk::ElementOrdering ordering)
+{
+  Teuchos::ParameterList pl;
+  pl.set<int>("X Elements",elmts);
+  pl.set<int>("Y Elements",elmts);
+  pl.set<int>("Z Elements",elmts);
+
+  panzer_stk::CubeHexMeshFactory meshFact;
+  meshFact.setParameterList(Teuchos::rcpFromRef(pl));
+
+  RCP<panzer_stk::STK_Interface> mesh = meshFact.buildMesh(MPI_COMM_WORLD);
+  mesh->setElementOrdering(ordering);
+  return mesh;
+}
+
+}
+
+void periodicMatch(const Options & opts,std::ostream & os)
+{
+  using Teuchos::Tuple;
+  typedef std::vector<std::pair<std::size_t,std::size_t> > PairVector;
+
+  // 64 nodes per element and direction, 1000 x 1000 periodic nodes at the default size
+  const int n = std::max(2,64*opts.elements);
+  std::vector<std::size_t> leftIds, rightIds;
+  std::vector<Tuple<double,3> > leftCoords, rightCoords;
+  buildPlaneSide(n,2,0.0,0,leftIds,leftCoords);
+  buildPlaneSide(n,2,1.0,n*n,rightIds,rightCoords);
+
+  panzer_stk::PlaneMatcher matcher(0,1);
+  Teuchos::Time bucketedTimer("bucketed");
+  for(int r=0;r<opts.repeats;++r) {
+    Teuchos::TimeMonitor tm(bucketedTimer);
+    RCP<PairVector> matched = panzer_stk::periodic_helpers::matchSideIdsAndCoords(leftIds,leftCoords,rightIds,rightCoords,matcher);
+    TEUCHOS_ASSERT(matched->size()==rightIds.size());
+  }
+
+  // all pairs is quadratic, only time it on a tenth of the nodes per direction
+  const int m = std::max(2,n/10);
+  buildPlaneSide(m,2,0.0,0,leftIds,leftCoords);
+  buildPlaneSide(m,2,1.0,m*m,rightIds,rightCoords);
+  AllPairsMatcher<panzer_stk::PlaneMatcher> allPairs{matcher};
+
+  Teuchos::Time allPairsTimer("all pairs");
+  RCP<PairVector> reference;
+  for(int r=0;r<opts.repeats;++r) {
+    Teuchos::TimeMonitor tm(allPairsTimer);
+    reference = panzer_stk::periodic_helpers::matchSideIdsAndCoords(leftIds,leftCoords,rightIds,rightCoords,allPairs);
+  }
+
+  // both searches give the same pairs
+  RCP<PairVector> bucketed = panzer_stk::periodic_helpers::matchSideIdsAndCoords(leftIds,leftCoords,rightIds,rightCoords,matcher);
+  TEUCHOS_ASSERT(*bucketed==*reference);
+
+  os << "Periodic side matching (" << opts.repeats << " matches): bucketed " << n*n << " nodes = "
+     << bucketedTimer.totalElapsedTime() << " s, all pairs " << m*m << " nodes = "
+     << allPairsTimer.totalElapsedTime() << " s" << std::endl;
+}
+
+void elementOrdering(const Options & opts,std::ostream & os)
+{
+  // the mean LID span touched by a workset and the time of a gather over all
+  // worksets, a proxy for the cache footprint of the assembly
+  const int elmts = std::max(2,3*opts.elements/2);
+  const std::size_t worksetSize = 64;
+
+  RCP<Intrepid2::Basis<PHX::exec_space,double,double> > basis
+     = rcp(new Intrepid2::Basis_HGRAD_HEX_C1_FEM<PHX::exec_space,double,double>);
+  RCP<const panzer::FieldPattern> pattern = rcp(new panzer::Intrepid2FieldPattern(basis));
+
+  const char * names[] = { "Native", "Morton", "RCM" };
+  for(const char * name : names) {
+    RCP<panzer_stk::STK_Interface> mesh = buildOrderedHexMesh(elmts,panzer_stk::elementOrderingFromString(name));
+
+    RCP<panzer::DOFManager> dofManager = rcp(new panzer::DOFManager());
+    dofManager->setConnManager(rcp(new panzer_stk::STKConnManager(mesh)),MPI_COMM_WORLD);
+    dofManager->addField("u",pattern);
+    dofManager->buildGlobalUnknowns();
+
+    const std::vector<panzer::LocalOrdinal> & block = dofManager->getElementBlock("eblock-0_0_0");
+
+    std::vector<std::vector<panzer::GlobalOrdinal> > elementGIDs(block.size());
+    for(std::size_t e=0;e<block.size();++e)
+      dofManager->getElementGIDs(block[e],elementGIDs[e]);
+
+    double span = 0.0;
+    std::size_t numWorksets = 0;
+    for(std::size_t begin=0;begin<block.size();begin+=worksetSize,++numWorksets) {
+      const std::size_t end = std::min(block.size(),begin+worksetSize);
+      panzer::GlobalOrdinal lo = elementGIDs[begin][0], hi = lo;
+      for(std::size_t e=begin;e<end;++e) {
+        lo = std::min(lo,*std::min_element(elementGIDs[e].begin(),elementGIDs[e].end()));
+        hi = std::max(hi,*std::max_element(elementGIDs[e].begin(),elementGIDs[e].end()));
+      }
+      span += static_cast<double>(hi-lo+1);
+    }
+    span /= numWorksets;
+
+    // the unknowns index the solution directly, sized for the largest one touched
+    panzer::GlobalOrdinal maxGID = 0;
+    for(const auto & gids : elementGIDs)
+      maxGID = std::max(maxGID,*std::max_element(gids.begin(),gids.end()));
+    std::vector<double> x(maxGID+1,1.0);
+
+    Teuchos::Time timer(name);
+    double sum = 0.0;
+    for(int r=0;r<opts.repeats;++r) {
+      Teuchos::TimeMonitor tm(timer);
+      for(const auto & gids : elementGIDs)
+        for(const auto gid : gids)
+          sum += x[gid];
+    }
+    TEUCHOS_ASSERT(sum==opts.repeats*8.0*block.size());
+
+    os << name << " ordering, " << block.size() << " elements: mean workset LID span = " << span
+       << ", gather time (" << opts.repeats << " sweeps) = " << timer.totalElapsedTime() << " s" << std::endl;
+  }
+}
+
+}
@@ -0,0 +1,201 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#include "Benchmarks.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "Kokkos_Core.hpp"
+
+#include "Teuchos_Assert.hpp"
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_TimeMonitor.hpp"
+
+#include "Panzer_CellData.hpp"
+#include "Panzer_IntegrationRule.hpp"
+#include "Panzer_IntegrationValues2.hpp"
+#include "Panzer_BasisIRLayout.hpp"
+#include "Panzer_BasisValues2.hpp"
+#include "Panzer_TensorProductBasis.hpp"
+#include "Panzer_CommonArrayFactories.hpp"
+#include "Panzer_Traits.hpp"
+
+namespace panzer_benchmarks {
+
+namespace {
+
+using Teuchos::RCP;
+using Teuchos::rcp;
+
+// integration and basis values on a row of distorted hexahedra
+struct HexValues {
+  RCP<panzer::IntegrationRule> ir;
+  RCP<panzer::IntegrationValues2<double> > iv;
+  RCP<panzer::BasisValues2<double> > bv;
+
+  HexValues(const int numCells,const int order)
+  {
+    RCP<shards::CellTopology> topo
+       = rcp(new shards::CellTopology(shards::getCellTopologyData<shards::Hexahedron<8> >()));
+    const panzer::CellData cellData(numCells,topo);
+    ir = rcp(new panzer::IntegrationRule(2*order,cellData));
+
+    iv = rcp(new panzer::IntegrationValues2<double>("",true));
+    iv->setupArrays(ir);
+
+    panzer::MDFieldArrayFactory af("",true);
+    auto nodes = af.buildStaticArray<double,panzer::Cell,panzer::NODE,panzer::Dim>("nodes",numCells,8,3);
+    const double ref[8][3] = {{0,0,0},{1,0,0},{1,1,0},{0,1,0},
+                              {0,0,1},{1,0,1},{1,1,1},{0,1,1}};
+    auto nodesHost = Kokkos::create_mirror_view(nodes.get_static_view());
+    for(int c=0;c<numCells;c++)
+      for(int v=0;v<8;v++)
+        for(int d=0;d<3;d++)
+          nodesHost(c,v,d) = ref[v][d] + (d==0 ? c : 0.0) + 0.1*std::sin(1.0+c+3.0*v+7.0*d);
+    Kokkos::deep_copy(nodes.get_static_view(),nodesHost);
+    iv->evaluateValues(nodes);
+
+    RCP<panzer::BasisIRLayout> layout = rcp(new panzer::BasisIRLayout("HGrad",order,*ir));
+    bv = rcp(new panzer::BasisValues2<double>("",true,true));
+    bv->setupArrays(layout);
+    bv->evaluateValues(iv->cub_points,iv->jac,iv->jac_det,iv->jac_inv,iv->weighted_measure,nodes);
+  }
+};
+
+double maxRelativeDifference(const PHX::View<double**> & a,const PHX::View<double**> & b)
+{
+  auto hostA = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),a);
+  auto hostB = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),b);
+  double diff = 0.0, scale = 0.0;
+  for(std::size_t i=0;i<hostA.extent(0);i++) {
+    for(std::size_t j=0;j<hostA.extent(1);j++) {
+      diff = std::max(diff,std::abs(hostA(i,j)-hostB(i,j)));
+      scale = std::max(scale,std::abs(hostB(i,j)));
+    }
+  }
+  return scale>0.0 ? diff/scale : diff;
+}
+
+}
+
+void sumFactorization(const Options & opts,std::ostream & os)
+{
+  // the expanded order 4 arrays hold 125x125x3 doubles per cell
+  const int numCells = std::max(1,opts.elements*opts.elements);
+
+  for(int order=1;order<=4;order++) {
+    HexValues values(numCells,order);
+    panzer::TensorProductBasis tp("HGrad",order,*values.iv);
+
+    const int numBasis = tp.numBasis();
+    const int numPoints = tp.numPoints();
+
+    PHX::View<double**> coeffs("coeffs",numCells,numBasis);
+    auto coeffsHost = Kokkos::create_mirror_view(coeffs);
+    for(int c=0;c<numCells;c++)
+      for(int b=0;b<numBasis;b++)
+        coeffsHost(c,b) = std::sin(1.0+c+0.3*b);
+    Kokkos::deep_copy(coeffs,coeffsHost);
+
+    auto jacInv = values.iv->jac_inv.get_static_view();
+    auto wm = values.iv->weighted_measure.get_static_view();
+    auto gradBasis = values.bv->grad_basis.get_static_view();
+    auto weightedGradBasis = values.bv->getGradBasisValues(true).get_static_view();
+
+    // the flux is the interpolated gradient, as in a diffusion operator
+    PHX::View<double***> grad("grad",numCells,numPoints,3);
+    PHX::View<double***> refFlux("refFlux",numCells,numPoints,3);
+    PHX::View<double**> expanded("expanded",numCells,numBasis);
+    PHX::View<double**> factorized("factorized",numCells,numBasis);
+    PHX::View<double**> scratch("scratch",numCells,tp.scratchSize());
+
+    Teuchos::Time expandedTimer("expanded p="+std::to_string(order));
+    for(int r=0;r<opts.repeats;r++) {
+      Teuchos::TimeMonitor tm(expandedTimer);
+      Kokkos::parallel_for("expanded",Kokkos::RangePolicy<PHX::exec_space>(0,numCells),KOKKOS_LAMBDA(const int c) {
+        for(int q=0;q<numPoints;q++) {
+          for(int d=0;d<3;d++) {
+            grad(c,q,d) = 0.0;
+            for(int b=0;b<numBasis;b++)
+              grad(c,q,d) += coeffs(c,b)*gradBasis(c,b,q,d);
+          }
+        }
+        for(int b=0;b<numBasis;b++) {
+          expanded(c,b) = 0.0;
+          for(int q=0;q<numPoints;q++)
+            for(int d=0;d<3;d++)
+              expanded(c,b) += weightedGradBasis(c,b,q,d)*grad(c,q,d);
+        }
+      });
+      Kokkos::fence();
+    }
+
+    Teuchos::Time factorizedTimer("sum factorized p="+std::to_string(order));
+    for(int r=0;r<opts.repeats;r++) {
+      Teuchos::TimeMonitor tm(factorizedTimer);
+      Kokkos::parallel_for("sum factorized",Kokkos::RangePolicy<PHX::exec_space>(0,numCells),KOKKOS_LAMBDA(const int c) {
+        tp.evaluateGradient(c,coeffs,jacInv,grad,scratch);
+        for(int q=0;q<numPoints;q++) {
+          for(int e=0;e<3;e++) {
+            refFlux(c,q,e) = 0.0;
+            for(int d=0;d<3;d++)
+              refFlux(c,q,e) += wm(c,q)*jacInv(c,q,e,d)*grad(c,q,d);
+          }
+        }
+        for(int b=0;b<numBasis;b++)
+          factorized(c,b) = 0.0;
+        tp.integrateGradient(c,refFlux,factorized,scratch);
+      });
+      Kokkos::fence();
+    }
+    TEUCHOS_ASSERT(maxRelativeDifference(factorized,expanded) <= 1.0e-10);
+
+    const double cells = static_cast<double>(numCells)*opts.repeats;
+    os << "Hexahedra of order " << order << ", " << numBasis << " basis functions, " << numPoints
+       << " points: expanded = " << cells/expandedTimer.totalElapsedTime() << " cells/s, sum factorized = "
+       << cells/factorizedTimer.totalElapsedTime() << " cells/s" << std::endl;
+  }
+}
+
+}
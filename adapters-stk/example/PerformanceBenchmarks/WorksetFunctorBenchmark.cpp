@@ -0,0 +1,98 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#include "Benchmarks.hpp"
+
+#include "Kokkos_Core.hpp"
+
+#include "Teuchos_Assert.hpp"
+#include "Teuchos_TimeMonitor.hpp"
+
+#include "TianXin_WorksetFunctor.hpp"
+
+namespace panzer_benchmarks {
+
+void worksetFunctor(const Options & opts,std::ostream & os)
+{
+  using TianXin::WorksetFunctor;
+
+  Teuchos::ParameterList p("Dirichlet");
+  p.set("Value Type","TimeTable");
+  Teuchos::ParameterList& pt = p.sublist("TimeTable");
+  pt.set<Teuchos::Array<double> >("Time Values",Teuchos::tuple<double>( 0.0, 1.0, 2.0 ));
+  pt.set<Teuchos::Array<double> >("BC Values",Teuchos::tuple<double>( 0.0, 10.0, 30.0 ));
+  auto functor = TianXin::WorksetFunctorFactory::Instance().Create("TimeTable", p);
+
+  // as many dofs as the nodes of a second order hex mesh
+  const std::size_t ndofs = 8*opts.elements*opts.elements*opts.elements;
+  WorksetFunctor::DofView dofs("dofs",ndofs);
+  WorksetFunctor::ValueView values("values",ndofs);
+  WorksetFunctor::ValueView values_ref("values_ref",ndofs);
+
+  panzer::Workset wk;
+  wk.time = 0.25;
+
+  Teuchos::Time perDofTimer("per dof"), batchedTimer("batched");
+  for( int r=0; r<opts.repeats; ++r ) {
+    Teuchos::TimeMonitor tm(perDofTimer);
+    auto values_h = Kokkos::create_mirror_view(values_ref);
+    for( std::size_t i=0; i<ndofs; ++i )
+      values_h(i) = (*functor)(wk);
+    Kokkos::deep_copy(values_ref, values_h);
+    Kokkos::fence();
+  }
+  for( int r=0; r<opts.repeats; ++r ) {
+    Teuchos::TimeMonitor tm(batchedTimer);
+    functor->evaluate(wk, dofs, values);
+    Kokkos::fence();
+  }
+
+  auto values_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), values);
+  auto values_ref_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), values_ref);
+  for( std::size_t i=0; i<ndofs; ++i )
+    TEUCHOS_ASSERT(values_h(i)==values_ref_h(i));
+
+  os << "TimeTable functor, " << ndofs << " dofs, " << opts.repeats << " evaluations: per dof = "
+     << perDofTimer.totalElapsedTime() << " s, batched = " << batchedTimer.totalElapsedTime() << " s" << std::endl;
+}
+
+}
@@ -0,0 +1,160 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Kokkos_Core.hpp"
+
+#include "Teuchos_GlobalMPISession.hpp"
+#include "Teuchos_CommandLineProcessor.hpp"
+#include "Teuchos_DefaultMpiComm.hpp"
+#include "Teuchos_TimeMonitor.hpp"
+#include "Teuchos_ParameterList.hpp"
+#include "Teuchos_oblackholestream.hpp"
+
+#include "PanzerDiscFE_config.hpp"
+
+#include "Benchmarks.hpp"
+
+// Performance benchmarks kept out of the unit tests, run all of them or one
+// selected with --benchmark.
+
+namespace {
+
+struct Benchmark {
+  std::string name;
+  void (*run)(const panzer_benchmarks::Options &,std::ostream &);
+};
+
+const std::vector<Benchmark> & benchmarks()
+{
+  static const std::vector<Benchmark> list = {
+    {"workset_functor",panzer_benchmarks::worksetFunctor},
+    {"dof_info_scaling",panzer_benchmarks::dofInfoScaling},
+    {"concurrent_volume",panzer_benchmarks::concurrentVolume},
+    {"precomputed_crs_offsets",panzer_benchmarks::precomputedCrsOffsets},
+    {"overlapped_ghost_exchange",panzer_benchmarks::overlappedGhostExchange},
+    {"linear_element_matrices",panzer_benchmarks::linearElementMatrices},
+    {"jacobian_fad_capacity",panzer_benchmarks::jacobianFadCapacity},
+    {"blocked_crs_offsets",panzer_benchmarks::blockedCrsOffsets},
+    {"periodic_match",panzer_benchmarks::periodicMatch},
+    {"element_ordering",panzer_benchmarks::elementOrdering},
+    {"sum_factorization",panzer_benchmarks::sumFactorization},
+#ifdef PANZER_HAVE_EXPREVAL
+    {"expr_program",panzer_benchmarks::exprProgram},
+#endif
+  };
+  return list;
+}
+
+}
+
+int main(int argc,char * argv[])
+{
+  Teuchos::GlobalMPISession mpiSession(&argc, &argv);
+  Kokkos::initialize(argc,argv);
+
+  int status = 0;
+  {
+    Teuchos::MpiComm<int> comm(MPI_COMM_WORLD);
+
+    panzer_benchmarks::Options opts;
+    std::string selected = "all";
+    std::string timingsFile = "";
+
+    std::string names;
+    for(const auto & b : benchmarks())
+      names += " " + b.name;
+
+    Teuchos::CommandLineProcessor clp;
+    clp.setOption("benchmark",&selected,("Benchmark to run, \"all\" or one of:"+names).c_str());
+    clp.setOption("elements",&opts.elements,"Elements per direction of the benchmark meshes");
+    clp.setOption("repeats",&opts.repeats,"Timed evaluations per code path");
+    clp.setOption("timings-file",&timingsFile);
+    auto cmdResult = clp.parse(argc,argv);
+    if(cmdResult!=Teuchos::CommandLineProcessor::PARSE_SUCCESSFUL) {
+      clp.printHelpMessage(argv[0],std::cout);
+      return -1;
+    }
+
+    // only rank 0 reports, all ranks run
+    Teuchos::oblackholestream blackhole;
+    std::ostream & os = comm.getRank()==0 ? std::cout : blackhole;
+
+    bool found = false;
+    for(const auto & b : benchmarks()) {
+      if(selected!="all" && selected!=b.name)
+        continue;
+      found = true;
+
+      os << "=== " << b.name << " ===" << std::endl;
+      b.run(opts,os);
+    }
+
+    if(!found) {
+      os << "Unknown benchmark \"" << selected << "\", available:" << names << std::endl;
+      status = -1;
+    }
+    else {
+      Teuchos::TimeMonitor::summarize(os,false,true,false);
+
+      if ( timingsFile != "" ){
+        std::ofstream fout(timingsFile.c_str());
+        Teuchos::RCP<Teuchos::ParameterList> reportParams = parameterList(* (Teuchos::TimeMonitor::getValidReportParameters()));
+        reportParams->set("Report format", "YAML");
+        reportParams->set("YAML style", "spacious");
+        Teuchos::TimeMonitor::report(fout,reportParams);
+      }
+
+      // this confirms the application passes
+      os << "Performance benchmarks completed" << std::endl;
+    }
+  }
+
+  Kokkos::finalize();
+
+  return status;
+}
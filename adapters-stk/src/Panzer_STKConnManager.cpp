@@ -115,6 +115,9 @@ void STKConnManager::buildLocalElementMapping()
       std::vector<stk::mesh::Entity> blockElmts;
       stkMeshDB_->getMyElements(blockId,blockElmts);
 
+      // follow the local ID order (and so the mesh element ordering) within the block
+      std::sort(blockElmts.begin(),blockElmts.end(),LocalIdCompare(stkMeshDB_));
+
       // concatenate them into element LID lookup table
       elements_.insert(elements_.end(),blockElmts.begin(),blockElmts.end());
 
@@ -454,6 +457,11 @@ getElementalEdges(const LocalOrdinal& elmtLid, std::vector<GlobalOrdinal>& edges
 void STKConnManager::
 getElementalFaces(const LocalOrdinal& elmtLid, std::vector<GlobalOrdinal>& facesgid) const
 {
+	 // a 2D mesh has no face entities, the cell is its own face
+	 if(stkMeshDB_->getDimension()==2) {
+	   facesgid.assign(1,stkMeshDB_->elementGlobalId(elmtLid));
+	   return;
+	 }
 	 stkMeshDB_->getFaceIdsForElement(elmtLid,facesgid);
 }
 
@@ -245,7 +245,8 @@ public:
     void getElementalEdges(const LocalOrdinal& elmtLid, std::vector<GlobalOrdinal>& nodesgid) const;
     int getEdgeRank() const final {return stkMeshDB_->getEdgeRank();}
 	
-	/** Get the node connectivity of a given element
+	/** Get the face connectivity of a given element. On a 2D mesh this is
+     * the global ID of the element itself.
      *
      * \param[in] elmtLid elemental local index
      *
@@ -169,10 +169,23 @@ namespace panzer_stk {
         p.set<int>("Default Integration Order",-1);
         p.set<std::string>("Field Order","");
         p.set<std::string>("Auxiliary Field Order","");
+        p.set<std::string>("Element Ordering","Native");
         p.set<bool>("Load Balance DOFs",false);
         p.set<bool>("Use Tpetra",false);
         p.set<bool>("Use Epetra ME",true);
         p.set<bool>("Lump Explicit Mass",false);
+        p.set<bool>("Element Block Inverse Explicit Mass",false);
+        p.set<bool>("Element Local Lumped Explicit Mass",false);
+        p.set<bool>("Cache Side Workset Values",true);
+        p.set<bool>("Concurrent Volume Assembly",false);
+        p.set<int>("Concurrent Volume Workers",4);
+        p.set<bool>("Overlap Ghost Exchange",false);
+        p.set<bool>("Cache Workset Geometry",false);
+        p.set<double>("Workset Geometry Cache Budget (MB)",0.0);
+        p.set<bool>("Freeze Jacobian Graph",false);
+        p.set<bool>("Precompute Jacobian Offsets",false);
+        p.set<bool>("Sum Factorization",false);
+        p.set<bool>("Fused Response Evaluation",false);
         p.set<bool>("Constant Mass Matrix",true);
         p.set<bool>("Apply Mass Matrix Inverse in Explicit Evaluator",true);
         p.set<bool>("Use Conservative IMEX",false);
@@ -389,6 +402,9 @@ namespace panzer_stk {
        throw ebexp;
     }
 
+    // element local ids (and so worksets and DOF numbering) follow this ordering
+    mesh->setElementOrdering(panzer_stk::elementOrderingFromString(assembly_params.get<std::string>("Element Ordering")));
+
     mesh->print(fout);
     if(p.sublist("Output").get<bool>("Write to Exodus"))
       mesh->setupExodusFile(p.sublist("Output").get<std::string>("File Name"));
@@ -528,7 +544,10 @@ namespace panzer_stk {
          checkInterfaceConnections(conn_manager, dofManager->getComm());
 
        TEUCHOS_ASSERT(!useDiscreteAdjoint); // safety check
-       linObjFactory = Teuchos::rcp(new panzer::TpetraLinearObjFactory<panzer::Traits,double,int,panzer::GlobalOrdinal>(mpi_comm,dofManager));
+       Teuchos::RCP<panzer::TpetraLinearObjFactory<panzer::Traits,double,int,panzer::GlobalOrdinal> > tLinObjFactory
+         = Teuchos::rcp(new panzer::TpetraLinearObjFactory<panzer::Traits,double,int,panzer::GlobalOrdinal>(mpi_comm,dofManager));
+       tLinObjFactory->setFrozenGraphAssembly(assembly_params.get<bool>("Freeze Jacobian Graph"));
+       linObjFactory = tLinObjFactory;
 
        // build load balancing string for informative output
        loadBalanceString = printUGILoadBalancingInformation(*dofManager);
@@ -577,6 +596,12 @@ namespace panzer_stk {
        = Teuchos::rcp(new panzer::WorksetContainer(wkstFactory,needs));
 
     wkstContainer->setWorksetSize(workset_size);
+    wkstContainer->setCacheSideWorksetValues(assembly_params.get<bool>("Cache Side Workset Values"));
+    if(assembly_params.get<bool>("Cache Workset Geometry")) {
+      Teuchos::RCP<panzer::WorksetGeometryCache> geometryCache = Teuchos::rcp(new panzer::WorksetGeometryCache);
+      geometryCache->setMemoryBudget(static_cast<std::size_t>(assembly_params.get<double>("Workset Geometry Cache Budget (MB)")*1024.0*1024.0));
+      wkstContainer->setGeometryCache(geometryCache);
+    }
     wkstContainer->setGlobalIndexer(globalIndexer); // set the global indexer so the orientations are evaluated
 
     m_wkstContainer = wkstContainer;
@@ -589,6 +614,8 @@ namespace panzer_stk {
       max_wksets = std::max(max_wksets,works->size());
     }
     user_data_params.set<std::size_t>("Max Worksets",max_wksets);
+    user_data_params.set<bool>("Precompute Jacobian Offsets",assembly_params.get<bool>("Precompute Jacobian Offsets"));
+    user_data_params.set<bool>("Sum Factorization",assembly_params.get<bool>("Sum Factorization"));
     wkstContainer->clear(); 
 
     // Setup lagrangian type coordinates
@@ -752,6 +779,13 @@ namespace panzer_stk {
                                      is_transient,
                                      t_init);
 
+    // sweep the responses with the residual when both are requested
+    {
+      Teuchos::RCP<PanzerME> panzer_me = Teuchos::rcp_dynamic_cast<PanzerME>(thyra_me);
+      if(panzer_me!=Teuchos::null)
+        panzer_me->setFusedResponseEvaluation(assembly_params.get<bool>("Fused Response Evaluation"));
+    }
+
     m_physics_me = thyra_me;
   }
 
@@ -1177,6 +1211,11 @@ namespace panzer_stk {
   {
     Teuchos::RCP<panzer::FieldManagerBuilder> fmb = Teuchos::rcp(new panzer::FieldManagerBuilder);
     fmb->setWorksetContainer(wc);
+    if(this->getParameterList()!=Teuchos::null) {
+      fmb->setConcurrentVolumeAssembly(this->getParameterList()->sublist("Assembly").template get<bool>("Concurrent Volume Assembly"),
+                                       this->getParameterList()->sublist("Assembly").template get<int>("Concurrent Volume Workers"));
+      fmb->setOverlapGhostExchange(this->getParameterList()->sublist("Assembly").template get<bool>("Overlap Ghost Exchange"));
+    }
     fmb->setupVolumeFieldManagers(physicsBlocks,volume_cm_factory,closure_models,lo_factory,user_data);
     fmb->setupBCFieldManagers(bcs,physicsBlocks,eqset_factory,bc_cm_factory,bc_factory,closure_models,lo_factory,user_data);
 
@@ -1350,7 +1389,11 @@ namespace panzer_stk {
       if(is_explicit) {
         const Teuchos::ParameterList & assembly_params = p.sublist("Assembly");
         bool lumpExplicitMass = assembly_params.get<bool>("Lump Explicit Mass");
-        thyra_me = Teuchos::rcp(new panzer::ExplicitModelEvaluator<ScalarT>(thyra_me,!useDynamicCoordinates_,lumpExplicitMass));
+        bool blockInverseExplicitMass = assembly_params.get<bool>("Element Block Inverse Explicit Mass");
+        bool elementLocalLumpedExplicitMass = assembly_params.get<bool>("Element Local Lumped Explicit Mass");
+        thyra_me = Teuchos::rcp(new panzer::ExplicitModelEvaluator<ScalarT>(thyra_me,!useDynamicCoordinates_,lumpExplicitMass,
+                                                                            true,blockInverseExplicitMass,
+                                                                            elementLocalLumpedExplicitMass));
       }
 
       return thyra_me;
@@ -309,10 +309,24 @@ buildBCWorkset(const panzer_stk::STK_Interface & mesh,
 				const std::string & eblockID,
                 const std::string & sidesetID)
 {
-	panzer::MDFieldArrayFactory mdArrayFactory("",true);
-	
-	Teuchos::RCP<panzer::Workset> workset = Teuchos::rcp(new panzer::Workset);
-  //stk::mesh::SideSet sideset =  mesh.getSTKSideset(sidesetID);
+  // the whole sideset in a single workset
+  Teuchos::RCP<std::vector<panzer::Workset> > worksets = buildBCWorksetChunks(mesh,needs,eblockID,sidesetID,-1,true);
+  if(worksets->empty()) return Teuchos::null;
+
+  return Teuchos::rcp(new panzer::Workset(worksets->front()));
+}
+
+Teuchos::RCP<std::vector<panzer::Workset> >
+buildBCWorksetChunks(const panzer_stk::STK_Interface & mesh,
+                     const panzer::WorksetNeeds & needs,
+                     const std::string & eblockID,
+                     const std::string & sidesetID,
+                     const int worksetSize,
+                     const bool populateValues)
+{
+  panzer::MDFieldArrayFactory mdArrayFactory("",true);
+
+  Teuchos::RCP<std::vector<panzer::Workset> > worksets = Teuchos::rcp(new std::vector<panzer::Workset>);
 
   std::vector<stk::mesh::Entity> sideEntities; 
   try {
@@ -329,7 +343,6 @@ buildBCWorkset(const panzer_stk::STK_Interface & mesh,
      TEUCHOS_TEST_FOR_EXCEPTION_PURE_MSG(true,std::logic_error,ss.str());
   }
 
-  
   std::vector<stk::mesh::Entity> elements;
   std::vector<std::size_t> local_cell_ids;
   std::vector<std::size_t> local_side_ids;
@@ -338,57 +351,57 @@ buildBCWorkset(const panzer_stk::STK_Interface & mesh,
   for(const auto& ele : elements) {
 	local_cell_ids.push_back(mesh.elementLocalId(ele));
   }
- 
- // std::vector<stk::mesh::SideSetEntry>::const_iterator itr=sideset.begin();
-  /* P.A.: Get cell toplogy (belongs to first element). For covenient, we suppose all elements have the same topo*/
-  //const auto& topo = stk::mesh::get_cell_topology(bulkData_->bucket(itr->element).topology());
-  
- // std::vector<SideSetEntry>::iterator lowerBound = std::lower_bound(sideset->begin(), sideset->end(), SideSetEntry(entity, 0));
- // std::vector<SideSetEntry>::iterator upperBound = std::upper_bound( sideset->begin(), sideset->end(), SideSetEntry(entity, INVALID_CONNECTIVITY_ORDINAL));
- // for(itr=sideset.begin();itr!=sideset.end();++itr) {
-//	  const auto& ele = itr->element;
-//	  local_cell_ids.emplace_back(mesh.elementLocalId(ele));
-//	  local_side_ids.emplace_back(itr->side);
-//  }
 
   // It is supposed that all elements in sideset have the same topology
-  if(local_cell_ids.empty()) return Teuchos::null;
-
+  if(local_cell_ids.empty()) return worksets;
+
+  Kokkos::DynRankView<double,PHX::Device> vertices;
+  mesh.getElementVertices(local_cell_ids, vertices);
+  auto vertices_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), vertices);
+
+  const std::size_t numCells = local_cell_ids.size();
+  const std::size_t chunkSize = (worksetSize>0) ? std::min(static_cast<std::size_t>(worksetSize),numCells) : numCells;
+  const std::size_t numChunks = (numCells+chunkSize-1)/chunkSize;
+  worksets->resize(numChunks);
+
+  for(std::size_t c=0;c<numChunks;c++) {
+    const std::size_t begin = c*chunkSize;
+    const std::size_t n = std::min(chunkSize,numCells-begin);
+    panzer::Workset & workset = (*worksets)[c];
+
+    workset.cell_vertex_coordinates = mdArrayFactory.buildStaticArray<double,panzer::Cell,panzer::NODE,panzer::Dim>(
+        "WorksetCoord", n, vertices.extent(1), vertices.extent(2));
+    auto coords_view = workset.cell_vertex_coordinates.get_view();
+    auto coords_h = Kokkos::create_mirror_view(coords_view);
+
+    auto cell_local_ids_k = PHX::View<int*>("Workset:cell_local_ids", n);
+    auto cell_local_ids_k_h = Kokkos::create_mirror_view(cell_local_ids_k);
+    auto local_side_ordinals = PHX::View<int*>("Workset:side_ordinals", n);
+    auto local_side_ids_h = Kokkos::create_mirror_view(local_side_ordinals);
+
+    for (std::size_t cell = 0; cell < n; ++cell) {
+      workset.cell_local_ids.push_back(local_cell_ids[begin+cell]);
+      cell_local_ids_k_h(cell) = local_cell_ids[begin+cell];
+      local_side_ids_h(cell) = local_side_ids[begin+cell];
+      for (std::size_t v = 0; v < vertices.extent(1); ++v)
+        for (std::size_t d = 0; d < vertices.extent(2); ++d)
+          coords_h(cell,v,d) = vertices_h(begin+cell,v,d);
+    }
+    Kokkos::deep_copy(coords_view, coords_h);
+    Kokkos::deep_copy(cell_local_ids_k, cell_local_ids_k_h);
+    Kokkos::deep_copy(local_side_ordinals, local_side_ids_h);
+    workset.block_id = eblockID;
+    workset.cell_local_ids_k = cell_local_ids_k;
+    workset.local_side_ordinals = local_side_ordinals;
+    workset.num_cells = n;
+    workset.subcell_dim = needs.cellData.baseCellDimension() - 1;
+    workset.subcell_index = local_side_ids[begin];   //used to determine subcell topo. Should it be deleted? in case local_side_ordinals be defined
+
+    if(populateValues)
+      panzer::populateValueArrays(workset.num_cells,true,needs,workset); // populate "side" values
+  }
 
-    Kokkos::DynRankView<double,PHX::Device> vertices;
-    mesh.getElementVertices(local_cell_ids, vertices);
-	
-	workset->cell_vertex_coordinates = mdArrayFactory.buildStaticArray<double,panzer::Cell,panzer::NODE,panzer::Dim>(
-        "WorksetCoord", vertices.extent(0), vertices.extent(1), vertices.extent(2));
-	auto coords_view = workset->cell_vertex_coordinates.get_view();
-	Kokkos::deep_copy(coords_view, vertices);
-	
-	auto cell_local_ids_k = PHX::View<int*>("Workset:cell_local_ids", local_cell_ids.size());
-	auto cell_local_ids_k_h = Kokkos::create_mirror_view(cell_local_ids_k);
-	auto local_side_ordinals = PHX::View<int*>("Workset:side_ordinals", local_cell_ids.size());
-	auto local_side_ids_h = Kokkos::create_mirror_view(local_side_ordinals);
-	
-	for (std::size_t cell = 0; cell < local_cell_ids.size(); ++cell) {
-      workset->cell_local_ids.push_back(local_cell_ids[cell]);
-	  cell_local_ids_k_h(cell) = local_cell_ids[cell];
-	  local_side_ids_h(cell) = local_side_ids[cell];
-	}
-	Kokkos::deep_copy(cell_local_ids_k, cell_local_ids_k_h);
-	Kokkos::deep_copy(local_side_ordinals, local_side_ids_h);
-	workset->block_id = eblockID;
-	workset->cell_local_ids_k = cell_local_ids_k;
-	workset->local_side_ordinals = local_side_ordinals;
-	workset->num_cells = local_cell_ids.size();
-	workset->subcell_dim = needs.cellData.baseCellDimension() - 1;
-    workset->subcell_index = local_side_ids[0];   //used to determine subcell topo. Should it be deleted? in case local_side_ordinals be defined
-	
-	panzer::populateValueArrays(workset->num_cells,true,needs,*workset); // populate "side" values
-	
-	return workset;
-//	std::string eblockID("");
-  
- // return panzer::buildBCWorkset(needs, eblockID, local_cell_ids, local_side_ids, vertices);
-  
+  return worksets;
 }
 
 namespace workset_utils { 
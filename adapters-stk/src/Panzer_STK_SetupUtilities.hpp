@@ -141,6 +141,26 @@ buildBCWorkset(const panzer_stk::STK_Interface & mesh,
                 const std::string & eblockID,
                 const std::string & sidesetID);
 
+/** Build boundary condition worksets for a STK mesh, splitting the sideset
+  * into worksets of at most <code>worksetSize</code> cells.
+  *
+  * \param[in] mesh A pointer to the STK_Interface used to construct the worksets
+  * \param[in] needs Physics block associated with the element block
+  * \param[in] eblockID Name of element block
+  * \param[in] sidesetID Name of sideset
+  * \param[in] worksetSize Maximum cells per workset, the whole sideset goes in one workset if <=0
+  * \param[in] populateValues Compute the basis and integration values of each workset
+  *
+  * \returns Worksets in sideset order, empty if this processor owns no side.
+  */
+Teuchos::RCP<std::vector<panzer::Workset> >
+buildBCWorksetChunks(const panzer_stk::STK_Interface & mesh,
+                     const panzer::WorksetNeeds & needs,
+                     const std::string & eblockID,
+                     const std::string & sidesetID,
+                     const int worksetSize,
+                     const bool populateValues);
+
 // namespace may not be neccssary in the future, currently avoids
 // collisions with previously implemented code in tests
 namespace workset_utils { 
@@ -43,6 +43,8 @@
 #ifndef PANZER_STK_SETUP_UTILITIES_IMPL_HPP
 #define PANZER_STK_SETUP_UTILITIES_IMPL_HPP
 
+#include <algorithm>
+
 namespace panzer_stk {
 namespace workset_utils {
 
@@ -54,6 +56,10 @@ void getIdsAndVertices(const panzer_stk::STK_Interface& mesh,
   
   std::vector<stk::mesh::Entity> elements;
   mesh.getMyElements(blockId,elements);
+
+  // follow the local ID order, so worksets match the mesh element ordering
+  std::sort(elements.begin(),elements.end(),
+            [&](stk::mesh::Entity a,stk::mesh::Entity b) { return mesh.elementLocalId(a)<mesh.elementLocalId(b); });
   
   // loop over elements of this block
   for(std::size_t elm=0;elm<elements.size();++elm) {
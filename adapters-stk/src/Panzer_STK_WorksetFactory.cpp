@@ -48,9 +48,41 @@
 #include "Panzer_CommonArrayFactories.hpp"
 
 #include <algorithm>
+#include <exception>
+#include <type_traits>
+#include <utility>
 
 namespace panzer_stk {
 
+namespace {
+
+using CellVertexField = PHX::MDField<double,panzer::Cell,panzer::NODE,panzer::Dim>;
+using CellVertexView = CellVertexField::array_type;
+using CellVertexRange = decltype(Kokkos::subview(std::declval<CellVertexView>(),std::pair<int,int>(),Kokkos::ALL(),Kokkos::ALL()));
+
+// A range of cells is contiguous in the block allocation, the workset views it directly
+void setCellVertexSubview(CellVertexField & field,CellVertexField block,int begin,int end,std::true_type)
+{
+   CellVertexView range = Kokkos::subview(block.get_static_view(),std::make_pair(begin,end),Kokkos::ALL(),Kokkos::ALL());
+   field.setFieldData(range);
+}
+
+// The device layout strides cells, the workset gets a copy of its range
+void setCellVertexSubview(CellVertexField & field,CellVertexField block,int begin,int end,std::false_type)
+{
+   CellVertexView range("cvc",end-begin,block.extent(1),block.extent(2));
+   Kokkos::deep_copy(range,Kokkos::subview(block.get_static_view(),std::make_pair(begin,end),Kokkos::ALL(),Kokkos::ALL()));
+   field.setFieldData(range);
+}
+
+void setCellVertexSubview(CellVertexField & field,const CellVertexField & block,int begin,int end)
+{
+   setCellVertexSubview(field,block,begin,end,
+                        std::integral_constant<bool,std::is_same<CellVertexRange::array_layout,CellVertexView::array_layout>::value>());
+}
+
+}
+
 /** Set mesh
   */
 void WorksetFactory::setMesh(const Teuchos::RCP<const panzer_stk::STK_Interface> & mesh)
@@ -76,6 +108,18 @@ getSideWorkset(const panzer::WorksetDescriptor & desc,
   return panzer_stk::buildBCWorkset(*mesh_,needs,desc.getElementBlock(0),desc.getSideset());
 }
 
+Teuchos::RCP<std::vector<panzer::Workset> > WorksetFactory::
+getSideWorksetChunks(const panzer::WorksetDescriptor & desc,
+                     const panzer::WorksetNeeds & needs,
+                     const int worksetSize,
+                     const bool populateValues) const
+{
+  TEUCHOS_ASSERT(desc.useSideset());
+
+  return panzer_stk::buildBCWorksetChunks(*mesh_,needs,desc.getElementBlock(0),desc.getSideset(),
+                                          worksetSize,populateValues);
+}
+
 Teuchos::RCP<std::map<unsigned,panzer::Workset> > WorksetFactory::
 getSideWorksets(const panzer::WorksetDescriptor & desc,
                 const panzer::WorksetNeeds & needs_a,
@@ -127,247 +171,144 @@ Teuchos::RCP<std::vector<panzer::Workset> > WorksetFactory::
 WorksetFactory :: generateWorksets(const panzer::WorksetDescriptor& worksetDesc,
     const panzer::WorksetNeeds& needs ) const
 {
-	using LO = panzer::LocalOrdinal;
-	panzer::MDFieldArrayFactory mdArrayFactory("",true);
-	
-	Teuchos::RCP<std::vector<panzer::Workset> > worksets_ptr = Teuchos::rcp(new std::vector<panzer::Workset>);
-	int myrank = mesh_->getComm()->getRank();
-	
-//	std::vector<panzer::GlobalOrdinal> coords;
-//	Teuchos::RCP<stk::mesh::MetaData> metaData = mesh_->getMetaData();
-//    Teuchos::RCP<stk::mesh::BulkData> bulkData = mesh_->getBulkData();
-	std::vector<panzer::LocalOrdinal> local_cell_ids;
-	std::vector<stk::mesh::Entity> elements;
-	
-	const std::string& element_block_name = worksetDesc.getElementBlock();
-	Teuchos::RCP<const shards::CellTopology> topo = mesh_->getCellTopology(element_block_name);
-	const int n_dim = topo->getDimension();
-	const int n_nodes = topo->getNodeCount();
 	const int n_celldata = needs.cellData.numCells();
-	const int n_sides = topo->getSubcellCount(n_dim-1);
-	
-/*	if(worksetDesc.useSideset()){
-		std::vector<stk::mesh::Entity> sideEntities;
-		mesh_->getMySides(worksetDesc.getSideset(),element_block_name,sideEntities);
-		if( sideEntities.empty() ) return;   // no entity in current cpu
-		std::vector<std::size_t> local_side_ids;
-		panzer_stk::workset_utils::getSideElements(*mesh_, element_block_name,sideEntities,local_side_ids,elements);
-		for(const auto& element: elements) {
-			local_cell_ids.emplace_back(mesh_->elementLocalId(element));
-		}
-	} else*/
-	{
-		int worksetSize = worksetDesc.getWorksetSize();
-		if( worksetSize>0 ) {
-			if( n_celldata>0 && n_celldata<worksetSize ) worksetSize = n_celldata;
-		} else {
-			worksetSize = n_celldata;
-		}
-		//const stk::mesh::Part* eb = mesh_->getElementBlockPart(element_block_name);
-		//if( !eb ) return;
-		//stk::mesh::Selector eselect = metaData->universal_part() & (*eb);
-        //stk::mesh::EntityRank elementRank = mesh_->getElementRank();
-        //stk::mesh::get_selected_entities(eselect,bulkData->buckets(elementRank),elements);
-		mesh_->getMyElements(element_block_name,elements);
-		if( elements.empty() ) return worksets_ptr;     // no entity in current cpu
-		for( const auto& ele : elements )
-		{
-			const auto lid = mesh_->elementLocalId( ele );
-			local_cell_ids.emplace_back( lid );
-		}		 
-		int numElements = local_cell_ids.size();
-		if( worksetDesc.getWorksetSize() == panzer::WorksetSizeType::ALL_ELEMENTS ) 
-			worksetSize = -1;
-
-		const int wksize = (worksetSize<=0) ?  numElements : std::min( worksetSize, numElements );
-		//if(worksetDesc.getWorksetSize() == panzer::WorksetSizeType::ALL_ELEMENTS)
-		//	wksize = local_cell_ids.size();
-		//else
-		//	wksize = std::min( worksetSize, local_cell_ids.size() );
-	    int remain = numElements%wksize;
-	    int numWorksets = (numElements-remain)/wksize;
-        if( remain>0 ) ++numWorksets;
-        worksets_ptr->resize(numWorksets);
-
-	    // create workset with size = wksize
-		LO wkset_count =0;
-		LO local_count =0;
-		for( LO i=0; i<numElements; i++ )
-		{
-			worksets_ptr->at(wkset_count).cell_local_ids.emplace_back( local_cell_ids[i] );
-			++local_count;
-			if( local_count>=wksize ) {
-				worksets_ptr->at(wkset_count).num_cells = local_count;
-				worksets_ptr->at(wkset_count).setNumeberOwnedCells(local_count);
-				++wkset_count;
-				local_count = 0;
-			}
-		}
 
-		std::vector<panzer::LocalOrdinal> side2ele, ele2side;
-		for( LO i=0; i<numWorksets; i++ )
-		{
-			std::size_t n_ele = worksets_ptr->at(i).num_cells;
-			worksets_ptr->at(i).cell_vertex_coordinates = mdArrayFactory.buildStaticArray<double,panzer::Cell,panzer::NODE,panzer::Dim>(
-			     "cvc", n_ele, n_nodes, n_dim);		
-			worksets_ptr->at(i).block_id = element_block_name;
-			worksets_ptr->at(i).set_dimension( n_dim );
-			worksets_ptr->at(i).subcell_dim = n_dim-1;
-			worksets_ptr->at(i).subcell_index = 0;
-			worksets_ptr->at(i).setTopology(topo);
-
-            PHX::View<int*> cell_local_ids_k = PHX::View<int*>("Workset:cell_local_ids",n_ele);
-			auto cell_local_ids_k_h = Kokkos::create_mirror_view(cell_local_ids_k);
-			for(std::size_t j=0;j<n_ele;j++)
-				cell_local_ids_k_h(j) = worksets_ptr->at(i).cell_local_ids[j];
-			Kokkos::deep_copy(cell_local_ids_k, cell_local_ids_k_h);
-			worksets_ptr->at(i).cell_local_ids_k = cell_local_ids_k;
-
-			Kokkos::DynRankView<double,PHX::Device> vertex_coordinates;
-			mesh_->getElementVertices( worksets_ptr->at(i).cell_local_ids, vertex_coordinates );
-			
-			// Copy cell vertex coordinates into local workset arrays
-			auto cell_vertex_coordinates = worksets_ptr->at(i).cell_vertex_coordinates.get_static_view();
-			Kokkos::parallel_for(worksets_ptr->at(i).num_cells, KOKKOS_LAMBDA (int cell) {
-			for (std::size_t vertex = 0; vertex < vertex_coordinates.extent(1); ++ vertex)
-				for (std::size_t dim = 0; dim < vertex_coordinates.extent(2); ++ dim) {
-					cell_vertex_coordinates(cell,vertex,dim) = vertex_coordinates(cell,vertex,dim);
-				}
-			});
-			
-			worksets_ptr->at(i).setSetup(true);
-			mesh_->getElementSideRelation( worksets_ptr->at(i).cell_local_ids,side2ele, ele2side);
-			worksets_ptr->at(i).setupFaceConnectivity(side2ele, n_sides, ele2side);
-
-			// Initialize IntegrationValues from integration descriptors
-			const auto& integs = needs.getIntegrators();
-			for(const auto & id : integs)
-				worksets_ptr->at(i).getIntegrationValues(id);
-
-			// Initialize PointValues from point descriptors
-			const auto& points = needs.getPoints();
-			for(const auto & pd : points)
-				worksets_ptr->at(i).getPointValues(pd);
-
-			// Initialize BasisValues
-			const auto& basis = needs.getBases();
-			if( basis.size()>0 ) {
-				TEUCHOS_ASSERT( needs.bases.size()==0 );  // no legacy definition
-				for(const auto & bd : basis){
-
-					// Initialize BasisValues from integrators
-					for(const auto & id : needs.getIntegrators())
-						worksets_ptr->at(i).getBasisValues(bd,id);
-
-					// Initialize BasisValues from points
-					for(const auto & pd : needs.getPoints())
-					worksets_ptr->at(i).getBasisValues(bd,pd);
-				} 
-			}
-		//	else if (needs.bases.size()>0) {
-		//		for( const auto& nds : needs.bases) {
-		//			panzer::BasisDescriptor bd(nds->order(),nds->type());
-		//		}
-		//	}
-		//	std::cout <<  worksets_ptr->at(i) ;
-		}
+	int worksetSize = worksetDesc.getWorksetSize();
+	if( worksetSize>0 ) {
+		if( n_celldata>0 && n_celldata<worksetSize ) worksetSize = n_celldata;
+	} else {
+		worksetSize = n_celldata;
 	}
-	return worksets_ptr;
+	if( worksetDesc.getWorksetSize() == panzer::WorksetSizeType::ALL_ELEMENTS ) 
+		worksetSize = -1;
+
+	if( needs.getBases().size()>0 )
+		TEUCHOS_ASSERT( needs.bases.size()==0 );  // no legacy definition
+
+	return buildElementBlockWorksets(worksetDesc.getElementBlock(),needs,worksetSize);
 }
 
 Teuchos::RCP<std::vector<panzer::Workset> > WorksetFactory::
 WorksetFactory :: generateWorksets(const panzer::PhysicsBlock& pb ) const
+{
+	const auto& needs = pb.getWorksetNeedsNew();
+	return buildElementBlockWorksets(pb.elementBlockID(),needs,needs.cellData.numCells());
+}
+
+Teuchos::RCP<std::vector<panzer::Workset> > WorksetFactory::
+buildElementBlockWorksets(const std::string & element_block_name,
+                          const panzer::WorksetNeeds & needs,
+                          const int worksetSize) const
 {
 	using LO = panzer::LocalOrdinal;
-	panzer::MDFieldArrayFactory mdArrayFactory("",true);
-	
-	Teuchos::RCP<std::vector<panzer::Workset> > pwksets = Teuchos::rcp(new std::vector<panzer::Workset>);
-	std::vector<panzer::LocalOrdinal> local_cell_ids;
+	using host_space = Kokkos::DefaultHostExecutionSpace;
+	using CellVertexField = PHX::MDField<double,panzer::Cell,panzer::NODE,panzer::Dim>;
+
+	Teuchos::RCP<std::vector<panzer::Workset> > worksets_ptr = Teuchos::rcp(new std::vector<panzer::Workset>);
+
 	std::vector<stk::mesh::Entity> elements;
-	
-	const auto& eb = pb.elementBlockID();
-	const auto& needs = pb.getWorksetNeedsNew();
-	const int worksetSize = needs.cellData.numCells();  // need reading?
-	
-	Teuchos::RCP<const shards::CellTopology> topo = mesh_->getCellTopology(eb);
+	mesh_->getMyElements(element_block_name,elements);
+	if( elements.empty() ) return worksets_ptr;     // no entity in current cpu
+
+	Teuchos::RCP<const shards::CellTopology> topo = mesh_->getCellTopology(element_block_name);
 	const int n_dim = topo->getDimension();
 	const int n_nodes = topo->getNodeCount();
-	const int n_celldata = needs.cellData.numCells();
 	const int n_sides = topo->getSubcellCount(n_dim-1);
-	
-	mesh_->getMyElements(eb,elements);
-	if( elements.empty() ) return pwksets;     // no entity in current cpu
+
+	// chunk in local ID order, so each workset covers a compact range of the element ordering
+	std::vector<std::size_t> local_cell_ids;
+	local_cell_ids.reserve(elements.size());
 	for( const auto& ele : elements )
+		local_cell_ids.emplace_back( mesh_->elementLocalId( ele ) );
+	std::sort( local_cell_ids.begin(), local_cell_ids.end() );
+
+	const int numElements = local_cell_ids.size();
+	const int wksize = (worksetSize<=0) ? numElements : std::min( worksetSize, numElements );
+	const int numWorksets = (numElements+wksize-1)/wksize;
+	worksets_ptr->resize(numWorksets);
+
+	// Block level data: the cell ids and vertex coordinates of all worksets are
+	// gathered once and each workset views its own range of cells
+	PHX::View<int*> block_cell_ids("Workset:cell_local_ids",numElements);
 	{
-		const auto lid = mesh_->elementLocalId( ele );
-		local_cell_ids.emplace_back( lid );
-	}		 
-	int numElements = local_cell_ids.size();
-	const int wksize = std::min( worksetSize, numElements );
-	
-	int remain = numElements%wksize;
-	int numWorksets = (numElements-remain)/wksize;
-    if( remain>0 ) ++numWorksets;
-    pwksets->resize(numWorksets);
-
-	// create workset with size = wksize
-	LO wkset_count =0;
-	LO local_count =0;
-	for( LO i=0; i<numElements; i++ )
-	{
-		pwksets->at(wkset_count).cell_local_ids.emplace_back( local_cell_ids[i] );
-		++local_count;
-		if( local_count>=wksize ) {
-			pwksets->at(wkset_count).num_cells = local_count;
-			pwksets->at(wkset_count).setNumeberOwnedCells(local_count);
-			++wkset_count;
-			local_count = 0;
-		}
+		auto block_cell_ids_h = Kokkos::create_mirror_view(block_cell_ids);
+		for( int i=0; i<numElements; i++ )
+			block_cell_ids_h(i) = local_cell_ids[i];
+		Kokkos::deep_copy(block_cell_ids, block_cell_ids_h);
 	}
 
-    std::vector<panzer::LocalOrdinal> side2ele, ele2side;
-	for( LO i=0; i<numWorksets; i++ )
+	Kokkos::DynRankView<double,PHX::Device> vertex_coordinates;
+	mesh_->getElementVertices( local_cell_ids, element_block_name, vertex_coordinates );
+
+	CellVertexField block_vertices = panzer::MDFieldArrayFactory("",true).buildStaticArray<double,panzer::Cell,panzer::NODE,panzer::Dim>(
+	     "cvc", numElements, n_nodes, n_dim);
 	{
-		std::size_t n_ele = pwksets->at(i).num_cells;
-		pwksets->at(i).cell_vertex_coordinates = mdArrayFactory.buildStaticArray<double,panzer::Cell,panzer::NODE,panzer::Dim>(
-			     "cvc", n_ele, n_nodes, n_dim);		
-		pwksets->at(i).block_id = eb;
-		pwksets->at(i).set_dimension( n_dim );
-		pwksets->at(i).subcell_dim = n_dim-1;
-		pwksets->at(i).subcell_index = 0;
-		pwksets->at(i).setTopology(topo);
-
-        PHX::View<int*> cell_local_ids_k = PHX::View<int*>("Workset:cell_local_ids",n_ele);
-		auto cell_local_ids_k_h = Kokkos::create_mirror_view(cell_local_ids_k);
-		for(std::size_t j=0;j<n_ele;j++)
-			cell_local_ids_k_h(j) = pwksets->at(i).cell_local_ids[j];
-		Kokkos::deep_copy(cell_local_ids_k, cell_local_ids_k_h);
-		pwksets->at(i).cell_local_ids_k = cell_local_ids_k;
-
-		Kokkos::DynRankView<double,PHX::Device> vertex_coordinates;
-		mesh_->getElementVertices( pwksets->at(i).cell_local_ids, vertex_coordinates );
-			
-		// Copy cell vertex coordinates into local workset arrays
-		auto cell_vertex_coordinates = pwksets->at(i).cell_vertex_coordinates.get_static_view();
-		Kokkos::parallel_for(pwksets->at(i).num_cells, KOKKOS_LAMBDA (int cell) {
-		for (std::size_t vertex = 0; vertex < vertex_coordinates.extent(1); ++ vertex)
-			for (std::size_t dim = 0; dim < vertex_coordinates.extent(2); ++ dim) {
+		auto cell_vertex_coordinates = block_vertices.get_static_view();
+		Kokkos::parallel_for("panzer_stk::WorksetFactory: copy vertices", numElements, KOKKOS_LAMBDA (int cell) {
+		for (int vertex = 0; vertex < n_nodes; ++ vertex)
+			for (int dim = 0; dim < n_dim; ++ dim)
 				cell_vertex_coordinates(cell,vertex,dim) = vertex_coordinates(cell,vertex,dim);
-			}
 		});
-			
-		pwksets->at(i).setSetup(true);
-		mesh_->getElementSideRelation( pwksets->at(i).cell_local_ids,side2ele, ele2side);
-		pwksets->at(i).setupFaceConnectivity(side2ele, n_sides, ele2side);
+		PHX::Device::execution_space().fence();
+	}
+
+	// The side relations only read the mesh, build them for all worksets in parallel.
+	// An exception must not leave the parallel region (e.g. a side missing from the
+	// local side ids), each workset keeps its own and the first one is rethrown after.
+	std::vector<std::vector<LO> > side2ele(numWorksets), ele2side(numWorksets);
+	std::vector<std::exception_ptr> errors(numWorksets);
+	Kokkos::parallel_for("panzer_stk::WorksetFactory: side relations",
+	                     Kokkos::RangePolicy<host_space,Kokkos::Schedule<Kokkos::Dynamic> >(0,numWorksets),
+	                     [&](const int i) {
+		try {
+			std::vector<std::size_t> cell_ids(local_cell_ids.begin()+i*wksize,
+			                                  local_cell_ids.begin()+std::min((i+1)*wksize,numElements));
+			mesh_->getElementSideRelation( cell_ids, side2ele[i], ele2side[i] );
+		}
+		catch(...) {
+			errors[i] = std::current_exception();
+		}
+	});
+	host_space().fence();
+	for( const auto& error : errors )
+		if( error )
+			std::rethrow_exception(error);
+
+	const panzer::MDFieldArrayFactory viewArrayFactory("",false);
+	for( LO i=0; i<numWorksets; i++ )
+	{
+		panzer::Workset & workset = worksets_ptr->at(i);
+		const int begin = i*wksize;
+		const int end = std::min(begin+wksize,numElements);
+		const int n_ele = end-begin;
+
+		workset.num_cells = n_ele;
+		workset.setNumeberOwnedCells(n_ele);
+		workset.cell_local_ids.assign(local_cell_ids.begin()+begin,local_cell_ids.begin()+end);
+		workset.cell_local_ids_k = Kokkos::subview(block_cell_ids,std::make_pair(begin,end));
+
+		workset.block_id = element_block_name;
+		workset.set_dimension( n_dim );
+		workset.subcell_dim = n_dim-1;
+		workset.subcell_index = 0;
+		workset.setTopology(topo);
+
+		workset.cell_vertex_coordinates = viewArrayFactory.buildStaticArray<double,panzer::Cell,panzer::NODE,panzer::Dim>(
+		     "cvc", n_ele, n_nodes, n_dim);
+		setCellVertexSubview(workset.cell_vertex_coordinates,block_vertices,begin,end);
+
+		workset.setSetup(true);
+		workset.setupFaceConnectivity(side2ele[i], n_sides, ele2side[i]);
+
 		// Initialize IntegrationValues from integration descriptors
 		const auto& integs = needs.getIntegrators();
 		for(const auto & id : integs)
-			pwksets->at(i).getIntegrationValues(id);
+			workset.getIntegrationValues(id);
 
 		// Initialize PointValues from point descriptors
 		const auto& points = needs.getPoints();
 		for(const auto & pd : points)
-			pwksets->at(i).getPointValues(pd);
+			workset.getPointValues(pd);
 
 		// Initialize BasisValues
 		const auto& basis = needs.getBases();
@@ -375,16 +316,15 @@ WorksetFactory :: generateWorksets(const panzer::PhysicsBlock& pb ) const
 
 			// Initialize BasisValues from integrators
 			for(const auto & id : needs.getIntegrators())
-				pwksets->at(i).getBasisValues(bd,id);
+				workset.getBasisValues(bd,id);
 
 			// Initialize BasisValues from points
 			for(const auto & pd : needs.getPoints())
-			pwksets->at(i).getBasisValues(bd,pd);
+				workset.getBasisValues(bd,pd);
 		}
-		//	std::cout <<  pwksets->at(i) ;
 	}
-	
-	return pwksets;
+
+	return worksets_ptr;
 }
 
 }
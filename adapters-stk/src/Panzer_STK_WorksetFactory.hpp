@@ -90,6 +90,15 @@ public:
    getSideWorkset(const panzer::WorksetDescriptor & desc,
                    const panzer::WorksetNeeds & needs) const final;
 
+   /** Build boundary condition worksets of at most worksetSize cells
+     */
+   virtual
+   Teuchos::RCP<std::vector<panzer::Workset> >
+   getSideWorksetChunks(const panzer::WorksetDescriptor & desc,
+                        const panzer::WorksetNeeds & needs,
+                        const int worksetSize,
+                        const bool populateValues) const final;
+
    /** Build workssets specified by the workset descriptor.
      */
    virtual
@@ -108,6 +117,15 @@ public:
 
 private:
 
+   /** Build the volume worksets of an element block, of at most worksetSize
+     * cells (all cells if worksetSize<=0). Cell ids and vertex coordinates are
+     * gathered once for the block, the worksets view ranges of them.
+     */
+   Teuchos::RCP< std::vector<panzer::Workset> >
+   buildElementBlockWorksets(const std::string & element_block_name,
+                             const panzer::WorksetNeeds & needs,
+                             const int worksetSize) const;
+
    /// Mesh
    Teuchos::RCP<const STK_Interface> mesh_;
 
@@ -44,6 +44,8 @@
 #include "Kokkos_DynRankView.hpp"
 
 #include <stk_mesh/base/FieldBase.hpp>
+#include <stk_mesh/base/GetBuckets.hpp>
+#include <stk_mesh/base/Selector.hpp>
 
 namespace TianXin {
 
@@ -223,51 +225,81 @@ void build_local_ids(const panzer_stk::STK_Interface & mesh,
    }
 }
 
-void pushSolutionOnFields(const panzer::GlobalIndexer& dofMngr,panzer_stk::STK_Interface & mesh,
-	const Tpetra::Vector<double,panzer::LocalOrdinal,panzer::GlobalOrdinal>& x, double scal )
+SolutionFieldTransfer::SolutionFieldTransfer(const Teuchos::RCP<const panzer::GlobalIndexer>& dofMngrRCP,const panzer_stk::STK_Interface & mesh)
+   : bulkData_(mesh.getBulkData())
 {
-	auto xview = x.getData();
-	// Prepare: All fields in mesh must in dofMngr
-	std::vector<stk::mesh::Entity> nodes, edges, faces;
-	mesh.getAllNodes( nodes );
-	mesh.getAllEdges( edges );
-	mesh.getAllFaces( faces );
-	//const stk::mesh::FieldVector &fields = mesh.getMetaData()->get_fields();
-	//for (size_t field_index = 0; field_index < fields.size(); field_index++) {
-	for (const auto& item : mesh.nameToField_) { 
-		//const stk::mesh::FieldBase &field = *fields[field_index];
-		//const std::string fname = field.name();
-		const stk::mesh::EntityRank rank = item.second ->entity_rank();
-		const int fnum = dofMngr.getFieldNum(item.first);
-		TEUCHOS_ASSERT( fnum>=0 );   // must exist
-		if( rank == mesh.getNodeRank() ) {
-			for( const auto& nd : nodes ) {
-				double *fieldDataForNode = stk::mesh::field_data( *item.second, nd );
-				auto offset = dofMngr.getNodalLDofOfField( fnum, mesh.EntityGlobalId(nd) );
-				*fieldDataForNode = xview[offset];
-			}
-		} else if ( rank == mesh.getEdgeRank() ) {
-			for( const auto& eg : edges ) {
-				double *fieldDataForEdge = stk::mesh::field_data( *item.second, eg );
-				TEUCHOS_ASSERT(fieldDataForEdge!=0); // only needed if blockId is not specified
-				auto offset = dofMngr.getEdgeLDofOfField( fnum, mesh.EntityGlobalId(eg) );
-				double val = 0.0;
-				for( const auto& off : offset )
-					val += xview[off];
-				fieldDataForEdge[0] = val/offset.size();
-			}
-		} else if ( rank == mesh.getFaceRank() ) {
-			for( const auto& fc : faces ) {
-				double *fieldDataForFace = stk::mesh::field_data( *item.second, fc );
-				TEUCHOS_ASSERT(fieldDataForFace!=0); // only needed if blockId is not specified
-				auto offset = dofMngr.getFaceLDofOfField( fnum, mesh.EntityGlobalId(fc) );
-				double val = 0.0;
-				for( const auto& off : offset )
-					val += xview[off];
-				fieldDataForFace[0] = val/offset.size();
-			}
-		} 
+   TEUCHOS_ASSERT(bulkData_!=Teuchos::null);
+   TEUCHOS_ASSERT(dofMngrRCP!=Teuchos::null);
+   dofMngr_ = dofMngrRCP.create_weak();
+   const panzer::GlobalIndexer & dofMngr = *dofMngrRCP;
+   syncCount_ = bulkData_->synchronized_count();
+
+   std::vector<panzer::LocalOrdinal> entityLids;
+   for (const auto& item : mesh.nameToField_) {
+      const stk::mesh::EntityRank rank = item.second->entity_rank();
+      const int fnum = dofMngr.getFieldNum(item.first);
+      TEUCHOS_ASSERT( fnum>=0 );   // must exist
+
+      int indexRank = -1;
+      if( rank == mesh.getNodeRank() )      indexRank = 0;
+      else if( rank == mesh.getEdgeRank() ) indexRank = 1;
+      else if( rank == mesh.getFaceRank() ) indexRank = 2;
+      if( indexRank<0 ) continue;
+
+      FieldSlots slots;
+      slots.field = item.second;
+      slots.offsets.push_back(0);
+
+      const panzer::EntityDofIndex * index = dofMngr.getEntityDofIndex(fnum,indexRank);
+      const stk::mesh::BucketVector & buckets = bulkData_->get_buckets(rank,stk::mesh::selectField(*item.second));
+      for( stk::mesh::Bucket * bucket : buckets ) {
+         slots.buckets.push_back(bucket);
+         for( const stk::mesh::Entity entity : *bucket ) {
+            if( index!=nullptr && index->getLIDs(bulkData_->identifier(entity),entityLids) )
+               slots.lids.insert(slots.lids.end(),entityLids.begin(),entityLids.end());
+            slots.offsets.push_back(slots.lids.size());
+         }
+      }
+      fields_.push_back(std::move(slots));
+   }
+}
+
+void SolutionFieldTransfer::apply(const VectorType & x) const
+{
+   TEUCHOS_TEST_FOR_EXCEPTION(!isCurrent(),std::logic_error,
+                              "SolutionFieldTransfer: The mesh was modified or the DOF manager destroyed after the transfer was built");
+
+   auto xview = x.getLocalViewHost(Tpetra::Access::ReadOnly);
+   for( const auto& slots : fields_ ) {
+      const std::size_t * offsets = slots.offsets.data();
+      const panzer::LocalOrdinal * lids = slots.lids.data();
+      for( const stk::mesh::Bucket * bucket : slots.buckets ) {
+         double * values = stk::mesh::field_data(*slots.field,*bucket);
+         for( std::size_t i=0;i<bucket->size();i++,offsets++ ) {
+            const std::size_t begin = offsets[0], end = offsets[1];
+            if( end-begin==1 )
+               values[i] = xview(lids[begin],0);
+            else if( end>begin ) {
+               double val = 0.0;
+               for( std::size_t k=begin;k<end;k++ )
+                  val += xview(lids[k],0);
+               values[i] = val/(end-begin);
+            }
+         }
+      }
+   }
+}
+
+void pushSolutionOnFields(const Teuchos::RCP<const panzer::GlobalIndexer>& dofMngr,panzer_stk::STK_Interface & mesh,
+	const Tpetra::Vector<double,panzer::LocalOrdinal,panzer::GlobalOrdinal>& x, double /* scal */ )
+{
+	std::shared_ptr<const SolutionFieldTransfer> transfer = mesh.getSolutionFieldTransfer(dofMngr);
+	if( transfer==nullptr || !transfer->isCurrent() ) {
+		transfer = std::make_shared<const SolutionFieldTransfer>(dofMngr,mesh);
+		mesh.setSolutionFieldTransfer(dofMngr,transfer);
 	}
+
+	transfer->apply(x);
 }
 
 void writeSolutionToFile(const panzer::GlobalIndexer& dofMngr,const panzer_stk::STK_Interface& mesh,const std::vector<Teuchos::RCP<panzer::PhysicsBlock> >& physicsBlocks 
@@ -58,11 +58,62 @@ void write_solution_data(const panzer::GlobalIndexer& dofMngr,panzer_stk::STK_In
 void write_solution_data(const panzer::GlobalIndexer& dofMngr,panzer_stk::STK_Interface & mesh,const Epetra_Vector & x,const std::string & prefix="",const std::string & postfix="");
 #endif 
 void write_solution_data(const panzer::GlobalIndexer& dofMngr,panzer_stk::STK_Interface & mesh,const Tpetra::Vector<double,panzer::LocalOrdinal,panzer::GlobalOrdinal>& x,const std::string & prefix="",const std::string & postfix="");
-void pushSolutionOnFields(const panzer::GlobalIndexer& dofMngr,panzer_stk::STK_Interface & mesh,
+
+/** Copy the dofs of a ghosted solution vector into the STK solution fields of
+  * the mesh. The <code>SolutionFieldTransfer</code> is kept on the mesh for
+  * <code>dofMngr</code> (see <code>STK_Interface::getSolutionFieldTransfer</code>)
+  * and only rebuilt once the mesh is modified.
+  */
+void pushSolutionOnFields(const Teuchos::RCP<const panzer::GlobalIndexer>& dofMngr,panzer_stk::STK_Interface & mesh,
 	const Tpetra::Vector<double,panzer::LocalOrdinal,panzer::GlobalOrdinal>& x, double scal=0.0 );
 void writeSolutionToFile(const panzer::GlobalIndexer& dofMngr,const panzer_stk::STK_Interface & mesh,const std::vector<Teuchos::RCP<panzer::PhysicsBlock> >& physicsBlocks,
 	const Tpetra::Vector<double,panzer::LocalOrdinal,panzer::GlobalOrdinal>& x );
 	
+/** Transfer of a ghosted solution vector to the STK solution fields.
+  *
+  * The constructor looks up, bucket by bucket, the local ids of the vector
+  * entries that belong to each entity of every field in
+  * <code>mesh.nameToField_</code>. <code>apply</code> then fills the
+  * contiguous field storage of each bucket straight from the vector, with no
+  * per-cell evaluation and no entity lookups. An edge or face field holding
+  * several dofs per entity gets their mean, entities without dofs are left
+  * untouched.
+  *
+  * The slots refer to the STK buckets and to the local ids of the DOF
+  * manager, so the transfer must be rebuilt after the mesh is modified or for
+  * another DOF manager.
+  */
+class SolutionFieldTransfer {
+public:
+   typedef Tpetra::Vector<double,panzer::LocalOrdinal,panzer::GlobalOrdinal> VectorType;
+
+   SolutionFieldTransfer(const Teuchos::RCP<const panzer::GlobalIndexer>& dofMngr,const panzer_stk::STK_Interface & mesh);
+
+   //! Copy the dofs of the ghosted vector <code>x</code> into the fields
+   void apply(const VectorType & x) const;
+
+   //! Number of fields filled by <code>apply</code>
+   std::size_t numFields() const
+   { return fields_.size(); }
+
+   //! Was the mesh left unmodified and is the DOF manager alive since the transfer was built
+   bool isCurrent() const
+   { return bulkData_->synchronized_count()==syncCount_ && dofMngr_.is_valid_ptr(); }
+
+private:
+   struct FieldSlots {
+      panzer_stk::STK_Interface::SolutionFieldType * field;
+      std::vector<stk::mesh::Bucket*> buckets;
+      std::vector<std::size_t> offsets; // entity i in bucket order has lids[offsets[i]...offsets[i+1]-1]
+      std::vector<panzer::LocalOrdinal> lids;
+   };
+
+   Teuchos::RCP<stk::mesh::BulkData> bulkData_;
+   Teuchos::RCP<const panzer::GlobalIndexer> dofMngr_; // weak, the lids belong to it
+   std::size_t syncCount_; // bulk data state the slots were built for
+   std::vector<FieldSlots> fields_;
+};
+
 /** Using a container, compute the sorted permutation vector
   * do not modifiy the original container.
   *
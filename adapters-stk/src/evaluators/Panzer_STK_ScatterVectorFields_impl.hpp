@@ -52,7 +52,6 @@
 #include "Phalanx_DataLayout_MDALayout.hpp"
 
 #include "Panzer_Traits.hpp"
-#include "Panzer_CommonArrayFactories.hpp"
 
 #include "Teuchos_FancyOStream.hpp"
 
@@ -115,8 +114,6 @@ template < >
 void ScatterVectorFields<panzer::Traits::Residual,panzer::Traits>::
 evaluateFields(panzer::Traits::EvalData workset)
 {
-  panzer::MDFieldArrayFactory af("",true);
-
   std::vector<std::string> dimStrings(3);
   dimStrings[0] = "X";
   dimStrings[1] = "Y";
@@ -126,26 +123,22 @@ evaluateFields(panzer::Traits::EvalData workset)
   const std::vector<std::size_t> & localCellIds = this->wda(workset).cell_local_ids;
   std::string blockId = this->wda(workset).block_id;
 
-  for(int d=0;d<spatialDimension_;d++) {
-    for(std::size_t fieldIndex=0; fieldIndex<scatterFields_.size();fieldIndex++) {
-      PHX::MDField<const ScalarT,panzer::Cell,panzer::IP,panzer::Dim> & field = scatterFields_[fieldIndex];
-      std::string fieldName = names_[fieldIndex]+dimStrings[d];
-
-      PHX::MDField<double,panzer::Cell,panzer::NODE> cellValue
-          = af.buildStaticArray<double,panzer::Cell,panzer::NODE>("",field.extent(0),1);
+  for(std::size_t fieldIndex=0; fieldIndex<scatterFields_.size();fieldIndex++) {
+    // one copy to the host for all the dimensions
+    auto field_h = Kokkos::create_mirror_view(scatterFields_[fieldIndex].get_static_view());
+    Kokkos::deep_copy(field_h, scatterFields_[fieldIndex].get_static_view());
 
-      // scaline field value only if the scaling parameter is specified, otherwise use 1.0
-      double scaling = (scaling_.size()>0) ? scaling_[fieldIndex] : 1.0;
+    // scaline field value only if the scaling parameter is specified, otherwise use 1.0
+    double scaling = (scaling_.size()>0) ? scaling_[fieldIndex] : 1.0;
 
-      auto cellValue_v = cellValue.get_static_view();
-      auto field_v = field.get_static_view();
-      Kokkos::parallel_for(field_v.extent(0), KOKKOS_LAMBDA (int i) {
-	  cellValue_v(i,0) = field_v(i,0,d);
-	});
-      Kokkos::fence();
+    for(int d=0;d<spatialDimension_;d++) {
+      std::string fieldName = names_[fieldIndex]+dimStrings[d];
 
-      // add in vector value at d^th dimension
-      mesh_->setCellFieldData(fieldName,blockId,localCellIds,cellValue.get_view(),scaling);
+      // write the vector value at d^th dimension straight into the cell field
+      const STK_Interface::ElementFieldSlots & slots
+          = mesh_->getElementFieldSlots(*mesh_->getCellField(fieldName,blockId));
+      for(std::size_t cell=0;cell<localCellIds.size();cell++)
+        *slots.values[slots.offsets[localCellIds[cell]]] = scaling*field_h(cell,0,d);
     }
   }
 }
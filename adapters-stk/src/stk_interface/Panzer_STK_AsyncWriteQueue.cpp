@@ -0,0 +1,132 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#include "Panzer_STK_AsyncWriteQueue.hpp"
+
+#include "Teuchos_Assert.hpp"
+
+namespace panzer_stk {
+
+AsyncWriteQueue::AsyncWriteQueue(std::size_t maxQueued)
+   : maxQueued_(maxQueued), busy_(false), pending_(0), stop_(false)
+{
+   TEUCHOS_ASSERT(maxQueued_>0);
+   thread_ = std::thread(&AsyncWriteQueue::run,this);
+}
+
+AsyncWriteQueue::~AsyncWriteQueue()
+{
+   {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+   }
+   changed_.notify_all();
+   thread_.join();
+}
+
+void AsyncWriteQueue::push(std::function<void()> task)
+{
+   {
+      std::unique_lock<std::mutex> lock(mutex_);
+      changed_.wait(lock,[this] { return tasks_.size()<maxQueued_ || error_; });
+      rethrowError();
+      tasks_.push_back(std::move(task));
+      ++pending_;
+   }
+   changed_.notify_all();
+}
+
+void AsyncWriteQueue::wait()
+{
+   std::unique_lock<std::mutex> lock(mutex_);
+   changed_.wait(lock,[this] { return (tasks_.empty() && !busy_) || error_; });
+   rethrowError();
+}
+
+std::exception_ptr AsyncWriteQueue::error()
+{
+   std::lock_guard<std::mutex> lock(mutex_);
+   return error_;
+}
+
+void AsyncWriteQueue::rethrowError()
+{
+   // a failed queue stays failed, the steps after the failed one are never written
+   if(error_)
+      std::rethrow_exception(error_);
+}
+
+void AsyncWriteQueue::run()
+{
+   std::unique_lock<std::mutex> lock(mutex_);
+   while(true) {
+      changed_.wait(lock,[this] { return !tasks_.empty() || stop_; });
+      if(tasks_.empty())
+         return; // stopped and drained
+
+      std::function<void()> task = std::move(tasks_.front());
+      tasks_.pop_front();
+      busy_ = true;
+      lock.unlock();
+      changed_.notify_all(); // room in the queue
+
+      std::exception_ptr error;
+      try {
+         task();
+      }
+      catch(...) {
+         error = std::current_exception();
+      }
+
+      lock.lock();
+      busy_ = false;
+      --pending_;
+      if(error && !error_) {
+         error_ = error;
+         tasks_.clear();
+         pending_ = 0;
+      }
+      changed_.notify_all();
+   }
+}
+
+}
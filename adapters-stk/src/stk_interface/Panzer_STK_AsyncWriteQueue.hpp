@@ -0,0 +1,119 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#ifndef __Panzer_STK_AsyncWriteQueue_hpp__
+#define __Panzer_STK_AsyncWriteQueue_hpp__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace panzer_stk {
+
+/** Runs write tasks in order on one background thread.
+  *
+  * At most <code>maxQueued</code> tasks wait to run; <code>push</code> blocks
+  * while the queue is full, so the memory held by queued tasks stays bounded
+  * when writing falls behind. An exception thrown by a task leaves the queue
+  * failed: the tasks still queued are dropped, no further tasks are run, and
+  * every later call to <code>push</code> or <code>wait</code> rethrows it.
+  */
+class AsyncWriteQueue {
+public:
+
+   /** Start the background thread.
+     *
+     * \param[in] maxQueued Largest number of tasks waiting to run, must be positive
+     */
+   explicit AsyncWriteQueue(std::size_t maxQueued);
+
+   //! Run the remaining tasks and stop the background thread.
+   ~AsyncWriteQueue();
+
+   AsyncWriteQueue(const AsyncWriteQueue &) = delete;
+   AsyncWriteQueue & operator=(const AsyncWriteQueue &) = delete;
+
+   //! Queue a task, blocking while the queue is full.
+   void push(std::function<void()> task);
+
+   //! Block until every queued task has run.
+   void wait();
+
+   //! The exception a task threw, null unless the queue failed
+   std::exception_ptr error();
+
+   //! Are no tasks queued or running, does not lock
+   bool idle() const
+   { return pending_==0; }
+
+   //! Largest number of tasks waiting to run
+   std::size_t maxQueued() const
+   { return maxQueued_; }
+
+private:
+
+   void run();
+
+   // throw the failure of a task, the mutex must be held
+   void rethrowError();
+
+   const std::size_t maxQueued_;
+
+   std::mutex mutex_;
+   std::condition_variable changed_;
+   std::deque<std::function<void()> > tasks_;
+   bool busy_;  // a task is running
+   std::atomic<std::size_t> pending_; // queued tasks plus the running one
+   bool stop_;
+   std::exception_ptr error_;
+
+   std::thread thread_;
+};
+
+}
+
+#endif
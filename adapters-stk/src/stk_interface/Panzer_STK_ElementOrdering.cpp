@@ -0,0 +1,227 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#include "Panzer_STK_ElementOrdering.hpp"
+#include "Panzer_STK_Interface.hpp"
+
+#include "Teuchos_Assert.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+namespace panzer_stk {
+
+namespace {
+
+//! Spread the low 21 bits of v so that there are two zero bits between each
+std::uint64_t spreadBits(std::uint64_t v)
+{
+   v &= 0x1fffff;
+   v = (v | v << 32) & 0x1f00000000ffffULL;
+   v = (v | v << 16) & 0x1f0000ff0000ffULL;
+   v = (v | v << 8)  & 0x100f00f00f00f00fULL;
+   v = (v | v << 4)  & 0x10c30c30c30c30c3ULL;
+   v = (v | v << 2)  & 0x1249249249249249ULL;
+   return v;
+}
+
+void mortonOrder(const STK_Interface & mesh,std::vector<stk::mesh::Entity> & elements)
+{
+   const stk::mesh::BulkData & bulk = *mesh.getBulkData();
+   const unsigned dim = mesh.getDimension();
+   const std::size_t n = elements.size();
+
+   // element centroids and their bounding box
+   std::vector<double> centroids(3*n,0.0);
+   double lo[3] = { std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max() };
+   double hi[3] = { std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest() };
+   for(std::size_t e=0;e<n;++e) {
+      const stk::mesh::Entity * nodes = bulk.begin_nodes(elements[e]);
+      const unsigned numNodes = bulk.num_nodes(elements[e]);
+      for(unsigned k=0;k<numNodes;++k) {
+         const double * x = mesh.getNodeCoordinates(nodes[k]);
+         for(unsigned d=0;d<dim;++d)
+            centroids[3*e+d] += x[d]/numNodes;
+      }
+      for(unsigned d=0;d<3;++d) {
+         lo[d] = std::min(lo[d],centroids[3*e+d]);
+         hi[d] = std::max(hi[d],centroids[3*e+d]);
+      }
+   }
+
+   // quantize to 21 bits per direction and interleave
+   const double cells = static_cast<double>((1<<21)-1);
+   std::vector<std::pair<std::uint64_t,std::size_t> > keys(n);
+   for(std::size_t e=0;e<n;++e) {
+      std::uint64_t key = 0;
+      for(unsigned d=0;d<3;++d) {
+         const double extent = hi[d]-lo[d];
+         const std::uint64_t q = (extent>0.0) ? static_cast<std::uint64_t>((centroids[3*e+d]-lo[d])/extent*cells) : 0;
+         key |= spreadBits(q) << d;
+      }
+      keys[e] = std::make_pair(key,e);
+   }
+   std::sort(keys.begin(),keys.end());
+
+   std::vector<stk::mesh::Entity> ordered(n);
+   for(std::size_t e=0;e<n;++e)
+      ordered[e] = elements[keys[e].second];
+   elements.swap(ordered);
+}
+
+void rcmOrder(const STK_Interface & mesh,std::vector<stk::mesh::Entity> & elements)
+{
+   const stk::mesh::BulkData & bulk = *mesh.getBulkData();
+   const std::size_t n = elements.size();
+
+   // node -> element incidence as a sorted (node, element) list, then CSR for both directions
+   std::vector<std::pair<std::size_t,std::size_t> > incidence;
+   for(std::size_t e=0;e<n;++e) {
+      const stk::mesh::Entity * nodes = bulk.begin_nodes(elements[e]);
+      const unsigned numNodes = bulk.num_nodes(elements[e]);
+      for(unsigned k=0;k<numNodes;++k)
+         incidence.emplace_back(nodes[k].local_offset(),e);
+   }
+   std::sort(incidence.begin(),incidence.end());
+
+   std::vector<std::size_t> nodeOffsets(1,0), nodeElements, elementNodes(incidence.size());
+   std::vector<std::size_t> elementOffsets(n+1,0);
+   nodeElements.reserve(incidence.size());
+   for(std::size_t i=0;i<incidence.size();++i) {
+      if(i>0 && incidence[i].first!=incidence[i-1].first)
+         nodeOffsets.push_back(i);
+      nodeElements.push_back(incidence[i].second);
+      ++elementOffsets[incidence[i].second+1];
+   }
+   nodeOffsets.push_back(incidence.size());
+   for(std::size_t e=0;e<n;++e)
+      elementOffsets[e+1] += elementOffsets[e];
+   {
+      std::vector<std::size_t> fill(elementOffsets.begin(),elementOffsets.end()-1);
+      for(std::size_t node=0;node+1<nodeOffsets.size();++node)
+         for(std::size_t i=nodeOffsets[node];i<nodeOffsets[node+1];++i)
+            elementNodes[fill[nodeElements[i]]++] = node;
+   }
+
+   // the degree of an element is approximated by the valence sum of its nodes
+   std::vector<std::size_t> degree(n,0);
+   for(std::size_t e=0;e<n;++e)
+      for(std::size_t k=elementOffsets[e];k<elementOffsets[e+1];++k)
+         degree[e] += nodeOffsets[elementNodes[k]+1]-nodeOffsets[elementNodes[k]];
+
+   // breadth first search from a minimum degree element of every component
+   std::vector<std::size_t> byDegree(n);
+   for(std::size_t e=0;e<n;++e) byDegree[e] = e;
+   std::stable_sort(byDegree.begin(),byDegree.end(),
+                    [&](std::size_t a,std::size_t b) { return degree[a]<degree[b]; });
+
+   std::vector<char> visited(n,0);
+   std::vector<std::size_t> order, neighbors;
+   order.reserve(n);
+   for(const std::size_t seed : byDegree) {
+      if(visited[seed]) continue;
+      visited[seed] = 1;
+      std::size_t head = order.size();
+      order.push_back(seed);
+      while(head<order.size()) {
+         const std::size_t e = order[head++];
+         neighbors.clear();
+         for(std::size_t k=elementOffsets[e];k<elementOffsets[e+1];++k) {
+            const std::size_t node = elementNodes[k];
+            for(std::size_t i=nodeOffsets[node];i<nodeOffsets[node+1];++i) {
+               const std::size_t other = nodeElements[i];
+               if(!visited[other]) {
+                  visited[other] = 1;
+                  neighbors.push_back(other);
+               }
+            }
+         }
+         std::stable_sort(neighbors.begin(),neighbors.end(),
+                          [&](std::size_t a,std::size_t b) { return degree[a]<degree[b]; });
+         order.insert(order.end(),neighbors.begin(),neighbors.end());
+      }
+   }
+   TEUCHOS_ASSERT(order.size()==n);
+
+   std::vector<stk::mesh::Entity> ordered(n);
+   for(std::size_t e=0;e<n;++e)
+      ordered[e] = elements[order[n-1-e]];
+   elements.swap(ordered);
+}
+
+}
+
+ElementOrdering elementOrderingFromString(const std::string & name)
+{
+   if(name=="Native") return ElementOrdering::Native;
+   if(name=="Morton") return ElementOrdering::Morton;
+   if(name=="RCM")    return ElementOrdering::RCM;
+   TEUCHOS_TEST_FOR_EXCEPTION(true,std::logic_error,
+                              "Unknown element ordering \"" << name << "\", choose \"Native\", \"Morton\" or \"RCM\"");
+}
+
+void orderElements(const STK_Interface & mesh,ElementOrdering ordering,
+                   std::vector<stk::mesh::Entity> & elements)
+{
+   if(ordering==ElementOrdering::Native || elements.empty())
+      return;
+
+   // start from a canonical order, so the result does not depend on bucket layout
+   const stk::mesh::BulkData & bulk = *mesh.getBulkData();
+   std::sort(elements.begin(),elements.end(),
+             [&](stk::mesh::Entity a,stk::mesh::Entity b) { return bulk.identifier(a)<bulk.identifier(b); });
+
+   switch(ordering) {
+   case ElementOrdering::Morton:
+      mortonOrder(mesh,elements);
+      break;
+   case ElementOrdering::RCM:
+      rcmOrder(mesh,elements);
+      break;
+   default:
+      break;
+   }
+}
+
+}
@@ -0,0 +1,79 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#ifndef __Panzer_STK_ElementOrdering_hpp__
+#define __Panzer_STK_ElementOrdering_hpp__
+
+#include <string>
+#include <vector>
+
+#include <stk_mesh/base/Entity.hpp>
+
+namespace panzer_stk {
+
+class STK_Interface;
+
+/** Orderings of the locally owned elements. Element local IDs follow this
+  * order, so do worksets and, through the connection manager, the DOF
+  * numbering. A locality preserving order keeps the LIDs touched by one
+  * workset in a compact range.
+  */
+enum class ElementOrdering {
+   Native,  //!< STK bucket order
+   Morton,  //!< Z-order curve on the element centroids
+   RCM      //!< reverse Cuthill-McKee on the node sharing element graph
+};
+
+/** Parse "Native", "Morton" or "RCM", throws on anything else.
+  */
+ElementOrdering elementOrderingFromString(const std::string & name);
+
+/** Reorder <code>elements</code> in place according to <code>ordering</code>.
+  * The result only depends on the elements and the mesh geometry and
+  * connectivity, not on their incoming order.
+  */
+void orderElements(const STK_Interface & mesh,ElementOrdering ordering,
+                   std::vector<stk::mesh::Entity> & elements);
+
+}
+
+#endif
@@ -64,6 +64,7 @@
 
 #ifdef PANZER_HAVE_IOSS
 #include <Ionit_Initializer.h>
+#include <Ioss_SubSystem.h>
 #include <stk_io/IossBridge.hpp>
 #include <stk_io/WriteMesh.hpp>
 #endif
@@ -79,6 +80,8 @@
 #include <set>
 #include <limits>
 #include <cassert>
+#include <algorithm>
+#include <iostream>
 
 using Teuchos::RCP;
 using Teuchos::rcp;
@@ -93,19 +96,19 @@ const std::string STK_Interface::edgeBlockString = "edge_block";
 const std::string STK_Interface::faceBlockString = "face_block";
 
 STK_Interface::STK_Interface()
-   : dimension_(0), initialized_(false), initialStateTime_(0.0), currentStateTime_(0.0), useFieldCoordinates_(false)
+   : dimension_(0), initialized_(false), initialStateTime_(0.0), currentStateTime_(0.0), maxQueuedExodusSteps_(0), useFieldCoordinates_(false)
 {
   metaData_ = rcp(new stk::mesh::MetaData());
 }
 
 STK_Interface::STK_Interface(Teuchos::RCP<stk::mesh::MetaData> metaData)
-  : dimension_(0), initialized_(false), initialStateTime_(0.0), currentStateTime_(0.0), useFieldCoordinates_(false)
+  : dimension_(0), initialized_(false), initialStateTime_(0.0), currentStateTime_(0.0), maxQueuedExodusSteps_(0), useFieldCoordinates_(false)
 {
   metaData_ = metaData;
 }
 
 STK_Interface::STK_Interface(unsigned dim)
-   : dimension_(dim), initialized_(false), useFieldCoordinates_(false)
+   : dimension_(dim), initialized_(false), maxQueuedExodusSteps_(0), useFieldCoordinates_(false)
 {
    std::vector<std::string> entity_rank_names = stk::mesh::entity_rank_names();
    entity_rank_names.push_back("FAMILY_TREE");
@@ -115,6 +118,29 @@ STK_Interface::STK_Interface(unsigned dim)
    initializeFromMetaData();
 }
 
+STK_Interface::~STK_Interface()
+{
+#ifdef PANZER_HAVE_IOSS
+   // The queued steps refer to the mesh, finish them first. Only this process's
+   // writer is waited for: the processes may destroy their meshes at different
+   // times, or after MPI_Finalize, so there is no collective agreement on errors
+   // here as in flushExodusOutput().
+   if(exodusWriteQueue_!=nullptr) {
+      try {
+         exodusWriteQueue_->wait();
+      }
+      catch(const std::exception & e) {
+         std::cerr << "STK_Interface: Exodus output failed: " << e.what() << std::endl;
+      }
+   }
+
+   // close the output file before freeing the communicator it is written on
+   exodusWriteQueue_ = nullptr;
+   meshData_ = Teuchos::null;
+   freeExodusComm();
+#endif
+}
+
 void STK_Interface::addSideset(const std::string & name,const CellTopologyData * ctData)
 {
    TEUCHOS_ASSERT(not initialized_);
@@ -422,6 +448,13 @@ void STK_Interface::beginModification()
    TEUCHOS_TEST_FOR_EXCEPTION(bulkData_==Teuchos::null,std::logic_error,
                       "STK_Interface: Must call \"initialized\" or \"instantiateBulkData\" before \"beginModification\"");
 
+   // the queued output steps were taken from the current mesh
+   flushExodusOutput();
+#ifdef PANZER_HAVE_IOSS
+   exodusOutputFields_.clear();
+   exodusOutputFieldsBuilt_ = false;
+#endif
+
    bulkData_->modification_begin();
 }
 
@@ -673,7 +706,30 @@ setupExodusFile(const std::string& filename,
 #ifdef PANZER_HAVE_IOSS
   TEUCHOS_ASSERT(not mpiComm_.is_null())
 
+  // the queued steps belong to the previous output file, so does its queue,
+  // also if a step failed, which is reported here
+  try
+  {
+    flushExodusOutput();
+  }
+  catch (...)
+  {
+    exodusWriteQueue_ = nullptr;
+    throw;
+  }
+  exodusWriteQueue_ = nullptr;
+  exodusOutputFields_.clear();
+  exodusOutputFieldsBuilt_ = false;
+  meshData_ = Teuchos::null;
+  freeExodusComm();
+
+  // the background writer makes collective calls while this thread makes its
+  // own, so it gets a communicator of its own
   stk::ParallelMachine comm = *mpiComm_->getRawMpiComm();
+  if (isAsyncExodusOutputEnabled()) {
+    MPI_Comm_dup(comm, &exodusComm_);
+    comm = exodusComm_;
+  }
   meshData_ = Teuchos::rcp(new stk::io::StkMeshIoBroker(comm));
   meshData_->set_bulk_data(Teuchos::get_shared_ptr(bulkData_));
   Ioss::PropertyManager props;
@@ -704,6 +760,9 @@ setupExodusFile(const std::string& filename,
     }
   }
 
+  if (isAsyncExodusOutputEnabled())
+    exodusWriteQueue_.reset(new AsyncWriteQueue(maxQueuedExodusSteps_));
+
   // convert the set to a vector
   std::vector<std::string> deduped_info_records(informationRecords_.begin(),informationRecords_.end());
   meshData_->add_info_records(meshIndex_, deduped_info_records);
@@ -726,11 +785,57 @@ writeToExodus(double timestep)
   if (not meshData_.is_null())
   {
     currentStateTime_ = timestep;
-    globalToExodus(GlobalVariable::ADD);
-    meshData_->begin_output_step(meshIndex_, currentStateTime_);
-    meshData_->write_defined_output_fields(meshIndex_);
-    globalToExodus(GlobalVariable::WRITE);
-    meshData_->end_output_step(meshIndex_);
+    if (exodusWriteQueue_ == nullptr)
+    {
+      writeExodusStep(currentStateTime_, globalData_);
+      return;
+    }
+
+    // The first step defines the fields of the output file through the bulk
+    // data, the ones after it are written from copies of the field values.
+    if (not exodusOutputFieldsBuilt_)
+    {
+      writeExodusStep(currentStateTime_, globalData_);
+      exodusOutputFieldsBuilt_ = true;
+      if (not buildExodusOutputFields())
+      {
+        Teuchos::FancyOStream out(Teuchos::rcpFromRef(std::cout));
+        out.setOutputToRootOnly(0);
+        out << "WARNING:  Some Exodus output field is not a field of the "
+            << "mesh; writing the steps on the calling thread." << std::endl;
+        exodusWriteQueue_ = nullptr;
+      }
+      return;
+    }
+
+    // Copy the values so the caller may change the fields as soon as this
+    // returns.  The writer thread does not touch the bulk data.
+    auto values = std::make_shared<std::vector<std::vector<double>>>(
+      exodusOutputFields_.size());
+    for (std::size_t i = 0; i < exodusOutputFields_.size(); ++i)
+    {
+      const ExodusOutputField& output = exodusOutputFields_[i];
+      std::vector<double>& fieldValues = (*values)[i];
+      // like stk_io, entities the field is not defined on are written as zero
+      fieldValues.assign(output.entities.size() * output.components, 0.0);
+      for (std::size_t e = 0; e < output.entities.size(); ++e)
+      {
+        const double* data = static_cast<const double*>(
+          stk::mesh::field_data(*output.field, output.entities[e]));
+        if (data != nullptr)
+          std::copy(data, data + output.components,
+            fieldValues.begin() + e * output.components);
+      }
+    }
+    // every process queues the step, or none does
+    agreeOnExodusWriteError();
+
+    auto globals = std::make_shared<Teuchos::ParameterList>(globalData_);
+    const double time = currentStateTime_;
+    exodusWriteQueue_->push([this, values, globals, time]()
+    {
+      writeExodusStep(time, *globals, *values);
+    });
   }
   else // if (meshData_.is_null())
   {
@@ -744,6 +849,191 @@ writeToExodus(double timestep)
 #endif
 } // end of writeToExodus()
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  enableAsyncExodusOutput()
+//
+///////////////////////////////////////////////////////////////////////////////
+void
+STK_Interface::
+enableAsyncExodusOutput(int maxQueuedSteps)
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(initialized_, std::logic_error,
+    "STK_Interface::enableAsyncExodusOutput():  Must be called before "
+    "\"initialize\".");
+  TEUCHOS_TEST_FOR_EXCEPTION(maxQueuedSteps < 1, std::invalid_argument,
+    "STK_Interface::enableAsyncExodusOutput():  The number of queued steps "
+    "must be positive, not " << maxQueuedSteps << ".");
+#ifdef PANZER_HAVE_IOSS
+  // the writer thread makes MPI calls while this thread makes its own
+  int threadSupport = MPI_THREAD_SINGLE;
+  MPI_Query_thread(&threadSupport);
+  TEUCHOS_TEST_FOR_EXCEPTION(threadSupport != MPI_THREAD_MULTIPLE,
+    std::runtime_error, "STK_Interface::enableAsyncExodusOutput():  "
+    "Asynchronous output needs MPI initialized with MPI_THREAD_MULTIPLE.");
+  maxQueuedExodusSteps_ = maxQueuedSteps;
+#else
+  TEUCHOS_ASSERT(false);
+#endif
+} // end of enableAsyncExodusOutput()
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  flushExodusOutput()
+//
+///////////////////////////////////////////////////////////////////////////////
+void
+STK_Interface::
+flushExodusOutput()
+{
+#ifdef PANZER_HAVE_IOSS
+  if (exodusWriteQueue_ != nullptr)
+  {
+    // the error is kept by the queue, it is rethrown once the processes agree
+    try
+    {
+      exodusWriteQueue_->wait();
+    }
+    catch (...)
+    {
+    }
+    agreeOnExodusWriteError();
+  }
+#endif
+} // end of flushExodusOutput()
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  agreeOnExodusWriteError()
+//
+///////////////////////////////////////////////////////////////////////////////
+void
+STK_Interface::
+agreeOnExodusWriteError()
+{
+#ifdef PANZER_HAVE_IOSS
+  const std::exception_ptr error = exodusWriteQueue_->error();
+  const int localFailed = error ? 1 : 0;
+  int globalFailed = 0;
+  Teuchos::reduceAll(*mpiComm_, Teuchos::REDUCE_MAX, 1, &localFailed, &globalFailed);
+  if (error)
+    std::rethrow_exception(error);
+  TEUCHOS_TEST_FOR_EXCEPTION(globalFailed != 0, std::runtime_error,
+    "STK_Interface::agreeOnExodusWriteError():  Writing an Exodus step "
+    "failed on another process.");
+#endif
+} // end of agreeOnExodusWriteError()
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  writeExodusStep()
+//
+///////////////////////////////////////////////////////////////////////////////
+void
+STK_Interface::
+writeExodusStep(double timestep,
+                const Teuchos::ParameterList& globalData)
+{
+  globalToExodus(GlobalVariable::ADD, globalData);
+  meshData_->begin_output_step(meshIndex_, timestep);
+  meshData_->write_defined_output_fields(meshIndex_);
+  globalToExodus(GlobalVariable::WRITE, globalData);
+  meshData_->end_output_step(meshIndex_);
+} // end of writeExodusStep()
+
+void
+STK_Interface::
+writeExodusStep(double timestep,
+                const Teuchos::ParameterList& globalData,
+                std::vector<std::vector<double>>& values)
+{
+  globalToExodus(GlobalVariable::ADD, globalData);
+  meshData_->begin_output_step(meshIndex_, timestep);
+  for (std::size_t i = 0; i < exodusOutputFields_.size(); ++i)
+    exodusOutputFields_[i].entity->put_field_data(exodusOutputFields_[i].name,
+      values[i]);
+  globalToExodus(GlobalVariable::WRITE, globalData);
+  meshData_->end_output_step(meshIndex_);
+} // end of writeExodusStep()
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  buildExodusOutputFields()
+//
+///////////////////////////////////////////////////////////////////////////////
+bool
+STK_Interface::
+buildExodusOutputFields()
+{
+  exodusOutputFields_.clear();
+
+  auto region = meshData_->get_output_ioss_region(meshIndex_);
+  stk::io::OutputParams params(*region, *bulkData_);
+
+  // the entities are listed the way stk_io lists them when it writes a field
+  auto addFields = [&](Ioss::GroupingEntity* entity,
+                       stk::mesh::EntityRank rank)
+  {
+    Ioss::NameList names;
+    entity->field_describe(Ioss::Field::TRANSIENT, &names);
+    if (names.empty())
+      return true;
+
+    std::vector<stk::mesh::Entity> entities;
+    stk::io::get_output_entity_list(entity, rank, params, entities);
+    for (const std::string& name : names)
+    {
+      const stk::mesh::FieldBase* field = metaData_->get_field(rank, name);
+      if (field == nullptr)
+        return false;
+
+      ExodusOutputField output;
+      output.entity = entity;
+      output.name = name;
+      output.field = field;
+      output.entities = entities;
+      output.components = entity->get_field(name).raw_storage()->component_count();
+      exodusOutputFields_.push_back(output);
+    }
+    return true;
+  };
+
+  bool found = true;
+  for (Ioss::NodeBlock* block : region->get_node_blocks())
+    found = addFields(block, stk::topology::NODE_RANK) && found;
+  for (Ioss::EdgeBlock* block : region->get_edge_blocks())
+    found = addFields(block, stk::topology::EDGE_RANK) && found;
+  for (Ioss::FaceBlock* block : region->get_face_blocks())
+    found = addFields(block, stk::topology::FACE_RANK) && found;
+  for (Ioss::ElementBlock* block : region->get_element_blocks())
+    found = addFields(block, stk::topology::ELEM_RANK) && found;
+  for (Ioss::NodeSet* set : region->get_nodesets())
+    found = addFields(set, stk::topology::NODE_RANK) && found;
+  for (Ioss::SideSet* set : region->get_sidesets())
+    for (Ioss::SideBlock* block : set->get_side_blocks())
+      found = addFields(block, metaData_->side_rank()) && found;
+
+  if (not found)
+    exodusOutputFields_.clear();
+  return found;
+} // end of buildExodusOutputFields()
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  freeExodusComm()
+//
+///////////////////////////////////////////////////////////////////////////////
+void
+STK_Interface::
+freeExodusComm()
+{
+  int finalized = 0;
+  MPI_Finalized(&finalized);
+  if (exodusComm_ != MPI_COMM_NULL && not finalized)
+    MPI_Comm_free(&exodusComm_);
+  exodusComm_ = MPI_COMM_NULL;
+} // end of freeExodusComm()
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  globalToExodus()
@@ -751,21 +1041,22 @@ writeToExodus(double timestep)
 ///////////////////////////////////////////////////////////////////////////////
 void
 STK_Interface::
-globalToExodus(const GlobalVariable& flag)
+globalToExodus(const GlobalVariable& flag,
+               const Teuchos::ParameterList& globalData)
 {
   using Teuchos::Array;
 
   // Loop over all the global variables to be added to the Exodus output file.
   // For each global variable, we determine the data type, and then add or
   // write it accordingly, depending on the value of flag.
-  for (auto i = globalData_.begin(); i != globalData_.end(); ++i)
+  for (auto i = globalData.begin(); i != globalData.end(); ++i)
   {
-    const std::string& name = globalData_.name(i);
+    const std::string& name = globalData.name(i);
 
     // Integers.
-    if (globalData_.isType<int>(name))
+    if (globalData.isType<int>(name))
     {
-      const auto& value = globalData_.get<int>(name);
+      const auto& value = globalData.get<int>(name);
       if (flag == GlobalVariable::ADD)
       {
         try
@@ -784,9 +1075,9 @@ globalToExodus(const GlobalVariable& flag)
     }
 
     // Doubles.
-    else if (globalData_.isType<double>(name))
+    else if (globalData.isType<double>(name))
     {
-      const auto& value = globalData_.get<double>(name);
+      const auto& value = globalData.get<double>(name);
       if (flag == GlobalVariable::ADD)
       {
         try
@@ -805,9 +1096,9 @@ globalToExodus(const GlobalVariable& flag)
     }
 
     // Vectors of integers.
-    else if (globalData_.isType<Array<int>>(name))
+    else if (globalData.isType<Array<int>>(name))
     {
-      const auto& value = globalData_.get<Array<int>>(name).toVector();
+      const auto& value = globalData.get<Array<int>>(name).toVector();
       if (flag == GlobalVariable::ADD)
       {
         try
@@ -826,9 +1117,9 @@ globalToExodus(const GlobalVariable& flag)
     }
 
     // Vectors of doubles.
-    else if (globalData_.isType<Array<double>>(name))
+    else if (globalData.isType<Array<double>>(name))
     {
-      const auto& value = globalData_.get<Array<double>>(name).toVector();
+      const auto& value = globalData.get<Array<double>>(name).toVector();
       if (flag == GlobalVariable::ADD)
       {
         try
@@ -852,7 +1143,7 @@ globalToExodus(const GlobalVariable& flag)
         "STK_Interface::globalToExodus():  The global variable to be added "  \
         "to the Exodus output file is of an invalid type.  Valid types are "  \
         "int and double, along with std::vectors of those types.")
-  } // end loop over globalData_
+  } // end loop over globalData
 } // end of globalToExodus()
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -1010,7 +1301,7 @@ void STK_Interface::getNodeIdsForElement(const stk::mesh::Entity& element,std::v
 
 void STK_Interface::getNodeIdsForElement(const panzer::LocalOrdinal& elmtLid, std::vector<panzer::GlobalOrdinal>& nodeIds) const
 {
-  stk::mesh::Entity const& element = ownedElements_[elmtLid];
+  stk::mesh::Entity const& element = allElements_[elmtLid];
   stk::mesh::Entity const* nodeRel = bulkData_->begin_nodes(element);
   const size_t numNodes = bulkData_->num_nodes(element);
 
@@ -1023,7 +1314,7 @@ void STK_Interface::getNodeIdsForElement(const panzer::LocalOrdinal& elmtLid, st
 void STK_Interface::getEdgeIdsForElement(const panzer::LocalOrdinal& elmtLid,std::vector<panzer::GlobalOrdinal> & edgsIds) const
 {
   edgsIds.clear();
-  stk::mesh::Entity const& element = ownedElements_[elmtLid];
+  stk::mesh::Entity const& element = allElements_[elmtLid];
   
   const stk::mesh::EntityRank rank = this->getEdgeRank();
   const size_t num_rels = bulkData_->num_connectivity(element, rank);
@@ -1038,7 +1329,7 @@ void STK_Interface::getEdgeIdsForElement(const panzer::LocalOrdinal& elmtLid,std
 void STK_Interface::getFaceIdsForElement(const panzer::LocalOrdinal& elmtLid,std::vector<panzer::GlobalOrdinal> & facesgid) const
 {
      facesgid.clear();
-	 stk::mesh::Entity const& element = ownedElements_[elmtLid];
+	 stk::mesh::Entity const& element = allElements_[elmtLid];
 
    	 const stk::mesh::EntityRank rank = this->getFaceRank();
      const size_t num_rels = bulkData_->num_connectivity(element, rank);
@@ -2207,6 +2498,72 @@ Teuchos::RCP<const std::vector<stk::mesh::Entity> > STK_Interface::getElementsOr
    return orderedElementVector_.getConst();
 }
 
+const STK_Interface::ElementFieldSlots &
+STK_Interface::getElementFieldSlots(const SolutionFieldType & field) const
+{
+   // the buckets holding the field data move when the mesh is modified
+   const std::size_t count = bulkData_->synchronized_count();
+   if(count!=elementFieldSlotsCount_) {
+      elementFieldSlots_.clear();
+      elementFieldSlotsCount_ = count;
+   }
+
+   auto itr = elementFieldSlots_.find(&field);
+   if(itr!=elementFieldSlots_.end())
+      return itr->second;
+
+   const std::vector<stk::mesh::Entity> & elements = *(this->getElementsOrderedByLID());
+   const bool nodal = field.entity_rank()==getNodeRank();
+
+   ElementFieldSlots & slots = elementFieldSlots_[&field];
+   slots.offsets.reserve(elements.size()+1);
+   slots.offsets.push_back(0);
+   for(const stk::mesh::Entity element : elements) {
+      if(nodal) {
+         const std::size_t num_nodes = bulkData_->num_nodes(element);
+         stk::mesh::Entity const* nodes = bulkData_->begin_nodes(element);
+         for(std::size_t i=0;i<num_nodes;++i)
+            slots.values.push_back(stk::mesh::field_data(field,nodes[i]));
+      }
+      else
+         slots.values.push_back(stk::mesh::field_data(field,element));
+      slots.offsets.push_back(slots.values.size());
+   }
+
+   return slots;
+}
+
+std::shared_ptr<const TianXin::SolutionFieldTransfer>
+STK_Interface::getSolutionFieldTransfer(const Teuchos::RCP<const panzer::GlobalIndexer> & dofMngr) const
+{
+   // the weak reference keeps the RCP node of a destroyed DOF manager alive,
+   // so it shares no resource with any later one
+   for(const SolutionFieldTransferEntry & entry : solutionFieldTransfers_) {
+      if(entry.dofMngr.shares_resource(dofMngr))
+         return entry.transfer;
+   }
+   return nullptr;
+}
+
+void STK_Interface::setSolutionFieldTransfer(const Teuchos::RCP<const panzer::GlobalIndexer> & dofMngr,
+                                             const std::shared_ptr<const TianXin::SolutionFieldTransfer> & transfer)
+{
+   TEUCHOS_ASSERT(dofMngr!=Teuchos::null);
+
+   std::vector<SolutionFieldTransferEntry> entries;
+   for(const SolutionFieldTransferEntry & entry : solutionFieldTransfers_) {
+      if(entry.dofMngr.is_valid_ptr() && not entry.dofMngr.shares_resource(dofMngr))
+         entries.push_back(entry);
+   }
+
+   SolutionFieldTransferEntry entry;
+   entry.dofMngr = dofMngr.create_weak();
+   entry.transfer = transfer;
+   entries.push_back(entry);
+
+   solutionFieldTransfers_.swap(entries);
+}
+
 void STK_Interface::addElementBlock(const std::string & name,const CellTopologyData * ctData)
 {
    TEUCHOS_ASSERT(not initialized_);
@@ -2344,13 +2701,14 @@ void STK_Interface::buildLocalElementIDs()
    std::size_t currentLocalId = 0;
 
    orderedElementVector_ = Teuchos::null; // forces rebuild of ordered lists
+   elementFieldSlots_.clear(); // indexed by local id
 	
-   ownedElements_.clear();
-   getMyElements(ownedElements_);
-
    // might be better (faster) to do this by buckets
    std::vector<stk::mesh::Entity> elements;
    getMyElements(elements);
+   orderElements(*this,elementOrdering_,elements);
+
+   ownedElements_ = elements;
 
    for(std::size_t index=0;index<elements.size();++index) {
       stk::mesh::Entity element = elements[index];
@@ -2383,6 +2741,18 @@ void STK_Interface::buildLocalElementIDs()
    }
 
    orderedElementVector_->insert(orderedElementVector_->end(),elements.begin(),elements.end());
+
+   // owned then neighbor elements, so entity lookups by local id also work on the ghost layer
+   allElements_ = *orderedElementVector_;
+}
+
+void STK_Interface::setElementOrdering(ElementOrdering ordering)
+{
+   elementOrdering_ = ordering;
+
+   // rebuild the local ids if they are already in use
+   if(orderedElementVector_!=Teuchos::null)
+      buildLocalElementIDs();
 }
 
 void STK_Interface::applyElementLoadBalanceWeights()
@@ -2577,7 +2947,11 @@ void STK_Interface::getElementSideRelation( std::vector<std::size_t>& elements,
 		const stk::mesh::Entity* sides = bulkData_->begin(element,siderank);//if( getComm()->getRank()==1 ) std::cout << " ok\n";
 		for (unsigned i=0; i<numSides; ++i) {
 			const auto& gid = bulkData_->identifier( sides[i] );//if( getComm()->getRank()==1 ) std::cout << gid << " gid\n";	
-			element2sides.emplace_back(localSideIDHash_.at(gid));
+			const auto sideItr = localSideIDHash_.find(gid);
+			TEUCHOS_TEST_FOR_EXCEPTION(sideItr==localSideIDHash_.end(),std::logic_error,
+			                           "STK_Interface::getElementSideRelation: side " << gid << " of element "
+			                           << this->elementGlobalId(ele) << " has no local side id");
+			element2sides.emplace_back(sideItr->second);
 		}
 	}
 
@@ -65,11 +65,18 @@
 #include <Kokkos_ViewFactory.hpp>
 
 #include "TianXin_AbstractDiscretation.hpp"
+#include "Panzer_STK_ElementOrdering.hpp"
+#include "Panzer_STK_AsyncWriteQueue.hpp"
 
+#include <memory>
 #include <unordered_map>
 
 #ifdef PANZER_HAVE_IOSS
 #include <stk_io/StkMeshIoBroker.hpp>
+
+namespace Ioss {
+  class GroupingEntity;
+}
 #endif
 
 #ifdef PANZER_HAVE_PERCEPT
@@ -79,6 +86,14 @@ namespace percept {
 }
 #endif
 
+namespace panzer {
+  class GlobalIndexer;
+}
+
+namespace TianXin {
+  class SolutionFieldTransfer;
+}
+
 namespace panzer_stk {
 
 class PeriodicBC_MatcherBase;
@@ -100,6 +115,9 @@ public:
 
    STK_Interface(Teuchos::RCP<stk::mesh::MetaData> metaData);
 
+   //! Finishes any Exodus output still being written
+   ~STK_Interface();
+
    // functions called before initialize
    //////////////////////////////////////////
 
@@ -532,6 +550,50 @@ public:
   void
   writeToExodus( double timestep );
 
+  /**
+   *  \brief Write Exodus output steps on a background thread.
+   *
+   *  With this enabled `writeToExodus(double timestep)` copies the values of
+   *  the output fields and global variables into buffers owned by the step,
+   *  queues the step and returns. A background thread writes the buffers to
+   *  the output file, without touching the bulk data, while the caller goes on
+   *  changing the fields. At most `maxQueuedSteps` steps wait to be written;
+   *  further calls block until one finishes, so at most that many copies of
+   *  the output fields are held.
+   *
+   *  The first step of each output file is written on the calling thread, it
+   *  defines the fields of the file and the order of their values.
+   *
+   *  The writer makes its collective calls on a duplicate of the mesh
+   *  communicator.
+   *
+   *  \note Must be called before `initialize()`.
+   *  \note The mesh must not be modified while steps are being written,
+   *        `beginModification()` waits for them.
+   *
+   *  \param[in] maxQueuedSteps Largest number of steps waiting to be written.
+   *
+   *  \throws `std::runtime_error` If MPI does not provide
+   *                               `MPI_THREAD_MULTIPLE`.
+   */
+  void
+  enableAsyncExodusOutput(int maxQueuedSteps = 2);
+
+  //! Is Exodus output written on a background thread
+  bool
+  isAsyncExodusOutputEnabled() const
+  { return maxQueuedExodusSteps_>0; }
+
+  /**
+   *  \brief Block until every step passed to `writeToExodus(double timestep)`
+   *         has been written.
+   *
+   *  Rethrows any error raised while writing a queued step.  Collective:
+   *  if a step failed on some process, every process throws.
+   */
+  void
+  flushExodusOutput();
+
   /**
    *  \brief Add an `int` global variable to the information to be written to
    *         the Exodus output file.
@@ -974,6 +1036,43 @@ public:
    void setCellFieldData(const std::string & fieldName,const std::string & blockId,
                          const std::vector<std::size_t> & localElementIds,const ArrayT & solutionValues,double scaleValue=1.0);
 
+   /** Storage of a solution or cell field, element by element in local id order.
+     * Element <code>lid</code> owns <code>values[offsets[lid]]</code> to
+     * <code>values[offsets[lid+1]-1]</code>: the value at each of its nodes for a
+     * solution field, its own value for a cell field.
+     */
+   struct ElementFieldSlots {
+      std::vector<std::size_t> offsets;
+      std::vector<double*> values;
+   };
+
+   /** Get the storage slots of a solution or cell field. They are built on the
+     * first call for the field and rebuilt once the mesh is modified or the
+     * element local ids change, so <code>setSolutionFieldData</code> and
+     * <code>setCellFieldData</code> write a workset without any entity lookups.
+     * Fetch the slots again before each write rather than holding on to them.
+     */
+   const ElementFieldSlots & getElementFieldSlots(const SolutionFieldType & field) const;
+
+   /** Get the transfer of ghosted solution vectors to the solution fields kept
+     * for <code>dofMngr</code> (see <code>TianXin::pushSolutionOnFields</code>),
+     * null if none was set. The mesh holds the DOF manager weakly, so a
+     * transfer is never returned for another DOF manager, even one allocated
+     * at the same address.
+     */
+   std::shared_ptr<const TianXin::SolutionFieldTransfer>
+   getSolutionFieldTransfer(const Teuchos::RCP<const panzer::GlobalIndexer> & dofMngr) const;
+
+   /** Keep the transfer of ghosted solution vectors built for <code>dofMngr</code>,
+     * replacing any earlier one. Transfers of destroyed DOF managers are dropped.
+     */
+   void setSolutionFieldTransfer(const Teuchos::RCP<const panzer::GlobalIndexer> & dofMngr,
+                                 const std::shared_ptr<const TianXin::SolutionFieldTransfer> & transfer);
+
+   //! Number of transfers of ghosted solution vectors kept by the mesh
+   std::size_t numSolutionFieldTransfers() const
+   { return solutionFieldTransfers_.size(); }
+
    /** Get Vector of edge entities ordered by their LID, returns an RCP so that
      * it is easily stored by the caller.
      */
@@ -1257,6 +1356,18 @@ public:
    void setBlockWeight(const std::string & blockId,double weight)
    { blockWeights_[blockId] = weight; }
 
+   /** Set the order of the locally owned elements. Element local IDs, and
+     * therefore worksets and the DOF numbering built on them, follow this
+     * order. If the local IDs are already built they are rebuilt, so this
+     * must be called before any connection manager or DOF manager is constructed.
+     */
+   void setElementOrdering(ElementOrdering ordering);
+
+   /** Get the order of the locally owned elements (Native by default).
+     */
+   ElementOrdering getElementOrdering() const
+   { return elementOrdering_; }
+
    /** When coordinates are returned in the getElementVertices
      * method, extract coordinates using a specified field (not the intrinsic coordinates)
      * where available (where unavailable the intrinsic coordinates are used.
@@ -1411,6 +1522,7 @@ protected:
 	
    std::vector<stk::mesh::Entity> ownedElements_;
    std::vector<stk::mesh::Entity> allElements_;
+   ElementOrdering elementOrdering_ = ElementOrdering::Native;
 
    std::map<std::string, stk::mesh::Part*> elementBlocks_;  // Element blocks
    std::map<std::string, stk::mesh::Part*> sidesets_;       // Side sets
@@ -1488,6 +1600,8 @@ protected:
    *  \param[in] flag Either `GlobalVariable::ADD` or `GlobalVariable::WRITE`,
    *                  indicating that the global variables should be added or
    *                  written to the mesh database, respectively.
+   *  \param[in] globalData The global variables, either `globalData_` or the
+   *                        copy taken when an asynchronous step was queued.
    *
    *  \throws `std::invalid_argument` If a global variable is not an `int`,
    *                                  `double`, `std::string`,
@@ -1496,17 +1610,92 @@ protected:
    *                                  `std::vector<std::string>`.
    */
   void
-  globalToExodus(const GlobalVariable& flag);
+  globalToExodus(const GlobalVariable& flag,
+                 const Teuchos::ParameterList& globalData);
+
+  /**
+   *  \brief Write one output step with the given global variables.
+   */
+  void
+  writeExodusStep(double timestep,
+                  const Teuchos::ParameterList& globalData);
+
+  /**
+   *  \brief Write one output step from the values copied when it was queued.
+   *
+   *  Only the output region is used, not the bulk data.
+   *
+   *  \param[in] values The values of each of `exodusOutputFields_`.
+   */
+  void
+  writeExodusStep(double timestep,
+                  const Teuchos::ParameterList& globalData,
+                  std::vector<std::vector<double> >& values);
+
+  /**
+   *  \brief Find the transient fields of the output region and the entities
+   *         their values belong to, in the order of the region.
+   *
+   *  \returns False if some field of the region is not a field of the mesh.
+   */
+  bool
+  buildExodusOutputFields();
+
+  /**
+   *  \brief Free the duplicate communicator of the output file, if any.
+   */
+  void
+  freeExodusComm();
+
+  /**
+   *  \brief Throw on every process if writing a queued step failed on any.
+   *
+   *  A process whose writer failed rethrows its error, the others throw a
+   *  `std::runtime_error`.  Collective, so that no process queues another
+   *  step, whose collective write the failed process would never make.
+   */
+  void
+  agreeOnExodusWriteError();
 
   /**
    *  \brief The global variable(s) to be added to the Exodus output.
    */
   Teuchos::ParameterList globalData_;
+
+  /**
+   *  \brief The values of a transient field on one entity of the output
+   *         region.
+   */
+  struct ExodusOutputField
+  {
+    Ioss::GroupingEntity* entity;
+    std::string name; // of the field in the region
+    const stk::mesh::FieldBase* field;
+    std::vector<stk::mesh::Entity> entities; // in the order of the region
+    std::size_t components;
+  };
+
+  // found after the first step of the output file, empty until then
+  std::vector<ExodusOutputField> exodusOutputFields_;
+  bool exodusOutputFieldsBuilt_ = false;
+
+  // writes the output steps, null if they are written on the calling thread
+  std::unique_ptr<AsyncWriteQueue> exodusWriteQueue_;
+
+  // duplicate of the mesh communicator the output file is written on, if the
+  // steps are written in the background
+  MPI_Comm exodusComm_ = MPI_COMM_NULL;
 #endif
 
+   std::size_t maxQueuedExodusSteps_; // zero if asynchronous output is disabled
+
    // uses lazy evaluation
    mutable Teuchos::RCP<std::vector<stk::mesh::Entity> > orderedElementVector_;
 
+   // uses lazy evaluation, valid for the bulk data state elementFieldSlotsCount_
+   mutable std::unordered_map<const SolutionFieldType*,ElementFieldSlots> elementFieldSlots_;
+   mutable std::size_t elementFieldSlotsCount_ = 0;
+
    // uses lazy evaluation
    mutable Teuchos::RCP<std::vector<stk::mesh::Entity> > orderedEdgeVector_;
 
@@ -1545,13 +1734,22 @@ protected:
    private:
      const STK_Interface * mesh_;
    };
+
+private:
+
+   // a transfer of ghosted solution vectors and a weak reference to the DOF
+   // manager it was built for
+   struct SolutionFieldTransferEntry {
+      Teuchos::RCP<const panzer::GlobalIndexer> dofMngr;
+      std::shared_ptr<const TianXin::SolutionFieldTransfer> transfer;
+   };
+   std::vector<SolutionFieldTransferEntry> solutionFieldTransfers_;
 };
 
 template <typename ArrayT>
 void STK_Interface::setSolutionFieldData(const std::string & fieldName,const std::string & blockId,
                                          const std::vector<std::size_t> & localElementIds,const ArrayT & solutionValues,double scaleValue)
 {
-   const std::vector<stk::mesh::Entity> & elements = *(this->getElementsOrderedByLID());
    auto solutionValues_h = Kokkos::create_mirror_view(solutionValues);
    Kokkos::deep_copy(solutionValues_h, solutionValues);
 
@@ -1561,22 +1759,16 @@ void STK_Interface::setSolutionFieldData(const std::string & fieldName,const std
      return;
    }
 
-   SolutionFieldType * field = this->getSolutionField(fieldName,blockId);
+   const ElementFieldSlots & slots = getElementFieldSlots(*this->getSolutionField(fieldName,blockId));
 
    for(std::size_t cell=0;cell<localElementIds.size();cell++) {
       std::size_t localId = localElementIds[cell];
-      stk::mesh::Entity element = elements[localId];
 
       // loop over nodes set solution values
-      const size_t num_nodes = bulkData_->num_nodes(element);
-      stk::mesh::Entity const* nodes = bulkData_->begin_nodes(element);
-      for(std::size_t i=0; i<num_nodes; ++i) {
-        stk::mesh::Entity node = nodes[i];
-
-        double * solnData = stk::mesh::field_data(*field,node);
-        // TEUCHOS_ASSERT(solnData!=0); // only needed if blockId is not specified
-        solnData[0] = scaleValue*solutionValues_h(cell,i);
-      }
+      double * const * solnData = slots.values.data()+slots.offsets[localId];
+      const std::size_t num_nodes = slots.offsets[localId+1]-slots.offsets[localId];
+      for(std::size_t i=0; i<num_nodes; ++i)
+        *solnData[i] = scaleValue*solutionValues_h(cell,i);
    }
 }
 
@@ -1643,18 +1835,13 @@ template <typename ArrayT>
 void STK_Interface::setCellFieldData(const std::string & fieldName,const std::string & blockId,
                                      const std::vector<std::size_t> & localElementIds,const ArrayT & solutionValues,double scaleValue)
 {
-   const std::vector<stk::mesh::Entity> & elements = *(this->getElementsOrderedByLID());
-
-   SolutionFieldType * field = this->getCellField(fieldName,blockId);
+   const ElementFieldSlots & slots = getElementFieldSlots(*this->getCellField(fieldName,blockId));
 
    auto solutionValues_h = Kokkos::create_mirror_view(solutionValues);
    Kokkos::deep_copy(solutionValues_h, solutionValues);
 
    for(std::size_t cell=0;cell<localElementIds.size();cell++) {
-      std::size_t localId = localElementIds[cell];
-      stk::mesh::Entity element = elements[localId];
-
-      double * solnData = stk::mesh::field_data(*field,element);
+      double * solnData = slots.values[slots.offsets[localElementIds[cell]]];
       TEUCHOS_ASSERT(solnData!=0); // only needed if blockId is not specified
       solnData[0] = scaleValue*solutionValues_h.access(cell,0);
    }
@@ -107,6 +107,8 @@ public:
 
   int getIndex() const {return index_;}
 
+  bool isRelative() const {return relative_;}
+
   int getPeriodicDirection() const
   {
     // This assumes a 2D x-y mesh even though the object supports the
@@ -203,6 +205,7 @@ public:
 
   int getIndex0() const {return index0_;}
   int getIndex1() const {return index1_;}
+  bool isRelative() const {return relative_;}
   int getPeriodicDirection() const
   {
     if (index0_ ==0) {
@@ -121,6 +121,20 @@ namespace periodic_helpers {
                             const STK_Interface & mesh,
                             const std::string & sideName,const Matcher & matcher, const std::string type_ = "coord");
  
+   /** Match the locally owned side ids and coordinates against the passed in
+     * (globally distributed) ids and coordinates. Returns (passed in gid, local gid)
+     * pairs. For coordinate and plane matchers the passed in coordinates are
+     * bucketed on a grid no finer than the matching tolerance, so only
+     * neighboring buckets are tested. Other matchers test all pairs.
+     */
+   template <typename Matcher>
+   Teuchos::RCP<std::vector<std::pair<std::size_t,std::size_t> > >
+   matchSideIdsAndCoords(const std::vector<std::size_t> & side_ids,
+                         const std::vector<Teuchos::Tuple<double,3> > & side_coords,
+                         const std::vector<std::size_t> & local_side_ids,
+                         const std::vector<Teuchos::Tuple<double,3> > & local_side_coords,
+                         const Matcher & matcher);
+ 
    /** Builds a vector of local ids and their matching global indices.
      * This requires a previously discovered vector of pairs of locally matched
      * ids to distribute. This vector comes from the getLocallyMatchedSideIds.
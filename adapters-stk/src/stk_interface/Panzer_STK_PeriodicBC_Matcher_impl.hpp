@@ -45,14 +45,90 @@
 
 #include "PanzerAdaptersSTK_config.hpp"
 #include "Panzer_STK_Interface.hpp"
+#include "Panzer_STK_PeriodicBC_MatchConditions.hpp"
 
 #include "Teuchos_FancyOStream.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
 #include <set>
+#include <unordered_map>
 
 namespace panzer_stk {
 namespace periodic_helpers {
 
+/** Bucketing support for matching side coordinates. A matcher that compares
+  * a fixed set of coordinate components up to a bounded tolerance can be
+  * searched on a grid with cells of that size: a matching pair is always in
+  * the same or a neighboring cell.
+  */
+namespace bucketing {
+
+typedef std::array<long long,2> CellKey;
+
+struct CellKeyHash {
+   std::size_t operator()(const CellKey & key) const
+   { return std::hash<long long>()(key[0]) ^ (std::hash<long long>()(key[1])*0x9e3779b97f4a7c15ULL); }
+};
+
+//! Extent of component <code>index</code> over both sets of coordinates
+inline double coordinateSpan(const std::vector<Teuchos::Tuple<double,3> > & a,
+                             const std::vector<Teuchos::Tuple<double,3> > & b,int index)
+{
+   double lo = std::numeric_limits<double>::max(), hi = std::numeric_limits<double>::lowest();
+   for(const auto & x : a) { lo = std::min(lo,x[index]); hi = std::max(hi,x[index]); }
+   for(const auto & x : b) { lo = std::min(lo,x[index]); hi = std::max(hi,x[index]); }
+   return hi>=lo ? hi-lo : 0.0;
+}
+
+//! By default a matcher can't be bucketed, all pairs are tested
+template <typename Matcher>
+bool matchedComponents(const Matcher &,
+                       const std::vector<Teuchos::Tuple<double,3> > &,const std::vector<Teuchos::Tuple<double,3> > &,
+                       std::vector<int> &,double &)
+{ return false; }
+
+inline bool matchedComponents(const CoordMatcher & matcher,
+                              const std::vector<Teuchos::Tuple<double,3> > & a,const std::vector<Teuchos::Tuple<double,3> > & b,
+                              std::vector<int> & components,double & tolerance)
+{
+   components.assign(1,matcher.getIndex());
+   tolerance = matcher.getAbsoluteTolerance();
+
+   // a relative tolerance scales with the distance between the sides, bound it by the extent
+   if(matcher.isRelative())
+      tolerance *= coordinateSpan(a,b,1-matcher.getIndex());
+   return true;
+}
+
+inline bool matchedComponents(const PlaneMatcher & matcher,
+                              const std::vector<Teuchos::Tuple<double,3> > & a,const std::vector<Teuchos::Tuple<double,3> > & b,
+                              std::vector<int> & components,double & tolerance)
+{
+   components.assign({matcher.getIndex0(),matcher.getIndex1()});
+   tolerance = matcher.getAbsoluteTolerance();
+   if(matcher.isRelative())
+      tolerance = std::max(tolerance,tolerance*coordinateSpan(a,b,3-matcher.getIndex0()-matcher.getIndex1()));
+   return true;
+}
+
+//! Grid cell of a point, false if it is out of range for the cell size
+inline bool cellKey(const Teuchos::Tuple<double,3> & x,const std::vector<int> & components,double cellSize,CellKey & key)
+{
+   key[0] = key[1] = 0;
+   for(std::size_t c=0;c<components.size();++c) {
+      const double k = std::floor(x[components[c]]/cellSize);
+      if(!(std::fabs(k)<1e18))
+         return false;
+      key[c] = static_cast<long long>(k);
+   }
+   return true;
+}
+
+}
+
 template <typename Matcher>
 Teuchos::RCP<std::vector<std::pair<std::size_t,std::size_t> > >
 matchPeriodicSides(const std::string & left,const std::string & right,
@@ -70,7 +146,7 @@ matchPeriodicSides(const std::string & left,const std::string & right,
   //    3. If a processor requires a node on the left (if it is owned or ghosted)
   //       communicate matching conditions from the right boundary
   //
-  // Note: The matching check could definitely be sped up with a sorting operation
+  // Note: The matching check buckets coordinates for coordinate and plane matchers
   // Note: The communication could be done in a way that requires less global communication
   //       Essentially doing step one in a Many-2-Many way as opposed to an All-2-All
   //
@@ -126,18 +202,27 @@ matchPeriodicSides(const std::string & left,const std::string & right,
                                                                            // of IDs
   std::vector<std::pair<std::size_t,std::size_t> > unusedOwnedToMapped;
 
+  // positions of each ID in locallyRequiredIds, kept up to date as IDs are
+  // replaced so the first position is the one a linear search would find
+  std::unordered_map<std::size_t,std::set<std::size_t> > requiredPositions;
+  for(std::size_t i=0;i<locallyRequiredIds->size();i++)
+     requiredPositions[(*locallyRequiredIds)[i]].insert(i);
+
   // apply previous mappings to this set of local IDs
   for(std::size_t i=0;i<ownedToMapped.size();i++) {
      std::size_t owned = ownedToMapped[i].first;
      std::size_t mapped = ownedToMapped[i].second;
 
-     std::vector<std::size_t>::iterator itr
-        = std::find(locallyRequiredIds->begin(),locallyRequiredIds->end(),owned);
+     auto itr = requiredPositions.find(owned);
 
      // if found, replace the local ID with the previously matched ID
      // this means the locallyRequiredIds may now include IDs owned by a different processor
-     if(itr!=locallyRequiredIds->end())
-       *itr = mapped;
+     if(itr!=requiredPositions.end() && !itr->second.empty()) {
+       const std::size_t position = *itr->second.begin();
+       itr->second.erase(itr->second.begin());
+       (*locallyRequiredIds)[position] = mapped;
+       requiredPositions[mapped].insert(position);
+     }
      else
        unusedOwnedToMapped.push_back(ownedToMapped[i]);
   }
@@ -160,6 +245,8 @@ matchPeriodicSides(const std::string & left,const std::string & right,
   // this is a result (and fix) for some of the complexity incurred by
   // the reverseMap above.
   {
+     const std::set<std::size_t> saved_locallyRequiredIdSet(saved_locallyRequiredIds.begin(),saved_locallyRequiredIds.end());
+
      // fill up set with current globally matched ids (not neccessarily owned/ghosted)
      std::set<std::pair<std::size_t,std::size_t> > gmi_set;
      gmi_set.insert(globallyMatchedIds->begin(),globallyMatchedIds->end());
@@ -176,9 +263,7 @@ matchPeriodicSides(const std::string & left,const std::string & right,
            gmi_set.insert(std::make_pair(others[j],pair.second));
 
         // remove ids that are not ghosted/owned by this processor
-        if(std::find(saved_locallyRequiredIds.begin(),
-                     saved_locallyRequiredIds.end(),
-                     pair.first)==saved_locallyRequiredIds.end()) {
+        if(saved_locallyRequiredIdSet.find(pair.first)==saved_locallyRequiredIdSet.end()) {
            gmi_set.erase(pair);
         }
      }
@@ -211,7 +296,7 @@ matchPeriodicSides(const std::string & left,const std::string & right,
   //    3. If a processor requires a node on the left (if it is owned or ghosted)
   //       communicate matching conditions from the right boundary
   //
-  // Note: The matching check could definitely be spead up with a sorting operation
+  // Note: The matching check buckets coordinates for coordinate and plane matchers
   // Note: The communication could be done in a way that requires less global communication
   //       Essentially doing step one in a Many-2-Many way as opposed to an All-2-All
   //
@@ -270,12 +355,6 @@ getLocallyMatchedSideIds(const std::vector<std::size_t> & side_ids,
                          const panzer_stk::STK_Interface & mesh,
                          const std::string & sideName,const Matcher & matcher, std::string type_)
 {
-   using Teuchos::RCP;
-   using Teuchos::Tuple;
-
-   RCP<std::vector<std::pair<std::size_t,std::size_t> > > result
-         = Teuchos::rcp(new std::vector<std::pair<std::size_t,std::size_t> >);
-
    // grab local IDs and coordinates on this side
    //////////////////////////////////////////////////////////////////
 
@@ -286,31 +365,96 @@ getLocallyMatchedSideIds(const std::vector<std::size_t> & side_ids,
    std::vector<std::size_t> & local_side_ids = *sidePair.first;
    std::vector<Teuchos::Tuple<double,3> > & local_side_coords = *sidePair.second;
 
+   return matchSideIdsAndCoords(side_ids,side_coords,local_side_ids,local_side_coords,matcher);
+}
+
+template <typename Matcher>
+Teuchos::RCP<std::vector<std::pair<std::size_t,std::size_t> > >
+matchSideIdsAndCoords(const std::vector<std::size_t> & side_ids,
+                      const std::vector<Teuchos::Tuple<double,3> > & side_coords,
+                      const std::vector<std::size_t> & local_side_ids,
+                      const std::vector<Teuchos::Tuple<double,3> > & local_side_coords,
+                      const Matcher & matcher)
+{
+   using Teuchos::RCP;
+   using bucketing::CellKey;
+
+   RCP<std::vector<std::pair<std::size_t,std::size_t> > > result
+         = Teuchos::rcp(new std::vector<std::pair<std::size_t,std::size_t> >);
+
    bool checkProb = false;
    std::vector<bool> side_flags(side_ids.size(),false);
 
-   // do a slow search for the coordinates: this _can_ be sped
-   // up! (considered searches in sorted ranges using the sorted_permutation function)
+   // record a match, the candidates are tested in increasing order
+   // so the result is the same as testing all pairs
+   auto testCandidate = [&](std::size_t globalNode,std::size_t localNode) {
+      if(matcher(side_coords[globalNode],local_side_coords[localNode])) {
+         if(side_flags[globalNode]) // has this node been matched by this
+            checkProb = true;       // processor?
+
+         result->push_back(std::make_pair(side_ids[globalNode],local_side_ids[localNode]));
+         side_flags[globalNode] = true;
+      }
+   };
+
+   // bucket the globally distributed coordinates on a grid of the tolerance
    ////////////////////////////////////////////////////////
-   for(std::size_t localNode=0;localNode<local_side_ids.size();localNode++) {
-      std::size_t local_gid = local_side_ids[localNode];
-      const Tuple<double,3> & local_coord = local_side_coords[localNode];
-
-      // loop over globally distributed coordinates and find a match
-      for(std::size_t globalNode=0;globalNode<side_ids.size();globalNode++) {
-         std::size_t global_gid = side_ids[globalNode];
-         const Tuple<double,3> & global_coord = side_coords[globalNode];
-
-         if(matcher(global_coord,local_coord)) {
-            if(side_flags[globalNode]) // has this node been matched by this
-               checkProb = true;       // processor?
-
-            result->push_back(std::make_pair(global_gid,local_gid));
-            side_flags[globalNode] = true;
-            continue;
+   std::vector<int> components;
+   double cellSize = 0.0;
+   bool bucketed = bucketing::matchedComponents(matcher,side_coords,local_side_coords,components,cellSize)
+                && cellSize>0.0 && std::isfinite(cellSize);
+
+   std::vector<std::pair<CellKey,std::size_t> > cells;
+   if(bucketed) {
+      cells.resize(side_coords.size());
+      for(std::size_t globalNode=0;globalNode<side_coords.size() && bucketed;globalNode++) {
+         bucketed = bucketing::cellKey(side_coords[globalNode],components,cellSize,cells[globalNode].first);
+         cells[globalNode].second = globalNode;
+      }
+      for(std::size_t localNode=0;localNode<local_side_coords.size() && bucketed;localNode++) {
+         CellKey key;
+         bucketed = bucketing::cellKey(local_side_coords[localNode],components,cellSize,key);
+      }
+   }
+
+   if(bucketed) {
+      std::sort(cells.begin(),cells.end());
+
+      // cell -> range of sorted entries
+      std::unordered_map<CellKey,std::pair<std::size_t,std::size_t>,bucketing::CellKeyHash> cellRanges;
+      cellRanges.reserve(cells.size());
+      for(std::size_t begin=0,end=0;begin<cells.size();begin=end) {
+         for(end=begin+1;end<cells.size() && cells[end].first==cells[begin].first;++end) {}
+         cellRanges[cells[begin].first] = std::make_pair(begin,end);
+      }
+
+      const int numNeighbors = components.size()==1 ? 3 : 9;
+      std::vector<std::size_t> candidates;
+      for(std::size_t localNode=0;localNode<local_side_ids.size();localNode++) {
+         CellKey key;
+         bucketing::cellKey(local_side_coords[localNode],components,cellSize,key);
+
+         candidates.clear();
+         for(int n=0;n<numNeighbors;n++) {
+            const CellKey neighbor = {{ key[0]+(n%3)-1, components.size()==1 ? key[1] : key[1]+(n/3)-1 }};
+            auto itr = cellRanges.find(neighbor);
+            if(itr==cellRanges.end())
+               continue;
+            for(std::size_t i=itr->second.first;i<itr->second.second;i++)
+               candidates.push_back(cells[i].second);
          }
+         std::sort(candidates.begin(),candidates.end());
+
+         for(const std::size_t globalNode : candidates)
+            testCandidate(globalNode,localNode);
       }
    }
+   else {
+      // test all pairs
+      for(std::size_t localNode=0;localNode<local_side_ids.size();localNode++)
+         for(std::size_t globalNode=0;globalNode<side_ids.size();globalNode++)
+            testCandidate(globalNode,localNode);
+   }
 
    // make sure you matched everything you can: If this throws...it can
    // cause the process to hang!
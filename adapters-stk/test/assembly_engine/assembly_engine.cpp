@@ -43,7 +43,6 @@
 #include <Teuchos_ConfigDefs.hpp>
 #include <Teuchos_UnitTestHarness.hpp>
 #include <Teuchos_RCP.hpp>
-#include <Teuchos_TimeMonitor.hpp>
 
 using Teuchos::RCP;
 using Teuchos::rcp;
@@ -54,6 +53,7 @@ using Teuchos::rcp;
 #include "PanzerAdaptersSTK_config.hpp"
 #include "Panzer_STK_Interface.hpp"
 #include "Panzer_STK_SquareQuadMeshFactory.hpp"
+#include "Panzer_STK_CubeHexMeshFactory.hpp"
 #include "Panzer_STK_SetupUtilities.hpp"
 #include "Panzer_WorksetContainer.hpp"
 #include "Panzer_Workset_Builder.hpp"
@@ -69,6 +69,9 @@ using Teuchos::rcp;
 #include "Panzer_GlobalData.hpp"
 #include "Panzer_PauseToAttach.hpp"
 #include "Panzer_ParameterLibraryUtilities.hpp"
+#include "Panzer_Workset_Utilities.hpp"
+#include "Panzer_MatrixFreeJacobianOp.hpp"
+#include "Panzer_TpetraVector_ReadOnly_GlobalEvaluationData.hpp"
 
 #include "user_app_EquationSetFactory.hpp"
 #include "user_app_ClosureModel_Factory_TemplateBuilder.hpp"
@@ -86,15 +89,18 @@ using Teuchos::rcp;
 #include "Thyra_TpetraThyraWrappers.hpp"
 #include "Thyra_TpetraVector.hpp"
 #include "Thyra_TpetraVectorSpace.hpp"
+#include "Thyra_VectorStdOps.hpp"
 
 #include "Thyra_LinearOpTester.hpp"
 #include "Thyra_TestingTools.hpp"
 
+#include <algorithm>
 #include <cstdio> // for get char
+#include <set>
 
 namespace panzer {
 
-  void testInitialzation(const Teuchos::RCP<Teuchos::ParameterList>& ipb);
+  void testInitialzation(const Teuchos::RCP<Teuchos::ParameterList>& ipb,bool linearDiffusion=false);
 
   Teuchos::RCP<const Thyra::LinearOpBase<double> >  tLinearOp;
   Teuchos::RCP<const Thyra::VectorBase<double> >  tVector;
@@ -500,6 +506,585 @@ namespace panzer {
                                                        globalCont->get_f().getConst());
   }
 
+  //! How buildVolumeSystem assembles, the defaults are one serial fill of the AD physics
+  struct VolumeSystemOptions {
+    bool concurrent = false;           //!< one field manager per host thread
+    int numRepeats = 1;                //!< number of fills
+    bool matrixFree = false;           //!< also build a matrix-free Jacobian
+    bool precomputeOffsets = false;    //!< "Precompute Jacobian Offsets" user data
+    bool overlapGhostExchange = false; //!< overlap the halo exchange with the fill
+    bool linearDiffusion = false;      //!< diffusion from element stiffness matrices
+    bool solutionGatherContainer = false; //!< Jacobian gathers x = gid+1 from a read-only container
+  };
+
+  //! Assembled Jacobian and residual of buildVolumeSystem
+  struct VolumeSystem {
+    Teuchos::RCP<const Thyra::LinearOpBase<double> > op;
+    Teuchos::RCP<const Thyra::VectorBase<double> > f;
+    std::vector<std::vector<std::size_t> > colors;
+    Teuchos::RCP<const panzer::MatrixFreeJacobianOp> matrixFreeOp;
+    Teuchos::RCP<panzer::TpetraVector_ReadOnly_GlobalEvaluationData<double,int,panzer::GlobalOrdinal> > solution;
+    Teuchos::RCP<const panzer::GlobalIndexer> dofManager;
+  };
+
+  //! Volume fill of a two block mesh, serially or with one field manager per host thread
+  VolumeSystem buildVolumeSystem(const VolumeSystemOptions & opts = VolumeSystemOptions())
+  {
+    VolumeSystem system;
+    Teuchos::RCP<Teuchos::Comm<int> > comm = Teuchos::rcp(new Teuchos::MpiComm<int>(Teuchos::opaqueWrapper(MPI_COMM_WORLD)));
+
+    RCP<Teuchos::ParameterList> pl = rcp(new Teuchos::ParameterList);
+    pl->set("X Blocks",2);
+    pl->set("Y Blocks",1);
+    pl->set("X Elements",24);
+    pl->set("Y Elements",16);
+
+    panzer_stk::SquareQuadMeshFactory factory;
+    factory.setParameterList(pl);
+    RCP<panzer_stk::STK_Interface> mesh = factory.buildMesh(MPI_COMM_WORLD);
+
+    Teuchos::RCP<Teuchos::ParameterList> ipb = Teuchos::parameterList("Physics Blocks");
+    testInitialzation(ipb,opts.linearDiffusion);
+
+    const std::size_t workset_size = 8;
+    Teuchos::RCP<user_app::MyFactory> eqset_factory = Teuchos::rcp(new user_app::MyFactory);
+    std::vector<Teuchos::RCP<panzer::PhysicsBlock> > physicsBlocks;
+    {
+      std::map<std::string,std::string> block_ids_to_physics_ids;
+      block_ids_to_physics_ids["eblock-0_0"] = "test physics";
+      block_ids_to_physics_ids["eblock-1_0"] = "test physics";
+
+      std::map<std::string,Teuchos::RCP<const shards::CellTopology> > block_ids_to_cell_topo;
+      block_ids_to_cell_topo["eblock-0_0"] = mesh->getCellTopology("eblock-0_0");
+      block_ids_to_cell_topo["eblock-1_0"] = mesh->getCellTopology("eblock-1_0");
+
+      Teuchos::RCP<panzer::GlobalData> gd = panzer::createGlobalData();
+
+      Teuchos::ParameterList material_models("Material");
+      Teuchos::ParameterList& Cu = material_models.sublist("Cu");
+      const char * props[] = {"Thermal Conductivity","Density","Heat Capacity",
+                              "ION_Thermal Conductivity","ION_Density","ION_Heat Capacity"};
+      for(const char * prop : props) {
+        Teuchos::ParameterList& mp = Cu.sublist(prop);
+        mp.set("Value Type","Constant");
+        mp.sublist("Constant").set<Teuchos::Array<double> >("Value",Teuchos::tuple<double>( 1.0 ));
+      }
+      panzer::createAndRegisterFunctor<double>(material_models,gd->functors);
+
+      panzer::buildPhysicsBlocks(block_ids_to_physics_ids,block_ids_to_cell_topo,ipb,1,workset_size,
+                                 eqset_factory,gd,false,physicsBlocks);
+    }
+
+    Teuchos::RCP<panzer::WorksetContainer> wkstContainer = Teuchos::rcp(new panzer::WorksetContainer);
+    wkstContainer->setFactory(Teuchos::rcp(new panzer_stk::WorksetFactory(mesh)));
+    for(size_t i=0;i<physicsBlocks.size();i++)
+      wkstContainer->setNeeds(physicsBlocks[i]->elementBlockID(),physicsBlocks[i]->getWorksetNeeds());
+    wkstContainer->setWorksetSize(workset_size);
+
+    const Teuchos::RCP<panzer::ConnManager> conn_manager = Teuchos::rcp(new panzer_stk::STKConnManager(mesh));
+    panzer::DOFManagerFactory globalIndexerFactory;
+    RCP<panzer::GlobalIndexer> dofManager
+         = globalIndexerFactory.buildGlobalIndexer(Teuchos::opaqueWrapper(MPI_COMM_WORLD),physicsBlocks,conn_manager);
+
+    Teuchos::RCP<panzer::LinearObjFactory<panzer::Traits> > linObjFactory
+          = Teuchos::rcp(new panzer::TpetraLinearObjFactory<panzer::Traits,double,int,panzer::GlobalOrdinal>(comm,dofManager));
+
+    panzer::ClosureModelFactory_TemplateManager<panzer::Traits> cm_factory;
+    user_app::MyModelFactory_TemplateBuilder cm_builder;
+    cm_factory.buildObjects(cm_builder);
+
+    Teuchos::ParameterList closure_models("Closure Models");
+    closure_models.sublist("solid").sublist("SOURCE_TEMPERATURE").set<double>("Value",1.0);
+    closure_models.sublist("ion solid").sublist("SOURCE_ION_TEMPERATURE").set<double>("Value",1.0);
+
+    Teuchos::ParameterList user_data("User Data");
+    user_data.set("Precompute Jacobian Offsets",opts.precomputeOffsets);
+
+    Teuchos::RCP<panzer::FieldManagerBuilder> fmb = Teuchos::rcp(new panzer::FieldManagerBuilder);
+    fmb->setWorksetContainer(wkstContainer);
+    fmb->setConcurrentVolumeAssembly(opts.concurrent);
+    fmb->setOverlapGhostExchange(opts.overlapGhostExchange);
+    fmb->setupVolumeFieldManagers(physicsBlocks,cm_factory,closure_models,*linObjFactory,user_data);
+
+    panzer::AssemblyEngine_TemplateManager<panzer::Traits> ae_tm;
+    panzer::AssemblyEngine_TemplateBuilder builder(fmb,linObjFactory);
+    ae_tm.buildObjects(builder);
+
+    for(const auto & wd : fmb->getVolumeWorksetDescriptors()) {
+      std::vector<std::vector<std::size_t> > blockColors;
+      panzer::colorWorksets(*dofManager,*wkstContainer->getWorksets(wd),blockColors);
+      system.colors.insert(system.colors.end(),blockColors.begin(),blockColors.end());
+    }
+
+    RCP<panzer::LinearObjContainer> ghosted = linObjFactory->buildGhostedLinearObjContainer();
+    RCP<panzer::LinearObjContainer> global = linObjFactory->buildLinearObjContainer();
+    const int mem = panzer::LinearObjContainer::X | panzer::LinearObjContainer::DxDt |
+                    panzer::LinearObjContainer::F | panzer::LinearObjContainer::Mat;
+    linObjFactory->initializeGhostedContainer(mem,*ghosted);
+    linObjFactory->initializeContainer(mem,*global);
+
+    panzer::AssemblyEngineInArgs input(ghosted,global);
+    input.alpha = 0.0;
+    input.beta = 1.0;
+
+    // the Jacobian gathers read this container instead of the ghosted one
+    if(opts.solutionGatherContainer) {
+      typedef panzer::TpetraVector_ReadOnly_GlobalEvaluationData<double,int,panzer::GlobalOrdinal> ROGED;
+      typedef Tpetra::Vector<double,int,panzer::GlobalOrdinal> VectorType;
+
+      RCP<panzer::TpetraLinearObjContainer<double,int,panzer::GlobalOrdinal> > tGlobal
+         = Teuchos::rcp_dynamic_cast<panzer::TpetraLinearObjContainer<double,int,panzer::GlobalOrdinal> >(global,true);
+      RCP<VectorType> x = Teuchos::rcp(new VectorType(tGlobal->get_x()->getMap()));
+      for(std::size_t i=0;i<x->getLocalLength();i++)
+        x->replaceLocalValue(i,x->getMap()->getGlobalElement(i)+1.0);
+
+      system.solution = Teuchos::rcp_dynamic_cast<ROGED>(linObjFactory->buildReadOnlyDomainContainer(),true);
+      system.solution->setOwnedVector_Tpetra(x);
+      input.addGlobalEvaluationData("Solution Gather Container - X",system.solution);
+    }
+    system.dofManager = dofManager;
+
+    // the import is only overlapped when the gather and volume fill are one call
+    typedef panzer::AssemblyEngine<panzer::Traits::Jacobian>::EvaluationFlags Flags;
+    for(int r=0;r<opts.numRepeats;r++) {
+      ghosted->initialize();
+      global->initialize();
+      ae_tm.getAsObject<panzer::Traits::Residual>()->evaluate(input,Flags(Flags::Initialize | Flags::VolumetricFill));
+      ae_tm.getAsObject<panzer::Traits::Jacobian>()->evaluate(input,Flags(Flags::Initialize | Flags::VolumetricFill));
+      ae_tm.getAsObject<panzer::Traits::Jacobian>()->evaluate(input,Flags(Flags::Scatter));
+    }
+
+    RCP<panzer::TpetraLinearObjContainer<double,int,panzer::GlobalOrdinal> > globalCont
+       = Teuchos::rcp_dynamic_cast<panzer::TpetraLinearObjContainer<double,int,panzer::GlobalOrdinal> >(global);
+
+    Teuchos::RCP<const Tpetra::Operator<double,int,panzer::GlobalOrdinal> > baseOp = globalCont->get_A();
+    Teuchos::RCP<const Thyra::VectorSpaceBase<double> > rangeSpace = Thyra::createVectorSpace<double>(baseOp->getRangeMap());
+    Teuchos::RCP<const Thyra::VectorSpaceBase<double> > domainSpace = Thyra::createVectorSpace<double>(baseOp->getDomainMap());
+
+    system.op = Thyra::constTpetraLinearOp<double,int,panzer::GlobalOrdinal>(rangeSpace, domainSpace, baseOp);
+    system.f = Thyra::constTpetraVector<double,int,panzer::GlobalOrdinal>(Thyra::tpetraVectorSpace<double,int,panzer::GlobalOrdinal>(baseOp->getRangeMap()).getConst(),
+                                                                          globalCont->get_f().getConst());
+
+    // the matrix-free operator only needs the state, it gets containers without F and Mat
+    if(opts.matrixFree) {
+      RCP<panzer::LinearObjContainer> mfGhosted = linObjFactory->buildGhostedLinearObjContainer();
+      RCP<panzer::LinearObjContainer> mfGlobal = linObjFactory->buildLinearObjContainer();
+      const int stateMem = panzer::LinearObjContainer::X | panzer::LinearObjContainer::DxDt;
+      linObjFactory->initializeGhostedContainer(stateMem,*mfGhosted);
+      linObjFactory->initializeContainer(stateMem,*mfGlobal);
+
+      panzer::AssemblyEngineInArgs mfInput(mfGhosted,mfGlobal);
+      mfInput.alpha = input.alpha;
+      mfInput.beta = input.beta;
+      system.matrixFreeOp = Teuchos::rcp(new panzer::MatrixFreeJacobianOp(ae_tm,linObjFactory,mfInput));
+    }
+
+    // check that no two worksets of one color share a DOF
+    for(const auto & wd : fmb->getVolumeWorksetDescriptors()) {
+      const std::vector<panzer::Workset> & worksets = *wkstContainer->getWorksets(wd);
+      std::vector<std::vector<std::size_t> > blockColors;
+      panzer::colorWorksets(*dofManager,worksets,blockColors);
+      for(const auto & color : blockColors) {
+        std::set<panzer::GlobalOrdinal> seen;
+        std::vector<panzer::GlobalOrdinal> gids;
+        for(const auto w : color) {
+          std::set<panzer::GlobalOrdinal> wkstGids;
+          const auto cells = Kokkos::create_mirror_view(worksets[w].getLocalCellIDs());
+          Kokkos::deep_copy(cells,worksets[w].getLocalCellIDs());
+          for(int c=0;c<worksets[w].num_cells;c++) {
+            dofManager->getElementGIDs(cells(c),gids,wd.getElementBlock());
+            wkstGids.insert(gids.begin(),gids.end());
+          }
+          for(const auto gid : wkstGids)
+            TEUCHOS_ASSERT(seen.insert(gid).second);
+        }
+      }
+    }
+
+    // interior and boundary worksets partition each block, and interior worksets
+    // touch no ghosted DOF
+    for(const auto & wd : fmb->getVolumeWorksetDescriptors()) {
+      const std::vector<panzer::Workset> & worksets = *wkstContainer->getWorksets(wd);
+      std::vector<std::size_t> interior, boundary;
+      panzer::classifyWorksets(*dofManager,worksets,interior,boundary);
+      TEUCHOS_ASSERT(interior.size()+boundary.size()==worksets.size());
+
+      std::vector<panzer::GlobalOrdinal> gids;
+      std::vector<bool> isOwned;
+      for(const auto w : interior) {
+        const auto cells = Kokkos::create_mirror_view(worksets[w].getLocalCellIDs());
+        Kokkos::deep_copy(cells,worksets[w].getLocalCellIDs());
+        for(int c=0;c<worksets[w].num_cells;c++) {
+          dofManager->getElementGIDs(cells(c),gids,wd.getElementBlock());
+          dofManager->ownedIndices(gids,isOwned);
+          for(const bool owned : isOwned)
+            TEUCHOS_ASSERT(owned);
+        }
+      }
+    }
+
+    return system;
+  }
+
+  TEUCHOS_UNIT_TEST(assembly_engine, concurrent_volume)
+  {
+    // two fills, so the second one reuses the cached workset coloring
+    VolumeSystemOptions opts;
+    opts.numRepeats = 2;
+    const VolumeSystem serial = buildVolumeSystem(opts);
+
+    opts.concurrent = true;
+    const VolumeSystem concurrent = buildVolumeSystem(opts);
+
+    TEST_ASSERT(concurrent.colors.size()>=2);
+    TEST_EQUALITY(serial.colors.size(),concurrent.colors.size());
+
+    Thyra::LinearOpTester<double> tester;
+    tester.set_all_error_tol(1e-12);
+    tester.num_random_vectors(20);
+    {
+      const bool result = tester.compare( *serial.op, *concurrent.op, Teuchos::ptrFromRef(out) );
+      TEST_ASSERT(result);
+    }
+
+    {
+      const bool result = Thyra::testRelNormDiffErr(
+         "Serial",*serial.f,
+         "Concurrent",*concurrent.f,
+         "linear_properties_error_tol()", 1e-12,
+         "linear_properties_warning_tol()", 1e-12,
+         &out);
+      TEST_ASSERT(result);
+    }
+  }
+
+  TEUCHOS_UNIT_TEST(assembly_engine, precomputed_crs_offsets)
+  {
+    // the first fill resolves the offsets, the second one reuses them
+    VolumeSystemOptions opts;
+    opts.numRepeats = 2;
+    const VolumeSystem search = buildVolumeSystem(opts);
+
+    opts.precomputeOffsets = true;
+    const VolumeSystem offset = buildVolumeSystem(opts);
+
+    Thyra::LinearOpTester<double> tester;
+    tester.set_all_error_tol(1e-12);
+    tester.num_random_vectors(20);
+    {
+      const bool result = tester.compare( *search.op, *offset.op, Teuchos::ptrFromRef(out) );
+      TEST_ASSERT(result);
+    }
+
+    {
+      const bool result = Thyra::testRelNormDiffErr(
+         "Search",*search.f,
+         "Offsets",*offset.f,
+         "linear_properties_error_tol()", 1e-12,
+         "linear_properties_warning_tol()", 1e-12,
+         &out);
+      TEST_ASSERT(result);
+    }
+  }
+
+  TEUCHOS_UNIT_TEST(assembly_engine, overlapped_ghost_exchange)
+  {
+    // two fills, so the second one reuses the cached workset classification
+    VolumeSystemOptions opts;
+    opts.numRepeats = 2;
+    const VolumeSystem sync = buildVolumeSystem(opts);
+
+    opts.overlapGhostExchange = true;
+    const VolumeSystem overlap = buildVolumeSystem(opts);
+
+    Thyra::LinearOpTester<double> tester;
+    tester.set_all_error_tol(1e-12);
+    tester.num_random_vectors(20);
+    {
+      const bool result = tester.compare( *sync.op, *overlap.op, Teuchos::ptrFromRef(out) );
+      TEST_ASSERT(result);
+    }
+
+    {
+      const bool result = Thyra::testRelNormDiffErr(
+         "Synchronous",*sync.f,
+         "Overlapped",*overlap.f,
+         "linear_properties_error_tol()", 1e-12,
+         "linear_properties_warning_tol()", 1e-12,
+         &out);
+      TEST_ASSERT(result);
+    }
+  }
+
+  TEUCHOS_UNIT_TEST(assembly_engine, overlapped_solution_gather)
+  {
+    VolumeSystemOptions opts;
+    opts.numRepeats = 2;
+    opts.solutionGatherContainer = true;
+    const VolumeSystem sync = buildVolumeSystem(opts);
+
+    opts.overlapGhostExchange = true;
+    const VolumeSystem overlap = buildVolumeSystem(opts);
+
+    Thyra::LinearOpTester<double> tester;
+    tester.set_all_error_tol(1e-12);
+    tester.num_random_vectors(20);
+    {
+      const bool result = tester.compare( *sync.op, *overlap.op, Teuchos::ptrFromRef(out) );
+      TEST_ASSERT(result);
+    }
+
+    {
+      const bool result = Thyra::testRelNormDiffErr(
+         "Synchronous",*sync.f,
+         "Overlapped",*overlap.f,
+         "linear_properties_error_tol()", 1e-12,
+         "linear_properties_warning_tol()", 1e-12,
+         &out);
+      TEST_ASSERT(result);
+    }
+
+    // the gathers of cells touching ghosted DOFs read the imported owner values
+    const Teuchos::RCP<const Tpetra::Vector<double,int,panzer::GlobalOrdinal> > x = overlap.solution->getGhostedVector_Tpetra();
+    const auto xView = x->getLocalViewHost(Tpetra::Access::ReadOnly);
+    std::vector<std::string> blockIds;
+    overlap.dofManager->getElementBlockIds(blockIds);
+    std::vector<panzer::GlobalOrdinal> gids;
+    std::vector<bool> isOwned;
+    int numGhostedCells = 0;
+    for(const auto & blockId : blockIds) {
+      for(const auto cell : overlap.dofManager->getElementBlock(blockId)) {
+        overlap.dofManager->getElementGIDs(cell,gids,blockId);
+        overlap.dofManager->ownedIndices(gids,isOwned);
+        if(std::find(isOwned.begin(),isOwned.end(),false)==isOwned.end())
+          continue;
+
+        numGhostedCells++;
+        for(const auto gid : gids) {
+          const int lid = x->getMap()->getLocalElement(gid);
+          TEST_ASSERT(lid>=0);
+          TEST_EQUALITY(xView(lid,0),gid+1.0);
+        }
+      }
+    }
+    if(overlap.dofManager->getComm()->getSize()>1)
+      TEST_ASSERT(numGhostedCells>0);
+  }
+
+  TEUCHOS_UNIT_TEST(assembly_engine, linear_element_matrices)
+  {
+    VolumeSystemOptions opts;
+    opts.numRepeats = 2;
+    const VolumeSystem ad = buildVolumeSystem(opts);
+
+    // the diffusion term is summed from element stiffness matrices, with both scatter paths
+    opts.linearDiffusion = true;
+    const VolumeSystem linear = buildVolumeSystem(opts);
+
+    Thyra::LinearOpTester<double> tester;
+    tester.set_all_error_tol(1e-12);
+    tester.num_random_vectors(20);
+    {
+      const bool result = tester.compare( *ad.op, *linear.op, Teuchos::ptrFromRef(out) );
+      TEST_ASSERT(result);
+    }
+
+    {
+      const bool result = Thyra::testRelNormDiffErr(
+         "AD",*ad.f,
+         "Linear",*linear.f,
+         "linear_properties_error_tol()", 1e-12,
+         "linear_properties_warning_tol()", 1e-12,
+         &out);
+      TEST_ASSERT(result);
+    }
+
+    opts.numRepeats = 1;
+    opts.precomputeOffsets = true;
+    const VolumeSystem offset = buildVolumeSystem(opts);
+    {
+      const bool result = tester.compare( *ad.op, *offset.op, Teuchos::ptrFromRef(out) );
+      TEST_ASSERT(result);
+    }
+  }
+
+  TEUCHOS_UNIT_TEST(assembly_engine, matrix_free_jacobian)
+  {
+    typedef Tpetra::CrsMatrix<double,int,panzer::GlobalOrdinal> CrsMatrixType;
+    typedef Tpetra::Vector<double,int,panzer::GlobalOrdinal> VectorType;
+
+    VolumeSystemOptions opts;
+    opts.matrixFree = true;
+    const VolumeSystem system = buildVolumeSystem(opts);
+    const Teuchos::RCP<const Thyra::LinearOpBase<double> > assembledOp = system.op;
+    const Teuchos::RCP<const panzer::MatrixFreeJacobianOp> matrixFreeOp = system.matrixFreeOp;
+
+    Thyra::LinearOpTester<double> tester;
+    tester.set_all_error_tol(1e-12);
+    tester.num_random_vectors(20);
+    {
+      const bool result = tester.compare( *assembledOp, *matrixFreeOp, Teuchos::ptrFromRef(out) );
+      TEST_ASSERT(result);
+    }
+
+    // the Jacobi diagonal agrees with the diagonal of the assembled matrix
+    {
+      Teuchos::RCP<const CrsMatrixType> A = Teuchos::rcp_dynamic_cast<const CrsMatrixType>(
+         Thyra::TpetraOperatorVectorExtraction<double,int,panzer::GlobalOrdinal>::getConstTpetraOperator(assembledOp),true);
+      Teuchos::RCP<VectorType> diag = Teuchos::rcp(new VectorType(A->getRowMap()));
+      A->getLocalDiagCopy(*diag);
+
+      const bool result = Thyra::testRelNormDiffErr(
+         "Assembled",*Thyra::constTpetraVector<double,int,panzer::GlobalOrdinal>(Thyra::tpetraVectorSpace<double,int,panzer::GlobalOrdinal>(A->getRowMap()).getConst(),diag.getConst()),
+         "Matrix-free",*matrixFreeOp->getDiagonal(),
+         "linear_properties_error_tol()", 1e-12,
+         "linear_properties_warning_tol()", 1e-12,
+         &out);
+      TEST_ASSERT(result);
+    }
+
+    // the row sums agree with the assembled matrix applied to ones
+    {
+      Teuchos::RCP<Thyra::VectorBase<double> > ones = Thyra::createMember(*assembledOp->domain());
+      Thyra::assign(ones.ptr(),1.0);
+      Teuchos::RCP<Thyra::VectorBase<double> > sums = Thyra::createMember(*assembledOp->range());
+      Thyra::apply(*assembledOp,Thyra::NOTRANS,*ones,sums.ptr());
+
+      const bool result = Thyra::testRelNormDiffErr(
+         "Assembled",*sums,
+         "Matrix-free",*matrixFreeOp->getRowSums(),
+         "linear_properties_error_tol()", 1e-12,
+         "linear_properties_warning_tol()", 1e-12,
+         &out);
+      TEST_ASSERT(result);
+    }
+
+    // continuous basis dofs are shared between elements, so there is no element block inverse
+    TEST_THROW(matrixFreeOp->buildElementBlockInverse(),std::logic_error);
+  }
+
+  //! Jacobian volume fill of one energy equation on a hexahedral mesh, returns the derivative dimension
+  int buildHexJacobian(int basisOrder)
+  {
+    Teuchos::RCP<Teuchos::Comm<int> > comm = Teuchos::rcp(new Teuchos::MpiComm<int>(Teuchos::opaqueWrapper(MPI_COMM_WORLD)));
+
+    RCP<Teuchos::ParameterList> pl = rcp(new Teuchos::ParameterList);
+    pl->set("X Blocks",1);
+    pl->set("Y Blocks",1);
+    pl->set("Z Blocks",1);
+    pl->set("X Elements",2);
+    pl->set("Y Elements",2);
+    pl->set("Z Elements",2);
+
+    panzer_stk::CubeHexMeshFactory factory;
+    factory.setParameterList(pl);
+    RCP<panzer_stk::STK_Interface> mesh = factory.buildMesh(MPI_COMM_WORLD);
+
+    Teuchos::RCP<Teuchos::ParameterList> ipb = Teuchos::parameterList("Physics Blocks");
+    {
+      Teuchos::ParameterList& physics_block = ipb->sublist("test physics");
+      physics_block.set("Material","Cu");
+      Teuchos::ParameterList& p = physics_block.sublist("a");
+      p.set("Type","Energy");
+      p.set("Prefix","");
+      p.set("Model ID","solid");
+      p.set("Basis Type","HGrad");
+      p.set("Basis Order",basisOrder);
+    }
+
+    const std::size_t workset_size = 64;
+    Teuchos::RCP<user_app::MyFactory> eqset_factory = Teuchos::rcp(new user_app::MyFactory);
+    std::vector<Teuchos::RCP<panzer::PhysicsBlock> > physicsBlocks;
+    {
+      std::map<std::string,std::string> block_ids_to_physics_ids;
+      block_ids_to_physics_ids["eblock-0_0_0"] = "test physics";
+
+      std::map<std::string,Teuchos::RCP<const shards::CellTopology> > block_ids_to_cell_topo;
+      block_ids_to_cell_topo["eblock-0_0_0"] = mesh->getCellTopology("eblock-0_0_0");
+
+      Teuchos::RCP<panzer::GlobalData> gd = panzer::createGlobalData();
+
+      Teuchos::ParameterList material_models("Material");
+      Teuchos::ParameterList& Cu = material_models.sublist("Cu");
+      const char * props[] = {"Thermal Conductivity","Density","Heat Capacity"};
+      for(const char * prop : props) {
+        Teuchos::ParameterList& mp = Cu.sublist(prop);
+        mp.set("Value Type","Constant");
+        mp.sublist("Constant").set<Teuchos::Array<double> >("Value",Teuchos::tuple<double>( 1.0 ));
+      }
+      panzer::createAndRegisterFunctor<double>(material_models,gd->functors);
+
+      panzer::buildPhysicsBlocks(block_ids_to_physics_ids,block_ids_to_cell_topo,ipb,2*basisOrder,workset_size,
+                                 eqset_factory,gd,false,physicsBlocks);
+    }
+
+    Teuchos::RCP<panzer::WorksetContainer> wkstContainer = Teuchos::rcp(new panzer::WorksetContainer);
+    wkstContainer->setFactory(Teuchos::rcp(new panzer_stk::WorksetFactory(mesh)));
+    for(size_t i=0;i<physicsBlocks.size();i++)
+      wkstContainer->setNeeds(physicsBlocks[i]->elementBlockID(),physicsBlocks[i]->getWorksetNeeds());
+    wkstContainer->setWorksetSize(workset_size);
+
+    const Teuchos::RCP<panzer::ConnManager> conn_manager = Teuchos::rcp(new panzer_stk::STKConnManager(mesh));
+    panzer::DOFManagerFactory globalIndexerFactory;
+    RCP<panzer::GlobalIndexer> dofManager
+         = globalIndexerFactory.buildGlobalIndexer(Teuchos::opaqueWrapper(MPI_COMM_WORLD),physicsBlocks,conn_manager);
+    const int derivativeDimension = dofManager->getElementBlockGIDCount("eblock-0_0_0");
+
+    Teuchos::RCP<panzer::LinearObjFactory<panzer::Traits> > linObjFactory
+          = Teuchos::rcp(new panzer::TpetraLinearObjFactory<panzer::Traits,double,int,panzer::GlobalOrdinal>(comm,dofManager));
+
+    panzer::ClosureModelFactory_TemplateManager<panzer::Traits> cm_factory;
+    user_app::MyModelFactory_TemplateBuilder cm_builder;
+    cm_factory.buildObjects(cm_builder);
+
+    Teuchos::ParameterList closure_models("Closure Models");
+    closure_models.sublist("solid").sublist("SOURCE_TEMPERATURE").set<double>("Value",1.0);
+
+    Teuchos::ParameterList user_data("User Data");
+
+    Teuchos::RCP<panzer::FieldManagerBuilder> fmb = Teuchos::rcp(new panzer::FieldManagerBuilder);
+    fmb->setWorksetContainer(wkstContainer);
+    fmb->setupVolumeFieldManagers(physicsBlocks,cm_factory,closure_models,*linObjFactory,user_data);
+
+    panzer::AssemblyEngine_TemplateManager<panzer::Traits> ae_tm;
+    panzer::AssemblyEngine_TemplateBuilder builder(fmb,linObjFactory);
+    ae_tm.buildObjects(builder);
+
+    RCP<panzer::LinearObjContainer> ghosted = linObjFactory->buildGhostedLinearObjContainer();
+    RCP<panzer::LinearObjContainer> global = linObjFactory->buildLinearObjContainer();
+    const int mem = panzer::LinearObjContainer::X | panzer::LinearObjContainer::DxDt |
+                    panzer::LinearObjContainer::F | panzer::LinearObjContainer::Mat;
+    linObjFactory->initializeGhostedContainer(mem,*ghosted);
+    linObjFactory->initializeContainer(mem,*global);
+
+    panzer::AssemblyEngineInArgs input(ghosted,global);
+    input.alpha = 0.0;
+    input.beta = 1.0;
+
+    ghosted->initialize();
+    global->initialize();
+    ae_tm.getAsObject<panzer::Traits::Jacobian>()->evaluate(input);
+
+    return derivativeDimension;
+  }
+
+  TEUCHOS_UNIT_TEST(assembly_engine, jacobian_fad_capacity)
+  {
+    typedef panzer::FadStaticCapacity<panzer::Traits::FadType> Capacity;
+
+    // first order elements have the derivative dimension of hex8, second
+    // order ones that of hex27
+    for(int basisOrder=1;basisOrder<=2;basisOrder++) {
+      const int expectedDimension = basisOrder==1 ? 8 : 27;
+      if(Capacity::value>0 && (Capacity::fixed ? Capacity::value!=expectedDimension : Capacity::value<expectedDimension)) {
+        out << "Skipping hex order " << basisOrder << ", FadType cannot hold " << expectedDimension << " derivatives" << std::endl;
+        continue;
+      }
+
+      TEST_EQUALITY(buildHexJacobian(basisOrder),expectedDimension);
+    }
+  }
+
   TEUCHOS_UNIT_TEST(assembly_engine, z_basic_epetra_vtpetra)
   {
 
@@ -540,7 +1125,7 @@ namespace panzer {
 
   }
 
-  void testInitialzation(const Teuchos::RCP<Teuchos::ParameterList>& ipb)
+  void testInitialzation(const Teuchos::RCP<Teuchos::ParameterList>& ipb,bool linearDiffusion)
   {
     // Physics block
     Teuchos::ParameterList& physics_block = ipb->sublist("test physics");
@@ -552,6 +1137,8 @@ namespace panzer {
       p.set("Model ID","solid");
       p.set("Basis Type","HGrad");
       p.set("Basis Order",2);
+      if(linearDiffusion)
+        p.set("Linear Diffusion","ON");
     }
     {
       Teuchos::ParameterList& p = physics_block.sublist("b");
@@ -560,6 +1147,8 @@ namespace panzer {
       p.set("Model ID","ion solid");
       p.set("Basis Type","HGrad");
       p.set("Basis Order",1);
+      if(linearDiffusion)
+        p.set("Linear Diffusion","ON");
     }
 
     // BCs
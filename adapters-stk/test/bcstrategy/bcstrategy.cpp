@@ -65,12 +65,14 @@
 #include "Panzer_ParameterLibraryUtilities.hpp"
 
 #include "user_app_EquationSetFactory.hpp"
+#include "user_app_FiveWorksetFunctor.hpp"
 #include "user_app_ClosureModel_Factory_TemplateBuilder.hpp"
 #include "Tpetra_Core.hpp"
 
 namespace panzer {
 
-  TEUCHOS_UNIT_TEST(bcstrategy, constant_Dirichlet_strategy)
+  // fixes the bottom nodes of a single element to 5.0 with the given value type
+  void testDirichletStrategy(const std::string & valueType,Teuchos::FancyOStream & out,bool & success)
   {
 
     using lids_type = typename Tpetra::CrsMatrix<double, int, panzer::GlobalOrdinal,panzer::TpetraNodeType>::nonconst_local_inds_host_view_type;
@@ -106,7 +108,7 @@ namespace panzer {
 	Teuchos::ParameterList pl_dirichlet("Dirichlet BC");
 	{
       pl_dirichlet.set("NodeSet Name","bottom");
-	  pl_dirichlet.set("Value Type","Constant");
+	  pl_dirichlet.set("Value Type",valueType);
       pl_dirichlet.set<Teuchos::Array<std::string> >("DOF Names",Teuchos::tuple<std::string>( "TEMPERATURE" ));
 	  Teuchos::ParameterList pl_sub("Constant");
 	  pl_sub.set("Value",5.0);
@@ -298,4 +300,14 @@ namespace panzer {
 
   }
 
+  TEUCHOS_UNIT_TEST(bcstrategy, constant_Dirichlet_strategy)
+  {
+    testDirichletStrategy("Constant",out,success);
+  }
+
+  TEUCHOS_UNIT_TEST(bcstrategy, functor_Dirichlet_strategy)
+  {
+    testDirichletStrategy("FiveWorksetFunctor",out,success);
+  }
+
 }
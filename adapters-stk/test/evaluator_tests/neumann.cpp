@@ -58,11 +58,13 @@
 #include "Panzer_ParameterLibraryUtilities.hpp"
 
 #include "user_app_EquationSetFactory.hpp"
+#include "user_app_FiveWorksetFunctor.hpp"
 #include "Tpetra_Core.hpp"
 
 namespace panzer {
 
-  TEUCHOS_UNIT_TEST(bcstrategy, constant_Neumman_evaluator)
+  // flux of 5.0 on the left side of a 2x1 mesh with the given value type
+  void testNeumannEvaluator(const std::string & valueType,Teuchos::FancyOStream & out,bool & success)
   {
     using Teuchos::RCP;
 
@@ -171,7 +173,7 @@ namespace panzer {
 	  pl_neumann.set<std::string>("Type","Flux");
 	  pl_neumann.set("Element Block Name","eblock-0_0");
       pl_neumann.set("SideSet Name","left");
-	  pl_neumann.set("Value Type","Constant");
+	  pl_neumann.set("Value Type",valueType);
       pl_neumann.set<std::string>("DOF Name","TEMPERATURE");
 	  pl_neumann.set<std::string>("Residual Name","Residual");
 	  Teuchos::ParameterList pl_sub("Constant");
@@ -248,4 +250,14 @@ namespace panzer {
 	TEST_FLOATING_EQUALITY(Sacado::scalarValue(res_h(0,3)),2.5,1e-15);
   }
 
+  TEUCHOS_UNIT_TEST(bcstrategy, constant_Neumman_evaluator)
+  {
+    testNeumannEvaluator("Constant",out,success);
+  }
+
+  TEUCHOS_UNIT_TEST(bcstrategy, functor_Neumman_evaluator)
+  {
+    testNeumannEvaluator("FiveWorksetFunctor",out,success);
+  }
+
 }
@@ -59,6 +59,7 @@ using Teuchos::rcp;
 #include "Panzer_Workset.hpp"
 #include "Panzer_GatherOrientation.hpp"
 #include "Panzer_ScatterResidual_BlockedTpetra.hpp"
+#include "Panzer_ElementCrsOffsets.hpp"
 #include "Panzer_GatherSolution_BlockedTpetra.hpp"
 #include "Panzer_GlobalEvaluationDataContainer.hpp"
 
@@ -74,6 +75,8 @@ using Teuchos::rcp;
 #include "Thyra_VectorStdOps.hpp"
 #include "Thyra_ProductVectorBase.hpp"
 #include "Thyra_SpmdVectorBase.hpp"
+#include "Thyra_BlockedLinearOpBase.hpp"
+#include "Thyra_TpetraLinearOp.hpp"
 
 #include "user_app_EquationSetFactory.hpp"
 
@@ -525,6 +528,201 @@ namespace panzer
       }
    }
 
+   //! Blocked Jacobian of a U,V (Q1) and B (QEdge1) system
+   void assembleBlockedJacobian(bool precomputeOffsets, int numRepeats, Teuchos::RCP<TpetraBlockedLinObjContainerType> &b_loc)
+   {
+      Teuchos::RCP<Teuchos::MpiComm<int>> tComm = Teuchos::rcp(new Teuchos::MpiComm<int>(MPI_COMM_WORLD));
+
+      const std::size_t workset_size = 32;
+      const std::string fieldName1_q1 = "U";
+      const std::string fieldName2_q1 = "V";
+      const std::string fieldName_qedge1 = "B";
+
+      Teuchos::RCP<panzer_stk::STK_Interface> mesh = buildMesh(16, 16);
+
+      Teuchos::RCP<panzer::PureBasis> basis_q1 = buildBasis(workset_size, "Q1");
+      Teuchos::RCP<panzer::PureBasis> basis_qedge1 = buildBasis(workset_size, "QEdge1");
+
+      Teuchos::RCP<Teuchos::ParameterList> ipb = Teuchos::parameterList();
+      testInitialization(ipb);
+
+      const int default_int_order = 1;
+      std::string eBlockID = "eblock-0_0";
+      Teuchos::RCP<user_app::MyFactory> eqset_factory = Teuchos::rcp(new user_app::MyFactory);
+      panzer::CellData cellData(workset_size, mesh->getCellTopology("eblock-0_0"));
+      Teuchos::RCP<panzer::GlobalData> gd = panzer::createGlobalData();
+      Teuchos::RCP<panzer::PhysicsBlock> physicsBlock =
+          Teuchos::rcp(new PhysicsBlock(ipb, eBlockID, default_int_order, cellData, eqset_factory, gd, false));
+
+      Teuchos::RCP<std::vector<panzer::Workset>> work_sets = panzer_stk::buildWorksets(*mesh, physicsBlock->elementBlockID(),
+                                                                                       physicsBlock->getWorksetNeeds());
+      // one build, so the offset tables are resolved once and then reused
+      for (std::size_t w = 0; w < work_sets->size(); ++w)
+      {
+         (*work_sets)[w].setIdentifier(w);
+         (*work_sets)[w].setVersion(1);
+      }
+
+      const Teuchos::RCP<panzer::ConnManager> conn_manager = Teuchos::rcp(new panzer_stk::STKConnManager(mesh));
+      RCP<panzer::BlockedDOFManager> dofManager = Teuchos::rcp(new panzer::BlockedDOFManager(conn_manager, MPI_COMM_WORLD));
+
+      dofManager->addField(fieldName1_q1, Teuchos::rcp(new panzer::Intrepid2FieldPattern(basis_q1->getIntrepid2Basis())));
+      dofManager->addField(fieldName2_q1, Teuchos::rcp(new panzer::Intrepid2FieldPattern(basis_q1->getIntrepid2Basis())));
+      dofManager->addField(fieldName_qedge1, Teuchos::rcp(new panzer::Intrepid2FieldPattern(basis_qedge1->getIntrepid2Basis())));
+
+      std::vector<std::vector<std::string>> fieldOrder(3);
+      fieldOrder[0].push_back(fieldName1_q1);
+      fieldOrder[1].push_back(fieldName_qedge1);
+      fieldOrder[2].push_back(fieldName2_q1);
+      dofManager->setFieldOrder(fieldOrder);
+      dofManager->buildGlobalUnknowns();
+
+      Teuchos::RCP<TpetraBlockedLinObjFactoryType> bt_lof = Teuchos::rcp(new TpetraBlockedLinObjFactoryType(tComm.getConst(), dofManager));
+      Teuchos::RCP<LinearObjFactory<panzer::Traits>> lof = bt_lof;
+      Teuchos::RCP<LinearObjContainer> loc = bt_lof->buildGhostedLinearObjContainer();
+      bt_lof->initializeGhostedContainer(LinearObjContainer::X | LinearObjContainer::F | LinearObjContainer::Mat, *loc);
+      loc->initialize();
+
+      b_loc = Teuchos::rcp_dynamic_cast<TpetraBlockedLinObjContainerType>(loc);
+
+      // a solution that varies from dof to dof
+      Teuchos::RCP<Thyra::ProductVectorBase<double>> p_vec = Teuchos::rcp_dynamic_cast<Thyra::ProductVectorBase<double>>(b_loc->get_x());
+      Thyra::seed_randomize<double>(12345);
+      for (int blk = 0; blk < 3; ++blk)
+         Thyra::randomize(-1.0, 1.0, p_vec->getNonconstVectorBlock(blk).ptr());
+
+      PHX::FieldManager<panzer::Traits> fm;
+
+      Teuchos::RCP<std::map<std::string, std::string>> names_map =
+          Teuchos::rcp(new std::map<std::string, std::string>);
+      names_map->insert(std::make_pair(fieldName1_q1, fieldName1_q1));
+      names_map->insert(std::make_pair(fieldName2_q1, fieldName2_q1));
+      names_map->insert(std::make_pair(fieldName_qedge1, fieldName_qedge1));
+
+      const std::pair<Teuchos::RCP<panzer::PureBasis>, std::vector<std::string>> fields[2] =
+          {{basis_q1, {fieldName1_q1, fieldName2_q1}}, {basis_qedge1, {fieldName_qedge1}}};
+      for (const auto &field : fields)
+      {
+         RCP<std::vector<std::string>> names = rcp(new std::vector<std::string>(field.second));
+
+         // scatter the gathered solution itself, its derivatives fill the diagonal blocks
+         Teuchos::ParameterList scatterPl;
+         scatterPl.set("Scatter Name", "Scatter" + field.second[0]);
+         scatterPl.set("Basis", field.first.getConst());
+         scatterPl.set("Dependent Names", names);
+         scatterPl.set("Dependent Map", names_map);
+         scatterPl.set("Precompute Jacobian Offsets", precomputeOffsets);
+
+         Teuchos::RCP<PHX::Evaluator<panzer::Traits>> scatter = lof->buildScatter<panzer::Traits::Jacobian>(scatterPl);
+         fm.registerEvaluator<panzer::Traits::Jacobian>(scatter);
+         fm.requireField<panzer::Traits::Jacobian>(*scatter->evaluatedFields()[0]);
+
+         Teuchos::ParameterList gatherPl;
+         gatherPl.set("Basis", field.first);
+         gatherPl.set("DOF Names", names);
+         gatherPl.set("Indexer Names", names);
+
+         fm.registerEvaluator<panzer::Traits::Jacobian>(lof->buildGather<panzer::Traits::Jacobian>(gatherPl));
+      }
+
+      std::vector<PHX::index_size_type> derivative_dimensions;
+      derivative_dimensions.push_back(12);
+      fm.setKokkosExtendedDataTypeDimensions<panzer::Traits::Jacobian>(derivative_dimensions);
+
+      panzer::Traits::SD sd;
+      sd.worksets_ = work_sets;
+      fm.postRegistrationSetup(sd);
+
+      panzer::Traits::PED ped;
+      ped.gedc->addDataObject("Solution Gather Container", loc);
+      ped.gedc->addDataObject("Residual Scatter Container", loc);
+
+      for (int r = 0; r < numRepeats; ++r)
+      {
+         loc->initialize();
+         fm.preEvaluate<panzer::Traits::Jacobian>(ped);
+
+         for (panzer::Workset &workset : *work_sets)
+         {
+            workset.alpha = 0.0;
+            workset.beta = 2.0;
+            workset.time = 0.0;
+            workset.evaluate_transient_terms = false;
+            fm.evaluateFields<panzer::Traits::Jacobian>(workset);
+         }
+         Kokkos::fence();
+      }
+   }
+
+   TEUCHOS_UNIT_TEST(block_assembly, scatter_jacobian_precomputed_offsets)
+   {
+      typedef Tpetra::CrsMatrix<double, panzer::LocalOrdinal, panzer::GlobalOrdinal> CrsMatrixType;
+
+      // the first fill resolves the offsets, the second one reuses them
+      const int numRepeats = 2;
+
+      Teuchos::RCP<TpetraBlockedLinObjContainerType> searchLoc, offsetLoc;
+      assembleBlockedJacobian(false, numRepeats, searchLoc);
+      assembleBlockedJacobian(true, numRepeats, offsetLoc);
+
+      const Teuchos::RCP<const Thyra::BlockedLinearOpBase<double>> searchA =
+          Teuchos::rcp_dynamic_cast<const Thyra::BlockedLinearOpBase<double>>(searchLoc->get_A(), true);
+      const Teuchos::RCP<const Thyra::BlockedLinearOpBase<double>> offsetA =
+          Teuchos::rcp_dynamic_cast<const Thyra::BlockedLinearOpBase<double>>(offsetLoc->get_A(), true);
+
+      int numCompared = 0;
+      for (int row = 0; row < 3; ++row)
+      {
+         for (int col = 0; col < 3; ++col)
+         {
+            const auto searchBlock = Teuchos::rcp_dynamic_cast<const Thyra::TpetraLinearOp<double, panzer::LocalOrdinal, panzer::GlobalOrdinal>>(searchA->getBlock(row, col));
+            const auto offsetBlock = Teuchos::rcp_dynamic_cast<const Thyra::TpetraLinearOp<double, panzer::LocalOrdinal, panzer::GlobalOrdinal>>(offsetA->getBlock(row, col));
+            TEST_EQUALITY(searchBlock == Teuchos::null, offsetBlock == Teuchos::null);
+            if (searchBlock == Teuchos::null || offsetBlock == Teuchos::null)
+               continue;
+
+            const auto searchMat = Teuchos::rcp_dynamic_cast<const CrsMatrixType>(searchBlock->getConstTpetraOperator(), true);
+            const auto offsetMat = Teuchos::rcp_dynamic_cast<const CrsMatrixType>(offsetBlock->getConstTpetraOperator(), true);
+
+            // both factories build identical graphs, so the value arrays line up
+            const auto searchValues = searchMat->getLocalMatrixHost().values;
+            const auto offsetValues = offsetMat->getLocalMatrixHost().values;
+            TEST_EQUALITY(searchValues.extent(0), offsetValues.extent(0));
+            for (std::size_t k = 0; k < std::min(searchValues.extent(0), offsetValues.extent(0)); ++k)
+               TEST_FLOATING_EQUALITY(searchValues(k) + 1.0, offsetValues(k) + 1.0, 1e-12);
+            ++numCompared;
+         }
+      }
+      TEST_ASSERT(numCompared > 0);
+   }
+
+   TEUCHOS_UNIT_TEST(block_assembly, crs_offsets_versions)
+   {
+      ElementCrsOffsets offsets;
+      ElementCrsOffsets::OffsetView table;
+      const int graph = 0;
+      const std::vector<const void *> graphs = {&graph};
+
+      // resolved once per workset and build
+      TEST_ASSERT(!offsets.lookup(0, 1, 4, graphs, 3, 3, table));
+      TEST_ASSERT(offsets.lookup(0, 1, 4, graphs, 3, 3, table));
+      TEST_ASSERT(!offsets.lookup(1, 1, 4, graphs, 3, 3, table));
+      TEST_EQUALITY(offsets.size(), 2);
+
+      // a rebuild with the same identifiers is resolved again, the stale tables are dropped
+      TEST_ASSERT(!offsets.lookup(0, 2, 4, graphs, 3, 3, table));
+      TEST_EQUALITY(offsets.size(), 1);
+      TEST_ASSERT(offsets.lookup(0, 2, 4, graphs, 3, 3, table));
+
+      // other graphs invalidate all tables
+      const int otherGraph = 0;
+      TEST_ASSERT(!offsets.lookup(0, 2, 4, {&otherGraph}, 3, 3, table));
+
+      // worksets not built by a container are never trusted
+      TEST_ASSERT(!offsets.lookup(0, 0, 4, graphs, 3, 3, table));
+      TEST_ASSERT(!offsets.lookup(0, 0, 4, graphs, 3, 3, table));
+   }
+
    Teuchos::RCP<panzer::PureBasis> buildBasis(std::size_t worksetSize, const std::string &basisName)
    {
       Teuchos::RCP<shards::CellTopology> topo =
@@ -71,6 +71,9 @@ using Teuchos::rcp;
 #include "Panzer_WorksetContainer.hpp"
 #include "Panzer_PauseToAttach.hpp"
 #include "Panzer_ExplicitModelEvaluator.hpp"
+#include "Panzer_ThyraObjContainer.hpp"
+
+#include "Thyra_TestingTools.hpp"
 
 #include "Stratimikos_DefaultLinearSolverBuilder.hpp"
 
@@ -95,7 +98,8 @@ namespace panzer {
                            Teuchos::RCP<panzer::FieldManagerBuilder> & fmb,
                            Teuchos::RCP<panzer::ResponseLibrary<panzer::Traits> > & rLibrary,
                            Teuchos::RCP<panzer::GlobalData> & gd,
-                           Teuchos::RCP<panzer::LinearObjFactory<panzer::Traits> > & lof);
+                           Teuchos::RCP<panzer::LinearObjFactory<panzer::Traits> > & lof,
+                           bool useTpetra=false);
 
   TEUCHOS_UNIT_TEST(explicit_model_evaluator, basic)
   {
@@ -213,6 +217,91 @@ namespace panzer {
     }
   }
 
+  TEUCHOS_UNIT_TEST(explicit_model_evaluator, element_local_lumped_mass)
+  {
+    using Teuchos::RCP;
+    typedef Thyra::ModelEvaluatorBase::InArgs<double> InArgs;
+    typedef Thyra::ModelEvaluatorBase::OutArgs<double> OutArgs;
+    typedef Thyra::VectorBase<double> VectorType;
+    typedef panzer::ModelEvaluator<double> PME;
+    typedef panzer::ExplicitModelEvaluator<double> ExpPME;
+
+    Teuchos::RCP<panzer::FieldManagerBuilder> fmb;
+    Teuchos::RCP<panzer::ResponseLibrary<panzer::Traits> > rLibrary;
+    Teuchos::RCP<panzer::LinearObjFactory<panzer::Traits> > lof;
+    Teuchos::RCP<panzer::GlobalData> gd;
+
+    buildAssemblyPieces(true,fmb,rLibrary,gd,lof,true);
+
+    std::vector<Teuchos::RCP<Teuchos::Array<std::string> > > p_names;
+    std::vector<Teuchos::RCP<Teuchos::Array<double> > > p_values;
+    RCP<PME> me = Teuchos::rcp(new PME(fmb,rLibrary,lof,p_names,p_values,Teuchos::null,gd,true,0.0));
+
+    RCP<VectorType> x = Thyra::createMember(*me->get_x_space());
+    RCP<VectorType> x_dot = Thyra::createMember(*me->get_x_space());
+    Thyra::assign(x_dot.ptr(),0.0);
+    Thyra::assign(x.ptr(),5.0);
+
+    // element local lumped mass
+    RCP<VectorType> local_f = Thyra::createMember(*me->get_f_space());
+    {
+      RCP<ExpPME> exp_me = Teuchos::rcp(new ExpPME(me,true,true,true,false,true));
+
+      InArgs in_args = exp_me->createInArgs();
+      in_args.set_x(x);
+      in_args.set_x_dot(x_dot);
+
+      OutArgs out_args = exp_me->createOutArgs();
+      out_args.set_f(local_f);
+
+      exp_me->evalModel(in_args, out_args);
+    }
+
+    // neither the residual nor the element mass matrices allocate the ghosted matrix
+    RCP<panzer::ThyraObjContainer<double> > ghosted
+        = Teuchos::rcp_dynamic_cast<panzer::ThyraObjContainer<double> >(me->getGhostedContainer(),true);
+    TEST_ASSERT(ghosted->get_A_th()==Teuchos::null);
+
+    // lumped mass from the assembled mass matrix, on the same model
+    RCP<VectorType> assembled_f = Thyra::createMember(*me->get_f_space());
+    {
+      RCP<ExpPME> exp_me = Teuchos::rcp(new ExpPME(me,true,true));
+
+      InArgs in_args = exp_me->createInArgs();
+      in_args.set_x(x);
+      in_args.set_x_dot(x_dot);
+
+      OutArgs out_args = exp_me->createOutArgs();
+      out_args.set_f(assembled_f);
+
+      exp_me->evalModel(in_args, out_args);
+    }
+
+    // x_dot=0, so both are the residual scaled by the inverse row sums of the mass matrix
+    TEST_ASSERT(Thyra::norm_2(*assembled_f)>0.0);
+    const bool result = Thyra::testRelNormDiffErr(
+       "Assembled lumped",*assembled_f,
+       "Element local lumped",*local_f,
+       "linear_properties_error_tol()", 1e-12,
+       "linear_properties_warning_tol()", 1e-12,
+       &out);
+    TEST_ASSERT(result);
+
+    // the HGrad dofs are shared between elements, so there is no element block inverse to compare
+    {
+      RCP<ExpPME> exp_me = Teuchos::rcp(new ExpPME(me,true,false,true,true,false));
+
+      InArgs in_args = exp_me->createInArgs();
+      in_args.set_x(x);
+      in_args.set_x_dot(x_dot);
+
+      OutArgs out_args = exp_me->createOutArgs();
+      out_args.set_f(Thyra::createMember(*me->get_f_space()));
+
+      TEST_THROW(exp_me->evalModel(in_args, out_args),std::logic_error);
+    }
+  }
+
   void testInitialzation(const Teuchos::RCP<Teuchos::ParameterList>& ipb,
 			 std::vector<panzer::BC>& bcs)
   {
@@ -286,7 +375,8 @@ namespace panzer {
                            Teuchos::RCP<panzer::FieldManagerBuilder> & fmb,
                            Teuchos::RCP<panzer::ResponseLibrary<panzer::Traits> > & rLibrary,
                            Teuchos::RCP<panzer::GlobalData> & gd,
-                           Teuchos::RCP<panzer::LinearObjFactory<panzer::Traits> > & lof
+                           Teuchos::RCP<panzer::LinearObjFactory<panzer::Traits> > & lof,
+                           bool useTpetra
                            )
   {
     using Teuchos::RCP;
@@ -362,8 +452,11 @@ namespace panzer {
     RCP<panzer::GlobalIndexer> dofManager
          = globalIndexerFactory.buildGlobalIndexer(Teuchos::opaqueWrapper(MPI_COMM_WORLD),physicsBlocks,conn_manager);
 
-    Teuchos::RCP<panzer::LinearObjFactory<panzer::Traits> > linObjFactory
-        = Teuchos::rcp(new panzer::BlockedEpetraLinearObjFactory<panzer::Traits,int>(mpiComm,dofManager,false));
+    Teuchos::RCP<panzer::LinearObjFactory<panzer::Traits> > linObjFactory;
+    if(useTpetra)
+      linObjFactory = Teuchos::rcp(new panzer::TpetraLinearObjFactory<panzer::Traits,double,panzer::LocalOrdinal,panzer::GlobalOrdinal>(Comm,dofManager));
+    else
+      linObjFactory = Teuchos::rcp(new panzer::BlockedEpetraLinearObjFactory<panzer::Traits,int>(mpiComm,dofManager,false));
     lof = linObjFactory;
 
     rLibrary = Teuchos::rcp(new panzer::ResponseLibrary<panzer::Traits>(wkstContainer,dofManager,linObjFactory));
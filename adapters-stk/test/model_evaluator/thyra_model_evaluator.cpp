@@ -263,6 +263,83 @@ namespace panzer {
     }
   }
 
+  TEUCHOS_UNIT_TEST(thyra_model_evaluator, fused_response)
+  {
+
+    bool parameter_on = true;
+    AssemblyPieces ap;
+
+    buildAssemblyPieces(parameter_on,false,ap);
+
+    {
+      typedef Thyra::ModelEvaluatorBase::InArgs<double> InArgs;
+      typedef Thyra::ModelEvaluatorBase::OutArgs<double> OutArgs;
+      typedef Thyra::VectorBase<double> VectorType;
+      typedef panzer::ModelEvaluator<double> PME;
+
+      bool build_transient_support = false;
+      RCP<PME> me = Teuchos::rcp(new PME(ap.lof,Teuchos::null,ap.gd,build_transient_support,0.0));
+
+      Teuchos::RCP<panzer::FunctionalResponse_Builder<int,int> > builder
+        = Teuchos::rcp(new panzer::FunctionalResponse_Builder<int,int>);
+
+      builder->comm = MPI_COMM_WORLD; // good enough
+      builder->cubatureDegree = 1;
+      builder->requiresCellIntegral = true;
+      builder->quadPointField = "";
+
+      // only one of the two blocks carries the response
+      std::vector<panzer::WorksetDescriptor> blocks;
+      blocks.push_back(panzer::blockDescriptor("eblock-0_0"));
+      me->addFlexibleResponse("TEMPERATURE",blocks,builder);
+      me->setupModel(ap.wkstContainer,ap.physicsBlocks,ap.bcs,
+                     *ap.eqset_factory,
+                     *ap.bc_factory,
+                     ap.cm_factory,
+                     ap.cm_factory,
+                     ap.closure_models,
+                     ap.user_data,false,"");
+
+      TEST_ASSERT(!me->getFusedResponseEvaluation());
+
+      RCP<VectorType> x = Thyra::createMember(*me->get_x_space());
+      Thyra::randomize(1.0,2.0,x.ptr());
+
+      InArgs in_args = me->createInArgs();
+      in_args.set_x(x);
+
+      // two sweeps
+      RCP<VectorType> f = Thyra::createMember(*me->get_f_space());
+      RCP<VectorType> g = Thyra::createMember(*me->get_g_space(0));
+      {
+        OutArgs out_args = me->createOutArgs();
+        out_args.set_f(f);
+        out_args.set_g(0,g);
+        me->evalModel(in_args, out_args);
+      }
+
+      // one sweep
+      me->setFusedResponseEvaluation(true);
+
+      RCP<VectorType> f_fused = Thyra::createMember(*me->get_f_space());
+      RCP<VectorType> g_fused = Thyra::createMember(*me->get_g_space(0));
+      {
+        OutArgs out_args = me->createOutArgs();
+        out_args.set_f(f_fused);
+        out_args.set_g(0,g_fused);
+        me->evalModel(in_args, out_args);
+      }
+
+      TEST_ASSERT(Thyra::norm_2(*f) > 0.0);
+      TEST_ASSERT(Thyra::norm_2(*g) > 0.0);
+
+      Thyra::Vp_StV(f_fused.ptr(),-1.0,*f);
+      Thyra::Vp_StV(g_fused.ptr(),-1.0,*g);
+      TEST_FLOATING_EQUALITY(Thyra::norm_2(*f_fused)/Thyra::norm_2(*f)+1.0,1.0,1e-14);
+      TEST_FLOATING_EQUALITY(Thyra::norm_2(*g_fused)/Thyra::norm_2(*g)+1.0,1.0,1e-14);
+    }
+  }
+
   // Testing Parameter Support
   TEUCHOS_UNIT_TEST(thyra_model_evaluator, scalar_parameters)
   {
@@ -180,6 +180,86 @@ namespace panzer {
 
   }
 
+  TEUCHOS_UNIT_TEST(workset_builder, volume_chunks)
+  {
+    RCP<Teuchos::ParameterList> pl = rcp(new Teuchos::ParameterList);
+    pl->set("X Blocks",2);
+    pl->set("Y Blocks",1);
+    pl->set("X Elements",4);  // in each block
+    pl->set("Y Elements",5);  // in each block
+
+    panzer_stk::SquareQuadMeshFactory factory;
+    factory.setParameterList(pl);
+    RCP<panzer_stk::STK_Interface> mesh = factory.buildMesh(MPI_COMM_WORLD);
+
+    // 20 cells per block, chunked into worksets of 6, 6, 6 and 2 cells
+    const std::size_t workset_size = 6;
+
+    Teuchos::RCP<Teuchos::ParameterList> ipb = Teuchos::parameterList("Physics Blocks");
+    std::vector<panzer::BC> bcs;
+    testInitialzation(ipb, bcs);
+
+    std::vector<Teuchos::RCP<panzer::PhysicsBlock> > physicsBlocks;
+    {
+      Teuchos::RCP<user_app::MyFactory> eqset_factory = Teuchos::rcp(new user_app::MyFactory);
+
+      std::map<std::string,std::string> block_ids_to_physics_ids;
+      block_ids_to_physics_ids["eblock-0_0"] = "test physics";
+      block_ids_to_physics_ids["eblock-1_0"] = "test physics";
+
+      std::map<std::string,Teuchos::RCP<const shards::CellTopology> > block_ids_to_cell_topo;
+      block_ids_to_cell_topo["eblock-0_0"] = mesh->getCellTopology("eblock-0_0");
+      block_ids_to_cell_topo["eblock-1_0"] = mesh->getCellTopology("eblock-1_0");
+
+      panzer::buildPhysicsBlocks(block_ids_to_physics_ids,
+                                 block_ids_to_cell_topo,
+                                 ipb,
+                                 1,
+                                 workset_size,
+                                 eqset_factory,
+                                 panzer::createGlobalData(),
+                                 false,
+                                 physicsBlocks);
+    }
+
+    panzer_stk::WorksetFactory wkstFactory(mesh);
+    for(const auto & pb : physicsBlocks) {
+      Teuchos::RCP<std::vector<panzer::Workset> > worksets = wkstFactory.generateWorksets(*pb);
+      TEST_EQUALITY(worksets->size(),4);
+
+      std::vector<std::size_t> block_cell_ids;
+      for(const auto & workset : *worksets) {
+        TEST_ASSERT(workset.num_cells<=static_cast<int>(workset_size));
+        TEST_EQUALITY(workset.cell_local_ids.size(),std::size_t(workset.num_cells));
+        block_cell_ids.insert(block_cell_ids.end(),workset.cell_local_ids.begin(),workset.cell_local_ids.end());
+
+        // the device cell ids and vertices view the range of this workset
+        auto cell_ids_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),workset.cell_local_ids_k);
+        TEST_EQUALITY(cell_ids_h.extent(0),workset.cell_local_ids.size());
+        for(std::size_t c=0;c<workset.cell_local_ids.size();++c)
+          TEST_EQUALITY(std::size_t(cell_ids_h(c)),workset.cell_local_ids[c]);
+
+        Kokkos::DynRankView<double,PHX::Device> vertices;
+        mesh->getElementVertices(workset.cell_local_ids,vertices);
+        auto vertices_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),vertices);
+        auto workset_vertices_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),workset.cell_vertex_coordinates.get_static_view());
+        TEST_EQUALITY(workset_vertices_h.extent(0),vertices_h.extent(0));
+        for(std::size_t c=0;c<workset_vertices_h.extent(0);++c)
+          for(std::size_t v=0;v<workset_vertices_h.extent(1);++v)
+            for(std::size_t d=0;d<workset_vertices_h.extent(2);++d)
+              TEST_EQUALITY(workset_vertices_h(c,v,d),vertices_h(c,v,d));
+
+        TEST_EQUALITY(workset.getFaceConnectivity().numCells(),workset.num_cells);
+      }
+
+      // every cell of the block appears once, in local id order
+      std::vector<std::size_t> local_cell_ids;
+      Kokkos::DynRankView<double,PHX::Device> cell_vertex_coordinates;
+      panzer_stk::workset_utils::getIdsAndVertices(*mesh,pb->elementBlockID(),local_cell_ids,cell_vertex_coordinates);
+      TEST_ASSERT(block_cell_ids==local_cell_ids);
+    }
+  }
+
   TEUCHOS_UNIT_TEST(workset_builder, edge)
   {
 
@@ -52,6 +52,11 @@
 #include "Panzer_WorksetContainer.hpp"
 #include "Panzer_IntrepidBasisFactory.hpp"
 #include "Panzer_DOFManager.hpp"
+#include "Panzer_IntegrationRule.hpp"
+#include "Panzer_PureBasis.hpp"
+#include "Panzer_WorksetGeometryCache.hpp"
+#include "Panzer_IntegrationValues2.hpp"
+#include "Panzer_BasisValues2.hpp"
 
 #include "Panzer_STK_Interface.hpp"
 #include "Panzer_STK_CubeHexMeshFactory.hpp"
@@ -190,4 +195,218 @@ namespace panzer {
       }
     }
   }
+
+  TEUCHOS_UNIT_TEST(workset_container, side_chunks)
+  {
+    using Teuchos::RCP;
+    using Teuchos::rcp;
+
+    std::string element_block = "eblock-0_0_0";
+    std::string sideset = "left";
+    int workset_size = 10;
+
+    RCP<Teuchos::ParameterList> pl = rcp(new Teuchos::ParameterList);
+    pl->set("X Elements",8);
+    pl->set("Y Elements",8);
+    pl->set("Z Elements",8);
+
+    panzer_stk::CubeHexMeshFactory factory;
+    factory.setParameterList(pl);
+    RCP<panzer_stk::STK_Interface> mesh = factory.buildMesh(MPI_COMM_WORLD);
+
+    RCP<panzer_stk::WorksetFactory> wkstFactory
+       = rcp(new panzer_stk::WorksetFactory(mesh)); // build STK workset factory
+    panzer::WorksetContainer wkstContainer;
+    {
+      WorksetNeeds needs;
+      needs.cellData = CellData(workset_size,mesh->getCellTopology(element_block));
+      needs.int_rules.push_back(rcp(new IntegrationRule(2,needs.cellData)));
+      needs.bases.push_back(rcp(new PureBasis("HGrad",1,needs.cellData)));
+      wkstContainer.setNeeds(element_block,needs);
+    }
+    wkstContainer.setFactory(wkstFactory);
+    wkstContainer.setWorksetSize(workset_size);
+
+    const WorksetDescriptor wd = sidesetDescriptor(element_block,sideset);
+
+    // the whole sideset in one workset is the reference
+    RCP<Workset> whole = wkstContainer.getSideWorkset(wd);
+    const std::size_t numSides = whole==Teuchos::null ? 0 : whole->num_cells;
+
+    // cached: every chunk has at most workset_size cells and holds its values
+    {
+      std::vector<Workset> & chunks = *wkstContainer.getSideWorksetChunks(wd);
+      TEST_EQUALITY(chunks.size(),(numSides+workset_size-1)/workset_size);
+
+      std::size_t total = 0;
+      std::set<std::size_t> identifiers;
+      for(std::size_t c=0;c<chunks.size();c++) {
+        TEST_ASSERT(chunks[c].num_cells<=workset_size);
+        TEST_ASSERT(chunks[c].num_cells>0);
+        TEST_ASSERT(chunks[c].int_rules.size()==1);
+        for(int i=0;i<chunks[c].num_cells;i++)
+          TEST_EQUALITY(chunks[c].cell_local_ids[i],whole->cell_local_ids[total+i]);
+        total += chunks[c].num_cells;
+        identifiers.insert(chunks[c].getIdentifier());
+      }
+      TEST_EQUALITY(total,numSides);
+      TEST_EQUALITY(identifiers.size(),chunks.size());
+    }
+
+    // rebuilt per chunk: only the chunk accessed last holds values
+    wkstContainer.setCacheSideWorksetValues(false);
+    {
+      std::vector<Workset> & chunks = *wkstContainer.getSideWorksetChunks(wd);
+      for(std::size_t c=0;c<chunks.size();c++)
+        TEST_ASSERT(chunks[c].int_rules.empty());
+
+      for(std::size_t c=0;c<chunks.size();c++) {
+        Workset & wkst = wkstContainer.getSideWorksetChunk(wd,c);
+        TEST_EQUALITY(wkst.int_rules.size(),1);
+        TEST_EQUALITY(wkst.bases.size(),1);
+
+        std::size_t populated = 0;
+        for(std::size_t k=0;k<chunks.size();k++)
+          populated += chunks[k].int_rules.empty() ? 0 : 1;
+        TEST_EQUALITY(populated,1);
+      }
+    }
+  }
+
+  TEUCHOS_UNIT_TEST(workset_container, geometry_cache)
+  {
+    using Teuchos::RCP;
+    using Teuchos::rcp;
+
+    std::string element_block = "eblock-0_0_0";
+    int workset_size = 10;
+
+    RCP<Teuchos::ParameterList> pl = rcp(new Teuchos::ParameterList);
+    pl->set("X Elements",8);
+    pl->set("Y Elements",8);
+    pl->set("Z Elements",8);
+
+    panzer_stk::CubeHexMeshFactory factory;
+    factory.setParameterList(pl);
+    RCP<panzer_stk::STK_Interface> mesh = factory.buildMesh(MPI_COMM_WORLD);
+
+    RCP<panzer_stk::WorksetFactory> wkstFactory
+       = rcp(new panzer_stk::WorksetFactory(mesh)); // build STK workset factory
+    RCP<WorksetGeometryCache> cache = rcp(new WorksetGeometryCache);
+
+    panzer::WorksetContainer wkstContainer;
+    {
+      WorksetNeeds needs;
+      needs.cellData = CellData(workset_size,mesh->getCellTopology(element_block));
+      needs.int_rules.push_back(rcp(new IntegrationRule(2,needs.cellData)));
+      needs.bases.push_back(rcp(new PureBasis("HGrad",1,needs.cellData)));
+      wkstContainer.setNeeds(element_block,needs);
+    }
+    wkstContainer.setFactory(wkstFactory);
+    wkstContainer.setWorksetSize(workset_size);
+    wkstContainer.setGeometryCache(cache);
+
+    const WorksetDescriptor wd = blockDescriptor(element_block);
+
+    // first build: everything is computed, one integration and one basis value per workset
+    std::vector<double> measures;
+    std::size_t numWorksets = 0;
+    {
+      std::vector<Workset> & worksets = *wkstContainer.getWorksets(wd);
+      numWorksets = worksets.size();
+      for(const auto & wkst : worksets) {
+        TEST_EQUALITY(wkst.int_rules.size(),1);
+        TEST_EQUALITY(wkst.bases.size(),1);
+        auto wm = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),wkst.int_rules[0]->weighted_measure.get_static_view());
+        for(int c=0;c<wkst.num_cells;c++)
+          for(std::size_t q=0;q<wm.extent(1);q++)
+            measures.push_back(wm(c,q));
+      }
+    }
+    TEST_EQUALITY(cache->getHits(),0u);
+    TEST_EQUALITY(cache->getMisses(),2*numWorksets);
+    TEST_EQUALITY(cache->size(),2*numWorksets);
+    TEST_ASSERT(cache->getMemoryUsage()>0);
+
+    // rebuilding after a reset and a new factory reuses all the geometry
+    wkstContainer.clear();
+    wkstContainer.setFactory(rcp(new panzer_stk::WorksetFactory(mesh)));
+    {
+      std::vector<Workset> & worksets = *wkstContainer.getWorksets(wd);
+      TEST_EQUALITY(worksets.size(),numWorksets);
+
+      std::size_t k = 0;
+      for(const auto & wkst : worksets) {
+        auto wm = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),wkst.int_rules[0]->weighted_measure.get_static_view());
+        for(int c=0;c<wkst.num_cells;c++)
+          for(std::size_t q=0;q<wm.extent(1);q++)
+            TEST_EQUALITY(wm(c,q),measures[k++]);
+      }
+    }
+    TEST_EQUALITY(cache->getHits(),2*numWorksets);
+    TEST_EQUALITY(cache->getMisses(),2*numWorksets);
+
+    // a new coordinate version recomputes and drops the stale values
+    wkstContainer.setMeshCoordinateVersion(1);
+    wkstContainer.getWorksets(wd);
+    TEST_EQUALITY(cache->getHits(),2*numWorksets);
+    TEST_EQUALITY(cache->getMisses(),4*numWorksets);
+    TEST_EQUALITY(cache->size(),2*numWorksets);
+    TEST_EQUALITY(cache->getEvictions(),2*numWorksets);
+
+    // a budget evicts the least recently used entries
+    const std::size_t budget = cache->getMemoryUsage()/2;
+    cache->setMemoryBudget(budget);
+    TEST_ASSERT(cache->getMemoryUsage()<=budget);
+    TEST_ASSERT(cache->size()<2*numWorksets);
+  }
+
+  TEUCHOS_UNIT_TEST(workset_container, geometry_cache_key)
+  {
+    using Teuchos::RCP;
+    using Teuchos::rcp;
+
+    // two different sets of cells forced into the same hash bucket
+    auto cellsA = std::make_shared<WorksetGeometryCache::Cells>();
+    cellsA->localIds = {0,1};
+    cellsA->coordinates = {0.0,1.0};
+    cellsA->hash = 7;
+
+    auto cellsB = std::make_shared<WorksetGeometryCache::Cells>(*cellsA);
+    cellsB->localIds = {0,2};
+
+    auto cellsMoved = std::make_shared<WorksetGeometryCache::Cells>(*cellsA);
+    cellsMoved->coordinates = {0.0,2.0};
+
+    WorksetGeometryCache::Key a;
+    a.elementBlock = "eblock-0_0_0";
+    a.cells = cellsA;
+    a.integration = 1;
+    a.basis = 0;
+    a.coordinateVersion = 0;
+
+    WorksetGeometryCache::Key b = a;
+    b.cells = cellsB;
+
+    WorksetGeometryCache::Key moved = a;
+    moved.cells = cellsMoved;
+
+    WorksetGeometryCache::Key same = a;
+    same.cells = std::make_shared<WorksetGeometryCache::Cells>(*cellsA);
+
+    WorksetGeometryCache::KeyHash hash;
+    TEST_EQUALITY(hash(a),hash(b));
+    TEST_ASSERT(!(a==b));
+    TEST_ASSERT(!(a==moved));
+    TEST_ASSERT(a==same);
+
+    WorksetGeometryCache cache;
+    RCP<IntegrationValues2<double> > iv = rcp(new IntegrationValues2<double>("",true));
+    cache.insert(a,iv);
+    TEST_ASSERT(cache.findIntegrationValues(b)==Teuchos::null);
+    TEST_ASSERT(cache.findIntegrationValues(moved)==Teuchos::null);
+    TEST_ASSERT(cache.findIntegrationValues(same)==iv);
+    TEST_EQUALITY(cache.getHits(),1u);
+    TEST_EQUALITY(cache.getMisses(),2u);
+  }
 }
@@ -45,6 +45,8 @@
 #include <Teuchos_RCP.hpp>
 #include <Teuchos_TimeMonitor.hpp>
 
+#include <algorithm>
+
 using Teuchos::RCP;
 using Teuchos::rcp;
 
@@ -1754,4 +1756,88 @@ namespace panzer {
     TEST_ASSERT(wm->isThreeD());
     TEST_EQUALITY(wm->getIndex(),0);
   }
+
+  // Forwards to a matcher, but hides its type so all pairs are tested
+  template <typename Matcher>
+  struct AllPairsMatcher {
+    Matcher matcher;
+    bool operator()(const Teuchos::Tuple<double,3> & a,const Teuchos::Tuple<double,3> & b) const
+    { return matcher(a,b); }
+  };
+
+  // Nodes of a n x n grid in the plane normal to direction normal at offset
+  void buildPlaneSide(int n,int normal,double offset,std::size_t firstId,
+                      std::vector<std::size_t> & ids,std::vector<Teuchos::Tuple<double,3> > & coords)
+  {
+    ids.clear(); coords.clear();
+    for(int i=0;i<n;i++) {
+      for(int j=0;j<n;j++) {
+        Teuchos::Tuple<double,3> x;
+        x[normal] = offset;
+        x[(normal+1)%3] = double(i)/(n-1);
+        x[(normal+2)%3] = double(j)/(n-1);
+        coords.push_back(x);
+        ids.push_back(firstId+i*n+j);
+      }
+    }
+  }
+
+  TEUCHOS_UNIT_TEST(periodic_bcs, matchSideIdsAndCoords_bucketed)
+  {
+    using Teuchos::Tuple;
+    typedef std::vector<std::pair<std::size_t,std::size_t> > PairVector;
+
+    std::vector<std::size_t> leftIds, rightIds;
+    std::vector<Tuple<double,3> > leftCoords, rightCoords;
+    buildPlaneSide(17,0,0.0,0,leftIds,leftCoords);
+    buildPlaneSide(17,0,1.0,1000,rightIds,rightCoords);
+
+    // right side is processed in a scrambled order
+    std::reverse(rightIds.begin(),rightIds.end());
+    std::reverse(rightCoords.begin(),rightCoords.end());
+
+    // plane matcher: the bucketed search gives the same pairs as testing all pairs
+    {
+      PlaneMatcher matcher(1,2);
+      RCP<PairVector> bucketed = panzer_stk::periodic_helpers::matchSideIdsAndCoords(leftIds,leftCoords,rightIds,rightCoords,matcher);
+      AllPairsMatcher<PlaneMatcher> allPairs{matcher};
+      RCP<PairVector> reference = panzer_stk::periodic_helpers::matchSideIdsAndCoords(leftIds,leftCoords,rightIds,rightCoords,allPairs);
+
+      TEST_EQUALITY(bucketed->size(),rightIds.size());
+      TEST_ASSERT(*bucketed==*reference);
+      for(const auto & pair : *bucketed)
+        TEST_EQUALITY(pair.first+1000,pair.second);
+    }
+
+    // relative coordinate matcher, sides 1e-6 apart with nodes 1e-7 apart
+    {
+      std::vector<std::size_t> lineLeftIds, lineRightIds;
+      std::vector<Tuple<double,3> > lineLeftCoords, lineRightCoords;
+      for(int i=0;i<11;i++) {
+        lineLeftIds.push_back(i);
+        lineLeftCoords.push_back(Teuchos::tuple(0.0,1.0e-7*i,0.0));
+        lineRightIds.push_back(1000+10-i);
+        lineRightCoords.push_back(Teuchos::tuple(1.0e-6,1.0e-7*(10-i),0.0));
+      }
+
+      std::vector<std::string> params;
+      params.push_back("1e-3");
+      params.push_back("relative");
+      CoordMatcher matcher(1,params);
+      RCP<PairVector> bucketed = panzer_stk::periodic_helpers::matchSideIdsAndCoords(lineLeftIds,lineLeftCoords,lineRightIds,lineRightCoords,matcher);
+      AllPairsMatcher<CoordMatcher> allPairs{matcher};
+      RCP<PairVector> reference = panzer_stk::periodic_helpers::matchSideIdsAndCoords(lineLeftIds,lineLeftCoords,lineRightIds,lineRightCoords,allPairs);
+      TEST_EQUALITY(bucketed->size(),lineRightIds.size());
+      TEST_ASSERT(*bucketed==*reference);
+      for(const auto & pair : *bucketed)
+        TEST_EQUALITY(pair.first+1000,pair.second);
+    }
+
+    // a tolerance larger than the node spacing is still detected
+    {
+      PlaneMatcher matcher(1,2,0.1);
+      TEST_THROW(panzer_stk::periodic_helpers::matchSideIdsAndCoords(leftIds,leftCoords,rightIds,rightCoords,matcher),std::logic_error);
+    }
+  }
+
 }
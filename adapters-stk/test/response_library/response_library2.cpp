@@ -84,6 +84,10 @@ namespace panzer {
 										Teuchos::RCP<panzer::WorksetContainer> wkstContainer,
 										RCP<panzer::WorksetContainer> wkstContainer2);
 
+  template <typename EvalT=panzer::Traits::Residual>
+  void evaluateResponses(const panzer::FieldManagerBuilder & fmb,
+                         panzer::WorksetContainer & wkstContainer);
+
   TEUCHOS_UNIT_TEST(response_library, test_surface)
   {
 
@@ -146,32 +150,7 @@ namespace panzer {
 			ev.get<panzer::Traits::Residual>()->setVector(rvec);
 	}
 	
-	const std::vector< std::shared_ptr< PHX::FieldManager<panzer::Traits> > >
-		rfm = fmb->getResponseFieldManager();
-	const std::vector<WorksetDescriptor> & wkstDesc = fmb->getResponseWorksetDescriptors();
-	// Loop over response field managers
-	for (std::size_t block = 0; block < rfm.size(); ++block) {
-		const WorksetDescriptor& wd = wkstDesc[block];
-		std::shared_ptr< PHX::FieldManager<panzer::Traits> > fm = rfm[block];
-		Teuchos::RCP<panzer::Workset> workset;
-		if( wd.useSideset() ) {
-		  workset = wkstContainer->getSideWorkset(wd);
-	    } else {
-			Teuchos::RCP<std::vector<Workset> > wksts = wkstContainer->getWorksets(wd);
-			workset = Teuchos::rcpFromRef((*wksts)[0]);
-		}
-		TEUCHOS_TEST_FOR_EXCEPTION(workset == Teuchos::null, std::logic_error,
-                         "Failed to find corresponding bc workset!");
-
-		panzer::Traits::PED ped;
-		fm->template preEvaluate<panzer::Traits::Residual>(ped);
-		fm->evaluateFields<panzer::Traits::Residual>(*workset);
-		fm->postEvaluate<panzer::Traits::Residual>(0);
-		
-		//for(PHX::FieldManager<panzer::Traits>::iterator fd=fm->begin(); fd!=fm->end(); ++fd) {
-		//	fd->print(std::cout);
-		//}
-	}
+	evaluateResponses(*fmb,*wkstContainer);
 
 	{ 
 		const auto& resp0 = respContainer["RESPONSE_FIELD_A"];
@@ -189,6 +168,134 @@ namespace panzer {
 	}
   }
 
+  TEUCHOS_UNIT_TEST(response_library, process_without_response_cells)
+  {
+    std::vector<Teuchos::RCP<panzer::PhysicsBlock> > physics_blocks;
+    panzer::ClosureModelFactory_TemplateManager<panzer::Traits> cm_factory;
+    Teuchos::ParameterList closure_models("Closure Models");
+    Teuchos::ParameterList res_pl("Response");
+    Teuchos::ParameterList user_data("User Data");
+
+    RCP<panzer_stk::STK_Interface> mesh;
+    Teuchos::RCP<panzer::WorksetContainer> wkstContainer = Teuchos::rcp(new panzer::WorksetContainer);
+    Teuchos::RCP<panzer::WorksetContainer> wkstContainer2 = Teuchos::rcp(new panzer::WorksetContainer);
+    RCP<panzer::LinearObjFactory<panzer::Traits> > lof
+          = buildModel(physics_blocks,cm_factory,closure_models,user_data,mesh,wkstContainer,wkstContainer2);
+
+    double iValue = -2.3;
+    double tValue = 82.9;
+
+    // Each block is split along x, so with two processes the left side is owned
+    // by the first process only and the right side by the second only
+    {
+      Teuchos::ParameterList& p = res_pl.sublist("right response");
+      p.set("Type","Integral");
+      p.set<Teuchos::Array<std::string> >("Element Block Name",Teuchos::tuple<std::string>("eblock-1_0"));
+      p.set<Teuchos::Array<std::string> >("SideSet Name",Teuchos::tuple<std::string>("right"));
+      p.set("Integrand Name","FIELD_B");
+      p.set("DOF Name","FIELD_B");
+    }
+    {
+      Teuchos::ParameterList& p = res_pl.sublist("left response");
+      p.set("Type","Integral");
+      p.set<Teuchos::Array<std::string> >("Element Block Name",Teuchos::tuple<std::string>("eblock-0_0"));
+      p.set<Teuchos::Array<std::string> >("SideSet Name",Teuchos::tuple<std::string>("left"));
+      p.set("Integrand Name","FIELD_A");
+      p.set("DOF Name","FIELD_A");
+    }
+
+    Teuchos::RCP<panzer::FieldManagerBuilder> fmb = Teuchos::rcp(new panzer::FieldManagerBuilder);
+    std::unordered_map<std::string, std::vector<TianXin::TemplatedResponse>> respContainer;
+    fmb->setWorksetContainer2(wkstContainer);
+    fmb->setupResponseFieldManagers(res_pl,mesh,physics_blocks,*lof,cm_factory,closure_models,user_data,respContainer);
+
+    // both slots exist everywhere, whatever the process owns
+    Teuchos::RCP<TianXin::ResponseReduction> reduction = fmb->getResponseReduction<panzer::Traits::Residual>();
+    TEST_ASSERT(reduction!=Teuchos::null);
+    TEST_ASSERT(reduction->isSetup());
+    TEST_EQUALITY(reduction->numResponses(),2);
+    TEST_EQUALITY(reduction->size(),2);
+
+    // the Jacobian responses have a reduction of their own, one value per response
+    Teuchos::RCP<TianXin::ResponseReduction> jacobianReduction = fmb->getResponseReduction<panzer::Traits::Jacobian>();
+    TEST_ASSERT(jacobianReduction!=Teuchos::null);
+    TEST_ASSERT(jacobianReduction!=reduction);
+    TEST_ASSERT(jacobianReduction->isSetup());
+    TEST_EQUALITY(jacobianReduction->numResponses(),2);
+    TEST_EQUALITY(jacobianReduction->size(),2);
+
+    for( const auto& resps : respContainer )
+    {
+      if(resps.second.empty())
+        continue;
+      const auto& map= resps.second[0].get<panzer::Traits::Residual>()->getMap();
+      Teuchos::RCP<Tpetra::Vector<double, int, panzer::GlobalOrdinal>> rvec = Teuchos::rcp(new Tpetra::Vector<double, int, panzer::GlobalOrdinal>(map));
+      Teuchos::RCP<Tpetra::Vector<double, int, panzer::GlobalOrdinal>> jvec = Teuchos::rcp(new Tpetra::Vector<double, int, panzer::GlobalOrdinal>(map));
+      for( auto& ev : resps.second ) {
+        ev.get<panzer::Traits::Residual>()->setVector(rvec);
+        ev.get<panzer::Traits::Jacobian>()->setVector(jvec);
+      }
+    }
+
+    // returns on every process only if all of them post the reduction
+    evaluateResponses(*fmb,*wkstContainer);
+    evaluateResponses<panzer::Traits::Jacobian>(*fmb,*wkstContainer);
+
+    // each side has unit length
+    const auto right = respContainer.find("RESPONSE_FIELD_B");
+    if(right!=respContainer.end() && !right->second.empty()) {
+      const auto& array = right->second[0].get<panzer::Traits::Residual>()->getVector()->getData(0);
+      TEST_FLOATING_EQUALITY(array[0],iValue,1e-14);
+    }
+    const auto left = respContainer.find("RESPONSE_FIELD_A");
+    if(left!=respContainer.end() && !left->second.empty()) {
+      const auto& array = left->second[0].get<panzer::Traits::Residual>()->getVector()->getData(0);
+      TEST_FLOATING_EQUALITY(array[0],tValue,1e-14);
+
+      // the Jacobian evaluation sums the same value
+      typedef TianXin::Response_Integral<panzer::Traits::Jacobian,panzer::Traits> JacobianIntegral;
+      const Teuchos::RCP<JacobianIntegral> jac =
+        Teuchos::rcp_dynamic_cast<JacobianIntegral>(left->second[0].get<panzer::Traits::Jacobian>(),true);
+      const auto value = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),jac->value_.get_view());
+      TEST_FLOATING_EQUALITY(value(0),tValue,1e-14);
+    }
+  }
+
+  template <typename EvalT>
+  void evaluateResponses(const panzer::FieldManagerBuilder & fmb,
+                         panzer::WorksetContainer & wkstContainer)
+  {
+    Teuchos::RCP<TianXin::ResponseReduction> reduction = fmb.getResponseReduction<EvalT>();
+    reduction->initializeData();
+
+    const std::vector< std::shared_ptr< PHX::FieldManager<panzer::Traits> > >
+        rfm = fmb.getResponseFieldManager();
+    const std::vector<WorksetDescriptor> & wkstDesc = fmb.getResponseWorksetDescriptors();
+    // Loop over response field managers
+    for (std::size_t block = 0; block < rfm.size(); ++block) {
+        const WorksetDescriptor& wd = wkstDesc[block];
+        std::shared_ptr< PHX::FieldManager<panzer::Traits> > fm = rfm[block];
+        Teuchos::RCP<panzer::Workset> workset;
+        if( wd.useSideset() ) {
+          workset = wkstContainer.getSideWorkset(wd);
+        } else {
+            Teuchos::RCP<std::vector<Workset> > wksts = wkstContainer.getWorksets(wd);
+            workset = Teuchos::rcpFromRef((*wksts)[0]);
+        }
+        TEUCHOS_TEST_FOR_EXCEPTION(workset == Teuchos::null, std::logic_error,
+                         "Failed to find corresponding bc workset!");
+
+        panzer::Traits::PED ped;
+        fm->template preEvaluate<EvalT>(ped);
+        fm->template evaluateFields<EvalT>(*workset);
+        fm->template postEvaluate<EvalT>(0);
+    }
+
+    // every process posts, also one that owns no cells of a response
+    reduction->beginReduction();
+    reduction->endReduction();
+  }
+
   void testInitialzation(const Teuchos::RCP<Teuchos::ParameterList>& ipb)
   {
     // Physics block
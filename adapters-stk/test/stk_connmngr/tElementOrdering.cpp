@@ -0,0 +1,245 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+
+#include <Teuchos_ConfigDefs.hpp>
+#include <Teuchos_UnitTestHarness.hpp>
+#include "Teuchos_DefaultComm.hpp"
+#include "Teuchos_GlobalMPISession.hpp"
+#include "Teuchos_ParameterList.hpp"
+
+#include "PanzerAdaptersSTK_config.hpp"
+#include "Panzer_IntrepidFieldPattern.hpp"
+#include "Panzer_DOFManager.hpp"
+#include "Panzer_STK_CubeHexMeshFactory.hpp"
+#include "Panzer_STK_ElementOrdering.hpp"
+#include "Panzer_STKConnManager.hpp"
+
+#include "Intrepid2_HGRAD_HEX_C1_FEM.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <numeric>
+#include <random>
+#include <set>
+
+using Teuchos::RCP;
+using Teuchos::rcp;
+
+namespace panzer_stk {
+
+namespace {
+
+RCP<STK_Interface> buildOrderedHexMesh(int elmts,ElementOrdering ordering)
+{
+   Teuchos::ParameterList pl;
+   pl.set<int>("X Elements",elmts);
+   pl.set<int>("Y Elements",elmts);
+   pl.set<int>("Z Elements",elmts);
+
+   CubeHexMeshFactory meshFact;
+   meshFact.setParameterList(Teuchos::rcpFromRef(pl));
+
+   RCP<STK_Interface> mesh = meshFact.buildMesh(MPI_COMM_WORLD);
+   mesh->setElementOrdering(ordering);
+   return mesh;
+}
+
+//! Local ids of the element pairs sharing a face (four nodes)
+std::vector<std::pair<std::size_t,std::size_t> > faceNeighbors(const STK_Interface & mesh)
+{
+   const stk::mesh::BulkData & bulk = *mesh.getBulkData();
+   RCP<const std::vector<stk::mesh::Entity> > elements = mesh.getElementsOrderedByLID();
+
+   std::map<stk::mesh::EntityId,std::vector<std::size_t> > nodeElements;
+   for(std::size_t e=0;e<elements->size();++e) {
+      const stk::mesh::Entity * nodes = bulk.begin_nodes((*elements)[e]);
+      for(unsigned k=0;k<bulk.num_nodes((*elements)[e]);++k)
+         nodeElements[bulk.identifier(nodes[k])].push_back(e);
+   }
+
+   std::map<std::pair<std::size_t,std::size_t>,int> shared;
+   for(const auto & node : nodeElements)
+      for(std::size_t a : node.second)
+         for(std::size_t b : node.second)
+            if(a<b) ++shared[std::make_pair(a,b)];
+
+   std::vector<std::pair<std::size_t,std::size_t> > pairs;
+   for(const auto & pair : shared)
+      if(pair.second==4)
+         pairs.push_back(pair.first);
+   return pairs;
+}
+
+//! Mean of |order[a]-order[b]| over the neighbor pairs
+double meanIndexDistance(const std::vector<std::pair<std::size_t,std::size_t> > & pairs,
+                         const std::vector<std::size_t> & order)
+{
+   double sum = 0.0;
+   for(const auto & pair : pairs)
+      sum += std::abs(static_cast<double>(order[pair.first])-static_cast<double>(order[pair.second]));
+   return sum/pairs.size();
+}
+
+//! Distinct nodes touched by each run of chunkSize consecutive local ids, summed
+std::size_t chunkNodeFootprint(const STK_Interface & mesh,std::size_t chunkSize)
+{
+   const stk::mesh::BulkData & bulk = *mesh.getBulkData();
+   RCP<const std::vector<stk::mesh::Entity> > elements = mesh.getElementsOrderedByLID();
+
+   std::size_t footprint = 0;
+   for(std::size_t begin=0;begin<elements->size();begin+=chunkSize) {
+      std::set<stk::mesh::EntityId> nodes;
+      for(std::size_t e=begin;e<std::min(begin+chunkSize,elements->size());++e) {
+         const stk::mesh::Entity * elementNodes = bulk.begin_nodes((*elements)[e]);
+         for(unsigned k=0;k<bulk.num_nodes((*elements)[e]);++k)
+            nodes.insert(bulk.identifier(elementNodes[k]));
+      }
+      footprint += nodes.size();
+   }
+   return footprint;
+}
+
+RCP<panzer::DOFManager> buildDOFManager(const RCP<STK_Interface> & mesh)
+{
+   RCP<Intrepid2::Basis<PHX::exec_space,double,double> > basis
+      = rcp(new Intrepid2::Basis_HGRAD_HEX_C1_FEM<PHX::exec_space,double,double>);
+   RCP<const panzer::FieldPattern> pattern = rcp(new panzer::Intrepid2FieldPattern(basis));
+
+   RCP<panzer::DOFManager> dofManager = rcp(new panzer::DOFManager());
+   dofManager->setConnManager(rcp(new STKConnManager(mesh)),MPI_COMM_WORLD);
+   dofManager->addField("u",pattern);
+   dofManager->buildGlobalUnknowns();
+   return dofManager;
+}
+
+}
+
+TEUCHOS_UNIT_TEST(tElementOrdering, parse)
+{
+   TEST_ASSERT(elementOrderingFromString("Native")==ElementOrdering::Native);
+   TEST_ASSERT(elementOrderingFromString("Morton")==ElementOrdering::Morton);
+   TEST_ASSERT(elementOrderingFromString("RCM")==ElementOrdering::RCM);
+   TEST_THROW(elementOrderingFromString("Hilbert"),std::logic_error);
+}
+
+TEUCHOS_UNIT_TEST(tElementOrdering, permutation)
+{
+   const int elmts = 6;
+   const std::size_t numElmts = elmts*elmts*elmts;
+
+   for(ElementOrdering ordering : {ElementOrdering::Native,ElementOrdering::Morton,ElementOrdering::RCM}) {
+      RCP<STK_Interface> mesh = buildOrderedHexMesh(elmts,ordering);
+      TEST_ASSERT(mesh->getElementOrdering()==ordering);
+
+      // local ids are still a permutation of the owned elements
+      std::vector<stk::mesh::Entity> elements;
+      mesh->getMyElements(elements);
+      TEST_EQUALITY(elements.size(),numElmts);
+
+      std::vector<std::size_t> lids;
+      for(const auto & element : elements)
+        lids.push_back(mesh->elementLocalId(element));
+      std::sort(lids.begin(),lids.end());
+      for(std::size_t i=0;i<lids.size();++i)
+        TEST_EQUALITY(lids[i],i);
+
+      // and the lookup from local id back to the element is consistent
+      RCP<const std::vector<stk::mesh::Entity> > ordered = mesh->getElementsOrderedByLID();
+      for(std::size_t i=0;i<numElmts;++i)
+        TEST_EQUALITY(mesh->elementLocalId((*ordered)[i]),i);
+
+      // the element block lists used for worksets follow local id order
+      RCP<panzer::DOFManager> dofManager = buildDOFManager(mesh);
+      const std::vector<panzer::LocalOrdinal> & block = dofManager->getElementBlock("eblock-0_0_0");
+      TEST_EQUALITY(block.size(),numElmts);
+      TEST_ASSERT(std::is_sorted(block.begin(),block.end()));
+
+      // the connectivity of an element does not depend on the ordering
+      std::vector<panzer::GlobalOrdinal> gids;
+      dofManager->getElementGIDs(mesh->elementLocalId(mesh->getBulkData()->get_entity(mesh->getElementRank(),1)),gids);
+      TEST_EQUALITY(gids.size(),8);
+   }
+}
+
+TEUCHOS_UNIT_TEST(tElementOrdering, locality)
+{
+   // the native order of the generated cube is already lexicographic, so the
+   // reference for the mean index distance is a shuffled order of the same mesh
+   const int elmts = 8;
+   const std::size_t chunkSize = 8;
+
+   RCP<STK_Interface> native = buildOrderedHexMesh(elmts,ElementOrdering::Native);
+   const std::vector<std::pair<std::size_t,std::size_t> > nativePairs = faceNeighbors(*native);
+   TEST_EQUALITY(nativePairs.size(),std::size_t(3*elmts*elmts*(elmts-1)));
+
+   std::vector<std::size_t> shuffled(elmts*elmts*elmts);
+   std::iota(shuffled.begin(),shuffled.end(),0);
+   std::mt19937 generator(1234);
+   std::shuffle(shuffled.begin(),shuffled.end(),generator);
+   const double shuffledDistance = meanIndexDistance(nativePairs,shuffled);
+
+   std::vector<std::size_t> identity(shuffled.size());
+   std::iota(identity.begin(),identity.end(),0);
+   const std::size_t nativeFootprint = chunkNodeFootprint(*native,chunkSize);
+
+   for(ElementOrdering ordering : {ElementOrdering::Morton,ElementOrdering::RCM}) {
+      RCP<STK_Interface> mesh = buildOrderedHexMesh(elmts,ordering);
+      const std::vector<std::pair<std::size_t,std::size_t> > pairs = faceNeighbors(*mesh);
+      TEST_EQUALITY(pairs.size(),nativePairs.size());
+
+      // face neighbors end up close to each other in local id order
+      const double distance = meanIndexDistance(pairs,identity);
+      out << "mean face neighbor distance " << distance << ", shuffled " << shuffledDistance << std::endl;
+      TEST_ASSERT(distance < 0.25*shuffledDistance);
+
+      // Morton blocks are compact, so a workset touches fewer nodes than a run of x-lines
+      if(ordering==ElementOrdering::Morton) {
+         const std::size_t footprint = chunkNodeFootprint(*mesh,chunkSize);
+         out << "nodes per " << chunkSize << " elements " << footprint << ", native " << nativeFootprint << std::endl;
+         TEST_ASSERT(footprint < nativeFootprint);
+      }
+   }
+}
+
+}
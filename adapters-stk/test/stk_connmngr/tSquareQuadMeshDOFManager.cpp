@@ -52,6 +52,10 @@
 #include "Panzer_DOFManager.hpp"
 #include "Panzer_STK_SquareQuadMeshFactory.hpp"
 #include "Panzer_STKConnManager.hpp"
+#include "TianXin_STK_Utilities.hpp"
+
+#include "Tpetra_Map.hpp"
+#include "Tpetra_Vector.hpp"
 
 #include "Intrepid2_HGRAD_QUAD_C1_FEM.hpp"
 #include "Intrepid2_HGRAD_QUAD_C2_FEM.hpp"
@@ -1036,4 +1040,163 @@ TEUCHOS_UNIT_TEST(tSquareQuadMeshDOFManager, buildTest_nabors)
    }
 }
 
+TEUCHOS_UNIT_TEST(tSquareQuadMeshDOFManager, solution_field_transfer)
+{
+   stk::ParallelMachine Comm = MPI_COMM_WORLD;
+
+   // mesh with a solution field for each dof field
+   Teuchos::ParameterList pl;
+   pl.set<int>("X Elements",4);
+   pl.set<int>("Y Elements",3);
+   pl.set<int>("X Blocks",1);
+   pl.set<int>("Y Blocks",1);
+
+   panzer_stk::SquareQuadMeshFactory meshFact;
+   meshFact.setParameterList(Teuchos::rcpFromRef(pl));
+
+   RCP<panzer_stk::STK_Interface> mesh = meshFact.buildUncommitedMesh(Comm);
+   mesh->addSolutionField("ux","eblock-0_0");
+   mesh->addSolutionField("p","eblock-0_0");
+   meshFact.completeMeshConstruction(*mesh,Comm);
+
+   RCP<const panzer::FieldPattern> patternC1
+         = buildFieldPattern<Intrepid2::Basis_HGRAD_QUAD_C1_FEM<PHX::exec_space,double,double> >();
+
+   RCP<panzer::DOFManager> dofManager = rcp(new panzer::DOFManager());
+   dofManager->setConnManager(rcp(new panzer_stk::STKConnManager(mesh)),MPI_COMM_WORLD);
+   dofManager->addField("ux",patternC1);
+   dofManager->addField("p",patternC1);
+   dofManager->buildGlobalUnknowns();
+
+   // ghosted vector holding the global id of each dof
+   std::vector<panzer::GlobalOrdinal> ownedAndGhosted;
+   dofManager->getOwnedAndGhostedIndices(ownedAndGhosted);
+
+   typedef Tpetra::Map<panzer::LocalOrdinal,panzer::GlobalOrdinal> MapType;
+   RCP<const MapType> map = rcp(new MapType(Teuchos::OrdinalTraits<Tpetra::global_size_t>::invalid(),
+                                            ownedAndGhosted,0,Teuchos::DefaultComm<int>::getComm()));
+   TianXin::SolutionFieldTransfer::VectorType x(map);
+   {
+      auto xview = x.getLocalViewHost(Tpetra::Access::OverwriteAll);
+      for(std::size_t i=0;i<ownedAndGhosted.size();i++)
+         xview(i,0) = static_cast<double>(ownedAndGhosted[i]);
+   }
+
+   TianXin::SolutionFieldTransfer transfer(dofManager,*mesh);
+   TEST_EQUALITY(transfer.numFields(),2);
+   transfer.apply(x);
+
+   // every node holds the global id of its dof
+   std::vector<stk::mesh::Entity> nodes;
+   mesh->getAllNodes(nodes);
+   for(const std::string fieldName : {"ux","p"}) {
+      const int fnum = dofManager->getFieldNum(fieldName);
+      auto * field = mesh->getSolutionField(fieldName,"eblock-0_0");
+      for(const auto & node : nodes) {
+         const double * value = stk::mesh::field_data(*field,node);
+         TEST_EQUALITY(*value,static_cast<double>(dofManager->getNodalGDofOfField(fnum,mesh->EntityGlobalId(node))));
+      }
+   }
+
+   // pushSolutionOnFields builds the transfer for the DOF manager once
+   TianXin::pushSolutionOnFields(dofManager,*mesh,x);
+   TEST_EQUALITY(mesh->numSolutionFieldTransfers(),1);
+   const auto cached = mesh->getSolutionFieldTransfer(dofManager);
+   TEST_ASSERT(cached!=nullptr);
+   TianXin::pushSolutionOnFields(dofManager,*mesh,x);
+   TEST_EQUALITY(mesh->numSolutionFieldTransfers(),1);
+   TEST_ASSERT(mesh->getSolutionFieldTransfer(dofManager)==cached);
+
+   // the transfer of a destroyed DOF manager is neither current nor returned
+   // for a new DOF manager, whatever its address
+   dofManager = Teuchos::null;
+   TEST_ASSERT(!cached->isCurrent());
+
+   RCP<panzer::DOFManager> otherManager = rcp(new panzer::DOFManager());
+   otherManager->setConnManager(rcp(new panzer_stk::STKConnManager(mesh)),MPI_COMM_WORLD);
+   otherManager->addField("ux",patternC1);
+   otherManager->addField("p",patternC1);
+   otherManager->buildGlobalUnknowns();
+   TEST_ASSERT(mesh->getSolutionFieldTransfer(otherManager)==nullptr);
+
+   TianXin::pushSolutionOnFields(otherManager,*mesh,x);
+   TEST_EQUALITY(mesh->numSolutionFieldTransfers(),1);
+   TEST_ASSERT(mesh->getSolutionFieldTransfer(otherManager)!=cached);
+}
+
+
+/* Serial reference of the entity index: every node, edge and cell (the faces of a 2D mesh)
+ * of the owned and the ghosted (neighbor) elements is looked up element by element, as the
+ * index was built before, and must be found with the local ids of the element closure.
+ */
+TEUCHOS_UNIT_TEST(tSquareQuadMeshDOFManager, entity_dof_index_ghosts)
+{
+   stk::ParallelMachine Comm = MPI_COMM_WORLD;
+   TEUCHOS_ASSERT(stk::parallel_machine_size(Comm)==2);
+
+   RCP<const panzer::FieldPattern> patternC1
+         = buildFieldPattern<Intrepid2::Basis_HGRAD_QUAD_C1_FEM<PHX::exec_space,double,double> >();
+   RCP<const panzer::FieldPattern> patternC2
+         = buildFieldPattern<Intrepid2::Basis_HGRAD_QUAD_C2_FEM<PHX::exec_space,double,double> >();
+
+   RCP<panzer::ConnManager> connManager = buildQuadMesh(Comm,4,2,1,1);
+   RCP<panzer::DOFManager> dofManager = rcp(new panzer::DOFManager());
+   dofManager->useNeighbors(true);
+   dofManager->setConnManager(connManager,MPI_COMM_WORLD);
+   dofManager->addField("u",patternC2);
+   dofManager->addField("p",patternC1);
+   dofManager->buildGlobalUnknowns();
+
+   const std::string blockId = "eblock-0_0";
+   std::vector<panzer::LocalOrdinal> elements = connManager->getElementBlock(blockId);
+   const std::size_t numOwned = elements.size();
+   const std::vector<panzer::LocalOrdinal> & neighbors = connManager->getNeighborElementBlock(blockId);
+   elements.insert(elements.end(),neighbors.begin(),neighbors.end());
+   TEST_ASSERT(elements.size()>numOwned);
+
+   const auto hostLIDs = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),dofManager->getLIDs());
+
+   // rank 0: nodes, 1: edges (with their end nodes), 2: cells (every dof, the Q2 center included)
+   for(int rank=0;rank<3;rank++) {
+      for(const std::string fieldName : {"u","p"}) {
+         const int fnum = dofManager->getFieldNum(fieldName);
+         const panzer::EntityDofIndex * index = dofManager->getEntityDofIndex(fnum,rank);
+         TEST_ASSERT(index!=nullptr);
+         if(index==nullptr) continue;
+
+         std::set<panzer::GlobalOrdinal> owned_entities, all_entities;
+         bool allFound = true, allMatch = true;
+         std::vector<panzer::GlobalOrdinal> entities;
+         std::vector<panzer::LocalOrdinal> lids;
+         for(std::size_t e=0;e<elements.size();e++) {
+            const panzer::LocalOrdinal ele = elements[e];
+            if(rank==0)      connManager->getElementalNodeConnectivity(ele,entities);
+            else if(rank==1) connManager->getElementalEdges(ele,entities);
+            else             connManager->getElementalFaces(ele,entities);
+            if(rank==2) TEST_EQUALITY(entities.size(),1);
+
+            for(std::size_t i=0;i<entities.size();i++) {
+               const std::vector<int> & offsets = rank<2 ? dofManager->getGIDFieldOffsets_closure(blockId,fnum,rank,i).first
+                                                         : dofManager->getGIDFieldOffsets(blockId,fnum);
+               if(offsets.empty()) continue;
+               all_entities.insert(entities[i]);
+               if(e<numOwned) owned_entities.insert(entities[i]);
+
+               const bool found = index->getLIDs(entities[i],lids);
+               allFound &= found;
+               if(!found) continue;
+               allMatch &= (lids.size()==offsets.size());
+               for(std::size_t j=0;j<offsets.size() && j<lids.size();j++)
+                  allMatch &= (lids[j]==hostLIDs(ele,offsets[j]));
+            }
+         }
+         TEST_ASSERT(allFound);
+         TEST_ASSERT(allMatch);
+         TEST_EQUALITY(index->numEntities(),all_entities.size());
+         // the ghost layer adds entities no owned element touches
+         TEST_ASSERT(all_entities.size()>owned_entities.size());
+      }
+   }
+}
+
 }
@@ -0,0 +1,221 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#include <mpi.h>
+
+#include "Teuchos_ConfigDefs.hpp"
+#include "Teuchos_UnitTestHarness.hpp"
+#include "Teuchos_UnitTestRepository.hpp"
+
+#include "Kokkos_Core.hpp"
+
+#include "PanzerAdaptersSTK_config.hpp"
+#include "Panzer_STK_Interface.hpp"
+#include "Panzer_STK_ExodusReaderFactory.hpp"
+
+#include <limits> // for epsilon for tolerance in FP comparisons
+
+#ifdef PANZER_HAVE_IOSS
+
+// for checking test correctness
+#include "Ioss_DBUsage.h"               // for DatabaseUsage::READ_MODEL
+#include "Ioss_ElementBlock.h"          // for ElementBlock
+#include "Ioss_Field.h"                 // for Field, etc
+#include "Ioss_IOFactory.h"             // for IOFactory
+#include "Ioss_NodeBlock.h"             // for NodeBlock
+#include "Ioss_Property.h"              // for Property
+#include "Ioss_Region.h"                // for Region, etc
+
+const std::string node_field_name = "DUMMY_NODAL_FIELD";
+const std::string cell_field_name = "DUMMY_CELL_FIELD";
+const std::string block_name_1 = "block_1";
+const std::string block_name_2 = "block_2";
+
+namespace panzer_stk {
+
+  void setValues(const Teuchos::RCP<panzer_stk::STK_Interface>& mesh,
+                 double value)
+  {
+    auto cell_vals = mesh->getCellField(cell_field_name,block_name_1);
+
+    auto meta_data = mesh->getMetaData();
+    auto bulk_data = mesh->getBulkData();
+
+    auto cell_buckets = bulk_data->get_buckets(stk::topology::ELEM_RANK,meta_data->locally_owned_part());
+    for (size_t bucket_i=0 ; bucket_i<cell_buckets.size() ; ++bucket_i) {
+      stk::mesh::Bucket &cell_bucket = *cell_buckets[bucket_i];
+      for (size_t cell_i=0 ; cell_i<cell_bucket.size() ; ++cell_i) {
+        double * cell_data = stk::mesh::field_data(*cell_vals,cell_bucket.bucket_id(),cell_i);
+        *cell_data = value + 0.5;
+      }
+    }
+  }
+
+TEUCHOS_UNIT_TEST(tAsyncExodusOutput, NeedsThreadMultiple)
+{
+  int threadSupport = MPI_THREAD_SINGLE;
+  MPI_Query_thread(&threadSupport);
+  if (threadSupport == MPI_THREAD_MULTIPLE) {
+    out << "MPI provides MPI_THREAD_MULTIPLE, nothing to check" << std::endl;
+    return;
+  }
+
+  STK_ExodusReaderFactory f("meshes/basic.gen");
+  auto mesh = f.buildUncommitedMesh(MPI_COMM_WORLD);
+  TEST_THROW(mesh->enableAsyncExodusOutput(),std::runtime_error);
+  TEST_ASSERT(not mesh->isAsyncExodusOutputEnabled());
+}
+
+TEUCHOS_UNIT_TEST(tAsyncExodusOutput, FailedQueueStaysFailed)
+{
+  AsyncWriteQueue queue(2);
+  int written = 0;
+
+  queue.push([&written]() { ++written; });
+  queue.push([]() { throw std::runtime_error("failed step"); });
+  TEST_THROW(queue.wait(),std::runtime_error);
+  TEST_ASSERT(queue.error()!=nullptr);
+
+  // the failure is reported again, and no later step is queued or run
+  TEST_THROW(queue.wait(),std::runtime_error);
+  TEST_THROW(queue.push([&written]() { ++written; }),std::runtime_error);
+  TEST_EQUALITY(written,1);
+  TEST_ASSERT(queue.idle());
+}
+
+TEUCHOS_UNIT_TEST(tAsyncExodusOutput, BackgroundWrites)
+{
+  int threadSupport = MPI_THREAD_SINGLE;
+  MPI_Query_thread(&threadSupport);
+  if (threadSupport != MPI_THREAD_MULTIPLE) {
+    out << "MPI does not provide MPI_THREAD_MULTIPLE, nothing to check" << std::endl;
+    return;
+  }
+
+  stk::ParallelMachine pm(MPI_COMM_WORLD);
+  const std::string output_file = "exodus_async_output.exo";
+  const auto tolerance = std::numeric_limits<double>::epsilon() * 100.0;
+  const int num_steps = 5;
+
+  // *****************************
+  // Write time steps in the background, overwriting the fields as soon
+  // as each write returns
+  // *****************************
+  {
+    STK_ExodusReaderFactory f("meshes/basic.gen");
+    auto mesh = f.buildUncommitedMesh(MPI_COMM_WORLD);
+
+    mesh->addSolutionField(node_field_name,block_name_1);
+    mesh->addSolutionField(node_field_name,block_name_2);
+    mesh->addCellField(cell_field_name,block_name_1);
+    mesh->addCellField(cell_field_name,block_name_2);
+
+    mesh->enableAsyncExodusOutput(2);
+    TEST_ASSERT(mesh->isAsyncExodusOutputEnabled());
+
+    mesh->initialize(pm,true,false);
+
+    f.completeMeshConstruction(*mesh,MPI_COMM_WORLD);
+
+    mesh->setupExodusFile(output_file);
+    for (int step=0; step<num_steps; ++step) {
+      setValues(mesh,step);
+      mesh->writeToExodus(step);
+      setValues(mesh,-1.0);
+    }
+    mesh->flushExodusOutput();
+  }
+
+  // *****************************
+  // Every step holds the values it was written with
+  // *****************************
+  {
+    Ioss::DatabaseIO *resultsDb = Ioss::IOFactory::create("exodus", output_file, Ioss::READ_MODEL, MPI_COMM_WORLD);
+    Ioss::Region results(resultsDb);
+
+    TEST_EQUALITY(results.get_property("state_count").get_int(),num_steps);
+
+    Ioss::NodeBlock *nb = results.get_node_blocks()[0];
+    TEST_EQUALITY(nb->field_count(Ioss::Field::TRANSIENT), 1);
+    TEST_ASSERT(nb->field_exists(node_field_name));
+
+    Ioss::ElementBlock *eb = results.get_element_blocks()[0];
+    TEST_EQUALITY(eb->field_count(Ioss::Field::TRANSIENT), 3);
+    TEST_ASSERT(eb->field_exists(cell_field_name));
+
+    for (int step=0; step<num_steps; ++step) {
+      // ioss steps are 1 based
+      double db_time = results.begin_state(step+1);
+      TEST_FLOATING_EQUALITY(db_time,double(step),tolerance);
+
+      std::vector<double> cell_values;
+      eb->get_field_data(cell_field_name,cell_values);
+      for (const double value : cell_values)
+        TEST_FLOATING_EQUALITY(value,step+0.5,tolerance);
+
+      results.end_state(step+1);
+    }
+  }
+}
+
+} // namespace panzer_stk
+
+#endif
+
+// The background writer makes MPI calls of its own, so MPI is initialized
+// here with MPI_THREAD_MULTIPLE instead of by Teuchos::GlobalMPISession.
+int main( int argc, char* argv[] )
+{
+  int provided = MPI_THREAD_SINGLE;
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
+  Kokkos::initialize(argc,argv);
+
+  int result = 0;
+  {
+    Teuchos::UnitTestRepository::setGloballyReduceTestResult(true);
+    result = Teuchos::UnitTestRepository::runUnitTestsFromMain(argc, argv);
+  }
+
+  Kokkos::finalize();
+  MPI_Finalize();
+  return result;
+}
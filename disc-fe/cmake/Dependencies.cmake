@@ -1,5 +1,5 @@
 SET(LIB_REQUIRED_DEP_PACKAGES TeuchosCore TeuchosParameterList TeuchosComm Kokkos Sacado Phalanx Intrepid2 ThyraCore ThyraTpetraAdapters Tpetra Zoltan PanzerCore PanzerDofMgr)
-SET(LIB_OPTIONAL_DEP_PACKAGES ThyraEpetraAdapters ThyraEpetraExtAdapters Epetra EpetraExt)
+SET(LIB_OPTIONAL_DEP_PACKAGES ThyraEpetraAdapters ThyraEpetraExtAdapters Epetra EpetraExt PanzerExprEval)
 SET(TEST_REQUIRED_DEP_PACKAGES)
 SET(TEST_OPTIONAL_DEP_PACKAGES)
 SET(LIB_REQUIRED_DEP_TPLS MPI)
@@ -49,6 +49,14 @@
 #include "Panzer_Traits.hpp"
 #include "Panzer_LinearObjFactory.hpp"
 #include "Panzer_LinearObjContainer.hpp"
+#include "TianXin_ResponseReduction.hpp"
+
+#include <map>
+#include <vector>
+
+namespace PHX {
+  template<typename Traits> class FieldManager;
+}
 
 namespace panzer {
   class FieldManagerBuilder;
@@ -87,9 +95,23 @@ namespace panzer {
     AssemblyEngine(const Teuchos::RCP<panzer::FieldManagerBuilder>& fmb,
                    const Teuchos::RCP<const panzer::LinearObjFactory<panzer::Traits> > & lof);
     
-    void evaluate(const panzer::AssemblyEngineInArgs& input_arguments, const EvaluationFlags flags=EvaluationFlags(EvaluationFlags::All));
+    /** Evaluate the fill selected by <code>flags</code>. When <code>responses</code>
+      * is not null the responses of that engine (the one the <code>ResponseLibrary</code>
+      * uses) are evaluated in the same assembly pass: the solution is imported into the
+      * ghosted domain once, every workset is swept once for both the residual and the
+      * response evaluators, and the responses are scattered together with the residual.
+      * Their global evaluation data must already be in <code>input_arguments</code>.
+      */
+    void evaluate(const panzer::AssemblyEngineInArgs& input_arguments, const EvaluationFlags flags=EvaluationFlags(EvaluationFlags::All),
+                  AssemblyEngine<EvalT> * responses=nullptr);
 
-    void evaluateVolume(const panzer::AssemblyEngineInArgs& input_arguments);
+    /** Evaluate the volume field managers. When <code>responses</code> is not null
+      * the volume field managers of that engine are evaluated in the same sweep:
+      * each workset is handed to the response field manager of its block right
+      * after this engine's field manager is done with it.
+      */
+    void evaluateVolume(const panzer::AssemblyEngineInArgs& input_arguments,
+                        AssemblyEngine<EvalT> * responses=nullptr);
     void evaluateInterfaceBCs(const panzer::AssemblyEngineInArgs& input_arguments);
 	
 	void evaluateDirichletCondition(const panzer::AssemblyEngineInArgs& input_arguments);
@@ -112,6 +134,32 @@ namespace panzer {
 		     const panzer::AssemblyEngineInArgs& input_arguments,
                      const Teuchos::RCP<LinearObjContainer> preEval_loc=Teuchos::null);
 
+    /** Evaluate the worksets of one element block concurrently using the
+      * per-worker field managers built by the field manager builder. Worksets
+      * are grouped into colors that share no DOFs; the worksets of a color
+      * are handed out to one std::thread per field manager (the calling thread
+      * is worker zero). The coloring is cached and rebuilt when
+      * <code>worksetVersion</code> (see WorksetContainer::getVolumeWorksetVersion)
+      * changes. The field manager builder only provides replicas when the
+      * device kernels run inline on the launching thread.
+      */
+    void evaluateVolumeConcurrent(std::size_t block,
+                                  const std::vector< Teuchos::RCP< PHX::FieldManager<panzer::Traits> > > & replicas,
+                                  std::vector<panzer::Workset> & worksets,
+                                  std::size_t worksetVersion,
+                                  const panzer::AssemblyEngineInArgs& input_arguments,
+                                  panzer::Traits::PED & ped);
+
+    //! Copy the solver parameters (alpha, beta, time, ...) of the fill into a workset
+    static void setWorksetParameters(panzer::Workset & workset,const panzer::AssemblyEngineInArgs& input_arguments);
+
+    /** Complete the solution halo exchanges posted by <code>evaluate</code> when
+      * they are overlapped with the volume assembly, those of the global evaluation
+      * data in the arguments and of the ghosted container. Does nothing if no
+      * exchange is in flight.
+      */
+    void endGhostExchange(const panzer::AssemblyEngineInArgs& input_arguments);
+
   protected:
     
       Teuchos::RCP<panzer::FieldManagerBuilder> m_field_manager_builder;
@@ -124,6 +172,24 @@ namespace panzer {
       Teuchos::RCP<LinearObjContainer> localCounter_;
       Teuchos::RCP<LinearObjContainer> globalCounter_;
       Teuchos::RCP<LinearObjContainer> summedGhostedCounter_;
+
+      //! Workset colors for concurrent volume assembly, keyed by block
+      struct WorksetColoring {
+        std::size_t version = 0;
+        std::vector<std::vector<std::size_t> > colors;
+      };
+      std::map<std::size_t,WorksetColoring> volumeColorings_;
+
+      //! Interior (owned DOFs only) and boundary worksets of a block, keyed by block
+      struct WorksetClassification {
+        std::size_t version = 0;
+        std::vector<std::size_t> interior;
+        std::vector<std::size_t> boundary;
+      };
+      std::map<std::size_t,WorksetClassification> volumeClassifications_;
+
+      //! True between posting the overlapped solution import and completing it
+      bool ghostExchangePending_;
   };
   
 }
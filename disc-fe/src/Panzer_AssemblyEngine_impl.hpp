@@ -47,7 +47,13 @@
 #include "Panzer_FieldManagerBuilder.hpp"
 #include "Panzer_AssemblyEngine_InArgs.hpp"
 #include "Panzer_GlobalEvaluationDataContainer.hpp"
+#include "Panzer_GlobalIndexer.hpp"
+#include "Panzer_Workset_Utilities.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <sstream>
+#include <thread>
 
 //===========================================================================
 //===========================================================================
@@ -55,7 +61,7 @@ template <typename EvalT>
 panzer::AssemblyEngine<EvalT>::
 AssemblyEngine(const Teuchos::RCP<panzer::FieldManagerBuilder>& fmb,
                const Teuchos::RCP<const panzer::LinearObjFactory<panzer::Traits> > & lof)
-  : m_field_manager_builder(fmb), m_lin_obj_factory(lof), countersInitialized_(false)
+  : m_field_manager_builder(fmb), m_lin_obj_factory(lof), countersInitialized_(false), ghostExchangePending_(false)
 { 
 
 }
@@ -64,10 +70,12 @@ AssemblyEngine(const Teuchos::RCP<panzer::FieldManagerBuilder>& fmb,
 //===========================================================================
 template <typename EvalT>
 void panzer::AssemblyEngine<EvalT>::
-evaluate(const panzer::AssemblyEngineInArgs& in, const EvaluationFlags flags)
+evaluate(const panzer::AssemblyEngineInArgs& in, const EvaluationFlags flags, AssemblyEngine<EvalT> * responses)
 {
   typedef LinearObjContainer LOC;
 
+  // The TianXin responses are summed in evaluateResponse, the only pass that evaluates
+  // them. No reduction is posted here, it would carry nothing.
   GlobalEvaluationDataContainer gedc;
 
   if ( flags.getValue() & EvaluationFlags::Initialize ) {
@@ -75,10 +83,19 @@ evaluate(const panzer::AssemblyEngineInArgs& in, const EvaluationFlags flags)
 
     in.fillGlobalEvaluationDataContainer(gedc);
     gedc.initialize(); // make sure all ghosted data is ready to go
-    gedc.globalToGhost(LOC::X | LOC::DxDt);
 
-    // Push solution, x and dxdt into ghosted domain
-    m_lin_obj_factory->globalToGhostContainer(*in.container_,*in.ghostedContainer_,LOC::X | LOC::DxDt);
+    // Push solution, x and dxdt into ghosted domain, both for the gather containers
+    // and the ghosted linear object container. When the volume fill follows, the
+    // imports can be left in flight while the interior worksets are evaluated.
+    if(m_field_manager_builder->getOverlapGhostExchange() && (flags.getValue() & EvaluationFlags::VolumetricFill)) {
+      gedc.beginGlobalToGhost(LOC::X | LOC::DxDt);
+      m_lin_obj_factory->beginGlobalToGhostContainer(*in.container_,*in.ghostedContainer_,LOC::X | LOC::DxDt);
+      ghostExchangePending_ = true;
+    }
+    else {
+      gedc.globalToGhost(LOC::X | LOC::DxDt);
+      m_lin_obj_factory->globalToGhostContainer(*in.container_,*in.ghostedContainer_,LOC::X | LOC::DxDt);
+    }
     m_lin_obj_factory->beginFill(*in.ghostedContainer_);
   }
 
@@ -87,8 +104,9 @@ evaluate(const panzer::AssemblyEngineInArgs& in, const EvaluationFlags flags)
   // *********************
   if ( flags.getValue() & EvaluationFlags::VolumetricFill) {
     PANZER_FUNC_TIME_MONITOR_DIFF("panzer::AssemblyEngine::evaluate_volume("+PHX::print<EvalT>()+")", eval_vol);
-    this->evaluateVolume(in);
+    this->evaluateVolume(in,responses);
   }
+  this->endGhostExchange(in);
 
   // *********************
   // BC fill
@@ -101,11 +119,15 @@ evaluate(const panzer::AssemblyEngineInArgs& in, const EvaluationFlags flags)
     {
       PANZER_FUNC_TIME_MONITOR_DIFF("panzer::AssemblyEngine::evaluate_neumannbcs("+PHX::print<EvalT>()+")",eval_neumannbcs);
 	  this->evaluateNeumannCondition(in);
+      if(responses!=nullptr)
+        responses->evaluateNeumannCondition(in);
     }
 
     {
       PANZER_FUNC_TIME_MONITOR_DIFF("panzer::AssemblyEngine::evaluate_interfacebcs("+PHX::print<EvalT>()+")",eval_interfacebcs);
       this->evaluateInterfaceBCs(in);
+      if(responses!=nullptr)
+        responses->evaluateInterfaceBCs(in);
     }
 
 	{
@@ -128,12 +150,11 @@ evaluate(const panzer::AssemblyEngineInArgs& in, const EvaluationFlags flags)
   return;
 }
 
-
 //===========================================================================
 //===========================================================================
 template <typename EvalT>
 void panzer::AssemblyEngine<EvalT>::
-evaluateVolume(const panzer::AssemblyEngineInArgs& in)
+evaluateVolume(const panzer::AssemblyEngineInArgs& in, AssemblyEngine<EvalT> * responses)
 {
   const std::vector< Teuchos::RCP< PHX::FieldManager<panzer::Traits> > > &
     volume_field_managers = m_field_manager_builder->getVolumeFieldManagers();
@@ -148,28 +169,87 @@ evaluateVolume(const panzer::AssemblyEngineInArgs& in)
   ped.second_sensitivities_name = in.second_sensitivities_name;
   in.fillGlobalEvaluationDataContainer(*(ped.gedc));
 
+  const std::vector< std::vector< Teuchos::RCP< PHX::FieldManager<panzer::Traits> > > > &
+    replicas = m_field_manager_builder->getVolumeFieldManagerReplicas();
+
+  // Pair each response block with the block of this engine that sweeps the same
+  // worksets. Blocks evaluated concurrently, or responses over worksets this
+  // engine doesn't visit, are evaluated on their own afterwards.
+  std::vector< Teuchos::RCP< PHX::FieldManager<panzer::Traits> > > fused_fms(volume_field_managers.size());
+  std::vector<std::size_t> unfused;
+  if(responses!=nullptr) {
+    Teuchos::RCP<panzer::FieldManagerBuilder> rfmb = responses->getManagerBuilder();
+    const std::vector< Teuchos::RCP< PHX::FieldManager<panzer::Traits> > > &
+      response_fms = rfmb->getVolumeFieldManagers();
+    const std::vector<WorksetDescriptor> & responseDesc = rfmb->getVolumeWorksetDescriptors();
+    const bool sameWorksets = rfmb->getWorksetContainer()==wkstContainer;
+
+    for (std::size_t r = 0; r < response_fms.size(); ++r) {
+      std::size_t block = 0;
+      while(block < wkstDesc.size() && !(wkstDesc[block]==responseDesc[r]))
+        ++block;
+
+      const bool concurrent = block < replicas.size() && replicas[block].size() > 1;
+      if(sameWorksets && block < wkstDesc.size() && !concurrent && fused_fms[block]==Teuchos::null)
+        fused_fms[block] = response_fms[r];
+      else
+        unfused.push_back(r);
+    }
+  }
+
   // Loop over volume field managers
   for (std::size_t block = 0; block < volume_field_managers.size(); ++block) {
     const WorksetDescriptor & wd = wkstDesc[block];
     Teuchos::RCP< PHX::FieldManager<panzer::Traits> > fm = volume_field_managers[block];
     std::vector<panzer::Workset>& w = *wkstContainer->getWorksets(wd);
 
-    fm->template preEvaluate<EvalT>(ped);
+    // worker copies only pay off when there is more than one workset to share out
+    if(block < replicas.size() && replicas[block].size() > 1 && w.size() > 1) {
+      this->endGhostExchange(in);
+      this->evaluateVolumeConcurrent(block,replicas[block],w,wkstContainer->getVolumeWorksetVersion(),in,ped);
+      continue;
+    }
 
-    // Loop over worksets in this element block
-    for (std::size_t i = 0; i < w.size(); ++i) {
-      panzer::Workset& workset = w[i];
+    const Teuchos::RCP< PHX::FieldManager<panzer::Traits> > & rfm = fused_fms[block];
 
-      workset.alpha = in.alpha;
-      workset.beta = in.beta;
-      workset.time = in.time;
-      workset.step_size = in.step_size;
-      workset.stage_number = in.stage_number;
-      workset.gather_seeds = in.gather_seeds;
-      workset.evaluate_transient_terms = in.evaluate_transient_terms;
+    fm->template preEvaluate<EvalT>(ped);
+    if(rfm!=Teuchos::null)
+      rfm->template preEvaluate<EvalT>(ped);
 
+    auto evaluateWorkset = [&](panzer::Workset& workset) {
+      setWorksetParameters(workset,in);
 
       fm->template evaluateFields<EvalT>(workset);
+
+      // the workset geometry and gathered solution are still hot
+      if(rfm!=Teuchos::null)
+        rfm->template evaluateFields<EvalT>(workset);
+    };
+
+    if(ghostExchangePending_) {
+      // the classification only depends on the worksets, rebuild it if they were rebuilt
+      WorksetClassification & classes = volumeClassifications_[block];
+      if(classes.version != wkstContainer->getVolumeWorksetVersion()) {
+        PANZER_FUNC_TIME_MONITOR_DIFF("panzer::AssemblyEngine::evaluateVolume: classify worksets",classify_worksets);
+        panzer::classifyWorksets(*m_lin_obj_factory->getDomainGlobalIndexer(),w,classes.interior,classes.boundary);
+        classes.version = wkstContainer->getVolumeWorksetVersion();
+      }
+
+      // owned solution values are in place once the import is posted, so the
+      // interior worksets run while the halo messages are in flight
+      for (std::size_t i : classes.interior)
+        evaluateWorkset(w[i]);
+
+      if(!classes.boundary.empty())
+        this->endGhostExchange(in);
+
+      for (std::size_t i : classes.boundary)
+        evaluateWorkset(w[i]);
+    }
+    else {
+      // Loop over worksets in this element block
+      for (std::size_t i = 0; i < w.size(); ++i)
+        evaluateWorkset(w[i]);
     }
 
     // double s = 0.;
@@ -178,9 +258,136 @@ evaluateVolume(const panzer::AssemblyEngineInArgs& in)
     // std::cout << "Analyze Graph: " << PHX::print<EvalT>() << ",b=" << block << ", s=" << s << ", p=" << p << std::endl;
 
     fm->template postEvaluate<EvalT>(NULL);
+    if(rfm!=Teuchos::null)
+      rfm->template postEvaluate<EvalT>(NULL);
+  }
+
+  this->endGhostExchange(in);
+
+  // Response blocks that could not share the sweep
+  if(!unfused.empty()) {
+    Teuchos::RCP<panzer::FieldManagerBuilder> rfmb = responses->getManagerBuilder();
+    const std::vector< Teuchos::RCP< PHX::FieldManager<panzer::Traits> > > &
+      response_fms = rfmb->getVolumeFieldManagers();
+    const std::vector<WorksetDescriptor> & responseDesc = rfmb->getVolumeWorksetDescriptors();
+
+    for (std::size_t r : unfused) {
+      Teuchos::RCP< PHX::FieldManager<panzer::Traits> > rfm = response_fms[r];
+      std::vector<panzer::Workset>& w = *rfmb->getWorksetContainer()->getWorksets(responseDesc[r]);
+
+      rfm->template preEvaluate<EvalT>(ped);
+      for (std::size_t i = 0; i < w.size(); ++i) {
+        setWorksetParameters(w[i],in);
+        rfm->template evaluateFields<EvalT>(w[i]);
+      }
+      rfm->template postEvaluate<EvalT>(NULL);
+    }
   }
 }
 
+//===========================================================================
+//===========================================================================
+template <typename EvalT>
+void panzer::AssemblyEngine<EvalT>::
+evaluateVolumeConcurrent(std::size_t block,
+                         const std::vector< Teuchos::RCP< PHX::FieldManager<panzer::Traits> > > & replicas,
+                         std::vector<panzer::Workset> & w,
+                         std::size_t worksetVersion,
+                         const panzer::AssemblyEngineInArgs& in,
+                         panzer::Traits::PED & ped)
+{
+  PANZER_FUNC_TIME_MONITOR_DIFF("panzer::AssemblyEngine::evaluateVolumeConcurrent("+PHX::print<EvalT>()+")",eval_vol_concurrent);
+
+  // the coloring only depends on the worksets, rebuild it if they were rebuilt
+  WorksetColoring & coloring = volumeColorings_[block];
+  if(coloring.version != worksetVersion) {
+    PANZER_FUNC_TIME_MONITOR_DIFF("panzer::AssemblyEngine::evaluateVolumeConcurrent: color worksets",color_worksets);
+    panzer::colorWorksets(*m_lin_obj_factory->getRangeGlobalIndexer(),w,coloring.colors);
+    coloring.version = worksetVersion;
+  }
+
+  for (std::size_t i = 0; i < w.size(); ++i)
+    setWorksetParameters(w[i],in);
+
+  for (const auto & fm : replicas)
+    fm->template preEvaluate<EvalT>(ped);
+
+  // Each worker owns one field manager and pulls worksets of the current color
+  // from a shared counter. Worksets in a color touch disjoint rows so the
+  // scatters into the shared ghosted container never overlap. The kernels the
+  // evaluators launch run inline on the worker thread (see
+  // FieldManagerBuilder::concurrentVolumeAssemblySupported), so no Kokkos
+  // parallel region is ever nested. All workers launch on the default Serial
+  // instance, which Kokkos 4.2 and later guard for concurrent launches.
+  for (const auto & color : coloring.colors) {
+    const std::size_t numWorkers = std::min(replicas.size(),color.size());
+    std::atomic<std::size_t> next(0);
+    std::vector<std::exception_ptr> errors(numWorkers);
+
+    auto work = [&](const std::size_t worker) {
+      try {
+        for (std::size_t c = next++; c < color.size(); c = next++)
+          replicas[worker]->template evaluateFields<EvalT>(w[color[c]]);
+      }
+      catch(...) {
+        errors[worker] = std::current_exception();
+      }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(numWorkers);
+    for (std::size_t t = 1; t < numWorkers; ++t)
+      threads.emplace_back(work,t);
+    work(0);
+    for (auto & thread : threads)
+      thread.join();
+
+    for (const auto & error : errors)
+      if(error)
+        std::rethrow_exception(error);
+  }
+
+  for (const auto & fm : replicas)
+    fm->template postEvaluate<EvalT>(NULL);
+}
+
+//===========================================================================
+//===========================================================================
+template <typename EvalT>
+void panzer::AssemblyEngine<EvalT>::
+setWorksetParameters(panzer::Workset & workset,const panzer::AssemblyEngineInArgs& in)
+{
+  workset.alpha = in.alpha;
+  workset.beta = in.beta;
+  workset.time = in.time;
+  workset.step_size = in.step_size;
+  workset.stage_number = in.stage_number;
+  workset.gather_seeds = in.gather_seeds;
+  workset.evaluate_transient_terms = in.evaluate_transient_terms;
+}
+
+//===========================================================================
+//===========================================================================
+template <typename EvalT>
+void panzer::AssemblyEngine<EvalT>::
+endGhostExchange(const panzer::AssemblyEngineInArgs& in)
+{
+  typedef LinearObjContainer LOC;
+
+  if(!ghostExchangePending_)
+    return;
+
+  PANZER_FUNC_TIME_MONITOR_DIFF("panzer::AssemblyEngine::endGhostExchange("+PHX::print<EvalT>()+")", end_ghost_exchange);
+
+  // the gather containers are the data objects of the arguments, those
+  // without a split exchange were already imported when it was posted
+  GlobalEvaluationDataContainer gedc;
+  in.fillGlobalEvaluationDataContainer(gedc);
+  gedc.endGlobalToGhost(LOC::X | LOC::DxDt);
+
+  m_lin_obj_factory->endGlobalToGhostContainer(*in.container_,*in.ghostedContainer_,LOC::X | LOC::DxDt);
+  ghostExchangePending_ = false;
+}
 
 //===========================================================================
 //===========================================================================
@@ -342,23 +549,18 @@ evaluateNeumannCondition(const panzer::AssemblyEngineInArgs& in)
   for (std::size_t block = 0; block < nfm.size(); ++block) {
     const WorksetDescriptor & wd = wkstDesc[block];
     std::shared_ptr< PHX::FieldManager<panzer::Traits> > fm = nfm[block];
-    const Teuchos::RCP<panzer::Workset> workset = wkstContainer->getSideWorkset(wd);
-    TEUCHOS_TEST_FOR_EXCEPTION(workset == Teuchos::null, std::logic_error,
-                         "Failed to find corresponding bc workset!");
+    const std::size_t numChunks = wkstContainer->getSideWorksetChunks(wd)->size();
 
     fm->template preEvaluate<EvalT>(ped);
 
-    {
-      workset->alpha = in.alpha;
-      workset->beta = in.beta;
-      workset->time = in.time;
-      workset->step_size = in.step_size;
-      workset->stage_number = in.stage_number;
-      workset->gather_seeds = in.gather_seeds;
-      workset->evaluate_transient_terms = in.evaluate_transient_terms;
-	}
+    // the sideset is evaluated in chunks of at most the workset size
+    for (std::size_t chunk = 0; chunk < numChunks; ++chunk) {
+      panzer::Workset & workset = wkstContainer->getSideWorksetChunk(wd,chunk);
+      setWorksetParameters(workset,in);
+
+      fm->template evaluateFields<EvalT>(workset);
+    }
 
-    fm->template evaluateFields<EvalT>(*workset);
     fm->template postEvaluate<EvalT>(NULL);
   }
 }
@@ -370,6 +572,11 @@ evaluateResponse(const panzer::AssemblyEngineInArgs& in)
 {
   Teuchos::RCP<panzer::WorksetContainer> wkstContainer = m_field_manager_builder->getWorksetContainer2();
 
+  const Teuchos::RCP<TianXin::ResponseReduction> reduction =
+    m_field_manager_builder->template getResponseReduction<EvalT>();
+  if(reduction!=Teuchos::null)
+    reduction->initializeData();
+
   panzer::Traits::PED ped;
   ped.gedc->addDataObject("Solution Gather Container",in.ghostedContainer_);
   ped.gedc->addDataObject("Residual Scatter Container",in.ghostedContainer_);
@@ -391,19 +598,19 @@ evaluateResponse(const panzer::AssemblyEngineInArgs& in)
 
     fm->template preEvaluate<EvalT>(ped);
 
-    {
-      workset->alpha = in.alpha;
-      workset->beta = in.beta;
-      workset->time = in.time;
-      workset->step_size = in.step_size;
-      workset->stage_number = in.stage_number;
-      workset->gather_seeds = in.gather_seeds;
-      workset->evaluate_transient_terms = in.evaluate_transient_terms;
-	}
+    setWorksetParameters(*workset,in);
 
     fm->template evaluateFields<EvalT>(*workset);
     fm->template postEvaluate<EvalT>(NULL);
   }
+
+  // posted on every process, also on those without cells of any response. Only a
+  // reduction with slots posts. Nothing is left to overlap it with here, evaluate
+  // does not run the response field managers.
+  if(reduction!=Teuchos::null) {
+    reduction->beginReduction();
+    reduction->endReduction();
+  }
 }
 
 #endif
@@ -211,7 +211,7 @@ namespace panzer {
 
     mutable Array_CellBasisIP weighted_basis_scalar;                  // <Cell,BASIS,IP>
     mutable Array_CellBasisIPDim weighted_basis_vector;               // <Cell,BASIS,IP,Dim>
-    mutable Array_CellBasisIPDim weighted_grad_basis;                 // <Cell,BASIS,IP,Dim>
+    mutable Array_CellBasisIPDim weighted_grad_basis;                 // <Cell,BASIS,IP,Dim>, built by getGradBasisValues(true)
     mutable Array_CellBasisIP weighted_curl_basis_scalar;             // <Cell,BASIS,IP>
     mutable Array_CellBasisIPDim weighted_curl_basis_vector;          // <Cell,BASIS,IP,Dim>
     mutable Array_CellBasisIP weighted_div_basis;                     // <Cell,BASIS,IP>
@@ -244,8 +244,8 @@ evaluateValues(const PHX::MDField<Scalar,IP,Dim> & cub_points,
   if(elmtspace == PureBasis::HDIV or elmtspace == PureBasis::HCURL)
     getVectorBasisValues(true,true,true);
 
-  if(elmtspace == PureBasis::HGRAD and compute_derivatives)
-    getGradBasisValues(true,true,true);
+  // The weighted gradients are built on the first getGradBasisValues(true)
+  // call, sum factorized integrators never ask for them
 
   if(elmtspace == PureBasis::HCURL and compute_derivatives){
     if(num_dims == 2)
@@ -298,10 +298,9 @@ evaluateValues(const PHX::MDField<Scalar,Cell,IP,Dim> & cub_points,
     if(build_weighted) getVectorBasisValues(true,true,true);
   }
 
-  if(elmtspace == PureBasis::HGRAD and compute_derivatives){
+  // The weighted gradients are built on the first getGradBasisValues(true) call
+  if(elmtspace == PureBasis::HGRAD and compute_derivatives)
     getGradBasisValues(false,true,true);
-    if(build_weighted) getGradBasisValues(true,true,true);
-  }
 
   if(elmtspace == PureBasis::HCURL and compute_derivatives){
     if(num_dims == 2){
@@ -397,7 +396,7 @@ applyOrientations(const std::vector<Intrepid2::Orientation> & orientations,
     applyOrientationsImpl<Scalar>(num_cells, basis_scalar.get_view(), device_orientations, *intrepid_basis);
     if(build_weighted) applyOrientationsImpl<Scalar>(num_cells, weighted_basis_scalar.get_view(), device_orientations, *intrepid_basis);
     if(compute_derivatives) applyOrientationsImpl<Scalar>(num_cells, grad_basis.get_view(), device_orientations, *intrepid_basis);
-    if(compute_derivatives and build_weighted) applyOrientationsImpl<Scalar>(num_cells, weighted_grad_basis.get_view(), device_orientations, *intrepid_basis);
+    if(compute_derivatives and build_weighted and weighted_grad_basis_evaluated_) applyOrientationsImpl<Scalar>(num_cells, weighted_grad_basis.get_view(), device_orientations, *intrepid_basis);
   }
 
   if(elmtspace == PureBasis::HCURL){
@@ -479,8 +478,7 @@ setupArrays(const Teuchos::RCP<const panzer::BasisIRLayout>& layout,
        grad_basis_ref = af.buildStaticArray<Scalar,BASIS,IP,Dim>("grad_basis_ref",card,num_quad,dim); // F, P, D
        grad_basis = af.buildStaticArray<Scalar,Cell,BASIS,IP,Dim>("grad_basis",numcells,card,num_quad,dim);
 
-       if(build_weighted)
-         weighted_grad_basis = af.buildStaticArray<Scalar,Cell,BASIS,IP,Dim>("weighted_grad_basis",numcells,card,num_quad,dim);
+       // weighted_grad_basis is allocated on the first getGradBasisValues(true) call
      }
 
      // build curl
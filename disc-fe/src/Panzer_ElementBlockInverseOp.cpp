@@ -0,0 +1,233 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+
+#include "Panzer_ElementBlockInverseOp.hpp"
+
+#include "Panzer_GlobalIndexer.hpp"
+
+#include "Thyra_MultiVectorBase.hpp"
+#include "Thyra_TpetraThyraWrappers.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace panzer {
+
+namespace {
+
+/** Invert one element matrix by Gauss-Jordan elimination with partial
+  * pivoting. <code>a</code> is overwritten, false if it is singular: a pivot
+  * is no larger than n*epsilon times the largest magnitude of its column in
+  * the original matrix. Runs on the host.
+  */
+template <typename MatrixT>
+bool invertElementMatrix(const MatrixT & a,const MatrixT & inv)
+{
+  const int n = a.extent(0);
+  const double tolerance = n*std::numeric_limits<double>::epsilon();
+  std::vector<double> columnMax(n,0.0);
+  for(int i=0;i<n;i++) {
+    for(int j=0;j<n;j++) {
+      inv(i,j) = (i==j) ? 1.0 : 0.0;
+      columnMax[j] = std::max(columnMax[j],std::abs(a(i,j)));
+    }
+  }
+
+  for(int k=0;k<n;k++) {
+    int p = k;
+    for(int r=k+1;r<n;r++)
+      if(std::abs(a(r,k))>std::abs(a(p,k)))
+        p = r;
+    if(std::abs(a(p,k))<=tolerance*columnMax[k])
+      return false;
+
+    if(p!=k) {
+      for(int j=0;j<n;j++) {
+        std::swap(a(p,j),a(k,j));
+        std::swap(inv(p,j),inv(k,j));
+      }
+    }
+
+    const double d = 1.0/a(k,k);
+    for(int j=0;j<n;j++) {
+      a(k,j) *= d;
+      inv(k,j) *= d;
+    }
+
+    for(int r=0;r<n;r++) {
+      const double f = a(r,k);
+      if(r==k || f==0.0)
+        continue;
+      for(int j=0;j<n;j++) {
+        a(r,j) -= f*a(k,j);
+        inv(r,j) -= f*inv(k,j);
+      }
+    }
+  }
+
+  return true;
+}
+
+// y(lids(c,:)) = inverses(c,:,:)*x(lids(c,:)) for every cell, each dof belongs to one cell
+void applyElementInverses(const ElementMatrices_GlobalEvaluationData::MatrixView & inverses,
+                          const Kokkos::View<panzer::LocalOrdinal**,PHX::Device> & lids,
+                          const Kokkos::View<const double**,Kokkos::LayoutLeft,PHX::Device> & x,
+                          const Kokkos::View<double**,Kokkos::LayoutLeft,PHX::Device> & y)
+{
+  const int numDofs = inverses.extent(1);
+  Kokkos::parallel_for("ElementBlockInverseOp::apply",inverses.extent(0),KOKKOS_LAMBDA (const int c) {
+    for(int i=0;i<numDofs;i++) {
+      double sum = 0.0;
+      for(int j=0;j<numDofs;j++)
+        sum += inverses(c,i,j)*x(lids(c,j),0);
+      y(lids(c,i),0) = sum;
+    }
+  });
+}
+
+}
+
+ElementBlockInverseOp::
+ElementBlockInverseOp(const ElementMatrices_GlobalEvaluationData & matrices,
+                      const Teuchos::RCP<const LinearObjFactory<panzer::Traits> > & lof)
+{
+  typedef Kokkos::DefaultHostExecutionSpace HostSpace;
+
+  lof_ = Teuchos::rcp_dynamic_cast<const TpetraLOF>(lof,true);
+  range_ = lof_->getThyraRangeSpace();
+  domain_ = lof_->getThyraDomainSpace();
+
+  const GlobalIndexer & indexer = *matrices.getGlobalIndexer();
+  const auto hostLIDs = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),indexer.getLIDs());
+
+  // the inverse is only block diagonal if every dof lives in a single element
+  std::vector<int> dofCells(lof_->getGhostedMap()->getLocalNumElements(),0);
+
+  std::vector<std::string> blockIds;
+  indexer.getElementBlockIds(blockIds);
+  for(const auto & blockId : blockIds) {
+    const std::vector<panzer::LocalOrdinal> & cells = indexer.getElementBlock(blockId);
+    const int numDofs = indexer.getElementBlockGIDCount(blockId);
+
+    Block block;
+    block.lids = Kokkos::View<panzer::LocalOrdinal**,PHX::Device>("lids",cells.size(),numDofs);
+    block.inverses = ElementMatrices_GlobalEvaluationData::MatrixView("inverses",cells.size(),numDofs,numDofs);
+
+    auto lids = Kokkos::create_mirror_view(block.lids);
+    for(std::size_t c=0;c<cells.size();c++) {
+      for(int i=0;i<numDofs;i++) {
+        lids(c,i) = hostLIDs(cells[c],i);
+        TEUCHOS_TEST_FOR_EXCEPTION(++dofCells[lids(c,i)]>1,std::logic_error,
+                                   "ElementBlockInverseOp: a dof of element block \"" << blockId << "\" is shared by "
+                                   "several elements, the block diagonal inverse requires element local (discontinuous) dofs");
+      }
+    }
+    Kokkos::deep_copy(block.lids,lids);
+
+    // invert on the host, the matrices are copied since elimination overwrites them
+    const ElementMatrices_GlobalEvaluationData::MatrixView elementMatrices = matrices.getMatrices(blockId);
+    ElementMatrices_GlobalEvaluationData::MatrixView::HostMirror a("a",cells.size(),numDofs,numDofs);
+    Kokkos::deep_copy(a,elementMatrices);
+    auto inverses = Kokkos::create_mirror_view(block.inverses);
+    int numSingular = 0;
+    Kokkos::parallel_reduce(Kokkos::RangePolicy<HostSpace>(0,cells.size()),[&] (const int c,int & singular) {
+      if(!invertElementMatrix(Kokkos::subview(a,c,Kokkos::ALL(),Kokkos::ALL()),
+                              Kokkos::subview(inverses,c,Kokkos::ALL(),Kokkos::ALL())))
+        singular++;
+    },numSingular);
+    TEUCHOS_TEST_FOR_EXCEPTION(numSingular>0,std::runtime_error,
+                               "ElementBlockInverseOp: " << numSingular << " singular element matrices in element block \""
+                               << blockId << "\"");
+    Kokkos::deep_copy(block.inverses,inverses);
+
+    blocks_[blockId] = block;
+  }
+}
+
+bool ElementBlockInverseOp::
+opSupportedImpl(Thyra::EOpTransp M_trans) const
+{
+  return M_trans==Thyra::NOTRANS;
+}
+
+void ElementBlockInverseOp::
+applyImpl(const Thyra::EOpTransp M_trans,
+          const Thyra::MultiVectorBase<double> & X,
+          const Teuchos::Ptr<Thyra::MultiVectorBase<double> > & Y,
+          const double alpha,
+          const double beta) const
+{
+  typedef Thyra::TpetraOperatorVectorExtraction<double,panzer::LocalOrdinal,panzer::GlobalOrdinal,panzer::TpetraNodeType> TOE;
+
+  TEUCHOS_TEST_FOR_EXCEPTION(M_trans!=Thyra::NOTRANS,std::logic_error,
+                             "ElementBlockInverseOp: only the non-transposed operator is available");
+
+  if(ghostedX_==Teuchos::null) {
+    ghostedX_ = lof_->getGhostedTpetraVector();
+    ghostedY_ = lof_->getGhostedTpetraVector();
+    result_ = lof_->getTpetraVector();
+  }
+
+  for(Thyra::Ordinal j=0;j<X.domain()->dim();j++) {
+    ghostedX_->doImport(*TOE::getConstTpetraVector(X.col(j)),*lof_->getGhostedImport(),Tpetra::INSERT);
+    ghostedY_->putScalar(0.0);
+
+    {
+      auto x = ghostedX_->getLocalViewDevice(Tpetra::Access::ReadOnly);
+      auto y = ghostedY_->getLocalViewDevice(Tpetra::Access::ReadWrite);
+      for(const auto & block : blocks_)
+        applyElementInverses(block.second.inverses,block.second.lids,x,y);
+    }
+
+    result_->putScalar(0.0);
+    result_->doExport(*ghostedY_,*lof_->getGhostedExport(),Tpetra::ADD);
+
+    // Y = alpha*inv(M)*X + beta*Y, where Y is not read when beta is zero
+    TOE::getTpetraVector(Y->col(j))->update(alpha,*result_,beta);
+  }
+}
+
+}
@@ -0,0 +1,121 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+
+#ifndef PANZER_ELEMENT_BLOCK_INVERSE_OP_HPP
+#define PANZER_ELEMENT_BLOCK_INVERSE_OP_HPP
+
+#include "PanzerDiscFE_config.hpp"
+
+#include "Teuchos_RCP.hpp"
+
+#include "Thyra_LinearOpDefaultBase.hpp"
+
+#include "Panzer_Traits.hpp"
+#include "Panzer_LinearObjFactory.hpp"
+#include "Panzer_TpetraLinearObjFactory.hpp"
+#include "Panzer_ElementMatrices_GlobalEvaluationData.hpp"
+
+#include <map>
+
+namespace panzer {
+
+/** Inverse of a block diagonal operator whose blocks are the element matrices,
+  * as for the mass matrix of a discontinuous (DG-like) discretization. Each
+  * element matrix is inverted once at construction; applying the operator
+  * gathers the element dofs of v, multiplies by the element inverse and writes
+  * the result back. No global matrix is formed and no linear solve is done.
+  *
+  * The inverse is exact only if no dof is shared between elements, which is
+  * checked at construction. Only Tpetra linear object factories are supported.
+  */
+class ElementBlockInverseOp : public Thyra::LinearOpDefaultBase<double> {
+public:
+
+  /** Invert the element matrices.
+    *
+    * \param[in] matrices Element matrices, filled by a Jacobian evaluation
+    * \param[in] lof Linear object factory of the global indexer of <code>matrices</code>
+    */
+  ElementBlockInverseOp(const ElementMatrices_GlobalEvaluationData & matrices,
+                        const Teuchos::RCP<const LinearObjFactory<panzer::Traits> > & lof);
+
+  Teuchos::RCP<const Thyra::VectorSpaceBase<double> > range() const override
+  { return range_; }
+
+  Teuchos::RCP<const Thyra::VectorSpaceBase<double> > domain() const override
+  { return domain_; }
+
+protected:
+
+  bool opSupportedImpl(Thyra::EOpTransp M_trans) const override;
+
+  void applyImpl(const Thyra::EOpTransp M_trans,
+                 const Thyra::MultiVectorBase<double> & X,
+                 const Teuchos::Ptr<Thyra::MultiVectorBase<double> > & Y,
+                 const double alpha,
+                 const double beta) const override;
+
+private:
+
+  ElementBlockInverseOp();
+
+  typedef TpetraLinearObjFactory<panzer::Traits,double,panzer::LocalOrdinal,panzer::GlobalOrdinal> TpetraLOF;
+  typedef TpetraLOF::VectorType VectorType;
+
+  struct Block {
+    ElementMatrices_GlobalEvaluationData::MatrixView inverses; // (cell, row, column)
+    Kokkos::View<panzer::LocalOrdinal**,PHX::Device> lids;      // ghosted local ids of the element dofs
+  };
+
+  Teuchos::RCP<const TpetraLOF> lof_;
+  std::map<std::string,Block> blocks_;
+
+  Teuchos::RCP<const Thyra::VectorSpaceBase<double> > range_, domain_;
+
+  // ghosted work vectors, kept so repeated applies do not reallocate
+  mutable Teuchos::RCP<VectorType> ghostedX_, ghostedY_, result_;
+};
+
+}
+
+#endif
@@ -0,0 +1,110 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#include "Panzer_ElementMatrices_GlobalEvaluationData.hpp"
+
+#include "Panzer_GlobalIndexer.hpp"
+
+#include "Teuchos_Assert.hpp"
+
+#include <algorithm>
+
+namespace panzer {
+
+ElementMatrices_GlobalEvaluationData::
+ElementMatrices_GlobalEvaluationData(const Teuchos::RCP<const GlobalIndexer> & indexer)
+  : indexer_(indexer)
+{
+  TEUCHOS_ASSERT(indexer_!=Teuchos::null);
+
+  std::vector<std::string> blockIds;
+  indexer_->getElementBlockIds(blockIds);
+
+  std::size_t numCells = 0;
+  for(const auto & blockId : blockIds) {
+    const std::vector<panzer::LocalOrdinal> & cells = indexer_->getElementBlock(blockId);
+    if(!cells.empty())
+      numCells = std::max(numCells,static_cast<std::size_t>(*std::max_element(cells.begin(),cells.end()))+1);
+  }
+
+  cellPositions_ = Kokkos::View<int*,PHX::Device>("cellPositions",numCells);
+  auto positions = Kokkos::create_mirror_view(cellPositions_);
+  Kokkos::deep_copy(positions,-1);
+
+  for(const auto & blockId : blockIds) {
+    const std::vector<panzer::LocalOrdinal> & cells = indexer_->getElementBlock(blockId);
+    for(std::size_t i=0;i<cells.size();i++)
+      positions(cells[i]) = static_cast<int>(i);
+
+    const int numDofs = indexer_->getElementBlockGIDCount(blockId);
+    matrices_[blockId] = MatrixView("elementMatrices",cells.size(),numDofs,numDofs);
+  }
+  Kokkos::deep_copy(cellPositions_,positions);
+}
+
+void ElementMatrices_GlobalEvaluationData::
+initializeData()
+{
+  for(auto & matrices : matrices_)
+    Kokkos::deep_copy(matrices.second,0.0);
+}
+
+ElementMatrices_GlobalEvaluationData::MatrixView
+ElementMatrices_GlobalEvaluationData::
+getMatrices(const std::string & blockId) const
+{
+  auto itr = matrices_.find(blockId);
+  TEUCHOS_TEST_FOR_EXCEPTION(itr==matrices_.end(),std::logic_error,
+                             "ElementMatrices_GlobalEvaluationData: unknown element block \"" << blockId << "\"");
+  return itr->second;
+}
+
+void ElementMatrices_GlobalEvaluationData::
+print(std::ostream & os) const
+{
+  os << "ElementMatrices_GlobalEvaluationData:" << std::endl;
+  for(const auto & matrices : matrices_)
+    os << "   block \"" << matrices.first << "\": " << matrices.second.extent(0) << " cells, "
+       << matrices.second.extent(1) << " dofs" << std::endl;
+}
+
+}
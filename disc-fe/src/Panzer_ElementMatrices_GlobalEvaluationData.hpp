@@ -0,0 +1,96 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#ifndef __Panzer_ElementMatrices_GlobalEvaluationData_hpp__
+#define __Panzer_ElementMatrices_GlobalEvaluationData_hpp__
+
+#include "PanzerDiscFE_config.hpp"
+#include "Panzer_Traits.hpp"
+#include "Panzer_GlobalEvaluationData.hpp"
+
+#include "Teuchos_RCP.hpp"
+
+#include <map>
+#include <string>
+
+namespace panzer {
+
+class GlobalIndexer;
+
+/** Dense element Jacobians of every local cell, kept per element block. The
+  * Jacobian scatter fills them in place of the global matrix when this object
+  * is registered as the "Element Jacobian Container". Rows and columns are the
+  * element dof offsets of the global indexer. No communication is required.
+  */
+class ElementMatrices_GlobalEvaluationData : public GlobalEvaluationData_Default {
+public:
+   //! Element matrices of a block, (cell position in block, row, column)
+   typedef Kokkos::View<double***,PHX::Device> MatrixView;
+
+   ElementMatrices_GlobalEvaluationData(const Teuchos::RCP<const GlobalIndexer> & indexer);
+
+   //! Zero all element matrices
+   virtual void initializeData();
+
+   const Teuchos::RCP<const GlobalIndexer> & getGlobalIndexer() const
+   { return indexer_; }
+
+   /** Element matrices of a block, the cells are in the order of
+     * <code>GlobalIndexer::getElementBlock(blockId)</code>.
+     */
+   MatrixView getMatrices(const std::string & blockId) const;
+
+   //! Position of each local cell within its element block
+   Kokkos::View<const int*,PHX::Device> getCellPositions() const
+   { return cellPositions_; }
+
+   virtual void print(std::ostream & os) const;
+
+private:
+   Teuchos::RCP<const GlobalIndexer> indexer_;
+   std::map<std::string,MatrixView> matrices_;
+   Kokkos::View<int*,PHX::Device> cellPositions_;
+};
+
+}
+
+#endif
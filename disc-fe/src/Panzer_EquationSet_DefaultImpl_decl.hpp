@@ -269,6 +269,21 @@ namespace panzer {
       */
 	void addDOFDotDot(const std::string & dofName, const std::string & dotName = "");
 
+    /** Alert the panzer library that an element matrix evaluated by an
+      * Integrator_LinearOperator is to be summed into the Jacobian rows
+      * of the residual associated with a DOF, next to its AD derivatives.
+      *
+      * \param[in] dofName (Required) Name of field to lookup in the unique global indexer. 
+      * \param[in] matrixName (Required) Name of the element matrix field.
+      * \param[in] columnDofName (Optional) Name of the DOF the integrator is applied to
+      *                          (its "DOF Name", or the DOF of its time derivative). It
+      *                          gives the Jacobian columns and must share the basis of
+      *                          dofName. If not supplied or an empty string used, it is dofName.
+      */
+    void addLinearElementMatrix(const std::string & dofName,
+                                const std::string & matrixName,
+                                const std::string & columnDofName = "");
+
     /** Alert the panzer to the fact that a set of DOFs coorespond to coordinates.
       * They may have to be handled differently.
       *
@@ -371,6 +386,7 @@ namespace panzer {
       std::pair<bool,std::string> div;
       std::pair<bool,std::string> timeDerivative;
 	  std::pair<bool,std::string> xdotdot;
+      std::vector<std::pair<std::string,std::string> > linearElementMatrices; // (matrix, column DOF)
 
       void print(std::ostream & os) const {
         os << "DOF Desc = \"" << dofName << "\": "
@@ -46,6 +46,7 @@
 #include "Panzer_DOF.hpp"
 #include "Panzer_DOF_PointValues.hpp"
 #include "Panzer_DOFGradient.hpp"
+#include "Panzer_DOFGradient_SumFactorized.hpp"
 #include "Panzer_DOFCurl.hpp"
 #include "Panzer_DOFDiv.hpp"
 #include "Panzer_GatherBasisCoordinates.hpp"
@@ -364,12 +365,17 @@ buildAndRegisterDOFProjectionsToIPEvaluators(PHX::FieldManager<panzer::Traits>&
                                              const panzer::FieldLayoutLibrary& fl,
                                              const Teuchos::RCP<panzer::IntegrationRule>& ir,
                                              const Teuchos::Ptr<const panzer::LinearObjFactory<panzer::Traits> > & lof,
-                                             const Teuchos::ParameterList& /* user_data */) const
+                                             const Teuchos::ParameterList& user_data) const
 {
   using Teuchos::ParameterList;
   using Teuchos::RCP;
   using Teuchos::rcp;
 
+  // interpolate gradients of tensor-product HGrad bases by sum factorization
+  bool sumFactorization = false;
+  if(user_data.isParameter("Sum Factorization"))
+    sumFactorization = user_data.get<bool>("Sum Factorization");
+
   Teuchos::RCP<const panzer::GlobalIndexer> globalIndexer;
   if(lof!=Teuchos::null) 
     globalIndexer = lof->getRangeGlobalIndexer();
@@ -417,8 +423,12 @@ buildAndRegisterDOFProjectionsToIPEvaluators(PHX::FieldManager<panzer::Traits>&
       p.set("Basis", fl.lookupLayout(dof_name)); 
       p.set("IR", ir);
       
-      RCP< PHX::Evaluator<panzer::Traits> > op = 
-        rcp(new panzer::DOFGradient<EvalT,panzer::Traits>(p));
+      // other bases and rules keep the expanded gradient arrays
+      RCP< PHX::Evaluator<panzer::Traits> > op;
+      if(sumFactorization && TensorProductBasis::isSupported(itr->second.basis->type(),*ir))
+        op = rcp(new panzer::DOFGradient_SumFactorized<EvalT,panzer::Traits>(p));
+      else
+        op = rcp(new panzer::DOFGradient<EvalT,panzer::Traits>(p));
 
       this->template registerEvaluator<EvalT>(fm, op);
     }
@@ -587,6 +597,11 @@ buildAndRegisterScatterEvaluators(PHX::FieldManager<panzer::Traits>& fm,
   bool ignoreScatter = false;
   if(user_data.isParameter("Ignore Scatter")) 
     ignoreScatter = user_data.get<bool>("Ignore Scatter");
+
+  // resolve the Jacobian CRS offsets once per workset instead of searching rows
+  bool precomputeOffsets = false;
+  if(user_data.isParameter("Precompute Jacobian Offsets")) 
+    precomputeOffsets = user_data.get<bool>("Precompute Jacobian Offsets");
   
   if(!ignoreScatter) {
     
@@ -608,6 +623,13 @@ buildAndRegisterScatterEvaluators(PHX::FieldManager<panzer::Traits>& fm,
         p.set("Basis", itr->second.basis.getConst());
         p.set("Dependent Names", residual_names);
         p.set("Dependent Map", names_map);
+        p.set("Precompute Jacobian Offsets", precomputeOffsets);
+        if(itr->second.linearElementMatrices.size()>0) {
+          RCP<std::map<std::string,std::vector<std::pair<std::string,std::string> > > > linear_matrices
+              = rcp(new std::map<std::string,std::vector<std::pair<std::string,std::string> > >);
+          (*linear_matrices)[itr->second.residualName.second] = itr->second.linearElementMatrices;
+          p.set("Linear Element Matrices", linear_matrices.getConst());
+        }
         
         RCP< PHX::Evaluator<panzer::Traits> > op = lof.buildScatter<EvalT>(p);
         
@@ -958,6 +980,35 @@ addDOFTimeDerivative(const std::string & dofName,
     desc.timeDerivative = std::make_pair(true,dotName);
 }
 
+// ***********************************************************************
+template <typename EvalT>
+void panzer::EquationSet_DefaultImpl<EvalT>::
+addLinearElementMatrix(const std::string & dofName,
+                       const std::string & matrixName,
+                       const std::string & columnDofName)
+{
+  typename std::map<std::string,DOFDescriptor>::iterator itr = m_provided_dofs_desc.find(dofName);
+
+  TEUCHOS_TEST_FOR_EXCEPTION(itr==m_provided_dofs_desc.end(),std::runtime_error,
+                             "EquationSet_DefaultImpl::addLinearElementMatrix: DOF \"" << dofName << "\" has not been specified as a DOF "
+                             "by derived equation set \"" << this->getType() << "\".");
+
+  const std::string colName = columnDofName=="" ? dofName : columnDofName;
+  typename std::map<std::string,DOFDescriptor>::const_iterator colItr = m_provided_dofs_desc.find(colName);
+
+  TEUCHOS_TEST_FOR_EXCEPTION(colItr==m_provided_dofs_desc.end(),std::runtime_error,
+                             "EquationSet_DefaultImpl::addLinearElementMatrix: column DOF \"" << colName << "\" has not been specified as a DOF "
+                             "by derived equation set \"" << this->getType() << "\".");
+
+  // the element matrix is square on one basis
+  TEUCHOS_TEST_FOR_EXCEPTION(colItr->second.basisType!=itr->second.basisType || colItr->second.basisOrder!=itr->second.basisOrder,
+                             std::runtime_error,
+                             "EquationSet_DefaultImpl::addLinearElementMatrix: column DOF \"" << colName << "\" of matrix \"" << matrixName << "\" "
+                             "does not share the basis of DOF \"" << dofName << "\" in equation set \"" << this->getType() << "\".");
+
+  itr->second.linearElementMatrices.push_back(std::make_pair(matrixName,colName));
+}
+
 // ***********************************************************************
 template <typename EvalT>
 void panzer::EquationSet_DefaultImpl<EvalT>::
@@ -67,11 +67,20 @@ public:
 
   /** Take in a Thyra model evaluator and then turn it into an explicit model evaluator. Assume the
     * mass matrix is constant unless the user specifies otherwise.
+    *
+    * With <code>useElementLocalLumpedMass</code> (and <code>useLumpedMass</code>) the lumped
+    * mass is summed from the element mass matrices of the underlying panzer::ModelEvaluator
+    * without assembling a global matrix. With <code>useElementBlockInverseMass</code> the element
+    * mass matrices are inverted one by one instead, which is the exact inverse for
+    * discretizations without shared dofs (DG-like). Both need the underlying model to be (or
+    * wrap) a panzer::ModelEvaluator with a Tpetra linear object factory.
     */
   ExplicitModelEvaluator(const Teuchos::RCP<Thyra::ModelEvaluator<Scalar> > & model,
                          bool constantMassMatrix,
                          bool useLumpedMass,
-                         bool applyMassInverse=true);
+                         bool applyMassInverse=true,
+                         bool useElementBlockInverseMass=false,
+                         bool useElementLocalLumpedMass=false);
 
   //@}
 
@@ -130,12 +139,23 @@ private: // data members
     */
   void setOneTimeDirichletBeta(double beta,const Thyra::ModelEvaluator<Scalar> & me) const;
 
+  /** Find the panzer::ModelEvaluator under a hierarchy of delegators, the same
+    * way <code>setOneTimeDirichletBeta</code> does. Returns null if there is none.
+    */
+  Teuchos::Ptr<const panzer::ModelEvaluator<Scalar> > getPanzerModel(const Thyra::ModelEvaluator<Scalar> & me) const;
+
   //! Is the mass matrix constant
   bool constantMassMatrix_;
 
   //! Use mass lumping, or a full solve
   bool massLumping_;
 
+  //! Invert the element mass matrices rather than solving with the global one
+  bool massElementBlockInverse_;
+
+  //! Sum the lumped mass from the element mass matrices rather than the global one
+  bool massElementLocalLumping_;
+
   //! Access to the panzer model evaluator pointer (thyra version)
   Teuchos::RCP<const panzer::ModelEvaluator<Scalar> > panzerModel_;
 
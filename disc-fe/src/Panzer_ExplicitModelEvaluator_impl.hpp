@@ -47,6 +47,9 @@
 #include "Thyra_DefaultDiagonalLinearOp.hpp"
 #include "Thyra_LinearOpWithSolveFactoryBase.hpp"
 
+#include "Panzer_MatrixFreeJacobianOp.hpp"
+#include "Panzer_TpetraLinearObjFactory.hpp"
+
 #include "Thyra_get_Epetra_Operator.hpp"
 #include "EpetraExt_RowMatrixOut.h"
 
@@ -57,10 +60,14 @@ ExplicitModelEvaluator<Scalar>::
 ExplicitModelEvaluator(const Teuchos::RCP<Thyra::ModelEvaluator<Scalar> > & model,
                        bool constantMassMatrix,
                        bool useLumpedMass,
-                       bool applyMassInverse)
+                       bool applyMassInverse,
+                       bool useElementBlockInverseMass,
+                       bool useElementLocalLumpedMass)
    : Thyra::ModelEvaluatorDelegatorBase<Scalar>(model)
    , constantMassMatrix_(constantMassMatrix)
    , massLumping_(useLumpedMass)
+   , massElementBlockInverse_(useElementBlockInverseMass)
+   , massElementLocalLumping_(useElementLocalLumpedMass)
 {
   using Teuchos::RCP;
   using Teuchos::rcp_dynamic_cast;
@@ -163,9 +170,6 @@ buildInverseMassMatrix(const Thyra::ModelEvaluatorBase::InArgs<Scalar> &inArgs)
   
   RCP<const Thyra::ModelEvaluator<Scalar> > me = this->getUnderlyingModel();
 
-  // first allocate space for the mass matrix
-  mass_ = me->create_W_op();
-
   // intialize a zero to get rid of the x-dot 
   if(zero_==Teuchos::null) {
     zero_ = Thyra::createMember(*me->get_x_space());
@@ -180,6 +184,38 @@ buildInverseMassMatrix(const Thyra::ModelEvaluatorBase::InArgs<Scalar> &inArgs)
   inArgs_new.set_alpha(1.0);
   inArgs_new.set_beta(0.0);
 
+  // if requested, a lumped or element block inverse mass comes straight from
+  // the element mass matrices of the panzer model, neither a global nor a ghosted
+  // matrix is allocated. The matrix-free fills are only scattered by the Tpetra evaluators.
+  typedef TpetraLinearObjFactory<panzer::Traits,double,panzer::LocalOrdinal,panzer::GlobalOrdinal> TpetraLOF;
+  Teuchos::Ptr<const panzer::ModelEvaluator<Scalar> > panzerModel = getPanzerModel(*me);
+  bool elementLocalMass = panzerModel!=Teuchos::null
+                       && Teuchos::rcp_dynamic_cast<const TpetraLOF>(panzerModel->getLinearObjFactory())!=Teuchos::null;
+  bool elementLocalLumping = massLumping_ && massElementLocalLumping_;
+  TEUCHOS_TEST_FOR_EXCEPTION((massElementBlockInverse_ || elementLocalLumping) && !elementLocalMass,std::logic_error,
+                             "panzer::ExplicitModelEvaluator: an element block inverse or element local lumped mass "
+                             "requires a panzer::ME with a Tpetra linear object factory as the underlying (or a "
+                             "delegated) model.");
+  if(elementLocalLumping || massElementBlockInverse_) {
+    RCP<panzer::MatrixFreeJacobianOp> op
+        = Teuchos::rcp_dynamic_cast<panzer::MatrixFreeJacobianOp>(panzerModel->create_matrix_free_W_op(inArgs_new),true);
+    mass_ = op; // applyMassMatrix is matrix-free as well
+
+    if(massElementBlockInverse_) {
+      invMassMatrix_ = op->buildElementBlockInverse();
+    }
+    else {
+      RCP<Thyra::VectorBase<Scalar> > invLumpMass = op->getRowSums();
+      Thyra::reciprocal(*invLumpMass,invLumpMass.ptr());
+
+      invMassMatrix_ = Thyra::diagonal(invLumpMass);
+    }
+    return;
+  }
+
+  // first allocate space for the mass matrix
+  mass_ = me->create_W_op();
+
   // set the one time beta to ensure dirichlet conditions
   // are correctly included in the mass matrix: do it for
   // both epetra and Tpetra. 
@@ -266,6 +302,26 @@ setOneTimeDirichletBeta(double beta,const Thyra::ModelEvaluator<Scalar> & me) co
                              "The deepest model is also not a delegator. Thus the recursion failed and an exception was generated.");
 }
 
+template<typename Scalar>
+Teuchos::Ptr<const panzer::ModelEvaluator<Scalar> > ExplicitModelEvaluator<Scalar>::
+getPanzerModel(const Thyra::ModelEvaluator<Scalar> & me) const
+{
+  using Teuchos::Ptr;
+  using Teuchos::ptrFromRef;
+  using Teuchos::ptr_dynamic_cast;
+
+  Ptr<const panzer::ModelEvaluator<Scalar> > panzerModel = ptr_dynamic_cast<const panzer::ModelEvaluator<Scalar> >(ptrFromRef(me));
+  if(panzerModel!=Teuchos::null)
+    return panzerModel;
+
+  Ptr<const Thyra::ModelEvaluatorDelegatorBase<Scalar> > delegator
+      = ptr_dynamic_cast<const Thyra::ModelEvaluatorDelegatorBase<Scalar> >(ptrFromRef(me));
+  if(delegator!=Teuchos::null)
+    return getPanzerModel(*delegator->getUnderlyingModel());
+
+  return Teuchos::null;
+}
+
 } // end namespace panzer
 
 #endif
@@ -44,6 +44,9 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <algorithm>
+#include <thread>
+#include <type_traits>
 
 #include "Panzer_FieldManagerBuilder.hpp"
 
@@ -51,6 +54,11 @@
 #include "Phalanx_FieldManager.hpp"
 
 #include "Teuchos_FancyOStream.hpp"
+#ifdef HAVE_MPI
+#include "Teuchos_DefaultMpiComm.hpp"
+#else
+#include "Teuchos_DefaultSerialComm.hpp"
+#endif
 
 #include "Shards_CellTopology.hpp"
 
@@ -81,9 +89,40 @@ FieldManagerBuilder(bool disablePhysicsBlockScatter,
                     bool disablePhysicsBlockGather)
   : disablePhysicsBlockScatter_(disablePhysicsBlockScatter)
   , disablePhysicsBlockGather_(disablePhysicsBlockGather)
+  , concurrentVolumeAssembly_(false)
+  , maxVolumeWorkers_(1)
+  , overlapGhostExchange_(false)
   , active_evaluation_types_(Sacado::mpl::size<panzer::Traits::EvalTypes>::value, true)
 {}
 
+//=======================================================================
+bool panzer::FieldManagerBuilder::concurrentVolumeAssemblySupported()
+{
+  // older releases don't guard the Serial instance's scratch and reduction
+  // buffers against launches from several threads
+#if defined(KOKKOS_ENABLE_SERIAL) && KOKKOS_VERSION >= 40200
+  return std::is_same<PHX::exec_space,Kokkos::Serial>::value;
+#else
+  return false;
+#endif
+}
+
+//=======================================================================
+void panzer::FieldManagerBuilder::setConcurrentVolumeAssembly(bool flag,int maxWorkers)
+{
+  if(flag && !concurrentVolumeAssemblySupported()) {
+    Teuchos::FancyOStream fout(Teuchos::rcpFromRef(std::cout));
+    fout.setOutputToRootOnly(0);
+
+    fout << "Panzer Warning: Concurrent volume assembly requires the Kokkos Serial "
+         << "execution space of Kokkos 4.2 or later, it stays off for " << PHX::exec_space::name()
+         << " (Kokkos " << KOKKOS_VERSION << ")." << std::endl;
+  }
+
+  concurrentVolumeAssembly_ = flag && concurrentVolumeAssemblySupported();
+  maxVolumeWorkers_ = maxWorkers;
+}
+
 //=======================================================================
 namespace {
   struct PostRegistrationFunctor {
@@ -106,6 +145,51 @@ namespace {
   };
 }
 
+//=======================================================================
+Teuchos::RCP<PHX::FieldManager<panzer::Traits> >
+panzer::FieldManagerBuilder::buildVolumeFieldManager(panzer::PhysicsBlock & pb,
+                                                     const WorksetDescriptor & wd,
+                                                     const panzer::ClosureModelFactory_TemplateManager<panzer::Traits>& cm_factory,
+                                                     const Teuchos::ParameterList& closure_models,
+                                                     const panzer::LinearObjFactory<panzer::Traits> & lo_factory,
+                                                     const Teuchos::ParameterList& user_data,
+                                                     const GenericEvaluatorFactory & gEvalFact,
+                                                     bool closureModelByEBlock,
+                                                     Traits::SD & setupData) const
+{
+  Teuchos::RCP<PHX::FieldManager<panzer::Traits> > fm
+        = Teuchos::rcp(new PHX::FieldManager<panzer::Traits>);
+
+  // use the physics block to register active evaluators
+  pb.setActiveEvaluationTypes(active_evaluation_types_);
+  pb.buildAndRegisterEquationSetEvaluators(*fm, user_data);
+  if(!physicsBlockGatherDisabled())
+    pb.buildAndRegisterGatherAndOrientationEvaluators(*fm,lo_factory,user_data);
+  pb.buildAndRegisterDOFProjectionsToIPEvaluators(*fm,Teuchos::ptrFromRef(lo_factory),user_data);
+  if(!physicsBlockScatterDisabled())
+    pb.buildAndRegisterScatterEvaluators(*fm,lo_factory,user_data);
+
+  if(closureModelByEBlock)
+    pb.buildAndRegisterClosureModelEvaluators(*fm,cm_factory,pb.elementBlockID(),closure_models,user_data);
+  else
+    pb.buildAndRegisterClosureModelEvaluators(*fm,cm_factory,closure_models,user_data);
+  pb.buildAndRegisterMaterialEvaluators(*fm,cm_factory);
+
+  // Reset active evaluation types
+  pb.activateAllEvaluationTypes();
+
+  // register additional model evaluator from the generic evaluator factory
+  gEvalFact.registerEvaluators(*fm,wd,pb);
+
+  // setup derivative information
+  setKokkosExtendedDataTypeDimensions(wd.getElementBlock(),*lo_factory.getRangeGlobalIndexer(),user_data,*fm);
+
+  // call postRegistrationSetup() for each active type
+  Sacado::mpl::for_each_no_kokkos<panzer::Traits::EvalTypes>(PostRegistrationFunctor(active_evaluation_types_,*fm,setupData));
+
+  return fm;
+}
+
 //=======================================================================
 void panzer::FieldManagerBuilder::setupVolumeFieldManagers(
                                             const std::vector<Teuchos::RCP<panzer::PhysicsBlock> >& physicsBlocks,
@@ -124,8 +208,13 @@ void panzer::FieldManagerBuilder::setupVolumeFieldManagers(
                             "panzer::FMB::setupVolumeFieldManagers: physics block count must match workset descriptor count.");
 
   phx_volume_field_managers_.clear();
+  phx_volume_field_manager_replicas_.clear();
 
-  Teuchos::RCP<const panzer::GlobalIndexer> globalIndexer = lo_factory.getRangeGlobalIndexer();
+  int numReplicas = 1;
+  if(concurrentVolumeAssembly_) {
+    const int hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+    numReplicas = std::max(1,std::min(maxVolumeWorkers_,hardwareThreads));
+  }
 
   for (std::size_t blkInd=0;blkInd<physicsBlocks.size();++blkInd) {
     Teuchos::RCP<panzer::PhysicsBlock> pb = physicsBlocks[blkInd];
@@ -140,40 +229,21 @@ void panzer::FieldManagerBuilder::setupVolumeFieldManagers(
     // sanity check
     TEUCHOS_ASSERT(wd.getElementBlock()==pb->elementBlockID());
 
-    // build a field manager object
-    Teuchos::RCP<PHX::FieldManager<panzer::Traits> > fm
-          = Teuchos::rcp(new PHX::FieldManager<panzer::Traits>);
-
-    // use the physics block to register active evaluators
-    pb->setActiveEvaluationTypes(active_evaluation_types_);
-    pb->buildAndRegisterEquationSetEvaluators(*fm, user_data);
-    if(!physicsBlockGatherDisabled())
-      pb->buildAndRegisterGatherAndOrientationEvaluators(*fm,lo_factory,user_data);
-    pb->buildAndRegisterDOFProjectionsToIPEvaluators(*fm,Teuchos::ptrFromRef(lo_factory),user_data);
-    if(!physicsBlockScatterDisabled())
-      pb->buildAndRegisterScatterEvaluators(*fm,lo_factory,user_data);
-
-    if(closureModelByEBlock)
-      pb->buildAndRegisterClosureModelEvaluators(*fm,cm_factory,pb->elementBlockID(),closure_models,user_data);
-    else
-      pb->buildAndRegisterClosureModelEvaluators(*fm,cm_factory,closure_models,user_data);
-    pb->buildAndRegisterMaterialEvaluators(*fm,cm_factory);
-
-    // Reset active evaluation types
-    pb->activateAllEvaluationTypes();
-
-    // register additional model evaluator from the generic evaluator factory
-    gEvalFact.registerEvaluators(*fm,wd,*pb);
-
-    // setup derivative information
-    setKokkosExtendedDataTypeDimensions(wd.getElementBlock(),*globalIndexer,user_data,*fm);
-
-    // call postRegistrationSetup() for each active type
-    Sacado::mpl::for_each_no_kokkos<panzer::Traits::EvalTypes>(PostRegistrationFunctor(active_evaluation_types_,*fm,setupData));
+    // build a field manager object, one per worker for concurrent assembly.
+    // Phalanx field managers can't be copied (each evaluator binds its fields
+    // to the memory of the manager it is registered with), so every worker
+    // registers its own evaluators. Blocks get no more copies than worksets.
+    const int blockReplicas = std::min<int>(numReplicas,setupData.worksets_->size());
+    std::vector<Teuchos::RCP<PHX::FieldManager<panzer::Traits> > > replicas(blockReplicas);
+    for (int r=0;r<blockReplicas;++r)
+      replicas[r] = buildVolumeFieldManager(*pb,wd,cm_factory,closure_models,lo_factory,user_data,
+                                            gEvalFact,closureModelByEBlock,setupData);
 
     // make sure to add the field manager & workset to the list
     volume_workset_desc_.push_back(wd);
-    phx_volume_field_managers_.push_back(fm);
+    phx_volume_field_managers_.push_back(replicas[0]);
+    if(numReplicas>1)
+      phx_volume_field_manager_replicas_.push_back(replicas);
   }
 }
 
@@ -451,8 +521,9 @@ setupNeumannFieldManagers(const Teuchos::ParameterList& pl, const Teuchos::RCP<c
           = std::shared_ptr<PHX::FieldManager<panzer::Traits>>( new PHX::FieldManager<panzer::Traits>());
 		
 		WorksetDescriptor wd(sublist);
-		const Teuchos::RCP<panzer::Workset> currentWkst = getWorksetContainer()->getSideWorkset(wd);
-		if (currentWkst.is_null()) continue;
+		// fields are sized by the first (largest) chunk of the sideset
+		if (getWorksetContainer()->getSideWorksetChunks(wd)->empty()) continue;
+		const Teuchos::RCP<panzer::Workset> currentWkst = Teuchos::rcpFromRef(getWorksetContainer()->getSideWorksetChunk(wd,0));
 		
 		const std::string element_block_id = wd.getElementBlock();
 		const auto& volume_pb_itr = physicsBlocks_map.find(element_block_id);
@@ -552,6 +623,17 @@ setupResponseFieldManagers(const Teuchos::ParameterList& pl,
 
     Teuchos::RCP<const panzer::GlobalIndexer> globalIndexer = lo_factory.getRangeGlobalIndexer();
 
+    // One slot per response and element block (or side), registered on every process
+    // from the parameter list, so the processes agree on the reduction even where
+    // they own no cells of a response.
+#ifdef HAVE_MPI
+    const Teuchos::RCP<const Teuchos::Comm<int> > reductionComm = Teuchos::rcp(new Teuchos::MpiComm<int>(lo_factory.getComm()));
+#else
+    const Teuchos::RCP<const Teuchos::Comm<int> > reductionComm = Teuchos::rcp(new Teuchos::SerialComm<int>);
+#endif
+    response_reduction_ = Teuchos::rcp(new TianXin::ResponseReduction(reductionComm));
+    response_jacobian_reduction_ = Teuchos::rcp(new TianXin::ResponseReduction(reductionComm));
+
     // for convenience build a map (element block id => physics block)
     std::map<std::string,Teuchos::RCP<panzer::PhysicsBlock> > physicsBlocks_map;
     {
@@ -585,6 +667,10 @@ setupResponseFieldManagers(const Teuchos::ParameterList& pl,
 		std::vector<TianXin::TemplatedResponse> resps;
 		std::string respname;
 		for( unsigned int i=0; i<eblocks.size(); ++i ) {
+			const std::string slotName = bc_pl->first+"/"+eblocks[i]+(notSideset ? std::string() : "/"+esides[i]);
+			response_reduction_->registerResponse(slotName,0);
+			response_jacobian_reduction_->registerResponse(slotName,0);
+
 			const auto& volume_pb_itr = physicsBlocks_map.find(eblocks[i]);
 			TEUCHOS_TEST_FOR_EXCEPTION(volume_pb_itr==physicsBlocks_map.end(),std::logic_error,
 				 "panzer::FMB::setupBCFieldManagers: Cannot find physics block corresponding to element block \"" << eblocks[i] << "\"");
@@ -598,7 +684,7 @@ setupResponseFieldManagers(const Teuchos::ParameterList& pl,
 			if( notSideset ) {
 				WorksetDescriptor wd(eblocks[i],WorksetSizeType::ALL_ELEMENTS);
 				Teuchos::RCP<std::vector<Workset> > wksts = getWorksetContainer2()->getWorksets(wd);
-				if (wksts.is_null()) continue;
+				if (wksts.is_null() || wksts->empty()) continue;
 				response_workset_desc_.push_back(wd);
 				currentWkst = Teuchos::rcpFromRef((*wksts)[0]);
 				side_pb = volume_pb;
@@ -615,6 +701,7 @@ setupResponseFieldManagers(const Teuchos::ParameterList& pl,
 
 			side_pb->buildAndRegisterEquationSetEvaluators(*fm, user_data);
 			side_pb->buildAndRegisterClosureModelEvaluatorsForType<panzer::Traits::Residual>(*fm,cm_factory,closure_models,user_data);
+			side_pb->buildAndRegisterClosureModelEvaluatorsForType<panzer::Traits::Jacobian>(*fm,cm_factory,closure_models,user_data);
 			//side_pb->buildAndRegisterClosureModelEvaluatorsForType<panzer::Traits::Tangent>(*fm,cm_factory,closure_models,user_data);
 
 			// ---- Define bais and ir -------
@@ -648,9 +735,22 @@ setupResponseFieldManagers(const Teuchos::ParameterList& pl,
 			}
 			respname = evalr->getResponseName();
 			Teuchos::RCP<TianXin::ResponseBase<panzer::Traits::Residual, panzer::Traits> > re = Teuchos::rcp(evalr.release());
+			re->setReduction(response_reduction_,slotName);
 			fm->template registerEvaluator<panzer::Traits::Residual>(re);
 			fm->requireField<panzer::Traits::Residual>(*re->evaluatedFields()[0]);
 
+			// ====== Jacobian evaluator ========
+			// its value is summed in the Jacobian reduction
+			std::unique_ptr<TianXin::ResponseBase<panzer::Traits::Jacobian, panzer::Traits>> evalj = 
+				TianXin::ResponseJacobianFactory::Instance().Create(Identifier, plist);
+			Teuchos::RCP<TianXin::ResponseBase<panzer::Traits::Jacobian, panzer::Traits> > rj;
+			if( evalj ) {
+				rj = Teuchos::rcp(evalj.release());
+				rj->setReduction(response_jacobian_reduction_,slotName);
+				fm->template registerEvaluator<panzer::Traits::Jacobian>(rj);
+				fm->requireField<panzer::Traits::Jacobian>(*rj->evaluatedFields()[0]);
+			}
+
 		// ====== Tangent evaluator =======
 		/*std::unique_ptr<TianXin::ResponseBase<panzer::Traits::Tangent, panzer::Traits>> evalj = 
 			TianXin::ResponseTangentFactory::Instance().Create(Identifier, plist);
@@ -669,6 +769,8 @@ setupResponseFieldManagers(const Teuchos::ParameterList& pl,
 			// ==== Save in container =====
 			TianXin::TemplatedResponse aresp;
 			aresp.set<panzer::Traits::Residual>( re );
+			if( rj!=Teuchos::null )
+				aresp.set<panzer::Traits::Jacobian>( rj );
 			resps.emplace_back(aresp);
 
 			// gather
@@ -691,6 +793,9 @@ setupResponseFieldManagers(const Teuchos::ParameterList& pl,
 		}
 		respContainer.emplace( respname, resps );
 	};
+
+	response_reduction_->setupSlots();
+	response_jacobian_reduction_->setupSlots();
 }
 
 //=======================================================================
@@ -860,16 +965,41 @@ writeResponseTextDependencyFiles(std::string filename_prefix) const
 
 //=======================================================================
 //=======================================================================
+namespace {
+  /** A statically sized AD type (see Panzer_FAD_MAX_DERIVATIVES) must hold the
+    * requested number of derivatives, and a fixed length one must match it exactly.
+    */
+  template <typename EvalT>
+  void checkDerivativeCapacity(const std::string & where,const std::string & evalType,
+                               const std::string & what,const int count)
+  {
+    typedef panzer::FadStaticCapacity<typename EvalT::ScalarT> Capacity;
+    TEUCHOS_TEST_FOR_EXCEPTION(Capacity::value>0 && count>Capacity::value,std::logic_error,
+                               "FieldManagerBuilder: " << where << " has " << count << " " << what
+                               << " but the " << evalType << " scalar type holds at most "
+                               << Capacity::value << " derivatives. Reconfigure with a larger Panzer_FAD_MAX_DERIVATIVES.");
+    TEUCHOS_TEST_FOR_EXCEPTION(Capacity::fixed && count!=Capacity::value,std::logic_error,
+                               "FieldManagerBuilder: " << where << " has " << count << " " << what
+                               << " but the " << evalType << " scalar type has exactly "
+                               << Capacity::value << " derivatives.");
+  }
+}
+
 void panzer::FieldManagerBuilder::
 setKokkosExtendedDataTypeDimensions(const std::string & eblock,
                                     const panzer::GlobalIndexer & globalIndexer,
                                     const Teuchos::ParameterList& user_data,
                                     PHX::FieldManager<panzer::Traits> & fm) const
 {
+  const std::string where = "Element block \"" + eblock + "\"";
+
   // setup Jacobian derivative terms
   {
+    const int gidCount = globalIndexer.getElementBlockGIDCount(eblock);
+    checkDerivativeCapacity<panzer::Traits::Jacobian>(where,"Jacobian","DOFs per element",gidCount);
+
     std::vector<PHX::index_size_type> derivative_dimensions;
-    derivative_dimensions.push_back(globalIndexer.getElementBlockGIDCount(eblock));
+    derivative_dimensions.push_back(gidCount);
 
     fm.setKokkosExtendedDataTypeDimensions<panzer::Traits::Jacobian>(derivative_dimensions);
 
@@ -877,8 +1007,11 @@ setKokkosExtendedDataTypeDimensions(const std::string & eblock,
 
   #ifdef Panzer_BUILD_HESSIAN_SUPPORT
   {
+    const int gidCount = globalIndexer.getElementBlockGIDCount(eblock);
+    checkDerivativeCapacity<panzer::Traits::Hessian>(where,"Hessian","DOFs per element",gidCount);
+
     std::vector<PHX::index_size_type> derivative_dimensions;
-    derivative_dimensions.push_back(globalIndexer.getElementBlockGIDCount(eblock));
+    derivative_dimensions.push_back(gidCount);
 
     fm.setKokkosExtendedDataTypeDimensions<panzer::Traits::Hessian>(derivative_dimensions);
   }
@@ -889,6 +1022,8 @@ setKokkosExtendedDataTypeDimensions(const std::string & eblock,
     derivative_dimensions.push_back(1);
     if (user_data.isType<int>("Tangent Dimension"))
       derivative_dimensions[0] = user_data.get<int>("Tangent Dimension");
+    checkDerivativeCapacity<panzer::Traits::Tangent>(where,"Tangent","tangent directions (\"Tangent Dimension\")",
+                                                     derivative_dimensions[0]);
     fm.setKokkosExtendedDataTypeDimensions<panzer::Traits::Tangent>(derivative_dimensions);
   }
 }
@@ -46,6 +46,7 @@
 #include <iostream>
 #include <vector>
 #include <map>
+#include <type_traits>
 #include "Teuchos_RCP.hpp"
 #include "Panzer_BC.hpp"
 #include "Panzer_LinearObjFactory.hpp"
@@ -122,6 +123,20 @@ namespace panzer {
 	const std::vector< std::shared_ptr< PHX::FieldManager<panzer::Traits> > >
     getResponseFieldManager() const { return phx_response_field_manager_; }
 
+	/** The reduction that sums the responses of <code>setupResponseFieldManagers</code>,
+	  * one for Residual and one for Jacobian evaluations. Null for evaluation types
+	  * without such responses.
+	  */
+	template <typename EvalT>
+	Teuchos::RCP<TianXin::ResponseReduction> getResponseReduction() const
+	{
+	  if(std::is_same<EvalT,panzer::Traits::Residual>::value)
+	    return response_reduction_;
+	  if(std::is_same<EvalT,panzer::Traits::Jacobian>::value)
+	    return response_jacobian_reduction_;
+	  return Teuchos::null;
+	}
+
     //! Look up field manager by an element block ID
     Teuchos::RCP< PHX::FieldManager<panzer::Traits> >
     getVolumeFieldManager(const WorksetDescriptor & wd) const
@@ -137,6 +152,43 @@ namespace panzer {
 
     const std::vector<WorksetDescriptor> &
     getVolumeWorksetDescriptors() const { return volume_workset_desc_; }
+
+    /** Build one copy of every volume field manager per worker thread, so that
+      * independent worksets of a block can be evaluated concurrently (see
+      * <code>AssemblyEngine::evaluateVolumeConcurrent</code>). At most
+      * <code>maxWorkers</code> copies are built, fewer if the hardware has fewer
+      * threads or the block has fewer worksets. Requesting it when
+      * <code>concurrentVolumeAssemblySupported()</code> is false prints a warning
+      * and leaves it off. Must be called before <code>setupVolumeFieldManagers</code>.
+      * Off by default.
+      */
+    void setConcurrentVolumeAssembly(bool flag,int maxWorkers=4);
+
+    /** True if the evaluators' kernels run inline on the thread that launches them
+      * and the backend accepts launches from several threads, which concurrent volume
+      * assembly relies on (Kokkos Serial backend of Kokkos 4.2 or later only).
+      */
+    static bool concurrentVolumeAssemblySupported();
+
+    bool getConcurrentVolumeAssembly() const
+    { return concurrentVolumeAssembly_; }
+
+    /** Overlap the solution halo exchange with the volume assembly: worksets
+      * whose cells only touch owned DOFs are evaluated while the import is in
+      * flight (see <code>AssemblyEngine::evaluate</code>). Off by default.
+      */
+    void setOverlapGhostExchange(bool flag)
+    { overlapGhostExchange_ = flag; }
+
+    bool getOverlapGhostExchange() const
+    { return overlapGhostExchange_; }
+
+    /** Copies of the volume field managers, indexed by block then worker; the first
+      * copy of a block is the field manager in <code>getVolumeFieldManagers()</code>.
+      * Empty unless concurrent volume assembly is on.
+      */
+    const std::vector< std::vector< Teuchos::RCP< PHX::FieldManager<panzer::Traits> > > > &
+    getVolumeFieldManagerReplicas() const { return phx_volume_field_manager_replicas_; }
 	
 	const std::vector<WorksetDescriptor> &
     getNeumannWorksetDescriptors() const { return neumann_workset_desc_; }
@@ -245,6 +297,21 @@ namespace panzer {
                                              const panzer::GlobalIndexer & globalIndexer,
                                              const Teuchos::ParameterList& user_data,
                                              PHX::FieldManager<panzer::Traits> & fm) const;
+
+    /** Build the volume field manager of one element block: register the physics
+      * block, closure model and generic evaluators and run the post registration
+      * setup. Called once per worker copy for concurrent volume assembly.
+      */
+    Teuchos::RCP<PHX::FieldManager<panzer::Traits> >
+    buildVolumeFieldManager(panzer::PhysicsBlock & pb,
+                            const WorksetDescriptor & wd,
+                            const panzer::ClosureModelFactory_TemplateManager<panzer::Traits>& cm_factory,
+                            const Teuchos::ParameterList& closure_models,
+                            const panzer::LinearObjFactory<panzer::Traits> & lo_factory,
+                            const Teuchos::ParameterList& user_data,
+                            const GenericEvaluatorFactory & gEvalFact,
+                            bool closureModelByEBlock,
+                            Traits::SD & setupData) const;
 											 
 	//void buildMaterials( const Teuchos::ParameterList& pl );
 
@@ -252,6 +319,10 @@ namespace panzer {
     std::vector< Teuchos::RCP< PHX::FieldManager<panzer::Traits> > >
       phx_volume_field_managers_;
 
+    //! One copy of each volume field manager per worker for concurrent volume assembly.
+    std::vector< std::vector< Teuchos::RCP< PHX::FieldManager<panzer::Traits> > > >
+      phx_volume_field_manager_replicas_;
+
     /** \brief Matches volume field managers so you can determine
       *        the appropriate set of worksets for each field manager.
       */
@@ -278,6 +349,7 @@ namespace panzer {
 	/** For response calculation */
 	Teuchos::RCP<WorksetContainer> worksetContainer2_;
 	std::vector< std::shared_ptr< PHX::FieldManager<panzer::Traits> > > phx_response_field_manager_;
+	Teuchos::RCP<TianXin::ResponseReduction> response_reduction_, response_jacobian_reduction_;
 
     /** Set to false by default, enables/disables physics block scattering in
       * newly created field managers.
@@ -289,6 +361,19 @@ namespace panzer {
       */
     bool disablePhysicsBlockGather_;
 
+    /** Set to false by default, builds a field manager per worker for concurrent
+      * volume assembly.
+      */
+    bool concurrentVolumeAssembly_;
+
+    //! Upper bound on the number of field manager copies for concurrent volume assembly.
+    int maxVolumeWorkers_;
+
+    /** Set to false by default, overlaps the solution import with the
+      * evaluation of interior worksets.
+      */
+    bool overlapGhostExchange_;
+
     /// Entries correspond to evaluation type mpl vector in traits. A value of true means the evaluation type is active.
     std::vector<bool> active_evaluation_types_;
   };
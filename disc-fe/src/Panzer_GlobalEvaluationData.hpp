@@ -61,6 +61,24 @@ public:
    virtual void ghostToGlobal(int mem) = 0;
    virtual void globalToGhost(int mem) = 0;
 
+   /** Split-phase version of <code>globalToGhost</code>. Posting the
+     * communication here and completing it in <code>endGlobalToGhost</code>
+     * lets the caller do work that does not touch ghosted data in between.
+     * By default the exchange is done synchronously in this call.
+     */
+   virtual void beginGlobalToGhost(int mem) { globalToGhost(mem); }
+
+   //! Complete an exchange started by <code>beginGlobalToGhost</code>.
+   virtual void endGlobalToGhost(int /* mem */) {}
+
+   /** Split-phase version of <code>ghostToGlobal</code>. By default
+     * the exchange is done synchronously in this call.
+     */
+   virtual void beginGhostToGlobal(int mem) { ghostToGlobal(mem); }
+
+   //! Complete an exchange started by <code>beginGhostToGlobal</code>.
+   virtual void endGhostToGlobal(int /* mem */) {}
+
    virtual void initializeData() = 0;
 
    //! Diagnostic function for determinning what's in this object
@@ -113,6 +113,34 @@ void GlobalEvaluationDataContainer::globalToGhost(int p)
      itr->second->globalToGhost(p);
 }
 
+//! Call begin global to ghost on all the containers
+void GlobalEvaluationDataContainer::beginGlobalToGhost(int p)
+{
+   for(iterator itr=begin();itr!=end();++itr)
+     itr->second->beginGlobalToGhost(p);
+}
+
+//! Call end global to ghost on all the containers
+void GlobalEvaluationDataContainer::endGlobalToGhost(int p)
+{
+   for(iterator itr=begin();itr!=end();++itr)
+     itr->second->endGlobalToGhost(p);
+}
+
+//! Call begin ghost to global on all the containers
+void GlobalEvaluationDataContainer::beginGhostToGlobal(int p)
+{
+   for(iterator itr=begin();itr!=end();++itr)
+     itr->second->beginGhostToGlobal(p);
+}
+
+//! Call end ghost to global on all the containers
+void GlobalEvaluationDataContainer::endGhostToGlobal(int p)
+{
+   for(iterator itr=begin();itr!=end();++itr)
+     itr->second->endGhostToGlobal(p);
+}
+
 //! Call global to ghost on all the containers
 void GlobalEvaluationDataContainer::initialize()
 {
@@ -74,6 +74,18 @@ public:
    //! Call global to ghost on all the containers
    void globalToGhost(int p);
 
+   //! Call begin global to ghost on all the containers
+   void beginGlobalToGhost(int p);
+
+   //! Call end global to ghost on all the containers
+   void endGlobalToGhost(int p);
+
+   //! Call begin ghost to global on all the containers
+   void beginGhostToGlobal(int p);
+
+   //! Call end ghost to global on all the containers
+   void endGhostToGlobal(int p);
+
    //! Call initialize on all containers
    void initialize();
 
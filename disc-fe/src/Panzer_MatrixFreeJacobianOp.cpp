@@ -0,0 +1,204 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+
+#include "Panzer_MatrixFreeJacobianOp.hpp"
+
+#include "Panzer_AssemblyEngine.hpp"
+#include "Panzer_LOCPair_GlobalEvaluationData.hpp"
+#include "Panzer_ParameterList_GlobalEvaluationData.hpp"
+#include "Panzer_ElementMatrices_GlobalEvaluationData.hpp"
+#include "Panzer_ElementBlockInverseOp.hpp"
+#include "Panzer_TpetraLinearObjFactory.hpp"
+#include "Panzer_ThyraObjContainer.hpp"
+#include "Panzer_ThyraObjFactory.hpp"
+
+#include "Thyra_MultiVectorBase.hpp"
+#include "Thyra_VectorStdOps.hpp"
+#include "Thyra_DefaultDiagonalLinearOp.hpp"
+
+namespace panzer {
+
+MatrixFreeJacobianOp::
+MatrixFreeJacobianOp(const AssemblyEngine_TemplateManager<panzer::Traits> & ae_tm,
+                     const Teuchos::RCP<const LinearObjFactory<panzer::Traits> > & lof,
+                     const AssemblyEngineInArgs & ae_inargs)
+  : ae_tm_(ae_tm), lof_(lof), ae_inargs_(ae_inargs)
+{
+  Teuchos::RCP<const ThyraObjFactory<double> > tof = Teuchos::rcp_dynamic_cast<const ThyraObjFactory<double> >(lof_,true);
+  range_ = tof->getThyraRangeSpace();
+  domain_ = tof->getThyraDomainSpace();
+
+  TEUCHOS_TEST_FOR_EXCEPTION(ae_inargs_.getGlobalEvaluationDataMap().count("Directional Derivative Container")>0 ||
+                             ae_inargs_.getGlobalEvaluationDataMap().count("Jacobian Diagonal Container")>0 ||
+                             ae_inargs_.getGlobalEvaluationDataMap().count("Jacobian Row Sum Container")>0 ||
+                             ae_inargs_.getGlobalEvaluationDataMap().count("Element Jacobian Container")>0,
+                             std::logic_error,
+                             "MatrixFreeJacobianOp: assembly arguments already carry a matrix-free container");
+
+  // the Tangent scatter always sets up the parameter sensitivities, the direction is the only derivative here
+  if(ae_inargs_.getGlobalEvaluationDataMap().count("PARAMETER_NAMES")==0)
+    ae_inargs_.addGlobalEvaluationData("PARAMETER_NAMES",
+                                       Teuchos::rcp(new ParameterList_GlobalEvaluationData(std::vector<std::string>())));
+}
+
+bool MatrixFreeJacobianOp::
+opSupportedImpl(Thyra::EOpTransp M_trans) const
+{
+  return M_trans==Thyra::NOTRANS;
+}
+
+void MatrixFreeJacobianOp::
+applyImpl(const Thyra::EOpTransp M_trans,
+          const Thyra::MultiVectorBase<double> & X,
+          const Teuchos::Ptr<Thyra::MultiVectorBase<double> > & Y,
+          const double alpha,
+          const double beta) const
+{
+  using Teuchos::RCP;
+  typedef LinearObjContainer LOC;
+
+  TEUCHOS_TEST_FOR_EXCEPTION(M_trans!=Thyra::NOTRANS,std::logic_error,
+                             "MatrixFreeJacobianOp: only the non-transposed operator is available");
+
+  if(direction_==Teuchos::null)
+    direction_ = Teuchos::rcp(new LOCPair_GlobalEvaluationData(lof_,LOC::X | LOC::F));
+
+  RCP<ThyraObjContainer<double> > thDirection =
+    Teuchos::rcp_dynamic_cast<ThyraObjContainer<double> >(direction_->getGlobalLOC(),true);
+
+  // the assembly engine initializes the ghosted direction, imports v and
+  // exports J*v through the global evaluation data container
+  AssemblyEngineInArgs in = ae_inargs_;
+  in.addGlobalEvaluationData("Directional Derivative Container",direction_);
+
+  RCP<Thyra::VectorBase<double> > jv = range_->createMember();
+  for(Thyra::Ordinal j=0;j<X.domain()->dim();j++) {
+    thDirection->set_x_th(Teuchos::rcp_const_cast<Thyra::VectorBase<double> >(X.col(j)));
+    thDirection->set_f_th(jv);
+
+    ae_tm_.getAsObject<panzer::Traits::Tangent>()->evaluate(in);
+
+    // Y = alpha*J*X + beta*Y, where Y is not read when beta is zero
+    RCP<Thyra::VectorBase<double> > y = Y->col(j);
+    if(beta==0.0)
+      Thyra::V_StV(y.ptr(),alpha,*jv);
+    else {
+      Thyra::Vt_S(y.ptr(),beta);
+      Thyra::Vp_StV(y.ptr(),alpha,*jv);
+    }
+  }
+
+  // don't hold on to the callers vectors
+  thDirection->set_x_th(Teuchos::null);
+  thDirection->set_f_th(Teuchos::null);
+}
+
+Teuchos::RCP<Thyra::VectorBase<double> > MatrixFreeJacobianOp::
+getDiagonal() const
+{
+  using Teuchos::RCP;
+  typedef LinearObjContainer LOC;
+
+  // x of the diagonal container stays zero, Dirichlet rows are written as x-(-pivot)
+  RCP<LOCPair_GlobalEvaluationData> diagonal = Teuchos::rcp(new LOCPair_GlobalEvaluationData(lof_,LOC::X | LOC::F));
+
+  RCP<Thyra::VectorBase<double> > diag = range_->createMember();
+  Teuchos::rcp_dynamic_cast<ThyraObjContainer<double> >(diagonal->getGlobalLOC(),true)->set_f_th(diag);
+
+  AssemblyEngineInArgs in = ae_inargs_;
+  in.addGlobalEvaluationData("Jacobian Diagonal Container",diagonal);
+
+  ae_tm_.getAsObject<panzer::Traits::Jacobian>()->evaluate(in);
+
+  return diag;
+}
+
+Teuchos::RCP<const Thyra::LinearOpBase<double> > MatrixFreeJacobianOp::
+buildJacobiPreconditioner() const
+{
+  Teuchos::RCP<Thyra::VectorBase<double> > diag = getDiagonal();
+  Teuchos::RCP<Thyra::VectorBase<double> > invDiag = range_->createMember();
+  Thyra::reciprocal(*diag,invDiag.ptr());
+
+  return Thyra::diagonal(invDiag);
+}
+
+Teuchos::RCP<Thyra::VectorBase<double> > MatrixFreeJacobianOp::
+getRowSums() const
+{
+  using Teuchos::RCP;
+  typedef LinearObjContainer LOC;
+
+  // as for the diagonal, Dirichlet rows sum to the pivot
+  RCP<LOCPair_GlobalEvaluationData> rowSums = Teuchos::rcp(new LOCPair_GlobalEvaluationData(lof_,LOC::X | LOC::F));
+
+  RCP<Thyra::VectorBase<double> > sums = range_->createMember();
+  Teuchos::rcp_dynamic_cast<ThyraObjContainer<double> >(rowSums->getGlobalLOC(),true)->set_f_th(sums);
+
+  AssemblyEngineInArgs in = ae_inargs_;
+  in.addGlobalEvaluationData("Jacobian Row Sum Container",rowSums);
+
+  ae_tm_.getAsObject<panzer::Traits::Jacobian>()->evaluate(in);
+
+  return sums;
+}
+
+Teuchos::RCP<const Thyra::LinearOpBase<double> > MatrixFreeJacobianOp::
+buildElementBlockInverse() const
+{
+  using Teuchos::RCP;
+  typedef TpetraLinearObjFactory<panzer::Traits,double,panzer::LocalOrdinal,panzer::GlobalOrdinal> TpetraLOF;
+
+  RCP<const TpetraLOF> tlof = Teuchos::rcp_dynamic_cast<const TpetraLOF>(lof_,true);
+  RCP<ElementMatrices_GlobalEvaluationData> matrices
+      = Teuchos::rcp(new ElementMatrices_GlobalEvaluationData(tlof->getRangeGlobalIndexer()));
+
+  AssemblyEngineInArgs in = ae_inargs_;
+  in.addGlobalEvaluationData("Element Jacobian Container",matrices);
+
+  ae_tm_.getAsObject<panzer::Traits::Jacobian>()->evaluate(in);
+
+  return Teuchos::rcp(new ElementBlockInverseOp(*matrices,lof_));
+}
+
+}
@@ -0,0 +1,135 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+
+#ifndef PANZER_MATRIX_FREE_JACOBIAN_OP_HPP
+#define PANZER_MATRIX_FREE_JACOBIAN_OP_HPP
+
+#include "PanzerDiscFE_config.hpp"
+
+#include "Teuchos_RCP.hpp"
+
+#include "Thyra_LinearOpDefaultBase.hpp"
+#include "Thyra_VectorBase.hpp"
+
+#include "Panzer_Traits.hpp"
+#include "Panzer_AssemblyEngine_InArgs.hpp"
+#include "Panzer_AssemblyEngine_TemplateManager.hpp"
+#include "Panzer_LinearObjFactory.hpp"
+
+namespace panzer {
+
+class LOCPair_GlobalEvaluationData;
+
+/** Jacobian of the residual as a linear operator that never assembles a matrix.
+  * The product J*v is formed element by element by seeding v into the first
+  * derivative component of the Tangent evaluation type and scattering that
+  * component; Dirichlet rows of the product are v itself. The diagonal, the
+  * row sums and the element blocks are taken from the element Jacobians for
+  * preconditioning and for mass lumping.
+  *
+  * The operator is fixed at the state (x, xdot, alpha, beta and time) in
+  * the assembly engine arguments it is constructed with. Only Tpetra linear
+  * object factories are supported. The ghosted container of the arguments
+  * needs no matrix, none of the fills touches one.
+  */
+class MatrixFreeJacobianOp : public Thyra::LinearOpDefaultBase<double> {
+public:
+
+  /** Build the operator.
+    *
+    * \param[in] ae_tm Assembly engines, a Tangent and a Jacobian engine are used
+    * \param[in] lof Linear object factory the engines were built with
+    * \param[in] ae_inargs Assembly arguments describing the linearization state
+    */
+  MatrixFreeJacobianOp(const AssemblyEngine_TemplateManager<panzer::Traits> & ae_tm,
+                       const Teuchos::RCP<const LinearObjFactory<panzer::Traits> > & lof,
+                       const AssemblyEngineInArgs & ae_inargs);
+
+  Teuchos::RCP<const Thyra::VectorSpaceBase<double> > range() const override
+  { return range_; }
+
+  Teuchos::RCP<const Thyra::VectorSpaceBase<double> > domain() const override
+  { return domain_; }
+
+  //! Diagonal of the Jacobian, summed from the element Jacobians
+  Teuchos::RCP<Thyra::VectorBase<double> > getDiagonal() const;
+
+  //! Point Jacobi preconditioner, the inverse of <code>getDiagonal()</code>
+  Teuchos::RCP<const Thyra::LinearOpBase<double> > buildJacobiPreconditioner() const;
+
+  //! Row sums of the Jacobian, summed from the element Jacobians (a lumped matrix)
+  Teuchos::RCP<Thyra::VectorBase<double> > getRowSums() const;
+
+  /** Inverse of the block diagonal part of the Jacobian made of the element
+    * Jacobians. This is the exact inverse only if no dof is shared between
+    * elements (for instance a DG mass matrix); Dirichlet rows are not treated.
+    */
+  Teuchos::RCP<const Thyra::LinearOpBase<double> > buildElementBlockInverse() const;
+
+protected:
+
+  bool opSupportedImpl(Thyra::EOpTransp M_trans) const override;
+
+  void applyImpl(const Thyra::EOpTransp M_trans,
+                 const Thyra::MultiVectorBase<double> & X,
+                 const Teuchos::Ptr<Thyra::MultiVectorBase<double> > & Y,
+                 const double alpha,
+                 const double beta) const override;
+
+private:
+
+  MatrixFreeJacobianOp();
+
+  AssemblyEngine_TemplateManager<panzer::Traits> ae_tm_;
+  Teuchos::RCP<const LinearObjFactory<panzer::Traits> > lof_;
+  AssemblyEngineInArgs ae_inargs_;
+
+  Teuchos::RCP<const Thyra::VectorSpaceBase<double> > range_, domain_;
+
+  // direction v in x and J*v in f, kept so repeated applies do not reallocate
+  mutable Teuchos::RCP<LOCPair_GlobalEvaluationData> direction_;
+};
+
+}
+
+#endif
@@ -405,6 +405,26 @@ public:
   void setupAssemblyInArgs(const Thyra::ModelEvaluatorBase::InArgs<Scalar> & inArgs,
                            panzer::AssemblyEngineInArgs & ae_inargs) const;
 
+  /** Build a Jacobian (W) operator at the state in "inArgs" that applies
+    * element by element instead of assembling a matrix, see
+    * <code>panzer::MatrixFreeJacobianOp</code>. It shares the solution containers
+    * of this model evaluator, so it is valid until the next model evaluation. Its
+    * ghosted container carries no matrix, so no CRS matrix is allocated or filled.
+    */
+  Teuchos::RCP<Thyra::LinearOpBase<Scalar> >
+  create_matrix_free_W_op(const Thyra::ModelEvaluatorBase::InArgs<Scalar> & inArgs) const;
+
+  /** Evaluate the responses in the same assembly pass as the residual when a
+    * residual (without a Jacobian) and responses are requested together, see
+    * <code>panzer::AssemblyEngine::evaluate</code>. Also set by the
+    * "Fused Response Evaluation" model evaluator parameter of <code>setupModel</code>.
+    */
+  void setFusedResponseEvaluation(bool value)
+  { fuse_response_evaluation_ = value; }
+
+  bool getFusedResponseEvaluation() const
+  { return fuse_response_evaluation_; }
+
 
   /**
    * \brief return a copy of the model evaluators template manager, this is shallow class so pass by value
@@ -417,6 +437,9 @@ public:
   Teuchos::RCP<panzer::ResponseLibrary<panzer::Traits> > getResponseLibrary() const
   { return responseLibrary_; }
 
+  Teuchos::RCP<const panzer::LinearObjFactory<panzer::Traits> > getLinearObjFactory() const
+  { return lof_; }
+
   /** Returns the x tangent vector index for a given parameter index
    */
   int getXTangentVectorIndex(const int index) const {
@@ -571,6 +594,10 @@ protected:
   virtual void evalModelImpl_basic_g(const Thyra::ModelEvaluatorBase::InArgs<Scalar> &inArgs,
                              const Thyra::ModelEvaluatorBase::OutArgs<Scalar> &outArgs) const;
 
+  //! Evaluate the residual and the responses in a single assembly pass
+  void evalModelImpl_basic_f_and_g(const Thyra::ModelEvaluatorBase::InArgs<Scalar> &inArgs,
+                                   const Thyra::ModelEvaluatorBase::OutArgs<Scalar> &outArgs) const;
+
   /** handles evaluation of responses dgdx
     *
     * \note This method should (basically) be a no-op if <code>required_basic_dgdx(outArgs)==false</code>.
@@ -622,6 +649,11 @@ protected:
   //! Does this set of out args require a simple response?
   bool required_basic_g(const Thyra::ModelEvaluatorBase::OutArgs<Scalar> &outArgs) const;
 
+  /** Can the responses in <code>outArgs</code> be evaluated in the residual's
+    * assembly pass?
+    */
+  bool canFuseResponseEvaluation(const Thyra::ModelEvaluatorBase::OutArgs<Scalar> &outArgs) const;
+
   //! Are their required responses in the out args? DgDx
   bool required_basic_dgdx(const Thyra::ModelEvaluatorBase::OutArgs<Scalar> &outArgs) const;
 
@@ -646,6 +678,10 @@ protected:
   // Reset parameters back to nominal values
   void resetParameters() const;
 
+  // Add the matrix to the ghosted container before the first matrix fill, residual-only
+  // evaluations never allocate the ghosted graph
+  void requireGhostedMatrix() const;
+
 private: // data members
 
   struct ParameterObject {
@@ -705,6 +741,7 @@ private: // data members
   int num_me_parameters_;
   bool do_fd_dfdp_;
   double fd_perturb_size_;
+  bool fuse_response_evaluation_;
 
   mutable bool require_in_args_refresh_;
   mutable bool require_out_args_refresh_;
@@ -721,6 +758,7 @@ private: // data members
   // basic specific linear object objects
   Teuchos::RCP<const panzer::LinearObjFactory<panzer::Traits> > lof_;
   mutable Teuchos::RCP<panzer::LinearObjContainer> ghostedContainer_;
+  mutable Teuchos::RCP<panzer::LinearObjContainer> matrixFreeGhostedContainer_; // never carries a matrix
   mutable Teuchos::RCP<ReadOnlyVector_GlobalEvaluationData> xContainer_;
   mutable Teuchos::RCP<ReadOnlyVector_GlobalEvaluationData> xdotContainer_;
   mutable Teuchos::RCP<ReadOnlyVector_GlobalEvaluationData> xdotdotContainer_;
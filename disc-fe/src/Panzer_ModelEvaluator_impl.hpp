@@ -62,6 +62,7 @@
 #include "Panzer_ParameterList_GlobalEvaluationData.hpp"
 #include "Panzer_ParameterLibraryUtilities.hpp"
 #include "Panzer_LinearObjFactory_Utilities.hpp"
+#include "Panzer_MatrixFreeJacobianOp.hpp"
 
 #include "Thyra_TpetraThyraWrappers.hpp"
 #include "Thyra_SpmdVectorBase.hpp"
@@ -96,6 +97,7 @@ ModelEvaluator(const Teuchos::RCP<panzer::FieldManagerBuilder>& fmb,
   , num_me_parameters_(0)
   , do_fd_dfdp_(false)
   , fd_perturb_size_(1e-7)
+  , fuse_response_evaluation_(false)
   , require_in_args_refresh_(true)
   , require_out_args_refresh_(true)
   , responseLibrary_(rLibrary)
@@ -155,6 +157,7 @@ ModelEvaluator(const Teuchos::RCP<const panzer::LinearObjFactory<panzer::Traits>
   , num_me_parameters_(0)
   , do_fd_dfdp_(false)
   , fd_perturb_size_(1e-7)
+  , fuse_response_evaluation_(false)
   , require_in_args_refresh_(true)
   , require_out_args_refresh_(true)
   , global_data_(global_data)
@@ -208,6 +211,7 @@ ModelEvaluator(const Teuchos::RCP<panzer::FieldManagerBuilder>& fmb,
   , num_me_parameters_(0)
   , do_fd_dfdp_(false)
   , fd_perturb_size_(1e-7)
+  , fuse_response_evaluation_(false)
   , require_in_args_refresh_(true)
   , require_out_args_refresh_(true)
   , responseLibrary_(rLibrary)
@@ -267,6 +271,7 @@ ModelEvaluator(const Teuchos::RCP<const panzer::LinearObjFactory<panzer::Traits>
   , num_me_parameters_(0)
   , do_fd_dfdp_(false)
   , fd_perturb_size_(1e-7)
+  , fuse_response_evaluation_(false)
   , require_in_args_refresh_(true)
   , require_out_args_refresh_(true)
   , global_data_(global_data)
@@ -635,6 +640,8 @@ setupModel(const Teuchos::RCP<panzer::WorksetContainer> & wc,
       do_fd_dfdp_ = me_params.get<bool>("FD Forward Sensitivities");
     if (me_params.isParameter("FD Perturbation Size"))
       fd_perturb_size_ = me_params.get<double>("FD Perturbation Size");
+    if (me_params.isParameter("Fused Response Evaluation"))
+      fuse_response_evaluation_ = me_params.get<bool>("Fused Response Evaluation");
   }
 }
 
@@ -717,6 +724,8 @@ setupModel(const Teuchos::RCP<panzer::WorksetContainer> & wc,
       do_fd_dfdp_ = me_params.get<bool>("FD Forward Sensitivities");
     if (me_params.isParameter("FD Perturbation Size"))
       fd_perturb_size_ = me_params.get<double>("FD Perturbation Size");
+    if (me_params.isParameter("Fused Response Evaluation"))
+      fuse_response_evaluation_ = me_params.get<bool>("Fused Response Evaluation");
   }
 }
 
@@ -731,13 +740,13 @@ setupAssemblyInArgs(const Thyra::ModelEvaluatorBase::InArgs<Scalar> & inArgs,
   using Teuchos::rcp_const_cast;
   typedef Thyra::ModelEvaluatorBase MEB;
 
-  // if neccessary build a ghosted container
+  // if neccessary build a ghosted container, the matrix is added by the
+  // first evaluation that fills one (see requireGhostedMatrix)
   if(Teuchos::is_null(ghostedContainer_)) {
      ghostedContainer_ = lof_->buildGhostedLinearObjContainer();
      lof_->initializeGhostedContainer(panzer::LinearObjContainer::X |
                                       panzer::LinearObjContainer::DxDt |
-                                      panzer::LinearObjContainer::F |
-                                      panzer::LinearObjContainer::Mat, *ghostedContainer_);
+                                      panzer::LinearObjContainer::F, *ghostedContainer_);
   }
 
   bool is_transient = false;
@@ -938,6 +947,41 @@ setupAssemblyInArgs(const Thyra::ModelEvaluatorBase::InArgs<Scalar> & inArgs,
   } // end loop over the parameter vectors
 } // end of setupAssemblyInArgs()
 
+template <typename Scalar>
+void panzer::ModelEvaluator<Scalar>::
+requireGhostedMatrix() const
+{
+  typedef panzer::LinearObjContainer LOC;
+
+  const Teuchos::RCP<panzer::ThyraObjContainer<Scalar> > thGhostedContainer =
+    Teuchos::rcp_dynamic_cast<panzer::ThyraObjContainer<Scalar> >(ghostedContainer_,true);
+  if(thGhostedContainer->get_A_th()==Teuchos::null)
+    lof_->initializeGhostedContainer(LOC::X | LOC::DxDt | LOC::F | LOC::Mat, *ghostedContainer_);
+}
+
+template <typename Scalar>
+Teuchos::RCP<Thyra::LinearOpBase<Scalar> >
+panzer::ModelEvaluator<Scalar>::
+create_matrix_free_W_op(const Thyra::ModelEvaluatorBase::InArgs<Scalar> & inArgs) const
+{
+  typedef panzer::LinearObjContainer LOC;
+
+  panzer::AssemblyEngineInArgs ae_inargs;
+  setupAssemblyInArgs(inArgs,ae_inargs);
+
+  // the matrix-free fills get a ghosted container of their own without a matrix,
+  // so neither the ghosted graph is allocated nor a matrix is filled for them
+  if(Teuchos::is_null(matrixFreeGhostedContainer_)) {
+    matrixFreeGhostedContainer_ = lof_->buildGhostedLinearObjContainer();
+    lof_->initializeGhostedContainer(LOC::X | LOC::DxDt | LOC::F, *matrixFreeGhostedContainer_);
+  }
+  ae_inargs.ghostedContainer_ = matrixFreeGhostedContainer_;
+
+  // the global container only carries the state, so the matrix-free fills
+  // never export into a matrix or residual
+  return Teuchos::rcp(new panzer::MatrixFreeJacobianOp(ae_tm_,lof_,ae_inargs));
+}
+
 // Private functions overridden from ModelEvaulatorDefaultBase
 
 
@@ -1440,6 +1484,8 @@ evalModel_D2fDx2(const Thyra::ModelEvaluatorBase::InArgs<Scalar> & inArgs,
   {
     PANZER_FUNC_TIME_MONITOR("panzer::ModelEvaluator::evalModel(D2fDx2)");
 
+    requireGhostedMatrix();
+
     // this dummy nonsense is needed only for scattering dirichlet conditions
     RCP<Thyra::VectorBase<Scalar> > dummy_f = Thyra::createMember(f_space_);
     thGlobalContainer->set_f_th(dummy_f);
@@ -1542,6 +1588,8 @@ evalModel_D2fDxDp(int pIndex,
   {
     PANZER_FUNC_TIME_MONITOR("panzer::ModelEvaluator::evalModel(D2fDxDp)");
 
+    requireGhostedMatrix();
+
     // this dummy nonsense is needed only for scattering dirichlet conditions
     RCP<Thyra::VectorBase<Scalar> > dummy_f = Thyra::createMember(f_space_);
     thGlobalContainer->set_f_th(dummy_f);
@@ -1681,11 +1729,17 @@ void panzer::ModelEvaluator<Scalar>::
 evalModelImpl(const Thyra::ModelEvaluatorBase::InArgs<Scalar> &inArgs,
               const Thyra::ModelEvaluatorBase::OutArgs<Scalar> &outArgs) const
 {
-  evalModelImpl_basic(inArgs,outArgs);
+  // a residual evaluation that also wants responses can be done in one sweep
+  if(fuse_response_evaluation_ && canFuseResponseEvaluation(outArgs)) {
+    evalModelImpl_basic_f_and_g(inArgs,outArgs);
+  }
+  else {
+    evalModelImpl_basic(inArgs,outArgs);
 
-  // evaluate responses...uses the stored assembly arguments and containers
-  if(required_basic_g(outArgs))
-    evalModelImpl_basic_g(inArgs,outArgs);
+    // evaluate responses...uses the stored assembly arguments and containers
+    if(required_basic_g(outArgs))
+      evalModelImpl_basic_g(inArgs,outArgs);
+  }
 
   // evaluate response derivatives
   if(required_basic_dgdx(outArgs))
@@ -1777,6 +1831,8 @@ evalModelImpl_basic(const Thyra::ModelEvaluatorBase::InArgs<Scalar> &inArgs,
   if (!Teuchos::is_null(f_out) && !Teuchos::is_null(W_out)) {
     PANZER_FUNC_TIME_MONITOR("panzer::ModelEvaluator::evalModel(f and J)");
 
+    requireGhostedMatrix();
+
     // only add auxiliary global data if Jacobian is being formed
     ae_inargs.addGlobalEvaluationData(nonParamGlobalEvaluationData_);
 
@@ -1808,6 +1864,8 @@ evalModelImpl_basic(const Thyra::ModelEvaluatorBase::InArgs<Scalar> &inArgs,
 
     PANZER_FUNC_TIME_MONITOR("panzer::ModelEvaluator::evalModel(J)");
 
+    requireGhostedMatrix();
+
     // only add auxiliary global data if Jacobian is being formed
     ae_inargs.addGlobalEvaluationData(nonParamGlobalEvaluationData_);
 
@@ -1915,6 +1973,76 @@ evalModelImpl_basic_g(const Thyra::ModelEvaluatorBase::InArgs<Scalar> &inArgs,
   resetParameters();
 }
 
+template <typename Scalar>
+void panzer::ModelEvaluator<Scalar>::
+evalModelImpl_basic_f_and_g(const Thyra::ModelEvaluatorBase::InArgs<Scalar> &inArgs,
+                            const Thyra::ModelEvaluatorBase::OutArgs<Scalar> &outArgs) const
+{
+  using Teuchos::RCP;
+
+  PANZER_FUNC_TIME_MONITOR("panzer::ModelEvaluator::evalModel(f and g)");
+
+  typedef Thyra::ModelEvaluatorBase MEB;
+
+  bool is_transient = false;
+  if (inArgs.supports(MEB::IN_ARG_x_dot ) )
+    is_transient = !Teuchos::is_null(inArgs.get_x_dot());
+
+  TEUCHOS_TEST_FOR_EXCEPTION(is_transient && !build_transient_support_, std::runtime_error,
+                     "ModelEvaluator was not built with transient support enabled!");
+
+  const RCP<Thyra::VectorBase<Scalar> > f_out = outArgs.get_f();
+
+  // the residual and the responses share the assembly in arguments
+  panzer::AssemblyEngineInArgs ae_inargs;
+  setupAssemblyInArgs(inArgs,ae_inargs);
+
+  // set model parameters from supplied inArgs
+  setParameters(inArgs);
+
+  if(oneTimeDirichletBeta_on_) {
+    ae_inargs.dirichlet_beta = oneTimeDirichletBeta_;
+    ae_inargs.apply_dirichlet_beta = true;
+
+    oneTimeDirichletBeta_on_ = false;
+  }
+
+  for(std::size_t i=0;i<responses_.size();i++) {
+    Teuchos::RCP<Thyra::VectorBase<Scalar> > vec = outArgs.get_g(i);
+    if(vec!=Teuchos::null) {
+      std::string responseName = responses_[i]->name;
+      Teuchos::RCP<panzer::ResponseMESupportBase<panzer::Traits::Residual> > resp
+          = Teuchos::rcp_dynamic_cast<panzer::ResponseMESupportBase<panzer::Traits::Residual> >(
+              responseLibrary_->getResponse<panzer::Traits::Residual>(responseName));
+      resp->setVector(vec);
+    }
+  }
+  responseLibrary_->addResponsesToInArgs<panzer::Traits::Residual>(ae_inargs);
+
+  const RCP<panzer::ThyraObjContainer<Scalar> > thGlobalContainer =
+    Teuchos::rcp_dynamic_cast<panzer::ThyraObjContainer<Scalar> >(ae_inargs.container_);
+  const RCP<panzer::ThyraObjContainer<Scalar> > thGhostedContainer =
+    Teuchos::rcp_dynamic_cast<panzer::ThyraObjContainer<Scalar> >(ae_inargs.ghostedContainer_);
+
+  thGlobalContainer->set_f_th(f_out);
+
+  // Zero values in ghosted container objects
+  Thyra::assign(thGhostedContainer->get_f_th().ptr(),0.0);
+
+  typedef panzer::AssemblyEngine<panzer::Traits::Residual> ResidualEngine;
+  ae_tm_.template getAsObject<panzer::Traits::Residual>()->evaluate(
+      ae_inargs,ResidualEngine::EvaluationFlags(ResidualEngine::EvaluationFlags::All),
+      responseLibrary_->getAssemblyEngine<panzer::Traits::Residual>().get());
+
+  thGlobalContainer->set_x_th(Teuchos::null);
+  thGlobalContainer->set_dxdt_th(Teuchos::null);
+  if( build_dotdot_support_ ) thGlobalContainer->set_d2xdt2_th(Teuchos::null);
+  thGlobalContainer->set_f_th(Teuchos::null);
+
+  // reset parameters back to nominal values
+  resetParameters();
+}
+
 template <typename Scalar>
 void
 panzer::ModelEvaluator<Scalar>::
@@ -2410,6 +2538,24 @@ required_basic_g(const Thyra::ModelEvaluatorBase::OutArgs<Scalar> &outArgs) cons
    return activeGArgs | required_basic_dgdx(outArgs);
 }
 
+template <typename Scalar>
+bool panzer::ModelEvaluator<Scalar>::
+canFuseResponseEvaluation(const Thyra::ModelEvaluatorBase::OutArgs<Scalar> &outArgs) const
+{
+   // the responses are evaluated with the residual type, so only a residual
+   // evaluation can carry them along
+   bool activeGArgs = false;
+   for(int i=0;i<outArgs.Ng();i++)
+      activeGArgs |= (outArgs.get_g(i)!=Teuchos::null);
+
+   return activeGArgs
+       && !required_basic_dgdx(outArgs)
+       && outArgs.get_f()!=Teuchos::null
+       && outArgs.get_W_op()==Teuchos::null
+       && responseLibrary_!=Teuchos::null
+       && !responseLibrary_->isResidualType();
+}
+
 template <typename Scalar>
 bool panzer::ModelEvaluator<Scalar>::
 required_basic_dgdx(const Thyra::ModelEvaluatorBase::OutArgs<Scalar> &outArgs) const
@@ -0,0 +1,265 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#include "Panzer_TensorProductBasis.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Teuchos_Assert.hpp"
+
+#include "Shards_CellTopology.hpp"
+
+#include "Panzer_IntegrationRule.hpp"
+#include "Panzer_IntegrationValues2.hpp"
+#include "Panzer_IntrepidBasisFactory.hpp"
+
+namespace panzer {
+
+namespace {
+
+bool isTensorTopology(const shards::CellTopology & topo)
+{
+  return topo.getBaseKey()==shards::Quadrilateral<4>::key ||
+         topo.getBaseKey()==shards::Hexahedron<8>::key;
+}
+
+// index of x in the sorted coordinates, or -1
+int findCoordinate(const std::vector<double> & coords,double x)
+{
+  const double tol = 1e-12;
+  for(std::size_t i=0;i<coords.size();i++)
+    if(std::fabs(coords[i]-x)<tol)
+      return static_cast<int>(i);
+  return -1;
+}
+
+// sorted distinct values of one coordinate direction
+std::vector<double> distinctCoordinates(const Kokkos::DynRankView<double,Kokkos::HostSpace> & coords,int dir)
+{
+  std::vector<double> distinct;
+  for(std::size_t i=0;i<coords.extent(0);i++)
+    if(findCoordinate(distinct,coords(i,dir))<0)
+      distinct.push_back(coords(i,dir));
+  std::sort(distinct.begin(),distinct.end());
+  return distinct;
+}
+
+}
+
+// **********************************************************************
+TensorProductBasis::
+TensorProductBasis()
+  : dim_(0), n_(0), q_(0), nz_(0), qz_(0)
+{ }
+
+// **********************************************************************
+bool TensorProductBasis::
+isSupported(const std::string & basis_type,
+            const IntegrationRule & ir)
+{
+  return basis_type=="HGrad" &&
+         ir.getType()==IntegrationDescriptor::VOLUME &&
+         isTensorTopology(*ir.topology);
+}
+
+// **********************************************************************
+TensorProductBasis::
+TensorProductBasis(const std::string & basis_type,
+                   const int basis_order,
+                   const IntegrationValues2<double> & iv)
+{
+  typedef Kokkos::DynRankView<double,PHX::Device> DeviceArray;
+  typedef Kokkos::DynRankView<double,Kokkos::HostSpace> HostArray;
+
+  const IntegrationRule & ir = *iv.int_rule;
+  const shards::CellTopology & topo = *ir.topology;
+
+  TEUCHOS_TEST_FOR_EXCEPTION(!isSupported(basis_type,ir),std::logic_error,
+                             "TensorProductBasis: Basis \"" << basis_type << "\" with integration rule \""
+                             << ir.getName() << "\" on \"" << topo.getName() << "\" is not of tensor-product form.");
+
+  dim_ = topo.getDimension();
+
+  // the integration points, the 1D points are the distinct coordinates
+  HostArray points("points",ir.num_points,dim_);
+  {
+    auto points_d = iv.getUniformCubaturePointsRef(false);
+    auto points_h = Kokkos::create_mirror_view(points_d.get_static_view());
+    Kokkos::deep_copy(points_h,points_d.get_static_view());
+    for(int p=0;p<ir.num_points;p++)
+      for(int d=0;d<dim_;d++)
+        points(p,d) = points_h(p,d);
+  }
+  const std::vector<double> points_1d = distinctCoordinates(points,0);
+  q_ = points_1d.size();
+  qz_ = dim_==3 ? q_ : 1;
+  TEUCHOS_TEST_FOR_EXCEPTION(q_*q_*qz_!=ir.num_points,std::logic_error,
+                             "TensorProductBasis: Integration rule \"" << ir.getName() << "\" is not a tensor product of a 1D rule.");
+
+  // the 1D basis, with the same point distribution as the full basis
+  const shards::CellTopology line(shards::getCellTopologyData<shards::Line<2> >());
+  auto line_basis = createIntrepid2Basis<PHX::Device::execution_space,double,double>(basis_type,basis_order,line);
+  auto full_basis = createIntrepid2Basis<PHX::Device::execution_space,double,double>(basis_type,basis_order,topo);
+  n_ = line_basis->getCardinality();
+  nz_ = dim_==3 ? n_ : 1;
+  TEUCHOS_TEST_FOR_EXCEPTION(n_*n_*nz_!=full_basis->getCardinality(),std::logic_error,
+                             "TensorProductBasis: Basis \"" << basis_type << "\" of order " << basis_order
+                             << " on \"" << topo.getName() << "\" is not a tensor product of a 1D basis.");
+
+  HostArray values("values",n_,q_), grads("grads",n_,q_);
+  {
+    DeviceArray line_points("line_points",q_,1);
+    auto line_points_h = Kokkos::create_mirror_view(line_points);
+    for(int q=0;q<q_;q++)
+      line_points_h(q,0) = points_1d[q];
+    Kokkos::deep_copy(line_points,line_points_h);
+
+    DeviceArray line_values("line_values",n_,q_), line_grads("line_grads",n_,q_,1);
+    line_basis->getValues(line_values,line_points,Intrepid2::OPERATOR_VALUE);
+    line_basis->getValues(line_grads,line_points,Intrepid2::OPERATOR_GRAD);
+    auto line_values_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),line_values);
+    auto line_grads_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),line_grads);
+    for(int i=0;i<n_;i++) {
+      for(int q=0;q<q_;q++) {
+        values(i,q) = line_values_h(i,q);
+        grads(i,q) = line_grads_h(i,q,0);
+      }
+    }
+  }
+
+  // the tables of each direction, the third direction of a quadrilateral is constant
+  values_ = PHX::View<double***>("TensorProductBasis::values",3,n_,q_);
+  grads_ = PHX::View<double***>("TensorProductBasis::grads",3,n_,q_);
+  auto values_h = Kokkos::create_mirror_view(values_);
+  auto grads_h = Kokkos::create_mirror_view(grads_);
+  for(int dir=0;dir<3;dir++) {
+    for(int i=0;i<n_;i++) {
+      for(int q=0;q<q_;q++) {
+        const bool constant = (dir==2 && dim_==2);
+        values_h(dir,i,q) = constant ? (i==0 && q==0 ? 1.0 : 0.0) : values(i,q);
+        grads_h(dir,i,q) = constant ? 0.0 : grads(i,q);
+      }
+    }
+  }
+  Kokkos::deep_copy(values_,values_h);
+  Kokkos::deep_copy(grads_,grads_h);
+
+  // tensor point index of each integration point
+  pointMap_ = PHX::View<int*>("TensorProductBasis::pointMap",numPoints());
+  auto pointMap_h = Kokkos::create_mirror_view(pointMap_);
+  Kokkos::deep_copy(pointMap_h,-1);
+  for(int p=0;p<ir.num_points;p++) {
+    int t[3] = {0,0,0};
+    for(int d=0;d<dim_;d++)
+      t[d] = findCoordinate(points_1d,points(p,d));
+    TEUCHOS_TEST_FOR_EXCEPTION(t[0]<0 || t[1]<0 || t[2]<0,std::logic_error,
+                               "TensorProductBasis: Integration rule \"" << ir.getName() << "\" is not a tensor product of a 1D rule.");
+    pointMap_h(t[0]+q_*(t[1]+q_*t[2])) = p;
+  }
+  for(int t=0;t<numPoints();t++)
+    TEUCHOS_TEST_FOR_EXCEPTION(pointMap_h(t)<0,std::logic_error,
+                               "TensorProductBasis: Integration rule \"" << ir.getName() << "\" is not a tensor product of a 1D rule.");
+  Kokkos::deep_copy(pointMap_,pointMap_h);
+
+  // tensor basis index of each basis function, from the nodes of the Lagrange bases
+  basisMap_ = PHX::View<int*>("TensorProductBasis::basisMap",numBasis());
+  auto basisMap_h = Kokkos::create_mirror_view(basisMap_);
+  Kokkos::deep_copy(basisMap_h,-1);
+  {
+    DeviceArray line_nodes("line_nodes",n_,1), full_nodes("full_nodes",numBasis(),dim_);
+    line_basis->getDofCoords(line_nodes);
+    full_basis->getDofCoords(full_nodes);
+    auto line_nodes_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),line_nodes);
+    auto full_nodes_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),full_nodes);
+
+    std::vector<double> nodes_1d(n_);
+    for(int i=0;i<n_;i++)
+      nodes_1d[i] = line_nodes_h(i,0);
+
+    for(int b=0;b<numBasis();b++) {
+      int t[3] = {0,0,0};
+      for(int d=0;d<dim_;d++)
+        t[d] = findCoordinate(nodes_1d,full_nodes_h(b,d));
+      TEUCHOS_TEST_FOR_EXCEPTION(t[0]<0 || t[1]<0 || t[2]<0,std::logic_error,
+                                 "TensorProductBasis: Node of basis function " << b << " is not a tensor product of 1D nodes.");
+      basisMap_h(t[0]+n_*(t[1]+n_*t[2])) = b;
+    }
+  }
+  for(int t=0;t<numBasis();t++)
+    TEUCHOS_TEST_FOR_EXCEPTION(basisMap_h(t)<0,std::logic_error,
+                               "TensorProductBasis: Basis \"" << basis_type << "\" of order " << basis_order
+                               << " is not a tensor product of a 1D basis.");
+  Kokkos::deep_copy(basisMap_,basisMap_h);
+
+  // check the products of the 1D values against the full basis, once
+  {
+    DeviceArray full_points("full_points",ir.num_points,dim_);
+    auto full_points_h = Kokkos::create_mirror_view(full_points);
+    for(int p=0;p<ir.num_points;p++)
+      for(int d=0;d<dim_;d++)
+        full_points_h(p,d) = points(p,d);
+    Kokkos::deep_copy(full_points,full_points_h);
+
+    DeviceArray full_values("full_values",numBasis(),ir.num_points);
+    full_basis->getValues(full_values,full_points,Intrepid2::OPERATOR_VALUE);
+    auto full_values_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),full_values);
+
+    double error = 0.0;
+    for(int i2=0;i2<nz_;i2++)
+      for(int i1=0;i1<n_;i1++)
+        for(int i0=0;i0<n_;i0++)
+          for(int q2=0;q2<qz_;q2++)
+            for(int q1=0;q1<q_;q1++)
+              for(int q0=0;q0<q_;q0++) {
+                const double tensor = values_h(0,i0,q0)*values_h(1,i1,q1)*values_h(2,i2,q2);
+                const double full = full_values_h(basisMap_h(i0+n_*(i1+n_*i2)),pointMap_h(q0+q_*(q1+q_*q2)));
+                error = std::max(error,std::fabs(tensor-full));
+              }
+    TEUCHOS_TEST_FOR_EXCEPTION(error>1e-10,std::logic_error,
+                               "TensorProductBasis: Basis \"" << basis_type << "\" of order " << basis_order
+                               << " differs from the product of 1D bases by " << error << ".");
+  }
+}
+
+}
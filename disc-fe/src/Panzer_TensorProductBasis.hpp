@@ -0,0 +1,296 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#ifndef PANZER_TENSOR_PRODUCT_BASIS_HPP
+#define PANZER_TENSOR_PRODUCT_BASIS_HPP
+
+#include "PanzerDiscFE_config.hpp"
+
+#include <string>
+
+#include "Kokkos_Core.hpp"
+#include "Phalanx_KokkosDeviceTypes.hpp"
+
+namespace panzer {
+
+class IntegrationRule;
+template <typename Scalar> class IntegrationValues2;
+
+/** Sum-factorized (tensor-product) form of an HGrad basis on quadrilaterals
+  * and hexahedra, for volume integration rules that are tensor products of a
+  * 1D rule.
+  *
+  * Only the 1D basis values and derivatives at the 1D points are stored. The
+  * reference gradient of a field at the integration points, and the integral
+  * of a reference flux against the reference basis gradients, are contracted
+  * one direction at a time. For order p this costs O(p^(d+1)) per cell
+  * instead of the O(p^(2d)) of the fully expanded <code>(cell,basis,point,dim)</code>
+  * arrays of <code>BasisValues2</code>, which are never formed.
+  *
+  * The maps between the tensor indices and the Intrepid2 basis and cubature
+  * point orderings are found when the object is built, and the tensor-product
+  * structure of the basis is checked against the full basis.
+  *
+  * A quadrilateral is handled as a hexahedron with a single basis function
+  * and point in the third direction.
+  */
+class TensorProductBasis {
+public:
+
+  TensorProductBasis();
+
+  /** Build the 1D tables.
+    *
+    * \param[in] basis_type Basis type, must be "HGrad"
+    * \param[in] basis_order Order of the basis
+    * \param[in] iv Integration values of a volume rule on a quadrilateral or hexahedron
+    *
+    * \throws std::logic_error If the basis or the integration rule is not of tensor-product form
+    */
+  TensorProductBasis(const std::string & basis_type,
+                     const int basis_order,
+                     const IntegrationValues2<double> & iv);
+
+  //! Can a basis of this type be used with this integration rule?
+  static bool isSupported(const std::string & basis_type,
+                          const IntegrationRule & ir);
+
+  //! Number of basis functions
+  int numBasis() const
+  { return n_*n_*nz_; }
+
+  //! Number of integration points
+  int numPoints() const
+  { return q_*q_*qz_; }
+
+  //! Spatial dimension
+  int dimension() const
+  { return dim_; }
+
+  //! Number of scalars of scratch space per cell needed by the contractions
+  int scratchSize() const
+  { return 2*q_*n_*nz_ + 3*q_*q_*nz_; }
+
+  /** Physical gradient of a field at the integration points.
+    *
+    * \param[in] cell Cell index
+    * \param[in] coeffs Basis coefficients of the field, <code>(cell,basis)</code>
+    * \param[in] jac_inv Inverse of the Jacobian, <code>(cell,point,dim,dim)</code>
+    * \param[out] grad Gradient, <code>(cell,point,dim)</code>
+    * \param[in] scratch Scratch space, <code>(cell,scratchSize())</code>
+    */
+  template <typename CoeffArray,typename JacInvArray,typename GradArray,typename ScratchArray>
+  KOKKOS_INLINE_FUNCTION
+  void evaluateGradient(const int cell,
+                        const CoeffArray & coeffs,
+                        const JacInvArray & jac_inv,
+                        const GradArray & grad,
+                        const ScratchArray & scratch) const;
+
+  /** Sum the integral of a reference flux against the reference basis
+    * gradients into a residual,
+    * \f$ r_i \mathrel{+}= \sum_q \sum_e \hat{\partial}_e \phi_i(x_q) G_e(x_q) \f$.
+    *
+    * The physical integral \f$ \int \nabla\phi_i \cdot F \f$ follows from
+    * \f$ G_e = w_q \sum_d J^{-1}_{ed} F_d \f$.
+    *
+    * \param[in] cell Cell index
+    * \param[in] ref_flux Reference flux, <code>(cell,point,dim)</code>
+    * \param[in,out] residual Residual, <code>(cell,basis)</code>
+    * \param[in] scratch Scratch space, <code>(cell,scratchSize())</code>
+    */
+  template <typename FluxArray,typename ResidualArray,typename ScratchArray>
+  KOKKOS_INLINE_FUNCTION
+  void integrateGradient(const int cell,
+                         const FluxArray & ref_flux,
+                         const ResidualArray & residual,
+                         const ScratchArray & scratch) const;
+
+private:
+
+  // number of 1D basis functions and points in the first two directions,
+  // and in the third (one for a quadrilateral)
+  int dim_, n_, q_, nz_, qz_;
+
+  // 1D basis values and derivatives, (direction,basis,point)
+  PHX::View<double***> values_, grads_;
+
+  // Intrepid2 basis and point index of each tensor index i0+n*(i1+n*i2)
+  PHX::View<int*> basisMap_, pointMap_;
+};
+
+// **********************************************************************
+template <typename CoeffArray,typename JacInvArray,typename GradArray,typename ScratchArray>
+KOKKOS_INLINE_FUNCTION
+void TensorProductBasis::
+evaluateGradient(const int cell,
+                 const CoeffArray & coeffs,
+                 const JacInvArray & jac_inv,
+                 const GradArray & grad,
+                 const ScratchArray & s) const
+{
+  const int n = n_, q = q_, nz = nz_, qz = qz_;
+
+  // scratch: a (q0,i1,i2) twice, then c (q0,q1,i2) three times
+  const int a_v = 0, a_d = q*n*nz, c_vv = 2*q*n*nz, c_dv = c_vv+q*q*nz, c_vd = c_dv+q*q*nz;
+
+  // contract the first direction
+  for(int i2=0;i2<nz;i2++) {
+    for(int i1=0;i1<n;i1++) {
+      for(int q0=0;q0<q;q0++) {
+        const int a = q0+q*(i1+n*i2);
+        s(cell,a_v+a) = 0.0;
+        s(cell,a_d+a) = 0.0;
+        for(int i0=0;i0<n;i0++) {
+          const int b = basisMap_(i0+n*(i1+n*i2));
+          s(cell,a_v+a) += values_(0,i0,q0)*coeffs(cell,b);
+          s(cell,a_d+a) += grads_(0,i0,q0)*coeffs(cell,b);
+        }
+      }
+    }
+  }
+
+  // contract the second direction
+  for(int i2=0;i2<nz;i2++) {
+    for(int q1=0;q1<q;q1++) {
+      for(int q0=0;q0<q;q0++) {
+        const int c = q0+q*(q1+q*i2);
+        s(cell,c_vv+c) = 0.0;
+        s(cell,c_dv+c) = 0.0;
+        s(cell,c_vd+c) = 0.0;
+        for(int i1=0;i1<n;i1++) {
+          const int a = q0+q*(i1+n*i2);
+          s(cell,c_vv+c) += values_(1,i1,q1)*s(cell,a_v+a);
+          s(cell,c_dv+c) += values_(1,i1,q1)*s(cell,a_d+a);
+          s(cell,c_vd+c) += grads_(1,i1,q1)*s(cell,a_v+a);
+        }
+      }
+    }
+  }
+
+  // contract the third direction and map the reference gradient, grad = J^{-T} ref_grad
+  for(int q2=0;q2<qz;q2++) {
+    for(int q1=0;q1<q;q1++) {
+      for(int q0=0;q0<q;q0++) {
+        const int pt = pointMap_(q0+q*(q1+q*q2));
+        for(int d=0;d<dim_;d++) {
+          grad(cell,pt,d) = 0.0;
+          for(int i2=0;i2<nz;i2++) {
+            const int c = q0+q*(q1+q*i2);
+            grad(cell,pt,d) += values_(2,i2,q2)*(jac_inv(cell,pt,0,d)*s(cell,c_dv+c) +
+                                                 jac_inv(cell,pt,1,d)*s(cell,c_vd+c));
+            if(dim_==3)
+              grad(cell,pt,d) += grads_(2,i2,q2)*jac_inv(cell,pt,2,d)*s(cell,c_vv+c);
+          }
+        }
+      }
+    }
+  }
+}
+
+// **********************************************************************
+template <typename FluxArray,typename ResidualArray,typename ScratchArray>
+KOKKOS_INLINE_FUNCTION
+void TensorProductBasis::
+integrateGradient(const int cell,
+                  const FluxArray & ref_flux,
+                  const ResidualArray & residual,
+                  const ScratchArray & s) const
+{
+  const int n = n_, q = q_, nz = nz_, qz = qz_;
+
+  // scratch: t (q0,q1,i2) three times, then u (q0,i1,i2) twice
+  const int t_0 = 0, t_1 = q*q*nz, t_2 = 2*q*q*nz, u_d = 3*q*q*nz, u_v = u_d+q*n*nz;
+
+  // contract the third direction
+  for(int i2=0;i2<nz;i2++) {
+    for(int q1=0;q1<q;q1++) {
+      for(int q0=0;q0<q;q0++) {
+        const int t = q0+q*(q1+q*i2);
+        s(cell,t_0+t) = 0.0;
+        s(cell,t_1+t) = 0.0;
+        s(cell,t_2+t) = 0.0;
+        for(int q2=0;q2<qz;q2++) {
+          const int pt = pointMap_(q0+q*(q1+q*q2));
+          s(cell,t_0+t) += values_(2,i2,q2)*ref_flux(cell,pt,0);
+          s(cell,t_1+t) += values_(2,i2,q2)*ref_flux(cell,pt,1);
+          if(dim_==3)
+            s(cell,t_2+t) += grads_(2,i2,q2)*ref_flux(cell,pt,2);
+        }
+      }
+    }
+  }
+
+  // contract the second direction, u_d pairs with the first direction
+  // derivative and u_v with its values
+  for(int i2=0;i2<nz;i2++) {
+    for(int i1=0;i1<n;i1++) {
+      for(int q0=0;q0<q;q0++) {
+        const int u = q0+q*(i1+n*i2);
+        s(cell,u_d+u) = 0.0;
+        s(cell,u_v+u) = 0.0;
+        for(int q1=0;q1<q;q1++) {
+          const int t = q0+q*(q1+q*i2);
+          s(cell,u_d+u) += values_(1,i1,q1)*s(cell,t_0+t);
+          s(cell,u_v+u) += grads_(1,i1,q1)*s(cell,t_1+t) + values_(1,i1,q1)*s(cell,t_2+t);
+        }
+      }
+    }
+  }
+
+  // contract the first direction
+  for(int i2=0;i2<nz;i2++) {
+    for(int i1=0;i1<n;i1++) {
+      for(int i0=0;i0<n;i0++) {
+        const int b = basisMap_(i0+n*(i1+n*i2));
+        for(int q0=0;q0<q;q0++) {
+          const int u = q0+q*(i1+n*i2);
+          residual(cell,b) += grads_(0,i0,q0)*s(cell,u_d+u) + values_(0,i0,q0)*s(cell,u_v+u);
+        }
+      }
+    }
+  }
+}
+
+}
+
+#endif
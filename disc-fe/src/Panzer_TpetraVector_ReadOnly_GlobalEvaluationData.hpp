@@ -70,10 +70,10 @@ public:
 
    //! Default constructor
    TpetraVector_ReadOnly_GlobalEvaluationData()
-      : isInitialized_(false) { }
+      : isInitialized_(false), importInFlight_(false) { }
 
    TpetraVector_ReadOnly_GlobalEvaluationData(const TpetraVector_ReadOnly_GlobalEvaluationData & src)
-      : isInitialized_(false) { initialize(src.importer_, src.ghostedMap_, src.ownedMap_); }
+      : isInitialized_(false), importInFlight_(false) { initialize(src.importer_, src.ghostedMap_, src.ownedMap_); }
 
    /** Initialize this object with some Tpetra communication objects. This method
      * must be called before an object of this type can be used.
@@ -86,7 +86,7 @@ public:
    TpetraVector_ReadOnly_GlobalEvaluationData(const Teuchos::RCP<const ImportType>& importer,
                                               const Teuchos::RCP<const MapType>&    ghostedMap,
                                               const Teuchos::RCP<const MapType>&    ownedMap)
-      : isInitialized_(false) { initialize(importer, ghostedMap, ownedMap); }
+      : isInitialized_(false), importInFlight_(false) { initialize(importer, ghostedMap, ownedMap); }
 
    /** Choose a few GIDs and instead of zeroing them out in the ghosted vector set
      * them to a specified value. Note that this is only useful for GIDs in the
@@ -114,6 +114,14 @@ public:
      */
    virtual void globalToGhost(int mem);
 
+   /** Post the halo exchange for the vector. The ghosted vector must
+     * not be read until <code>endGlobalToGhost</code> has been called.
+     */
+   virtual void beginGlobalToGhost(int mem);
+
+   //! Complete the halo exchange started by <code>beginGlobalToGhost</code>.
+   virtual void endGlobalToGhost(int mem);
+
    //! Clear out the ghosted vector 
    virtual void initializeData(); 
   
@@ -146,6 +154,7 @@ public:
 
 private:
    bool isInitialized_;
+   bool importInFlight_;
 
    Teuchos::RCP<const MapType> ghostedMap_;
    Teuchos::RCP<const MapType> ownedMap_;
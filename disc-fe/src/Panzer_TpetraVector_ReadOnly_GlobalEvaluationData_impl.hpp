@@ -124,6 +124,36 @@ globalToGhost(int /* mem */)
   PHX::ExecSpace().fence();
 }
 
+template <typename ScalarT,typename LocalOrdinalT,typename GlobalOrdinalT,typename NodeT>
+void 
+TpetraVector_ReadOnly_GlobalEvaluationData<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>::
+beginGlobalToGhost(int /* mem */)
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(ownedVector_ == Teuchos::null, std::logic_error,
+    "Owned vector has not been set, can't perform the halo exchange!");
+  TEUCHOS_TEST_FOR_EXCEPTION(importInFlight_, std::logic_error,
+    "TpetraVector_ReadOnly_GED: halo exchange already in flight, call \"endGlobalToGhost\" first!");
+
+  initializeData();
+
+  // Post the sends and receives, the unpack happens in endGlobalToGhost.
+  ghostedVector_->beginImport(*ownedVector_, *importer_, Tpetra::INSERT);
+  importInFlight_ = true;
+}
+
+template <typename ScalarT,typename LocalOrdinalT,typename GlobalOrdinalT,typename NodeT>
+void 
+TpetraVector_ReadOnly_GlobalEvaluationData<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>::
+endGlobalToGhost(int /* mem */)
+{
+  if(!importInFlight_)
+    return;
+
+  ghostedVector_->endImport(*ownedVector_, *importer_, Tpetra::INSERT);
+  importInFlight_ = false;
+  PHX::ExecSpace().fence();
+}
+
 template <typename ScalarT,typename LocalOrdinalT,typename GlobalOrdinalT,typename NodeT>
 void 
 TpetraVector_ReadOnly_GlobalEvaluationData<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>::
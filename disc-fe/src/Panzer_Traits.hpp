@@ -142,6 +142,31 @@ namespace panzer {
 
   };
   
+  // ******************************************************************
+  // *** Derivative storage of the AD scalar types
+  //     Number of derivative components a type holds without heap
+  //     allocation, zero for the dynamically sized types.  SLFad stores
+  //     up to that many and runs at the length set per element block,
+  //     SFad always has exactly that many.
+  // ******************************************************************
+  template <typename FadT>
+  struct FadStaticCapacity {
+    static constexpr int value = 0;
+    static constexpr bool fixed = false;
+  };
+
+  template <typename T,int N>
+  struct FadStaticCapacity<Sacado::Fad::SLFad<T,N> > {
+    static constexpr int value = N;
+    static constexpr bool fixed = false;
+  };
+
+  template <typename T,int N>
+  struct FadStaticCapacity<Sacado::Fad::SFad<T,N> > {
+    static constexpr int value = N;
+    static constexpr bool fixed = true;
+  };
+
   // ******************************************************************
   // *** Access Residual/Jacobian/Tangent::ScalarT 
   //     Specified for Sacodo::ScalarParameterEntry definition which use function apply
@@ -362,6 +362,31 @@ getBasisValues(const panzer::BasisDescriptor & basis_description,
 }
 
 
+void
+WorksetDetails::
+setIntegrationValues(const panzer::IntegrationDescriptor & description,
+                     const Teuchos::RCP<panzer::IntegrationValues2<double> > & values) const
+{
+  TEUCHOS_ASSERT(values!=Teuchos::null);
+
+  integration_values_map_[description.getKey()] = values;
+  ir_degrees->push_back(values->int_rule->cubature_degree);
+  int_rules.push_back(values);
+}
+
+void
+WorksetDetails::
+setBasisValues(const panzer::BasisDescriptor & basis_description,
+               const panzer::IntegrationDescriptor & integration_description,
+               const Teuchos::RCP<panzer::BasisValues2<double> > & values) const
+{
+  TEUCHOS_ASSERT(values!=Teuchos::null);
+
+  basis_integration_values_map_[basis_description.getKey()][integration_description.getKey()] = values;
+  bases.push_back(values);
+  basis_names->push_back(values->basis_layout->name());
+}
+
 panzer::PointValues2<double> &
 WorksetDetails::
 getPointValues(const panzer::PointDescriptor & description) const
@@ -284,6 +284,23 @@ namespace panzer {
     panzer::PointValues2<double> &
     getPointValues(const panzer::PointDescriptor & point_description) const;
 
+    /**
+     * \brief Register integration values built elsewhere (e.g. taken from a
+     * <code>WorksetGeometryCache</code>), later calls to <code>getIntegrationValues</code>
+     * return them instead of recomputing
+     */
+    void
+    setIntegrationValues(const panzer::IntegrationDescriptor & description,
+                         const Teuchos::RCP<panzer::IntegrationValues2<double> > & values) const;
+
+    /**
+     * \brief Register basis values built elsewhere for a basis and integration description
+     */
+    void
+    setBasisValues(const panzer::BasisDescriptor & basis_description,
+                   const panzer::IntegrationDescriptor & integration_description,
+                   const Teuchos::RCP<panzer::BasisValues2<double> > & values) const;
+
     /// Number of total cells in workset (owned, ghost, and virtual)
     int numCells() const {return num_cells;}
 
@@ -347,10 +364,10 @@ namespace panzer {
   class Workset : public WorksetDetails {
   public:
     //! Default constructor, identifier is a useless 0 by default
-    Workset() : identifier_(0) {}
+    Workset() : identifier_(0), version_(0) {}
 
     //! Constructor that that requires a unique identifier
-    Workset(std::size_t identifier) : identifier_(identifier) {}
+    Workset(std::size_t identifier) : identifier_(identifier), version_(0) {}
 
     //! Set the unique identifier for this workset, this is not an index!
     void setIdentifier(std::size_t identifier) { identifier_ = identifier; }
@@ -358,6 +375,14 @@ namespace panzer {
     //! Get the unique identifier for this workset, this is not an index!
     std::size_t getIdentifier() const { return identifier_; }
 
+    //! Set the version of the workset build (see WorksetContainer::getVolumeWorksetVersion)
+    void setVersion(std::size_t version) { version_ = version; }
+
+    /** Get the version of the workset build, zero if the workset was not built by a
+      * WorksetContainer. Together with the identifier it tells a rebuilt workset apart.
+      */
+    std::size_t getVersion() const { return version_; }
+
     double alpha;
     double beta;
     double time;
@@ -392,6 +417,7 @@ namespace panzer {
 
   private:
     std::size_t identifier_;
+    std::size_t version_;
   };
 
   std::ostream& operator<<(std::ostream& os, const panzer::Workset& w);
@@ -45,18 +45,34 @@
 #include "Panzer_IntrepidOrientation.hpp"
 
 #include "Panzer_Workset_Utilities.hpp"
+#include "Panzer_Workset_Builder.hpp"
 #include "Panzer_CommonArrayFactories.hpp"
 #include "Panzer_Dimension.hpp"
 
+#include <atomic>
+
 namespace panzer {
 
+namespace {
+
+//! Volume workset versions, unique over all containers
+std::size_t nextVolumeWorksetVersion()
+{
+  static std::atomic<std::size_t> counter(0);
+  return ++counter;
+}
+
+}
+
 //! Default contructor, starts with no workset factory objects
 WorksetContainer::WorksetContainer()
-   : worksetSize_(1)
+   : cacheSideWorksetValues_(true), worksetSize_(1), coordinateVersion_(0)
+   , volumeWorksetVersion_(nextVolumeWorksetVersion())
 {}
 WorksetContainer::WorksetContainer(const Teuchos::RCP<const WorksetFactoryBase> & factory,
                                    const std::map<std::string,WorksetNeeds> & needs)
-   : wkstFactory_(factory), worksetSize_(0)
+   : wkstFactory_(factory), cacheSideWorksetValues_(true), worksetSize_(0), coordinateVersion_(0)
+   , volumeWorksetVersion_(nextVolumeWorksetVersion())
 {
   // thats all!
   ebToNeeds_ = needs;
@@ -67,7 +83,11 @@ WorksetContainer::WorksetContainer(const Teuchos::RCP<const WorksetFactoryBase>
   */
 WorksetContainer::WorksetContainer(const WorksetContainer & wc)
    : wkstFactory_(wc.wkstFactory_)
+   , cacheSideWorksetValues_(wc.cacheSideWorksetValues_)
    , worksetSize_(wc.worksetSize_)
+   , geometryCache_(wc.geometryCache_)
+   , coordinateVersion_(wc.coordinateVersion_)
+   , volumeWorksetVersion_(nextVolumeWorksetVersion())
 {
 }
 
@@ -83,11 +103,15 @@ void WorksetContainer::clear()
 void WorksetContainer::clearVolumeWorksets()
 {
   worksets_.clear();
+  volumeWorksetVersion_ = nextVolumeWorksetVersion();
 }
 
 void WorksetContainer::clearSideWorksets()
 {
   sideWorksets_.clear();
+  sidesetWorksets_.clear();
+  sidesetChunks_.clear();
+  activeSideChunk_.clear();
 }
 
 void WorksetContainer::
@@ -109,6 +133,40 @@ const WorksetNeeds & WorksetContainer::lookupNeeds(const std::string & eBlock) c
    return itr->second;
 }
 
+void WorksetContainer::
+setMeshCoordinateVersion(std::size_t version)
+{
+  if(version==coordinateVersion_)
+    return;
+
+  coordinateVersion_ = version;
+  clearVolumeWorksets();
+  if(geometryCache_!=Teuchos::null)
+    geometryCache_->evictOtherCoordinateVersions(coordinateVersion_);
+}
+
+namespace {
+
+//! Needs without integration and basis values, those come from the geometry cache
+WorksetNeeds withoutGeometry(const WorksetNeeds & needs)
+{
+  WorksetNeeds stripped;
+  stripped.cellData = needs.cellData;
+  for(const auto & pd : needs.getPoints())
+    stripped.addPoint(pd);
+  return stripped;
+}
+
+}
+
+void WorksetContainer::
+populateCachedValues(const WorksetNeeds & needs,std::vector<Workset> & worksets)
+{
+  for(std::size_t i=0;i<worksets.size();i++)
+    for(std::size_t j=0;j<worksets[i].numDetails();j++)
+      geometryCache_->populateValues(needs,coordinateVersion_,worksets[i](j));
+}
+
 Teuchos::RCP<std::vector<Workset> >
 WorksetContainer::getWorksets(const WorksetDescriptor & wd)
 {
@@ -119,7 +177,14 @@ WorksetContainer::getWorksets(const WorksetDescriptor & wd)
       WorksetNeeds needs;
       if(hasNeeds())
         needs = lookupNeeds(wd.getElementBlock());
-      worksetVector = wkstFactory_->getWorksets(wd,needs);
+
+      if(geometryCache_!=Teuchos::null && hasNeeds() && !wd.useSideset()) {
+        worksetVector = wkstFactory_->getWorksets(wd,withoutGeometry(needs));
+        if(worksetVector!=Teuchos::null)
+          populateCachedValues(needs,*worksetVector);
+      }
+      else
+        worksetVector = wkstFactory_->getWorksets(wd,needs);
 
       // apply orientations to the just constructed worksets
       if(worksetVector!=Teuchos::null && wd.applyOrientations()) {
@@ -131,6 +196,10 @@ WorksetContainer::getWorksets(const WorksetDescriptor & wd)
 
       // store vector for reuse in the future
       worksets_[wd] = worksetVector;
+      volumeWorksetVersion_ = nextVolumeWorksetVersion();
+      if(worksetVector!=Teuchos::null)
+        for(auto & wkst : *worksetVector)
+          wkst.setVersion(volumeWorksetVersion_);
    }
    else
       worksetVector = itr->second;
@@ -146,7 +215,13 @@ WorksetContainer::generateWorksets(const WorksetDescriptor & wd)
    if(itr==worksets_.end()) {  // couldn't find workset, build it!
       WorksetNeeds needs;
       if(hasNeeds()) needs = lookupNeeds(wd.getElementBlock());
-      worksetVector = wkstFactory_->generateWorksets(wd,needs);
+
+      if(geometryCache_!=Teuchos::null && hasNeeds() && !wd.useSideset()) {
+        worksetVector = wkstFactory_->generateWorksets(wd,withoutGeometry(needs));
+        populateCachedValues(needs,*worksetVector);
+      }
+      else
+        worksetVector = wkstFactory_->generateWorksets(wd,needs);
 
       // apply orientations to the just constructed worksets
       if(!worksetVector->empty() && wd.applyOrientations()) {
@@ -157,6 +232,10 @@ WorksetContainer::generateWorksets(const WorksetDescriptor & wd)
 
       // store vector for reuse in the future
       worksets_[wd] = worksetVector;
+      volumeWorksetVersion_ = nextVolumeWorksetVersion();
+      if(worksetVector!=Teuchos::null)
+        for(auto & wkst : *worksetVector)
+          wkst.setVersion(volumeWorksetVersion_);
    }
    else
       worksetVector = itr->second;
@@ -231,6 +310,54 @@ if( worksetPtr.is_null() )
    return worksetPtr;
 }
 
+Teuchos::RCP<std::vector<Workset> >
+WorksetContainer::getSideWorksetChunks(const WorksetDescriptor & desc)
+{
+   auto itr = sidesetChunks_.find(desc);
+   if(itr!=sidesetChunks_.end())
+      return itr->second;
+
+   // chunk size: descriptor size, else the container size (zero means no limit)
+   int worksetSize = desc.getWorksetSize();
+   if(worksetSize==WorksetSizeType::CLASSIC_MODE)
+      worksetSize = static_cast<int>(worksetSize_);
+
+   Teuchos::RCP<std::vector<Workset> > chunks
+      = wkstFactory_->getSideWorksetChunks(desc,lookupNeeds(desc.getElementBlock(0)),worksetSize,cacheSideWorksetValues_);
+   if(chunks==Teuchos::null)
+      chunks = Teuchos::rcp(new std::vector<Workset>);
+
+   if(!chunks->empty())
+      setIdentifiers(desc,*chunks);
+
+   // store chunks for reuse in the future
+   sidesetChunks_[desc] = chunks;
+   return chunks;
+}
+
+Workset &
+WorksetContainer::getSideWorksetChunk(const WorksetDescriptor & desc,std::size_t chunk)
+{
+   std::vector<Workset> & chunks = *getSideWorksetChunks(desc);
+   TEUCHOS_TEST_FOR_EXCEPTION(chunk>=chunks.size(),std::out_of_range,
+                              "WorksetContainer::getSideWorksetChunk: chunk " << chunk << " out of range, "
+                              "sideset \"" << desc.getSideset() << "\" has " << chunks.size() << " chunks");
+   Workset & workset = chunks[chunk];
+   if(cacheSideWorksetValues_)
+      return workset;
+
+   // release the values of the chunk used last, then (re)build this one
+   auto active = activeSideChunk_.find(desc);
+   if(active!=activeSideChunk_.end() && active->second!=chunk) {
+      chunks[active->second].int_rules.clear();
+      chunks[active->second].bases.clear();
+   }
+   if(workset.int_rules.empty() && workset.bases.empty())
+      populateValueArrays(workset.num_cells,true,lookupNeeds(desc.getElementBlock(0)),workset);
+   activeSideChunk_[desc] = chunk;
+
+   return workset;
+}
 
 void WorksetContainer::
 setGlobalIndexer(const Teuchos::RCP<const panzer::GlobalIndexer> & ugi)
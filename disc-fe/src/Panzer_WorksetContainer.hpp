@@ -52,6 +52,7 @@
 #include "Panzer_WorksetFactoryBase.hpp"
 #include "Panzer_WorksetDescriptor.hpp" // what the workset is defined over
 #include "Panzer_WorksetNeeds.hpp"      // whats in a workset basis/integration rules
+#include "Panzer_WorksetGeometryCache.hpp"
 
 namespace panzer {
 
@@ -149,6 +150,56 @@ public:
    Teuchos::RCP<std::map<unsigned,Workset> > getSideWorksets(const WorksetDescriptor & desc);
    Teuchos::RCP<Workset> getSideWorkset(const WorksetDescriptor & desc);
 
+   /** Side worksets of a sideset split in chunks of at most the workset size: the
+     * size of the descriptor if one is given, <code>getWorksetSize()</code> in classic
+     * mode (the whole sideset if that is zero). When side workset values are not
+     * cached the chunks carry no basis or integration values, use
+     * <code>getSideWorksetChunk</code> to get a chunk ready for evaluation.
+     */
+   Teuchos::RCP<std::vector<Workset> > getSideWorksetChunks(const WorksetDescriptor & desc);
+
+   /** Access a chunk of a sideset with its value arrays populated. If side workset
+     * values are not cached, the values of the chunk previously accessed for this
+     * descriptor are released, so at most one chunk per sideset holds values.
+     */
+   Workset & getSideWorksetChunk(const WorksetDescriptor & desc,std::size_t chunk);
+
+   /** Keep the basis and integration values of every side workset chunk (default),
+     * or rebuild them each time a chunk is accessed to bound the memory used on
+     * large sidesets. Clears the side worksets.
+     */
+   void setCacheSideWorksetValues(bool flag)
+   { clearSideWorksets(); cacheSideWorksetValues_ = flag; }
+
+   bool getCacheSideWorksetValues() const
+   { return cacheSideWorksetValues_; }
+
+   /** Reuse the integration and basis values of volume worksets when they are
+     * rebuilt (see <code>WorksetGeometryCache</code>). The cache is kept by
+     * <code>clear()</code> and <code>setFactory()</code> and may be shared between
+     * containers. A null cache (default) disables reuse. Clears the volume worksets.
+     */
+   void setGeometryCache(const Teuchos::RCP<WorksetGeometryCache> & cache)
+   { clearVolumeWorksets(); geometryCache_ = cache; }
+
+   Teuchos::RCP<WorksetGeometryCache> getGeometryCache() const
+   { return geometryCache_; }
+
+   /** Signal that the mesh coordinates changed. Volume worksets are rebuilt on
+     * next access and cached geometry of other coordinate versions is evicted.
+     */
+   void setMeshCoordinateVersion(std::size_t version);
+
+   std::size_t getMeshCoordinateVersion() const
+   { return coordinateVersion_; }
+
+   /** Version of the volume worksets. It changes whenever volume worksets are built
+     * or cleared and is never reused, not even by another container. Data derived
+     * from the worksets (colorings, classifications, offsets) is keyed on it.
+     */
+   std::size_t getVolumeWorksetVersion() const
+   { return volumeWorksetVersion_; }
+
    /** Set the global indexer. This is used solely for accessing the
      * orientations.
      */
@@ -196,6 +247,11 @@ private:
      */
    void applyOrientations(const WorksetDescriptor & desc,std::map<unsigned,Workset> & worksets) const;
 
+   /** Fill the integration and basis values of freshly built volume worksets
+     * from the geometry cache.
+     */
+   void populateCachedValues(const WorksetNeeds & needs,std::vector<Workset> & worksets);
+
    /** Set all the workset identifier in a vector.
      *
      * \param[in] wd       Workset descriptor, this defines the base point for the identifiers
@@ -224,9 +280,17 @@ private:
    SideMap sideWorksets_;
    // one side - one workset. We donot consider worksetSize here (How about two physical BC upon one siderset?
    std::unordered_map<WorksetDescriptor,Teuchos::RCP<Workset>> sidesetWorksets_;
+   // sideset split in chunks of at most worksetSize_ cells, and the chunk holding values when not cached
+   std::unordered_map<WorksetDescriptor,Teuchos::RCP<std::vector<Workset> > > sidesetChunks_;
+   std::unordered_map<WorksetDescriptor,std::size_t> activeSideChunk_;
+   bool cacheSideWorksetValues_;
 
    std::size_t worksetSize_;
 
+   Teuchos::RCP<WorksetGeometryCache> geometryCache_;
+   std::size_t coordinateVersion_;
+   std::size_t volumeWorksetVersion_;
+
    Teuchos::RCP<const panzer::GlobalIndexer> globalIndexer_;
 
    Teuchos::RCP<std::vector<Intrepid2::Orientation> >  orientations_;
@@ -100,6 +100,17 @@ public:
    getSideWorkset(const panzer::WorksetDescriptor & desc,
                    const panzer::WorksetNeeds & needs) const =0;
 
+   /** Build the side worksets of a sideset, each holding at most <code>worksetSize</code>
+     * cells (the whole sideset in one workset if <code>worksetSize<=0</code>). The basis and
+     * integration values are only computed if <code>populateValues</code> is true.
+     */
+   virtual
+   Teuchos::RCP<std::vector<panzer::Workset> >
+   getSideWorksetChunks(const panzer::WorksetDescriptor & desc,
+                        const panzer::WorksetNeeds & needs,
+                        const int worksetSize,
+                        const bool populateValues) const =0;
+
    /**
     * \brief Used to apply orientations to any bases added to the worksets
     *
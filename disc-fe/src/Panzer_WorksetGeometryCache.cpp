@@ -0,0 +1,356 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+
+#include "Panzer_WorksetGeometryCache.hpp"
+
+#include "Panzer_Workset.hpp"
+#include "Panzer_WorksetNeeds.hpp"
+#include "Panzer_IntegrationRule.hpp"
+#include "Panzer_PureBasis.hpp"
+#include "Panzer_BasisIRLayout.hpp"
+#include "Panzer_IntegrationValues2.hpp"
+#include "Panzer_BasisValues2.hpp"
+#include "Panzer_HashUtils.hpp"
+
+namespace panzer {
+
+namespace {
+
+template <typename ArrayT>
+std::size_t bytesOf(const ArrayT & array)
+{ return array.size()*sizeof(double); }
+
+std::size_t bytesOf(const IntegrationValues2<double> & iv)
+{
+  return bytesOf(iv.cub_points) + bytesOf(iv.side_cub_points) + bytesOf(iv.cub_weights)
+       + bytesOf(iv.node_coordinates) + bytesOf(iv.jac) + bytesOf(iv.jac_inv) + bytesOf(iv.jac_det)
+       + bytesOf(iv.weighted_measure) + bytesOf(iv.weighted_normals) + bytesOf(iv.surface_normals)
+       + bytesOf(iv.surface_rotation_matrices) + bytesOf(iv.covarient) + bytesOf(iv.contravarient)
+       + bytesOf(iv.norm_contravarient) + bytesOf(iv.ip_coordinates) + bytesOf(iv.ref_ip_coordinates);
+}
+
+std::size_t bytesOf(const BasisValues2<double> & bv)
+{
+  // weighted_grad_basis is built on the first getGradBasisValues(true) call,
+  // count it at the size of grad_basis until then
+  const std::size_t weightedGradBytes =
+      bv.weighted_grad_basis.size()>0 ? bytesOf(bv.weighted_grad_basis)
+                                      : (bv.build_weighted ? bytesOf(bv.grad_basis) : 0);
+
+  return bytesOf(bv.basis_ref_scalar) + bytesOf(bv.basis_scalar)
+       + bytesOf(bv.basis_ref_vector) + bytesOf(bv.basis_vector)
+       + bytesOf(bv.grad_basis_ref) + bytesOf(bv.grad_basis)
+       + bytesOf(bv.curl_basis_ref_scalar) + bytesOf(bv.curl_basis_scalar)
+       + bytesOf(bv.curl_basis_ref_vector) + bytesOf(bv.curl_basis_vector)
+       + bytesOf(bv.div_basis_ref) + bytesOf(bv.div_basis)
+       + bytesOf(bv.weighted_basis_scalar) + bytesOf(bv.weighted_basis_vector)
+       + weightedGradBytes + bytesOf(bv.weighted_curl_basis_scalar)
+       + bytesOf(bv.weighted_curl_basis_vector) + bytesOf(bv.weighted_div_basis)
+       + bytesOf(bv.basis_coordinates_ref) + bytesOf(bv.basis_coordinates);
+}
+
+}
+
+std::size_t WorksetGeometryCache::KeyHash::
+operator()(const Key & k) const
+{
+  std::size_t seed = 0;
+  panzer::hash_combine(seed,k.elementBlock);
+  panzer::hash_combine(seed,k.cells!=nullptr ? k.cells->hash : 0);
+  panzer::hash_combine(seed,k.integration);
+  panzer::hash_combine(seed,k.basis);
+  panzer::hash_combine(seed,k.coordinateVersion);
+  return seed;
+}
+
+WorksetGeometryCache::
+WorksetGeometryCache()
+  : memoryBudget_(0), memoryUsage_(0), hits_(0), misses_(0), evictions_(0)
+{}
+
+void WorksetGeometryCache::
+setMemoryBudget(std::size_t bytes)
+{
+  memoryBudget_ = bytes;
+  enforceBudget();
+}
+
+std::shared_ptr<const WorksetGeometryCache::Cells> WorksetGeometryCache::
+buildCells(const WorksetDetails & details)
+{
+  const int numCells = details.num_cells;
+
+  auto cells = std::make_shared<Cells>();
+  cells->hash = 0;
+  panzer::hash_combine(cells->hash,numCells);
+
+  auto cellIds = Kokkos::create_mirror_view(details.getLocalCellIDs());
+  Kokkos::deep_copy(cellIds,details.getLocalCellIDs());
+  cells->localIds.resize(numCells);
+  for(int c=0;c<numCells;c++) {
+    cells->localIds[c] = cellIds(c);
+    panzer::hash_combine(cells->hash,cellIds(c));
+  }
+
+  // the coordinates distinguish moved meshes and different meshes with the same numbering
+  auto coords = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),details.cell_vertex_coordinates.get_static_view());
+  cells->coordinates.reserve(numCells*coords.extent(1)*coords.extent(2));
+  for(int c=0;c<numCells;c++)
+    for(std::size_t n=0;n<coords.extent(1);n++)
+      for(std::size_t d=0;d<coords.extent(2);d++) {
+        cells->coordinates.push_back(coords(c,n,d));
+        panzer::hash_combine(cells->hash,coords(c,n,d));
+      }
+
+  return cells;
+}
+
+void WorksetGeometryCache::
+populateValues(const WorksetNeeds & needs,std::size_t coordinateVersion,WorksetDetails & details)
+{
+  using Teuchos::RCP;
+  using Teuchos::rcp;
+
+  const std::size_t num_cells = details.num_cells;
+
+  // required for backwards compatibility, see populateValueArrays
+  if(details.numOwnedCells()==-1)
+    details.setNumberOfCells(num_cells,0,0);
+
+  Key key;
+  key.elementBlock = details.getElementBlock();
+  key.cells = buildCells(details);
+  key.coordinateVersion = coordinateVersion;
+
+  // integration rule and basis vectors: all basis/integration rule pairs
+  details.ir_degrees = rcp(new std::vector<int>(0));
+  details.basis_names = rcp(new std::vector<std::string>(0));
+  for(std::size_t i=0;i<needs.int_rules.size();i++) {
+    const RCP<const IntegrationRule> & ir = needs.int_rules[i];
+
+    key.integration = ir->getKey();
+    key.basis = 0;
+
+    details.ir_degrees->push_back(ir->cubature_degree);
+
+    RCP<IntegrationValues2<double> > iv = findIntegrationValues(key);
+    if(iv==Teuchos::null) {
+      iv = rcp(new IntegrationValues2<double>("",true));
+      iv->setupArrays(ir);
+      iv->evaluateValues(details.cell_vertex_coordinates,num_cells);
+      insert(key,iv);
+    }
+    details.int_rules.push_back(iv);
+
+    for(std::size_t b=0;b<needs.bases.size();b++) {
+      RCP<BasisIRLayout> b_layout = rcp(new BasisIRLayout(needs.bases[b],*ir));
+      details.basis_names->push_back(b_layout->name());
+
+      key.basis = BasisDescriptor(needs.bases[b]->order(),needs.bases[b]->type()).getKey();
+
+      RCP<BasisValues2<double> > bv = findBasisValues(key);
+      if(bv==Teuchos::null) {
+        bv = rcp(new BasisValues2<double>("",true,true));
+        bv->setupArrays(b_layout);
+        bv->evaluateValues(iv->cub_points,
+                           iv->jac,
+                           iv->jac_det,
+                           iv->jac_inv,
+                           iv->weighted_measure,
+                           details.cell_vertex_coordinates,
+                           true,
+                           num_cells);
+        insert(key,bv);
+      }
+      details.bases.push_back(bv);
+    }
+  }
+
+  // descriptor based needs, the workset builds missing values itself
+  for(const auto & id : needs.getIntegrators()) {
+    key.integration = id.getKey();
+    key.basis = 0;
+
+    RCP<IntegrationValues2<double> > iv = findIntegrationValues(key);
+    if(iv==Teuchos::null) {
+      details.getIntegrationValues(id);
+      insert(key,details.int_rules.back());
+    }
+    else
+      details.setIntegrationValues(id,iv);
+  }
+
+  for(const auto & bd : needs.getBases()) {
+    for(const auto & id : needs.getIntegrators()) {
+      key.integration = id.getKey();
+      key.basis = bd.getKey();
+
+      RCP<BasisValues2<double> > bv = findBasisValues(key);
+      if(bv==Teuchos::null) {
+        details.getBasisValues(bd,id);
+        insert(key,details.bases.back());
+      }
+      else
+        details.setBasisValues(bd,id,bv);
+    }
+
+    // point values are cheap and may be modified by evaluators, they are not cached
+    for(const auto & pd : needs.getPoints())
+      details.getBasisValues(bd,pd);
+  }
+}
+
+WorksetGeometryCache::Entry *
+WorksetGeometryCache::
+find(const Key & key)
+{
+  auto itr = entries_.find(key);
+  if(itr==entries_.end()) {
+    misses_++;
+    return nullptr;
+  }
+
+  hits_++;
+
+  // move to the front of the least recently used list
+  lru_.splice(lru_.begin(),lru_,itr->second.lru);
+  return &itr->second;
+}
+
+Teuchos::RCP<IntegrationValues2<double> >
+WorksetGeometryCache::
+findIntegrationValues(const Key & key)
+{
+  Entry * entry = find(key);
+  return entry!=nullptr ? entry->integrationValues : Teuchos::null;
+}
+
+Teuchos::RCP<BasisValues2<double> >
+WorksetGeometryCache::
+findBasisValues(const Key & key)
+{
+  Entry * entry = find(key);
+  return entry!=nullptr ? entry->basisValues : Teuchos::null;
+}
+
+void WorksetGeometryCache::
+insert(const Key & key,const Teuchos::RCP<IntegrationValues2<double> > & values)
+{
+  TEUCHOS_ASSERT(values!=Teuchos::null);
+
+  Entry entry;
+  entry.integrationValues = values;
+  entry.bytes = bytesOf(*values);
+  insert(key,entry);
+}
+
+void WorksetGeometryCache::
+insert(const Key & key,const Teuchos::RCP<BasisValues2<double> > & values)
+{
+  TEUCHOS_ASSERT(values!=Teuchos::null);
+
+  Entry entry;
+  entry.basisValues = values;
+  entry.bytes = bytesOf(*values);
+  insert(key,entry);
+}
+
+void WorksetGeometryCache::
+insert(const Key & key,Entry entry)
+{
+  auto itr = entries_.find(key);
+  if(itr!=entries_.end())
+    erase(itr);
+
+  lru_.push_front(key);
+  entry.lru = lru_.begin();
+  memoryUsage_ += entry.bytes;
+  entries_.emplace(key,entry);
+
+  enforceBudget();
+}
+
+void WorksetGeometryCache::
+erase(EntryMap::iterator itr)
+{
+  memoryUsage_ -= itr->second.bytes;
+  lru_.erase(itr->second.lru);
+  entries_.erase(itr);
+}
+
+void WorksetGeometryCache::
+enforceBudget()
+{
+  if(memoryBudget_==0)
+    return;
+
+  // always keep the most recent entry, it is in use by the workset being built
+  while(memoryUsage_>memoryBudget_ && lru_.size()>1) {
+    erase(entries_.find(lru_.back()));
+    evictions_++;
+  }
+}
+
+void WorksetGeometryCache::
+evictOtherCoordinateVersions(std::size_t coordinateVersion)
+{
+  for(auto itr=entries_.begin();itr!=entries_.end();) {
+    if(itr->first.coordinateVersion!=coordinateVersion) {
+      auto stale = itr++;
+      erase(stale);
+      evictions_++;
+    }
+    else
+      ++itr;
+  }
+}
+
+void WorksetGeometryCache::
+clear()
+{
+  entries_.clear();
+  lru_.clear();
+  memoryUsage_ = 0;
+}
+
+}
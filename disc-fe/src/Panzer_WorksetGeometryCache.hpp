@@ -0,0 +1,189 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+
+#ifndef __Panzer_WorksetGeometryCache_hpp__
+#define __Panzer_WorksetGeometryCache_hpp__
+
+#include "Teuchos_RCP.hpp"
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace panzer {
+
+template <typename Scalar> class IntegrationValues2;
+template <typename Scalar> class BasisValues2;
+class WorksetDetails;
+struct WorksetNeeds;
+
+/** \brief Cache of the geometric values (integration and basis values) of
+  *        volume worksets.
+  *
+  * Integration values (Jacobians, weighted measures, ...) and basis values
+  * (weighted basis functions and gradients, ...) only depend on the cells of
+  * a workset and their coordinates. This cache keeps them alive independently
+  * of the worksets, so that rebuilding worksets (after
+  * <code>WorksetContainer::clear()</code>, a new factory, ...) reuses them
+  * instead of recomputing.
+  *
+  * Entries are keyed by the element block, the cells of the workset (their
+  * local ids and vertex coordinates), the integration and basis descriptors,
+  * and a mesh coordinate version. Keys compare the cells exactly, their hash
+  * is only used to bucket the entries. When a memory budget is set the least
+  * recently used entries are evicted once the estimated footprint exceeds it.
+  */
+class WorksetGeometryCache {
+public:
+
+  //! Cells of a workset, shared by the keys of all values computed on them
+  struct Cells {
+    std::vector<int> localIds;       //! Local cell ids
+    std::vector<double> coordinates; //! Vertex coordinates, cell major
+    std::size_t hash;                //! Hash of the ids and coordinates, only used for bucketing
+
+    bool operator==(const Cells & c) const
+    { return hash==c.hash && localIds==c.localIds && coordinates==c.coordinates; }
+  };
+
+  struct Key {
+    std::string elementBlock;
+    std::shared_ptr<const Cells> cells;
+    std::size_t integration;       //! Integration descriptor key
+    std::size_t basis;             //! Basis descriptor key, zero for integration values
+    std::size_t coordinateVersion; //! Mesh coordinate version
+
+    bool operator==(const Key & k) const
+    { return integration==k.integration && basis==k.basis
+             && coordinateVersion==k.coordinateVersion && elementBlock==k.elementBlock
+             && (cells==k.cells || (cells!=nullptr && k.cells!=nullptr && *cells==*k.cells)); }
+  };
+
+  struct KeyHash {
+    std::size_t operator()(const Key & k) const;
+  };
+
+  //! Empty cache with no memory budget
+  WorksetGeometryCache();
+
+  /** Set the memory budget in bytes, zero (default) means no limit. Entries
+    * are evicted immediately if the current footprint exceeds the budget.
+    */
+  void setMemoryBudget(std::size_t bytes);
+
+  std::size_t getMemoryBudget() const
+  { return memoryBudget_; }
+
+  //! Estimated number of bytes held by the cached values
+  std::size_t getMemoryUsage() const
+  { return memoryUsage_; }
+
+  //! Number of cached integration and basis values
+  std::size_t size() const
+  { return entries_.size(); }
+
+  /** Fill the integration and basis values required by <code>needs</code> on a
+    * volume workset, using cached values when available and caching the values
+    * that had to be computed. Supports both the integration rule/basis vectors
+    * and the descriptor based needs.
+    */
+  void populateValues(const WorksetNeeds & needs,std::size_t coordinateVersion,WorksetDetails & details);
+
+  //! Look up integration values, null if not cached (counts a hit or a miss)
+  Teuchos::RCP<IntegrationValues2<double> > findIntegrationValues(const Key & key);
+
+  //! Look up basis values, null if not cached (counts a hit or a miss)
+  Teuchos::RCP<BasisValues2<double> > findBasisValues(const Key & key);
+
+  void insert(const Key & key,const Teuchos::RCP<IntegrationValues2<double> > & values);
+  void insert(const Key & key,const Teuchos::RCP<BasisValues2<double> > & values);
+
+  //! Drop all values computed for a coordinate version other than <code>coordinateVersion</code>
+  void evictOtherCoordinateVersions(std::size_t coordinateVersion);
+
+  //! Drop all values, the counters are kept
+  void clear();
+
+  std::size_t getHits() const { return hits_; }
+  std::size_t getMisses() const { return misses_; }
+  std::size_t getEvictions() const { return evictions_; }
+
+  void resetCounters()
+  { hits_ = 0; misses_ = 0; evictions_ = 0; }
+
+  //! Copy the local ids and vertex coordinates of the cells of a workset
+  static std::shared_ptr<const Cells> buildCells(const WorksetDetails & details);
+
+private:
+
+  struct Entry {
+    Teuchos::RCP<IntegrationValues2<double> > integrationValues;
+    Teuchos::RCP<BasisValues2<double> > basisValues;
+    std::size_t bytes;
+    std::list<Key>::iterator lru;
+  };
+
+  typedef std::unordered_map<Key,Entry,KeyHash> EntryMap;
+
+  Entry * find(const Key & key);
+  void insert(const Key & key,Entry entry);
+  void erase(EntryMap::iterator itr);
+  void enforceBudget();
+
+  EntryMap entries_;
+  std::list<Key> lru_; //! Most recently used first
+
+  std::size_t memoryBudget_;
+  std::size_t memoryUsage_;
+
+  std::size_t hits_;
+  std::size_t misses_;
+  std::size_t evictions_;
+};
+
+}
+
+#endif
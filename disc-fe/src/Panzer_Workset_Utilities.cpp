@@ -45,11 +45,13 @@
 
 #include "Panzer_Traits.hpp"
 #include "Panzer_Workset.hpp"
+#include "Panzer_GlobalIndexer.hpp"
 #include "Teuchos_Assert.hpp"
 #include <vector>
 #include <string>
 #include <algorithm>
 #include <iterator>
+#include <unordered_map>
 
 namespace panzer {
 
@@ -184,8 +186,12 @@ namespace panzer {
      os << "]\n";
      
      os << "   weighted_grad_basis = [ ";
-     for(int i=0;i<wda(workset).bases[0]->weighted_grad_basis.size();i++)
-        os << wda(workset).bases[0]->weighted_grad_basis[i] << " ";
+     if(wda(workset).bases[0]->build_weighted && wda(workset).bases[0]->grad_basis.size()>0) {
+       // built on first use
+       const auto weighted_grad_basis = wda(workset).bases[0]->getGradBasisValues(true);
+       for(int i=0;i<weighted_grad_basis.size();i++)
+          os << weighted_grad_basis[i] << " ";
+     }
      os << "]\n";
 
      os << "   basis = [ ";
@@ -219,6 +225,82 @@ namespace panzer {
     WorksetDetailsAccessor wda;
     printWorkset(os, workset, wda);
   }
+
+  void colorWorksets(const panzer::GlobalIndexer & indexer,
+                     const std::vector<panzer::Workset> & worksets,
+                     std::vector<std::vector<std::size_t> > & colors)
+  {
+    colors.clear();
+
+    // last color that claimed each DOF, and the DOFs touched by each workset
+    std::unordered_map<panzer::GlobalOrdinal,std::vector<int> > dofColors;
+    std::vector<panzer::GlobalOrdinal> gids, wkstGids;
+
+    for (std::size_t w = 0; w < worksets.size(); ++w) {
+      const std::string & blockId = worksets[w].getElementBlock();
+      const auto cells = Kokkos::create_mirror_view(worksets[w].getLocalCellIDs());
+      Kokkos::deep_copy(cells,worksets[w].getLocalCellIDs());
+
+      wkstGids.clear();
+      for (int c = 0; c < worksets[w].num_cells; ++c) {
+        indexer.getElementGIDs(cells(c),gids,blockId);
+        wkstGids.insert(wkstGids.end(),gids.begin(),gids.end());
+      }
+      std::sort(wkstGids.begin(),wkstGids.end());
+      wkstGids.erase(std::unique(wkstGids.begin(),wkstGids.end()),wkstGids.end());
+
+      // mark every color already used by a neighboring workset
+      std::vector<bool> used(colors.size(),false);
+      for (const auto gid : wkstGids) {
+        auto itr = dofColors.find(gid);
+        if (itr != dofColors.end())
+          for (const int c : itr->second)
+            used[c] = true;
+      }
+
+      std::size_t color = 0;
+      while (color < used.size() && used[color])
+        ++color;
+      if (color == colors.size())
+        colors.emplace_back();
+      colors[color].push_back(w);
+
+      for (const auto gid : wkstGids)
+        dofColors[gid].push_back(static_cast<int>(color));
+    }
+  }
+
+  void classifyWorksets(const panzer::GlobalIndexer & indexer,
+                        const std::vector<panzer::Workset> & worksets,
+                        std::vector<std::size_t> & interior,
+                        std::vector<std::size_t> & boundary)
+  {
+    interior.clear();
+    boundary.clear();
+
+    std::vector<panzer::GlobalOrdinal> gids, wkstGids;
+    std::vector<bool> isOwned;
+
+    for (std::size_t w = 0; w < worksets.size(); ++w) {
+      const std::string & blockId = worksets[w].getElementBlock();
+      const auto cells = Kokkos::create_mirror_view(worksets[w].getLocalCellIDs());
+      Kokkos::deep_copy(cells,worksets[w].getLocalCellIDs());
+
+      wkstGids.clear();
+      for (int c = 0; c < worksets[w].num_cells; ++c) {
+        indexer.getElementGIDs(cells(c),gids,blockId);
+        wkstGids.insert(wkstGids.end(),gids.begin(),gids.end());
+      }
+      std::sort(wkstGids.begin(),wkstGids.end());
+      wkstGids.erase(std::unique(wkstGids.begin(),wkstGids.end()),wkstGids.end());
+
+      indexer.ownedIndices(wkstGids,isOwned);
+      if (std::find(isOwned.begin(),isOwned.end(),false) == isOwned.end())
+        interior.push_back(w);
+      else
+        boundary.push_back(w);
+    }
+  }
 }
 
 #endif
@@ -50,6 +50,8 @@
 
 namespace panzer {
 
+  class GlobalIndexer;
+
   /** \brief Returns the index in the workset bases for a particular PureBasis name.
       \param[in] basis_name Name of the basis that corresponds to a particular PureBasis
       \param[in] workset Worksets to perform the search over
@@ -71,6 +73,35 @@ namespace panzer {
 
   void printWorkset(std::ostream& os, const panzer::Workset & workset, WorksetDetailsAccessor& wda);
 
+  /** \brief Greedily partition worksets into colors that do not share any degree of freedom.
+
+      Two worksets conflict if any of their cells touch the same global DOF. Worksets
+      within one color therefore scatter into disjoint rows and may be evaluated
+      concurrently without synchronization.
+
+      \param[in] indexer Global indexer used to find the DOFs of each cell
+      \param[in] worksets Worksets to color (cells from <code>getLocalCellIDs()</code>)
+      \param[out] colors Workset indices grouped by color
+  */
+  void colorWorksets(const panzer::GlobalIndexer & indexer,
+                     const std::vector<panzer::Workset> & worksets,
+                     std::vector<std::vector<std::size_t> > & colors);
+
+  /** \brief Split worksets into those that only touch owned DOFs and those that touch ghosted ones.
+
+      Interior worksets read no ghosted solution values, so they can be evaluated
+      while the halo exchange of the solution is still in flight.
+
+      \param[in] indexer Global indexer used to find the DOFs of each cell
+      \param[in] worksets Worksets to classify (cells from <code>getLocalCellIDs()</code>)
+      \param[out] interior Indices of the worksets whose DOFs are all owned
+      \param[out] boundary Indices of the worksets with at least one ghosted DOF
+  */
+  void classifyWorksets(const panzer::GlobalIndexer & indexer,
+                        const std::vector<panzer::Workset> & worksets,
+                        std::vector<std::size_t> & interior,
+                        std::vector<std::size_t> & boundary);
+
   // Temporarily provide non-wda versions so that Charon continues to build and work.
   std::vector<std::string>::size_type getPureBasisIndex(std::string basis_name, const panzer::Workset& workset);
   std::vector<std::string>::size_type getBasisIndex(std::string basis_name, const panzer::Workset& workset);
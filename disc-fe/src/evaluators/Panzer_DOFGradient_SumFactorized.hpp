@@ -0,0 +1,108 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#ifndef PANZER_EVALUATOR_DOF_GRADIENT_SUM_FACTORIZED_HPP
+#define PANZER_EVALUATOR_DOF_GRADIENT_SUM_FACTORIZED_HPP
+
+#include <string>
+
+#include "Phalanx_Evaluator_Macros.hpp"
+#include "Phalanx_MDField.hpp"
+
+#include "Panzer_Evaluator_Macros.hpp"
+#include "Panzer_TensorProductBasis.hpp"
+
+namespace panzer {
+
+/** Interpolates basis DOF values to IP DOF gradient values by sum factorization.
+  *
+  * Equivalent to <code>DOFGradient</code> for HGrad bases on quadrilaterals and
+  * hexahedra with a tensor-product integration rule (see <code>TensorProductBasis</code>),
+  * but reads only the 1D basis tables and the inverse Jacobian of the workset.
+  * The expanded <code>grad_basis</code> array is never used.
+  */
+template <typename EvalT, typename TRAITS>
+class DOFGradient_SumFactorized : public panzer::EvaluatorWithBaseImpl<TRAITS>,
+                                  public PHX::EvaluatorDerived<EvalT, TRAITS>  {
+public:
+
+  /** \brief Ctor
+    *
+    * \param[in] p Takes the same parameters as <code>DOFGradient</code>:
+    *              "Name", "Gradient Name", "Basis" and "IR"
+    */
+  DOFGradient_SumFactorized(const Teuchos::ParameterList& p);
+
+  void postRegistrationSetup(typename TRAITS::SetupData d,
+                             PHX::FieldManager<TRAITS>& fm);
+
+  void evaluateFields(typename TRAITS::EvalData d);
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const std::size_t & cell) const
+  { tensor_basis.evaluateGradient(cell,dof_value,jac_inv,dof_gradient,scratch); }
+
+private:
+
+  typedef typename EvalT::ScalarT ScalarT;
+
+  // <cell,basis>
+  PHX::MDField<const ScalarT,Cell,BASIS> dof_value;
+
+  // <cell,point,dim>
+  PHX::MDField<ScalarT,Cell,IP,Dim> dof_gradient;
+
+  // <cell,point,dim,dim> of the current workset
+  PHX::MDField<const double,Cell,IP,Dim,Dim> jac_inv;
+
+  std::string basis_type;
+  int basis_order;
+  int quad_order;
+  std::size_t quad_index;
+
+  TensorProductBasis tensor_basis;
+  PHX::View<ScalarT**> scratch;
+};
+
+}
+
+#endif
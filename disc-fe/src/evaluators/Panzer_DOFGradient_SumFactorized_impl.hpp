@@ -0,0 +1,122 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#ifndef PANZER_DOF_GRADIENT_SUM_FACTORIZED_IMPL_HPP
+#define PANZER_DOF_GRADIENT_SUM_FACTORIZED_IMPL_HPP
+
+#include "Panzer_IntegrationRule.hpp"
+#include "Panzer_BasisIRLayout.hpp"
+#include "Panzer_Workset_Utilities.hpp"
+
+namespace panzer {
+
+//**********************************************************************
+template<typename EvalT, typename Traits>
+DOFGradient_SumFactorized<EvalT, Traits>::
+DOFGradient_SumFactorized(
+  const Teuchos::ParameterList& p) :
+  dof_value( p.get<std::string>("Name"),
+	     p.get< Teuchos::RCP<panzer::BasisIRLayout> >("Basis")->functional),
+  dof_gradient( p.get<std::string>("Gradient Name"),
+		p.get< Teuchos::RCP<panzer::IntegrationRule> >("IR")->dl_vector ),
+  quad_index(0)
+{
+  Teuchos::RCP<const PureBasis> basis
+     = p.get< Teuchos::RCP<BasisIRLayout> >("Basis")->getBasis();
+  Teuchos::RCP<const IntegrationRule> ir
+     = p.get< Teuchos::RCP<panzer::IntegrationRule> >("IR");
+
+  // Verify that this basis and rule have a tensor-product form
+  TEUCHOS_TEST_FOR_EXCEPTION(!TensorProductBasis::isSupported(basis->type(),*ir),std::logic_error,
+                             "DOFGradient_SumFactorized: Basis of type \"" << basis->name() << "\" with integration rule \""
+                             << ir->getName() << "\" does not have a tensor-product form");
+
+  basis_type = basis->type();
+  basis_order = basis->order();
+  quad_order = ir->cubature_degree;
+
+  this->addEvaluatedField(dof_gradient);
+  this->addDependentField(dof_value);
+
+  std::string n = "DOFGradient_SumFactorized: " + dof_gradient.fieldTag().name() + " ("+PHX::print<EvalT>()+")";
+  this->setName(n);
+}
+
+//**********************************************************************
+template<typename EvalT, typename Traits>
+void
+DOFGradient_SumFactorized<EvalT, Traits>::
+postRegistrationSetup(
+  typename Traits::SetupData sd,
+  PHX::FieldManager<Traits>& /* fm */)
+{
+  quad_index = panzer::getIntegrationRuleIndex(quad_order,(*sd.worksets_)[0], this->wda);
+  tensor_basis = TensorProductBasis(basis_type,basis_order,*this->wda((*sd.worksets_)[0]).int_rules[quad_index]);
+
+  if (Sacado::IsADType<ScalarT>::value) {
+    const auto fadSize = Kokkos::dimension_scalar(dof_gradient.get_view());
+    scratch = PHX::View<ScalarT**>("DOFGradient_SumFactorized::scratch",dof_gradient.extent(0),tensor_basis.scratchSize(),fadSize);
+  } else {
+    scratch = PHX::View<ScalarT**>("DOFGradient_SumFactorized::scratch",dof_gradient.extent(0),tensor_basis.scratchSize());
+  }
+}
+
+//**********************************************************************
+template<typename EvalT, typename Traits>
+void
+DOFGradient_SumFactorized<EvalT, Traits>::
+evaluateFields(typename Traits::EvalData workset)
+{
+  if (workset.num_cells == 0)
+    return;
+
+  jac_inv = this->wda(workset).int_rules[quad_index]->jac_inv;
+
+  Kokkos::parallel_for("panzer::DOFGradient_SumFactorized::evaluateFields",
+                       Kokkos::RangePolicy<PHX::exec_space>(0,workset.num_cells),*this);
+}
+
+//**********************************************************************
+
+}
+
+#endif
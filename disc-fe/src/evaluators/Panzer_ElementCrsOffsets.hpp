@@ -0,0 +1,176 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#ifndef __Panzer_ElementCrsOffsets_hpp__
+#define __Panzer_ElementCrsOffsets_hpp__
+
+#include "PanzerDiscFE_config.hpp"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "Kokkos_Core.hpp"
+#include "Phalanx_KokkosDeviceTypes.hpp"
+
+namespace panzer {
+
+/** \brief Positions of element matrix entries in the value array of local CRS matrices.
+  *
+  * For every workset the offset of each (row,col) pair of the element matrix is
+  * resolved once, so a Jacobian scatter reduces to atomic adds into
+  * <code>values(offsets(cell,row,col))</code> instead of searching the row with
+  * <code>sumIntoValues</code>. Pairs that are not stored in the graph resolve to
+  * <code>invalid()</code> and are skipped, as <code>sumIntoValues</code> does.
+  *
+  * Tables are keyed by the workset identifier and recomputed when the workset is
+  * rebuilt (its version changes, see <code>Workset::getVersion</code>) or the graphs
+  * they point into change. Tables of older workset versions are dropped, so at most
+  * one build's worth of tables is kept. They hold <code>numCells*numRows*numCols</code>
+  * offsets per workset, trading memory for speed.
+  */
+class ElementCrsOffsets {
+public:
+  typedef Kokkos::View<std::size_t***,Kokkos::LayoutRight,PHX::Device> OffsetView;
+
+  KOKKOS_INLINE_FUNCTION
+  static std::size_t invalid() { return ~static_cast<std::size_t>(0); }
+
+  ElementCrsOffsets() : version_(0) {}
+
+  /** Get the offset table of a workset.
+    *
+    * \param[in] identifier Workset identifier
+    * \param[in] version    Workset version, zero (not built by a WorksetContainer)
+    *                       is never considered current
+    * \param[in] numCells   Number of cells in the workset
+    * \param[in] graphs     Identity of the graphs the offsets point into
+    * \param[out] offsets   Table of size <code>(numCells,numRows,numCols)</code>
+    *
+    * \returns true if the table is current, false if it was (re)allocated and must be
+    *          filled by the caller (see <code>fillElementCrsOffsets</code>).
+    */
+  bool lookup(std::size_t identifier,std::size_t version,int numCells,
+              const std::vector<const void*> & graphs,int numRows,int numCols,
+              OffsetView & offsets)
+  {
+    // offsets into other graphs are meaningless, tables of older builds are stale
+    if(graphs!=graphs_ || version!=version_) {
+      tables_.clear();
+      graphs_ = graphs;
+      version_ = version;
+    }
+
+    Table & table = tables_[identifier];
+    const bool current = version!=0
+                      && table.offsets.extent(0)==static_cast<std::size_t>(numCells)
+                      && table.offsets.extent(1)==static_cast<std::size_t>(numRows)
+                      && table.offsets.extent(2)==static_cast<std::size_t>(numCols);
+    if(!current)
+      table.offsets = OffsetView(Kokkos::view_alloc("panzer::ElementCrsOffsets",Kokkos::WithoutInitializing),numCells,numRows,numCols);
+
+    offsets = table.offsets;
+    return current;
+  }
+
+  //! Drop all tables
+  void clear()
+  { tables_.clear(); graphs_.clear(); version_ = 0; }
+
+  //! Number of tables held
+  std::size_t size() const
+  { return tables_.size(); }
+
+private:
+  struct Table {
+    OffsetView offsets;
+  };
+
+  std::vector<const void*> graphs_;
+  std::size_t version_;
+  std::map<std::size_t,Table> tables_;
+};
+
+/** \brief Resolve the CRS offsets of a block of the element matrix.
+  *
+  * For each cell, the element rows in <code>[rows.first,rows.second)</code> and element
+  * columns in <code>[cols.first,cols.second)</code> are looked up in the (sorted) local
+  * graph through the local ids <code>lids(cell,.)</code>.
+  */
+template <typename OffsetView,typename LocalGraphT,typename LidView>
+void fillElementCrsOffsets(const OffsetView & offsets,
+                           const LocalGraphT & graph,
+                           const LidView & lids,
+                           const std::pair<int,int> rows,
+                           const std::pair<int,int> cols)
+{
+  const auto row_map = graph.row_map;
+  const auto entries = graph.entries;
+
+  Kokkos::parallel_for("panzer::fillElementCrsOffsets",Kokkos::RangePolicy<PHX::Device>(0,offsets.extent(0)),
+                       KOKKOS_LAMBDA (const int cell) {
+    for(int row=rows.first;row<rows.second;++row) {
+      const auto lid = lids(cell,row);
+      const std::size_t begin = row_map(lid);
+      const std::size_t end = row_map(lid+1);
+
+      for(int col=cols.first;col<cols.second;++col) {
+        const auto colLid = lids(cell,col);
+
+        // binary search of the sorted row
+        std::size_t lo = begin, hi = end;
+        while(lo<hi) {
+          const std::size_t mid = lo + (hi-lo)/2;
+          if(entries(mid)<colLid)
+            lo = mid+1;
+          else
+            hi = mid;
+        }
+        offsets(cell,row,col) = (lo<end && entries(lo)==colLid) ? lo : ElementCrsOffsets::invalid();
+      }
+    }
+  });
+}
+
+}
+
+#endif
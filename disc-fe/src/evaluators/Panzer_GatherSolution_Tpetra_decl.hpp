@@ -194,6 +194,10 @@ private:
 
   Teuchos::RCP<const TpetraLinearObjContainer<double,LO,GO,NodeT> > tpetraContainer_;
 
+  // Direction v of a matrix-free Jacobian product, seeded into the first
+  // derivative component when present (see MatrixFreeJacobianOp)
+  Teuchos::RCP<const TpetraLinearObjContainer<double,LO,GO,NodeT> > directionContainer_;
+
   // Fields for storing tangent components dx/dp of solution vector x
   bool has_tangent_fields_;
   std::vector< std::vector< PHX::MDField<const RealT,Cell,NODE> > > tangentFields_;
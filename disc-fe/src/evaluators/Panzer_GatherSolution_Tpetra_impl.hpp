@@ -331,6 +331,13 @@ preEvaluate(typename TRAITS::PreEvalData d)
       Teuchos::RCP<LinearObjContainer> loc = Teuchos::rcp_dynamic_cast<LOCPair_GlobalEvaluationData>(d.gedc->getDataObject(globalDataKey_),true)->getGhostedLOC();
       tpetraContainer_ = Teuchos::rcp_dynamic_cast<LOC>(loc);
    }
+
+   // a direction vector turns this into a directional derivative gather
+   directionContainer_ = Teuchos::null;
+   if(d.gedc->containsDataObject("Directional Derivative Container")) {
+      Teuchos::RCP<LinearObjContainer> loc = Teuchos::rcp_dynamic_cast<LOCPair_GlobalEvaluationData>(d.gedc->getDataObject("Directional Derivative Container"),true)->getGhostedLOC();
+      directionContainer_ = Teuchos::rcp_dynamic_cast<LOC>(loc,true);
+   }
 }
 
 // **********************************************************************
@@ -358,7 +365,26 @@ evaluateFields(typename TRAITS::EvalData workset)
    auto x_view = x->getLocalViewDevice(Tpetra::Access::ReadOnly);
    auto tangentInnerVectorSizes = this->tangentInnerVectorSizes_;
 
-   if (has_tangent_fields_) {
+   if (directionContainer_!=Teuchos::null) {
+     // perturbation of x is beta*v and of dxdt is alpha*v, so the scattered
+     // derivative is (alpha*df/dxdot + beta*df/dx)*v
+     const double seed_value = useTimeDerivativeSolutionVector_ ? workset.alpha : workset.beta;
+     auto v_view = directionContainer_->get_x()->getLocalViewDevice(Tpetra::Access::ReadOnly);
+     Kokkos::parallel_for("GatherSolutionTpetra<Tangent>::direction",cellLocalIdsKokkos.extent(0),KOKKOS_LAMBDA(const int worksetCellIndex) {
+       for (std::size_t fieldIndex = 0; fieldIndex < gidFieldOffsets.extent(0); ++fieldIndex) {
+         for(std::size_t basis=0;basis<gidFieldOffsets(fieldIndex).extent(0);basis++) {
+           int offset = gidFieldOffsets(fieldIndex)(basis);
+           LO lid = lids(cellLocalIdsKokkos(worksetCellIndex),offset);
+           reference_type gf_ref = (gatherFieldsDevice[fieldIndex])(worksetCellIndex,basis);
+           gf_ref.val() = x_view(lid,0);
+           for (int i=1; i<gf_ref.size(); ++i)
+             gf_ref.fastAccessDx(i) = 0.0;
+           gf_ref.fastAccessDx(0) = seed_value*v_view(lid,0);
+         }
+       }
+     });
+   }
+   else if (has_tangent_fields_) {
      auto tangentFieldsDevice = tangentFieldsVoV_.getViewDevice();
      Kokkos::parallel_for("GatherSolutionTpetra<Tangent>",cellLocalIdsKokkos.extent(0),KOKKOS_LAMBDA(const int worksetCellIndex) {
        for (std::size_t fieldIndex = 0; fieldIndex < gidFieldOffsets.extent(0); ++fieldIndex) { 
@@ -338,7 +338,7 @@ namespace panzer
        *  \brief The gradient vector basis information necessary for
        *         integration.
        */
-      PHX::MDField<double, panzer::Cell, panzer::BASIS, panzer::IP, panzer::Dim> basis_;
+      PHX::MDField<const double, panzer::Cell, panzer::BASIS, panzer::IP, panzer::Dim> basis_;
 
   }; // end of class Integrator_GradBasisCrossVector
 
@@ -461,7 +461,7 @@ namespace panzer
     using Kokkos::RangePolicy;
 
     // Grab the basis information.
-    basis_ = this->wda(workset).bases[basisIndex_]->weighted_grad_basis;
+    basis_ = this->wda(workset).bases[basisIndex_]->getGradBasisValues(true);
 
     // The following if-block is for the sake of optimization depending on the
     // number of field multipliers.  The parallel_fors will loop over the cells
@@ -331,7 +331,7 @@ namespace panzer
        *  \brief The gradient vector basis information necessary for
        *         integration.
        */
-      PHX::MDField<double, panzer::Cell, panzer::BASIS, panzer::IP,
+      PHX::MDField<const double, panzer::Cell, panzer::BASIS, panzer::IP,
         panzer::Dim> basis_;
 
     /// Temporary used when shared memory is disabled
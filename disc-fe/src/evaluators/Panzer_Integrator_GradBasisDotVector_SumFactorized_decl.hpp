@@ -0,0 +1,260 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#ifndef   __Panzer_Integrator_GradBasisDotVector_SumFactorized_decl_hpp__
+#define   __Panzer_Integrator_GradBasisDotVector_SumFactorized_decl_hpp__
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Include Files
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// C++
+#include <string>
+#include <vector>
+
+// Panzer
+#include "Panzer_EvaluatorStyle.hpp"
+#include "Panzer_Evaluator_WithBaseImpl.hpp"
+#include "Panzer_TensorProductBasis.hpp"
+
+// Phalanx
+#include "Phalanx_Evaluator_Derived.hpp"
+#include "Phalanx_MDField.hpp"
+
+namespace panzer
+{
+  class BasisIRLayout;
+  class IntegrationRule;
+
+  /**
+   *  \brief Computes \f$ Ma(x)b(x)\cdots\int\vec{s}(x)\cdot\nabla\phi(x)\,dx
+   *         \f$ by sum factorization.
+   *
+   *  Equivalent to `Integrator_GradBasisDotVector` for HGrad bases on
+   *  quadrilaterals and hexahedra with a tensor-product integration rule (see
+   *  `TensorProductBasis`). The vector is mapped to the reference cell at each
+   *  integration point and contracted with the 1D basis tables one direction
+   *  at a time, so the expanded `weighted_grad_basis` array is never built.
+   */
+  template<typename EvalT, typename Traits>
+  class Integrator_GradBasisDotVector_SumFactorized
+    :
+    public panzer::EvaluatorWithBaseImpl<Traits>,
+    public PHX::EvaluatorDerived<EvalT, Traits>
+  {
+    public:
+
+      /**
+       *  \brief Main Constructor.
+       *
+       *  \param[in] evalStyle  An `enum` declaring the behavior of this
+       *                        `Evaluator`, which is to either:
+       *                        - compute and contribute (`CONTRIBUTES`), or
+       *                        - compute and store (`EVALUATES`).
+       *  \param[in] resName    The name of either the contributed or evaluated
+       *                        field, depending on `evalStyle`.
+       *  \param[in] fluxName   The name of the vector-valued function being
+       *                        integrated (\f$ \vec{s} \f$).
+       *  \param[in] basis      The basis that you'd like to use (\f$ \phi
+       *                        \f$).
+       *  \param[in] ir         The integration rule that you'd like to use.
+       *  \param[in] multiplier The scalar multiplier out in front of the
+       *                        integral you're computing (\f$ M \f$).  If not
+       *                        specified, this defaults to 1.
+       *  \param[in] fmNames    A list of names of fields that are multipliers
+       *                        out in front of the integral you're computing
+       *                        (\f$ a(x) \f$, \f$ b(x) \f$, etc.).  If not
+       *                        specified, this defaults to an empty `vector`.
+       *
+       *  \throws std::invalid_argument If any of the inputs are invalid.
+       *  \throws std::logic_error      If the `basis` and `ir` do not have a
+       *                                tensor-product form.
+       */
+      Integrator_GradBasisDotVector_SumFactorized(
+        const panzer::EvaluatorStyle&   evalStyle,
+        const std::string&              resName,
+        const std::string&              fluxName,
+        const panzer::BasisIRLayout&    basis,
+        const panzer::IntegrationRule&  ir,
+        const double&                   multiplier = 1,
+        const std::vector<std::string>& fmNames    =
+          std::vector<std::string>());
+
+      /**
+       *  \brief `ParameterList` Constructor.
+       *
+       *  \param[in] p A `ParameterList` with the same keys as the one taken
+       *               by `Integrator_GradBasisDotVector`, without
+       *               "Vector Data Layout".  The `Evaluator` evaluates
+       *               (`EVALUATES`) the residual.
+       */
+      Integrator_GradBasisDotVector_SumFactorized(
+        const Teuchos::ParameterList& p);
+
+      /**
+       *  \brief Post-Registration Setup.
+       *
+       *  Finds the integration rule in the `Workset`, builds the 1D basis
+       *  tables, and allocates the temporaries.
+       *
+       *  \param[in] sd Essentially a list of `Workset`s, which are collections
+       *                of cells (elements) that all live on a single process.
+       *  \param[in] fm This is an unused part of the `Evaluator` interface.
+       */
+      void
+      postRegistrationSetup(
+        typename Traits::SetupData sd,
+        PHX::FieldManager<Traits>& fm);
+
+      /**
+       *  \brief Evaluate Fields.
+       *
+       *  \param[in] workset The `Workset` on which you're going to do the
+       *                     integration.
+       */
+      void
+      evaluateFields(
+        typename Traits::EvalData workset);
+
+      /**
+       *  \brief Perform the integration over one cell.
+       *
+       *  \param[in] cell The cell in the `Workset` over which to integrate.
+       */
+      KOKKOS_INLINE_FUNCTION
+      void
+      operator()(
+        const std::size_t& cell) const;
+
+    private:
+
+      /**
+       *  \brief Get Valid Parameters.
+       *
+       *  \returns A `ParameterList` with all the valid parameters (keys) in
+       *           it.  The values tied to those keys are meaningless default
+       *           values.
+       */
+      Teuchos::RCP<Teuchos::ParameterList>
+      getValidParameters() const;
+
+      /**
+       *  \brief The scalar type.
+       */
+      using ScalarT = typename EvalT::ScalarT;
+
+      /**
+       *  \brief An `enum` determining the behavior of this `Evaluator`.
+       */
+      const panzer::EvaluatorStyle evalStyle_;
+
+      /**
+       *  \brief A field to which we'll contribute, or in which we'll store,
+       *         the result of computing this integral.
+       */
+      PHX::MDField<ScalarT, panzer::Cell, panzer::BASIS> field_;
+
+      /**
+       *  \brief A field representing the vector-valued function we're
+       *         integrating (\f$ \vec{s} \f$).
+       */
+      PHX::MDField<const ScalarT, panzer::Cell, panzer::IP, panzer::Dim>
+      vector_;
+
+      /**
+       *  \brief The scalar multiplier out in front of the integral (\f$ M
+       *         \f$).
+       */
+      double multiplier_;
+
+      /**
+       *  \brief The (possibly empty) list of fields that are multipliers out
+       *         in front of the integral (\f$ a(x) \f$, \f$ b(x) \f$, etc.).
+       */
+      std::vector<PHX::MDField<const ScalarT, panzer::Cell, panzer::IP>>
+      fieldMults_;
+
+      /**
+       *  \brief The `PHX::View` representation of the field multipliers.
+       */
+      PHX::View<PHX::UnmanagedView<const ScalarT**>* > kokkosFieldMults_;
+
+      /**
+       *  \brief The basis type, order, and integration order.
+       */
+      std::string basisType_;
+      int basisOrder_;
+      int quadOrder_;
+
+      /**
+       *  \brief The index in the `Workset` integration rules for our
+       *         particular integration order.
+       */
+      std::size_t quadIndex_;
+
+      /**
+       *  \brief The inverse Jacobian and weighted measure of the current
+       *         `Workset`.
+       */
+      PHX::MDField<const double, panzer::Cell, panzer::IP, panzer::Dim,
+        panzer::Dim> jacInv_;
+      PHX::MDField<const double, panzer::Cell, panzer::IP> weightedMeasure_;
+
+      /**
+       *  \brief The 1D basis tables.
+       */
+      TensorProductBasis tensorBasis_;
+
+      /**
+       *  \brief The vector mapped to the reference cell, and scratch space
+       *         for the contractions.
+       */
+      PHX::View<ScalarT***> refVector_;
+      PHX::View<ScalarT**> scratch_;
+
+  }; // end of class Integrator_GradBasisDotVector_SumFactorized
+
+} // end of namespace panzer
+
+#endif // __Panzer_Integrator_GradBasisDotVector_SumFactorized_decl_hpp__
@@ -0,0 +1,324 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#ifndef   __Panzer_Integrator_GradBasisDotVector_SumFactorized_impl_hpp__
+#define   __Panzer_Integrator_GradBasisDotVector_SumFactorized_impl_hpp__
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Include Files
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Panzer
+#include "Panzer_BasisIRLayout.hpp"
+#include "Panzer_IntegrationRule.hpp"
+#include "Panzer_IntegrationValues2.hpp"
+#include "Panzer_Workset_Utilities.hpp"
+
+namespace panzer
+{
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Main Constructor
+  //
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename EvalT, typename Traits>
+  Integrator_GradBasisDotVector_SumFactorized<EvalT, Traits>::
+  Integrator_GradBasisDotVector_SumFactorized(
+    const panzer::EvaluatorStyle&   evalStyle,
+    const std::string&              resName,
+    const std::string&              fluxName,
+    const panzer::BasisIRLayout&    basis,
+    const panzer::IntegrationRule&  ir,
+    const double&                   multiplier, /* = 1 */
+    const std::vector<std::string>& fmNames     /* =
+      std::vector<std::string>() */)
+    :
+    evalStyle_(evalStyle),
+    multiplier_(multiplier),
+    quadIndex_(0)
+  {
+    using panzer::BASIS;
+    using panzer::Cell;
+    using panzer::EvaluatorStyle;
+    using panzer::IP;
+    using PHX::MDField;
+    using std::invalid_argument;
+    using std::logic_error;
+    using std::string;
+    using Teuchos::RCP;
+
+    // Ensure the input makes sense.
+    TEUCHOS_TEST_FOR_EXCEPTION(resName == "", invalid_argument, "Error:  "   \
+      "Integrator_GradBasisDotVector_SumFactorized called with an empty "     \
+      "residual name.")
+    TEUCHOS_TEST_FOR_EXCEPTION(fluxName == "", invalid_argument, "Error:  "   \
+      "Integrator_GradBasisDotVector_SumFactorized called with an empty flux " \
+      "name.")
+    RCP<const PureBasis> tmpBasis = basis.getBasis();
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      not TensorProductBasis::isSupported(tmpBasis->type(), ir), logic_error,
+      "Error:  Integrator_GradBasisDotVector_SumFactorized:  Basis of type \""
+      << tmpBasis->name() << "\" with integration rule \"" << ir.getName()
+      << "\" does not have a tensor-product form.")
+    basisType_  = tmpBasis->type();
+    basisOrder_ = tmpBasis->order();
+    quadOrder_  = ir.cubature_degree;
+
+    // Create the field for the vector-valued function we're integrating.
+    vector_ = MDField<const ScalarT, Cell, IP, Dim>(fluxName, ir.dl_vector);
+    this->addDependentField(vector_);
+
+    // Create the field that we're either contributing to or evaluating
+    // (storing).
+    field_ = MDField<ScalarT, Cell, BASIS>(resName, basis.functional);
+    if (evalStyle_ == EvaluatorStyle::CONTRIBUTES)
+      this->addContributedField(field_);
+    else // if (evalStyle_ == EvaluatorStyle::EVALUATES)
+      this->addEvaluatedField(field_);
+
+    // Add the dependent field multipliers, if there are any.
+    int i(0);
+    fieldMults_.resize(fmNames.size());
+    kokkosFieldMults_ = PHX::View<PHX::UnmanagedView<const ScalarT**>*>(
+      "GradBasisDotVector_SumFactorized::KokkosFieldMultipliers",
+      fmNames.size());
+    for (const auto& name : fmNames)
+    {
+      fieldMults_[i++] = MDField<const ScalarT, Cell, IP>(name, ir.dl_scalar);
+      this->addDependentField(fieldMults_[i - 1]);
+    } // end loop over the field multipliers
+
+    // Set the name of this object.
+    string n("Integrator_GradBasisDotVector_SumFactorized (");
+    if (evalStyle_ == EvaluatorStyle::CONTRIBUTES)
+      n += "CONTRIBUTES";
+    else // if (evalStyle_ == EvaluatorStyle::EVALUATES)
+      n += "EVALUATES";
+    n += "):  " + field_.fieldTag().name();
+    this->setName(n);
+  } // end of Main Constructor
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  ParameterList Constructor
+  //
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename EvalT, typename Traits>
+  Integrator_GradBasisDotVector_SumFactorized<EvalT, Traits>::
+  Integrator_GradBasisDotVector_SumFactorized(
+    const Teuchos::ParameterList& p)
+    :
+    Integrator_GradBasisDotVector_SumFactorized(
+      panzer::EvaluatorStyle::EVALUATES,
+      p.get<std::string>("Residual Name"),
+      p.get<std::string>("Flux Name"),
+      (*p.get<Teuchos::RCP<panzer::BasisIRLayout>>("Basis")),
+      (*p.get<Teuchos::RCP<panzer::IntegrationRule>>("IR")),
+      p.get<double>("Multiplier"),
+      p.isType<Teuchos::RCP<const std::vector<std::string>>>
+        ("Field Multipliers") ?
+        (*p.get<Teuchos::RCP<const std::vector<std::string>>>
+        ("Field Multipliers")) : std::vector<std::string>())
+  {
+    using Teuchos::ParameterList;
+    using Teuchos::RCP;
+
+    // Ensure that the input ParameterList didn't contain any bogus entries.
+    RCP<ParameterList> validParams = this->getValidParameters();
+    p.validateParameters(*validParams);
+  } // end of ParameterList Constructor
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  postRegistrationSetup()
+  //
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename EvalT, typename Traits>
+  void
+  Integrator_GradBasisDotVector_SumFactorized<EvalT, Traits>::
+  postRegistrationSetup(
+    typename Traits::SetupData sd,
+    PHX::FieldManager<Traits>& /* fm */)
+  {
+    using panzer::getIntegrationRuleIndex;
+    using std::size_t;
+
+    // Get the PHX::Views of the field multipliers.
+    auto field_mults_host_mirror = Kokkos::create_mirror_view(kokkosFieldMults_);
+    for (size_t i(0); i < fieldMults_.size(); ++i)
+      field_mults_host_mirror(i) = fieldMults_[i].get_static_view();
+    Kokkos::deep_copy(kokkosFieldMults_,field_mults_host_mirror);
+
+    // Determine the index in the Workset integration rules for our particular
+    // integration order, and build the 1D basis tables from that rule.
+    const auto& ws0 = (*sd.worksets_)[0];
+    quadIndex_ = getIntegrationRuleIndex(quadOrder_, ws0, this->wda);
+    tensorBasis_ = TensorProductBasis(basisType_, basisOrder_,
+      *this->wda(ws0).int_rules[quadIndex_]);
+
+    // Allocate the reference vector and the scratch space for the
+    // contractions.
+    const int numCells(vector_.extent(0)), numQP(vector_.extent(1)),
+              numDim(vector_.extent(2));
+    if (Sacado::IsADType<ScalarT>::value)
+    {
+      const auto fadSize = Kokkos::dimension_scalar(field_.get_view());
+      refVector_ = PHX::View<ScalarT***>(
+        "GradBasisDotVector_SumFactorized::refVector_", numCells, numQP,
+        numDim, fadSize);
+      scratch_ = PHX::View<ScalarT**>(
+        "GradBasisDotVector_SumFactorized::scratch_", numCells,
+        tensorBasis_.scratchSize(), fadSize);
+    }
+    else
+    {
+      refVector_ = PHX::View<ScalarT***>(
+        "GradBasisDotVector_SumFactorized::refVector_", numCells, numQP,
+        numDim);
+      scratch_ = PHX::View<ScalarT**>(
+        "GradBasisDotVector_SumFactorized::scratch_", numCells,
+        tensorBasis_.scratchSize());
+    } // end if (Sacado::IsADType<ScalarT>::value)
+  } // end of postRegistrationSetup()
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  operator()()
+  //
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename EvalT, typename Traits>
+  KOKKOS_INLINE_FUNCTION
+  void
+  Integrator_GradBasisDotVector_SumFactorized<EvalT, Traits>::
+  operator()(
+    const std::size_t& cell) const
+  {
+    using panzer::EvaluatorStyle;
+    const int numQP(vector_.extent(1)), numDim(vector_.extent(2)),
+              numBases(field_.extent(1)),
+              numFieldMults(kokkosFieldMults_.extent(0));
+
+    // Map the vector to the reference cell, G_e = w J^{-1}_{ed} s_d, and
+    // scale it by the multiplier and the field multipliers.
+    for (int qp(0); qp < numQP; ++qp)
+    {
+      for (int e(0); e < numDim; ++e)
+      {
+        refVector_(cell, qp, e) = 0.0;
+        for (int dim(0); dim < numDim; ++dim)
+          refVector_(cell, qp, e) += jacInv_(cell, qp, e, dim) *
+            vector_(cell, qp, dim);
+        refVector_(cell, qp, e) *= multiplier_ * weightedMeasure_(cell, qp);
+        for (int fm(0); fm < numFieldMults; ++fm)
+          refVector_(cell, qp, e) *= kokkosFieldMults_(fm)(cell, qp);
+      } // end loop over the reference directions
+    } // end loop over the quadrature points
+
+    // Initialize the evaluated field, and then perform the integration one
+    // direction at a time.
+    if (evalStyle_ == EvaluatorStyle::EVALUATES)
+      for (int basis(0); basis < numBases; ++basis)
+        field_(cell, basis) = 0.0;
+    tensorBasis_.integrateGradient(cell, refVector_, field_, scratch_);
+  } // end of operator()()
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  evaluateFields()
+  //
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename EvalT, typename Traits>
+  void
+  Integrator_GradBasisDotVector_SumFactorized<EvalT, Traits>::
+  evaluateFields(
+    typename Traits::EvalData workset)
+  {
+    using Kokkos::parallel_for;
+    using Kokkos::RangePolicy;
+
+    // Grab the geometry of the integration rule.
+    const auto& iv = *this->wda(workset).int_rules[quadIndex_];
+    jacInv_          = iv.jac_inv;
+    weightedMeasure_ = iv.weighted_measure;
+
+    // Loop over the cells in the Workset and execute operator()() above.
+    parallel_for(this->getName(),
+      RangePolicy<PHX::exec_space>(0, workset.num_cells), *this);
+  } // end of evaluateFields()
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  getValidParameters()
+  //
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename EvalT, typename TRAITS>
+  Teuchos::RCP<Teuchos::ParameterList>
+  Integrator_GradBasisDotVector_SumFactorized<EvalT, TRAITS>::
+  getValidParameters() const
+  {
+    using panzer::BasisIRLayout;
+    using panzer::IntegrationRule;
+    using std::string;
+    using std::vector;
+    using Teuchos::ParameterList;
+    using Teuchos::RCP;
+    using Teuchos::rcp;
+
+    // Create a ParameterList with all the valid keys we support.
+    RCP<ParameterList> p = rcp(new ParameterList);
+    p->set<string>("Residual Name", "?");
+    p->set<string>("Flux Name", "?");
+    RCP<BasisIRLayout> basis;
+    p->set("Basis", basis);
+    RCP<IntegrationRule> ir;
+    p->set("IR", ir);
+    p->set<double>("Multiplier", 1.0);
+    RCP<const vector<string>> fms;
+    p->set("Field Multipliers", fms);
+    return p;
+  } // end of getValidParameters()
+
+} // end of namespace panzer
+
+#endif // __Panzer_Integrator_GradBasisDotVector_SumFactorized_impl_hpp__
@@ -0,0 +1,412 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#ifndef   PANZER_INTEGRATOR_LINEAROPERATOR_HPP
+#define   PANZER_INTEGRATOR_LINEAROPERATOR_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Include Files
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// C++
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Panzer
+#include "Panzer_Dimension.hpp"
+#include "Panzer_Evaluator_WithBaseImpl.hpp"
+#include "Panzer_EvaluatorStyle.hpp"
+#include "Panzer_PureBasis.hpp"
+#include "Panzer_Traits.hpp"
+
+// Phalanx
+#include "Phalanx_DataLayout_MDALayout.hpp"
+#include "Phalanx_Evaluator_Derived.hpp"
+#include "Phalanx_MDField.hpp"
+
+namespace panzer
+{
+  class BasisIRLayout;
+  class IntegrationRule;
+
+  /**
+   *  \brief The bilinear form assembled by an `Integrator_LinearOperator`.
+   */
+  enum class LinearOperatorType
+  {
+    MASS,      /*!< \f$ \int \phi_i \phi_j \,dx \f$ */
+    STIFFNESS, /*!< \f$ \int \nabla\phi_i \cdot \nabla\phi_j \,dx \f$ */
+  }; // end of enum class LinearOperatorType
+
+  /**
+   *  \brief The layout of an element matrix, `<Cell,BASIS,BASIS>`, shared by
+   *         the `Integrator_LinearOperator` that evaluates it and the scatter
+   *         that assembles it.
+   */
+  inline Teuchos::RCP<PHX::DataLayout>
+  linearElementMatrixLayout(
+    const panzer::PureBasis& basis)
+  {
+    return Teuchos::rcp(new PHX::MDALayout<panzer::Cell, panzer::BASIS,
+      panzer::BASIS>(basis.numCells(), basis.cardinality(),
+      basis.cardinality()));
+  } // end of linearElementMatrixLayout()
+
+  /**
+   *  \brief Computes \f$ Ma(x)b(x)\cdots\int \mathcal{L}(u)\,\phi\,dx \f$ for
+   *         a term that is linear in the degree of freedom \f$ u \f$.
+   *
+   *  Evaluates either the mass term
+   *  \f[
+   *    Ma(x)b(x)\cdots\int u\,\phi_i\,dx
+   *  \f]
+   *  or the stiffness term
+   *  \f[
+   *    Ma(x)b(x)\cdots\int \nabla u\cdot\nabla\phi_i\,dx,
+   *  \f]
+   *  where \f$ u = \sum_j u_j \phi_j \f$ is interpolated from the gathered
+   *  basis coefficients of the degree of freedom.
+   *
+   *  For the `Jacobian` evaluation type the term is formed from the element
+   *  matrices \f$ K_{ij} \f$, computed in `double` for all cells of the
+   *  workset at once. Only the value of the residual, \f$ K u \f$, is written
+   *  to the (FAD) residual field; the matrix itself, scaled by the gather seed,
+   *  is stored in the element matrix field and summed into the global
+   *  Jacobian by the scatter next to the AD derivatives of the nonlinear terms
+   *  (see `EquationSet_DefaultImpl::addLinearElementMatrix()`). All other
+   *  evaluation types, and Jacobians with respect to parameters, integrate
+   *  with the full scalar type.
+   *
+   *  \note The field multipliers (\f$ a(x) \f$, \f$ b(x) \f$, etc.) must not
+   *        depend on the degrees of freedom, their derivatives are dropped
+   *        from the element matrix. The degree of freedom, or the one it is
+   *        the time derivative of, gives the columns of the matrix and must be
+   *        the column DOF registered with the matrix.
+   */
+  template<typename EvalT, typename Traits>
+  class Integrator_LinearOperator
+    :
+    public panzer::EvaluatorWithBaseImpl<Traits>,
+    public PHX::EvaluatorDerived<EvalT, Traits>
+  {
+    public:
+
+      /**
+       *  \brief Main Constructor.
+       *
+       *  \param[in] evalStyle      An `enum` declaring the behavior of this
+       *                            `Evaluator`, which is to either:
+       *                            - compute and contribute (`CONTRIBUTES`),
+       *                              or
+       *                            - compute and store (`EVALUATES`).
+       *  \param[in] resName        The name of either the contributed or
+       *                            evaluated field, depending on `evalStyle`.
+       *  \param[in] dofName        The name of the gathered degree of freedom
+       *                            (\f$ u \f$), laid out on the basis.
+       *  \param[in] matrixName     The name of the element matrix field
+       *                            evaluated for the `Jacobian`.
+       *  \param[in] basis          The scalar basis that you'd like to use
+       *                            (\f$ \phi \f$).
+       *  \param[in] ir             The integration rule that you'd like to use.
+       *  \param[in] opType         The bilinear form to assemble.
+       *  \param[in] multiplier     The scalar multiplier out in front of the
+       *                            integral you're computing (\f$ M \f$).  If
+       *                            not specified, this defaults to 1.
+       *  \param[in] fmNames        A list of names of fields that are
+       *                            multipliers out in front of the integral
+       *                            you're computing (\f$ a(x) \f$, \f$ b(x)
+       *                            \f$, etc.).  If not specified, this
+       *                            defaults to an empty `vector`.
+       *  \param[in] timeDerivative Whether `dofName` is the time derivative of
+       *                            the degree of freedom, in which case the
+       *                            element matrix is scaled by \f$ \alpha \f$
+       *                            instead of \f$ \beta \f$.
+       *  \param[in] sensName      The sensitivities name the solution gather
+       *                            seeds its derivatives for. The element
+       *                            matrix is only used when it is the current
+       *                            first sensitivities name.  If not
+       *                            specified, this defaults to "", the name of
+       *                            the default gather.
+       *
+       *  \throws std::invalid_argument If any of the inputs are invalid.
+       *  \throws std::logic_error      If the `basis` supplied is not a scalar
+       *                                basis, or a stiffness term is requested
+       *                                for a basis without gradients.
+       */
+      Integrator_LinearOperator(
+        const panzer::EvaluatorStyle&     evalStyle,
+        const std::string&                resName,
+        const std::string&                dofName,
+        const std::string&                matrixName,
+        const panzer::BasisIRLayout&      basis,
+        const panzer::IntegrationRule&    ir,
+        const panzer::LinearOperatorType& opType,
+        const double&                     multiplier     = 1,
+        const std::vector<std::string>&   fmNames        =
+          std::vector<std::string>(),
+        const bool                        timeDerivative = false,
+        const std::string&                sensName       = "");
+
+      /**
+       *  \brief `ParameterList` Constructor.
+       *
+       *  \param[in] p A `ParameterList` of the form
+                       \code{.xml}
+                       <ParameterList>
+                         <Parameter name = "Residual Name"       type = "std::string"                         value = (required)    />
+                         <Parameter name = "DOF Name"            type = "std::string"                         value = (required)    />
+                         <Parameter name = "Element Matrix Name" type = "std::string"                         value = (required)    />
+                         <Parameter name = "Basis"               type = "RCP<panzer::BasisIRLayout>"          value = (required)    />
+                         <Parameter name = "IR"                  type = "RCP<panzer::IntegrationRule>"        value = (required)    />
+                         <Parameter name = "Operator"            type = "std::string"                         value = "Mass" or "Stiffness" (required)/>
+                         <Parameter name = "Multiplier"          type = "double"                              value = 1.0 (default) />
+                         <Parameter name = "Field Multipliers"   type = "RCP<const std::vector<std::string>>" value = null (default)/>
+                         <Parameter name = "Time Derivative"     type = "bool"                                value = false (default)/>
+                         <Parameter name = "Sensitivities Name"  type = "std::string"                         value = "" (default)  />
+                       </ParameterList>
+                       \endcode
+       *               The `Evaluator` evaluates (`EVALUATES`) the residual.
+       */
+      Integrator_LinearOperator(
+        const Teuchos::ParameterList& p);
+
+      /**
+       *  \brief Post-Registration Setup.
+       *
+       *  Get the PHX::Views of the field multipliers, determine the index in
+       *  the Workset bases for our particular basis name, and allocate the
+       *  temporaries.
+       *
+       *  \param[in] sd Essentially a list of `Workset`s, which are collections
+       *                of cells (elements) that all live on a single process.
+       *  \param[in] fm This is unused, though part of the interface.
+       */
+      void
+      postRegistrationSetup(
+        typename Traits::SetupData sd,
+        PHX::FieldManager<Traits>& fm);
+
+      /**
+       *  \brief Pre-Evaluate.
+       *
+       *  The element matrix only replaces the derivatives of the residual
+       *  when they are taken with respect to the solution, i.e. when the
+       *  first sensitivities name is the one of the solution gather.
+       *
+       *  \param[in] d The pre-evaluation data.
+       */
+      void
+      preEvaluate(
+        typename Traits::PreEvalData d);
+
+      /**
+       *  \brief Evaluate Fields.
+       *
+       *  \param[in] workset The `Workset` on which you're going to do the
+       *                     integration.
+       */
+      void
+      evaluateFields(
+        typename Traits::EvalData workset);
+
+      //! Integrate with the full scalar type, one cell per thread.
+      struct ScalarTag {};
+
+      //! Coefficient at the quadrature points, one cell per thread.
+      struct CoefficientTag {};
+
+      //! One entry of the element matrices of the workset.
+      struct ElementMatrixTag {};
+
+      //! Residual value from the element matrix, then the seed, one cell per thread.
+      struct ApplyTag {};
+
+      KOKKOS_INLINE_FUNCTION
+      void
+      operator()(
+        const ScalarTag&   tag,
+        const std::size_t& cell) const;
+
+      KOKKOS_INLINE_FUNCTION
+      void
+      operator()(
+        const CoefficientTag& tag,
+        const std::size_t&    cell) const;
+
+      KOKKOS_INLINE_FUNCTION
+      void
+      operator()(
+        const ElementMatrixTag& tag,
+        const int&              cell,
+        const int&              i,
+        const int&              j) const;
+
+      KOKKOS_INLINE_FUNCTION
+      void
+      operator()(
+        const ApplyTag&    tag,
+        const std::size_t& cell) const;
+
+    private:
+
+      /**
+       *  \brief Get Valid Parameters.
+       *
+       *  \returns A `ParameterList` with all the valid parameters (keys) in
+       *           it.  The values tied to those keys are meaningless default
+       *           values.
+       */
+      Teuchos::RCP<Teuchos::ParameterList>
+      getValidParameters() const;
+
+      /**
+       *  \brief The scalar type.
+       */
+      using ScalarT = typename EvalT::ScalarT;
+
+      /**
+       *  \brief Whether this is the `Jacobian` evaluation type, the only one
+       *         that assembles element matrices.
+       */
+      static constexpr bool isJacobian_ =
+        std::is_same<EvalT, panzer::Traits::Jacobian>::value;
+
+      /**
+       *  \brief An `enum` determining the behavior of this `Evaluator`.
+       */
+      const panzer::EvaluatorStyle evalStyle_;
+
+      /**
+       *  \brief The bilinear form to assemble.
+       */
+      const panzer::LinearOperatorType opType_;
+
+      /**
+       *  \brief A field to which we'll contribute, or in which we'll store,
+       *         the result of computing this integral.
+       */
+      PHX::MDField<ScalarT, panzer::Cell, panzer::BASIS> field_;
+
+      /**
+       *  \brief The gathered basis coefficients of the degree of freedom.
+       */
+      PHX::MDField<const ScalarT, panzer::Cell, panzer::BASIS> dof_;
+
+      /**
+       *  \brief The element matrices, evaluated for the `Jacobian` only.
+       */
+      PHX::MDField<double, panzer::Cell, panzer::BASIS, panzer::BASIS> matrix_;
+
+      /**
+       *  \brief The scalar multiplier out in front of the integral (\f$ M
+       *         \f$).
+       */
+      double multiplier_;
+
+      /**
+       *  \brief Whether the degree of freedom is a time derivative.
+       */
+      bool timeDerivative_;
+
+      /**
+       *  \brief The sensitivities name of the solution gather.
+       */
+      std::string sensitivitiesName_;
+
+      /**
+       *  \brief Whether the derivatives are taken with respect to the
+       *         solution, set in `preEvaluate()`.
+       */
+      bool applySensitivities_;
+
+      /**
+       *  \brief The gather seed the element matrix is scaled by.
+       */
+      double seed_;
+
+      /**
+       *  \brief The (possibly empty) list of fields that are multipliers out
+       *         in front of the integral (\f$ a(x) \f$, \f$ b(x) \f$, etc.).
+       */
+      std::vector<PHX::MDField<const ScalarT, panzer::Cell, panzer::IP>> fieldMults_;
+
+      /**
+       *  \brief The `PHX::View` representation of the field multipliers.
+       */
+      PHX::View<Kokkos::View<const ScalarT**, typename PHX::DevLayout<ScalarT>::type, Kokkos::MemoryUnmanaged>*> kokkosFieldMults_;
+
+      /**
+       *  \brief The name of the basis we're using.
+       */
+      std::string basisName_;
+
+      /**
+       *  \brief The index in the `Workset` bases for our particular
+       *         `BasisIRLayout` name.
+       */
+      std::size_t basisIndex_;
+
+      /**
+       *  \brief The weighted and unweighted basis values (mass), or basis
+       *         gradients (stiffness), of the current workset.
+       */
+      PHX::MDField<double, panzer::Cell, panzer::BASIS, panzer::IP> weightedBasis_, basis_;
+      PHX::MDField<const double, panzer::Cell, panzer::BASIS, panzer::IP, panzer::Dim> weightedGradBasis_;
+      PHX::MDField<double, panzer::Cell, panzer::BASIS, panzer::IP, panzer::Dim> gradBasis_;
+
+      /**
+       *  \brief The `double` coefficient at the quadrature points, used to
+       *         build the element matrices.
+       */
+      PHX::View<double**> coefficient_;
+
+      /// For storing temporaries, one value per thread
+      PHX::View<ScalarT*> tmp_;
+
+  }; // end of class Integrator_LinearOperator
+
+} // end of namespace panzer
+
+#endif // PANZER_INTEGRATOR_LINEAROPERATOR_HPP
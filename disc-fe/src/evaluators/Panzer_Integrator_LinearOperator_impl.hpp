@@ -0,0 +1,502 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#ifndef   PANZER_INTEGRATOR_LINEAROPERATOR_IMPL_HPP
+#define   PANZER_INTEGRATOR_LINEAROPERATOR_IMPL_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Include Files
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Panzer
+#include "Panzer_BasisIRLayout.hpp"
+#include "Panzer_IntegrationRule.hpp"
+#include "Panzer_Workset_Utilities.hpp"
+
+namespace panzer
+{
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Main Constructor
+  //
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename EvalT, typename Traits>
+  Integrator_LinearOperator<EvalT, Traits>::
+  Integrator_LinearOperator(
+    const panzer::EvaluatorStyle&     evalStyle,
+    const std::string&                resName,
+    const std::string&                dofName,
+    const std::string&                matrixName,
+    const panzer::BasisIRLayout&      basis,
+    const panzer::IntegrationRule&    ir,
+    const panzer::LinearOperatorType& opType,
+    const double&                     multiplier,     /* = 1 */
+    const std::vector<std::string>&   fmNames,        /* =
+      std::vector<std::string>() */
+    const bool                        timeDerivative, /* = false */
+    const std::string&                sensName        /* = "" */)
+    :
+    evalStyle_(evalStyle),
+    opType_(opType),
+    multiplier_(multiplier),
+    timeDerivative_(timeDerivative),
+    sensitivitiesName_(sensName),
+    applySensitivities_(true),
+    seed_(0.0),
+    basisName_(basis.name())
+  {
+    using PHX::View;
+    using panzer::BASIS;
+    using panzer::Cell;
+    using panzer::EvaluatorStyle;
+    using panzer::IP;
+    using panzer::PureBasis;
+    using PHX::MDField;
+    using std::invalid_argument;
+    using std::logic_error;
+    using std::string;
+    using Teuchos::RCP;
+
+    // Ensure the input makes sense.
+    TEUCHOS_TEST_FOR_EXCEPTION(resName == "", invalid_argument, "Error:  "    \
+      "Integrator_LinearOperator called with an empty residual name.")
+    TEUCHOS_TEST_FOR_EXCEPTION(dofName == "", invalid_argument, "Error:  "    \
+      "Integrator_LinearOperator called with an empty DOF name.")
+    TEUCHOS_TEST_FOR_EXCEPTION(matrixName == "", invalid_argument, "Error:  " \
+      "Integrator_LinearOperator called with an empty element matrix name.")
+    RCP<const PureBasis> tmpBasis = basis.getBasis();
+    TEUCHOS_TEST_FOR_EXCEPTION(not tmpBasis->isScalarBasis(), logic_error,
+      "Error:  Integrator_LinearOperator:  Basis of type \""
+      << tmpBasis->name() << "\" is not a scalar basis.")
+    TEUCHOS_TEST_FOR_EXCEPTION(opType == LinearOperatorType::STIFFNESS and
+      not tmpBasis->supportsGrad(), logic_error, "Error:  "                   \
+      "Integrator_LinearOperator:  Basis of type \"" << tmpBasis->name()
+      << "\" does not support the gradient needed by a stiffness term.")
+
+    // The gathered degree of freedom.
+    dof_ = MDField<const ScalarT, Cell, BASIS>(dofName, basis.functional);
+    this->addDependentField(dof_);
+
+    // Create the field that we're either contributing to or evaluating
+    // (storing).
+    field_ = MDField<ScalarT, Cell, BASIS>(resName, basis.functional);
+    if (evalStyle == EvaluatorStyle::CONTRIBUTES)
+      this->addContributedField(field_);
+    else // if (evalStyle == EvaluatorStyle::EVALUATES)
+      this->addEvaluatedField(field_);
+
+    // Only the Jacobian hands an element matrix to the scatter.
+    matrix_ = MDField<double, Cell, BASIS, BASIS>(matrixName,
+      linearElementMatrixLayout(*tmpBasis));
+    if (isJacobian_)
+      this->addEvaluatedField(matrix_);
+
+    // Add the dependent field multipliers, if there are any.
+    int i(0);
+    fieldMults_.resize(fmNames.size());
+    kokkosFieldMults_ =
+      View<Kokkos::View<const ScalarT**, typename PHX::DevLayout<ScalarT>::type, Kokkos::MemoryUnmanaged>*>("LinearOperator::KokkosFieldMultipliers",
+      fmNames.size());
+    for (const auto& name : fmNames)
+    {
+      fieldMults_[i++] = MDField<const ScalarT, Cell, IP>(name, ir.dl_scalar);
+      this->addDependentField(fieldMults_[i - 1]);
+    } // end loop over the field multipliers
+
+    // Set the name of this object.
+    string n("Integrator_LinearOperator (");
+    if (evalStyle_ == EvaluatorStyle::CONTRIBUTES)
+      n += "CONTRIBUTES";
+    else // if (evalStyle_ == EvaluatorStyle::EVALUATES)
+      n += "EVALUATES";
+    n += (opType_ == LinearOperatorType::MASS ? ", MASS" : ", STIFFNESS");
+    n += "):  " + field_.fieldTag().name();
+    this->setName(n);
+  } // end of Main Constructor
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  ParameterList Constructor
+  //
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename EvalT, typename Traits>
+  Integrator_LinearOperator<EvalT, Traits>::
+  Integrator_LinearOperator(
+    const Teuchos::ParameterList& p)
+    :
+    Integrator_LinearOperator(
+      panzer::EvaluatorStyle::EVALUATES,
+      p.get<std::string>("Residual Name"),
+      p.get<std::string>("DOF Name"),
+      p.get<std::string>("Element Matrix Name"),
+      (*p.get<Teuchos::RCP<panzer::BasisIRLayout>>("Basis")),
+      (*p.get<Teuchos::RCP<panzer::IntegrationRule>>("IR")),
+      p.get<std::string>("Operator") == "Stiffness" ?
+        panzer::LinearOperatorType::STIFFNESS :
+        panzer::LinearOperatorType::MASS,
+      p.isType<double>("Multiplier") ? p.get<double>("Multiplier") : 1.0,
+      p.isType<Teuchos::RCP<const std::vector<std::string>>>
+        ("Field Multipliers") ?
+        (*p.get<Teuchos::RCP<const std::vector<std::string>>>
+        ("Field Multipliers")) : std::vector<std::string>(),
+      p.isType<bool>("Time Derivative") ? p.get<bool>("Time Derivative") :
+        false,
+      p.isType<std::string>("Sensitivities Name") ?
+        p.get<std::string>("Sensitivities Name") : std::string(""))
+  {
+    using Teuchos::ParameterList;
+    using Teuchos::RCP;
+
+    // Ensure that the input ParameterList didn't contain any bogus entries.
+    RCP<ParameterList> validParams = this->getValidParameters();
+    p.validateParameters(*validParams);
+
+    const std::string op = p.get<std::string>("Operator");
+    TEUCHOS_TEST_FOR_EXCEPTION(op != "Mass" and op != "Stiffness",
+      std::invalid_argument, "Error:  Integrator_LinearOperator:  Operator \""
+      << op << "\" is not one of \"Mass\" or \"Stiffness\".")
+  } // end of ParameterList Constructor
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  postRegistrationSetup()
+  //
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename EvalT, typename Traits>
+  void
+  Integrator_LinearOperator<EvalT, Traits>::
+  postRegistrationSetup(
+    typename Traits::SetupData sd,
+    PHX::FieldManager<Traits>& /* fm */)
+  {
+    using panzer::getBasisIndex;
+    using std::size_t;
+
+    auto kokkosFieldMults_h = Kokkos::create_mirror_view(kokkosFieldMults_);
+
+    // Get the PHX::Views of the field multipliers.
+    for (size_t i(0); i < fieldMults_.size(); ++i)
+      kokkosFieldMults_h(i) = fieldMults_[i].get_static_view();
+
+    Kokkos::deep_copy(kokkosFieldMults_, kokkosFieldMults_h);
+
+    // Determine the index in the Workset bases for our particular basis name.
+    basisIndex_ = getBasisIndex(basisName_, (*sd.worksets_)[0], this->wda);
+
+    // Allocate temporaries
+    if (isJacobian_) {
+      const int numQP = this->wda((*sd.worksets_)[0]).bases[basisIndex_]->basis_layout->numPoints();
+      coefficient_ = PHX::View<double**>("LinearOperator::coefficient_",field_.extent(0),numQP);
+    }
+    if (Sacado::IsADType<ScalarT>::value) {
+      const auto fadSize = Kokkos::dimension_scalar(field_.get_view());
+      tmp_ = PHX::View<ScalarT*>("LinearOperator::tmp_",field_.extent(0),fadSize);
+    } else {
+      tmp_ = PHX::View<ScalarT*>("LinearOperator::tmp_",field_.extent(0));
+    }
+  } // end of postRegistrationSetup()
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  preEvaluate()
+  //
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename EvalT, typename Traits>
+  void
+  Integrator_LinearOperator<EvalT, Traits>::
+  preEvaluate(
+    typename Traits::PreEvalData d)
+  {
+    // The solution gather seeds its derivatives only when its own
+    // sensitivities are requested.
+    applySensitivities_ = d.first_sensitivities_name == sensitivitiesName_;
+  } // end of preEvaluate()
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  operator()(ScalarTag)
+  //
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename EvalT, typename Traits>
+  KOKKOS_INLINE_FUNCTION
+  void
+  Integrator_LinearOperator<EvalT, Traits>::
+  operator()(
+    const ScalarTag& /* tag */,
+    const size_t&    cell) const
+  {
+    using panzer::EvaluatorStyle;
+
+    const int numBases(dof_.extent(1)), numFieldMults(kokkosFieldMults_.extent(0));
+    if (evalStyle_ == EvaluatorStyle::EVALUATES)
+      for (int basis(0); basis < numBases; ++basis)
+        field_(cell, basis) = 0.0;
+
+    if (opType_ == LinearOperatorType::MASS)
+    {
+      const int numQP(basis_.extent(2));
+      for (int qp(0); qp < numQP; ++qp)
+      {
+        // interpolate the degree of freedom, then scale it
+        tmp_(cell) = 0.0;
+        for (int basis(0); basis < numBases; ++basis)
+          tmp_(cell) += basis_(cell, basis, qp) * dof_(cell, basis);
+        tmp_(cell) *= multiplier_;
+        for (int fm(0); fm < numFieldMults; ++fm)
+          tmp_(cell) *= kokkosFieldMults_(fm)(cell, qp);
+        for (int basis(0); basis < numBases; ++basis)
+          field_(cell, basis) += weightedBasis_(cell, basis, qp) * tmp_(cell);
+      } // end loop over the quadrature points
+    }
+    else // if (opType_ == LinearOperatorType::STIFFNESS)
+    {
+      const int numQP(gradBasis_.extent(2)), numDim(gradBasis_.extent(3));
+      for (int qp(0); qp < numQP; ++qp)
+      {
+        for (int dim(0); dim < numDim; ++dim)
+        {
+          tmp_(cell) = 0.0;
+          for (int basis(0); basis < numBases; ++basis)
+            tmp_(cell) += gradBasis_(cell, basis, qp, dim) * dof_(cell, basis);
+          tmp_(cell) *= multiplier_;
+          for (int fm(0); fm < numFieldMults; ++fm)
+            tmp_(cell) *= kokkosFieldMults_(fm)(cell, qp);
+          for (int basis(0); basis < numBases; ++basis)
+            field_(cell, basis) += weightedGradBasis_(cell, basis, qp, dim) * tmp_(cell);
+        } // end loop over the dimensions
+      } // end loop over the quadrature points
+    } // end if (opType_ == something)
+  } // end of operator()(ScalarTag)
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  operator()(CoefficientTag)
+  //
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename EvalT, typename Traits>
+  KOKKOS_INLINE_FUNCTION
+  void
+  Integrator_LinearOperator<EvalT, Traits>::
+  operator()(
+    const CoefficientTag& /* tag */,
+    const size_t&         cell) const
+  {
+    // The derivatives of the field multipliers are dropped, they are
+    // constant in the degrees of freedom.
+    const int numQP(coefficient_.extent(1)), numFieldMults(kokkosFieldMults_.extent(0));
+    for (int qp(0); qp < numQP; ++qp)
+    {
+      double c(multiplier_);
+      for (int fm(0); fm < numFieldMults; ++fm)
+        c *= Sacado::scalarValue(kokkosFieldMults_(fm)(cell, qp));
+      coefficient_(cell, qp) = c;
+    } // end loop over the quadrature points
+  } // end of operator()(CoefficientTag)
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  operator()(ElementMatrixTag)
+  //
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename EvalT, typename Traits>
+  KOKKOS_INLINE_FUNCTION
+  void
+  Integrator_LinearOperator<EvalT, Traits>::
+  operator()(
+    const ElementMatrixTag& /* tag */,
+    const int&              cell,
+    const int&              i,
+    const int&              j) const
+  {
+    // K_ij = sum_qp,dim (weighted basis)_i,qp,dim c_qp basis_j,qp,dim, the
+    // (basis x qp) by (qp x basis) product of one cell of the batch
+    double k(0.0);
+    if (opType_ == LinearOperatorType::MASS)
+    {
+      const int numQP(basis_.extent(2));
+      for (int qp(0); qp < numQP; ++qp)
+        k += weightedBasis_(cell, i, qp) * coefficient_(cell, qp) * basis_(cell, j, qp);
+    }
+    else // if (opType_ == LinearOperatorType::STIFFNESS)
+    {
+      const int numQP(gradBasis_.extent(2)), numDim(gradBasis_.extent(3));
+      for (int qp(0); qp < numQP; ++qp)
+      {
+        double g(0.0);
+        for (int dim(0); dim < numDim; ++dim)
+          g += weightedGradBasis_(cell, i, qp, dim) * gradBasis_(cell, j, qp, dim);
+        k += g * coefficient_(cell, qp);
+      } // end loop over the quadrature points
+    } // end if (opType_ == something)
+    matrix_(cell, i, j) = k;
+  } // end of operator()(ElementMatrixTag)
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  operator()(ApplyTag)
+  //
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename EvalT, typename Traits>
+  KOKKOS_INLINE_FUNCTION
+  void
+  Integrator_LinearOperator<EvalT, Traits>::
+  operator()(
+    const ApplyTag&  /* tag */,
+    const size_t&    cell) const
+  {
+    using panzer::EvaluatorStyle;
+
+    // Only the value of the residual is set here, assigning a double clears
+    // the derivatives and adding one leaves them alone.
+    const int numBases(dof_.extent(1));
+    for (int i(0); i < numBases; ++i)
+    {
+      double r(0.0);
+      for (int j(0); j < numBases; ++j)
+        r += matrix_(cell, i, j) * Sacado::scalarValue(dof_(cell, j));
+      if (evalStyle_ == EvaluatorStyle::EVALUATES)
+        field_(cell, i) = r;
+      else // if (evalStyle_ == EvaluatorStyle::CONTRIBUTES)
+        field_(cell, i) += r;
+    } // end loop over the rows
+
+    // d(residual)/d(solution) = K d(dof)/d(solution) = seed K
+    for (int i(0); i < numBases; ++i)
+      for (int j(0); j < numBases; ++j)
+        matrix_(cell, i, j) *= seed_;
+  } // end of operator()(ApplyTag)
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  evaluateFields()
+  //
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename EvalT, typename Traits>
+  void
+  Integrator_LinearOperator<EvalT, Traits>::
+  evaluateFields(
+    typename Traits::EvalData workset)
+  {
+    using Kokkos::MDRangePolicy;
+    using Kokkos::parallel_for;
+    using Kokkos::RangePolicy;
+
+    // Grab the basis information.
+    const auto& bv = *this->wda(workset).bases[basisIndex_];
+    if (opType_ == LinearOperatorType::MASS)
+    {
+      weightedBasis_ = bv.weighted_basis_scalar;
+      basis_         = bv.basis_scalar;
+    }
+    else // if (opType_ == LinearOperatorType::STIFFNESS)
+    {
+      weightedGradBasis_ = bv.getGradBasisValues(true);
+      gradBasis_         = bv.grad_basis;
+    } // end if (opType_ == something)
+
+    if (not isJacobian_)
+    {
+      parallel_for(RangePolicy<ScalarTag>(0, workset.num_cells), *this);
+      return;
+    }
+
+    // Jacobians with respect to parameters need the derivatives of the field
+    // multipliers, take the AD path and hand an empty matrix to the scatter.
+    if (not applySensitivities_)
+    {
+      parallel_for(RangePolicy<ScalarTag>(0, workset.num_cells), *this);
+      Kokkos::deep_copy(matrix_.get_static_view(), 0.0);
+      return;
+    }
+
+    seed_ = timeDerivative_ ? workset.alpha : workset.beta;
+
+    // Build the element matrices of the whole workset, one (i,j) entry per
+    // thread, then apply them to the degree of freedom.
+    const int numBases(dof_.extent(1));
+    parallel_for(RangePolicy<CoefficientTag>(0, workset.num_cells), *this);
+    parallel_for(MDRangePolicy<ElementMatrixTag, Kokkos::Rank<3>>({0, 0, 0},
+      {static_cast<int>(workset.num_cells), numBases, numBases}), *this);
+    parallel_for(RangePolicy<ApplyTag>(0, workset.num_cells), *this);
+  } // end of evaluateFields()
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  getValidParameters()
+  //
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename EvalT, typename TRAITS>
+  Teuchos::RCP<Teuchos::ParameterList>
+  Integrator_LinearOperator<EvalT, TRAITS>::
+  getValidParameters() const
+  {
+    using panzer::BasisIRLayout;
+    using panzer::IntegrationRule;
+    using std::string;
+    using std::vector;
+    using Teuchos::ParameterList;
+    using Teuchos::RCP;
+    using Teuchos::rcp;
+
+    // Create a ParameterList with all the valid keys we support.
+    RCP<ParameterList> p = rcp(new ParameterList);
+    p->set<string>("Residual Name", "?");
+    p->set<string>("DOF Name", "?");
+    p->set<string>("Element Matrix Name", "?");
+    RCP<BasisIRLayout> basis;
+    p->set("Basis", basis);
+    RCP<IntegrationRule> ir;
+    p->set("IR", ir);
+    p->set<string>("Operator", "Mass");
+    p->set<double>("Multiplier", 1.0);
+    RCP<const vector<string>> fms;
+    p->set("Field Multipliers", fms);
+    p->set<bool>("Time Derivative", false);
+    p->set<string>("Sensitivities Name", "");
+    return p;
+  } // end of getValidParameters()
+
+} // end of namespace panzer
+
+#endif // PANZER_INTEGRATOR_LINEAROPERATOR_IMPL_HPP
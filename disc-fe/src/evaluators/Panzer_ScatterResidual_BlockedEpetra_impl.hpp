@@ -404,6 +404,13 @@ ScatterResidual_BlockedEpetra(const std::vector<Teuchos::RCP<const GlobalIndexer
   if(colIndexers_.size()==0)
     colIndexers_ = rowIndexers_;
 
+  // element matrices of linear terms are only assembled by ScatterResidual_Tpetra
+  typedef Teuchos::RCP<const std::map<std::string,std::vector<std::pair<std::string,std::string> > > > LinearMatrixMap;
+  TEUCHOS_TEST_FOR_EXCEPTION(p.isType<LinearMatrixMap>("Linear Element Matrices") &&
+                             !p.get<LinearMatrixMap>("Linear Element Matrices")->empty(),std::logic_error,
+                             "ScatterResidual: \"Linear Element Matrices\" are not supported by this scatter, "
+                             "use the Tpetra linear object factory.");
+
   this->setName(scatterName+" Scatter Residual BlockedEpetra (Jacobian)");
 }
 
@@ -54,6 +54,7 @@
 #include "Panzer_Traits.hpp"
 #include "Panzer_CloneableEvaluator.hpp"
 #include "Panzer_BlockedTpetraLinearObjContainer.hpp"
+#include "Panzer_ElementCrsOffsets.hpp"
 
 #include "Panzer_Evaluator_WithBaseImpl.hpp"
 
@@ -192,6 +193,7 @@ public:
          <Parameter name="Dependent Map" type="RCP<map<string,string> >" value="(required)"/>
          <Parameter name="Basis" type="RCP<const PureBasis>" value=(required)/>
          <Parameter name="Global Data Key" type="string" value="Residual Scatter Container" (default)/>
+         <Parameter name="Precompute Jacobian Offsets" type="bool" value="false" (default)/>
       </ParameterList>
       \endverbatim
 
@@ -199,13 +201,14 @@ public:
   * This field should be required so that the evaluators is guranteed to run. "Dependent Names"
   * specifies the field to be scatter to the operator.  The "Dependent Map" gives a mapping from the
   * dependent field to the field string used in the global indexer. "Basis" is the basis
-  * used to define the size of the "Dependent Names" fields. Finally "Global Data Key" is the key
+  * used to define the size of the "Dependent Names" fields. "Global Data Key" is the key
   * used to index into the GlobalDataContainer object, for finding the operator and residual
   * linear algebra data structures that need to be filled. By default this is the simple residual/jacobian
-  * with key "Residual Scatter Container".
+  * with key "Residual Scatter Container". Finally "Precompute Jacobian Offsets" resolves the
+  * position of every element matrix entry in the CRS blocks once per workset (see ElementCrsOffsets).
   */
   ScatterResidual_BlockedTpetra(const Teuchos::RCP<const BlockedDOFManager> & indexer)
-     : globalIndexer_(indexer) {}
+     : globalIndexer_(indexer), precomputeOffsets_(false) {}
   
   ScatterResidual_BlockedTpetra(const Teuchos::RCP<const BlockedDOFManager> & indexer,
                                 const Teuchos::ParameterList& p);
@@ -268,6 +271,10 @@ private:
   //! The offset values of the blocked DOFs per element. Size of number of blocks in the product vector + 1. The plus one is a sentinel.
   PHX::View<LO*> blockOffsets_;
 
+  //! Scatter through precomputed CRS offsets instead of searching the rows
+  bool precomputeOffsets_;
+  ElementCrsOffsets crsOffsets_;
+
   ScatterResidual_BlockedTpetra();
 };
 
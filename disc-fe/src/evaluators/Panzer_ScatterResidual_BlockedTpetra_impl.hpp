@@ -237,6 +237,7 @@ ScatterResidual_BlockedTpetra(const Teuchos::RCP<const BlockedDOFManager> & inde
                               const Teuchos::ParameterList& p)
    : globalIndexer_(indexer)
    , globalDataKey_("Residual Scatter Container")
+   , precomputeOffsets_(false)
 {
   std::string scatterName = p.get<std::string>("Scatter Name");
   scatterHolder_ =
@@ -267,6 +268,16 @@ ScatterResidual_BlockedTpetra(const Teuchos::RCP<const BlockedDOFManager> & inde
   if (p.isType<std::string>("Global Data Key"))
      globalDataKey_ = p.get<std::string>("Global Data Key");
 
+  if (p.isType<bool>("Precompute Jacobian Offsets"))
+     precomputeOffsets_ = p.get<bool>("Precompute Jacobian Offsets");
+
+  // element matrices of linear terms are only assembled by ScatterResidual_Tpetra
+  typedef Teuchos::RCP<const std::map<std::string,std::vector<std::pair<std::string,std::string> > > > LinearMatrixMap;
+  TEUCHOS_TEST_FOR_EXCEPTION(p.isType<LinearMatrixMap>("Linear Element Matrices") &&
+                             !p.get<LinearMatrixMap>("Linear Element Matrices")->empty(),std::logic_error,
+                             "ScatterResidual: \"Linear Element Matrices\" are not supported by this scatter, "
+                             "use the Tpetra linear object factory.");
+
   this->setName(scatterName+" Scatter Residual (Jacobian)");
 }
 
@@ -380,6 +391,7 @@ evaluateFields(typename TRAITS::EvalData workset)
 
   PHX::View<int**> blockExistsInJac =   PHX::View<int**>("blockExistsInJac_",numFieldBlocks,numFieldBlocks);
   auto hostBlockExistsInJac = Kokkos::create_mirror_view(blockExistsInJac);
+  std::vector<RCP<const CrsMatrixType> > crsBlocks(numFieldBlocks*numFieldBlocks);
 
   for (int row=0; row < numFieldBlocks; ++row) {
     for (int col=0; col < numFieldBlocks; ++col) {
@@ -414,6 +426,7 @@ evaluateFields(typename TRAITS::EvalData workset)
           typename LocalMatrixType::values_type unmanagedValues(managedMatrix.values.data(),managedMatrix.values.extent(0));
           LocalMatrixType unmanagedMatrix(managedMatrix.values.label(), managedMatrix.numCols(), unmanagedValues, unmanagedGraph);
           new (&hostJacTpetraBlocks(row,col)) LocalMatrixType(unmanagedMatrix);
+          crsBlocks[row*numFieldBlocks+col] = tpetraCrsMatrix;
         }
 
         hostBlockExistsInJac(row,col) = 1;
@@ -441,6 +454,29 @@ evaluateFields(typename TRAITS::EvalData workset)
     globalIndexers[block]->getElementLIDs(localCellIds,subviewOfBlockLIDs);
   }
 
+  // Resolve where each element matrix entry lives in the CRS blocks, once per workset
+  const bool useCrsOffsets = precomputeOffsets_;
+  ElementCrsOffsets::OffsetView crsOffsets;
+  if (useCrsOffsets) {
+    std::vector<const void*> graphs(crsBlocks.size(),nullptr);
+    for (std::size_t i=0; i < crsBlocks.size(); ++i)
+      if (nonnull(crsBlocks[i]))
+        graphs[i] = crsBlocks[i]->getCrsGraph().get();
+
+    const int numIds = static_cast<int>(worksetLIDs_.extent(1));
+    if (!crsOffsets_.lookup(workset.getIdentifier(),workset.getVersion(),workset.num_cells,graphs,numIds,numIds,crsOffsets)) {
+      for (int row=0; row < numFieldBlocks; ++row) {
+        for (int col=0; col < numFieldBlocks; ++col) {
+          const RCP<const CrsMatrixType> & crsBlock = crsBlocks[row*numFieldBlocks+col];
+          if (nonnull(crsBlock))
+            fillElementCrsOffsets(crsOffsets,crsBlock->getLocalMatrixDevice().graph,worksetLIDs_,
+                                  std::make_pair(static_cast<int>(blockOffsets_h(row)),static_cast<int>(blockOffsets_h(row+1))),
+                                  std::make_pair(static_cast<int>(blockOffsets_h(col)),static_cast<int>(blockOffsets_h(col+1))));
+        }
+      }
+    }
+  }
+
   // Loop over scattered fields
   for (std::size_t fieldIndex = 0; fieldIndex < scatterFields_.size(); fieldIndex++) {
 
@@ -474,6 +510,16 @@ evaluateFields(typename TRAITS::EvalData workset)
             const int stop = blockOffsets(blockColIndex+1);
             const int sensSize = stop-start;
 
+            if (useCrsOffsets) {
+              const auto& values = jacTpetraBlocks(blockRowIndex,blockColIndex).values;
+              for (int i=start; i < stop; ++i) {
+                const std::size_t k = crsOffsets(cell,fieldOffsets(basis),i);
+                if (k != ElementCrsOffsets::invalid())
+                  Kokkos::atomic_add(&values(k), tmpFieldVal.fastAccessDx(i));
+              }
+              continue;
+            }
+
             for (int i=0; i < sensSize; ++i)
               workset_vals(cell,i) = tmpFieldVal.fastAccessDx(start+i);
 
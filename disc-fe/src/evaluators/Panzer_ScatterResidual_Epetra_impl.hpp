@@ -347,6 +347,13 @@ ScatterResidual_Epetra(const Teuchos::RCP<const GlobalIndexer> & indexer,
   if(useDiscreteAdjoint)
   { TEUCHOS_ASSERT(colGlobalIndexer_==globalIndexer_); }
 
+  // element matrices of linear terms are only assembled by ScatterResidual_Tpetra
+  typedef Teuchos::RCP<const std::map<std::string,std::vector<std::pair<std::string,std::string> > > > LinearMatrixMap;
+  TEUCHOS_TEST_FOR_EXCEPTION(p.isType<LinearMatrixMap>("Linear Element Matrices") &&
+                             !p.get<LinearMatrixMap>("Linear Element Matrices")->empty(),std::logic_error,
+                             "ScatterResidual: \"Linear Element Matrices\" are not supported by this scatter, "
+                             "use the Tpetra linear object factory.");
+
   this->setName(scatterName+" Scatter Residual Epetra (Jacobian)");
 }
 
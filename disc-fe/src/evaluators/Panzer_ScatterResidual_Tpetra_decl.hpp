@@ -54,6 +54,7 @@
 #include "Panzer_Traits.hpp"
 #include "Panzer_CloneableEvaluator.hpp"
 #include "Panzer_TpetraLinearObjContainer.hpp"
+#include "Panzer_ElementCrsOffsets.hpp"
 
 #include "Panzer_NodeType.hpp"
 
@@ -64,6 +65,7 @@
 namespace panzer {
 
 class GlobalIndexer;
+class ElementMatrices_GlobalEvaluationData;
 
 /** \brief Pushes residual values into the residual vector for a 
            Newton-based solve
@@ -188,6 +190,12 @@ private:
 
   std::vector< Teuchos::ArrayRCP<double> > dfdp_vectors_;
 
+  // accumulates J*v when a direction vector is supplied (see MatrixFreeJacobianOp)
+  Teuchos::RCP<const TpetraLinearObjContainer<double,LO,GO,NodeT> > directionContainer_;
+
+  Kokkos::View<LO**, Kokkos::LayoutRight, PHX::Device> scratch_lids_;
+  std::vector<PHX::View<int*> > scratch_offsets_;
+
   ScatterResidual_Tpetra();
 };
 
@@ -242,6 +250,15 @@ private:
   std::string globalDataKey_; // what global data does this fill?
   Teuchos::RCP<const TpetraLinearObjContainer<double,LO,GO,NodeT> > tpetraContainer_;
 
+  // when present only the diagonal of the Jacobian is scattered, into its residual vector
+  Teuchos::RCP<const TpetraLinearObjContainer<double,LO,GO,NodeT> > diagonalContainer_;
+
+  // when present only the row sums of the Jacobian are scattered, into its residual vector
+  Teuchos::RCP<const TpetraLinearObjContainer<double,LO,GO,NodeT> > rowSumContainer_;
+
+  // when present the element Jacobians are stored in it and not summed into a matrix
+  Teuchos::RCP<ElementMatrices_GlobalEvaluationData> elementMatrices_;
+
   ScatterResidual_Tpetra();
 
   Kokkos::View<LO**, Kokkos::LayoutRight, PHX::Device> scratch_lids_;
@@ -250,6 +267,19 @@ private:
 
   int my_derivative_size_;
   int other_derivative_size_;
+
+  // scatter through precomputed CRS offsets instead of searching the rows
+  bool precomputeOffsets_;
+  ElementCrsOffsets crsOffsets_;
+
+  // element matrices of the linear terms, summed into the Jacobian next to the
+  // derivatives of each scattered field (see Integrator_LinearOperator), with
+  // the field and offsets of their columns
+  std::vector<std::vector< PHX::MDField<const double,Cell,BASIS,BASIS> > > linearMatrices_;
+  std::vector<std::vector<std::string> > linearColumnFields_;
+  std::vector<std::vector< PHX::View<int*> > > linearColumnOffsets_;
+  Kokkos::View<LO**, Kokkos::LayoutRight, PHX::Device> linear_lids_;
+  Kokkos::View<double**, Kokkos::LayoutRight, PHX::Device> linear_vals_;
 };
 
 }
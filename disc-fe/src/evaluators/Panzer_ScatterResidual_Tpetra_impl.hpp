@@ -52,8 +52,10 @@
 #include "Panzer_PureBasis.hpp"
 #include "Panzer_TpetraLinearObjContainer.hpp"
 #include "Panzer_LOCPair_GlobalEvaluationData.hpp"
+#include "Panzer_ElementMatrices_GlobalEvaluationData.hpp"
 #include "Panzer_ParameterList_GlobalEvaluationData.hpp"
 #include "Panzer_GlobalEvaluationDataContainer.hpp"
+#include "Panzer_Integrator_LinearOperator.hpp"
 
 #include "Phalanx_DataLayout_MDALayout.hpp"
 
@@ -197,16 +199,27 @@ ScatterResidual_Tpetra(const Teuchos::RCP<const panzer::GlobalIndexer> & indexer
 // **********************************************************************
 template<typename TRAITS,typename LO,typename GO,typename NodeT>
 void panzer::ScatterResidual_Tpetra<panzer::Traits::Tangent, TRAITS,LO,GO,NodeT>::
-postRegistrationSetup(typename TRAITS::SetupData /* d */,
+postRegistrationSetup(typename TRAITS::SetupData d,
                       PHX::FieldManager<TRAITS>& /* fm */)
 {
   fieldIds_.resize(scatterFields_.size());
+  scratch_offsets_.resize(scatterFields_.size());
+  const Workset & workset_0 = (*d.worksets_)[0];
+  std::string blockId = this->wda(workset_0).block_id;
+
   // load required field numbers for fast use
   for(std::size_t fd=0;fd<scatterFields_.size();++fd) {
     // get field ID from DOF manager
     std::string fieldName = fieldMap_->find(scatterFields_[fd].fieldTag().name())->second;
     fieldIds_[fd] = globalIndexer_->getFieldNum(fieldName);
+
+    // device offsets for the directional derivative scatter
+    const std::vector<int> & offsets = globalIndexer_->getGIDFieldOffsets(blockId,fieldIds_[fd]);
+    scratch_offsets_[fd] = PHX::View<int*>("offsets",offsets.size());
+    Kokkos::deep_copy(scratch_offsets_[fd], Kokkos::View<const int*, Kokkos::HostSpace, Kokkos::MemoryUnmanaged>(offsets.data(), offsets.size()));
   }
+  scratch_lids_ = Kokkos::View<LO**, Kokkos::LayoutRight, PHX::Device>(
+    "lids",scatterFields_[0].extent(0),globalIndexer_->getElementBlockGIDCount(blockId));
 }
 
 // **********************************************************************
@@ -230,6 +243,43 @@ preEvaluate(typename TRAITS::PreEvalData d)
     Teuchos::ArrayRCP<double> vec_array = vec->get1dViewNonConst();
     dfdp_vectors_.push_back(vec_array);
   }
+
+  // a direction vector turns this into a directional derivative scatter (see MatrixFreeJacobianOp)
+  directionContainer_ = Teuchos::null;
+  if(d.gedc->containsDataObject("Directional Derivative Container")) {
+    RCP<LinearObjContainer> loc =
+      rcp_dynamic_cast<LOCPair_GlobalEvaluationData>(d.gedc->getDataObject("Directional Derivative Container"),true)->getGhostedLOC();
+    directionContainer_ = rcp_dynamic_cast<LOC>(loc,true);
+  }
+}
+
+// **********************************************************************
+namespace panzer {
+namespace {
+
+template <typename ScalarT,typename LO>
+class ScatterResidual_Direction_Functor {
+public:
+  typedef typename PHX::Device execution_space;
+  typedef PHX::MDField<const ScalarT,Cell,NODE> FieldType;
+
+  Kokkos::View<double**, Kokkos::LayoutLeft,PHX::Device> jv;
+
+  Kokkos::View<const LO**, Kokkos::LayoutRight, PHX::Device> lids; // local indices for unknowns.
+  PHX::View<const int*> offsets; // how to get a particular field
+  FieldType field;
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const unsigned int cell) const
+  {
+    for(std::size_t basis=0; basis < offsets.extent(0); basis++) {
+       LO lid = lids(cell,offsets(basis));
+       Kokkos::atomic_add(&jv(lid,0), field(cell,basis).fastAccessDx(0));
+    }
+  }
+};
+
+}
 }
 
 // **********************************************************************
@@ -241,6 +291,24 @@ evaluateFields(typename TRAITS::EvalData workset)
    std::string blockId = this->wda(workset).block_id;
    const std::vector<std::size_t> & localCellIds = this->wda(workset).cell_local_ids;
 
+   // the gather seeded the direction into the first derivative, it is the only
+   // derivative carried so the parameter sensitivities are not scattered
+   if(directionContainer_!=Teuchos::null) {
+     globalIndexer_->getElementLIDs(this->wda(workset).cell_local_ids_k,scratch_lids_);
+
+     ScatterResidual_Direction_Functor<ScalarT,LO> functor;
+     functor.jv = directionContainer_->get_f()->getLocalViewDevice(Tpetra::Access::ReadWrite);
+     functor.lids = scratch_lids_;
+
+     for (std::size_t fieldIndex = 0; fieldIndex < scatterFields_.size(); fieldIndex++) {
+       functor.offsets = scratch_offsets_[fieldIndex];
+       functor.field = scatterFields_[fieldIndex];
+
+       Kokkos::parallel_for(workset.num_cells,functor);
+     }
+     return;
+   }
+
    // NOTE: A reordering of these loops will likely improve performance
    //       The "getGIDFieldOffsets may be expensive.  However the
    //       "getElementGIDs" can be cheaper. However the lookup for LIDs
@@ -281,6 +349,7 @@ ScatterResidual_Tpetra(const Teuchos::RCP<const GlobalIndexer> & indexer,
    , globalDataKey_("Residual Scatter Container")
    , my_derivative_size_(0)
    , other_derivative_size_(0)
+   , precomputeOffsets_(false)
 {
   std::string scatterName = p.get<std::string>("Scatter Name");
   scatterHolder_ =
@@ -293,17 +362,39 @@ ScatterResidual_Tpetra(const Teuchos::RCP<const GlobalIndexer> & indexer,
   // grab map from evaluated names to field names
   fieldMap_ = p.get< Teuchos::RCP< std::map<std::string,std::string> > >("Dependent Map");
 
-  Teuchos::RCP<PHX::DataLayout> dl =
-    p.get< Teuchos::RCP<const panzer::PureBasis> >("Basis")->functional;
+  Teuchos::RCP<const panzer::PureBasis> basis =
+    p.get< Teuchos::RCP<const panzer::PureBasis> >("Basis");
+  Teuchos::RCP<PHX::DataLayout> dl = basis->functional;
+
+  // element matrices of the linear terms and the field of their columns, keyed by the scattered field name
+  typedef Teuchos::RCP<const std::map<std::string,std::vector<std::pair<std::string,std::string> > > > LinearMatrixMap;
+  LinearMatrixMap linearMatrices;
+  if (p.isType<LinearMatrixMap>("Linear Element Matrices"))
+    linearMatrices = p.get<LinearMatrixMap>("Linear Element Matrices");
 
   // build the vector of fields that this is dependent on
   scatterFields_.resize(names.size());
   scratch_offsets_.resize(names.size());
+  linearMatrices_.resize(names.size());
+  linearColumnFields_.resize(names.size());
   for (std::size_t eq = 0; eq < names.size(); ++eq) {
     scatterFields_[eq] = PHX::MDField<const ScalarT,Cell,NODE>(names[eq],dl);
 
     // tell the field manager that we depend on this field
     this->addDependentField(scatterFields_[eq]);
+
+    if (linearMatrices==Teuchos::null)
+      continue;
+
+    auto itr = linearMatrices->find(names[eq]);
+    if (itr==linearMatrices->end())
+      continue;
+
+    for (const auto & matrix : itr->second) {
+      linearMatrices_[eq].push_back(PHX::MDField<const double,Cell,BASIS,BASIS>(matrix.first,linearElementMatrixLayout(*basis)));
+      linearColumnFields_[eq].push_back(matrix.second);
+      this->addDependentField(linearMatrices_[eq].back());
+    }
   }
 
   // this is what this evaluator provides
@@ -312,6 +403,9 @@ ScatterResidual_Tpetra(const Teuchos::RCP<const GlobalIndexer> & indexer,
   if (p.isType<std::string>("Global Data Key"))
      globalDataKey_ = p.get<std::string>("Global Data Key");
 
+  if (p.isType<bool>("Precompute Jacobian Offsets"))
+     precomputeOffsets_ = p.get<bool>("Precompute Jacobian Offsets");
+
   this->setName(scatterName+" Scatter Residual (Jacobian)");
 }
 
@@ -338,6 +432,20 @@ postRegistrationSetup(typename TRAITS::SetupData d,
     Kokkos::deep_copy(scratch_offsets_[fd], Kokkos::View<const int*, Kokkos::HostSpace, Kokkos::MemoryUnmanaged>(offsets.data(), offsets.size()));
   }
 
+  // the columns of an element matrix are the DOFs of its column field
+  linearColumnOffsets_.resize(scatterFields_.size());
+  for(std::size_t fd=0;fd<scatterFields_.size();++fd) {
+    linearColumnOffsets_[fd].clear();
+    for(const auto & columnField : linearColumnFields_[fd]) {
+      const std::vector<int> & offsets = globalIndexer_->getGIDFieldOffsets(blockId,globalIndexer_->getFieldNum(columnField));
+      TEUCHOS_TEST_FOR_EXCEPTION(offsets.size()!=scratch_offsets_[fd].extent(0),std::logic_error,
+                                 "ScatterResidual_Tpetra: the column field \"" << columnField << "\" of a linear element matrix "
+                                 "of \"" << scatterFields_[fd].fieldTag().name() << "\" is not on the basis of the scattered field.");
+      linearColumnOffsets_[fd].push_back(PHX::View<int*>("column offsets",offsets.size()));
+      Kokkos::deep_copy(linearColumnOffsets_[fd].back(), Kokkos::View<const int*, Kokkos::HostSpace, Kokkos::MemoryUnmanaged>(offsets.data(), offsets.size()));
+    }
+  }
+
   my_derivative_size_ = globalIndexer_->getElementBlockGIDCount(blockId);
   if (Teuchos::nonnull(workset_0.other)) {
     auto otherBlockId = workset_0.other->block_id;
@@ -347,6 +455,11 @@ postRegistrationSetup(typename TRAITS::SetupData d,
     "lids", scatterFields_[0].extent(0), my_derivative_size_ + other_derivative_size_ );
   scratch_vals_ = Kokkos::View<typename Sacado::ScalarType<ScalarT>::type**, Kokkos::LayoutRight, PHX::Device>(
     "vals", scatterFields_[0].extent(0), my_derivative_size_ + other_derivative_size_ );
+
+  // element matrices are square, their columns have as many DOFs as the rows
+  const int numBasis = scatterFields_[0].extent(1);
+  linear_lids_ = Kokkos::View<LO**, Kokkos::LayoutRight, PHX::Device>("linear_lids", scatterFields_[0].extent(0), numBasis);
+  linear_vals_ = Kokkos::View<double**, Kokkos::LayoutRight, PHX::Device>("linear_vals", scatterFields_[0].extent(0), numBasis);
 }
 
 // **********************************************************************
@@ -364,6 +477,22 @@ preEvaluate(typename TRAITS::PreEvalData d)
     Teuchos::RCP<LinearObjContainer> loc = Teuchos::rcp_dynamic_cast<LOCPair_GlobalEvaluationData>(d.gedc->getDataObject(globalDataKey_),true)->getGhostedLOC();
     tpetraContainer_ = Teuchos::rcp_dynamic_cast<LOC>(loc);
   }
+
+  diagonalContainer_ = Teuchos::null;
+  if(d.gedc->containsDataObject("Jacobian Diagonal Container")) {
+    Teuchos::RCP<LinearObjContainer> loc = Teuchos::rcp_dynamic_cast<LOCPair_GlobalEvaluationData>(d.gedc->getDataObject("Jacobian Diagonal Container"),true)->getGhostedLOC();
+    diagonalContainer_ = Teuchos::rcp_dynamic_cast<LOC>(loc,true);
+  }
+
+  rowSumContainer_ = Teuchos::null;
+  if(d.gedc->containsDataObject("Jacobian Row Sum Container")) {
+    Teuchos::RCP<LinearObjContainer> loc = Teuchos::rcp_dynamic_cast<LOCPair_GlobalEvaluationData>(d.gedc->getDataObject("Jacobian Row Sum Container"),true)->getGhostedLOC();
+    rowSumContainer_ = Teuchos::rcp_dynamic_cast<LOC>(loc,true);
+  }
+
+  elementMatrices_ = Teuchos::null;
+  if(d.gedc->containsDataObject("Element Jacobian Container"))
+    elementMatrices_ = Teuchos::rcp_dynamic_cast<ElementMatrices_GlobalEvaluationData>(d.gedc->getDataObject("Element Jacobian Container"),true);
 }
 
 
@@ -412,6 +541,250 @@ public:
   }
 };
 
+template <typename ScalarT,typename LO,typename GO,typename NodeT,typename LocalMatrixT>
+class ScatterResidual_JacobianOffsets_Functor {
+public:
+  typedef typename PHX::Device execution_space;
+  typedef PHX::MDField<const ScalarT,Cell,NODE> FieldType;
+
+  bool fillResidual;
+  Kokkos::View<double**, Kokkos::LayoutLeft,PHX::Device> r_data;
+  typename LocalMatrixT::values_type values; // Kokkos jacobian values
+
+  Kokkos::View<const LO**, Kokkos::LayoutRight, PHX::Device> lids; // local indices for unknowns.
+  ElementCrsOffsets::OffsetView crsOffsets; // where the element matrix lives in values
+  PHX::View<const int*> offsets; // how to get a particular field
+  FieldType field;
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const unsigned int cell) const
+  {
+    int numIds = crsOffsets.extent(2);
+
+    // loop over the basis functions (currently they are nodes)
+    for(std::size_t basis=0; basis < offsets.extent(0); basis++) {
+       typename FieldType::array_type::reference_type scatterField = field(cell,basis);
+       int offset = offsets(basis);
+
+       // Sum residual
+       if(fillResidual)
+         Kokkos::atomic_add(&r_data(lids(cell,offset),0), scatterField.val());
+
+       // Sum Jacobian, entries missing from the graph are dropped
+       for(int sensIndex=0;sensIndex<numIds;++sensIndex) {
+          const std::size_t k = crsOffsets(cell,offset,sensIndex);
+          if(k!=ElementCrsOffsets::invalid())
+            Kokkos::atomic_add(&values(k), scatterField.fastAccessDx(sensIndex));
+       }
+    } // end basis
+  }
+};
+
+template <typename ScalarT,typename LO,typename GO,typename NodeT>
+class ScatterResidual_JacobianDiagonal_Functor {
+public:
+  typedef typename PHX::Device execution_space;
+  typedef PHX::MDField<const ScalarT,Cell,NODE> FieldType;
+
+  Kokkos::View<double**, Kokkos::LayoutLeft,PHX::Device> d_data;
+
+  Kokkos::View<const LO**, Kokkos::LayoutRight, PHX::Device> lids; // local indices for unknowns.
+  PHX::View<const int*> offsets; // how to get a particular field
+  FieldType field;
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const unsigned int cell) const
+  {
+    // the derivative index of a DOF is its offset in the element
+    for(std::size_t basis=0; basis < offsets.extent(0); basis++) {
+       int offset = offsets(basis);
+       LO lid    = lids(cell,offset);
+       Kokkos::atomic_add(&d_data(lid,0), field(cell,basis).fastAccessDx(offset));
+    }
+  }
+};
+
+template <typename ScalarT,typename LO,typename GO,typename NodeT>
+class ScatterResidual_JacobianRowSum_Functor {
+public:
+  typedef typename PHX::Device execution_space;
+  typedef PHX::MDField<const ScalarT,Cell,NODE> FieldType;
+
+  Kokkos::View<double**, Kokkos::LayoutLeft,PHX::Device> d_data;
+
+  Kokkos::View<const LO**, Kokkos::LayoutRight, PHX::Device> lids; // local indices for unknowns.
+  PHX::View<const int*> offsets; // how to get a particular field
+  FieldType field;
+  int numIds; // derivatives of this cell, interface neighbors are left out
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const unsigned int cell) const
+  {
+    for(std::size_t basis=0; basis < offsets.extent(0); basis++) {
+       double sum = 0.0;
+       for(int sensIndex=0;sensIndex<numIds;++sensIndex)
+          sum += field(cell,basis).fastAccessDx(sensIndex);
+       Kokkos::atomic_add(&d_data(lids(cell,offsets(basis)),0), sum);
+    }
+  }
+};
+
+template <typename ScalarT,typename LO,typename GO,typename NodeT>
+class ScatterResidual_ElementMatrix_Functor {
+public:
+  typedef typename PHX::Device execution_space;
+  typedef PHX::MDField<const ScalarT,Cell,NODE> FieldType;
+
+  ElementMatrices_GlobalEvaluationData::MatrixView matrices;
+  Kokkos::View<const int*,PHX::Device> positions; // cell local id to position in the block
+  Kokkos::View<const int*> cellIds;
+  PHX::View<const int*> offsets; // how to get a particular field
+  FieldType field;
+  int numIds; // derivatives of this cell, interface neighbors are left out
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const unsigned int cell) const
+  {
+    // each cell owns its matrix and each field its rows, no atomics needed
+    const int position = positions(cellIds(cell));
+    for(std::size_t basis=0; basis < offsets.extent(0); basis++) {
+       const int row = offsets(basis);
+       for(int sensIndex=0;sensIndex<numIds;++sensIndex)
+          matrices(position,row,sensIndex) += field(cell,basis).fastAccessDx(sensIndex);
+    }
+  }
+};
+
+template <typename LO,typename GO,typename NodeT,typename LocalMatrixT>
+class ScatterResidual_LinearMatrix_Functor {
+public:
+  typedef typename PHX::Device execution_space;
+  typedef PHX::MDField<const double,Cell,BASIS,BASIS> MatrixType;
+
+  LocalMatrixT jac; // Kokkos jacobian type
+
+  Kokkos::View<const LO**, Kokkos::LayoutRight, PHX::Device> lids; // local indices for unknowns.
+  Kokkos::View<LO**, Kokkos::LayoutRight, PHX::Device> cols;
+  Kokkos::View<double**, Kokkos::LayoutRight, PHX::Device> vals;
+  PHX::View<const int*> offsets; // how to get a particular field
+  PHX::View<const int*> colOffsets; // how to get the column field
+  MatrixType matrix;
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const unsigned int cell) const
+  {
+    const int numBasis = offsets.extent(0);
+
+    for(int j=0; j < numBasis; j++)
+      cols(cell,j) = lids(cell,colOffsets(j));
+
+    for(int i=0; i < numBasis; i++) {
+      for(int j=0; j < numBasis; j++)
+        vals(cell,j) = matrix(cell,i,j);
+
+      jac.sumIntoValues(lids(cell,offsets(i)), &cols(cell,0), numBasis, &vals(cell,0), true, true);
+    }
+  }
+};
+
+template <typename LO,typename GO,typename NodeT,typename LocalMatrixT>
+class ScatterResidual_LinearMatrixOffsets_Functor {
+public:
+  typedef typename PHX::Device execution_space;
+  typedef PHX::MDField<const double,Cell,BASIS,BASIS> MatrixType;
+
+  typename LocalMatrixT::values_type values; // Kokkos jacobian values
+
+  ElementCrsOffsets::OffsetView crsOffsets; // where the element matrix lives in values
+  PHX::View<const int*> offsets; // how to get a particular field
+  PHX::View<const int*> colOffsets; // how to get the column field
+  MatrixType matrix;
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const unsigned int cell) const
+  {
+    const int numBasis = offsets.extent(0);
+
+    // entries missing from the graph are dropped
+    for(int i=0; i < numBasis; i++) {
+      for(int j=0; j < numBasis; j++) {
+        const std::size_t k = crsOffsets(cell,offsets(i),colOffsets(j));
+        if(k!=ElementCrsOffsets::invalid())
+          Kokkos::atomic_add(&values(k), matrix(cell,i,j));
+      }
+    }
+  }
+};
+
+template <typename LO,typename GO,typename NodeT>
+class ScatterResidual_LinearMatrixDiagonal_Functor {
+public:
+  typedef typename PHX::Device execution_space;
+  typedef PHX::MDField<const double,Cell,BASIS,BASIS> MatrixType;
+
+  Kokkos::View<double**, Kokkos::LayoutLeft,PHX::Device> d_data;
+
+  Kokkos::View<const LO**, Kokkos::LayoutRight, PHX::Device> lids; // local indices for unknowns.
+  PHX::View<const int*> offsets; // how to get a particular field
+  MatrixType matrix;
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const unsigned int cell) const
+  {
+    for(std::size_t basis=0; basis < offsets.extent(0); basis++)
+      Kokkos::atomic_add(&d_data(lids(cell,offsets(basis)),0), matrix(cell,basis,basis));
+  }
+};
+
+template <typename LO,typename GO,typename NodeT>
+class ScatterResidual_LinearMatrixRowSum_Functor {
+public:
+  typedef typename PHX::Device execution_space;
+  typedef PHX::MDField<const double,Cell,BASIS,BASIS> MatrixType;
+
+  Kokkos::View<double**, Kokkos::LayoutLeft,PHX::Device> d_data;
+
+  Kokkos::View<const LO**, Kokkos::LayoutRight, PHX::Device> lids; // local indices for unknowns.
+  PHX::View<const int*> offsets; // how to get a particular field
+  MatrixType matrix;
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const unsigned int cell) const
+  {
+    const int numBasis = offsets.extent(0);
+    for(int i=0; i < numBasis; i++) {
+      double sum = 0.0;
+      for(int j=0; j < numBasis; j++)
+        sum += matrix(cell,i,j);
+      Kokkos::atomic_add(&d_data(lids(cell,offsets(i)),0), sum);
+    }
+  }
+};
+
+template <typename LO,typename GO,typename NodeT>
+class ScatterResidual_LinearElementMatrix_Functor {
+public:
+  typedef typename PHX::Device execution_space;
+  typedef PHX::MDField<const double,Cell,BASIS,BASIS> MatrixType;
+
+  ElementMatrices_GlobalEvaluationData::MatrixView matrices;
+  Kokkos::View<const int*,PHX::Device> positions; // cell local id to position in the block
+  Kokkos::View<const int*> cellIds;
+  PHX::View<const int*> offsets; // how to get a particular field
+  PHX::View<const int*> colOffsets; // how to get the column field
+  MatrixType matrix;
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const unsigned int cell) const
+  {
+    const int position = positions(cellIds(cell));
+    const int numBasis = offsets.extent(0);
+    for(int i=0; i < numBasis; i++)
+      for(int j=0; j < numBasis; j++)
+        matrices(position,offsets(i),colOffsets(j)) += matrix(cell,i,j);
+  }
+};
+
 template <typename ScalarT,typename LO,typename GO,typename NodeT>
 class ScatterResidual_Residual_Functor {
 public:
@@ -497,6 +870,143 @@ evaluateFields(typename TRAITS::EvalData workset)
      globalIndexer_->getElementLIDs(this->wda(workset).cell_local_ids_k,scratch_lids_);
    }
 
+   // diagonal extraction never touches the matrix
+   if(diagonalContainer_!=Teuchos::null) {
+     ScatterResidual_JacobianDiagonal_Functor<ScalarT,LO,GO,NodeT> functor;
+     functor.d_data = diagonalContainer_->get_f()->getLocalViewDevice(Tpetra::Access::ReadWrite);
+     functor.lids = scratch_lids_;
+
+     for(std::size_t fieldIndex = 0; fieldIndex < scatterFields_.size(); fieldIndex++) {
+       functor.offsets = scratch_offsets_[fieldIndex];
+       functor.field = scatterFields_[fieldIndex];
+
+       Kokkos::parallel_for(workset.num_cells,functor);
+     }
+
+     ScatterResidual_LinearMatrixDiagonal_Functor<LO,GO,NodeT> linearFunctor;
+     linearFunctor.d_data = functor.d_data;
+     linearFunctor.lids = scratch_lids_;
+
+     // a matrix coupling to another field has no diagonal entries
+     for(std::size_t fieldIndex = 0; fieldIndex < scatterFields_.size(); fieldIndex++) {
+       const std::string & fieldName = fieldMap_->find(scatterFields_[fieldIndex].fieldTag().name())->second;
+       linearFunctor.offsets = scratch_offsets_[fieldIndex];
+       for(std::size_t m = 0; m < linearMatrices_[fieldIndex].size(); m++) {
+         if(linearColumnFields_[fieldIndex][m]!=fieldName)
+           continue;
+         linearFunctor.matrix = linearMatrices_[fieldIndex][m];
+
+         Kokkos::parallel_for(workset.num_cells,linearFunctor);
+       }
+     }
+     return;
+   }
+
+   // row sums (a lumped Jacobian) never touch the matrix either
+   if(rowSumContainer_!=Teuchos::null) {
+     ScatterResidual_JacobianRowSum_Functor<ScalarT,LO,GO,NodeT> functor;
+     functor.d_data = rowSumContainer_->get_f()->getLocalViewDevice(Tpetra::Access::ReadWrite);
+     functor.lids = scratch_lids_;
+     functor.numIds = my_derivative_size_;
+
+     for(std::size_t fieldIndex = 0; fieldIndex < scatterFields_.size(); fieldIndex++) {
+       functor.offsets = scratch_offsets_[fieldIndex];
+       functor.field = scatterFields_[fieldIndex];
+
+       Kokkos::parallel_for(workset.num_cells,functor);
+     }
+
+     ScatterResidual_LinearMatrixRowSum_Functor<LO,GO,NodeT> linearFunctor;
+     linearFunctor.d_data = functor.d_data;
+     linearFunctor.lids = scratch_lids_;
+
+     for(std::size_t fieldIndex = 0; fieldIndex < scatterFields_.size(); fieldIndex++) {
+       linearFunctor.offsets = scratch_offsets_[fieldIndex];
+       for(const auto & matrix : linearMatrices_[fieldIndex]) {
+         linearFunctor.matrix = matrix;
+
+         Kokkos::parallel_for(workset.num_cells,linearFunctor);
+       }
+     }
+     return;
+   }
+
+   // element Jacobians are kept per cell for element local inverses
+   if(elementMatrices_!=Teuchos::null) {
+     ScatterResidual_ElementMatrix_Functor<ScalarT,LO,GO,NodeT> functor;
+     functor.matrices = elementMatrices_->getMatrices(blockId);
+     functor.positions = elementMatrices_->getCellPositions();
+     functor.cellIds = this->wda(workset).cell_local_ids_k;
+     functor.numIds = my_derivative_size_;
+
+     for(std::size_t fieldIndex = 0; fieldIndex < scatterFields_.size(); fieldIndex++) {
+       functor.offsets = scratch_offsets_[fieldIndex];
+       functor.field = scatterFields_[fieldIndex];
+
+       Kokkos::parallel_for(workset.num_cells,functor);
+     }
+
+     ScatterResidual_LinearElementMatrix_Functor<LO,GO,NodeT> linearFunctor;
+     linearFunctor.matrices = functor.matrices;
+     linearFunctor.positions = functor.positions;
+     linearFunctor.cellIds = functor.cellIds;
+
+     for(std::size_t fieldIndex = 0; fieldIndex < scatterFields_.size(); fieldIndex++) {
+       linearFunctor.offsets = scratch_offsets_[fieldIndex];
+       for(std::size_t m = 0; m < linearMatrices_[fieldIndex].size(); m++) {
+         linearFunctor.colOffsets = linearColumnOffsets_[fieldIndex][m];
+         linearFunctor.matrix = linearMatrices_[fieldIndex][m];
+
+         Kokkos::parallel_for(workset.num_cells,linearFunctor);
+       }
+     }
+     return;
+   }
+
+   // the fills above are the only ones a container without a matrix supports
+   TEUCHOS_TEST_FOR_EXCEPTION(Jac==Teuchos::null,std::logic_error,
+                              "ScatterResidual_Tpetra<Jacobian>: the ghosted container carries no matrix, only the "
+                              "diagonal, row sum and element Jacobian fills can be evaluated without one");
+
+   if(precomputeOffsets_) {
+     ScatterResidual_JacobianOffsets_Functor<ScalarT,LO,GO,NodeT,LocalMatrixT> functor;
+     functor.fillResidual = (r!=Teuchos::null);
+     if(functor.fillResidual)
+       functor.r_data = r->getLocalViewDevice(Tpetra::Access::ReadWrite);
+
+     // rows belong to this cell, columns may span an interface neighbor
+     const LocalMatrixT jac = Jac->getLocalMatrixDevice();
+     const int numCols = my_derivative_size_ + other_derivative_size_;
+     if(!crsOffsets_.lookup(workset.getIdentifier(),workset.getVersion(),workset.num_cells,
+                            {Jac->getCrsGraph().get()},my_derivative_size_,numCols,functor.crsOffsets))
+       fillElementCrsOffsets(functor.crsOffsets,jac.graph,scratch_lids_,std::make_pair(0,my_derivative_size_),std::make_pair(0,numCols));
+
+     functor.values = jac.values;
+     functor.lids = scratch_lids_;
+
+     for(std::size_t fieldIndex = 0; fieldIndex < scatterFields_.size(); fieldIndex++) {
+       functor.offsets = scratch_offsets_[fieldIndex];
+       functor.field = scatterFields_[fieldIndex];
+
+       Kokkos::parallel_for(workset.num_cells,functor);
+     }
+
+     ScatterResidual_LinearMatrixOffsets_Functor<LO,GO,NodeT,LocalMatrixT> linearFunctor;
+     linearFunctor.values = jac.values;
+     linearFunctor.crsOffsets = functor.crsOffsets;
+
+     for(std::size_t fieldIndex = 0; fieldIndex < scatterFields_.size(); fieldIndex++) {
+       linearFunctor.offsets = scratch_offsets_[fieldIndex];
+       for(std::size_t m = 0; m < linearMatrices_[fieldIndex].size(); m++) {
+         linearFunctor.colOffsets = linearColumnOffsets_[fieldIndex][m];
+         linearFunctor.matrix = linearMatrices_[fieldIndex][m];
+
+         Kokkos::parallel_for(workset.num_cells,linearFunctor);
+       }
+     }
+     return;
+   }
+
    ScatterResidual_Jacobian_Functor<ScalarT,LO,GO,NodeT,LocalMatrixT> functor;
    functor.fillResidual = (r!=Teuchos::null);
    if(functor.fillResidual)
@@ -513,6 +1023,22 @@ evaluateFields(typename TRAITS::EvalData workset)
      Kokkos::parallel_for(workset.num_cells,functor);
    }
 
+   // add the element matrices of the linear terms
+   ScatterResidual_LinearMatrix_Functor<LO,GO,NodeT,LocalMatrixT> linearFunctor;
+   linearFunctor.jac = functor.jac;
+   linearFunctor.lids = scratch_lids_;
+   linearFunctor.cols = linear_lids_;
+   linearFunctor.vals = linear_vals_;
+
+   for(std::size_t fieldIndex = 0; fieldIndex < scatterFields_.size(); fieldIndex++) {
+     linearFunctor.offsets = scratch_offsets_[fieldIndex];
+     for(std::size_t m = 0; m < linearMatrices_[fieldIndex].size(); m++) {
+       linearFunctor.colOffsets = linearColumnOffsets_[fieldIndex][m];
+       linearFunctor.matrix = linearMatrices_[fieldIndex][m];
+
+       Kokkos::parallel_for(workset.num_cells,linearFunctor);
+     }
+   }
 }
 
 // **********************************************************************
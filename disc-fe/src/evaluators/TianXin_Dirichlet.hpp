@@ -74,7 +74,14 @@ class DirichletEvalautor<panzer::Traits::Jacobian,Traits>
 public:
   DirichletEvalautor(const Teuchos::ParameterList& p, const Teuchos::RCP<const TianXin::AbstractDiscretation>& mesh,
       const Teuchos::RCP<const panzer::GlobalIndexer> & indexer);
+  void preEvaluate(typename Traits::PreEvalData d);
   void evaluateFields(typename Traits::EvalData d);
+private:
+  // Jacobian diagonal or row sum extraction: constrained rows get the pivot
+  Teuchos::RCP<panzer::LinearObjContainer>  m_DiagonalContainer;
+  // element Jacobian extraction: constrained rows are skipped
+  bool                                      m_ElementMatrices = false;
+  TianXin::WorksetFunctor::ValueView        m_pivots;
 };
 
 // **************************************************************
@@ -86,7 +93,12 @@ class DirichletEvalautor<panzer::Traits::Tangent,Traits>
 public:
   DirichletEvalautor(const Teuchos::ParameterList& p, const Teuchos::RCP<const TianXin::AbstractDiscretation>& mesh,
       const Teuchos::RCP<const panzer::GlobalIndexer> & indexer);
+  void preEvaluate(typename Traits::PreEvalData d);
   void evaluateFields(typename Traits::EvalData d);
+private:
+  // matrix-free J*v: constrained rows of the product are v itself
+  Teuchos::RCP<panzer::LinearObjContainer>  m_DirectionContainer;
+  TianXin::WorksetFunctor::ValueView        m_zeros;
 };
 
 }
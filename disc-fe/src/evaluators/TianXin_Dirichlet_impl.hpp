@@ -39,6 +39,7 @@
 #define _TIANXIN_DIRICHLET_IMPL_HPP
 
 #include "Panzer_GlobalEvaluationDataContainer.hpp"
+#include "Panzer_LOCPair_GlobalEvaluationData.hpp"
 
 #include <set>
 #include <stdexcept>
@@ -70,11 +71,40 @@ template<typename Traits>
 DirichletEvalautor<panzer::Traits::Jacobian,Traits>::DirichletEvalautor(const Teuchos::ParameterList& params, const Teuchos::RCP<const TianXin::AbstractDiscretation>& mesh,
       const Teuchos::RCP<const panzer::GlobalIndexer> & indexer )
 : PointEvaluatorBase<panzer::Traits::Jacobian,Traits>(params, mesh, indexer )
-{}
+{
+	// the diagonal container's x is zero, so x-values leaves the pivot in f
+	double pivot = 1.0; //workset value
+	m_pivots = TianXin::WorksetFunctor::ValueView("DirichletEvalautor::pivots", this->m_ndofs);
+	Kokkos::deep_copy(m_pivots, -pivot);
+}
+
+template<typename Traits>
+void DirichletEvalautor<panzer::Traits::Jacobian, Traits> :: preEvaluate(typename Traits::PreEvalData d)
+{
+	PointEvaluatorBase<panzer::Traits::Jacobian,Traits>::preEvaluate(d);
+
+	m_DiagonalContainer = Teuchos::null;
+	if(d.gedc->containsDataObject("Jacobian Diagonal Container"))
+		m_DiagonalContainer = Teuchos::rcp_dynamic_cast<panzer::LOCPair_GlobalEvaluationData>(d.gedc->getDataObject("Jacobian Diagonal Container"),true)->getGhostedLOC();
+	// a constrained row sums to its pivot as well
+	else if(d.gedc->containsDataObject("Jacobian Row Sum Container"))
+		m_DiagonalContainer = Teuchos::rcp_dynamic_cast<panzer::LOCPair_GlobalEvaluationData>(d.gedc->getDataObject("Jacobian Row Sum Container"),true)->getGhostedLOC();
+
+	m_ElementMatrices = d.gedc->containsDataObject("Element Jacobian Container");
+}
 
 template<typename Traits>
 void DirichletEvalautor<panzer::Traits::Jacobian, Traits> :: evaluateFields(typename Traits::EvalData d)
 {
+	if( !m_DiagonalContainer.is_null() ) {
+		m_DiagonalContainer->evalDirichletResidual(this->m_local_dofs, m_pivots);
+		return;
+	}
+
+	// element local inverses leave strongly constrained rows alone
+	if( m_ElementMatrices )
+		return;
+
 	this->setValues(d);
 	double pivot = 1.0; //workset value
     this->m_GhostedContainer->applyDirichletBoundaryCondition(pivot, this->m_local_dofs, this->m_values);
@@ -88,11 +118,27 @@ template<typename Traits>
 DirichletEvalautor<panzer::Traits::Tangent,Traits>::DirichletEvalautor(const Teuchos::ParameterList& params, const Teuchos::RCP<const TianXin::AbstractDiscretation>& mesh,
       const Teuchos::RCP<const panzer::GlobalIndexer> & indexer )
 : PointEvaluatorBase<panzer::Traits::Tangent,Traits>(params, mesh, indexer )
-{}
+{
+	m_zeros = TianXin::WorksetFunctor::ValueView("DirichletEvalautor::zeros", this->m_ndofs);
+}
 
 template<typename Traits>
-void DirichletEvalautor<panzer::Traits::Tangent, Traits> :: evaluateFields(typename Traits::EvalData d)
-{}
+void DirichletEvalautor<panzer::Traits::Tangent, Traits> :: preEvaluate(typename Traits::PreEvalData d)
+{
+	PointEvaluatorBase<panzer::Traits::Tangent,Traits>::preEvaluate(d);
+
+	m_DirectionContainer = Teuchos::null;
+	if(d.gedc->containsDataObject("Directional Derivative Container"))
+		m_DirectionContainer = Teuchos::rcp_dynamic_cast<panzer::LOCPair_GlobalEvaluationData>(d.gedc->getDataObject("Directional Derivative Container"),true)->getGhostedLOC();
+}
+
+template<typename Traits>
+void DirichletEvalautor<panzer::Traits::Tangent, Traits> :: evaluateFields(typename Traits::EvalData /* d */)
+{
+	// the row of a constraint x-g is the identity, so (J*v) = v there
+	if( !m_DirectionContainer.is_null() )
+		m_DirectionContainer->evalDirichletResidual(this->m_local_dofs, m_zeros);
+}
 
 }
 
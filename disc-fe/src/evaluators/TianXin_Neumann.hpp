@@ -92,6 +92,8 @@ protected:
 	int quad_order, quad_index;
 	std::size_t num_cell, num_qp, num_dim;
 	PHX::MDField<ScalarT,panzer::Cell,panzer::Point,panzer::Dim> normals;
+	// functor values at the quadrature points, coordinate dependent functors only
+	Kokkos::View<double**, PHX::Device> point_values;
 	//Kokkos::DynRankView<ScalarT, PHX::Device> normal_lengths_buffer;
 	void calculateNormal(typename Traits::EvalData d);
 public:
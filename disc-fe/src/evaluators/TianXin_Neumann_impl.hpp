@@ -40,6 +40,7 @@
 
 #include <cstddef>
 #include <string>
+#include <utility>
 #include <vector>
 #include "Panzer_BasisIRLayout.hpp"
 #include "Panzer_Workset_Utilities.hpp"
@@ -108,6 +109,8 @@ postRegistrationSetup( typename Traits::SetupData sd,
   num_qp  = normals.extent(1);
   num_dim = normals.extent(2);
   quad_index =  panzer::getIntegrationRuleIndex(quad_order,(*sd.worksets_)[0]);
+  if( pFunc->dependsOnCoordinates() )
+    point_values = Kokkos::View<double**, PHX::Device>("Neumann::point_values", num_cell, num_qp);
 }
 
 //**********************************************************************
@@ -149,6 +152,24 @@ Flux<EvalT, Traits>::evaluateFields(typename Traits::EvalData workset)
 
   auto weighted_basis_scalar = workset.bases[this->basis_index]->weighted_basis_scalar.get_static_view();
   auto residual_v = this->residual.get_static_view();
+  if( this->pFunc->dependsOnCoordinates() ) {
+    // g(t,x,y,z): one batched evaluation at all quadrature points of the workset
+    const auto cells = std::make_pair(0, workset.num_cells);
+    auto ip_coordinates = workset.int_rules[this->quad_index]->getCubaturePoints().get_static_view();
+    WorksetFunctor::PointValueView values = Kokkos::subview(this->point_values, cells, Kokkos::ALL());
+    this->pFunc->evaluateAtPoints(workset,
+      Kokkos::subview(ip_coordinates, cells, Kokkos::ALL(), Kokkos::ALL()), values);
+    Kokkos::parallel_for("Neumann_Residual", workset.num_cells, KOKKOS_LAMBDA (const std::size_t cell) {
+      for (std::size_t basis = 0; basis < residual_v.extent(1); ++basis) {
+        residual_v(cell,basis) = 0.0;
+        for (std::size_t qp = 0; qp < values.extent(1); ++qp) {
+          residual_v(cell,basis) += values(cell,qp)*weighted_basis_scalar(cell,basis,qp);
+        }
+      }
+    });
+    return;
+  }
+
   const double val = (*(this->pFunc))(workset);
   Kokkos::parallel_for("Neumann_Residual", workset.num_cells, KOKKOS_LAMBDA (const std::size_t cell) {
     for (std::size_t basis = 0; basis < residual_v.extent(1); ++basis) {
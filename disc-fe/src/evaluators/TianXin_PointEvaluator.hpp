@@ -101,12 +101,18 @@ class PointEvaluatorBase : public PHX::EvaluatorWithBaseImpl<Traits>
 	std::unique_ptr<TianXin::WorksetFunctor> m_pFunctor;
 	//working variables
 	std::size_t m_ndofs;
-    Kokkos::View<panzer::LocalOrdinal*, Kokkos::HostSpace>   m_local_dofs;
+    TianXin::WorksetFunctor::DofView                          m_local_dofs;   // device resident
     Kokkos::View<panzer::GlobalOrdinal*, Kokkos::HostSpace>  m_global_dofs;
-	Kokkos::View<RealType*, Kokkos::HostSpace>               m_values;
+	TianXin::WorksetFunctor::ValueView                        m_values;       // device resident
+	TianXin::WorksetFunctor::CoordView                        m_coords;       // node coordinates of m_local_dofs, coordinate dependent values only
 	Teuchos::RCP<panzer::LinearObjContainer>  m_GhostedContainer; 
     //Teuchos::RCP<Xpetra::CrsMatrix<ScalarT, LO, GO, KokkosClassic::DefaultNode::DefaultNodeType> >  m_crsmatrix;
 	void setValues(const panzer::Workset&);
+
+  private:
+    // time at which m_values was last filled by a time-only functor
+    double m_values_time;
+    bool   m_values_valid;
 };
 
 }
@@ -108,105 +108,79 @@ PointEvaluatorBase<EvalT, Traits>::PointEvaluatorBase(const Teuchos::ParameterLi
 			mesh->getAllNodeSetIds(m_sideset_name,entities);
 		else
 			mesh->getAllNodeSetIds(m_sideset_name,eblock_name,entities);
-		
-		for(auto myname: m_dof_name) {
-			int fdnum = indexer->getFieldNum(myname);
-			for ( auto nd: entities ) {
-				auto b = indexer->getNodalLDofOfField( fdnum, nd );
-				if( b<0 ) std::cout << fdnum << ", " << nd <<std::endl;
-				TEUCHOS_TEST_FOR_EXCEPTION( (b<0), std::logic_error,
-				    "Error - Cannot find dof of Nodeset!" );
-				localIDs.insert(b);
-			}
-		}
 	} else if( m_sideset_rank==1 ) {
 		if( eblock_name.empty() )
 			mesh->getMyEdgeSetIds(m_sideset_name,entities);
 		else
 			mesh->getMyEdgeSetIds(m_sideset_name,eblock_name,entities);
-		for(auto myname: m_dof_name) {
-			int fdnum = indexer->getFieldNum(myname);
-			for ( auto nd: entities ) {
-				auto b = indexer->getEdgeLDofOfField( fdnum, nd );
-				if( b.empty() ) std::cout << fdnum << ", " << nd <<std::endl;
-				TEUCHOS_TEST_FOR_EXCEPTION( (b.empty()), std::logic_error,
-						"Error - Cannot find dof of Edgeset!" );
-				for( const auto ab: b )
-					localIDs.insert(ab);
-			}
-		}
 	} else if( m_sideset_rank==2 ) {
 		if( eblock_name.empty() )
 			mesh->getMyFaceSetIds(m_sideset_name,entities);
 		else
 			mesh->getMyFaceSetIds(m_sideset_name,eblock_name,entities);
-		for(auto myname: m_dof_name) {
-			int fdnum = indexer->getFieldNum(myname);
-			for ( auto nd: entities ) {
-				auto b = indexer->getFaceLDofOfField( fdnum, nd );
-				if( b.empty() ) std::cout << fdnum << ", " << nd <<std::endl;
-				TEUCHOS_TEST_FOR_EXCEPTION( (b.empty()), std::logic_error,
-						"Error - Cannot find dof of Edgeset!" );
-				for( const auto ab: b )
-					localIDs.insert(ab);
-			}
-		}
 	} else if( m_sideset_rank==-1 ) {
 		if( eblock_name.empty() )
 			mesh->getMySideSetIds(m_sideset_name,entities);
 		else
 			mesh->getMySideSetIds(m_sideset_name,eblock_name,entities);
-		auto dim = mesh->getDimension();
+	}
+
+	// sides are faces in 3D, edges in 2D and nodes in 1D
+	const int entity_rank = ( m_sideset_rank==-1 ) ? static_cast<int>(mesh->getDimension())-1 : m_sideset_rank;
+	// coordinate dependent values are evaluated at the nodes carrying the dofs
+	const bool needs_coords = m_pFunctor->dependsOnCoordinates();
+	TEUCHOS_TEST_FOR_EXCEPTION( needs_coords && entity_rank!=0, std::logic_error,
+		"Error - Value Type " << m_value_type << " depends on coordinates and needs a node set, " << m_sideset_name << " is not one!" );
+	std::map<panzer::LocalOrdinal,std::size_t> lid_to_node;
+	if( entity_rank>=0 && entity_rank<=2 ) {
+		std::vector<panzer::LocalOrdinal> lids;
 		for(auto myname: m_dof_name) {
 			int fdnum = indexer->getFieldNum(myname);
-			for ( auto nd: entities ) {
-				//std::cout << indexer->getComm()->getRank()<< "," << fdnum << ", " << nd << std::endl;
-				if( dim==3 ) {
-					std::vector<panzer::LocalOrdinal> vecb = indexer->getFaceLDofOfField( fdnum, nd );
-					if( vecb.empty() ) std::cout << "Error : Field " << myname << " of face " << nd <<std::endl;
-					TEUCHOS_TEST_FOR_EXCEPTION( (vecb.empty()), std::logic_error,
-						"Error - Cannot find dof of FaceSet!" );
-					for( const auto ab : vecb )
-						localIDs.insert(ab);	
-				}
-				else if( dim==2 ) {
-					std::vector<panzer::LocalOrdinal> vecb = indexer->getEdgeLDofOfField( fdnum, nd );
-					if( vecb.empty() ) std::cout << "Error : Field " << myname << " of edge " << nd <<std::endl;
-					TEUCHOS_TEST_FOR_EXCEPTION( (vecb.empty()), std::logic_error,
-						"Error - Cannot find dof of EdgeSet!" );
-					for( const auto ab : vecb )
-						localIDs.insert(ab);	
-				}
-				else if( dim==1 ) {
-					const auto b = indexer->getNodalLDofOfField( fdnum, nd );
-					if( b<0 ) std::cout << "Error : Field " << myname << " of node " << nd <<std::endl;
-					TEUCHOS_TEST_FOR_EXCEPTION( (b<0), std::logic_error,
-						"Error - Cannot find dof of NodeSet!" );
-					localIDs.insert(b);
+			const panzer::EntityDofIndex* index = indexer->getEntityDofIndex( fdnum, entity_rank );
+			TEUCHOS_TEST_FOR_EXCEPTION( (index==nullptr), std::logic_error,
+				"Error - Field " << myname << " has no dof on entities of set " << m_sideset_name << "!" );
+			// one batched lookup for the whole set, throws if an entity has no dof
+			index->getLIDs( entities, lids );
+			localIDs.insert( lids.begin(), lids.end() );
+			if( needs_coords ) {
+				for( const auto node: entities ) {
+					index->getLIDs( static_cast<panzer::GlobalOrdinal>(node), lids );
+					for( const auto lid: lids ) lid_to_node.emplace( lid, node );
 				}
 			}
 		}
 	}
 	m_ndofs = localIDs.size();
-	
-	// Create a view in the default execution space
-//	Kokkos::View<panzer::LocalOrdinal*,Kokkos::HostSpace> localIDs_k("Dirichelt::localIDs_",m_ndofs);
-	// Create a mirror of localIDs_k in host memory
+
+	// dofs and values live in device memory, they are consumed there by the linear object containers
 	std::string dof_label = p.name() + "::localIDs_";
-	m_local_dofs = Kokkos::View<panzer::LocalOrdinal*,Kokkos::HostSpace>(dof_label,m_ndofs);
+	m_local_dofs = TianXin::WorksetFunctor::DofView(dof_label,m_ndofs);
 	auto localIDs_h = Kokkos::create_mirror_view(m_local_dofs);
 	std::size_t nid=0;
 	for( const auto& lid: localIDs ) {
          localIDs_h(nid) = lid;
 		 ++nid;
     }
-	// Copy data from host to device if necessary
     Kokkos::deep_copy(m_local_dofs, localIDs_h);
-    // store in Kokkos type
-    //m_local_dofs = localIDs_k;
+
+	if( needs_coords ) {
+		const int dim = static_cast<int>(mesh->getDimension());
+		Kokkos::View<double**, PHX::Device> coords(p.name() + "::coordinates_", m_ndofs, dim);
+		auto coords_h = Kokkos::create_mirror_view(coords);
+		nid=0;
+		for( const auto& lid: localIDs ) {
+			const double* x = mesh->getNodeCoordinates( lid_to_node.at(lid) );
+			for( int d=0; d<dim; ++d ) coords_h(nid,d) = x[d];
+			++nid;
+		}
+		Kokkos::deep_copy(coords, coords_h);
+		m_coords = coords;
+	}
 
     std::string value_label = p.name() + "::Value_";
-	m_values = Kokkos::View<RealType*,Kokkos::HostSpace>(value_label,m_ndofs);
+	m_values = TianXin::WorksetFunctor::ValueView(value_label,m_ndofs);
+	m_values_time = 0.0;
+	m_values_valid = false;
 
     Teuchos::RCP<PHX::DataLayout> dummy = Teuchos::rcp(new PHX::MDALayout<void>(0));
     const PHX::Tag<ScalarT> fieldTag(eval_name, dummy);
@@ -218,15 +192,16 @@ PointEvaluatorBase<EvalT, Traits>::PointEvaluatorBase(const Teuchos::ParameterLi
 template<typename EvalT,typename Traits>
 void PointEvaluatorBase<EvalT, Traits> :: setValues(const panzer::Workset& wk)
 {
-    // Create a mirror of localIDs_k in host memory
-	auto value_h = Kokkos::create_mirror_view(m_values);
-	std::size_t nid=0;
-	for( std::size_t i=0; i<m_ndofs; ++i ) {
-	     value_h(nid) = (*m_pFunctor)(wk);
-		 ++nid;
-	}
-	// Copy data from host to device if necessary
-	Kokkos::deep_copy(m_values, value_h);
+	// time-only values are unchanged within one time step, e.g. over Newton iterations
+	if( m_values_valid && m_pFunctor->isTimeOnly() && wk.time==m_values_time )
+		return;
+
+	if( m_pFunctor->dependsOnCoordinates() )
+		m_pFunctor->evaluateAtNodes(wk, m_coords, m_values);
+	else
+		m_pFunctor->evaluate(wk, m_local_dofs, m_values);
+	m_values_time = wk.time;
+	m_values_valid = true;
 }
 
 template<typename EvalT,typename Traits>
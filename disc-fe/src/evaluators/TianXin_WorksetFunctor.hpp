@@ -38,23 +38,58 @@
 #ifndef _TIANXIN_WORKSET_FUNCTOR_HPP
 #define _TIANXIN_WORKSET_FUNCTOR_HPP
 
+#include "PanzerDiscFE_config.hpp"
 #include "Panzer_Workset.hpp"
+#include "Phalanx_KokkosDeviceTypes.hpp"
 #include <Teuchos_ParameterList.hpp>
 #include "TianXin_Factory.hpp"
+#ifdef PANZER_HAVE_EXPREVAL
+#include "Panzer_ExprProgram.hpp"
+#endif
 
 namespace TianXin {
 
 class WorksetFunctor
 {
   public:
+    typedef Kokkos::View<panzer::LocalOrdinal*, PHX::Device>  DofView;
+    typedef Kokkos::View<double*, PHX::Device>                ValueView;
+    typedef Kokkos::View<const double**, PHX::Device>         CoordView;       // (node,dim)
+    typedef Kokkos::View<const double***, Kokkos::LayoutStride, PHX::Device>  PointCoordView;  // (cell,point,dim)
+    typedef Kokkos::View<double**, Kokkos::LayoutStride, PHX::Device>         PointValueView;  // (cell,point)
+
     WorksetFunctor(const Teuchos::ParameterList& params ) {}
+    virtual ~WorksetFunctor() = default;
+
     virtual double operator()(const panzer::Workset&) = 0;
+
+    // Functor depends on time only, so its values may be kept across worksets
+    // of the same time. Functors opt in, otherwise they are evaluated every time.
+    virtual bool isTimeOnly() const
+    { return false; }
+
+    // Functor depends on coordinates, so it must be evaluated through
+    // evaluateAtNodes / evaluateAtPoints. Only coordinate functors opt in.
+    virtual bool dependsOnCoordinates() const
+    { return false; }
+
+    // Batched evaluation over a block of dofs. values(i) belongs to local_dofs(i).
+    // Default: operator() is evaluated once on host and broadcast on device.
+    virtual void evaluate(const panzer::Workset&, const DofView& local_dofs, const ValueView& values);
+
+    // Batched evaluation at nodes, values(i) belongs to the node at coords(i,:).
+    // Default: operator() is evaluated once on host and broadcast on device.
+    virtual void evaluateAtNodes(const panzer::Workset&, const CoordView& coords, const ValueView& values);
+
+    // Batched evaluation at the quadrature points of a workset, values(c,p) belongs to coords(c,p,:).
+    // Default: operator() is evaluated once on host and broadcast on device.
+    virtual void evaluateAtPoints(const panzer::Workset&, const PointCoordView& coords, const PointValueView& values);
 };
 
 typedef Factory<WorksetFunctor,std::string,Teuchos::ParameterList> WorksetFunctorFactory;
 
 #define REGISTER_WORKSET_FUNCTOR(CLASSNAME) \
-	static const auto CLASSNAME##register_result = WorksetFunctorFactory::Instance().Register<CLASSNAME>(#CLASSNAME); \
+	static const auto CLASSNAME##register_result = ::TianXin::WorksetFunctorFactory::Instance().Register<CLASSNAME>(#CLASSNAME);
 
 // **************************************************************
 // Constat function
@@ -66,6 +101,7 @@ class ConstantWorksetFunctor : public WorksetFunctor
   public:
     ConstantWorksetFunctor(const Teuchos::ParameterList& params );
     double operator()(const panzer::Workset&) final;
+    bool isTimeOnly() const final { return true; }
   private:
     double m_value;
 };
@@ -82,6 +118,7 @@ class LinearWorksetFunctor : public WorksetFunctor
   public:
     LinearWorksetFunctor(const Teuchos::ParameterList& params );
     double operator()(const panzer::Workset&) final;
+    bool isTimeOnly() const final { return true; }
   private:
     double m_elapse_time;
     double m_value;
@@ -100,6 +137,7 @@ class TimeTableFunctor : public WorksetFunctor
   public:
     TimeTableFunctor(const Teuchos::ParameterList& params );
     double operator()(const panzer::Workset&) final;
+    bool isTimeOnly() const final { return true; }
   private:
     std::vector<double> m_time;
     std::vector<double> m_value;
@@ -108,6 +146,8 @@ namespace FunctorRegister {
 	static bool const TimeTable_OK = WorksetFunctorFactory::Instance().template Register< TimeTableFunctor<double> >( "TimeTable");
 }
 
+#ifdef PANZER_HAVE_EXPREVAL
+
 // **************************************************************
 // Function of time expression
 // **************************************************************
@@ -118,23 +158,43 @@ class TimeExpressionFunctor : public WorksetFunctor
   public:
     TimeExpressionFunctor(const Teuchos::ParameterList& params );
     double operator()(const panzer::Workset&) final;
+    bool isTimeOnly() const final { return true; }
   private:
-    std::string expression{""};
+    // parsed once, evaluated on host at a single point
+    panzer::Expr::Program<double*, Kokkos::HostSpace>  m_program;
+    Kokkos::View<double*, Kokkos::HostSpace>           m_value;
 };
+namespace FunctorRegister {
+	static bool const TimeExpression_OK = WorksetFunctorFactory::Instance().template Register< TimeExpressionFunctor<double> >( "TimeExpression");
+}
 
 // **************************************************************
-// Function of coordinate expression
+// Function of coordinate expression, g(t,x,y,z)
 // **************************************************************
 
-/*template<typename EvalT>
-class CoordExpressionFunctor : public WorksetFunctor<EvalT>
+template<typename EvalT>
+class CoordExpressionFunctor : public WorksetFunctor
 {
   public:
     CoordExpressionFunctor(const Teuchos::ParameterList& params );
-    ScalarT operator(panzer::workset&) final;
+    double operator()(const panzer::Workset&) final;
+    bool isTimeOnly() const final;
+    bool dependsOnCoordinates() const final;
+    void evaluateAtNodes(const panzer::Workset&, const CoordView& coords, const ValueView& values) final;
+    void evaluateAtPoints(const panzer::Workset&, const PointCoordView& coords, const PointValueView& values) final;
   private:
-    std::string expression{""};
-};*/
+    // one parse, one program per evaluation shape, each a single kernel over all points
+    panzer::Expr::Bytecode                                               m_bytecode;
+    panzer::Expr::Program<double*, Kokkos::HostSpace>                    m_time_program;
+    panzer::Expr::Program<double*, Kokkos::LayoutStride, PHX::Device>    m_node_program;
+    panzer::Expr::Program<double**, Kokkos::LayoutStride, PHX::Device>   m_point_program;
+    Kokkos::View<double*, Kokkos::HostSpace>                             m_value;
+};
+namespace FunctorRegister {
+	static bool const CoordExpression_OK = WorksetFunctorFactory::Instance().template Register< CoordExpressionFunctor<double> >( "CoordExpression");
+}
+
+#endif // PANZER_HAVE_EXPREVAL
 
 /*template<typename EvalT>
 WorksetFunctor* createConstantFunctor(const Teuchos::ParameterList& params)             
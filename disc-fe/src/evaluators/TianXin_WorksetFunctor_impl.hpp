@@ -38,10 +38,34 @@
 #ifndef _TIANXIN_WORKSET_FUNCTOR_IMPL_HPP
 #define _TIANXIN_WORKSET_FUNCTOR_IMPL_HPP
 
-//#include <stk_expreval/Evaluator.hpp>
+#ifdef PANZER_HAVE_EXPREVAL
+#include "Panzer_ExprProgram_impl.hpp"
+#endif
 
 namespace TianXin {
 
+// **************************************************************
+// WorksetFunctor
+// **************************************************************
+inline void WorksetFunctor :: evaluate(const panzer::Workset& wk, const DofView& local_dofs, const ValueView& values)
+{
+	TEUCHOS_ASSERT(local_dofs.extent(0)==values.extent(0));
+	// operator() has no dof argument, so it has a single value per workset
+	Kokkos::deep_copy(values, (*this)(wk));
+}
+
+inline void WorksetFunctor :: evaluateAtNodes(const panzer::Workset& wk, const CoordView& coords, const ValueView& values)
+{
+	TEUCHOS_ASSERT(coords.extent(0)==values.extent(0));
+	Kokkos::deep_copy(values, (*this)(wk));
+}
+
+inline void WorksetFunctor :: evaluateAtPoints(const panzer::Workset& wk, const PointCoordView& coords, const PointValueView& values)
+{
+	TEUCHOS_ASSERT(coords.extent(0)==values.extent(0) && coords.extent(1)==values.extent(1));
+	Kokkos::deep_copy(values, (*this)(wk));
+}
+
 // **************************************************************
 // ConstantFunctor
 // **************************************************************
@@ -120,28 +144,103 @@ double TimeTableFunctor<EvalT> :: operator()(const panzer::Workset& wk)
     return val;
 }
 
+#ifdef PANZER_HAVE_EXPREVAL
+
 // **************************************************************
 // TimeExpressionFunctor
 // **************************************************************
 template<typename EvalT>
 TimeExpressionFunctor<EvalT>::TimeExpressionFunctor(const Teuchos::ParameterList& params )
 : WorksetFunctor(params)
+, m_program(params.sublist("TimeExpression").get<std::string>("Expression"), "TimeExpression")
+, m_value("TimeExpression::value", 1)
 {
-	const Teuchos::ParameterList& p = params.sublist("Constant"); 
-	expression = p.get<std::string>("Expression");
+	for( const auto& name: m_program.bytecode().variables )
+		TEUCHOS_TEST_FOR_EXCEPTION( name!="t", Teuchos::Exceptions::InvalidParameter,
+			"Error - TimeExpression may only depend on t, not on \"" << name << "\". Use CoordExpression instead!" );
 }
 
 template<typename EvalT>
 double TimeExpressionFunctor<EvalT> :: operator()(const panzer::Workset& wk)
 {
-/*	stk::expreval::Eval expr_eval(expression);
-    expr_eval.parse();
-	double curtime = wk.time;
-    expr_eval.bindVariable("t", curtime);
-    return expr_eval.evaluate();*/
-	return 0.0;
+	m_program.set("t", wk.time);
+	m_program.evaluate(m_value);
+	Kokkos::fence();
+	return m_value(0);
+}
+
+// **************************************************************
+// CoordExpressionFunctor
+// **************************************************************
+template<typename EvalT>
+CoordExpressionFunctor<EvalT>::CoordExpressionFunctor(const Teuchos::ParameterList& params )
+: WorksetFunctor(params)
+, m_bytecode(panzer::Expr::compile(params.sublist("CoordExpression").get<std::string>("Expression"), "CoordExpression"))
+, m_time_program(m_bytecode)
+, m_node_program(m_bytecode)
+, m_point_program(m_bytecode)
+, m_value("CoordExpression::value", 1)
+{
+	for( const auto& name: m_bytecode.variables )
+		TEUCHOS_TEST_FOR_EXCEPTION( name!="t" && name!="x" && name!="y" && name!="z", Teuchos::Exceptions::InvalidParameter,
+			"Error - CoordExpression may only depend on t, x, y and z, not on \"" << name << "\"!" );
 }
 
+template<typename EvalT>
+bool CoordExpressionFunctor<EvalT> :: isTimeOnly() const
+{
+	return !this->dependsOnCoordinates();
+}
+
+template<typename EvalT>
+bool CoordExpressionFunctor<EvalT> :: dependsOnCoordinates() const
+{
+	return m_time_program.has("x") || m_time_program.has("y") || m_time_program.has("z");
+}
+
+template<typename EvalT>
+double CoordExpressionFunctor<EvalT> :: operator()(const panzer::Workset& wk)
+{
+	TEUCHOS_TEST_FOR_EXCEPTION( this->dependsOnCoordinates(), std::logic_error,
+		"Error - CoordExpression depends on coordinates, it has no single value per workset!" );
+	m_time_program.set("t", wk.time);
+	m_time_program.evaluate(m_value);
+	Kokkos::fence();
+	return m_value(0);
+}
+
+template<typename EvalT>
+void CoordExpressionFunctor<EvalT> :: evaluateAtNodes(const panzer::Workset& wk, const CoordView& coords, const ValueView& values)
+{
+	TEUCHOS_ASSERT(coords.extent(0)==values.extent(0));
+	static const char* const names[3] = {"x", "y", "z"};
+	for( int d=0; d<3; ++d ) {
+		if( d<static_cast<int>(coords.extent(1)) )
+			m_node_program.set(names[d], Kokkos::subview(coords, Kokkos::ALL(), d));
+		else
+			m_node_program.set(names[d], 0.0);
+	}
+	m_node_program.set("t", wk.time);
+	m_node_program.evaluate(values);
+}
+
+template<typename EvalT>
+void CoordExpressionFunctor<EvalT> :: evaluateAtPoints(const panzer::Workset& wk, const PointCoordView& coords, const PointValueView& values)
+{
+	TEUCHOS_ASSERT(coords.extent(0)==values.extent(0) && coords.extent(1)==values.extent(1));
+	static const char* const names[3] = {"x", "y", "z"};
+	for( int d=0; d<3; ++d ) {
+		if( d<static_cast<int>(coords.extent(2)) )
+			m_point_program.set(names[d], Kokkos::subview(coords, Kokkos::ALL(), Kokkos::ALL(), d));
+		else
+			m_point_program.set(names[d], 0.0);
+	}
+	m_point_program.set("t", wk.time);
+	m_point_program.evaluate(values);
+}
+
+#endif // PANZER_HAVE_EXPREVAL
+
 }
 
 #endif
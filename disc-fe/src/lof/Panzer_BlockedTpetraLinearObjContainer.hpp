@@ -127,31 +127,51 @@ public:
    void beginFill();
    void endFill();
    
+   using LinearObjContainer::evalDirichletResidual;
+   using LinearObjContainer::applyDirichletBoundaryCondition;
+   using LinearObjContainer::applyConcentratedLoad;
+
+   /** Local dofs are numbered block after block, i.e. the local dof of block <code>b</code> is
+     * offset by the number of local entries of the maps of the preceding blocks.
+     */
    void applyDirichletBoundaryCondition( const std::map< panzer::LocalOrdinal, double >& indx ) override;
    void applyDirichletBoundaryCondition( const double&, const std::map< panzer::LocalOrdinal, double >& indx ) override;
    void applyDirichletBoundaryCondition( const double p, const Kokkos::View<panzer::LocalOrdinal*, Kokkos::HostSpace>& local_dofs,
-		Kokkos::View<double*, Kokkos::HostSpace>& values) final {;}
-   void evalDirichletResidual( const std::map< panzer::LocalOrdinal, double >& indx ) override {;}
+		Kokkos::View<double*, Kokkos::HostSpace>& values) final;
+   /** Apply Dirichlet values to matrix and residual in one pass over the local CRS storage of the blocks.
+     * The residual of the constrained rows is set to x-values; with RowAndColumn it is lifted
+     * into the free rows, f -= A(:,bc)*(x-values)(bc), before the columns are cleared.
+     */
+   void applyDirichletBoundaryCondition( const DirichletMode mode, const double p,
+		const Kokkos::View<panzer::LocalOrdinal*, PHX::Device>& local_dofs,
+		Kokkos::View<double*, PHX::Device>& values);
+   void evalDirichletResidual( const std::map< panzer::LocalOrdinal, double >& indx ) override;
    void evalDirichletResidual( const Kokkos::View<panzer::LocalOrdinal*, Kokkos::HostSpace>& local_dofs,
-		Kokkos::View<double*, Kokkos::HostSpace>& values) final
-   {
-      TEUCHOS_ASSERT(false); // not yet implemented
-   }
-   void applyConcentratedLoad( const std::map< panzer::LocalOrdinal, double >& indx ) override
-   {
-      TEUCHOS_ASSERT(false); // not yet implemented
-   }
+		Kokkos::View<double*, Kokkos::HostSpace>& values) final;
+   void applyConcentratedLoad( const std::map< panzer::LocalOrdinal, double >& indx ) override;
    void applyConcentratedLoad( Kokkos::View<panzer::LocalOrdinal*, Kokkos::HostSpace>& local_dofs,
-		Kokkos::View<double*, Kokkos::HostSpace>& values ) final
-   {
-      TEUCHOS_ASSERT(false); // not yet implemented
-   }
+		Kokkos::View<double*, Kokkos::HostSpace>& values ) final;
    void writeMatrixMarket(const std::string& filename) const override
    {
 	//   Tpetra::MatrixMarket::Writer<CrsMatrixType>::writeSparseFile(filename, *A);
    }
 
 private:
+   //! Block local (dof, value) pairs of every block
+   typedef std::vector<std::vector<std::pair<LocalOrdinalT,ScalarT> > > BlockDofs;
+
+   //! Split flat local dofs into block local dofs
+   void splitBlockDofs(const std::vector<std::pair<LocalOrdinalT,ScalarT> > & dofs,BlockDofs & blockDofs) const;
+
+   //! f = x - values on the constrained rows of each block
+   void evalBlockResidual(const BlockDofs & blockDofs);
+
+   /** Dirichlet elimination on the local CRS storage of the blocks. The matrix only overloads keep
+     * the residual untouched, <code>evalResidual</code> sets it to x-values on the constrained
+     * rows and lifts it into the free rows for RowAndColumn.
+     */
+   void applyDirichletToBlocks(const DirichletMode mode,const double p,const BlockDofs & blockDofs,const bool evalResidual);
+
    Teuchos::RCP<VectorType> x, dxdt, d2xdt2, f;
    Teuchos::RCP<CrsMatrixType> A;
 
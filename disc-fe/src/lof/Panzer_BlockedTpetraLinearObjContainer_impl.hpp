@@ -49,6 +49,10 @@
 
 #include "Tpetra_CrsMatrix.hpp"
 
+#include "Panzer_DirichletCrsKernel.hpp"
+
+#include <algorithm>
+
 namespace panzer {
 
 //! Make sure row and column spaces match up 
@@ -267,27 +271,251 @@ template <typename ScalarT,typename LocalOrdinalT,typename GlobalOrdinalT,typena
 void BlockedTpetraLinearObjContainer<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>::
 applyDirichletBoundaryCondition( const std::map< panzer::LocalOrdinal, double >& indx )
 {
-/*	using device_type = typename MapType::device_type;
-   using execution_space = typename MapType::execution_space;
-   using range_type = Kokkos::RangePolicy<execution_space, LocalOrdinalT>;
-	const LocalOrdinalT lclNumRows = indx.size();
-	Kokkos::View<typename MapType::local_ordinal_type*, device_type> lclRowInds("lclRowInds", lclNumRows);
-	Kokkos::parallel_for
-    ("Fill lclRowInds",
-      range_type (0, lclNumRows),
-      KOKKOS_LAMBDA (const LocalOrdinalT lclRow) {
-	    lclRowInds(lclRow) = indx[lclRow];
-      }
-    );
-	   
-	Tpetra::applyDirichletBoundaryConditionToLocalMatrixRows(*A, lclRowInds);*/
+   BlockDofs blockDofs;
+   splitBlockDofs(std::vector<std::pair<LocalOrdinalT,ScalarT> >(indx.begin(),indx.end()),blockDofs);
+   applyDirichletToBlocks(RowAndColumn,1.0,blockDofs,false);
 }
 	
 template <typename ScalarT,typename LocalOrdinalT,typename GlobalOrdinalT,typename NodeT>
 void BlockedTpetraLinearObjContainer<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>::
 applyDirichletBoundaryCondition( const double& p, const std::map< panzer::LocalOrdinal, double >& indx )
 {
+   BlockDofs blockDofs;
+   splitBlockDofs(std::vector<std::pair<LocalOrdinalT,ScalarT> >(indx.begin(),indx.end()),blockDofs);
+   applyDirichletToBlocks(RowAndColumn,p,blockDofs,false);
+}
+
+template <typename ScalarT,typename LocalOrdinalT,typename GlobalOrdinalT,typename NodeT>
+void BlockedTpetraLinearObjContainer<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>::
+applyDirichletBoundaryCondition( const double /* p */,
+                                 const Kokkos::View<panzer::LocalOrdinal*, Kokkos::HostSpace>& local_dofs,
+                                 Kokkos::View<double*, Kokkos::HostSpace>& values)
+{
+   std::vector<std::pair<LocalOrdinalT,ScalarT> > dofs(local_dofs.extent(0));
+   for(std::size_t i=0;i<dofs.size();i++)
+      dofs[i] = std::make_pair(local_dofs(i),values(i));
+
+   BlockDofs blockDofs;
+   splitBlockDofs(dofs,blockDofs);
+   // for eigen , need extent to consider K-pivot
+   applyDirichletToBlocks((get_f()==Teuchos::null) ? RowAndColumn : RowOnly,1.0,blockDofs,true);
+}
+
+template <typename ScalarT,typename LocalOrdinalT,typename GlobalOrdinalT,typename NodeT>
+void BlockedTpetraLinearObjContainer<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>::
+applyDirichletBoundaryCondition( const DirichletMode mode, const double p,
+                                 const Kokkos::View<panzer::LocalOrdinal*, PHX::Device>& local_dofs,
+                                 Kokkos::View<double*, PHX::Device>& values)
+{
+   auto local_dofs_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), local_dofs);
+   auto values_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), values);
+   std::vector<std::pair<LocalOrdinalT,ScalarT> > dofs(local_dofs_h.extent(0));
+   for(std::size_t i=0;i<dofs.size();i++)
+      dofs[i] = std::make_pair(local_dofs_h(i),values_h(i));
+
+   BlockDofs blockDofs;
+   splitBlockDofs(dofs,blockDofs);
+   applyDirichletToBlocks(mode,p,blockDofs,true);
+}
+
+template <typename ScalarT,typename LocalOrdinalT,typename GlobalOrdinalT,typename NodeT>
+void BlockedTpetraLinearObjContainer<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>::
+evalDirichletResidual( const std::map< panzer::LocalOrdinal, double >& indx )
+{
+   BlockDofs blockDofs;
+   splitBlockDofs(std::vector<std::pair<LocalOrdinalT,ScalarT> >(indx.begin(),indx.end()),blockDofs);
+   evalBlockResidual(blockDofs);
+}
+
+template <typename ScalarT,typename LocalOrdinalT,typename GlobalOrdinalT,typename NodeT>
+void BlockedTpetraLinearObjContainer<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>::
+evalDirichletResidual( const Kokkos::View<panzer::LocalOrdinal*, Kokkos::HostSpace>& local_dofs,
+                       Kokkos::View<double*, Kokkos::HostSpace>& values)
+{
+   std::vector<std::pair<LocalOrdinalT,ScalarT> > dofs(local_dofs.extent(0));
+   for(std::size_t i=0;i<dofs.size();i++)
+      dofs[i] = std::make_pair(local_dofs(i),values(i));
+
+   BlockDofs blockDofs;
+   splitBlockDofs(dofs,blockDofs);
+   evalBlockResidual(blockDofs);
+}
+
+template <typename ScalarT,typename LocalOrdinalT,typename GlobalOrdinalT,typename NodeT>
+void BlockedTpetraLinearObjContainer<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>::
+applyConcentratedLoad( const std::map< panzer::LocalOrdinal, double >& indx )
+{
+   std::vector<std::pair<LocalOrdinalT,ScalarT> > dofs(indx.begin(),indx.end());
+   Kokkos::View<panzer::LocalOrdinal*, Kokkos::HostSpace> local_dofs("local_dofs",dofs.size());
+   Kokkos::View<double*, Kokkos::HostSpace> values("values",dofs.size());
+   for(std::size_t i=0;i<dofs.size();i++) {
+      local_dofs(i) = dofs[i].first;
+      values(i) = dofs[i].second;
+   }
+   applyConcentratedLoad(local_dofs,values);
 }
 
+template <typename ScalarT,typename LocalOrdinalT,typename GlobalOrdinalT,typename NodeT>
+void BlockedTpetraLinearObjContainer<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>::
+applyConcentratedLoad( Kokkos::View<panzer::LocalOrdinal*, Kokkos::HostSpace>& local_dofs,
+                       Kokkos::View<double*, Kokkos::HostSpace>& values)
+{
+   typedef Tpetra::Vector<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT> TpetraVector;
+   typedef Thyra::TpetraOperatorVectorExtraction<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT> TOE;
+
+   std::vector<std::pair<LocalOrdinalT,ScalarT> > dofs(local_dofs.extent(0));
+   for(std::size_t i=0;i<dofs.size();i++)
+      dofs[i] = std::make_pair(local_dofs(i),values(i));
+
+   BlockDofs blockDofs;
+   splitBlockDofs(dofs,blockDofs);
+
+   Teuchos::RCP<Thyra::ProductVectorBase<ScalarT> > f_pv
+         = Teuchos::rcp_dynamic_cast<Thyra::ProductVectorBase<ScalarT> >(get_f(),true);
+   for(std::size_t b=0;b<blockDofs.size();b++) {
+      if(blockDofs[b].empty())
+         continue;
+      Teuchos::RCP<TpetraVector> f_b = TOE::getTpetraVector(f_pv->getNonconstVectorBlock(b));
+      auto f_h = f_b->getLocalViewHost(Tpetra::Access::ReadWrite);
+      for(const auto & dof : blockDofs[b])
+         f_h(dof.first,0) += dof.second;
+   }
+}
+
+template <typename ScalarT,typename LocalOrdinalT,typename GlobalOrdinalT,typename NodeT>
+void BlockedTpetraLinearObjContainer<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>::
+splitBlockDofs(const std::vector<std::pair<LocalOrdinalT,ScalarT> > & dofs,BlockDofs & blockDofs) const
+{
+   const std::size_t numBlocks = blockMaps_.size();
+
+   std::vector<LocalOrdinalT> offsets(numBlocks+1,0);
+   for(std::size_t b=0;b<numBlocks;b++)
+      offsets[b+1] = offsets[b] + blockMaps_[b]->getLocalNumElements();
+
+   blockDofs.clear();
+   blockDofs.resize(numBlocks);
+   for(const auto & dof : dofs) {
+      const std::size_t b = std::upper_bound(offsets.begin(),offsets.end(),dof.first)-offsets.begin()-1;
+      TEUCHOS_ASSERT(b<numBlocks);
+      blockDofs[b].push_back(std::make_pair(dof.first-offsets[b],dof.second));
+   }
+}
+
+template <typename ScalarT,typename LocalOrdinalT,typename GlobalOrdinalT,typename NodeT>
+void BlockedTpetraLinearObjContainer<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>::
+evalBlockResidual(const BlockDofs & blockDofs)
+{
+   typedef Tpetra::Vector<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT> TpetraVector;
+   typedef Thyra::TpetraOperatorVectorExtraction<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT> TOE;
+
+   Teuchos::RCP<Thyra::ProductVectorBase<ScalarT> > f_pv
+         = Teuchos::rcp_dynamic_cast<Thyra::ProductVectorBase<ScalarT> >(get_f(),true);
+   Teuchos::RCP<const Thyra::ProductVectorBase<ScalarT> > x_pv
+         = Teuchos::rcp_dynamic_cast<const Thyra::ProductVectorBase<ScalarT> >(get_x(),true);
+   for(std::size_t b=0;b<blockDofs.size();b++) {
+      if(blockDofs[b].empty())
+         continue;
+      Teuchos::RCP<TpetraVector> f_b = TOE::getTpetraVector(f_pv->getNonconstVectorBlock(b));
+      Teuchos::RCP<const TpetraVector> x_b = TOE::getConstTpetraVector(x_pv->getVectorBlock(b));
+      auto f_h = f_b->getLocalViewHost(Tpetra::Access::ReadWrite);
+      auto x_h = x_b->getLocalViewHost(Tpetra::Access::ReadOnly);
+      for(const auto & dof : blockDofs[b])
+         f_h(dof.first,0) = x_h(dof.first,0) - dof.second;
+   }
+}
+
+template <typename ScalarT,typename LocalOrdinalT,typename GlobalOrdinalT,typename NodeT>
+void BlockedTpetraLinearObjContainer<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>::
+applyDirichletToBlocks(const DirichletMode mode,const double p,const BlockDofs & blockDofs,const bool evalResidual)
+{
+   using Thyra::LinearOpBase;
+   using Thyra::PhysicallyBlockedLinearOpBase;
+   using Thyra::ProductVectorBase;
+   using Teuchos::RCP;
+   using Teuchos::rcp_dynamic_cast;
+
+   typedef Tpetra::CrsMatrix<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT> TpetraCrsMatrix;
+   typedef Tpetra::Vector<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT> TpetraVector;
+   typedef typename TpetraCrsMatrix::device_type device_type;
+   typedef typename TpetraCrsMatrix::execution_space execution_space;
+   typedef Thyra::TpetraOperatorVectorExtraction<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT> TOE;
+
+   const std::size_t numBlocks = blockMaps_.size();
+   const LocalOrdinalT invalid = Teuchos::OrdinalTraits<LocalOrdinalT>::invalid();
+
+   // residual of the constrained rows: f = x - values
+   const bool hasF = evalResidual && (get_f()!=Teuchos::null && get_x()!=Teuchos::null);
+   std::vector<RCP<TpetraVector> > f_blocks(numBlocks);
+   if(hasF) {
+      evalBlockResidual(blockDofs);
+      RCP<ProductVectorBase<ScalarT> > f_pv = rcp_dynamic_cast<ProductVectorBase<ScalarT> >(get_f(),true);
+      for(std::size_t b=0;b<numBlocks;b++)
+         f_blocks[b] = TOE::getTpetraVector(f_pv->getNonconstVectorBlock(b));
+   }
+
+   if(get_A()==Teuchos::null)
+      return;
+
+   RCP<PhysicallyBlockedLinearOpBase<ScalarT> > Amat
+         = rcp_dynamic_cast<PhysicallyBlockedLinearOpBase<ScalarT> >(get_A(),true);
+
+   // rows of block row i are constrained by the dofs of block i, columns of block column j by the dofs of block j
+   for(std::size_t i=0;i<numBlocks;i++) {
+      for(std::size_t j=0;j<numBlocks;j++) {
+         RCP<LinearOpBase<ScalarT> > block = Amat->getNonconstBlock(i,j);
+         if(block==Teuchos::null)
+            continue;
+         const bool doColumns = (mode==RowAndColumn && !blockDofs[j].empty());
+         if(blockDofs[i].empty() && !doColumns)
+            continue;
+
+         RCP<TpetraCrsMatrix> mat = rcp_dynamic_cast<TpetraCrsMatrix>(
+               rcp_dynamic_cast<Thyra::TpetraLinearOp<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT> >(block,true)->getTpetraOperator(),true);
+         RCP<const MapType> rowMap = mat->getRowMap();
+         RCP<const MapType> colMap = mat->getColMap();
+
+         Kokkos::View<LocalOrdinalT*, device_type> rowDiag("rowDiag", mat->getLocalNumRows());
+         Kokkos::View<int*, device_type> colMark("colMark", mat->getLocalNumCols());
+         Kokkos::View<ScalarT*, device_type> colLift("colLift", mat->getLocalNumCols());
+         auto rowDiag_h = Kokkos::create_mirror_view(rowDiag);
+         auto colMark_h = Kokkos::create_mirror_view(colMark);
+         auto colLift_h = Kokkos::create_mirror_view(colLift);
+         Kokkos::deep_copy(rowDiag_h,-2);
+         Kokkos::deep_copy(colMark_h,0);
+         Kokkos::deep_copy(colLift_h,0.0);
+
+         for(const auto & dof : blockDofs[i]) {
+            const GlobalOrdinalT gid = blockMaps_[i]->getGlobalElement(dof.first);
+            const LocalOrdinalT row = rowMap->getLocalElement(gid);
+            if(row==invalid)
+               continue;
+            const LocalOrdinalT diag = (i==j) ? colMap->getLocalElement(gid) : invalid;
+            rowDiag_h(row) = (diag==invalid) ? -1 : diag;
+         }
+         if(doColumns) {
+            typename TpetraVector::dual_view_type::t_host f_j;
+            if(hasF)
+               f_j = f_blocks[j]->getLocalViewHost(Tpetra::Access::ReadOnly);
+            for(const auto & dof : blockDofs[j]) {
+               const LocalOrdinalT col = colMap->getLocalElement(blockMaps_[j]->getGlobalElement(dof.first));
+               if(col==invalid)
+                  continue;
+               colMark_h(col) = 1;
+               colLift_h(col) = hasF ? f_j(dof.first,0) : 0.0;
+            }
+         }
+         Kokkos::deep_copy(rowDiag,rowDiag_h);
+         Kokkos::deep_copy(colMark,colMark_h);
+         Kokkos::deep_copy(colLift,colLift_h);
+
+         typename TpetraVector::dual_view_type::t_dev f_i;
+         if(hasF)
+            f_i = f_blocks[i]->getLocalViewDevice(Tpetra::Access::ReadWrite);
+         auto lclA = mat->getLocalMatrixDevice();
+         panzer::applyDirichletToLocalCrs<execution_space>(mode, p, lclA.graph.row_map, lclA.graph.entries, lclA.values,
+                                                           rowDiag, colMark, colLift, f_i, hasF, i==j);
+      }
+   }
+}
 
 }
@@ -0,0 +1,167 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+
+#ifndef __Panzer_DirichletCrsKernel_hpp__
+#define __Panzer_DirichletCrsKernel_hpp__
+
+#include "PanzerDiscFE_config.hpp"
+
+#include "Kokkos_Core.hpp"
+
+#include "Panzer_LinearObjContainer.hpp"
+
+namespace panzer {
+
+/** \brief Build the row and column markers of <code>applyDirichletToLocalCrs</code> from local dofs.
+  *
+  * The constrained dofs are local rows; their diagonal column is found through the global id,
+  * since row and column maps number the local entries differently (ghosted rows, off-process
+  * columns). A dof whose global id is not in the column map marks a row without a diagonal.
+  * The columns are lifted with the residual of their row, which must already hold x-values.
+  *
+  * \param[out] rowDiag  Sized to the local rows, overwritten.
+  * \param[out] colMark  Sized to the local columns, zero initialized.
+  * \param[out] colLift  Sized to the local columns.
+  */
+template <typename ExecSpace,typename DofView,typename RowMapType,typename ColMapType,
+          typename RowDiagView,typename ColMarkView,typename ColLiftView,typename ResidualView>
+void markDirichletDofs(const DofView & local_dofs,
+                       const RowMapType & rowMap,
+                       const ColMapType & colMap,
+                       const RowDiagView & rowDiag,
+                       const ColMarkView & colMark,
+                       const ColLiftView & colLift,
+                       const ResidualView & f,
+                       const bool hasF)
+{
+  typedef typename RowDiagView::non_const_value_type LO;
+  const LO invalid = -1;
+
+  Kokkos::deep_copy(rowDiag, -2);
+  const LO numDofs = local_dofs.extent(0);
+  Kokkos::parallel_for("panzer::markDirichletDofs",Kokkos::RangePolicy<ExecSpace,LO>(0,numDofs),
+                       KOKKOS_LAMBDA (const LO i) {
+    const LO row = local_dofs(i);
+    const LO col = colMap.getLocalElement(rowMap.getGlobalElement(row));
+    rowDiag(row) = (col==invalid) ? -1 : col;
+    if(col!=invalid) {
+      colMark(col) = 1;
+      colLift(col) = hasF ? f(row,0) : 0.0;
+    }
+  });
+}
+
+/** \brief Apply Dirichlet conditions directly on the local CRS arrays of a matrix (block).
+  *
+  * All rows are visited in a single parallel pass, each row by exactly one thread, so no
+  * atomics are needed:
+  *   - constrained rows (<code>rowDiag(r)!=-2</code>) get their off-diagonal entries zeroed and
+  *     their diagonal set to \c p (<code>RowOnly</code>, <code>RowAndColumn</code>), or only their
+  *     diagonal set to \c p and their residual scaled by \c p (<code>Penalty</code>).
+  *   - for <code>RowAndColumn</code> the free rows have every entry in a constrained column zeroed,
+  *     after lifting it into the residual: <code>f(r) -= A(r,c)*colLift(c)</code>.
+  *
+  * \param[in] rowDiag  Per local row: -2 for a free row, otherwise the local column of the
+  *                     diagonal entry, or -1 when this block holds no diagonal.
+  * \param[in] colMark  Per local column: nonzero for a constrained column.
+  * \param[in] colLift  Per local column: value lifted into the residual.
+  * \param[in] f        Residual (rank 2, first column used) of the row space, ignored if \c hasF is false.
+  * \param[in] scaleF   Scale the residual of constrained rows in penalty mode; set for one block per row only.
+  */
+template <typename ExecSpace,typename RowPtrView,typename EntriesView,typename ValuesView,
+          typename RowDiagView,typename ColMarkView,typename ColLiftView,typename ResidualView>
+void applyDirichletToLocalCrs(const LinearObjContainer::DirichletMode mode,
+                              const double p,
+                              const RowPtrView & rowptr,
+                              const EntriesView & entries,
+                              const ValuesView & vals,
+                              const RowDiagView & rowDiag,
+                              const ColMarkView & colMark,
+                              const ColLiftView & colLift,
+                              const ResidualView & f,
+                              const bool hasF,
+                              const bool scaleF)
+{
+  typedef typename EntriesView::non_const_value_type LO;
+  typedef typename ValuesView::non_const_value_type Scalar;
+
+  const LO numRows = rowDiag.extent(0);
+  if(numRows==0)
+    return;
+
+  Kokkos::parallel_for("panzer::applyDirichletToLocalCrs",Kokkos::RangePolicy<ExecSpace,LO>(0,numRows),
+                       KOKKOS_LAMBDA (const LO row) {
+    const LO diag = rowDiag(row);
+    if(diag!=-2) {
+      if(mode==LinearObjContainer::Penalty) {
+        if(diag>=0) {
+          for(auto k=rowptr(row);k<rowptr(row+1);++k)
+            if(entries(k)==diag)
+              vals(k) = p;
+        }
+        if(hasF && scaleF)
+          f(row,0) *= p;
+      }
+      else {
+        for(auto k=rowptr(row);k<rowptr(row+1);++k)
+          vals(k) = (entries(k)==diag) ? Scalar(p) : Scalar(0.0);
+      }
+    }
+    else if(mode==LinearObjContainer::RowAndColumn) {
+      Scalar lift = 0.0;
+      for(auto k=rowptr(row);k<rowptr(row+1);++k) {
+        const LO col = entries(k);
+        if(colMark(col)) {
+          lift += vals(k)*colLift(col);
+          vals(k) = 0.0;
+        }
+      }
+      if(hasF)
+        f(row,0) -= lift;
+    }
+  });
+}
+
+}
+
+#endif
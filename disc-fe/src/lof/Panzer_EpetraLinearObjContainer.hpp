@@ -55,6 +55,7 @@
 
 #include "Panzer_LinearObjFactory.hpp" 
 #include "Panzer_ThyraObjContainer.hpp"
+#include "Panzer_DirichletCrsKernel.hpp"
 
 #include "Teuchos_RCP.hpp"
 
@@ -157,37 +158,65 @@ public:
    virtual Teuchos::RCP<Thyra::LinearOpBase<double> > get_A_th() const
    { return (A==Teuchos::null) ? Teuchos::null : Thyra::nonconstEpetraLinearOp(A); }
    
-   // not implemented yet
+   using LinearObjContainer::evalDirichletResidual;
+   using LinearObjContainer::applyDirichletBoundaryCondition;
+   using LinearObjContainer::applyConcentratedLoad;
+
+   // -- 1-0 clear out, symmetric
    void applyDirichletBoundaryCondition( const std::map< panzer::LocalOrdinal, double >& indx ) override
    {
-      TEUCHOS_ASSERT(false); // not yet implemented
+      Kokkos::View<panzer::LocalOrdinal*, Kokkos::HostSpace> local_dofs;
+      Kokkos::View<double*, Kokkos::HostSpace> values;
+      copyToHostViews(indx, local_dofs, values);
+      this->applyDirichletToLocalMatrix(RowAndColumn, 1.0, local_dofs, values, false);
    }
-   void applyDirichletBoundaryCondition( const double&, const std::map< panzer::LocalOrdinal, double >& indx ) override
+   // -- Penaly
+   void applyDirichletBoundaryCondition( const double& p, const std::map< panzer::LocalOrdinal, double >& indx ) override
    {
-      TEUCHOS_ASSERT(false); // not yet implemented
+      Kokkos::View<panzer::LocalOrdinal*, Kokkos::HostSpace> local_dofs;
+      Kokkos::View<double*, Kokkos::HostSpace> values;
+      copyToHostViews(indx, local_dofs, values);
+      this->applyDirichletToLocalMatrix(RowAndColumn, p, local_dofs, values, false);
    }
-   void applyDirichletBoundaryCondition( const double p, const Kokkos::View<panzer::LocalOrdinal*, Kokkos::HostSpace>& local_dofs,
+   // -- 1-0 clear out
+   void applyDirichletBoundaryCondition( const double /* p */, const Kokkos::View<panzer::LocalOrdinal*, Kokkos::HostSpace>& local_dofs,
 		Kokkos::View<double*, Kokkos::HostSpace>& values) final
    {
-      TEUCHOS_ASSERT(false); // not yet implemented
+      this->applyDirichletToLocalMatrix( (f==Teuchos::null) ? RowAndColumn : RowOnly, 1.0, local_dofs, values, true);
+   }
+   /** Apply Dirichlet values to matrix and residual in one pass over the local CRS storage.
+     * The residual of the constrained rows is set to x-values; with RowAndColumn it is lifted
+     * into the free rows, f -= A(:,bc)*(x-values)(bc), before the columns are cleared.
+     */
+   void applyDirichletBoundaryCondition( const DirichletMode mode, const double p,
+		const Kokkos::View<panzer::LocalOrdinal*, PHX::Device>& local_dofs,
+		Kokkos::View<double*, PHX::Device>& values)
+   {
+      Kokkos::View<panzer::LocalOrdinal*, Kokkos::HostSpace> local_dofs_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), local_dofs);
+      Kokkos::View<double*, Kokkos::HostSpace> values_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), values);
+      this->applyDirichletToLocalMatrix(mode, p, local_dofs_h, values_h, true);
    }
    void evalDirichletResidual( const std::map< panzer::LocalOrdinal, double >& indx ) override
    {
-      TEUCHOS_ASSERT(false); // not yet implemented
+      for( const auto& itr: indx )
+         (*f)[itr.first] = (*x)[itr.first] - itr.second;
    }
    void evalDirichletResidual( const Kokkos::View<panzer::LocalOrdinal*, Kokkos::HostSpace>& local_dofs,
 		Kokkos::View<double*, Kokkos::HostSpace>& values) final
    {
-      TEUCHOS_ASSERT(false); // not yet implemented
+      for( std::size_t i=0; i<local_dofs.extent(0); ++i )
+         (*f)[local_dofs(i)] = (*x)[local_dofs(i)] - values(i);
    }
    void applyConcentratedLoad( const std::map< panzer::LocalOrdinal, double >& indx ) override
    {
-      TEUCHOS_ASSERT(false); // not yet implemented
+      for( const auto& itr: indx )
+         (*f)[itr.first] += itr.second;
    }
    void applyConcentratedLoad( Kokkos::View<panzer::LocalOrdinal*, Kokkos::HostSpace>& local_dofs,
 		Kokkos::View<double*, Kokkos::HostSpace>& values ) final
    {
-      TEUCHOS_ASSERT(false); // not yet implemented
+      for( std::size_t i=0; i<local_dofs.extent(0); ++i )
+         (*f)[local_dofs(i)] += values(i);
    }
    
    void writeMatrixMarket(const std::string& filename) const override
@@ -198,6 +227,69 @@ public:
    }
 
 private:
+   static void copyToHostViews( const std::map< panzer::LocalOrdinal, double >& indx,
+		Kokkos::View<panzer::LocalOrdinal*, Kokkos::HostSpace>& local_dofs, Kokkos::View<double*, Kokkos::HostSpace>& values )
+   {
+      local_dofs = Kokkos::View<panzer::LocalOrdinal*, Kokkos::HostSpace>("EpetraLinearObjContainer::local_dofs",indx.size());
+      values = Kokkos::View<double*, Kokkos::HostSpace>("EpetraLinearObjContainer::values",indx.size());
+      std::size_t i=0;
+      for( const auto& itr: indx ) {
+         local_dofs(i) = itr.first;
+         values(i) = itr.second;
+         ++i;
+      }
+   }
+
+   /** Dirichlet elimination on the local CRS arrays, Epetra storage is host only so the kernel runs
+     * on the host execution space. The matrix only overloads keep the residual untouched,
+     * <code>evalResidual</code> sets it to x-values on the constrained rows and lifts it into
+     * the free rows for RowAndColumn.
+     */
+   void applyDirichletToLocalMatrix( const DirichletMode mode, const double p,
+		const Kokkos::View<panzer::LocalOrdinal*, Kokkos::HostSpace>& local_dofs,
+		Kokkos::View<double*, Kokkos::HostSpace>& values, const bool evalResidual )
+   {
+      typedef Kokkos::DefaultHostExecutionSpace host_exec;
+      typedef Kokkos::MemoryTraits<Kokkos::Unmanaged> unmanaged;
+
+      const int numDofs = local_dofs.extent(0);
+      const bool hasF = evalResidual && (f!=Teuchos::null && x!=Teuchos::null);
+      if( hasF )
+         this->evalDirichletResidual(local_dofs, values);
+      if( A==Teuchos::null )
+         return;
+
+      int * indexOffset = 0;
+      int * indices = 0;
+      double * entries = 0;
+      const int err = A->ExtractCrsDataPointers(indexOffset,indices,entries);
+      TEUCHOS_TEST_FOR_EXCEPTION(err!=0,std::logic_error,
+                                 "EpetraLinearObjContainer: matrix storage must be optimized to apply Dirichlet conditions");
+
+      const int numRows = A->NumMyRows();
+      const int numCols = A->NumMyCols();
+      Kokkos::View<const int*, Kokkos::HostSpace, unmanaged> rowptr(indexOffset,numRows+1);
+      Kokkos::View<const int*, Kokkos::HostSpace, unmanaged> cols(indices,indexOffset[numRows]);
+      Kokkos::View<double*, Kokkos::HostSpace, unmanaged> vals(entries,indexOffset[numRows]);
+      Kokkos::View<double**, Kokkos::LayoutLeft, Kokkos::HostSpace, unmanaged> fview(hasF ? f->Values() : 0, hasF ? numRows : 0, 1);
+
+      Kokkos::View<int*, Kokkos::HostSpace> rowDiag("rowDiag",numRows);
+      Kokkos::View<int*, Kokkos::HostSpace> colMark("colMark",numCols);
+      Kokkos::View<double*, Kokkos::HostSpace> colLift("colLift",numCols);
+      Kokkos::deep_copy(rowDiag,-2);
+      for( int i=0; i<numDofs; ++i ) {
+         const int row = local_dofs(i);
+         const int col = A->ColMap().LID(A->RowMap().GID(row));
+         rowDiag(row) = (col<0) ? -1 : col;
+         if( col>=0 ) {
+            colMark(col) = 1;
+            colLift(col) = hasF ? (*f)[row] : 0.0;
+         }
+      }
+
+      panzer::applyDirichletToLocalCrs<host_exec>(mode, p, rowptr, cols, vals, rowDiag, colMark, colLift, fview, hasF, true);
+   }
+
    Teuchos::RCP<const Epetra_Map> domainMap;
    Teuchos::RCP<const Epetra_Map> rangeMap;
    Teuchos::RCP<const Thyra::VectorSpaceBase<double> > domainSpace;
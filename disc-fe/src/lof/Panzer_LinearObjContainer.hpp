@@ -46,10 +46,13 @@
 #include "PanzerDiscFE_config.hpp"
 #include "Panzer_GlobalEvaluationData.hpp"
 #include "Phalanx_DataLayout_MDALayout.hpp"
+#include "Phalanx_KokkosDeviceTypes.hpp"
 
 #include "Teuchos_RCP.hpp"
 #include "Teuchos_dyn_cast.hpp"
 
+#include <map>
+
 namespace panzer {
 
 // **********************************************************************************************
@@ -62,6 +65,9 @@ public:
 
    typedef enum { X=0x1, DxDt=0x2, D2xDt2=0x3, F=0x4, Mat=0x8} Members;
 
+   //! Treatment of Dirichlet rows: zero row, zero row and (symmetric) column, or penalty on the diagonal
+   typedef enum { RowOnly=0, RowAndColumn=1, Penalty=2 } DirichletMode;
+
    virtual void initialize() = 0;
    
    virtual void evalDirichletResidual( const std::map< panzer::LocalOrdinal, double >& indx ) = 0;
@@ -74,8 +80,55 @@ public:
    virtual void applyConcentratedLoad( const std::map< panzer::LocalOrdinal, double >& indx ) = 0;
    virtual void applyConcentratedLoad( Kokkos::View<panzer::LocalOrdinal*, Kokkos::HostSpace>& local_dofs,
 		Kokkos::View<double*, Kokkos::HostSpace>& values ) = 0;
+
+   /** \name Device resident dofs and values
+     * Same semantics as the host overloads. By default the views are copied to the host,
+     * containers with device storage override these to avoid the round trip.
+     */
+   //@{
+   virtual void evalDirichletResidual( const Kokkos::View<panzer::LocalOrdinal*, PHX::Device>& local_dofs,
+		Kokkos::View<double*, PHX::Device>& values)
+   {
+      Kokkos::View<panzer::LocalOrdinal*, Kokkos::HostSpace> local_dofs_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), local_dofs);
+      Kokkos::View<double*, Kokkos::HostSpace> values_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), values);
+      this->evalDirichletResidual(local_dofs_h, values_h);
+   }
+   virtual void applyDirichletBoundaryCondition( const double p, const Kokkos::View<panzer::LocalOrdinal*, PHX::Device>& local_dofs,
+		Kokkos::View<double*, PHX::Device>& values)
+   {
+      Kokkos::View<panzer::LocalOrdinal*, Kokkos::HostSpace> local_dofs_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), local_dofs);
+      Kokkos::View<double*, Kokkos::HostSpace> values_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), values);
+      this->applyDirichletBoundaryCondition(p, local_dofs_h, values_h);
+   }
+   virtual void applyConcentratedLoad( Kokkos::View<panzer::LocalOrdinal*, PHX::Device>& local_dofs,
+		Kokkos::View<double*, PHX::Device>& values )
+   {
+      Kokkos::View<panzer::LocalOrdinal*, Kokkos::HostSpace> local_dofs_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), local_dofs);
+      Kokkos::View<double*, Kokkos::HostSpace> values_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), values);
+      this->applyConcentratedLoad(local_dofs_h, values_h);
+   }
+   //@}
    
    virtual void writeMatrixMarket(const std::string& filename) const = 0;
+
+protected:
+   //! Copy a (local dof, value) map into device views
+   static void copyToDeviceViews( const std::map< panzer::LocalOrdinal, double >& indx,
+		Kokkos::View<panzer::LocalOrdinal*, PHX::Device>& local_dofs, Kokkos::View<double*, PHX::Device>& values )
+   {
+      local_dofs = Kokkos::View<panzer::LocalOrdinal*, PHX::Device>("LinearObjContainer::local_dofs",indx.size());
+      values = Kokkos::View<double*, PHX::Device>("LinearObjContainer::values",indx.size());
+      auto local_dofs_h = Kokkos::create_mirror_view(local_dofs);
+      auto values_h = Kokkos::create_mirror_view(values);
+      std::size_t i=0;
+      for( const auto& itr: indx ) {
+         local_dofs_h(i) = itr.first;
+         values_h(i) = itr.second;
+         ++i;
+      }
+      Kokkos::deep_copy(local_dofs, local_dofs_h);
+      Kokkos::deep_copy(values, values_h);
+   }
 };
 
 }
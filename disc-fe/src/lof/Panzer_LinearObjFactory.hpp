@@ -173,6 +173,20 @@ public:
    virtual void ghostToGlobalContainer(const LinearObjContainer & ghostContainer,
                                        LinearObjContainer & container,int) const = 0;
 
+   /** Split-phase version of <code>globalToGhostContainer</code>. The ghosted
+     * container must not be read until <code>endGlobalToGhostContainer</code>
+     * has been called with the same arguments. By default the exchange is
+     * done synchronously in this call.
+     */
+   virtual void beginGlobalToGhostContainer(const LinearObjContainer & container,
+                                            LinearObjContainer & ghostContainer,int mem) const
+   { globalToGhostContainer(container,ghostContainer,mem); }
+
+   //! Complete an exchange started by <code>beginGlobalToGhostContainer</code>.
+   virtual void endGlobalToGhostContainer(const LinearObjContainer & /* container */,
+                                          LinearObjContainer & /* ghostContainer */,int /* mem */) const
+   { }
+
    /** Initialize container with a specific set of member values.
      *
      * \note This will overwrite everything in the container and zero out values
@@ -51,13 +51,13 @@
 #include "Tpetra_Vector.hpp"
 #include "Tpetra_CrsMatrix.hpp"
 #include "MatrixMarket_Tpetra.hpp"
-#include "Tpetra_applyDirichletBoundaryCondition.hpp"
 
 #include "Thyra_TpetraThyraWrappers.hpp"
 
 #include "Panzer_LinearObjFactory.hpp"
 #include "Panzer_ThyraObjContainer.hpp"
 #include "Panzer_NodeType.hpp"
+#include "Panzer_DirichletCrsKernel.hpp"
 
 #include "Teuchos_RCP.hpp"
 
@@ -91,10 +91,8 @@ public:
       if(get_dxdt()!=Teuchos::null) get_dxdt()->putScalar(0.0);
       if(get_d2xdt2()!=Teuchos::null) get_d2xdt2()->putScalar(0.0);
       if(get_f()!=Teuchos::null) get_f()->putScalar(0.0);
-      if(get_A()!=Teuchos::null) {
-        Teuchos::RCP<CrsMatrixType> mat = get_A(); 
-        mat->setAllToScalar(0.0);
-      }
+      if(get_A()!=Teuchos::null)
+        fillMatrixValues(0.0);
    }
 
    //! Wipe out stored data.
@@ -124,7 +122,7 @@ public:
 
    void initializeMatrix(ScalarT value)
    {  
-     A->setAllToScalar(value); 
+     fillMatrixValues(value); 
    }
 
    virtual void set_x_th(const Teuchos::RCP<Thyra::VectorBase<ScalarT> > & in) 
@@ -170,113 +168,49 @@ public:
    virtual Teuchos::RCP<Thyra::LinearOpBase<ScalarT> > get_A_th() const
    { return (A==Teuchos::null) ? Teuchos::null : Thyra::createLinearOp<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>(A,rangeSpace,domainSpace); }
    
-   // -- 1-0 clear out
+   // -- 1-0 clear out, symmetric
    void applyDirichletBoundaryCondition( const std::map< panzer::LocalOrdinal, double >& indx ) override
    {
-	   /*using device_type = typename CrsMatrixType::device_type;
-      using execution_space = typename CrsMatrixType::execution_space;
-      using range_type = Kokkos::RangePolicy<execution_space, LocalOrdinalT>;
-
-      std::vector<panzer::LocalOrdinal> lids;
-      for( auto itr: indx ) lids.emplace_back(itr.first);
-	  
-	   const LocalOrdinalT lclNumRows = indx.size();
-	   Kokkos::View<typename CrsMatrixType::local_ordinal_type*, device_type> lclRowInds ("lclRowInds", lclNumRows);
-	   Kokkos::parallel_for
-      ("Fill lclRowInds",
-         range_type (0, lclNumRows),
-         KOKKOS_LAMBDA (const LocalOrdinalT lclRow) {
-	        lclRowInds(lclRow) = lids[lclRow];
-         }
-      );
-	   
-	   Tpetra::applyDirichletBoundaryConditionToLocalMatrixRows(*A, lclRowInds);*/
-
-    //  ContainerType & t_ghosted = Teuchos::dyn_cast<ContainerType>(GhostedContainer);
-    //  Teuchos::RCP<CrsMatrixType> A = t_ghosted.get_A();
-    //  VectorType f = *( t_ghosted.get_f() );
-    //  Teuchos::ArrayRCP<ScalarT> f_1dview = f.get1dViewNonConst();
-
-      ScalarT inputVals[1];  inputVals[0]=0.0;
-      LocalOrdinalT inputCols[1];
-      for( auto itr: indx )
-      {
-      //   std::cout << itr.first << "," << itr.second << std::endl;
-	      std::size_t numEntries = 0;
-         std::size_t sz = A->getNumEntriesInLocalRow(itr.first);
-         //Teuchos::Array<LocalOrdinalT> indices(sz);
-         //Teuchos::Array<ScalarT> Entries(sz);
-         //A->getLocalRowCopy(itr.first,indices,Entries,numEntries);
-		 typename CrsMatrixType::nonconst_local_inds_host_view_type indices("indices", sz);
-	     typename CrsMatrixType::nonconst_values_host_view_type Entries("values", sz);
-         A->getLocalRowCopy(itr.first,indices,Entries,numEntries);
-         inputCols[0] = itr.first;
-	      for (std::size_t i=0; i<sz; i++) {
-		      if( indices[i]==itr.first )
-			      Entries[i] = 1.0;
-		      else {
-		  	      Entries[i] = 0.0;
-               A->replaceLocalValues(indices[i],1,inputVals,inputCols);   // For symmetric mastrix only
-            }
-	      }  
-         A->replaceLocalValues(itr.first,indices,Entries);
-      //   f_1dview[itr.first] = 0.0;
-      }
+      Kokkos::View<panzer::LocalOrdinal*, PHX::Device> local_dofs;
+      Kokkos::View<double*, PHX::Device> values;
+      copyToDeviceViews(indx, local_dofs, values);
+      this->applyDirichletToLocalMatrix(RowAndColumn, 1.0, local_dofs, values, false);
    }
    
    // -- 1-0 clear out
    void applyDirichletBoundaryCondition( const double p, const Kokkos::View<panzer::LocalOrdinal*, Kokkos::HostSpace>& local_dofs,
 		Kokkos::View<double*, Kokkos::HostSpace>& values) final
    {
-	   if( f==Teuchos::null ) {   // for eigen , need extent to consider K-pivot
-		   Tpetra::applyDirichletBoundaryConditionToLocalMatrixRowsAndColumns(*A, local_dofs);
-	   } else {
-	       Tpetra::applyDirichletBoundaryConditionToLocalMatrixRows(*A, local_dofs);
-		   this->evalDirichletResidual(local_dofs, values);
-	   }
+      Kokkos::View<panzer::LocalOrdinal*, PHX::Device> local_dofs_d = Kokkos::create_mirror_view_and_copy(PHX::Device::memory_space(), local_dofs);
+      Kokkos::View<double*, PHX::Device> values_d = Kokkos::create_mirror_view_and_copy(PHX::Device::memory_space(), values);
+      this->applyDirichletBoundaryCondition(p, local_dofs_d, values_d);
+   }
+
+   void applyDirichletBoundaryCondition( const double /* p */, const Kokkos::View<panzer::LocalOrdinal*, PHX::Device>& local_dofs,
+		Kokkos::View<double*, PHX::Device>& values) final
+   {
+	   // for eigen , need extent to consider K-pivot
+	   this->applyDirichletToLocalMatrix( (f==Teuchos::null) ? RowAndColumn : RowOnly, 1.0, local_dofs, values, true);
    }
    
    // -- Penaly
    void applyDirichletBoundaryCondition( const double& p, const std::map< panzer::LocalOrdinal, double >& indx ) override
    {
-   	/*VectorType diagCopy (A->getRowMap ());
-	   Teuchos::ArrayRCP<std::size_t> offsets;
-	   A->getLocalDiagOffsets (offsets);
-      A->getLocalDiagCopy (diagCopy, offsets());
-      Teuchos::ArrayRCP<const ScalarT> diags = diagCopy.get1dView ();
-	  
-   	ScalarT inputVals[1];
-      LocalOrdinalT inputCols[1];
-   	for( auto itr: indx )
-      {
-        inputCols[0] = itr.first;
-		  inputVals[0] = diags[itr.first]*p;
-		  A->replaceLocalValues(itr.first,1,inputVals,inputCols);
-      }*/
-	  
-	  ScalarT inputVals[1];  inputVals[0]=0.0;
-      LocalOrdinalT inputCols[1];
-      for( auto itr: indx )
-      {
-         std::size_t numEntries = 0;
-         std::size_t sz = A->getNumEntriesInLocalRow(itr.first);
-         //Teuchos::Array<LocalOrdinalT> indices(sz);
-         //Teuchos::Array<ScalarT> Entries(sz);
-		 //A->getLocalRowCopy(itr.first,indices,Entries,numEntries);
-		 typename CrsMatrixType::nonconst_local_inds_host_view_type indices("indices", sz);
-	     typename CrsMatrixType::nonconst_values_host_view_type Entries("values", sz);
-         A->getLocalRowCopy(itr.first,indices,Entries,numEntries);
-         inputCols[0] = itr.first;
-	      for (std::size_t i=0; i<sz; i++) {
-		      if( indices[i]==itr.first )
-			      Entries[i] = p;
-		      else {
-		  	      Entries[i] = 0.0;
-               A->replaceLocalValues(indices[i],1,inputVals,inputCols);   // For symmetric mastrix only
-            }
-	      }  
-         A->replaceLocalValues(itr.first,indices,Entries);
-      }
+      Kokkos::View<panzer::LocalOrdinal*, PHX::Device> local_dofs;
+      Kokkos::View<double*, PHX::Device> values;
+      copyToDeviceViews(indx, local_dofs, values);
+      this->applyDirichletToLocalMatrix(RowAndColumn, p, local_dofs, values, false);
+   }
+
+   /** Apply Dirichlet values to matrix and residual in one pass over the local CRS storage.
+     * The residual of the constrained rows is set to x-values; with RowAndColumn it is lifted
+     * into the free rows, f -= A(:,bc)*(x-values)(bc), before the columns are cleared.
+     */
+   void applyDirichletBoundaryCondition( const DirichletMode mode, const double p,
+		const Kokkos::View<panzer::LocalOrdinal*, PHX::Device>& local_dofs,
+		Kokkos::View<double*, PHX::Device>& values)
+   {
+      this->applyDirichletToLocalMatrix(mode, p, local_dofs, values, true);
    }
 
    void evalDirichletResidual( const std::map< panzer::LocalOrdinal, double >& indx ) override
@@ -305,26 +239,21 @@ public:
    
    void evalDirichletResidual( const Kokkos::View<panzer::LocalOrdinal*, Kokkos::HostSpace>& local_dofs,
 		Kokkos::View<double*, Kokkos::HostSpace>& values) final
+   {
+      Kokkos::View<panzer::LocalOrdinal*, PHX::Device> local_dofs_d = Kokkos::create_mirror_view_and_copy(PHX::Device::memory_space(), local_dofs);
+      Kokkos::View<double*, PHX::Device> values_d = Kokkos::create_mirror_view_and_copy(PHX::Device::memory_space(), values);
+      this->evalDirichletResidual(local_dofs_d, values_d);
+   }
+
+   void evalDirichletResidual( const Kokkos::View<panzer::LocalOrdinal*, PHX::Device>& local_dofs,
+		Kokkos::View<double*, PHX::Device>& values) final
    {
 	   const auto& xview = x->getLocalViewDevice(Tpetra::Access::ReadOnly);
 	   const auto& fview = f->getLocalViewDevice(Tpetra::Access::ReadWrite);
 	   LocalOrdinalT numDofs = local_dofs.extent(0);
 	   Kokkos::parallel_for( numDofs, KOKKOS_LAMBDA (const LocalOrdinalT lclRow) {
-			//double a = xview(local_dofs(lclRow),0) - values(lclRow);
-			//std::cout << lclRow << " ,,, " << local_dofs(lclRow) << " ,,, " << values(lclRow) << std::endl;
 			fview(local_dofs(lclRow),0) = xview(local_dofs(lclRow),0) - values(lclRow);
-			//Kokkos::atomic_assign(&fview(local_dofs(lclRow),0), a);
        } );
-	  /*Teuchos::ArrayRCP<const ScalarT> x_1dview = x->get1dView();
-	  Teuchos::ArrayRCP<double> f_1dview = f->get1dViewNonConst();
-	  LocalOrdinalT numDofs = local_dofs.extent(0);std::cout << " ******************************\n";
-      for( std::size_t i=0; i<numDofs; ++i )
-      {
-		auto lid = local_dofs(i);
-	  	double a = x_1dview[lid] - values(i);
-		std::cout << i << " ,,, " << lid << " ,,, " << values(i)  << " ,,, " << x_1dview[lid] << std::endl;
-		f_1dview[lid] = a;
-      }*/
    }
    
    void applyConcentratedLoad( const std::map< panzer::LocalOrdinal, double >& indx ) override
@@ -337,23 +266,20 @@ public:
    
    void applyConcentratedLoad( Kokkos::View<panzer::LocalOrdinal*, Kokkos::HostSpace>& local_dofs,
 		Kokkos::View<double*, Kokkos::HostSpace>& values) final
+   {
+      Kokkos::View<panzer::LocalOrdinal*, PHX::Device> local_dofs_d = Kokkos::create_mirror_view_and_copy(PHX::Device::memory_space(), local_dofs);
+      Kokkos::View<double*, PHX::Device> values_d = Kokkos::create_mirror_view_and_copy(PHX::Device::memory_space(), values);
+      this->applyConcentratedLoad(local_dofs_d, values_d);
+   }
+
+   void applyConcentratedLoad( Kokkos::View<panzer::LocalOrdinal*, PHX::Device>& local_dofs,
+		Kokkos::View<double*, PHX::Device>& values) final
    {
 	   const auto& fview = f->getLocalViewDevice(Tpetra::Access::ReadWrite);
 	   LocalOrdinalT numDofs = local_dofs.extent(0);
 	   Kokkos::parallel_for( numDofs, KOKKOS_LAMBDA (const LocalOrdinalT lclRow) {
-			//std::cout << lclRow << " ,,, " << local_dofs(lclRow) << " ,,, " << values(lclRow) << std::endl;
 			fview(local_dofs(lclRow),0) += values(lclRow);
-			//Kokkos::atomic_add(&fview(local_dofs(lclRow),0), values(lclRow));
        } );
-	  /*
-	  Teuchos::ArrayRCP<double> f_1dview = f->get1dViewNonConst();
-	  LocalOrdinalT numDofs = local_dofs.extent(0);
-      for( std::size_t i=0; i<numDofs; ++i )
-      {
-		auto lid = local_dofs(i);
-		std::cout << i << " ,,, " << lid << " ,,, " << values(i)  << std::endl;
-		f_1dview[lid] += values(i);
-      }*/
    }
    
    void writeMatrixMarket(const std::string& filename) const override
@@ -369,6 +295,51 @@ public:
 private:
    typedef Thyra::TpetraOperatorVectorExtraction<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT> TOE;
 
+   /** Dirichlet elimination on the local CRS arrays. The matrix only overloads keep the
+     * residual untouched, <code>evalResidual</code> sets it to x-values on the constrained
+     * rows and lifts it into the free rows for RowAndColumn.
+     */
+   void applyDirichletToLocalMatrix(const DirichletMode mode, const double p,
+                                    const Kokkos::View<panzer::LocalOrdinal*, PHX::Device>& local_dofs,
+                                    Kokkos::View<double*, PHX::Device>& values,
+                                    const bool evalResidual)
+   {
+      typedef typename CrsMatrixType::device_type device_type;
+      typedef typename CrsMatrixType::execution_space execution_space;
+
+      const bool hasF = evalResidual && (f!=Teuchos::null && x!=Teuchos::null);
+      if( hasF )
+         this->evalDirichletResidual(local_dofs, values);
+      if( A==Teuchos::null )
+         return;
+
+      auto lclA = A->getLocalMatrixDevice();
+      Kokkos::View<LocalOrdinalT*, device_type> rowDiag("rowDiag", A->getLocalNumRows());
+      Kokkos::View<int*, device_type> colMark("colMark", A->getLocalNumCols());
+      Kokkos::View<ScalarT*, device_type> colLift("colLift", A->getLocalNumCols());
+
+      typename VectorType::dual_view_type::t_dev fview;
+      if( hasF )
+         fview = f->getLocalViewDevice(Tpetra::Access::ReadWrite);
+
+      panzer::markDirichletDofs<execution_space>(local_dofs, A->getRowMap()->getLocalMap(), A->getColMap()->getLocalMap(),
+                                                 rowDiag, colMark, colLift, fview, hasF);
+      panzer::applyDirichletToLocalCrs<execution_space>(mode, p, lclA.graph.row_map, lclA.graph.entries, lclA.values,
+                                                        rowDiag, colMark, colLift, fview, hasF, true);
+   }
+
+   /** Set every stored entry of the matrix to <code>value</code>. A matrix whose
+     * graph is frozen (see <code>TpetraLinearObjFactory::setFrozenGraphAssembly</code>)
+     * stays fill complete between assemblies, so its local values are written directly.
+     */
+   void fillMatrixValues(ScalarT value)
+   {
+     if(A->isFillActive())
+       A->setAllToScalar(value);
+     else
+       Kokkos::deep_copy(A->getLocalMatrixDevice().values,value);
+   }
+
    Teuchos::RCP<const Thyra::VectorSpaceBase<ScalarT> > domainSpace;
    Teuchos::RCP<const Thyra::VectorSpaceBase<ScalarT> > rangeSpace;
 
@@ -67,6 +67,7 @@
 
 #include "Teuchos_RCP.hpp"
 #include "Teuchos_DefaultMpiComm.hpp"
+#include "Teuchos_CommHelpers.hpp"
 
 namespace panzer {
 
@@ -112,6 +113,10 @@ public:
                                        LinearObjContainer & ghostContainer,int) const;
    virtual void ghostToGlobalContainer(const LinearObjContainer & ghostContainer,
                                        LinearObjContainer & container,int) const;
+   virtual void beginGlobalToGhostContainer(const LinearObjContainer & container,
+                                            LinearObjContainer & ghostContainer,int) const;
+   virtual void endGlobalToGhostContainer(const LinearObjContainer & container,
+                                          LinearObjContainer & ghostContainer,int) const;
 									   
    void ghostToGlobalTpetraVector(const Tpetra::Vector<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT> & in,
                                   Tpetra::Vector<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT> & out, bool col) const;
@@ -119,6 +124,10 @@ public:
                                   Tpetra::CrsMatrix<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT> & out) const;
    void globalToGhostTpetraVector(const Tpetra::Vector<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>& in,
                                   Tpetra::Vector<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT> & out, bool col) const;
+   void beginGlobalToGhostTpetraVector(const Tpetra::Vector<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>& in,
+                                       Tpetra::Vector<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT> & out, bool col) const;
+   void endGlobalToGhostTpetraVector(const Tpetra::Vector<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>& in,
+                                     Tpetra::Vector<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT> & out, bool col) const;
 
    /** Build a GlobalEvaluationDataContainer that handles all domain communication.
      * This is used primarily for gather operations and hides the allocation and usage
@@ -243,8 +252,54 @@ public:
    virtual void beginFill(LinearObjContainer & loc) const;
    virtual void endFill(LinearObjContainer & loc) const;
 
+   /** Freeze the matrix graphs after the first assembly. In this mode the ghosted and
+     * owned matrices stay fill complete: <code>beginFill</code>/<code>endFill</code> no longer
+     * call <code>resumeFill</code>/<code>fillComplete</code>, and <code>ghostToGlobalTpetraMatrix</code>
+     * writes values straight into the owned CRS storage through a precomputed table of
+     * offsets. Entries of rows owned by other processes are shipped through a persistent
+     * value exchange whose receives are posted by <code>beginFill</code> on the ghosted container.
+     */
+   void setFrozenGraphAssembly(bool value)
+   { frozenGraph_ = value; }
+
+   //! Is the matrix graph frozen between assemblies?
+   bool getFrozenGraphAssembly() const
+   { return frozenGraph_; }
+
 protected:
 
+   /** Precomputed plan for moving the values of the ghosted matrix into the owned
+     * matrix once the graphs are frozen. Offsets index the CRS value arrays directly.
+     */
+   struct MatrixValueExchange {
+      typedef Kokkos::View<std::size_t*,PHX::Device> OffsetView;
+      typedef Kokkos::View<ScalarT*,PHX::Device> ValueView;
+
+      static constexpr int patternTag = 2731; //!< tag used while building the exchange
+      static constexpr int valueTag = 2732;   //!< tag used by the persistent value exchange
+
+      Teuchos::RCP<const CrsGraphType> ghostedGraph; //!< graph the offsets were computed against
+      Teuchos::RCP<const CrsGraphType> ownedGraph;   //!< graph the offsets were computed against
+
+      OffsetView localSrc, localDst; //!< ghosted entries of locally owned rows
+      OffsetView sendSrc;            //!< ghosted entries shipped to other processes, grouped by process
+      OffsetView recvDst;            //!< owned entries receiving values, grouped by process
+
+      std::vector<int> sendProcs, recvProcs;
+      std::vector<std::size_t> sendOffsets, recvOffsets; //!< CSR style offsets into the send/recv tables
+
+      ValueView sendValues, recvValues;
+      Teuchos::ArrayRCP<ScalarT> sendBuffer, recvBuffer; //!< host buffers handed to MPI
+      std::vector<Teuchos::RCP<Teuchos::CommRequest<int> > > recvRequests;
+      bool recvPosted;
+   };
+
+   //! Build the frozen graph value exchange between the ghosted matrix and the owned matrix
+   Teuchos::RCP<MatrixValueExchange> buildMatrixValueExchange(const CrsMatrixType & in,const CrsMatrixType & out) const;
+
+   //! Post the receives of the frozen graph value exchange (if not already posted)
+   void postMatrixValueReceives(MatrixValueExchange & exchange) const;
+
    // get the map from the matrix
    virtual const Teuchos::RCP<Tpetra::Map<LocalOrdinalT,GlobalOrdinalT,NodeT> > buildMap() const;
    virtual const Teuchos::RCP<Tpetra::Map<LocalOrdinalT,GlobalOrdinalT,NodeT> > buildColMap() const;
@@ -275,6 +330,9 @@ protected:
 
    mutable Teuchos::RCP<const Thyra::VectorSpaceBase<double> > rangeSpace_;
    mutable Teuchos::RCP<const Thyra::VectorSpaceBase<double> > domainSpace_;
+
+   bool frozenGraph_;
+   mutable Teuchos::RCP<MatrixValueExchange> matrixExchange_;
 };
 
 }
@@ -56,8 +56,12 @@
 #include "Tpetra_MultiVector.hpp"
 #include "Tpetra_Vector.hpp"
 #include "Tpetra_CrsMatrix.hpp"
+#include "Tpetra_Distributor.hpp"
 #include "MatrixMarket_Tpetra.hpp"
 
+#include <algorithm>
+#include <numeric>
+
 namespace panzer {
 
 using Teuchos::RCP;
@@ -70,7 +74,7 @@ template <typename Traits,typename ScalarT,typename LocalOrdinalT,typename Globa
 TpetraLinearObjFactory<Traits,ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>::
 TpetraLinearObjFactory(const Teuchos::RCP<const Teuchos::Comm<int> > & comm,
                        const Teuchos::RCP<const GlobalIndexer> & gidProvider)
-   : comm_(comm), gidProvider_(gidProvider)
+   : comm_(comm), gidProvider_(gidProvider), frozenGraph_(false)
 { 
    hasColProvider_ = colGidProvider_!=Teuchos::null;
 
@@ -84,7 +88,7 @@ TpetraLinearObjFactory<Traits,ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>::
 TpetraLinearObjFactory(const Teuchos::RCP<const Teuchos::Comm<int> > & comm,
                        const Teuchos::RCP<const GlobalIndexer> & gidProvider,
                        const Teuchos::RCP<const GlobalIndexer> & colGidProvider)
-   : comm_(comm), gidProvider_(gidProvider), colGidProvider_(colGidProvider)
+   : comm_(comm), gidProvider_(gidProvider), colGidProvider_(colGidProvider), frozenGraph_(false)
 { 
    hasColProvider_ = colGidProvider_!=Teuchos::null;
 
@@ -148,6 +152,55 @@ globalToGhostContainer(const LinearObjContainer & in,
       globalToGhostTpetraVector(*t_in.get_f(),*t_out.get_f(),false);
 }
 
+template <typename Traits,typename ScalarT,typename LocalOrdinalT,typename GlobalOrdinalT,typename NodeT>
+void 
+TpetraLinearObjFactory<Traits,ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>::
+beginGlobalToGhostContainer(const LinearObjContainer & in,
+                            LinearObjContainer & out,int mem) const
+{
+   using Teuchos::is_null;
+   typedef LinearObjContainer LOC;
+
+   const ContainerType & t_in = Teuchos::dyn_cast<const ContainerType>(in); 
+   ContainerType & t_out = Teuchos::dyn_cast<ContainerType>(out); 
+  
+   // Only the solution vectors are overlapped, they are the only ones the
+   // volume evaluators read. The residual is exchanged synchronously.
+   if ( !is_null(t_in.get_x()) && !is_null(t_out.get_x()) && ((mem & LOC::X)==LOC::X))
+     beginGlobalToGhostTpetraVector(*t_in.get_x(),*t_out.get_x(),true);
+  
+   if ( !is_null(t_in.get_dxdt()) && !is_null(t_out.get_dxdt()) && ((mem & LOC::DxDt)==LOC::DxDt))
+     beginGlobalToGhostTpetraVector(*t_in.get_dxdt(),*t_out.get_dxdt(),true);
+ 
+   if ( !is_null(t_in.get_d2xdt2()) && !is_null(t_out.get_d2xdt2()) && ((mem & LOC::D2xDt2)==LOC::D2xDt2))
+     beginGlobalToGhostTpetraVector(*t_in.get_d2xdt2(),*t_out.get_d2xdt2(),true);
+
+   if ( !is_null(t_in.get_f()) && !is_null(t_out.get_f()) && ((mem & LOC::F)==LOC::F))
+      globalToGhostTpetraVector(*t_in.get_f(),*t_out.get_f(),false);
+}
+
+template <typename Traits,typename ScalarT,typename LocalOrdinalT,typename GlobalOrdinalT,typename NodeT>
+void 
+TpetraLinearObjFactory<Traits,ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>::
+endGlobalToGhostContainer(const LinearObjContainer & in,
+                          LinearObjContainer & out,int mem) const
+{
+   using Teuchos::is_null;
+   typedef LinearObjContainer LOC;
+
+   const ContainerType & t_in = Teuchos::dyn_cast<const ContainerType>(in); 
+   ContainerType & t_out = Teuchos::dyn_cast<ContainerType>(out); 
+  
+   if ( !is_null(t_in.get_x()) && !is_null(t_out.get_x()) && ((mem & LOC::X)==LOC::X))
+     endGlobalToGhostTpetraVector(*t_in.get_x(),*t_out.get_x(),true);
+  
+   if ( !is_null(t_in.get_dxdt()) && !is_null(t_out.get_dxdt()) && ((mem & LOC::DxDt)==LOC::DxDt))
+     endGlobalToGhostTpetraVector(*t_in.get_dxdt(),*t_out.get_dxdt(),true);
+ 
+   if ( !is_null(t_in.get_d2xdt2()) && !is_null(t_out.get_d2xdt2()) && ((mem & LOC::D2xDt2)==LOC::D2xDt2))
+     endGlobalToGhostTpetraVector(*t_in.get_d2xdt2(),*t_out.get_d2xdt2(),true);
+}
+
 template <typename Traits,typename ScalarT,typename LocalOrdinalT,typename GlobalOrdinalT,typename NodeT>
 void 
 TpetraLinearObjFactory<Traits,ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>::
@@ -195,6 +248,70 @@ ghostToGlobalTpetraMatrix(const Tpetra::CrsMatrix<ScalarT,LocalOrdinalT,GlobalOr
 {
    using Teuchos::RCP;
 
+   if(frozenGraph_ && in.isFillComplete() && out.isFillComplete()) {
+      // the plan is only valid for the graphs it was built from, rebuild it when
+      // the containers were given new graphs (graphs are built collectively, so
+      // every process rebuilds together)
+      if(matrixExchange_==Teuchos::null ||
+         matrixExchange_->ghostedGraph.get()!=in.getCrsGraph().get() ||
+         matrixExchange_->ownedGraph.get()!=out.getCrsGraph().get()) {
+         TEUCHOS_TEST_FOR_EXCEPTION(matrixExchange_!=Teuchos::null && matrixExchange_->recvPosted,std::logic_error,
+                                    "TpetraLinearObjFactory::ghostToGlobalTpetraMatrix: the matrix graphs changed "
+                                    "while receives for the previous graphs are posted (beginFill without a matching export)");
+         matrixExchange_ = buildMatrixValueExchange(in,out);
+      }
+
+      MatrixValueExchange & exchange = *matrixExchange_;
+      typedef typename MatrixValueExchange::OffsetView OffsetView;
+      typedef typename MatrixValueExchange::ValueView ValueView;
+
+      // normally posted by beginFill, make sure before anything is sent
+      postMatrixValueReceives(exchange);
+
+      const auto inValues = in.getLocalMatrixDevice().values;
+      const auto outValues = out.getLocalMatrixDevice().values;
+
+      // pack the contributions to rows owned by other processes and ship them
+      const OffsetView sendSrc = exchange.sendSrc;
+      const ValueView sendValues = exchange.sendValues;
+      Kokkos::parallel_for("TpetraLinearObjFactory::packMatrixValues",sendSrc.extent(0),KOKKOS_LAMBDA (const std::size_t i) {
+         sendValues(i) = inValues(sendSrc(i));
+      });
+      Kokkos::View<ScalarT*,Kokkos::HostSpace,Kokkos::MemoryUnmanaged> sendBuffer(exchange.sendBuffer.getRawPtr(),exchange.sendBuffer.size());
+      Kokkos::deep_copy(sendBuffer,sendValues);
+
+      std::vector<RCP<Teuchos::CommRequest<int> > > sendRequests;
+      for(std::size_t p=0;p<exchange.sendProcs.size();p++) {
+         const std::size_t begin = exchange.sendOffsets[p];
+         const std::size_t count = exchange.sendOffsets[p+1]-begin;
+         sendRequests.push_back(Teuchos::isend<int,ScalarT>(exchange.sendBuffer.persistingView(begin,count).getConst(),
+                                                            exchange.sendProcs[p],MatrixValueExchange::valueTag,*comm_));
+      }
+
+      // overlap the communication with the copy of the locally owned rows
+      const OffsetView localSrc = exchange.localSrc;
+      const OffsetView localDst = exchange.localDst;
+      Kokkos::deep_copy(outValues,0.0);
+      Kokkos::parallel_for("TpetraLinearObjFactory::copyMatrixValues",localSrc.extent(0),KOKKOS_LAMBDA (const std::size_t i) {
+         outValues(localDst(i)) = inValues(localSrc(i));
+      });
+
+      // sum in contributions from other processes
+      Teuchos::waitAll(*comm_,Teuchos::arrayViewFromVector(exchange.recvRequests));
+      exchange.recvPosted = false;
+
+      const OffsetView recvDst = exchange.recvDst;
+      const ValueView recvValues = exchange.recvValues;
+      Kokkos::View<const ScalarT*,Kokkos::HostSpace,Kokkos::MemoryUnmanaged> recvBuffer(exchange.recvBuffer.getRawPtr(),exchange.recvBuffer.size());
+      Kokkos::deep_copy(recvValues,recvBuffer);
+      Kokkos::parallel_for("TpetraLinearObjFactory::sumMatrixValues",recvDst.extent(0),KOKKOS_LAMBDA (const std::size_t i) {
+         Kokkos::atomic_add(&outValues(recvDst(i)),recvValues(i));
+      });
+
+      Teuchos::waitAll(*comm_,Teuchos::arrayViewFromVector(sendRequests));
+      return;
+   }
+
    // do the global distribution
    RCP<ExportType> exporter = getGhostedExport();
    
@@ -204,6 +321,158 @@ ghostToGlobalTpetraMatrix(const Tpetra::CrsMatrix<ScalarT,LocalOrdinalT,GlobalOr
    out.fillComplete(out.getDomainMap(),out.getRangeMap());
 }
 
+template <typename Traits,typename ScalarT,typename LocalOrdinalT,typename GlobalOrdinalT,typename NodeT>
+Teuchos::RCP<typename TpetraLinearObjFactory<Traits,ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>::MatrixValueExchange>
+TpetraLinearObjFactory<Traits,ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>::
+buildMatrixValueExchange(const CrsMatrixType & in,const CrsMatrixType & out) const
+{
+   using Teuchos::RCP;
+   typedef typename MatrixValueExchange::OffsetView OffsetView;
+   typedef typename MatrixValueExchange::ValueView ValueView;
+
+   RCP<MatrixValueExchange> exchange = Teuchos::rcp(new MatrixValueExchange);
+   exchange->ghostedGraph = in.getCrsGraph();
+   exchange->ownedGraph = out.getCrsGraph();
+   exchange->recvPosted = false;
+
+   const auto inGraph = exchange->ghostedGraph->getLocalGraphHost();
+   const auto outGraph = exchange->ownedGraph->getLocalGraphHost();
+   const MapType & inRowMap = *in.getRowMap();
+   const MapType & inColMap = *in.getColMap();
+   const MapType & outRowMap = *out.getRowMap();
+   const MapType & outColMap = *out.getColMap();
+
+   // find the offset of a (row,col) entry in the owned CRS storage
+   auto ownedOffset = [&](GlobalOrdinalT rowGid,GlobalOrdinalT colGid) -> std::size_t {
+      const LocalOrdinalT row = outRowMap.getLocalElement(rowGid);
+      const LocalOrdinalT col = outColMap.getLocalElement(colGid);
+      if(row!=Teuchos::OrdinalTraits<LocalOrdinalT>::invalid() && col!=Teuchos::OrdinalTraits<LocalOrdinalT>::invalid()) {
+         for(std::size_t k=outGraph.row_map(row);k<outGraph.row_map(row+1);k++)
+            if(outGraph.entries(k)==col)
+               return k;
+      }
+      TEUCHOS_TEST_FOR_EXCEPTION(true,std::logic_error,
+                                 "TpetraLinearObjFactory::buildMatrixValueExchange: entry (" << rowGid << "," << colGid << ") "
+                                 "of the ghosted matrix is not stored in the owned matrix.");
+      return 0;
+   };
+
+   // split the ghosted entries into locally owned rows and rows owned elsewhere
+   std::vector<std::size_t> localSrc, localDst, remoteSrc;
+   std::vector<GlobalOrdinalT> remoteRows, remoteCols;
+   for(std::size_t row=0;row<in.getLocalNumRows();row++) {
+      const GlobalOrdinalT rowGid = inRowMap.getGlobalElement(static_cast<LocalOrdinalT>(row));
+      const bool owned = outRowMap.isNodeGlobalElement(rowGid);
+      for(std::size_t k=inGraph.row_map(row);k<inGraph.row_map(row+1);k++) {
+         const GlobalOrdinalT colGid = inColMap.getGlobalElement(inGraph.entries(k));
+         if(owned) {
+            localSrc.push_back(k);
+            localDst.push_back(ownedOffset(rowGid,colGid));
+         }
+         else {
+            remoteSrc.push_back(k);
+            remoteRows.push_back(rowGid);
+            remoteCols.push_back(colGid);
+         }
+      }
+   }
+
+   // group the remote entries by owning process
+   std::vector<int> owners(remoteRows.size());
+   outRowMap.getRemoteIndexList(Teuchos::arrayViewFromVector(remoteRows),Teuchos::arrayViewFromVector(owners));
+
+   std::vector<std::size_t> order(owners.size());
+   std::iota(order.begin(),order.end(),0);
+   std::stable_sort(order.begin(),order.end(),[&](std::size_t a,std::size_t b) { return owners[a]<owners[b]; });
+
+   std::vector<int> sendTo(order.size());
+   std::vector<std::size_t> sendSrc(order.size());
+   Teuchos::ArrayRCP<GlobalOrdinalT> sendGids(2*order.size());
+   for(std::size_t i=0;i<order.size();i++) {
+      sendTo[i] = owners[order[i]];
+      sendSrc[i] = remoteSrc[order[i]];
+      sendGids[2*i+0] = remoteRows[order[i]];
+      sendGids[2*i+1] = remoteCols[order[i]];
+
+      if(exchange->sendProcs.size()==0 || exchange->sendProcs.back()!=sendTo[i]) {
+         exchange->sendProcs.push_back(sendTo[i]);
+         exchange->sendOffsets.push_back(i);
+      }
+   }
+   exchange->sendOffsets.push_back(order.size());
+
+   // learn who will be sending to this process and how much
+   Tpetra::Distributor distributor(comm_);
+   distributor.createFromSends(Teuchos::arrayViewFromVector(sendTo));
+
+   Teuchos::ArrayView<const int> procsFrom = distributor.getProcsFrom();
+   Teuchos::ArrayView<const std::size_t> lengthsFrom = distributor.getLengthsFrom();
+   exchange->recvProcs.assign(procsFrom.begin(),procsFrom.end());
+   exchange->recvOffsets.push_back(0);
+   for(std::size_t p=0;p<exchange->recvProcs.size();p++)
+      exchange->recvOffsets.push_back(exchange->recvOffsets.back()+lengthsFrom[p]);
+
+   // ship the global (row,col) pairs so the owners can compute their offsets
+   Teuchos::ArrayRCP<GlobalOrdinalT> recvGids(2*exchange->recvOffsets.back());
+   std::vector<RCP<Teuchos::CommRequest<int> > > requests;
+   for(std::size_t p=0;p<exchange->recvProcs.size();p++) {
+      const std::size_t begin = exchange->recvOffsets[p];
+      const std::size_t count = exchange->recvOffsets[p+1]-begin;
+      requests.push_back(Teuchos::ireceive<int,GlobalOrdinalT>(recvGids.persistingView(2*begin,2*count),
+                                                               exchange->recvProcs[p],MatrixValueExchange::patternTag,*comm_));
+   }
+   for(std::size_t p=0;p<exchange->sendProcs.size();p++) {
+      const std::size_t begin = exchange->sendOffsets[p];
+      const std::size_t count = exchange->sendOffsets[p+1]-begin;
+      requests.push_back(Teuchos::isend<int,GlobalOrdinalT>(sendGids.persistingView(2*begin,2*count).getConst(),
+                                                            exchange->sendProcs[p],MatrixValueExchange::patternTag,*comm_));
+   }
+   Teuchos::waitAll(*comm_,Teuchos::arrayViewFromVector(requests));
+
+   std::vector<std::size_t> recvDst(exchange->recvOffsets.back());
+   for(std::size_t i=0;i<recvDst.size();i++)
+      recvDst[i] = ownedOffset(recvGids[2*i+0],recvGids[2*i+1]);
+
+   // move the tables to the device
+   auto toDevice = [](const std::vector<std::size_t> & offsets,const std::string & name) {
+      OffsetView view(name,offsets.size());
+      auto view_h = Kokkos::create_mirror_view(view);
+      for(std::size_t i=0;i<offsets.size();i++)
+         view_h(i) = offsets[i];
+      Kokkos::deep_copy(view,view_h);
+      return view;
+   };
+   exchange->localSrc = toDevice(localSrc,"localSrc");
+   exchange->localDst = toDevice(localDst,"localDst");
+   exchange->sendSrc = toDevice(sendSrc,"sendSrc");
+   exchange->recvDst = toDevice(recvDst,"recvDst");
+
+   exchange->sendValues = ValueView("sendValues",sendSrc.size());
+   exchange->recvValues = ValueView("recvValues",recvDst.size());
+   exchange->sendBuffer = Teuchos::ArrayRCP<ScalarT>(sendSrc.size());
+   exchange->recvBuffer = Teuchos::ArrayRCP<ScalarT>(recvDst.size());
+   exchange->recvRequests.resize(exchange->recvProcs.size());
+
+   return exchange;
+}
+
+template <typename Traits,typename ScalarT,typename LocalOrdinalT,typename GlobalOrdinalT,typename NodeT>
+void 
+TpetraLinearObjFactory<Traits,ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>::
+postMatrixValueReceives(MatrixValueExchange & exchange) const
+{
+   if(exchange.recvPosted)
+      return;
+
+   for(std::size_t p=0;p<exchange.recvProcs.size();p++) {
+      const std::size_t begin = exchange.recvOffsets[p];
+      const std::size_t count = exchange.recvOffsets[p+1]-begin;
+      exchange.recvRequests[p] = Teuchos::ireceive<int,ScalarT>(exchange.recvBuffer.persistingView(begin,count),
+                                                                exchange.recvProcs[p],MatrixValueExchange::valueTag,*comm_);
+   }
+   exchange.recvPosted = true;
+}
+
 template <typename Traits,typename ScalarT,typename LocalOrdinalT,typename GlobalOrdinalT,typename NodeT>
 void 
 TpetraLinearObjFactory<Traits,ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>::
@@ -218,6 +487,33 @@ globalToGhostTpetraVector(const Tpetra::Vector<ScalarT,LocalOrdinalT,GlobalOrdin
    out.doImport(in,*importer,Tpetra::INSERT);
 }
 
+template <typename Traits,typename ScalarT,typename LocalOrdinalT,typename GlobalOrdinalT,typename NodeT>
+void 
+TpetraLinearObjFactory<Traits,ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>::
+beginGlobalToGhostTpetraVector(const Tpetra::Vector<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT> & in,
+                               Tpetra::Vector<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT> & out, bool col) const
+{
+   using Teuchos::RCP;
+
+   // post the global distribution, the importers are cached so the
+   // communication plan is reused from call to call
+   RCP<ImportType> importer = col ? getGhostedColImport() : getGhostedImport();
+   out.putScalar(0.0);
+   out.beginImport(in,*importer,Tpetra::INSERT);
+}
+
+template <typename Traits,typename ScalarT,typename LocalOrdinalT,typename GlobalOrdinalT,typename NodeT>
+void 
+TpetraLinearObjFactory<Traits,ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT>::
+endGlobalToGhostTpetraVector(const Tpetra::Vector<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT> & in,
+                             Tpetra::Vector<ScalarT,LocalOrdinalT,GlobalOrdinalT,NodeT> & out, bool col) const
+{
+   using Teuchos::RCP;
+
+   RCP<ImportType> importer = col ? getGhostedColImport() : getGhostedImport();
+   out.endImport(in,*importer,Tpetra::INSERT);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  buildReadOnlyDomainContainer()
@@ -723,7 +1019,15 @@ beginFill(LinearObjContainer & loc) const
 {
   ContainerType & tloc = Teuchos::dyn_cast<ContainerType>(loc);
   Teuchos::RCP<CrsMatrixType> A = tloc.get_A();
-  if(A!=Teuchos::null) 
+  if(A==Teuchos::null) 
+    return;
+
+  if(frozenGraph_ && A->isFillComplete()) {
+    // values are written in place, get ready for the contributions of other processes
+    if(matrixExchange_!=Teuchos::null && A->getCrsGraph().get()==matrixExchange_->ghostedGraph.get())
+      postMatrixValueReceives(*matrixExchange_);
+  }
+  else
     A->resumeFill();
 }
 
@@ -733,7 +1037,7 @@ endFill(LinearObjContainer & loc) const
 {
   ContainerType & tloc = Teuchos::dyn_cast<ContainerType>(loc);
   Teuchos::RCP<CrsMatrixType> A = tloc.get_A();
-  if(A!=Teuchos::null) 
+  if(A!=Teuchos::null && (!frozenGraph_ || A->isFillActive())) 
     A->fillComplete(A->getDomainMap(),A->getRangeMap());
 }
 
@@ -255,6 +255,14 @@ public:
    template <typename EvalT> 
    void evaluate(const panzer::AssemblyEngineInArgs& input_args);
 
+   /** Get the assembly engine that evaluates the responses for a particular
+     * evaluation type. This lets another engine sweep the response evaluators
+     * together with its own (see <code>AssemblyEngine::evaluate</code>).
+     */
+   template <typename EvalT>
+   Teuchos::RCP<AssemblyEngine<EvalT> > getAssemblyEngine()
+   { return ae_tm2_.template getAsObject<EvalT>(); }
+
    /** Print the contents of this response library.
      */
    void print(std::ostream & os) const;
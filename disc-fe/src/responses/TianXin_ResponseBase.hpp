@@ -48,6 +48,7 @@
 
 #include "Teuchos_RCP.hpp"
 #include "Teuchos_DefaultComm.hpp"
+#include "Teuchos_CommHelpers.hpp"
 
 #include "Tpetra_Map.hpp"
 #include "Tpetra_Vector.hpp"
@@ -55,10 +56,12 @@
 
 #include "Panzer_Traits.hpp"
 #include "Panzer_LinearObjFactory.hpp"
+#include "Panzer_GlobalEvaluationDataContainer.hpp"
 
 #include "TianXin_WorksetFunctor.hpp"
 #include "TianXin_Factory.hpp"
 #include "TianXin_TemplateTypeContainer.hpp"
+#include "TianXin_ResponseReduction.hpp"
 
 namespace TianXin {
 	
@@ -119,6 +122,29 @@ public:
 	virtual std::size_t localSizeRequired() const =0;
 	
 	virtual bool isDistributed() const =0;
+
+	//! Number of values this response sums over all processes
+	virtual std::size_t reductionSize() const { return 0; }
+
+	/** Sum this response through <code>reduction</code>, in the slot <code>name</code>.
+	  * Call this at setup, before <code>ResponseReduction::setupSlots</code>.
+	  */
+	void setReduction(const Teuchos::RCP<ResponseReduction> & reduction, const std::string & name)
+	{
+		if(reduction_!=Teuchos::null)
+			reduction_->removeCallbacks(this);
+		reduction_ = reduction;
+		reductionName_ = name;
+		reduction_->registerResponse(name,this->reductionSize(),
+		                             [this](const double * global) { this->finishReduction(global); },this);
+	}
+
+	//! The reduction outlives the field managers, it must not call back into a deleted response
+	virtual ~ResponseBase()
+	{
+		if(reduction_!=Teuchos::null)
+			reduction_->removeCallbacks(this);
+	}
 	
    //! Get the vector space for this response, vector space is constructed lazily.
    Teuchos::RCP< const Tpetra::Map<int> > getMap() const final {
@@ -151,6 +177,32 @@ protected:
    Teuchos::RCP<const Teuchos::Comm<int> > tComm_;
    Teuchos::RCP<const map_type >  tMap_;
    Teuchos::RCP<vector_type > tVector_;
+
+   /** Sum the process local values of this response over all processes. With a
+     * reduction (see <code>setReduction</code>) the sum is deferred to the scatter
+     * phase of the assembly, otherwise it is one blocking reduction right here.
+     * Either way <code>finishReduction</code> receives the result. Call this from
+     * postEvaluate.
+     */
+   void reduce(const double * local)
+   {
+      if(reduction_!=Teuchos::null) {
+         reduction_->contribute(reductionName_,local,this->reductionSize());
+         return;
+      }
+
+      const std::size_t size = this->reductionSize();
+      std::vector<double> global(size,0.0);
+      Teuchos::reduceAll<int,double>(*tComm_,Teuchos::REDUCE_SUM,static_cast<int>(size),local,global.data());
+      this->finishReduction(global.data());
+   }
+
+   //! Receives the values of this response summed over all processes
+   virtual void finishReduction(const double * /* global */) {}
+
+private:
+   Teuchos::RCP<ResponseReduction> reduction_;
+   std::string reductionName_;
    
 public:
    virtual const PHX::FieldTag & getFieldTag() const = 0;
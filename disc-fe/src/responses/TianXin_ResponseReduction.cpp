@@ -0,0 +1,193 @@
+// @HEADER
+// ***********************************************************************
+//
+//           TianXin: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2022) YUAN Xi
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ***********************************************************************
+
+#include "TianXin_ResponseReduction.hpp"
+
+#include <algorithm>
+
+#include "Teuchos_Assert.hpp"
+#include "Teuchos_CommHelpers.hpp"
+
+namespace TianXin {
+
+ResponseReduction::
+ResponseReduction(const Teuchos::RCP<const Teuchos::Comm<int> > & comm)
+: comm_(comm), setup_(false), local_("TianXin::ResponseReduction::local",0), global_("TianXin::ResponseReduction::global",0)
+{
+	TEUCHOS_ASSERT(comm_!=Teuchos::null);
+}
+
+void ResponseReduction::
+registerResponse(const std::string & name, std::size_t size, const Callback & finish, const void * owner)
+{
+	TEUCHOS_TEST_FOR_EXCEPTION(setup_,std::logic_error,
+	                           "TianXin::ResponseReduction::registerResponse: cannot register \"" << name << "\" "
+	                           "after setupSlots().");
+
+	const auto itr = slots_.insert(std::make_pair(name,Slot{0,0,{},false})).first;
+	itr->second.size = std::max(itr->second.size,size);
+	if( finish )
+		itr->second.finish.push_back(std::make_pair(owner,finish));
+}
+
+void ResponseReduction::
+removeCallbacks(const void * owner)
+{
+	for(auto & slot : slots_) {
+		std::vector<std::pair<const void *,Callback> > & finish = slot.second.finish;
+		finish.erase(std::remove_if(finish.begin(),finish.end(),
+		                            [owner](const std::pair<const void *,Callback> & f) { return f.first==owner; }),
+		             finish.end());
+	}
+}
+
+void ResponseReduction::
+setupSlots()
+{
+	TEUCHOS_TEST_FOR_EXCEPTION(setup_,std::logic_error,
+	                           "TianXin::ResponseReduction::setupSlots: the slots are already set up.");
+
+	// the slots are sorted by name, so all processes agree on the layout if they
+	// agree on the names. Compare their count and a hash (FNV-1a) of the names.
+	unsigned long long hash = 14695981039346656037ull;
+	for(const auto & slot : slots_) {
+		for(const char c : slot.first) {
+			hash ^= static_cast<unsigned char>(c);
+			hash *= 1099511628211ull;
+		}
+		hash ^= 0xffull;
+		hash *= 1099511628211ull;
+	}
+	const long long count = static_cast<long long>(slots_.size());
+	const long long key = static_cast<long long>(hash & 0x7fffffffffffffffull);
+	const long long local[4] = { count, key, -count, -key };
+	long long global[4];
+	Teuchos::reduceAll<int,long long>(*comm_,Teuchos::REDUCE_MAX,4,local,global);
+	TEUCHOS_TEST_FOR_EXCEPTION(global[0]!=-global[2] || global[1]!=-global[3],std::logic_error,
+	                           "TianXin::ResponseReduction::setupSlots: the processes registered different responses.");
+
+	// a process without cells of a response may not know its size
+	if( !slots_.empty() ) {
+		std::vector<long long> sizes, maxSizes(slots_.size());
+		for(const auto & slot : slots_)
+			sizes.push_back(static_cast<long long>(slot.second.size));
+		Teuchos::reduceAll<int,long long>(*comm_,Teuchos::REDUCE_MAX,static_cast<int>(sizes.size()),sizes.data(),maxSizes.data());
+
+		std::size_t offset = 0, i = 0;
+		for(auto & slot : slots_) {
+			slot.second.offset = offset;
+			slot.second.size = static_cast<std::size_t>(maxSizes[i++]);
+			offset += slot.second.size;
+		}
+
+		Kokkos::resize(local_,offset);
+		Kokkos::resize(global_,offset);
+		Kokkos::deep_copy(local_,0.0);
+	}
+
+	setup_ = true;
+}
+
+void ResponseReduction::
+contribute(const std::string & name, const double * values, std::size_t size)
+{
+	TEUCHOS_TEST_FOR_EXCEPTION(!setup_,std::logic_error,
+	                           "TianXin::ResponseReduction::contribute: setupSlots() was not called.");
+	TEUCHOS_TEST_FOR_EXCEPTION(request_!=nullptr,std::logic_error,
+	                           "TianXin::ResponseReduction::contribute: the reduction was already posted.");
+
+	const auto itr = slots_.find(name);
+	TEUCHOS_TEST_FOR_EXCEPTION(itr==slots_.end(),std::logic_error,
+	                           "TianXin::ResponseReduction::contribute: no slot \"" << name << "\" was registered.");
+
+	Slot & s = itr->second;
+	TEUCHOS_TEST_FOR_EXCEPTION(size>s.size,std::logic_error,
+	                           "TianXin::ResponseReduction::contribute: " << size << " values for slot \"" << name << "\" "
+	                           "of size " << s.size << ".");
+	for(std::size_t i=0;i<size;++i)
+		local_(s.offset+i) += values[i];
+	s.contributed = true;
+}
+
+void ResponseReduction::
+beginReduction()
+{
+	// every process has the same slots, so they all take part, contributions or not
+	if( slots_.empty() || request_!=nullptr )
+		return;
+
+	TEUCHOS_TEST_FOR_EXCEPTION(!setup_,std::logic_error,
+	                           "TianXin::ResponseReduction::beginReduction: setupSlots() was not called.");
+
+	request_ = Tpetra::Details::iallreduce(local_,global_,Teuchos::REDUCE_SUM,*comm_);
+}
+
+void ResponseReduction::
+endReduction()
+{
+	if( slots_.empty() )
+		return;
+
+	beginReduction();
+	request_->wait();
+	request_ = nullptr;
+
+	// a response that did not evaluate keeps its previous value
+	for(auto & slot : slots_) {
+		Slot & s = slot.second;
+		if( !s.contributed )
+			continue;
+		for(const auto & finish : s.finish)
+			finish.second(global_.data()+s.offset);
+		s.contributed = false;
+	}
+}
+
+void ResponseReduction::
+initializeData()
+{
+	// an abandoned reduction has to complete before its buffers are reused
+	if( request_!=nullptr ) {
+		request_->wait();
+		request_ = nullptr;
+	}
+
+	Kokkos::deep_copy(local_,0.0);
+	for(auto & slot : slots_)
+		slot.second.contributed = false;
+}
+
+}
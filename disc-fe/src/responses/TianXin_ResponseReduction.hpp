@@ -0,0 +1,144 @@
+// @HEADER
+// ***********************************************************************
+//
+//           TianXin: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2022) YUAN Xi
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ***********************************************************************
+
+#ifndef __TianXin_ResponseReduction_hpp__
+#define __TianXin_ResponseReduction_hpp__
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_Comm.hpp"
+
+#include "Kokkos_Core.hpp"
+
+#include "Tpetra_Details_iallreduce.hpp"
+
+#include "Panzer_GlobalEvaluationData.hpp"
+
+namespace TianXin {
+
+/* Collects the process-local values of the responses evaluated in one assembly
+   and sums them over the communicator with a single non-blocking allreduce.
+   Usage: 0. at setup every process registers every response slot by name, also
+             the slots of responses it owns no cells of, then calls setupSlots()
+             (collective) which lays the slots out in name order
+          1. a response adds its local values to its slot in postEvaluate
+          2. AssemblyEngine::evaluateResponse calls beginReduction() once all response
+             field managers are done. It is posted on every process, whether or not
+             it contributed anything, and never without slots.
+          3. ghostToGlobal() (scatter phase) waits and hands every response that
+             contributed since initializeData() its global values
+*/
+class ResponseReduction : public panzer::GlobalEvaluationData {
+public:
+	typedef std::function<void(const double *)> Callback;
+
+	ResponseReduction(const Teuchos::RCP<const Teuchos::Comm<int> > & comm);
+
+	/** Register a slot before setupSlots(). Registering a name again keeps one
+	  * slot, the largest size and every callback.
+	  *
+	  * \param[in] name Identifies the slot, the same on every process
+	  * \param[in] size Number of values, e.g. a value and its derivatives. A
+	  *                 process without the response may pass zero.
+	  * \param[in] finish Called with the global values once the reduction completes
+	  * \param[in] owner Identifies <code>finish</code> for removeCallbacks(), e.g. the
+	  *                  response it calls back into
+	  */
+	void registerResponse(const std::string & name, std::size_t size, const Callback & finish = Callback(),
+	                      const void * owner = nullptr);
+
+	//! Drop the callbacks registered by <code>owner</code>, the slots stay
+	void removeCallbacks(const void * owner);
+
+	/** Lay the registered slots out in name order, with sizes agreed on by all
+	  * processes. Collective, throws if the processes registered different names.
+	  */
+	void setupSlots();
+
+	bool isSetup() const
+	{ return setup_; }
+
+	/** Add process local values to a slot.
+	  *
+	  * \param[in] size Number of <code>values</code>, at most the size of the slot. The
+	  *                 slot is as large as the largest registration on any process,
+	  *                 values missing on this process count as zero.
+	  */
+	void contribute(const std::string & name, const double * values, std::size_t size);
+
+	//! Post the allreduce of everything contributed since initializeData()
+	void beginReduction();
+
+	//! Wait for the allreduce and run the callbacks of the slots contributed to
+	void endReduction();
+
+	std::size_t numResponses() const
+	{ return slots_.size(); }
+
+	//! Number of values in one reduction
+	std::size_t size() const
+	{ return local_.extent(0); }
+
+	virtual void ghostToGlobal(int /* mem */)
+	{ endReduction(); }
+
+	virtual void globalToGhost(int /* mem */) {}
+
+	virtual void initializeData();
+
+private:
+	struct Slot {
+		std::size_t offset, size;
+		std::vector<std::pair<const void *,Callback> > finish;
+		bool contributed;
+	};
+
+	Teuchos::RCP<const Teuchos::Comm<int> > comm_;
+	bool setup_;
+	std::map<std::string,Slot> slots_;
+
+	Kokkos::View<double*,Kokkos::HostSpace> local_, global_;
+	std::shared_ptr<Tpetra::Details::CommRequest> request_;
+};
+
+}
+
+#endif
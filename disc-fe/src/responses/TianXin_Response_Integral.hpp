@@ -60,13 +60,16 @@ public:
     Response_Integral(const Teuchos::ParameterList& plist);
 	 
 	void postRegistrationSetup(typename Traits::SetupData d,PHX::FieldManager<Traits>& fm);
+	void preEvaluate(typename Traits::PreEvalData d);
 	void evaluateFields(typename Traits::EvalData d);
+	void postEvaluate(typename Traits::PostEvalData d);
 	
 	//! provide direct access of result integral
     PHX::MDField<ScalarT> value_;
 	
 	virtual std::size_t localSizeRequired() const final { return 1; }
 	virtual bool isDistributed() const final {return false;}
+	virtual std::size_t reductionSize() const final { return 1; }
 
 private:
 	//std::string response_name;
@@ -77,6 +80,11 @@ private:
 	std::size_t num_cell, num_qp;
 	int quad_order, quad_index;
 	
+	//! process local integral, summed on the device over the worksets of an evaluation
+	Kokkos::View<double,PHX::Device> worksetSum_, localSum_;
+	
+	void finishReduction(const double * global) final;
+	
 public:
   const PHX::FieldTag & getFieldTag() const
   { return value_.fieldTag(); }
@@ -95,13 +103,16 @@ public:
     Response_Integral(const Teuchos::ParameterList& plist);
 	 
 	void postRegistrationSetup(typename Traits::SetupData d,PHX::FieldManager<Traits>& fm);
+	void preEvaluate(typename Traits::PreEvalData d);
 	void evaluateFields(typename Traits::EvalData d);
+	void postEvaluate(typename Traits::PostEvalData d);
 	
 	//! provide direct access of result integral
     PHX::MDField<double> value_;
 	
 	virtual std::size_t localSizeRequired() const final { return 1; }
 	virtual bool isDistributed() const final {return false;}
+	virtual std::size_t reductionSize() const final { return 1; }
 
 private:
 	//std::string response_name;
@@ -114,6 +125,11 @@ private:
 	
 	std::vector<Teuchos::RCP<const panzer::GlobalIndexer> > ugis_;
 	
+	//! process local integral, summed on the device over the worksets of an evaluation
+	Kokkos::View<double,PHX::Device> worksetSum_, localSum_;
+	
+	void finishReduction(const double * global) final;
+	
 public:
   const PHX::FieldTag & getFieldTag() const
   { return value_.fieldTag(); }
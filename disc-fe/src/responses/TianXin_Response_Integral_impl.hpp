@@ -81,6 +81,9 @@ Response_Integral(const Teuchos::ParameterList& plist)
 
 	std::string n = "Integral Response " + this->response_name;
 	this->setName(n);
+
+	worksetSum_ = Kokkos::View<double,PHX::Device>("TianXin::Response_Integral::worksetSum");
+	localSum_ = Kokkos::View<double,PHX::Device>("TianXin::Response_Integral::localSum");
 	
 	// ResponseBase related
 	const std::size_t num_non_zero = 1;
@@ -103,31 +106,56 @@ postRegistrationSetup( typename Traits::SetupData sd,
   
 }
 
+template<typename EvalT, typename Traits>
+void Response_Integral<EvalT,Traits>::
+preEvaluate(typename Traits::PreEvalData /* d */)
+{
+	Kokkos::deep_copy(localSum_,0.0);
+}
+
 template<typename EvalT, typename Traits>
 void Response_Integral<EvalT,Traits>::
 evaluateFields(typename Traits::EvalData workset)
-{//std::cout << this->tComm_->getRank() << "," << workset.num_cells << "   enter\n";
-	double result = 0.0;
+{
     if( num_cell>0 ) {
 		const auto wm = workset.int_rules[quad_index]->weighted_measure;
+		const auto cellvalue = cellvalue_;
+		const std::size_t nqp = num_qp;
+		const auto worksetSum = worksetSum_;
+		const auto localSum = localSum_;
+		// reducing into device views keeps the host from waiting on every workset
 		Kokkos::parallel_reduce("IntegratorScalar", workset.num_cells, KOKKOS_LAMBDA (int cell, double& v) {
 			double cell_integral = 0.0;
-			for (std::size_t qp = 0; qp < num_qp; ++qp) {
-				cell_integral += cellvalue_(cell, qp)*wm(cell, qp);
+			for (std::size_t qp = 0; qp < nqp; ++qp) {
+				cell_integral += cellvalue(cell, qp)*wm(cell, qp);
 			}
 			v += cell_integral;
-		}, result );
-		Kokkos::fence();
+		}, worksetSum );
+		Kokkos::parallel_for("IntegratorScalar::accumulate", 1, KOKKOS_LAMBDA (int) {
+			localSum() += worksetSum();
+		});
 	}
+}
 
-	double glbValue = 0.0;
-    Teuchos::reduceAll(*(this->tComm_), Teuchos::REDUCE_SUM, 1, &result, &glbValue);
-	this->value_ .deep_copy(glbValue);
+template<typename EvalT, typename Traits>
+void Response_Integral<EvalT,Traits>::
+postEvaluate(typename Traits::PostEvalData /* d */)
+{
+	double result = 0.0;
+	Kokkos::deep_copy(result,localSum_);
+	this->reduce(&result);
+}
+
+template<typename EvalT, typename Traits>
+void Response_Integral<EvalT,Traits>::
+finishReduction(const double * global)
+{
+	this->value_ .deep_copy(global[0]);
 	if( this->tVector_==Teuchos::null ) 
 		TEUCHOS_TEST_FOR_EXCEPTION(this->tVector_==Teuchos::null,std::logic_error,
                             "TianXin::Response_Integral: reponse vector not defined. "
                             "Please call setVector() before calling this method");
-	Teuchos::rcp_dynamic_cast<Tpetra::Vector<double, int, panzer::GlobalOrdinal>>(this->tVector_)->sumIntoLocalValue(0, glbValue);
+	Teuchos::rcp_dynamic_cast<Tpetra::Vector<double, int, panzer::GlobalOrdinal>>(this->tVector_)->sumIntoLocalValue(0, global[0]);
 }
 
 // **************************************************************
@@ -162,6 +190,9 @@ Response_Integral(const Teuchos::ParameterList& plist)
 
 	std::string n = "Integral Response " + this->response_name;
 	this->setName(n);
+
+	worksetSum_ = Kokkos::View<double,PHX::Device>("TianXin::Response_Integral::worksetSum");
+	localSum_ = Kokkos::View<double,PHX::Device>("TianXin::Response_Integral::localSum");
 	
 	// ResponseBase related
 	const std::size_t num_non_zero = 1;
@@ -183,6 +214,13 @@ postRegistrationSetup( typename Traits::SetupData sd,
   }
 }
 
+template<typename Traits>
+void Response_Integral<panzer::Traits::Jacobian,Traits>::
+preEvaluate(typename Traits::PreEvalData /* d */)
+{
+	Kokkos::deep_copy(localSum_,0.0);
+}
+
 template<typename Traits>
 void Response_Integral<panzer::Traits::Jacobian,Traits>::
 evaluateFields(typename Traits::EvalData workset)
@@ -216,21 +254,38 @@ evaluateFields(typename Traits::EvalData workset)
 		}
 	}
 
-	double result = 0.0;
+	const auto cellvalue = cellvalue_;
+	const std::size_t nqp = num_qp;
+	const auto worksetSum = worksetSum_;
+	const auto localSum = localSum_;
 	Kokkos::parallel_reduce("IntegratorScalar", workset.num_cells, KOKKOS_LAMBDA (int cell, double& v) {
 		ScalarT cell_integral = 0.0;
-		for (std::size_t qp = 0; qp < num_qp; ++qp) {
-			cell_integral += cellvalue_(cell, qp)*wm(cell, qp);
+		for (std::size_t qp = 0; qp < nqp; ++qp) {
+			cell_integral += cellvalue(cell, qp)*wm(cell, qp);
 		}
 		v += cell_integral.val();
-	}, result );
-	Kokkos::fence();
+	}, worksetSum );
+	Kokkos::parallel_for("IntegratorScalar::accumulate", 1, KOKKOS_LAMBDA (int) {
+		localSum() += worksetSum();
+	});
+}
 
-	double glbValue = 0.0;
-    Teuchos::reduceAll<int,double>(*(this->tComm_), Teuchos::REDUCE_SUM, static_cast<Thyra::Ordinal>(1), &result,&glbValue);
-	this->value_ .deep_copy(glbValue);
+template<typename Traits>
+void Response_Integral<panzer::Traits::Jacobian,Traits>::
+postEvaluate(typename Traits::PostEvalData /* d */)
+{
+	double result = 0.0;
+	Kokkos::deep_copy(result,localSum_);
+	this->reduce(&result);
+}
+
+template<typename Traits>
+void Response_Integral<panzer::Traits::Jacobian,Traits>::
+finishReduction(const double * global)
+{
+	this->value_ .deep_copy(global[0]);
 	
-	//Teuchos::rcp_dynamic_cast<Tpetra::Vector<double, int, panzer::GlobalOrdinal>>(this->tVector_)->sumIntoLocalValue(0, glbValue);
+	//Teuchos::rcp_dynamic_cast<Tpetra::Vector<double, int, panzer::GlobalOrdinal>>(this->tVector_)->sumIntoLocalValue(0, global[0]);
 }
 
 }
@@ -257,7 +257,7 @@ namespace panzer {
     auto grad_basis_ref_host = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),basis_values.grad_basis_ref.get_view());
     auto weighted_basis_scalar_host = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),basis_values.weighted_basis_scalar.get_view());
     auto grad_basis_host = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),basis_values.grad_basis.get_view());
-    auto weighted_grad_basis_host = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),basis_values.weighted_grad_basis.get_view());
+    auto weighted_grad_basis_host = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),basis_values.getGradBasisValues(true).get_view());
     auto jac_det_host = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),int_values.jac_det.get_view());
     for(int i=0;i<num_qp;i++) {
        double x = cub_points_host(i,0);
@@ -821,12 +821,8 @@ namespace panzer {
     TEST_EQUALITY(basis_values.grad_basis.fieldTag().dataLayout().extent(3),2);
     TEST_EQUALITY(basis_values.grad_basis.fieldTag().name(),"prefix_grad_basis");
 
-    TEST_EQUALITY(basis_values.weighted_grad_basis.fieldTag().dataLayout().rank(),4);
-    TEST_EQUALITY(basis_values.weighted_grad_basis.fieldTag().dataLayout().extent_int(0),num_cells);
-    TEST_EQUALITY(basis_values.weighted_grad_basis.fieldTag().dataLayout().extent(1),9);
-    TEST_EQUALITY(basis_values.weighted_grad_basis.fieldTag().dataLayout().extent(2),num_qp);
-    TEST_EQUALITY(basis_values.weighted_grad_basis.fieldTag().dataLayout().extent(3),2);
-    TEST_EQUALITY(basis_values.weighted_grad_basis.fieldTag().name(),"prefix_weighted_grad_basis");
+    // the weighted gradients are only built by getGradBasisValues(true)
+    TEST_EQUALITY(basis_values.weighted_grad_basis.size(),0);
 
     // check coordinates
     TEST_EQUALITY(basis_values.basis_coordinates_ref.fieldTag().dataLayout().rank(),2);
@@ -902,12 +898,8 @@ namespace panzer {
     TEST_EQUALITY(basis_values.grad_basis.fieldTag().dataLayout().extent(3),2);
     TEST_EQUALITY(basis_values.grad_basis.fieldTag().name(),"prefix_grad_basis");
 
-    TEST_EQUALITY(basis_values.weighted_grad_basis.fieldTag().dataLayout().rank(),4);
-    TEST_EQUALITY(basis_values.weighted_grad_basis.fieldTag().dataLayout().extent_int(0),num_cells);
-    TEST_EQUALITY(basis_values.weighted_grad_basis.fieldTag().dataLayout().extent(1),9);
-    TEST_EQUALITY(basis_values.weighted_grad_basis.fieldTag().dataLayout().extent(2),num_qp);
-    TEST_EQUALITY(basis_values.weighted_grad_basis.fieldTag().dataLayout().extent(3),2);
-    TEST_EQUALITY(basis_values.weighted_grad_basis.fieldTag().name(),"prefix_weighted_grad_basis");
+    // the weighted gradients are only built by getGradBasisValues(true)
+    TEST_EQUALITY(basis_values.weighted_grad_basis.size(),0);
 
     // check coordinates
     TEST_EQUALITY(basis_values.basis_coordinates_ref.fieldTag().dataLayout().rank(),2);
@@ -0,0 +1,220 @@
+// @HEADER
+// ***********************************************************************
+//
+//           TianXin: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2022) YUAN Xi
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ***********************************************************************
+// @HEADER
+
+#include <Teuchos_ConfigDefs.hpp>
+#include <Teuchos_UnitTestHarness.hpp>
+#include <Teuchos_RCP.hpp>
+#include <Teuchos_DefaultComm.hpp>
+
+#include "Kokkos_Core.hpp"
+
+#include "TianXin_ResponseReduction.hpp"
+
+namespace TianXin {
+
+    TEUCHOS_UNIT_TEST(response_reduction, batched_sum)
+    {
+        Teuchos::RCP<const Teuchos::Comm<int> > comm = Teuchos::DefaultComm<int>::getComm();
+        const int numProcs = comm->getSize();
+        const int rank = comm->getRank();
+
+        ResponseReduction reduction(comm);
+
+        // a scalar response and one carrying two derivatives
+        std::vector<double> valueA, valueB;
+        reduction.registerResponse("A",1,[&](const double * g) { valueA.assign(g,g+1); });
+        reduction.registerResponse("B",3,[&](const double * g) { valueB.assign(g,g+3); });
+
+        // registering again keeps one slot
+        reduction.registerResponse("A",1);
+        reduction.setupSlots();
+        TEST_ASSERT(reduction.isSetup());
+        TEST_EQUALITY(reduction.numResponses(),2);
+        TEST_EQUALITY(reduction.size(),4);
+
+        for(int evaluation=0;evaluation<2;++evaluation) {
+          reduction.initializeData();
+
+          // two worksets contribute to A
+          const double contribA = rank+1.0;
+          reduction.contribute("A",&contribA,1);
+          reduction.contribute("A",&contribA,1);
+
+          const double contribB[3] = { 1.0, double(rank), -1.0 };
+          reduction.contribute("B",contribB,3);
+
+          reduction.beginReduction();
+          reduction.ghostToGlobal(0);
+
+          TEST_EQUALITY(valueA.size(),1);
+          TEST_EQUALITY(valueB.size(),3);
+          TEST_FLOATING_EQUALITY(valueA[0],double(numProcs*(numProcs+1)),1e-14);
+          TEST_FLOATING_EQUALITY(valueB[0],double(numProcs),1e-14);
+          TEST_FLOATING_EQUALITY(valueB[1]+1.0,double(numProcs*(numProcs-1)/2)+1.0,1e-14);
+          TEST_FLOATING_EQUALITY(valueB[2],-double(numProcs),1e-14);
+        }
+    }
+
+    TEUCHOS_UNIT_TEST(response_reduction, process_without_cells)
+    {
+        Teuchos::RCP<const Teuchos::Comm<int> > comm = Teuchos::DefaultComm<int>::getComm();
+        const int numProcs = comm->getSize();
+        const int rank = comm->getRank();
+
+        ResponseReduction reduction(comm);
+
+        // Process 0 owns no cells of "right", the last process none of "left". Such a
+        // process registers the slot without a size or callback, and the processes
+        // register in different orders.
+        std::vector<double> left, right;
+        const bool ownsLeft = rank!=numProcs-1 || numProcs==1;
+        const bool ownsRight = rank!=0 || numProcs==1;
+        if(rank%2==0) {
+          reduction.registerResponse("right",ownsRight ? 2 : 0);
+          reduction.registerResponse("left",ownsLeft ? 1 : 0);
+        }
+        else {
+          reduction.registerResponse("left",ownsLeft ? 1 : 0);
+          reduction.registerResponse("right",ownsRight ? 2 : 0);
+        }
+        if(ownsLeft)
+          reduction.registerResponse("left",1,[&](const double * g) { left.assign(g,g+1); });
+        if(ownsRight)
+          reduction.registerResponse("right",2,[&](const double * g) { right.assign(g,g+2); });
+
+        reduction.setupSlots();
+        TEST_EQUALITY(reduction.numResponses(),2);
+        TEST_EQUALITY(reduction.size(),3);
+
+        const int numLeft = numProcs==1 ? 1 : numProcs-1;
+        const int numRight = numProcs==1 ? 1 : numProcs-1;
+
+        reduction.initializeData();
+        if(ownsLeft) {
+          const double contrib = 1.0;
+          reduction.contribute("left",&contrib,1);
+        }
+        if(ownsRight) {
+          const double contrib[2] = { 2.0, -1.0 };
+          reduction.contribute("right",contrib,2);
+        }
+
+        // every process posts, whether or not it contributed
+        reduction.beginReduction();
+        reduction.ghostToGlobal(0);
+
+        TEST_EQUALITY(left.size(),ownsLeft ? 1 : 0);
+        TEST_EQUALITY(right.size(),ownsRight ? 2 : 0);
+        if(ownsLeft)
+          TEST_FLOATING_EQUALITY(left[0],double(numLeft),1e-14);
+        if(ownsRight) {
+          TEST_FLOATING_EQUALITY(right[0],2.0*numRight,1e-14);
+          TEST_FLOATING_EQUALITY(right[1],-1.0*numRight,1e-14);
+        }
+
+        // an evaluation without any contribution still completes, the values are kept
+        left.clear();
+        reduction.initializeData();
+        reduction.beginReduction();
+        reduction.ghostToGlobal(0);
+        TEST_EQUALITY(left.size(),0);
+    }
+
+    TEUCHOS_UNIT_TEST(response_reduction, removed_callbacks)
+    {
+        Teuchos::RCP<const Teuchos::Comm<int> > comm = Teuchos::DefaultComm<int>::getComm();
+
+        ResponseReduction reduction(comm);
+
+        // two owners share a slot, the first one goes away before the evaluation
+        int first = 0, second = 0;
+        reduction.registerResponse("A",1,[&](const double *) { ++first; },&first);
+        reduction.registerResponse("A",1,[&](const double *) { ++second; },&second);
+        reduction.setupSlots();
+
+        reduction.removeCallbacks(&first);
+
+        reduction.initializeData();
+        const double contrib = 1.0;
+        reduction.contribute("A",&contrib,1);
+        reduction.beginReduction();
+        reduction.ghostToGlobal(0);
+
+        TEST_EQUALITY(first,0);
+        TEST_EQUALITY(second,1);
+        TEST_EQUALITY(reduction.numResponses(),1);
+    }
+
+    TEUCHOS_UNIT_TEST(response_reduction, short_contribution)
+    {
+        Teuchos::RCP<const Teuchos::Comm<int> > comm = Teuchos::DefaultComm<int>::getComm();
+        const int numProcs = comm->getSize();
+
+        // only the first process knows the slot has three values
+        ResponseReduction reduction(comm);
+        std::vector<double> value;
+        reduction.registerResponse("A",comm->getRank()==0 ? 3 : 1,[&](const double * g) { value.assign(g,g+3); });
+        reduction.setupSlots();
+        TEST_EQUALITY(reduction.size(),3);
+
+        // a shorter buffer is padded with zeros, a longer one is refused
+        reduction.initializeData();
+        const double contrib[4] = { 1.0, 2.0, 3.0, 4.0 };
+        TEST_THROW(reduction.contribute("A",contrib,4),std::logic_error);
+        reduction.contribute("A",contrib,comm->getRank()==0 ? 3 : 1);
+        reduction.beginReduction();
+        reduction.ghostToGlobal(0);
+
+        TEST_EQUALITY(value.size(),3);
+        TEST_FLOATING_EQUALITY(value[0],double(numProcs),1e-14);
+        TEST_FLOATING_EQUALITY(value[1],2.0,1e-14);
+        TEST_FLOATING_EQUALITY(value[2],3.0,1e-14);
+    }
+
+    TEUCHOS_UNIT_TEST(response_reduction, mismatched_registration)
+    {
+        Teuchos::RCP<const Teuchos::Comm<int> > comm = Teuchos::DefaultComm<int>::getComm();
+        if(comm->getSize()<2)
+          return;
+
+        // every process sees the mismatch, so all of them throw
+        ResponseReduction reduction(comm);
+        reduction.registerResponse(comm->getRank()==0 ? "A" : "B",1);
+        TEST_THROW(reduction.setupSlots(),std::logic_error);
+    }
+
+}
@@ -0,0 +1,222 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#include <Teuchos_ConfigDefs.hpp>
+#include <Teuchos_UnitTestHarness.hpp>
+#include <Teuchos_RCP.hpp>
+
+#include <cmath>
+
+#include "Panzer_CellData.hpp"
+#include "Panzer_IntegrationRule.hpp"
+#include "Panzer_IntegrationValues2.hpp"
+#include "Panzer_BasisIRLayout.hpp"
+#include "Panzer_BasisValues2.hpp"
+#include "Panzer_TensorProductBasis.hpp"
+#include "Panzer_CommonArrayFactories.hpp"
+#include "Panzer_Traits.hpp"
+
+using Teuchos::RCP;
+using Teuchos::rcp;
+using panzer::IntegrationRule;
+
+namespace panzer {
+
+  // Integration and basis values on a row of distorted quadrilaterals or
+  // hexahedra.
+  struct TensorProductFixture {
+    RCP<IntegrationRule> int_rule;
+    RCP<IntegrationValues2<double> > int_values;
+    RCP<BasisValues2<double> > basis_values;
+
+    TensorProductFixture(const int dim,const int num_cells,const int basis_order)
+    {
+      RCP<shards::CellTopology> topo;
+      if(dim==2)
+        topo = rcp(new shards::CellTopology(shards::getCellTopologyData< shards::Quadrilateral<4> >()));
+      else
+        topo = rcp(new shards::CellTopology(shards::getCellTopologyData< shards::Hexahedron<8> >()));
+
+      const panzer::CellData cell_data(num_cells,topo);
+      int_rule = rcp(new IntegrationRule(2*basis_order,cell_data));
+
+      int_values = rcp(new IntegrationValues2<double>("prefix_",true));
+      int_values->setupArrays(int_rule);
+
+      const int num_vertices = topo->getNodeCount();
+      panzer::MDFieldArrayFactory af("prefix_",true);
+      PHX::MDField<double,Cell,NODE,Dim> node_coordinates
+        = af.buildStaticArray<double,Cell,NODE,Dim>("nc",num_cells,num_vertices,dim);
+
+      // unit cells along x, with every vertex perturbed so the geometry is
+      // not affine
+      const double ref[8][3] = {{0,0,0},{1,0,0},{1,1,0},{0,1,0},
+                                {0,0,1},{1,0,1},{1,1,1},{0,1,1}};
+      auto node_coordinates_host = Kokkos::create_mirror_view(node_coordinates.get_static_view());
+      for(int cell=0;cell<num_cells;cell++) {
+        for(int v=0;v<num_vertices;v++) {
+          for(int d=0;d<dim;d++) {
+            const double shift = (d==0) ? cell : 0.0;
+            node_coordinates_host(cell,v,d) = ref[v][d] + shift + 0.1*std::sin(1.0+cell+3.0*v+7.0*d);
+          }
+        }
+      }
+      Kokkos::deep_copy(node_coordinates.get_static_view(),node_coordinates_host);
+
+      int_values->evaluateValues(node_coordinates);
+
+      RCP<panzer::BasisIRLayout> basis = rcp(new panzer::BasisIRLayout("HGrad",basis_order,*int_rule));
+      basis_values = rcp(new BasisValues2<double>("",true,true));
+      basis_values->setupArrays(basis);
+      basis_values->evaluateValues(int_values->cub_points,
+                                   int_values->jac,
+                                   int_values->jac_det,
+                                   int_values->jac_inv,
+                                   int_values->weighted_measure,
+                                   node_coordinates);
+    }
+  };
+
+  void testTensorProductBasis(const int dim,const int basis_order,
+                              Teuchos::FancyOStream & out,bool & success)
+  {
+    const int num_cells = 3;
+    TensorProductFixture fix(dim,num_cells,basis_order);
+
+    TEST_ASSERT(TensorProductBasis::isSupported("HGrad",*fix.int_rule));
+    TensorProductBasis tp("HGrad",basis_order,*fix.int_values);
+
+    const int num_basis = fix.basis_values->grad_basis.extent(1);
+    const int num_qp = fix.int_rule->num_points;
+    TEST_EQUALITY(tp.numBasis(),num_basis);
+    TEST_EQUALITY(tp.numPoints(),num_qp);
+    TEST_EQUALITY(tp.dimension(),dim);
+
+    PHX::View<double**> coeffs("coeffs",num_cells,num_basis);
+    PHX::View<double***> flux("flux",num_cells,num_qp,dim);
+    PHX::View<double***> ref_flux("ref_flux",num_cells,num_qp,dim);
+    PHX::View<double***> grad("grad",num_cells,num_qp,dim);
+    PHX::View<double**> residual("residual",num_cells,num_basis);
+    PHX::View<double**> scratch("scratch",num_cells,tp.scratchSize());
+
+    auto coeffs_host = Kokkos::create_mirror_view(coeffs);
+    auto flux_host = Kokkos::create_mirror_view(flux);
+    for(int cell=0;cell<num_cells;cell++) {
+      for(int b=0;b<num_basis;b++)
+        coeffs_host(cell,b) = std::sin(1.0+cell+0.3*b);
+      for(int q=0;q<num_qp;q++)
+        for(int d=0;d<dim;d++)
+          flux_host(cell,q,d) = std::cos(2.0+cell+0.7*q+1.3*d);
+    }
+    Kokkos::deep_copy(coeffs,coeffs_host);
+    Kokkos::deep_copy(flux,flux_host);
+
+    auto jac_inv = fix.int_values->jac_inv.get_static_view();
+    auto wm = fix.int_values->weighted_measure.get_static_view();
+    Kokkos::parallel_for(Kokkos::RangePolicy<PHX::exec_space>(0,num_cells),KOKKOS_LAMBDA(const int cell) {
+      for(int q=0;q<num_qp;q++) {
+        for(int e=0;e<dim;e++) {
+          ref_flux(cell,q,e) = 0.0;
+          for(int d=0;d<dim;d++)
+            ref_flux(cell,q,e) += wm(cell,q)*jac_inv(cell,q,e,d)*flux(cell,q,d);
+        }
+      }
+      tp.evaluateGradient(cell,coeffs,jac_inv,grad,scratch);
+      tp.integrateGradient(cell,ref_flux,residual,scratch);
+    });
+    PHX::Device::execution_space().fence();
+
+    auto grad_host = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),grad);
+    auto residual_host = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),residual);
+    auto grad_basis_host = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),fix.basis_values->grad_basis.get_static_view());
+    auto wgrad_basis_host = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),fix.basis_values->getGradBasisValues(true).get_static_view());
+
+    // compare against the contractions of the expanded arrays
+    const double tol = 1e-12;
+    for(int cell=0;cell<num_cells;cell++) {
+      for(int q=0;q<num_qp;q++) {
+        for(int d=0;d<dim;d++) {
+          double expected = 0.0;
+          for(int b=0;b<num_basis;b++)
+            expected += coeffs_host(cell,b)*grad_basis_host(cell,b,q,d);
+          TEST_FLOATING_EQUALITY(grad_host(cell,q,d),expected,tol);
+        }
+      }
+      for(int b=0;b<num_basis;b++) {
+        double expected = 0.0;
+        for(int q=0;q<num_qp;q++)
+          for(int d=0;d<dim;d++)
+            expected += wgrad_basis_host(cell,b,q,d)*flux_host(cell,q,d);
+        TEST_FLOATING_EQUALITY(residual_host(cell,b),expected,tol);
+      }
+    }
+  }
+
+  TEUCHOS_UNIT_TEST(tensor_product_basis, quad)
+  {
+    for(int order=1;order<=4;order++) {
+      out << "order " << order << std::endl;
+      testTensorProductBasis(2,order,out,success);
+    }
+  }
+
+  TEUCHOS_UNIT_TEST(tensor_product_basis, hex)
+  {
+    for(int order=1;order<=4;order++) {
+      out << "order " << order << std::endl;
+      testTensorProductBasis(3,order,out,success);
+    }
+  }
+
+  TEUCHOS_UNIT_TEST(tensor_product_basis, unsupported)
+  {
+    RCP<shards::CellTopology> topo
+       = rcp(new shards::CellTopology(shards::getCellTopologyData< shards::Triangle<3> >()));
+    const panzer::CellData cell_data(1,topo);
+    IntegrationRule tri_rule(2,cell_data);
+    TEST_ASSERT(!TensorProductBasis::isSupported("HGrad",tri_rule));
+
+    TensorProductFixture fix(3,1,2);
+    TEST_ASSERT(!TensorProductBasis::isSupported("HCurl",*fix.int_rule));
+  }
+
+}
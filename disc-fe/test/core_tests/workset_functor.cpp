@@ -0,0 +1,197 @@
+// @HEADER
+// ***********************************************************************
+//
+//           TianXin: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2022) YUAN Xi
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ***********************************************************************
+// @HEADER
+
+#include <Teuchos_ConfigDefs.hpp>
+#include <Teuchos_UnitTestHarness.hpp>
+#include <Teuchos_RCP.hpp>
+
+#include "Kokkos_Core.hpp"
+
+#include "TianXin_WorksetFunctor.hpp"
+
+namespace TianXin {
+
+    Teuchos::ParameterList buildTimeTableParams()
+    {
+        Teuchos::ParameterList p("Dirichlet");
+        p.set("Value Type","TimeTable");
+        Teuchos::ParameterList& pt = p.sublist("TimeTable");
+        pt.set<Teuchos::Array<double> >("Time Values",Teuchos::tuple<double>( 0.0, 1.0, 2.0 ));
+        pt.set<Teuchos::Array<double> >("BC Values",Teuchos::tuple<double>( 0.0, 10.0, 30.0 ));
+        return p;
+    }
+
+    WorksetFunctor::DofView buildDofs(std::size_t ndofs)
+    {
+        WorksetFunctor::DofView dofs("dofs",ndofs);
+        Kokkos::parallel_for( ndofs, KOKKOS_LAMBDA (const int i) { dofs(i) = 2*i; } );
+        return dofs;
+    }
+
+    TEUCHOS_UNIT_TEST(workset_functor, batched_time_only)
+    {
+        Teuchos::ParameterList p = buildTimeTableParams();
+        auto functor = WorksetFunctorFactory::Instance().Create("TimeTable", p);
+        TEST_ASSERT(functor->isTimeOnly());
+
+        const std::size_t ndofs = 100;
+        auto dofs = buildDofs(ndofs);
+        WorksetFunctor::ValueView values("values",ndofs);
+
+        panzer::Workset wk;
+        wk.time = 1.5;
+        functor->evaluate(wk, dofs, values);
+
+        auto values_h = Kokkos::create_mirror_view(values);
+        Kokkos::deep_copy(values_h, values);
+        for( std::size_t i=0; i<ndofs; ++i )
+            TEST_FLOATING_EQUALITY(values_h(i), (*functor)(wk), 1.0e-14);
+        TEST_FLOATING_EQUALITY(values_h(0), 20.0, 1.0e-14);
+    }
+
+    // a functor that only implements operator() is neither cached nor evaluated at coordinates
+    class CountingFunctor : public WorksetFunctor
+    {
+      public:
+        CountingFunctor() : WorksetFunctor(Teuchos::ParameterList()), calls(0) {}
+        double operator()(const panzer::Workset& wk) { ++calls; return 2.0*wk.time; }
+        int calls;
+    };
+
+    TEUCHOS_UNIT_TEST(workset_functor, default_not_time_only)
+    {
+        CountingFunctor functor;
+        TEST_ASSERT(!functor.isTimeOnly());
+        TEST_ASSERT(!functor.dependsOnCoordinates());
+
+        const std::size_t ndofs = 100;
+        auto dofs = buildDofs(ndofs);
+        WorksetFunctor::ValueView values("values",ndofs);
+
+        panzer::Workset wk;
+        wk.time = 1.5;
+
+        // operator() has no dof argument, it is called once per batch
+        functor.evaluate(wk, dofs, values);
+        TEST_EQUALITY(functor.calls, 1);
+        auto values_h = Kokkos::create_mirror_view(values);
+        Kokkos::deep_copy(values_h, values);
+        for( std::size_t i=0; i<ndofs; ++i )
+            TEST_FLOATING_EQUALITY(values_h(i), 3.0, 1.0e-14);
+
+        // at nodes and points operator() is broadcast as well
+        Kokkos::View<double**, PHX::Device> nodes("nodes", ndofs, 2);
+        WorksetFunctor::ValueView node_values("node_values",ndofs);
+        functor.evaluateAtNodes(wk, nodes, node_values);
+        TEST_EQUALITY(functor.calls, 2);
+        Kokkos::deep_copy(values_h, node_values);
+        for( std::size_t i=0; i<ndofs; ++i )
+            TEST_FLOATING_EQUALITY(values_h(i), 3.0, 1.0e-14);
+
+        const int ncells = 4, nqp = 8;
+        Kokkos::View<double***, PHX::Device> points("points", ncells, nqp, 2);
+        Kokkos::View<double**, PHX::Device> point_values("point_values", ncells, nqp);
+        functor.evaluateAtPoints(wk, points, point_values);
+        TEST_EQUALITY(functor.calls, 3);
+        auto point_values_h = Kokkos::create_mirror_view(point_values);
+        Kokkos::deep_copy(point_values_h, point_values);
+        for( int c=0; c<ncells; ++c )
+            for( int q=0; q<nqp; ++q )
+                TEST_FLOATING_EQUALITY(point_values_h(c,q), 3.0, 1.0e-14);
+    }
+
+#ifdef PANZER_HAVE_EXPREVAL
+    TEUCHOS_UNIT_TEST(workset_functor, time_expression)
+    {
+        Teuchos::ParameterList p("Dirichlet");
+        p.set("Value Type","TimeExpression");
+        p.sublist("TimeExpression").set<std::string>("Expression","t < 1 ? 10*t : 10 + 20*(t-1)");
+        auto functor = WorksetFunctorFactory::Instance().Create("TimeExpression", p);
+        TEST_ASSERT(functor->isTimeOnly());
+
+        panzer::Workset wk;
+        wk.time = 0.5;
+        TEST_FLOATING_EQUALITY((*functor)(wk), 5.0, 1.0e-14);
+        wk.time = 1.5;
+        TEST_FLOATING_EQUALITY((*functor)(wk), 20.0, 1.0e-14);
+
+        p.sublist("TimeExpression").set<std::string>("Expression","x*t");
+        TEST_THROW(WorksetFunctorFactory::Instance().Create("TimeExpression", p), Teuchos::Exceptions::InvalidParameter);
+    }
+
+    TEUCHOS_UNIT_TEST(workset_functor, coord_expression)
+    {
+        Teuchos::ParameterList p("Dirichlet");
+        p.set("Value Type","CoordExpression");
+        p.sublist("CoordExpression").set<std::string>("Expression","t*(x + 2*y) + z");
+        auto functor = WorksetFunctorFactory::Instance().Create("CoordExpression", p);
+        TEST_ASSERT(!functor->isTimeOnly());
+        TEST_ASSERT(functor->dependsOnCoordinates());
+
+        panzer::Workset wk;
+        wk.time = 2.0;
+
+        // nodes of a 2D mesh, z is taken as 0
+        const int nnodes = 10;
+        Kokkos::View<double**, PHX::Device> nodes("nodes", nnodes, 2);
+        Kokkos::parallel_for( nnodes, KOKKOS_LAMBDA (const int i) { nodes(i,0) = i; nodes(i,1) = 0.5*i; } );
+        WorksetFunctor::ValueView values("values", nnodes);
+        functor->evaluateAtNodes(wk, nodes, values);
+        auto values_h = Kokkos::create_mirror_view(values);
+        Kokkos::deep_copy(values_h, values);
+        for( int i=0; i<nnodes; ++i )
+            TEST_FLOATING_EQUALITY(values_h(i), 2.0*(i + 1.0*i), 1.0e-14);
+
+        // quadrature points of a 3D workset
+        const int ncells = 4, nqp = 8;
+        Kokkos::View<double***, PHX::Device> points("points", ncells, nqp, 3);
+        Kokkos::parallel_for( ncells, KOKKOS_LAMBDA (const int c) {
+            for( int q=0; q<nqp; ++q ) { points(c,q,0) = c; points(c,q,1) = q; points(c,q,2) = 1.0; }
+        });
+        Kokkos::View<double**, PHX::Device> point_values("point_values", ncells, nqp);
+        functor->evaluateAtPoints(wk, points, point_values);
+        auto point_values_h = Kokkos::create_mirror_view(point_values);
+        Kokkos::deep_copy(point_values_h, point_values);
+        for( int c=0; c<ncells; ++c )
+            for( int q=0; q<nqp; ++q )
+                TEST_FLOATING_EQUALITY(point_values_h(c,q), 2.0*(c + 2.0*q) + 1.0, 1.0e-14);
+
+        TEST_THROW((*functor)(wk), std::logic_error);
+    }
+#endif
+
+}
@@ -73,6 +73,7 @@ namespace user_app {
       std::string m_prefix;
       std::string m_dof_name;
       std::string m_do_convection;
+      std::string m_linear_diffusion;
   };
 
 }
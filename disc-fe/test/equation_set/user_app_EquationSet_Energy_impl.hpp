@@ -57,6 +57,8 @@
 #include "Panzer_Integrator_BasisTimesScalar.hpp"
 #include "Panzer_Integrator_TransientBasisTimesScalar.hpp"
 #include "Panzer_Integrator_GradBasisDotVector.hpp"
+#include "Panzer_Integrator_GradBasisDotVector_SumFactorized.hpp"
+#include "Panzer_Integrator_LinearOperator.hpp"
 #include "Panzer_ScalarToVector.hpp"
 #include "Panzer_Sum.hpp"
 #include "Panzer_Constant.hpp"
@@ -93,10 +95,19 @@ EquationSet_Energy(const Teuchos::RCP<Teuchos::ParameterList>& params,
       &valid_parameters
       );    
 
+    Teuchos::setStringToIntegralParameter<int>(
+      "Linear Diffusion",
+      "OFF",
+      "Assembles the diffusion Jacobian from element stiffness matrices instead of AD",
+      Teuchos::tuple<std::string>("ON","OFF"),
+      &valid_parameters
+      );    
+
     params->validateParametersAndSetDefaults(valid_parameters);
   }
 
   m_do_convection = params->get<std::string>("CONVECTION");
+  m_linear_diffusion = params->get<std::string>("Linear Diffusion");
   m_prefix = params->get<std::string>("Prefix");
   std::string basis_type = params->get<std::string>("Basis Type");
   int basis_order = params->get<int>("Basis Order");
@@ -119,6 +130,8 @@ EquationSet_Energy(const Teuchos::RCP<Teuchos::ParameterList>& params,
     this->addDOFGrad(m_dof_name);
     if (this->buildTransientSupport())
       this->addDOFTimeDerivative(m_dof_name);
+    if (m_linear_diffusion == "ON")
+      this->addLinearElementMatrix(m_dof_name,"DIFFUSION_MATRIX_"+m_dof_name);
   }
 
   this->addClosureModel(model_id);
@@ -131,13 +144,14 @@ template <typename EvalT>
 void user_app::EquationSet_Energy<EvalT>::
 buildAndRegisterEquationSetEvaluators(PHX::FieldManager<panzer::Traits>& fm,
                                       const panzer::FieldLibrary& /* fl */,
-                                      const Teuchos::ParameterList& /* user_data */) const
+                                      const Teuchos::ParameterList& user_data) const
 {
   using panzer::BasisIRLayout;
   using panzer::EvaluatorStyle;
   using panzer::IntegrationRule;
   using panzer::Integrator_BasisTimesScalar;
   using panzer::Integrator_GradBasisDotVector;
+  using panzer::Integrator_GradBasisDotVector_SumFactorized;
   using panzer::Traits;
   using PHX::Evaluator;
   using std::string;
@@ -166,7 +180,26 @@ buildAndRegisterEquationSetEvaluators(PHX::FieldManager<panzer::Traits>& fm,
     this->template registerEvaluator<EvalT>(fm, op);
   }
 
-  // Diffusion Operator
+  // Diffusion Operator (thermal conductivity is independent of temperature)
+  if (m_linear_diffusion == "ON")
+  {
+    ParameterList p("Diffusion Residual");
+    p.set("Residual Name", "RESIDUAL_"+m_dof_name);
+    p.set("DOF Name", m_dof_name);
+    p.set("Element Matrix Name", "DIFFUSION_MATRIX_"+m_dof_name);
+    p.set("Basis", basis);
+    p.set("IR", ir);
+    p.set("Operator", string("Stiffness"));
+    Teuchos::RCP<const std::vector<std::string> > vec = 
+      Teuchos::rcp(new std::vector<std::string>{m_prefix + "Thermal Conductivity"});
+    p.set("Field Multipliers", vec);
+
+    RCP< Evaluator<Traits> > op = 
+      rcp(new panzer::Integrator_LinearOperator<EvalT,Traits>(p));
+
+    this->template registerEvaluator<EvalT>(fm, op);
+  }
+  else
   {
     ParameterList p("Diffusion Residual");
     p.set("Residual Name", "RESIDUAL_"+m_dof_name);
@@ -179,8 +212,15 @@ buildAndRegisterEquationSetEvaluators(PHX::FieldManager<panzer::Traits>& fm,
 		Teuchos::rcp(new std::vector<std::string>{m_prefix + "Thermal Conductivity"});
 	p.set("Field Multipliers", vec);
     
-    RCP< Evaluator<Traits> > op = 
-      rcp(new Integrator_GradBasisDotVector<EvalT,Traits>(p));
+    bool sumFactorization = false;
+    if(user_data.isParameter("Sum Factorization"))
+      sumFactorization = user_data.get<bool>("Sum Factorization");
+
+    RCP< Evaluator<Traits> > op;
+    if(sumFactorization && panzer::TensorProductBasis::isSupported(basis->getBasis()->type(),*ir))
+      op = rcp(new Integrator_GradBasisDotVector_SumFactorized<EvalT,Traits>(p));
+    else
+      op = rcp(new Integrator_GradBasisDotVector<EvalT,Traits>(p));
 
     this->template registerEvaluator<EvalT>(fm, op);
   }
@@ -0,0 +1,300 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#include <Teuchos_ConfigDefs.hpp>
+#include <Teuchos_UnitTestHarness.hpp>
+#include <Teuchos_RCP.hpp>
+#include <Teuchos_DefaultSerialComm.hpp>
+#include <Teuchos_DefaultComm.hpp>
+
+#include "PanzerDiscFE_config.hpp"
+#include "Panzer_TpetraLinearObjContainer.hpp"
+
+#include "Tpetra_Map.hpp"
+#include "Tpetra_Vector.hpp"
+#include "Tpetra_CrsMatrix.hpp"
+
+using Teuchos::rcp;
+using Teuchos::RCP;
+
+namespace panzer {
+
+typedef TpetraLinearObjContainer<double,int,panzer::GlobalOrdinal> TpetraContainer;
+
+// 1D Laplacian tridiag(-1,2,-1) of size 4 with x=1 and f=0
+RCP<TpetraContainer> buildLaplacianContainer()
+{
+  typedef Tpetra::Map<int,panzer::GlobalOrdinal> Map;
+  RCP<const Teuchos::Comm<int> > comm = rcp(new Teuchos::SerialComm<int>);
+  RCP<const Map> map = rcp(new Map(4,0,comm));
+
+  RCP<TpetraContainer::CrsMatrixType> A = rcp(new TpetraContainer::CrsMatrixType(map,3));
+  for(panzer::GlobalOrdinal row=0;row<4;row++) {
+    std::vector<panzer::GlobalOrdinal> cols;
+    std::vector<double> vals;
+    for(panzer::GlobalOrdinal col=row-1;col<=row+1;col++) {
+      if(col<0 || col>3) continue;
+      cols.push_back(col);
+      vals.push_back(col==row ? 2.0 : -1.0);
+    }
+    A->insertGlobalValues(row,cols.size(),&vals[0],&cols[0]);
+  }
+  A->fillComplete();
+
+  RCP<TpetraContainer> container = rcp(new TpetraContainer(map,map));
+  container->set_A(A);
+  container->set_x(rcp(new TpetraContainer::VectorType(map)));
+  container->set_f(rcp(new TpetraContainer::VectorType(map)));
+  container->get_x()->putScalar(1.0);
+  container->get_f()->putScalar(0.0);
+  return container;
+}
+
+double getEntry(const TpetraContainer & container,int row,int col)
+{
+  const auto & A = *container.get_A();
+  typename TpetraContainer::CrsMatrixType::local_inds_host_view_type indices;
+  typename TpetraContainer::CrsMatrixType::values_host_view_type values;
+  A.getLocalRowView(row,indices,values);
+  for(std::size_t i=0;i<indices.extent(0);i++)
+    if(indices(i)==A.getColMap()->getLocalElement(col))
+      return values(i);
+  return 0.0;
+}
+
+void applyDirichlet(TpetraContainer & container,LinearObjContainer::DirichletMode mode,double p)
+{
+  Kokkos::View<panzer::LocalOrdinal*, PHX::Device> dofs("dofs",1);
+  Kokkos::View<double*, PHX::Device> values("values",1);
+  Kokkos::deep_copy(dofs,0);
+  Kokkos::deep_copy(values,3.0);
+
+  container.get_A()->resumeFill();
+  container.applyDirichletBoundaryCondition(mode,p,dofs,values);
+  container.get_A()->fillComplete();
+}
+
+TEUCHOS_UNIT_TEST(tTpetraDirichlet, row_only)
+{
+  RCP<TpetraContainer> container = buildLaplacianContainer();
+  applyDirichlet(*container,LinearObjContainer::RowOnly,1.0);
+
+  auto f = container->get_f()->getLocalViewHost(Tpetra::Access::ReadOnly);
+  TEST_FLOATING_EQUALITY(f(0,0),-2.0,1e-14);
+  TEST_EQUALITY(f(1,0),0.0);
+  TEST_EQUALITY(getEntry(*container,0,0),1.0);
+  TEST_EQUALITY(getEntry(*container,0,1),0.0);
+  TEST_EQUALITY(getEntry(*container,1,0),-1.0);
+}
+
+TEUCHOS_UNIT_TEST(tTpetraDirichlet, row_and_column)
+{
+  RCP<TpetraContainer> container = buildLaplacianContainer();
+  applyDirichlet(*container,LinearObjContainer::RowAndColumn,1.0);
+
+  // lifting: f(1) -= A(1,0)*f(0)
+  auto f = container->get_f()->getLocalViewHost(Tpetra::Access::ReadOnly);
+  TEST_FLOATING_EQUALITY(f(0,0),-2.0,1e-14);
+  TEST_FLOATING_EQUALITY(f(1,0),-2.0,1e-14);
+  TEST_EQUALITY(f(2,0),0.0);
+  TEST_EQUALITY(getEntry(*container,0,0),1.0);
+  TEST_EQUALITY(getEntry(*container,0,1),0.0);
+  TEST_EQUALITY(getEntry(*container,1,0),0.0);
+  TEST_EQUALITY(getEntry(*container,1,1),2.0);
+}
+
+TEUCHOS_UNIT_TEST(tTpetraDirichlet, penalty)
+{
+  RCP<TpetraContainer> container = buildLaplacianContainer();
+  applyDirichlet(*container,LinearObjContainer::Penalty,1.0e3);
+
+  auto f = container->get_f()->getLocalViewHost(Tpetra::Access::ReadOnly);
+  TEST_FLOATING_EQUALITY(f(0,0),-2.0e3,1e-14);
+  TEST_EQUALITY(getEntry(*container,0,0),1.0e3);
+  TEST_EQUALITY(getEntry(*container,0,1),-1.0);
+}
+
+
+TEUCHOS_UNIT_TEST(tTpetraDirichlet, map_overloads_keep_residual)
+{
+  std::map<panzer::LocalOrdinal,double> indx;
+  indx[0] = 3.0;
+
+  // 1-0 clear out, symmetric
+  {
+    RCP<TpetraContainer> container = buildLaplacianContainer();
+    container->get_A()->resumeFill();
+    container->applyDirichletBoundaryCondition(indx);
+    container->get_A()->fillComplete();
+
+    auto f = container->get_f()->getLocalViewHost(Tpetra::Access::ReadOnly);
+    TEST_EQUALITY(f(0,0),0.0);
+    TEST_EQUALITY(f(1,0),0.0);
+    TEST_EQUALITY(getEntry(*container,0,0),1.0);
+    TEST_EQUALITY(getEntry(*container,0,1),0.0);
+    TEST_EQUALITY(getEntry(*container,1,0),0.0);
+    TEST_EQUALITY(getEntry(*container,1,1),2.0);
+  }
+
+  // penalty
+  {
+    RCP<TpetraContainer> container = buildLaplacianContainer();
+    container->get_A()->resumeFill();
+    container->applyDirichletBoundaryCondition(1.0e3,indx);
+    container->get_A()->fillComplete();
+
+    auto f = container->get_f()->getLocalViewHost(Tpetra::Access::ReadOnly);
+    TEST_EQUALITY(f(0,0),0.0);
+    TEST_EQUALITY(getEntry(*container,0,0),1.0e3);
+    TEST_EQUALITY(getEntry(*container,0,1),0.0);
+    TEST_EQUALITY(getEntry(*container,1,0),0.0);
+  }
+}
+
+TEUCHOS_UNIT_TEST(tTpetraDirichlet, host_overload)
+{
+  RCP<TpetraContainer> container = buildLaplacianContainer();
+
+  Kokkos::View<panzer::LocalOrdinal*, Kokkos::HostSpace> dofs("dofs",1);
+  Kokkos::View<double*, Kokkos::HostSpace> values("values",1);
+  dofs(0) = 0;
+  values(0) = 3.0;
+
+  // with a residual only the rows are cleared
+  container->get_A()->resumeFill();
+  container->applyDirichletBoundaryCondition(1.0,dofs,values);
+  container->get_A()->fillComplete();
+
+  auto f = container->get_f()->getLocalViewHost(Tpetra::Access::ReadOnly);
+  TEST_FLOATING_EQUALITY(f(0,0),-2.0,1e-14);
+  TEST_EQUALITY(f(1,0),0.0);
+  TEST_EQUALITY(getEntry(*container,0,0),1.0);
+  TEST_EQUALITY(getEntry(*container,0,1),0.0);
+  TEST_EQUALITY(getEntry(*container,1,0),-1.0);
+}
+
+/* Ghosted 1D Laplacian, four nodes per rank. Rank r assembles the elements (g-1,g) of its
+ * nodes g, so its rows are the owned nodes plus the last node of rank r-1, stored first.
+ * That ghosted row has a different local id in the column map, where it follows the owned
+ * (domain map) columns, and its global column is owned by another process.
+ */
+TEUCHOS_UNIT_TEST(tTpetraDirichlet, ghosted_off_process_column)
+{
+  typedef Tpetra::Map<int,panzer::GlobalOrdinal> Map;
+  RCP<const Teuchos::Comm<int> > comm = Teuchos::DefaultComm<int>::getComm();
+  const int rank = comm->getRank();
+  const panzer::GlobalOrdinal first = 4*rank;
+
+  std::vector<panzer::GlobalOrdinal> owned, ghosted;
+  if(rank>0)
+    ghosted.push_back(first-1);
+  for(panzer::GlobalOrdinal g=first;g<first+4;g++) {
+    owned.push_back(g);
+    ghosted.push_back(g);
+  }
+  const Tpetra::global_size_t invalid = Teuchos::OrdinalTraits<Tpetra::global_size_t>::invalid();
+  RCP<const Map> ownedMap = rcp(new Map(invalid,owned,0,comm));
+  RCP<const Map> ghostedMap = rcp(new Map(invalid,ghosted,0,comm));
+
+  RCP<TpetraContainer::CrsMatrixType> A = rcp(new TpetraContainer::CrsMatrixType(ghostedMap,3));
+  for(panzer::GlobalOrdinal g=first;g<first+4;g++) {
+    if(g==0) continue;
+    panzer::GlobalOrdinal cols[2] = {g-1,g};
+    double row0[2] = {1.0,-1.0}, row1[2] = {-1.0,1.0};
+    A->insertGlobalValues(g-1,2,row0,cols);
+    A->insertGlobalValues(g,2,row1,cols);
+  }
+  A->fillComplete(ownedMap,ownedMap);
+
+  RCP<TpetraContainer> container = rcp(new TpetraContainer(ownedMap,ownedMap));
+  container->set_A(A);
+  container->set_x(rcp(new TpetraContainer::VectorType(ghostedMap)));
+  container->set_f(rcp(new TpetraContainer::VectorType(ghostedMap)));
+  container->get_x()->putScalar(1.0);
+  container->get_f()->putScalar(0.0);
+
+  // node 3 is the last owned node of rank 0 and the ghosted first row of rank 1
+  const panzer::GlobalOrdinal bc = 3;
+  const int lid = ghostedMap->getLocalElement(bc);
+  const bool hasBC = (lid!=Teuchos::OrdinalTraits<int>::invalid());
+  if(rank==1) {
+    TEST_EQUALITY(lid,0);
+    TEST_INEQUALITY(A->getColMap()->getLocalElement(bc),lid);
+  }
+
+  Kokkos::View<panzer::LocalOrdinal*, PHX::Device> dofs("dofs",hasBC ? 1 : 0);
+  Kokkos::View<double*, PHX::Device> values("values",hasBC ? 1 : 0);
+  if(hasBC) {
+    Kokkos::deep_copy(dofs,lid);
+    Kokkos::deep_copy(values,3.0);
+  }
+  A->resumeFill();
+  container->applyDirichletBoundaryCondition(LinearObjContainer::RowAndColumn,1.0,dofs,values);
+  A->fillComplete(ownedMap,ownedMap);
+
+  auto getGlobalEntry = [&](panzer::GlobalOrdinal row,panzer::GlobalOrdinal col) {
+    return getEntry(*container,ghostedMap->getLocalElement(row),col);
+  };
+  auto f = container->get_f()->getLocalViewHost(Tpetra::Access::ReadOnly);
+  if(rank==0 && comm->getSize()>1) {
+    TEST_EQUALITY(getGlobalEntry(3,3),1.0);
+    TEST_EQUALITY(getGlobalEntry(3,2),0.0);
+    TEST_EQUALITY(getGlobalEntry(2,3),0.0);
+    TEST_FLOATING_EQUALITY(f(ghostedMap->getLocalElement(3),0),-2.0,1e-14);
+    // lifting: f(2) -= A(2,3)*f(3)
+    TEST_FLOATING_EQUALITY(f(ghostedMap->getLocalElement(2),0),-2.0,1e-14);
+  }
+  if(rank==1) {
+    TEST_EQUALITY(getGlobalEntry(3,3),1.0);
+    TEST_EQUALITY(getGlobalEntry(3,4),0.0);
+    TEST_EQUALITY(getGlobalEntry(4,3),0.0);
+    TEST_EQUALITY(getGlobalEntry(4,4),2.0);
+    TEST_FLOATING_EQUALITY(f(ghostedMap->getLocalElement(3),0),-2.0,1e-14);
+    TEST_FLOATING_EQUALITY(f(ghostedMap->getLocalElement(4),0),-2.0,1e-14);
+  }
+  if(rank>1) {
+    TEST_EQUALITY(getGlobalEntry(first-1,first-1),1.0);
+    TEST_EQUALITY(getGlobalEntry(first,first-1),-1.0);
+  }
+}
+
+}
@@ -563,4 +563,105 @@ TEUCHOS_UNIT_TEST(tTpetraLinearObjFactory, initializeContainer)
    }
 }
 
+TEUCHOS_UNIT_TEST(tTpetraLinearObjFactory, frozenGraphAssembly)
+{
+
+   // build global (or serial communicator)
+   #ifdef HAVE_MPI
+      Teuchos::RCP<Teuchos::Comm<int> > tComm = Teuchos::rcp(new Teuchos::MpiComm<int>(Teuchos::opaqueWrapper(MPI_COMM_WORLD)));
+   #else
+      Teuchos::RCP<Teuchos::Comm<int> > failure_comm = THIS_,_SERIAL_BUILDS_,_SHOULD_FAIL;
+   #endif
+
+   using Teuchos::RCP;
+   using Teuchos::rcp;
+
+   int myRank = tComm->getRank();
+   int numProc = tComm->getSize();
+ 
+   typedef TpetraLinearObjContainer<double,int,panzer::GlobalOrdinal> LOC;
+   typedef panzer::TpetraLinearObjFactory<panzer::Traits,double,int,panzer::GlobalOrdinal> LOF;
+
+   RCP<panzer::GlobalIndexer> indexer 
+         = rcp(new unit_test::GlobalIndexer(myRank,numProc));
+
+   // one factory uses the export, the other the frozen graph tables
+   RCP<LOF> factories[2] = { rcp(new LOF(tComm.getConst(),indexer)), rcp(new LOF(tComm.getConst(),indexer)) };
+   factories[1]->setFrozenGraphAssembly(true);
+   TEST_ASSERT(!factories[0]->getFrozenGraphAssembly());
+   TEST_ASSERT(factories[1]->getFrozenGraphAssembly());
+
+   RCP<LOC> containers[2], ghostedContainers[2];
+   for(int f=0;f<2;f++) {
+      containers[f] = rcp_dynamic_cast<LOC>(factories[f]->buildLinearObjContainer());
+      ghostedContainers[f] = rcp_dynamic_cast<LOC>(factories[f]->buildGhostedLinearObjContainer());
+      factories[f]->initializeContainer(LOC::Mat,*containers[f]);
+      factories[f]->initializeGhostedContainer(LOC::Mat,*ghostedContainers[f]);
+   }
+
+   // repeated fills must give the same owned matrix
+   for(int fill=0;fill<4;fill++) {
+      // the last fill uses matrices on new graph objects, the value exchange is rebuilt
+      if(fill==3) {
+         RCP<LOC> frozen[2] = { containers[1], ghostedContainers[1] };
+         for(const RCP<LOC> & container : frozen) {
+            RCP<const CrsMatrix> oldA = container->get_A();
+            RCP<CrsMatrix> newA = rcp(new CrsMatrix(rcp(new CrsGraph(*oldA->getCrsGraph()))));
+            newA->fillComplete(oldA->getDomainMap(),oldA->getRangeMap());
+            TEST_ASSERT(newA->getCrsGraph().get()!=oldA->getCrsGraph().get());
+            container->set_A(newA);
+         }
+      }
+
+      for(int f=0;f<2;f++) {
+         const LOF & factory = *factories[f];
+         RCP<CrsMatrix> ghostedA = ghostedContainers[f]->get_A();
+
+         ghostedContainers[f]->initialize();
+         factory.beginFill(*ghostedContainers[f]);
+
+         // every process contributes to every ghosted entry
+         auto lclA = ghostedA->getLocalMatrixHost();
+         for(std::size_t row=0;row<ghostedA->getLocalNumRows();row++) {
+            panzer::GlobalOrdinal rowGid = ghostedA->getRowMap()->getGlobalElement(row);
+            for(std::size_t k=lclA.graph.row_map(row);k<lclA.graph.row_map(row+1);k++) {
+               panzer::GlobalOrdinal colGid = ghostedA->getColMap()->getGlobalElement(lclA.graph.entries(k));
+               lclA.values(k) = 1.0 + rowGid + 0.1*colGid + fill*(myRank+1);
+            }
+         }
+
+         factory.ghostToGlobalContainer(*ghostedContainers[f],*containers[f],LOC::Mat);
+         factory.beginFill(*containers[f]);
+         factory.endFill(*containers[f]);
+         factory.endFill(*ghostedContainers[f]);
+      }
+
+      // the frozen matrices are never reopened
+      TEST_ASSERT(containers[1]->get_A()->isFillComplete());
+      TEST_ASSERT(ghostedContainers[1]->get_A()->isFillComplete());
+
+      const CrsMatrix & A = *containers[0]->get_A();
+      const CrsMatrix & frozenA = *containers[1]->get_A();
+      TEST_EQUALITY(A.getLocalNumEntries(),frozenA.getLocalNumEntries());
+      for(std::size_t row=0;row<A.getLocalNumRows();row++) {
+         panzer::GlobalOrdinal rowGid = A.getRowMap()->getGlobalElement(row);
+         std::size_t numEntries = A.getNumEntriesInGlobalRow(rowGid);
+         TEST_EQUALITY(frozenA.getNumEntriesInGlobalRow(rowGid),numEntries);
+
+         CrsMatrix::nonconst_global_inds_host_view_type indices("indices",numEntries), frozenIndices("frozenIndices",numEntries);
+         CrsMatrix::nonconst_values_host_view_type values("values",numEntries), frozenValues("frozenValues",numEntries);
+         A.getGlobalRowCopy(rowGid,indices,values,numEntries);
+         frozenA.getGlobalRowCopy(rowGid,frozenIndices,frozenValues,numEntries);
+
+         std::map<panzer::GlobalOrdinal,double> entries;
+         for(std::size_t k=0;k<numEntries;k++)
+            entries[indices(k)] = values(k);
+         for(std::size_t k=0;k<numEntries;k++) {
+            TEST_ASSERT(entries.find(frozenIndices(k))!=entries.end());
+            TEST_FLOATING_EQUALITY(frozenValues(k),entries[frozenIndices(k)],1e-14);
+         }
+      }
+   }
+}
+
 }
@@ -257,6 +257,21 @@ TEUCHOS_UNIT_TEST(tTpetra_GlbEvalData, basic)
     TEST_EQUALITY(ghostedVecKv(3),thyraVec[3]);
     TEST_EQUALITY(ghostedVecKv(4),thyraVec[4]);
   }
+
+  // the split-phase exchange gives the same ghosted vector
+  {
+    RCP<Tpetra_Vector> expected = rcp(new Tpetra_Vector(*ged.getGhostedVector_Tpetra(),Teuchos::Copy));
+
+    ged.beginGlobalToGhost(0);
+    TEST_THROW(ged.beginGlobalToGhost(0),std::logic_error);
+    ged.endGlobalToGhost(0);
+    ged.endGlobalToGhost(0); // nothing in flight, does nothing
+
+    auto expectedKv = Kokkos::subview(expected->getLocalViewHost(Tpetra::Access::ReadOnly),Kokkos::ALL(),0);
+    auto ghostedKv = Kokkos::subview(ged.getGhostedVector_Tpetra()->getLocalViewHost(Tpetra::Access::ReadOnly),Kokkos::ALL(),0);
+    for(std::size_t i=0;i<ghostedKv.extent(0);i++)
+      TEST_EQUALITY(ghostedKv(i),expectedKv(i));
+  }
 }
 
 TEUCHOS_UNIT_TEST(tTpetra_GlbEvalData, blocked)
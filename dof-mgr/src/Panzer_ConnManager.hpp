@@ -148,7 +148,9 @@ class FieldPattern; // from DOFManager
     virtual void getElementalEdges(const LocalOrdinal&, std::vector<GlobalOrdinal>&) const {}
     virtual int getEdgeRank() const {return 1;}
 
-    /** Get the global faces IDs for a particular element
+    /** Get the global faces IDs for a particular element. On a 2D mesh this
+     * is the ID of the element itself, the DOF manager indexes its interior dofs
+     * with it.
      *
      * \param[in] local element ID
      * \returns Vector of global faces IDs.
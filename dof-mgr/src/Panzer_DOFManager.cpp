@@ -1373,204 +1373,143 @@ void DOFManager::buildLocalIdsFromOwnedAndGhostedElements()
 
 void DOFManager::buildDofsInfo()
 {
+  typedef EntityDofIndex::Record Record;
+  typedef Kokkos::DefaultHostExecutionSpace HostSpace;
+
+  PANZER_FUNC_TIME_MONITOR("panzer::DOFManager::buildDofsInfo");
+
   std::vector<std::string> elementBlockIds;
   connMngr_->getElementBlockIds(elementBlockIds);
-//std::cout << "My rank= " << communicator_->getRank() << std::endl;
-  nodeLIDMap_.clear();
-  nodeGIDMap_.clear();
-  edgeLIDMap_.clear();
-  edgeGIDMap_.clear();
-  faceLIDMap_.clear();
-  faceGIDMap_.clear();
-  std::size_t dimension = ga_fp_->getDimension();
-  std::vector<panzer::GlobalOrdinal> edgeGIDs;
-  std::vector<panzer::GlobalOrdinal> elementalNodes;
-  std::vector<panzer::GlobalOrdinal> faceGIDs;
-  auto nrank = connMngr_->getNodeRank();
-  auto erank = connMngr_->getEdgeRank();
-  auto frank = connMngr_->getFaceRank();
-
-//	std::vector< std::map< panzer::GlobalOrdinal, panzer::LocalOrdinal > > LidMaps;
-//  std::vector< std::map< panzer::GlobalOrdinal, panzer::GlobalOrdinal > > GidMaps;
-  std::vector< std::tuple<int, panzer::GlobalOrdinal, std::vector<panzer::LocalOrdinal> > > LidTuple_ed;   // field id, edge id, dof offset
-  std::vector< std::tuple<int, panzer::GlobalOrdinal, std::vector<panzer::GlobalOrdinal> > > GidTuple_ed;  // field id, edge id, dof offset
-  std::vector< std::tuple<int, panzer::GlobalOrdinal, panzer::LocalOrdinal > > LidTuple_nd;   // field id, node id, dof offset
-  std::vector< std::tuple<int, panzer::GlobalOrdinal, panzer::GlobalOrdinal > > GidTuple_nd;  // field id, node id, dof offset
-  std::vector< std::tuple<int, panzer::GlobalOrdinal, std::vector<panzer::LocalOrdinal> > > LidTuple_fc;   // field id, edge id, dof offset
-  std::vector< std::tuple<int, panzer::GlobalOrdinal, std::vector<panzer::GlobalOrdinal> > > GidTuple_fc;  // field id, edge id, dof offset
-
-  std::set<int> fieldids, total_fieldids;
-  std::set<int> lid_defined;
-  std::vector<panzer::LocalOrdinal> lids;
-  std::vector<panzer::GlobalOrdinal> gids;
-  panzer::GlobalOrdinal gid;
-  panzer::LocalOrdinal  lid;
+  nodeDofIndex_.clear();
+  edgeDofIndex_.clear();
+  faceDofIndex_.clear();
+
+  // entity kinds: 0 nodes, 1 edges, 2 faces; a kind carries dofs up to the cell dimension.
+  // A kind at the cell dimension (the faces of a 2D mesh) is the cell itself: its only
+  // entity is the one the connection manager reports for the cell and its closure is all
+  // the dofs of the field, so cell interior dofs are indexed too
+  const int dimension = ga_fp_->getDimension();
+  const int ranks[3] = { connMngr_->getNodeRank(), connMngr_->getEdgeRank(), connMngr_->getFaceRank() };
+  std::vector<int> kinds;
+  for( int k=0; k<3; k++ )
+    if( ranks[k]<=dimension ) kinds.push_back(k);
+  const int numSlots = 3*numFields_;
+
+  // element -> local ids on the host, element gids come from elementGIDs_
+  const auto hostLIDs = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),getLIDs());
+
+  // (kind, field) slot -> (entity id, position, lid, gid) of its dofs; duplicates are removed when sorted
+  std::vector< std::vector<Record> > records(numSlots);
+
+  const int numChunks = 4*HostSpace().concurrency();
+  std::vector< std::vector< std::vector<Record> > > chunkRecords(numChunks);
+
   for( auto blockId : elementBlockIds )
   {
-	  const std::vector<int>& fields = this->getBlockFieldNumbers(blockId);
-	  fieldids.clear();
-	  lid_defined.clear();
-	  for(std::size_t f=0;f<fields.size();f++) {
-            int fieldNum = fields[f];
-            fieldids.emplace(fieldNum);
-		  total_fieldids.emplace(fieldNum); 
+    std::map<std::string,int>::const_iterator bitr = blockNameToID_.find(blockId);
+    if(bitr==blockNameToID_.end() || fa_fps_[bitr->second]==Teuchos::null) continue;   // block not in FieldAggPattern manager
+    const Teuchos::RCP<const FieldAggPattern> fa_fp = fa_fps_[bitr->second];
+
+    const std::vector<int>& fields = this->getBlockFieldNumbers(blockId);
+
+    // owned elements plus the ghosted ones that carry unknowns (present when neighbors are used)
+    std::vector<panzer::LocalOrdinal> elements = connMngr_->getElementBlock(blockId);
+    for( auto ele : connMngr_->getNeighborElementBlock(blockId) )
+      if( static_cast<std::size_t>(ele)<elementGIDs_.size() && !elementGIDs_[ele].empty() )
+        elements.push_back(ele);
+    const std::size_t numElements = elements.size();
+
+    // closure offsets per (kind, field, subcell), looked up once: the lazy lookup is not thread safe.
+    // The closure lookup stops below the cell dimension, the closure of the cell is every field offset
+    int subcellCount[3] = { 0, 0, 0 };
+    std::vector< std::vector< std::vector<int> > > closure(numSlots);
+    for( auto k : kinds ) {
+      subcellCount[k] = ranks[k]<dimension ? fa_fp->getSubcellCount(ranks[k]) : 1;
+      for( auto fd : fields ) {
+        closure[k*numFields_+fd].resize(subcellCount[k]);
+        for( int i=0; i<subcellCount[k]; i++ )
+          closure[k*numFields_+fd][i] = ranks[k]<dimension ? getGIDFieldOffsets_closure(blockId, fd, ranks[k], i).first
+                                                            : fa_fp->localOffsets(fd);
       }
-	  const std::vector<LocalOrdinal>& elements = connMngr_->getElementBlock(blockId);
-	  // Can only consider owned element only. It is a BIG problem !!!
-	  //std::vector<panzer::LocalOrdinal> elements;
-	  //connMngr_->getElementBlockAll(blockId, elements);
-
-	  std::map<std::string,int>::const_iterator bitr = blockNameToID_.find(blockId);
-  	  if(bitr==blockNameToID_.end()) return;    // block not in FieldAggPattern manager
-	  
-	  //int bid=bitr->second;
-	  // const auto fv = fa_fps_[bid]->fieldIds();  = above fields
-	    
-	  for( auto ele: elements )
-	  {
-        std::vector<panzer::GlobalOrdinal> GIDs;
-	  	getElementGIDs( ele, GIDs );
-		auto LIDs = getElementLIDs( ele );
-		
-		std::size_t dofcount = 0;
-		connMngr_->getElementalNodeConnectivity(ele, elementalNodes);
-		for( std::size_t i =0; i<elementalNodes.size(); i++ )
-		{
-			for( auto fd1 : fieldids ) {
-				const auto& offsetPair = getGIDFieldOffsets_closure(blockId, fd1, nrank, i);
-				const auto& offsets =  offsetPair.first;
-				if( offsets.empty() ) continue;
-				++dofcount;
-			
-				gid = GIDs[offsets[0]];
-				lid = LIDs[offsets[0]];
-				auto itr_find = lid_defined.find(lid);
-				if( itr_find != lid_defined.end() ) continue;  // emblaced already!
-				lid_defined.emplace(lid);
-				auto& ndgid = elementalNodes[i];
-			//	std::cout << "ele:" << ele << "," << fd1 << ", " << i << ", " << ndgid << ", " << gid << ", " << lid << std::endl;
-				LidTuple_nd.emplace_back( std::make_tuple(fd1, ndgid, lid) );
-				GidTuple_nd.emplace_back( std::make_tuple(fd1, ndgid, gid) );
-			}
-		}
-	//	if( dofcount>=fields.size() ) continue;  // no edge/face dofs
-			
-		connMngr_->getElementalEdges(ele, edgeGIDs);
-		for( std::size_t i =0; i<edgeGIDs.size(); i++ )
-		{
-			for( auto fd1 : fieldids ) {
-				const auto& offsetPair = getGIDFieldOffsets_closure(blockId, fd1, erank, i);
-				const auto& offsets =  offsetPair.first;
-				if( offsets.empty() ) continue;
-				
-				std::size_t nids = offsets.size();
-				lids.resize(nids);
-				gids.resize(nids);
-				auto& ndgid = edgeGIDs[i];
-				
-				for( std::size_t j=0; j<nids; ++j )
-				{
-					++dofcount;
-			
-					gid = GIDs[offsets[j]];
-					lid = LIDs[offsets[j]];
-					lids[j] = lid;
-					gids[j] = gid;
-					auto itr_find = lid_defined.find(lid);
-					if( itr_find != lid_defined.end() ) continue;  // emblaced already!
-					lid_defined.emplace(lid);
-				}
-				LidTuple_ed.emplace_back( std::make_tuple(fd1, ndgid, lids) );
-				GidTuple_ed.emplace_back( std::make_tuple(fd1, ndgid, gids) );
-			}
-		}
-    //    if( dofcount>=fields.size() ) continue;  // no face dofs
-		  
-        if( dimension>1 ) {
-		   connMngr_->getElementalFaces(ele, faceGIDs);
-		   for( std::size_t i =0; i<faceGIDs.size(); i++ )
-		   {
-			 for( auto fd1 : fieldids ) {
-				const auto& offsetPair = getGIDFieldOffsets_closure(blockId, fd1, frank, i);
-				const auto& offsets =  offsetPair.first;
-				if( offsets.empty() ) continue;
-				
-				std::size_t nids = offsets.size();
-				lids.resize(nids);
-				gids.resize(nids);
-				auto& ndgid = faceGIDs[i];
-
-				for( std::size_t j=0; j<nids; ++j )
-				{
-					++dofcount;
-			
-					gid = GIDs[offsets[j]];
-					lid = LIDs[offsets[j]];
-                    lids[j] = lid;
-					gids[j] = gid;
-					auto itr_find = lid_defined.find(lid);
-					if( itr_find != lid_defined.end() ) continue;  // emblaced already!
-					lid_defined.emplace(lid);
-				}
-				LidTuple_fc.emplace_back( std::make_tuple(fd1, ndgid, lids) );
-				GidTuple_fc.emplace_back( std::make_tuple(fd1, ndgid, gids) );
-			}
-		  }
-	    }
-	}
-  }
-	
-  if( !LidTuple_nd.empty() ) {
-  	for(auto fd : total_fieldids) {
-	  std::map< panzer::GlobalOrdinal, panzer::LocalOrdinal > LidMap;
-	  for( auto lids: LidTuple_nd ) {
-		  if( std::get<0>(lids) != fd ) continue;
-		  LidMap.insert( std::make_pair(std::get<1>(lids), std::get<2>(lids)) );
-	  }
-	  std::map< panzer::GlobalOrdinal, panzer::GlobalOrdinal > GidMap;
-	  for( auto gids: GidTuple_nd ) {
-		  if( std::get<0>(gids) != fd ) continue;
-		  GidMap.insert( std::make_pair(std::get<1>(gids), std::get<2>(gids)) );
-	  }
-	  nodeLIDMap_.insert( std::make_pair(fd, LidMap) );
-	  nodeGIDMap_.insert( std::make_pair(fd, GidMap) );
-	}
-  }
+    }
 
-  if( !LidTuple_ed.empty() ) {
-	for(auto fd : total_fieldids) {
-	  std::map< panzer::GlobalOrdinal, std::vector<panzer::LocalOrdinal> > LidMap;
-	  for( auto lids: LidTuple_ed ) {
-		  if( std::get<0>(lids) != fd ) continue;
-		  LidMap.insert( std::make_pair(std::get<1>(lids), std::get<2>(lids)) );
-	  }
-	  std::map< panzer::GlobalOrdinal, std::vector<panzer::GlobalOrdinal> > GidMap;
-	  for( auto gids: GidTuple_ed ) {
-		  if( std::get<0>(gids) != fd ) continue;
-		  GidMap.insert( std::make_pair(std::get<1>(gids), std::get<2>(gids)) );
-	  }
-	  edgeLIDMap_.insert( std::make_pair(fd, LidMap) );
-	  edgeGIDMap_.insert( std::make_pair(fd, GidMap) );
-	}
-  }
-  
-  if( !LidTuple_fc.empty() ) {
-	for(auto fd : total_fieldids) {
-	  std::map< panzer::GlobalOrdinal, std::vector<panzer::LocalOrdinal> > LidMap;
-	  for( auto lids: LidTuple_fc ) {
-		  if( std::get<0>(lids) != fd ) continue;
-		  LidMap.insert( std::make_pair(std::get<1>(lids), std::get<2>(lids)) );
-	  }
-	  std::map< panzer::GlobalOrdinal, std::vector<panzer::GlobalOrdinal> > GidMap;
-	  for( auto gids: GidTuple_fc ) {
-		  if( std::get<0>(gids) != fd ) continue;
-		  GidMap.insert( std::make_pair(std::get<1>(gids), std::get<2>(gids)) );
-	  }
-	  faceLIDMap_.insert( std::make_pair(fd, LidMap) );
-	  faceGIDMap_.insert( std::make_pair(fd, GidMap) );
-	}
+    // snapshot of the element entities in flat arrays, the connection manager is not queried concurrently
+    std::vector<std::size_t> entityOffsets[3];
+    std::vector<panzer::GlobalOrdinal> entityIds[3];
+    {
+      std::vector<panzer::GlobalOrdinal> entities;
+      for( auto k : kinds ) {
+        entityOffsets[k].resize(numElements+1);
+        entityOffsets[k][0] = 0;
+        entityIds[k].clear();
+        entityIds[k].reserve(numElements*subcellCount[k]);
+        for( std::size_t e=0; e<numElements; e++ ) {
+          if( k==0 )      connMngr_->getElementalNodeConnectivity(elements[e], entities);
+          else if( k==1 ) connMngr_->getElementalEdges(elements[e], entities);
+          else            connMngr_->getElementalFaces(elements[e], entities);
+          const std::size_t count = std::min(entities.size(),static_cast<std::size_t>(subcellCount[k]));
+          entityIds[k].insert(entityIds[k].end(),entities.begin(),entities.begin()+count);
+          entityOffsets[k][e+1] = entityIds[k].size();
+        }
+      }
+    }
+
+    // gather: each chunk of elements fills its own buffers, reading only the snapshot and the dof arrays
+    Kokkos::parallel_for("panzer::DOFManager::buildDofsInfo::gather",Kokkos::RangePolicy<HostSpace>(0,numChunks),
+                         [&](const int c) {
+      std::vector< std::vector<Record> > & buffers = chunkRecords[c];
+      buffers.assign(numSlots,std::vector<Record>());
+
+      const std::size_t begin = (numElements*c)/numChunks, end = (numElements*(c+1))/numChunks;
+      for( std::size_t e=begin; e<end; e++ ) {
+        const panzer::LocalOrdinal ele = elements[e];
+        const std::vector<panzer::GlobalOrdinal> & GIDs = elementGIDs_[ele];
+        for( auto k : kinds ) {
+          const panzer::GlobalOrdinal * entities = entityIds[k].data()+entityOffsets[k][e];
+          const int count = static_cast<int>(entityOffsets[k][e+1]-entityOffsets[k][e]);
+          for( int i=0; i<count; i++ ) {
+            for( auto fd : fields ) {
+              const std::vector<int> & offsets = closure[k*numFields_+fd][i];
+              for( std::size_t j=0; j<offsets.size(); ++j )
+                buffers[k*numFields_+fd].push_back( Record{entities[i], static_cast<int>(j), hostLIDs(ele,offsets[j]), GIDs[offsets[j]]} );
+            }
+          }
+        }
+      }
+    });
+
+    // concatenate the chunks in element order, one slot per thread
+    Kokkos::parallel_for("panzer::DOFManager::buildDofsInfo::merge",Kokkos::RangePolicy<HostSpace>(0,numSlots),
+                         [&](const int slot) {
+      for( int c=0; c<numChunks; c++ ) {
+        std::vector<Record> & buffer = chunkRecords[c][slot];
+        records[slot].insert(records[slot].end(),buffer.begin(),buffer.end());
+        std::vector<Record>().swap(buffer);
+      }
+    });
   }
-	
+
+  // sort/unique every (kind, field) list concurrently
+  Kokkos::parallel_for("panzer::DOFManager::buildDofsInfo::sort",Kokkos::RangePolicy<HostSpace>(0,numSlots),
+                       [&](const int slot) { EntityDofIndex::sortRecords(records[slot]); });
+
+  // create the indices up front (the maps are not thread safe), fill their host arrays
+  // concurrently and copy them to the device afterwards
+  std::map<int,EntityDofIndex> * indices[3] = { &nodeDofIndex_, &edgeDofIndex_, &faceDofIndex_ };
+  std::vector<EntityDofIndex*> slotIndex(numSlots,nullptr);
+  for( int slot=0; slot<numSlots; slot++ )
+    if( !records[slot].empty() )
+      slotIndex[slot] = &(*indices[slot/numFields_])[slot%numFields_];
+
+  Kokkos::parallel_for("panzer::DOFManager::buildDofsInfo::build",Kokkos::RangePolicy<HostSpace>(0,numSlots),
+                       [&](const int slot) {
+    if( slotIndex[slot]!=nullptr )
+      slotIndex[slot]->buildSortedHost(records[slot]);
+  });
+
+  for( int slot=0; slot<numSlots; slot++ )
+    if( slotIndex[slot]!=nullptr )
+      slotIndex[slot]->copyToDevice();
 }
 
 
@@ -0,0 +1,116 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+
+#include "Panzer_EntityDofIndex.hpp"
+
+namespace panzer {
+
+void EntityDofIndex::sortRecords(std::vector<Record> & records)
+{
+   std::stable_sort(records.begin(),records.end(),
+                    [](const Record & a,const Record & b) { return a.entity<b.entity || (a.entity==b.entity && a.pos<b.pos); });
+   auto last = std::unique(records.begin(),records.end(),
+                           [](const Record & a,const Record & b) { return a.entity==b.entity && a.pos==b.pos; });
+   records.erase(last,records.end());
+}
+
+void EntityDofIndex::buildSortedHost(const std::vector<Record> & records)
+{
+   keys_.clear();
+   offsets_.clear();
+   lids_.resize(records.size());
+   gids_.resize(records.size());
+   for(std::size_t i=0;i<records.size();i++) {
+      if(i==0 || records[i].entity!=records[i-1].entity) {
+         keys_.push_back(records[i].entity);
+         offsets_.push_back(static_cast<LO>(i));
+      }
+      lids_[i] = records[i].lid;
+      gids_[i] = records[i].gid;
+   }
+   offsets_.push_back(static_cast<LO>(records.size()));
+}
+
+void EntityDofIndex::copyToDevice()
+{
+   keys_k_ = Kokkos::View<GO*,PHX::Device>("EntityDofIndex::keys",keys_.size());
+   offsets_k_ = Kokkos::View<LO*,PHX::Device>("EntityDofIndex::offsets",offsets_.size());
+   lids_k_ = Kokkos::View<LO*,PHX::Device>("EntityDofIndex::lids",lids_.size());
+   Kokkos::deep_copy(keys_k_,Kokkos::View<const GO*,Kokkos::HostSpace,Kokkos::MemoryTraits<Kokkos::Unmanaged> >(keys_.data(),keys_.size()));
+   Kokkos::deep_copy(offsets_k_,Kokkos::View<const LO*,Kokkos::HostSpace,Kokkos::MemoryTraits<Kokkos::Unmanaged> >(offsets_.data(),offsets_.size()));
+   Kokkos::deep_copy(lids_k_,Kokkos::View<const LO*,Kokkos::HostSpace,Kokkos::MemoryTraits<Kokkos::Unmanaged> >(lids_.data(),lids_.size()));
+}
+
+void EntityDofIndex::find(const Kokkos::View<const GO*,PHX::Device> & entities,
+                          const Kokkos::View<LO*,PHX::Device> & positions) const
+{
+   TEUCHOS_ASSERT(entities.extent(0)==positions.extent(0));
+   const auto keys = keys_k_;
+   const LO numKeys = keys_k_.extent(0);
+   Kokkos::parallel_for("EntityDofIndex::find",Kokkos::RangePolicy<PHX::Device::execution_space>(0,entities.extent(0)),
+                        KOKKOS_LAMBDA (const int i) {
+      const GO entity = entities(i);
+      LO lo = 0, hi = numKeys;
+      while(lo<hi) {
+         const LO mid = lo+(hi-lo)/2;
+         if(keys(mid)<entity) lo = mid+1;
+         else hi = mid;
+      }
+      positions(i) = (lo<numKeys && keys(lo)==entity) ? lo : -1;
+   });
+}
+
+void EntityDofIndex::print(std::ostream & os) const
+{
+   for(std::size_t p=0;p<keys_.size();p++) {
+      os << "  entity gid:" << keys_[p] << "  with local index=";
+      for(LO i=offsets_[p];i<offsets_[p+1];i++)
+         os << lids_[i] << "  ";
+      os << "  with global index=";
+      for(LO i=offsets_[p];i<offsets_[p+1];i++)
+         os << gids_[i] << "  ";
+      os << std::endl;
+   }
+}
+
+}
@@ -0,0 +1,204 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+
+#ifndef __Panzer_EntityDofIndex_hpp__
+#define __Panzer_EntityDofIndex_hpp__
+
+#include <vector>
+#include <ostream>
+#include <algorithm>
+
+#include "Teuchos_Assert.hpp"
+
+#include "PanzerDofMgr_config.hpp"
+#include "Phalanx_KokkosDeviceTypes.hpp"
+
+namespace panzer {
+
+/** \brief Flat index from mesh entities (nodes, edges or faces) to the dofs of one field.
+  *
+  * The index is stored CSR-like: a sorted array of entity global ids, an offset array and
+  * the local/global dof ids of each entity. Lookups are binary searches, batched lookups of
+  * a whole node/edge/face set reuse the search position of the previous key so that sorted
+  * sets are resolved in a single sweep. Device copies of the arrays are available for kernels.
+  */
+class EntityDofIndex {
+public:
+   typedef panzer::LocalOrdinal LO;
+   typedef panzer::GlobalOrdinal GO;
+
+   //! One dof of an entity, <code>pos</code> being its position within the entity
+   struct Record {
+      GO  entity;
+      int pos;
+      LO  lid;
+      GO  gid;
+   };
+
+   EntityDofIndex() {}
+
+   /** Build the index. The records are sorted in place. For an (entity, pos) pair
+     * given more than once the first record is kept.
+     */
+   void build(std::vector<Record> & records)
+   { sortRecords(records); buildSorted(records); }
+
+   /** Sort the records by (entity, pos) and remove duplicates, keeping the first.
+     * Touches no index state, so several record lists may be sorted concurrently.
+     */
+   static void sortRecords(std::vector<Record> & records);
+
+   //! Build the index from records already passed through <code>sortRecords</code>
+   void buildSorted(const std::vector<Record> & records)
+   { buildSortedHost(records); copyToDevice(); }
+
+   /** Host part of <code>buildSorted</code>. Allocates no Kokkos views, so distinct
+     * indices may be built concurrently; <code>copyToDevice</code> must follow.
+     */
+   void buildSortedHost(const std::vector<Record> & records);
+
+   //! Copy the host arrays to the device views
+   void copyToDevice();
+
+   bool empty() const
+   { return keys_.empty(); }
+
+   std::size_t numEntities() const
+   { return keys_.size(); }
+
+   //! Position of the entity in the index, -1 if not found
+   LO find(const GO entity) const
+   {
+      auto itr = std::lower_bound(keys_.begin(),keys_.end(),entity);
+      if(itr==keys_.end() || *itr!=entity) return -1;
+      return static_cast<LO>(itr-keys_.begin());
+   }
+
+   //! Local id of the first dof of an entity, -1 if not found
+   LO getLID(const GO entity) const
+   {
+      const LO p = find(entity);
+      return (p<0) ? -1 : lids_[offsets_[p]];
+   }
+
+   //! Global id of the first dof of an entity, throws if not found
+   GO getGID(const GO entity) const
+   {
+      const LO p = find(entity);
+      TEUCHOS_TEST_FOR_EXCEPTION(p<0,std::out_of_range,"EntityDofIndex: entity " << entity << " not found");
+      return gids_[offsets_[p]];
+   }
+
+   //! Local ids of all dofs of an entity, false if not found
+   bool getLIDs(const GO entity,std::vector<LO> & lids) const
+   {
+      const LO p = find(entity);
+      lids.clear();
+      if(p<0) return false;
+      lids.assign(lids_.begin()+offsets_[p],lids_.begin()+offsets_[p+1]);
+      return true;
+   }
+
+   //! Global ids of all dofs of an entity, throws if not found
+   void getGIDs(const GO entity,std::vector<GO> & gids) const
+   {
+      const LO p = find(entity);
+      TEUCHOS_TEST_FOR_EXCEPTION(p<0,std::out_of_range,"EntityDofIndex: entity " << entity << " not found");
+      gids.assign(gids_.begin()+offsets_[p],gids_.begin()+offsets_[p+1]);
+   }
+
+   /** Batched lookup: append the local ids of all dofs of every entity of the set
+     * to <code>lids</code>. Throws if an entity is not found.
+     */
+   template <typename KeyT>
+   void getLIDs(const std::vector<KeyT> & entities,std::vector<LO> & lids) const
+   {
+      lids.clear();
+      lids.reserve(entities.size());
+      auto first = keys_.begin();
+      GO previous = 0;
+      for(std::size_t i=0;i<entities.size();i++) {
+         const GO entity = static_cast<GO>(entities[i]);
+         // sorted sets continue the search from the last hit
+         if(i==0 || entity<previous) first = keys_.begin();
+         auto itr = std::lower_bound(first,keys_.end(),entity);
+         TEUCHOS_TEST_FOR_EXCEPTION(itr==keys_.end() || *itr!=entity,std::out_of_range,
+                                    "EntityDofIndex: entity " << entity << " not found");
+         const std::size_t p = itr-keys_.begin();
+         lids.insert(lids.end(),lids_.begin()+offsets_[p],lids_.begin()+offsets_[p+1]);
+         first = itr;
+         previous = entity;
+      }
+   }
+
+   /** Batched device lookup: <code>positions(i)</code> is the position of <code>entities(i)</code>
+     * in the index, or -1. Dofs of position p are <code>getLIDsView()(getOffsetsView()(p)...getOffsetsView()(p+1)-1)</code>.
+     */
+   void find(const Kokkos::View<const GO*,PHX::Device> & entities,
+             const Kokkos::View<LO*,PHX::Device> & positions) const;
+
+   Kokkos::View<const GO*,PHX::Device> getKeysView() const
+   { return keys_k_; }
+
+   Kokkos::View<const LO*,PHX::Device> getOffsetsView() const
+   { return offsets_k_; }
+
+   Kokkos::View<const LO*,PHX::Device> getLIDsView() const
+   { return lids_k_; }
+
+   void print(std::ostream & os) const;
+
+private:
+   std::vector<GO> keys_;     // sorted entity global ids
+   std::vector<LO> offsets_;  // keys_.size()+1 offsets into lids_/gids_
+   std::vector<LO> lids_;
+   std::vector<GO> gids_;
+
+   Kokkos::View<GO*,PHX::Device> keys_k_;
+   Kokkos::View<LO*,PHX::Device> offsets_k_;
+   Kokkos::View<LO*,PHX::Device> lids_k_;
+};
+
+}
+
+#endif
@@ -47,10 +47,13 @@
 #include <string>
 #include <unordered_map> // a hash table for buildLocalIds()
 #include <set>
+#include <map>
+#include <iostream>
 #include "Teuchos_RCP.hpp"
 #include "Teuchos_Comm.hpp"
 #include "Phalanx_KokkosDeviceTypes.hpp"
 #include "PanzerDofMgr_config.hpp"
+#include "Panzer_EntityDofIndex.hpp"
 
 namespace panzer {
 
@@ -325,42 +328,40 @@ public:
      
    };
    
+   /** \brief Flat entity to dof index of a field.
+     *
+     * \param[in] f    field number
+     * \param[in] rank 0: nodes, 1: edges, 2: faces (the cells of a 2D mesh)
+     *
+     * \returns Index or null if the field has no dofs on entities of this rank
+     */
+   const EntityDofIndex * getEntityDofIndex(int f, int rank) const
+   {
+	   const std::map<int,EntityDofIndex> & indices = (rank==0) ? nodeDofIndex_ : ( (rank==1) ? edgeDofIndex_ : faceDofIndex_ );
+	   auto it = indices.find(f);
+	   if( it==indices.end() ) return nullptr;
+	   return &it->second;
+   }
+
    // Return node dof map of fieldnum provided
    panzer::GlobalOrdinal getNodalGDofOfField(int f, panzer::GlobalOrdinal nd) const
-   { return nodeGIDMap_.at(f).at(nd); }
+   { return nodeDofIndex_.at(f).getGID(nd); }
    
    bool isNodalField(const int f) const
-   {
-	   if( nodeLIDMap_.empty() ) return false;
-	   auto it = nodeLIDMap_.find(f);
-	   if( it==nodeLIDMap_.end() ) return false;
-	   return true;
-   }
+   { return getEntityDofIndex(f,0)!=nullptr; }
    
    bool isEdgeField(const int f) const
-   {
-	   if( edgeLIDMap_.empty() ) return false;
-	   auto it = edgeLIDMap_.find(f);
-	   if( it==edgeLIDMap_.end() ) return false;
-	   return true;
-   }
+   { return getEntityDofIndex(f,1)!=nullptr; }
    
    bool isFaceField(const int f) const
-   {
-	   if( faceLIDMap_.empty() ) return false;
-	   auto it = faceLIDMap_.find(f);
-	   if( it==faceLIDMap_.end() ) return false;
-	   return true;
-   }
+   { return getEntityDofIndex(f,2)!=nullptr; }
    
+   //! Local dof of a node, -1 if the field or the node is not found
    panzer::LocalOrdinal getNodalLDofOfField(int f, panzer::GlobalOrdinal nd) const
    {
-	   if( nodeLIDMap_.empty() ) return -1;
-	   auto it = nodeLIDMap_.find(f);
-	   if( it==nodeLIDMap_.end() ) return -1;
-	  // auto itt = nodeGIDMap_.at(f).find(nd);
-	  // if( itt==nodeGIDMap_.at(f).end() ) return -1;
-	   return nodeLIDMap_.at(f).at(nd); 
+	   const EntityDofIndex * index = getEntityDofIndex(f,0);
+	   if( index==nullptr ) return -1;
+	   return index->getLID(nd); 
    }
 	
    /**
@@ -370,29 +371,15 @@ public:
    */
    virtual void getNodesetsLocalIndex(const int& fieldnum, const std::vector<panzer::GlobalOrdinal>& nodeset, std::vector<panzer::LocalOrdinal>& ldofs) const
    {
-	if( nodeLIDMap_.empty() ) return;
-	
-	auto localmap = nodeLIDMap_.at( fieldnum );
-	ldofs.clear();
-	for( auto nd: nodeset )
-	{
-		auto a = localmap.at( nd );
-		ldofs.emplace_back( a );
-	}
+	if( nodeDofIndex_.empty() ) return;
+	nodeDofIndex_.at( fieldnum ).getLIDs( nodeset, ldofs );
    }
 
    /* for stk::mesh::EntityId = uint64_t */
    virtual void getNodesetsLocalIndex(const int& fieldnum, const std::vector<uint64_t>& nodeset, std::vector<panzer::LocalOrdinal>& ldofs) const
    {
-	if( nodeLIDMap_.empty() ) return;
-	
-	auto localmap = nodeLIDMap_.at( fieldnum );
-	ldofs.clear();
-	for( auto nd: nodeset )
-	{
-		auto a = localmap.at( nd );
-		ldofs.emplace_back( a );
-	}
+	if( nodeDofIndex_.empty() ) return;
+	nodeDofIndex_.at( fieldnum ).getLIDs( nodeset, ldofs );
    }
    
    /**
@@ -402,122 +389,73 @@ public:
    */
    virtual void getEdgesetsLocalIndex(int fieldnum, std::vector<panzer::GlobalOrdinal>& edgeset, std::vector<panzer::LocalOrdinal>& ldofs) const
    {
-	if( edgeLIDMap_.empty() ) return;
-	
-	auto localmap = edgeLIDMap_.at( fieldnum );
-	ldofs.clear();
-	for( auto nd: edgeset )
-	{
-		auto a = localmap.at( nd );
-		for( auto ab : a )
-			ldofs.emplace_back( ab );
-	}
+	if( edgeDofIndex_.empty() ) return;
+	edgeDofIndex_.at( fieldnum ).getLIDs( edgeset, ldofs );
+   }
+
+   /**
+   * \param[in] fieldnum field number
+   * \param[in] global ids of a group of faces
+   * \param[out] gdofs  local index of faces' dof
+   */
+   virtual void getFacesetsLocalIndex(int fieldnum, const std::vector<panzer::GlobalOrdinal>& faceset, std::vector<panzer::LocalOrdinal>& ldofs) const
+   {
+	if( faceDofIndex_.empty() ) return;
+	faceDofIndex_.at( fieldnum ).getLIDs( faceset, ldofs );
    }
 	
    std::vector<panzer::LocalOrdinal> getEdgeLDofOfField(int f, panzer::GlobalOrdinal nd) const
    {
-	   if( edgeLIDMap_.empty() ) return std::vector<panzer::LocalOrdinal>();
-	   auto localmap = edgeLIDMap_.at( f );
 	   std::vector<panzer::LocalOrdinal> ldof;
-	   try {
-	      ldof = localmap.at(nd);
-	   }
-	   catch(std::out_of_range&) {
+	   const EntityDofIndex * index = getEntityDofIndex(f,1);
+	   if( index==nullptr ) return ldof;
+	   if( !index->getLIDs(nd, ldof) )
 			std::cout << "Cannot find field " << f << " of edge " << nd << " in cpu " << this->getComm()->getRank() << std::endl;
-	   }
 	   return ldof; 
    }
 	
    std::vector<panzer::GlobalOrdinal> getEdgeGDofOfField(int f, panzer::GlobalOrdinal nd) const
-   { return edgeGIDMap_.at(f).at(nd); }
-
+   {
+	   std::vector<panzer::GlobalOrdinal> gdof;
+	   edgeDofIndex_.at(f).getGIDs(nd, gdof);
+	   return gdof;
+   }
 
    std::vector<panzer::LocalOrdinal> getFaceLDofOfField(int f, panzer::GlobalOrdinal nd) const
    {
-	   if( faceLIDMap_.empty() ) return std::vector<panzer::LocalOrdinal>();
-	   auto localmap = faceLIDMap_.at( f );
 	   std::vector<panzer::LocalOrdinal> ldof;
-	   try {
-	      ldof = localmap.at(nd);
-	   }
-	   catch(std::out_of_range&) {
+	   const EntityDofIndex * index = getEntityDofIndex(f,2);
+	   if( index==nullptr ) return ldof;
+	   if( !index->getLIDs(nd, ldof) )
 			std::cout << "Cannot find field " << f << " of face " << nd << " in cpu " << this->getComm()->getRank() << std::endl;
-	   }
 	   return ldof; 
    }
 	
    std::vector<panzer::GlobalOrdinal> getFaceGDofOfField(int f, panzer::GlobalOrdinal nd) const
-   { return faceGIDMap_.at(f).at(nd); }
+   {
+	   std::vector<panzer::GlobalOrdinal> gdof;
+	   faceDofIndex_.at(f).getGIDs(nd, gdof);
+	   return gdof;
+   }
 
    
    void print_DOFInfo(std::ostream &os) const
    {
 	 os << "My rank= " << this->getComm()->getRank() << std::endl;
-	 for( auto ndmap: nodeLIDMap_ )
+	 for( const auto& ndmap: nodeDofIndex_ )
 	 {
-		os << "Field: " << getFieldString(ndmap.first) << "  with field number " << ndmap.first << std::endl;
-		std::size_t c =0;
-		for( auto b: ndmap.second )
-		{
-			std::cout << "  node gid:" << b.first << "  with local index=" << b.second << std::endl;
-			c++;
-		}
+		os << "Field: " << getFieldString(ndmap.first) << "  with field number " << ndmap.first << " on nodes" << std::endl;
+		ndmap.second.print(os);
      }
-	 for( auto ndmap: nodeGIDMap_ )
-	 {
-		os << "Field: " << getFieldString(ndmap.first) << "  with field number " << ndmap.first << std::endl;
-		std::size_t c =0;
-		for( auto b: ndmap.second )
-		{
-			std::cout << "  node gid:" << b.first << "  with global index=" << b.second << std::endl;
-			c++;
-		}
-	 }
-	
-	 for( auto edmap: edgeLIDMap_ )
+	 for( const auto& edmap: edgeDofIndex_ )
 	 {
-		os << "Field: " << getFieldString(edmap.first) << "  with field number " << edmap.first << std::endl;
-		for( auto b: edmap.second )
-		{
-			std::cout << "  Edge gid:" << b.first << "  with local index=";
-			for( const auto bb: b.second )
-				std::cout << bb << "  ";
-			std::cout << std::endl;
-		}
+		os << "Field: " << getFieldString(edmap.first) << "  with field number " << edmap.first << " on edges" << std::endl;
+		edmap.second.print(os);
 	 }
-	 for( auto edmap: edgeGIDMap_ )
-	 {
-		os << "Field: " << getFieldString(edmap.first) << "  with field number " << edmap.first << std::endl;
-		for( auto b: edmap.second )
-		{
-			std::cout << "  Edge gid:" << b.first << "  with global index=";
-			for( const auto bb: b.second )
-				std::cout << bb << "  ";
-			std::cout << std::endl;
-		}
-	 }
-	
-	 for( auto fdmap: faceLIDMap_ )
+	 for( const auto& fdmap: faceDofIndex_ )
 	 {
-		os << "Field: " << getFieldString(fdmap.first) << "  with field number " << fdmap.first << std::endl;
-		for( auto b: fdmap.second )
-		{
-			std::cout << "  face gid:" << b.first << "  with local index=";
-			for( const auto bb: b.second )
-				std::cout << bb << "  ";
-			std::cout << std::endl;
-		}
-	 }
-	 for( auto fdmap: faceGIDMap_ )
-	 {
-		os << "Field: " << getFieldString(fdmap.first) << "  with field number " << fdmap.first << std::endl;
-		for( auto b: fdmap.second )
-		{
-			std::cout << "  face gid:" << b.first << "  with global index=";
-			for( const auto bb: b.second )
-				std::cout << bb << "  ";
-			std::cout << std::endl;
-		}
+		os << "Field: " << getFieldString(fdmap.first) << "  with field number " << fdmap.first << " on faces" << std::endl;
+		fdmap.second.print(os);
 	 }
    }
    
@@ -528,17 +466,10 @@ public:
 
 protected:
 
-   // field ID -> nodal global index -> local & global index of dof
-   std::map< int, std::map<panzer::GlobalOrdinal, panzer::LocalOrdinal> > nodeLIDMap_;
-   std::map< int, std::map<panzer::GlobalOrdinal, panzer::GlobalOrdinal> > nodeGIDMap_;
-
-   // field ID -> edge global index -> local & global index of dof
-   std::map< int, std::map<panzer::GlobalOrdinal, std::vector<panzer::LocalOrdinal>> > edgeLIDMap_;
-   std::map< int, std::map<panzer::GlobalOrdinal, std::vector<panzer::GlobalOrdinal>> > edgeGIDMap_;
-
-   // field ID -> face global index -> local & global index of dof
-   std::map< int, std::map<panzer::GlobalOrdinal, std::vector<panzer::LocalOrdinal>> > faceLIDMap_;
-   std::map< int, std::map<panzer::GlobalOrdinal, std::vector<panzer::GlobalOrdinal>> > faceGIDMap_;
+   // field ID -> nodal/edge/face global index -> local & global index of dof
+   std::map< int, EntityDofIndex > nodeDofIndex_;
+   std::map< int, EntityDofIndex > edgeDofIndex_;
+   std::map< int, EntityDofIndex > faceDofIndex_;
    
    // field ID -> volume global index -> local & global index of dof
 
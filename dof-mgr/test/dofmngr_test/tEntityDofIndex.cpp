@@ -0,0 +1,125 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+
+#include <Teuchos_ConfigDefs.hpp>
+#include <Teuchos_UnitTestHarness.hpp>
+#include <Teuchos_RCP.hpp>
+
+#include <vector>
+
+#include "Panzer_EntityDofIndex.hpp"
+
+namespace panzer {
+
+typedef EntityDofIndex::Record Record;
+
+TEUCHOS_UNIT_TEST(tEntityDofIndex, build_and_lookup)
+{
+  // two edges with two dofs each, edge 7 given twice (shared by two elements)
+  std::vector<Record> records;
+  records.push_back(Record{7, 0, 4, 40});
+  records.push_back(Record{7, 1, 5, 50});
+  records.push_back(Record{3, 0, 0, 10});
+  records.push_back(Record{3, 1, 1, 11});
+  records.push_back(Record{7, 1, 9, 90});
+  records.push_back(Record{7, 0, 8, 80});
+
+  EntityDofIndex index;
+  index.build(records);
+
+  TEST_EQUALITY(index.numEntities(),2);
+  TEST_EQUALITY(index.find(3),0);
+  TEST_EQUALITY(index.find(7),1);
+  TEST_EQUALITY(index.find(5),-1);
+  TEST_EQUALITY(index.getLID(7),4);
+  TEST_EQUALITY(index.getLID(5),-1);
+  TEST_EQUALITY(index.getGID(3),10);
+  TEST_THROW(index.getGID(5),std::out_of_range);
+
+  std::vector<panzer::LocalOrdinal> lids;
+  TEST_ASSERT(index.getLIDs(7,lids));
+  TEST_EQUALITY(lids.size(),2);
+  TEST_EQUALITY(lids[0],4);
+  TEST_EQUALITY(lids[1],5);
+
+  // batched, unsorted set
+  std::vector<std::size_t> set;
+  set.push_back(7);
+  set.push_back(3);
+  index.getLIDs(set,lids);
+  TEST_EQUALITY(lids.size(),4);
+  TEST_EQUALITY(lids[0],4);
+  TEST_EQUALITY(lids[1],5);
+  TEST_EQUALITY(lids[2],0);
+  TEST_EQUALITY(lids[3],1);
+
+  set.push_back(11);
+  TEST_THROW(index.getLIDs(set,lids),std::out_of_range);
+}
+
+TEUCHOS_UNIT_TEST(tEntityDofIndex, device_find)
+{
+  std::vector<Record> records;
+  for(int n=0;n<100;n++)
+    records.push_back(Record{2*n, 0, n, 2*n});
+
+  EntityDofIndex index;
+  index.build(records);
+
+  Kokkos::View<panzer::GlobalOrdinal*,PHX::Device> entities("entities",4);
+  Kokkos::View<panzer::LocalOrdinal*,PHX::Device> positions("positions",4);
+  auto entities_h = Kokkos::create_mirror_view(entities);
+  entities_h(0) = 0;  entities_h(1) = 198;  entities_h(2) = 51;  entities_h(3) = 100;
+  Kokkos::deep_copy(entities,entities_h);
+
+  index.find(entities,positions);
+
+  auto positions_h = Kokkos::create_mirror_view(positions);
+  Kokkos::deep_copy(positions_h,positions);
+  TEST_EQUALITY(positions_h(0),0);
+  TEST_EQUALITY(positions_h(1),99);
+  TEST_EQUALITY(positions_h(2),-1);
+  TEST_EQUALITY(positions_h(3),50);
+}
+
+}
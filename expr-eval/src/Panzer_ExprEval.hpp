@@ -224,6 +224,10 @@ struct RebindViewType<Kokkos::View<DT, VP ...>, NewScalarType> {
  *        - allocate space for "(a * b) + c"
  *        - compute and store "(a * b) + c"
  *        - deallocate space for "(a * b)"
+ *
+ * \note Expressions which are evaluated repeatedly (e.g. at every time step or
+ *       for every workset) should use Expr::Program instead, which parses once
+ *       and evaluates without intermediate allocations.
  */
 template <typename DT, typename ... VP>
 class Eval : public EvalBase {
@@ -0,0 +1,331 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#include <Panzer_ExprProgram.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+
+#include <Teuchos_MathExpr.hpp>
+
+namespace panzer
+{
+namespace Expr
+{
+
+namespace {
+
+/// Code for one subexpression, and whether its value is boolean
+struct Fragment {
+  std::vector<Instruction> code;
+  bool is_bool;
+};
+
+/**
+ * \brief Lowers the Teuchos::MathExpr grammar to Bytecode.
+ *
+ * Mirrors EvalBase::at_reduce, except each production emits instructions
+ * instead of computing values.
+ * Assignments are emitted as they are reduced, so that symbols assigned by
+ * earlier statements are visible as locals to later ones.
+ */
+class Compiler : public Teuchos::Reader {
+ public:
+  Compiler()
+    : Teuchos::Reader(Teuchos::MathExpr::ask_reader_tables()) {
+  }
+  Bytecode bytecode;
+ protected:
+  void at_shift(Teuchos::any& result_any, int token, std::string& text) override {
+    using std::swap;
+    switch (token) {
+      case Teuchos::MathExpr::TOK_NAME: {
+        std::string& result = Teuchos::make_any_ref<std::string>(result_any);
+        swap(result, text);
+        return;
+      }
+      case Teuchos::MathExpr::TOK_CONST: {
+        int const index = int(bytecode.constants.size());
+        bytecode.constants.push_back(std::atof(text.c_str()));
+        result_any = Fragment{{Instruction{OpCode::CONST, index}}, false};
+        return;
+      }
+    }
+  }
+  void at_reduce(Teuchos::any& result, int prod, std::vector<Teuchos::any>& rhs) override {
+    using std::swap;
+    switch (prod) {
+      case Teuchos::MathExpr::PROD_PROGRAM: {
+        TEUCHOS_TEST_FOR_EXCEPTION(rhs.at(1).empty(), Teuchos::ParserFail,
+            "Expression has no value to compute!");
+        Fragment& value = Teuchos::any_ref_cast<Fragment>(rhs.at(1));
+        TEUCHOS_TEST_FOR_EXCEPTION(value.is_bool, Teuchos::ParserFail,
+            "Expression has a boolean value, Expr::Program only computes scalars!");
+        bytecode.code.insert(bytecode.code.end(), value.code.begin(), value.code.end());
+        break;
+      }
+      case Teuchos::MathExpr::PROD_NO_STATEMENTS:
+      case Teuchos::MathExpr::PROD_NO_EXPR:
+      case Teuchos::MathExpr::PROD_NEXT_STATEMENT: {
+        break;
+      }
+      case Teuchos::MathExpr::PROD_ASSIGN: {
+        std::string const& name = Teuchos::any_ref_cast<std::string>(rhs.at(0));
+        Fragment& value = Teuchos::any_ref_cast<Fragment>(rhs.at(4));
+        auto it = locals.find(name);
+        if (it == locals.end()) {
+          TEUCHOS_TEST_FOR_EXCEPTION(bytecode.num_locals == Bytecode::max_locals, Teuchos::ParserFail,
+              "Too many assigned symbols, at most " << Bytecode::max_locals << " are supported");
+          it = locals.insert({name, {bytecode.num_locals++, value.is_bool}}).first;
+        }
+        it->second.second = value.is_bool;
+        bytecode.code.insert(bytecode.code.end(), value.code.begin(), value.code.end());
+        bytecode.code.push_back(Instruction{OpCode::LOCAL_STORE, it->second.first});
+        break;
+      }
+      case Teuchos::MathExpr::PROD_YES_EXPR:
+      case Teuchos::MathExpr::PROD_EXPR:
+      case Teuchos::MathExpr::PROD_TERNARY_DECAY:
+      case Teuchos::MathExpr::PROD_OR_DECAY:
+      case Teuchos::MathExpr::PROD_AND_DECAY:
+      case Teuchos::MathExpr::PROD_ADD_SUB_DECAY:
+      case Teuchos::MathExpr::PROD_MUL_DIV_DECAY:
+      case Teuchos::MathExpr::PROD_POW_DECAY:
+      case Teuchos::MathExpr::PROD_NEG_DECAY:
+      case Teuchos::MathExpr::PROD_SOME_ARGS:
+      case Teuchos::MathExpr::PROD_CONST:
+        swap(result, rhs.at(0));
+        break;
+      case Teuchos::MathExpr::PROD_BOOL_PARENS:
+      case Teuchos::MathExpr::PROD_VAL_PARENS:
+        swap(result, rhs.at(2));
+        break;
+      case Teuchos::MathExpr::PROD_TERNARY: {
+        Fragment& cond = Teuchos::any_ref_cast<Fragment>(rhs.at(0));
+        Fragment& left = Teuchos::any_ref_cast<Fragment>(rhs.at(3));
+        Fragment& right = Teuchos::any_ref_cast<Fragment>(rhs.at(6));
+        TEUCHOS_TEST_FOR_EXCEPTION(!cond.is_bool, Teuchos::ParserFail,
+            "Ternary condition is not of boolean type!");
+        TEUCHOS_TEST_FOR_EXCEPTION(left.is_bool || right.is_bool, Teuchos::ParserFail,
+            "Boolean values in ternary operator not yet supported");
+        Fragment& out = Teuchos::make_any_ref<Fragment>(result);
+        swap(out.code, cond.code);
+        out.code.insert(out.code.end(), left.code.begin(), left.code.end());
+        out.code.insert(out.code.end(), right.code.begin(), right.code.end());
+        out.code.push_back(Instruction{OpCode::TERNARY, 0});
+        out.is_bool = false;
+        break;
+      }
+      case Teuchos::MathExpr::PROD_OR:
+        this->binary_op(OpCode::OR, "||", result, rhs.at(0), rhs.at(3));
+        break;
+      case Teuchos::MathExpr::PROD_AND:
+        this->binary_op(OpCode::AND, "&&", result, rhs.at(0), rhs.at(3));
+        break;
+      case Teuchos::MathExpr::PROD_GT:
+        this->binary_op(OpCode::GT, ">", result, rhs.at(0), rhs.at(3));
+        break;
+      case Teuchos::MathExpr::PROD_LT:
+        this->binary_op(OpCode::LT, "<", result, rhs.at(0), rhs.at(3));
+        break;
+      case Teuchos::MathExpr::PROD_GEQ:
+        this->binary_op(OpCode::GEQ, ">=", result, rhs.at(0), rhs.at(3));
+        break;
+      case Teuchos::MathExpr::PROD_LEQ:
+        this->binary_op(OpCode::LEQ, "<=", result, rhs.at(0), rhs.at(3));
+        break;
+      case Teuchos::MathExpr::PROD_EQ:
+        this->binary_op(OpCode::EQ, "==", result, rhs.at(0), rhs.at(3));
+        break;
+      case Teuchos::MathExpr::PROD_ADD:
+        this->binary_op(OpCode::ADD, "+", result, rhs.at(0), rhs.at(3));
+        break;
+      case Teuchos::MathExpr::PROD_SUB:
+        this->binary_op(OpCode::SUB, "-", result, rhs.at(0), rhs.at(3));
+        break;
+      case Teuchos::MathExpr::PROD_MUL:
+        this->binary_op(OpCode::MUL, "*", result, rhs.at(0), rhs.at(3));
+        break;
+      case Teuchos::MathExpr::PROD_DIV:
+        this->binary_op(OpCode::DIV, "/", result, rhs.at(0), rhs.at(3));
+        break;
+      case Teuchos::MathExpr::PROD_POW:
+        this->binary_op(OpCode::POW, "^", result, rhs.at(0), rhs.at(3));
+        break;
+      case Teuchos::MathExpr::PROD_CALL: {
+        std::string const& name = Teuchos::any_ref_cast<std::string>(rhs.at(0));
+        static std::map<std::string, OpCode> const functions = {
+          {"abs", OpCode::ABS},
+          {"exp", OpCode::EXP},
+          {"log", OpCode::LOG},
+          {"sqrt", OpCode::SQRT},
+          {"sin", OpCode::SIN},
+          {"cos", OpCode::COS},
+          {"tan", OpCode::TAN},
+        };
+        auto function = functions.find(name);
+        TEUCHOS_TEST_FOR_EXCEPTION(function == functions.end(), Teuchos::ParserFail,
+            "symbol \"" << name << "\" being called doesn't exist!");
+        std::vector<Fragment>& args = Teuchos::any_ref_cast<std::vector<Fragment>>(rhs.at(4));
+        TEUCHOS_TEST_FOR_EXCEPTION(args.size() != 1, Teuchos::ParserFail,
+            "Function \"" << name << "\" takes one argument, " << args.size() << " given");
+        TEUCHOS_TEST_FOR_EXCEPTION(args[0].is_bool, Teuchos::ParserFail,
+            "Argument to \"" << name << "\" is boolean!");
+        Fragment& out = Teuchos::make_any_ref<Fragment>(result);
+        swap(out.code, args[0].code);
+        out.code.push_back(Instruction{function->second, 0});
+        out.is_bool = false;
+        break;
+      }
+      case Teuchos::MathExpr::PROD_NO_ARGS: {
+        result = std::vector<Fragment>{};
+        break;
+      }
+      case Teuchos::MathExpr::PROD_FIRST_ARG: {
+        std::vector<Fragment>& args = Teuchos::make_any_ref<std::vector<Fragment>>(result);
+        args.push_back(Teuchos::any_ref_cast<Fragment>(rhs.at(0)));
+        break;
+      }
+      case Teuchos::MathExpr::PROD_NEXT_ARG: {
+        swap(result, rhs.at(0));
+        std::vector<Fragment>& args = Teuchos::any_ref_cast<std::vector<Fragment>>(result);
+        args.push_back(Teuchos::any_ref_cast<Fragment>(rhs.at(3)));
+        break;
+      }
+      case Teuchos::MathExpr::PROD_NEG: {
+        swap(result, rhs.at(2));
+        Fragment& out = Teuchos::any_ref_cast<Fragment>(result);
+        TEUCHOS_TEST_FOR_EXCEPTION(out.is_bool, Teuchos::ParserFail,
+            "Can't negate a boolean");
+        out.code.push_back(Instruction{OpCode::NEG, 0});
+        break;
+      }
+      case Teuchos::MathExpr::PROD_VAR: {
+        std::string const& name = Teuchos::any_ref_cast<std::string>(rhs.at(0));
+        auto local = locals.find(name);
+        if (local != locals.end()) {
+          result = Fragment{{Instruction{OpCode::LOCAL_LOAD, local->second.first}}, local->second.second};
+          break;
+        }
+        auto& variables = bytecode.variables;
+        auto it = std::find(variables.begin(), variables.end(), name);
+        if (it == variables.end()) {
+          TEUCHOS_TEST_FOR_EXCEPTION(variables.size() == std::size_t(Bytecode::max_variables), Teuchos::ParserFail,
+              "Too many variables, at most " << Bytecode::max_variables << " are supported");
+          it = variables.insert(variables.end(), name);
+        }
+        result = Fragment{{Instruction{OpCode::LOAD, int(it - variables.begin())}}, false};
+        break;
+      }
+    }
+  }
+ private:
+  /// Assigned symbols: their local index and whether they are boolean
+  std::map<std::string, std::pair<int, bool>> locals;
+
+  void binary_op(OpCode code, const char* syntax, Teuchos::any& result, Teuchos::any& left_any, Teuchos::any& right_any) {
+    using std::swap;
+    Fragment& left = Teuchos::any_ref_cast<Fragment>(left_any);
+    Fragment& right = Teuchos::any_ref_cast<Fragment>(right_any);
+    bool expect_booleans = (code == OpCode::AND || code == OpCode::OR);
+    TEUCHOS_TEST_FOR_EXCEPTION(left.is_bool != expect_booleans, Teuchos::ParserFail,
+        "Left argument to '" << syntax << "' is " << (left.is_bool ? "" : "not") << " boolean!");
+    TEUCHOS_TEST_FOR_EXCEPTION(right.is_bool != expect_booleans, Teuchos::ParserFail,
+        "Right argument to '" << syntax << "' is " << (right.is_bool ? "" : "not") << " boolean!");
+    bool const result_is_bool = expect_booleans ||
+      code == OpCode::GT || code == OpCode::LT || code == OpCode::GEQ ||
+      code == OpCode::LEQ || code == OpCode::EQ;
+    Fragment& out = Teuchos::make_any_ref<Fragment>(result);
+    swap(out.code, left.code);
+    out.code.insert(out.code.end(), right.code.begin(), right.code.end());
+    out.code.push_back(Instruction{code, 0});
+    out.is_bool = result_is_bool;
+  }
+};
+
+/// The net change in stack depth caused by one instruction
+int stack_effect(OpCode code) {
+  switch (code) {
+    case OpCode::CONST:
+    case OpCode::LOAD:
+    case OpCode::LOCAL_LOAD:
+      return 1;
+    case OpCode::TERNARY:
+      return -2;
+    case OpCode::NEG:
+    case OpCode::ABS:
+    case OpCode::EXP:
+    case OpCode::LOG:
+    case OpCode::SQRT:
+    case OpCode::SIN:
+    case OpCode::COS:
+    case OpCode::TAN:
+      return 0;
+    default:
+      return -1;
+  }
+}
+
+}
+
+constexpr int Bytecode::max_stack;
+constexpr int Bytecode::max_locals;
+constexpr int Bytecode::max_variables;
+
+Bytecode compile(std::string const& expression, std::string const& name) {
+  Compiler compiler;
+  Teuchos::any result;
+  compiler.read_string(result, expression, name);
+  Bytecode& bytecode = compiler.bytecode;
+  int depth = 0;
+  for (auto const& instruction : bytecode.code) {
+    depth += stack_effect(instruction.op);
+    if (depth > bytecode.stack_size) bytecode.stack_size = depth;
+  }
+  TEUCHOS_TEST_FOR_EXCEPTION(bytecode.stack_size > Bytecode::max_stack, Teuchos::ParserFail,
+      "Expression \"" << name << "\" needs a stack of " << bytecode.stack_size
+      << ", at most " << Bytecode::max_stack << " is supported");
+  return bytecode;
+}
+
+}} // end namespace panzer::Expr
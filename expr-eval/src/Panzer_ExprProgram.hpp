@@ -0,0 +1,233 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#ifndef PANZER_EXPR_PROGRAM_HPP
+#define PANZER_EXPR_PROGRAM_HPP
+
+/** \file Panzer_ExprProgram.hpp
+ *  \brief Declares panzer::Expr::Program, a compile-once alternative to panzer::Expr::Eval
+ */
+
+#include <string>
+#include <vector>
+
+#include <Panzer_ExprEval.hpp>
+
+namespace panzer
+{
+namespace Expr
+{
+
+/**
+ * \brief The instruction set of a compiled Teuchos::MathExpr expression.
+ *
+ * Instructions operate on a small per-point stack.
+ * Boolean values live on the same stack as scalars, stored as zero or one.
+ */
+enum class OpCode : int {
+  CONST,       ///< push constants[arg]
+  LOAD,        ///< push the value of variable slot arg at the current point
+  LOCAL_LOAD,  ///< push local (assigned) symbol arg
+  LOCAL_STORE, ///< pop into local (assigned) symbol arg
+  OR,
+  AND,
+  GT,
+  LT,
+  GEQ,
+  LEQ,
+  EQ,
+  ADD,
+  SUB,
+  MUL,
+  DIV,
+  POW,
+  NEG,
+  TERNARY,     ///< pop right, left, cond; push (cond ? left : right)
+  ABS,
+  EXP,
+  LOG,
+  SQRT,
+  SIN,
+  COS,
+  TAN,
+};
+
+/// One bytecode instruction, trivially copyable to device memory
+struct Instruction {
+  OpCode op;
+  int arg;
+};
+
+/**
+ * \brief The result of compiling an expression: a flat postfix program.
+ *
+ * Variables referenced by the expression (and not assigned inside it) are
+ * given slots in order of first appearance, and are bound to values by
+ * Expr::Program::set.
+ */
+struct Bytecode {
+  /// Upper bound on the evaluation stack depth of a compiled expression
+  static constexpr int max_stack = 16;
+  /// Upper bound on the number of symbols assigned inside an expression
+  static constexpr int max_locals = 16;
+  /// Upper bound on the number of variables an expression may reference
+  static constexpr int max_variables = 16;
+
+  std::vector<Instruction> code;
+  std::vector<double> constants;
+  std::vector<std::string> variables;
+  int num_locals = 0;
+  int stack_size = 0;
+};
+
+/**
+ * \brief Parses (expression) once and lowers it to a Bytecode program.
+ *
+ * Supports the full Teuchos::MathExpr grammar, with calls restricted to the
+ * functions registered by set_cmath_functions (abs, exp, log, sqrt, sin, cos, tan).
+ * Type errors (e.g. a non-boolean ternary condition) are reported here as
+ * Teuchos::ParserFail, exactly once, rather than at every evaluation.
+ */
+Bytecode compile(std::string const& expression, std::string const& name = "expression");
+
+/**
+ * \brief The device-side interpreter for a Bytecode program.
+ *
+ * Holds everything needed to evaluate the program at one point, so that
+ * Expr::Program can launch it as a single fused parallel_for with no
+ * intermediate views.
+ */
+template <typename DT, typename ... VP>
+struct ProgramKernel {
+  using original_view_type = Kokkos::View<DT, VP ...>;
+  using scalar_type = typename original_view_type::non_const_value_type;
+  using const_view_type = Kokkos::View<typename RebindDataType<DT, scalar_type const>::type, VP ...>;
+  using execution_space = typename original_view_type::execution_space;
+  using memory_space = typename original_view_type::memory_space;
+  using size_type = typename execution_space::size_type;
+
+  Kokkos::View<Instruction const*, memory_space> code_;
+  Kokkos::View<double const*, memory_space> constants_;
+  int size_ = 0;
+  const_view_type fields_[Bytecode::max_variables];
+  scalar_type scalars_[Bytecode::max_variables];
+  bool is_field_[Bytecode::max_variables];
+  original_view_type result_;
+
+  template <typename ... Indices>
+  KOKKOS_INLINE_FUNCTION
+  scalar_type run(Indices ... indices) const;
+  KOKKOS_INLINE_FUNCTION
+  void operator()(size_type i) const { result_(i) = this->run(i); }
+  KOKKOS_INLINE_FUNCTION
+  void operator()(size_type i, size_type j) const { result_(i, j) = this->run(i, j); }
+};
+
+/**
+ * \brief A mathematical expression compiled once and evaluated many times.
+ *
+ * Where Expr::Eval re-parses its input on every read_string call and
+ * allocates a Kokkos::View for every intermediate result, Program parses
+ * the expression once in its constructor and lowers it to Bytecode.
+ * Each call to evaluate() is then a single parallel_for over all
+ * points (a Kokkos::MDRangePolicy over cells and points for rank-2 views),
+ * in which every point runs the whole program in registers.
+ *
+ * Variables are bound by name with set(), either to one value shared by all
+ * points (e.g. the current time) or to a view with one value per point
+ * (e.g. a coordinate), and may be re-bound between evaluations without
+ * recompiling.
+ *
+ * \note Like Expr::Eval this class supports rank-1 and rank-2 Kokkos::Views.
+ *       The scalar type only needs the native arithmetic and comparison
+ *       operators plus the cmath functions, so Sacado FAD types work as well
+ *       as double.
+ */
+template <typename DT, typename ... VP>
+class Program {
+ public:
+  /// The corresponding Kokkos::View type, using the same template arguments are were given to Program
+  using original_view_type = Kokkos::View<DT, VP ...>;
+  /// The data type, including dimension information
+  using view_data_type = DT;
+  /// The scalar type
+  using scalar_type = typename original_view_type::non_const_value_type;
+  /// One scalar for each evaluation point, read-only
+  using const_view_type = Kokkos::View<typename RebindDataType<view_data_type, scalar_type const>::type, VP ...>;
+
+  /// Compiles (expression); throws Teuchos::ParserFail if it is malformed
+  explicit Program(std::string const& expression, std::string const& name = "expression");
+  /// Uses an already compiled program
+  explicit Program(Bytecode const& bytecode);
+
+  /// The compiled program
+  Bytecode const& bytecode() const { return bytecode_; }
+  /// Whether the expression references the variable (name)
+  bool has(std::string const& name) const;
+  /**
+   *  \brief Assign a scalar value to a variable symbol
+   *
+   *  Names the expression does not reference are ignored, so that callers
+   *  can bind a fixed set of variables (e.g. x, y, z, t) to any expression.
+   */
+  void set(std::string const& name, scalar_type const& value);
+  /// Assign scalar values (one for each evaluation point) to a variable symbol
+  void set(std::string const& name, const_view_type const& value);
+  /**
+   *  \brief Evaluates the program at every point of (result).
+   *
+   *  All per-point variables must have the same extents as (result).
+   *  The launch is asynchronous, in the usual Kokkos sense.
+   */
+  void evaluate(original_view_type const& result) const;
+ private:
+  void upload();
+  int find(std::string const& name) const;
+
+  Bytecode bytecode_;
+  ProgramKernel<DT, VP ...> kernel_;
+  std::vector<bool> bound_;
+};
+
+}} // end namespace panzer::Expr
+
+#endif // PANZER_EXPR_PROGRAM_HPP
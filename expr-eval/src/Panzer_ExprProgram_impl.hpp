@@ -0,0 +1,267 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#ifndef PANZER_EXPR_PROGRAM_IMPL_HPP
+#define PANZER_EXPR_PROGRAM_IMPL_HPP
+
+#include <Panzer_ExprProgram.hpp>
+#include <Panzer_ExprEval_impl.hpp>
+
+#include <algorithm>
+
+namespace panzer
+{
+namespace Expr
+{
+
+template <typename DT, typename ... VP>
+template <typename ... Indices>
+KOKKOS_INLINE_FUNCTION
+typename ProgramKernel<DT, VP ...>::scalar_type
+ProgramKernel<DT, VP ...>::run(Indices ... indices) const {
+  scalar_type stack[Bytecode::max_stack];
+  scalar_type locals[Bytecode::max_locals];
+  int top = -1;
+  for (int pc = 0; pc < size_; ++pc) {
+    Instruction const instruction = code_(pc);
+    int const arg = instruction.arg;
+    switch (instruction.op) {
+      case OpCode::CONST:
+        stack[++top] = scalar_type(constants_(arg));
+        break;
+      case OpCode::LOAD:
+        if (is_field_[arg]) stack[++top] = fields_[arg](indices ...);
+        else stack[++top] = scalars_[arg];
+        break;
+      case OpCode::LOCAL_LOAD:
+        stack[++top] = locals[arg];
+        break;
+      case OpCode::LOCAL_STORE:
+        locals[arg] = stack[top--];
+        break;
+      case OpCode::OR:
+        stack[top - 1] = ScalarOr::apply(stack[top - 1] != 0.0, stack[top] != 0.0) ? 1.0 : 0.0;
+        --top;
+        break;
+      case OpCode::AND:
+        stack[top - 1] = ScalarAnd::apply(stack[top - 1] != 0.0, stack[top] != 0.0) ? 1.0 : 0.0;
+        --top;
+        break;
+      case OpCode::GT:
+        stack[top - 1] = ScalarGT::apply(stack[top - 1], stack[top]) ? 1.0 : 0.0;
+        --top;
+        break;
+      case OpCode::LT:
+        stack[top - 1] = ScalarLT::apply(stack[top - 1], stack[top]) ? 1.0 : 0.0;
+        --top;
+        break;
+      case OpCode::GEQ:
+        stack[top - 1] = ScalarGEQ::apply(stack[top - 1], stack[top]) ? 1.0 : 0.0;
+        --top;
+        break;
+      case OpCode::LEQ:
+        stack[top - 1] = ScalarLEQ::apply(stack[top - 1], stack[top]) ? 1.0 : 0.0;
+        --top;
+        break;
+      case OpCode::EQ:
+        stack[top - 1] = ScalarEQ::apply(stack[top - 1], stack[top]) ? 1.0 : 0.0;
+        --top;
+        break;
+      case OpCode::ADD:
+        stack[top - 1] = ScalarAdd::apply(stack[top - 1], stack[top]);
+        --top;
+        break;
+      case OpCode::SUB:
+        stack[top - 1] = ScalarSub::apply(stack[top - 1], stack[top]);
+        --top;
+        break;
+      case OpCode::MUL:
+        stack[top - 1] = ScalarMul::apply(stack[top - 1], stack[top]);
+        --top;
+        break;
+      case OpCode::DIV:
+        stack[top - 1] = ScalarDiv::apply(stack[top - 1], stack[top]);
+        --top;
+        break;
+      case OpCode::POW:
+        stack[top - 1] = ScalarPow::apply(stack[top - 1], stack[top]);
+        --top;
+        break;
+      case OpCode::NEG:
+        stack[top] = ScalarNeg::apply(stack[top]);
+        break;
+      case OpCode::TERNARY:
+        stack[top - 2] = ScalarTernary::apply(stack[top - 2] != 0.0, stack[top - 1], stack[top]);
+        top -= 2;
+        break;
+      case OpCode::ABS:
+        stack[top] = ScalarAbs::apply(stack[top]);
+        break;
+      case OpCode::EXP:
+        stack[top] = ScalarExp::apply(stack[top]);
+        break;
+      case OpCode::LOG:
+        stack[top] = ScalarLog::apply(stack[top]);
+        break;
+      case OpCode::SQRT:
+        stack[top] = ScalarSqrt::apply(stack[top]);
+        break;
+      case OpCode::SIN:
+        stack[top] = ScalarSin::apply(stack[top]);
+        break;
+      case OpCode::COS:
+        stack[top] = ScalarCos::apply(stack[top]);
+        break;
+      case OpCode::TAN:
+        stack[top] = ScalarTan::apply(stack[top]);
+        break;
+    }
+  }
+  return stack[0];
+}
+
+template <typename Kernel, size_t Rank = Kernel::original_view_type::rank>
+struct ProgramLaunch;
+
+template <typename Kernel>
+struct ProgramLaunch<Kernel, 1> {
+  static void apply(Kernel const& kernel) {
+    using execution_space = typename Kernel::execution_space;
+    auto extent_0 = kernel.result_.extent(0);
+    Kokkos::parallel_for("panzer::Expr::Program", Kokkos::RangePolicy<execution_space>(0, extent_0), kernel);
+  }
+};
+
+template <typename Kernel>
+struct ProgramLaunch<Kernel, 2> {
+  static void apply(Kernel const& kernel) {
+    using execution_space = typename Kernel::execution_space;
+    auto extent_0 = kernel.result_.extent(0);
+    auto extent_1 = kernel.result_.extent(1);
+    using policy_type = Kokkos::MDRangePolicy<execution_space, Kokkos::Rank<2>>;
+    Kokkos::parallel_for("panzer::Expr::Program", policy_type({0, 0}, {extent_0, extent_1}), kernel);
+  }
+};
+
+template <typename DT, typename ... VP>
+Program<DT, VP ...>::Program(std::string const& expression, std::string const& name)
+  : bytecode_(compile(expression, name)) {
+  this->upload();
+}
+
+template <typename DT, typename ... VP>
+Program<DT, VP ...>::Program(Bytecode const& bytecode)
+  : bytecode_(bytecode) {
+  this->upload();
+}
+
+template <typename DT, typename ... VP>
+void Program<DT, VP ...>::upload() {
+  static_assert(original_view_type::rank == 1 || original_view_type::rank == 2,
+      "panzer::Expr::Program supports rank-1 and rank-2 views");
+  using memory_space = typename original_view_type::memory_space;
+  Kokkos::View<Instruction*, memory_space> code("program code", bytecode_.code.size());
+  auto host_code = Kokkos::create_mirror_view(code);
+  for (std::size_t i = 0; i < bytecode_.code.size(); ++i) host_code(i) = bytecode_.code[i];
+  Kokkos::deep_copy(code, host_code);
+  Kokkos::View<double*, memory_space> constants("program constants", bytecode_.constants.size());
+  auto host_constants = Kokkos::create_mirror_view(constants);
+  for (std::size_t i = 0; i < bytecode_.constants.size(); ++i) host_constants(i) = bytecode_.constants[i];
+  Kokkos::deep_copy(constants, host_constants);
+  kernel_.code_ = code;
+  kernel_.constants_ = constants;
+  kernel_.size_ = int(bytecode_.code.size());
+  for (int i = 0; i < Bytecode::max_variables; ++i) kernel_.is_field_[i] = false;
+  bound_.assign(bytecode_.variables.size(), false);
+}
+
+template <typename DT, typename ... VP>
+int Program<DT, VP ...>::find(std::string const& name) const {
+  auto const& variables = bytecode_.variables;
+  auto it = std::find(variables.begin(), variables.end(), name);
+  return it == variables.end() ? -1 : int(it - variables.begin());
+}
+
+template <typename DT, typename ... VP>
+bool Program<DT, VP ...>::has(std::string const& name) const {
+  return this->find(name) != -1;
+}
+
+template <typename DT, typename ... VP>
+void Program<DT, VP ...>::set(std::string const& name, scalar_type const& value) {
+  int const slot = this->find(name);
+  if (slot == -1) return;
+  kernel_.scalars_[slot] = value;
+  kernel_.fields_[slot] = const_view_type();
+  kernel_.is_field_[slot] = false;
+  bound_[slot] = true;
+}
+
+template <typename DT, typename ... VP>
+void Program<DT, VP ...>::set(std::string const& name, const_view_type const& value) {
+  int const slot = this->find(name);
+  if (slot == -1) return;
+  kernel_.fields_[slot] = value;
+  kernel_.is_field_[slot] = true;
+  bound_[slot] = true;
+}
+
+template <typename DT, typename ... VP>
+void Program<DT, VP ...>::evaluate(original_view_type const& result) const {
+  for (std::size_t slot = 0; slot < bound_.size(); ++slot) {
+    TEUCHOS_TEST_FOR_EXCEPTION(!bound_[slot], std::logic_error,
+        "Program::evaluate: variable \"" << bytecode_.variables[slot] << "\" was never set");
+    if (!kernel_.is_field_[slot]) continue;
+    for (unsigned r = 0; r < original_view_type::rank; ++r) {
+      TEUCHOS_TEST_FOR_EXCEPTION(kernel_.fields_[slot].extent(r) != result.extent(r), std::logic_error,
+          "Program::evaluate: extent " << r << " of variable \"" << bytecode_.variables[slot]
+          << "\" is " << kernel_.fields_[slot].extent(r) << " but the result's is " << result.extent(r));
+    }
+  }
+  auto kernel = kernel_;
+  kernel.result_ = result;
+  ProgramLaunch<ProgramKernel<DT, VP ...>>::apply(kernel);
+}
+
+}} // end namespace panzer::Expr
+
+#endif // PANZER_EXPR_PROGRAM_IMPL_HPP
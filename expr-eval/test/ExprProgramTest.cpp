@@ -0,0 +1,169 @@
+// @HEADER
+// ***********************************************************************
+//
+//           Panzer: A partial differential equation assembly
+//       engine for strongly coupled complex multiphysics systems
+//                 Copyright (2011) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Roger P. Pawlowski (rppawlo@sandia.gov) and
+// Eric C. Cyr (eccyr@sandia.gov)
+// ***********************************************************************
+// @HEADER
+
+#include <Teuchos_UnitTestHarness.hpp>
+
+#include "Panzer_ExprEval_impl.hpp"
+#include "Panzer_ExprProgram_impl.hpp"
+
+#include <cmath>
+
+namespace panzer {
+
+namespace {
+
+using view_type = Kokkos::View<double**>;
+using const_view_type = Kokkos::View<double const**>;
+
+view_type fill(std::string const& name, int num_cells, int num_points, double offset) {
+  view_type x(name, num_cells, num_points);
+  Kokkos::parallel_for(name, Kokkos::MDRangePolicy<Kokkos::Rank<2>>({0, 0}, {num_cells, num_points}),
+      KOKKOS_LAMBDA(int cell, int point) {
+    x(cell, point) = offset + 0.001 * cell + 0.01 * point;
+  });
+  return x;
+}
+
+const_view_type eval_reference(std::string const& expr, view_type x, view_type y, double t) {
+  Expr::Eval<double**> eval;
+  Expr::set_cmath_functions(eval);
+  eval.set("x", x);
+  eval.set("y", y);
+  eval.set("t", t);
+  Teuchos::any result;
+  eval.read_string(result, expr, expr);
+  return Teuchos::any_cast<const_view_type>(result);
+}
+
+double max_difference(const_view_type a, const_view_type b) {
+  auto h_a = Kokkos::create_mirror_view(a);
+  auto h_b = Kokkos::create_mirror_view(b);
+  Kokkos::deep_copy(h_a, a);
+  Kokkos::deep_copy(h_b, b);
+  double diff = 0.0;
+  for (std::size_t i = 0; i < h_a.extent(0); ++i)
+    for (std::size_t j = 0; j < h_a.extent(1); ++j)
+      diff = std::max(diff, std::abs(h_a(i, j) - h_b(i, j)));
+  return diff;
+}
+
+}
+
+TEUCHOS_UNIT_TEST(ExprProgram, matches_eval)
+{
+  auto x = fill("x", 7, 5, 0.25);
+  auto y = fill("y", 7, 5, 1.5);
+  double const t = 0.75;
+  char const* const expressions[] = {
+    "x + y",
+    "2 * x - y / 4",
+    "-x + (-t)",
+    "x^2 + y^t",
+    "abs(y - 2) + sqrt(x) * exp(-t) - log(y)",
+    "sin(x) * cos(y) + tan(t)",
+    "x < 0.28 ? 0.0 : 1.0",
+    "(x > 0.26 && y < 1.52) || t == 0.75 ? x : y",
+    "r2 = x^2 + y^2;\nk = 1 + 0.5 * r2;\n-k * exp(-t * r2)",
+    "a = x; a = a * 2; a + 1",
+  };
+  view_type result("result", 7, 5);
+  for (auto expr : expressions) {
+    Expr::Program<double**> program(expr);
+    program.set("x", x);
+    program.set("y", y);
+    program.set("t", t);
+    program.evaluate(result);
+    auto reference = eval_reference(expr, x, y, t);
+    TEST_COMPARE(max_difference(result, reference), <=, 1.0e-14);
+  }
+}
+
+TEUCHOS_UNIT_TEST(ExprProgram, rebind_variables)
+{
+  Expr::Program<double*> program("a * y + b");
+  TEST_ASSERT(program.has("a"));
+  TEST_ASSERT(program.has("y"));
+  TEST_ASSERT(!program.has("z"));
+  TEST_EQUALITY(program.bytecode().variables.size(), std::size_t(3));
+  auto y = Kokkos::View<double*>("y", 3);
+  auto h_y = Kokkos::create_mirror_view(y);
+  h_y(0) = 1.0;
+  h_y(1) = 2.0;
+  h_y(2) = 3.0;
+  Kokkos::deep_copy(y, h_y);
+  auto z = Kokkos::View<double*>("z", 3);
+  auto h_z = Kokkos::create_mirror_view(z);
+  program.set("y", y);
+  program.set("z", 10.0);
+  program.set("a", 2.0);
+  TEST_THROW(program.evaluate(z), std::logic_error);
+  program.set("b", 1.0);
+  program.evaluate(z);
+  Kokkos::deep_copy(h_z, z);
+  TEST_EQUALITY(h_z(0), 3.0);
+  TEST_EQUALITY(h_z(1), 5.0);
+  TEST_EQUALITY(h_z(2), 7.0);
+  program.set("a", -1.0);
+  program.set("b", y);
+  program.evaluate(z);
+  Kokkos::deep_copy(h_z, z);
+  TEST_EQUALITY(h_z(0), 0.0);
+  TEST_EQUALITY(h_z(1), 0.0);
+  TEST_EQUALITY(h_z(2), 0.0);
+  program.set("y", Kokkos::View<double*>("short", 2));
+  TEST_THROW(program.evaluate(z), std::logic_error);
+}
+
+TEUCHOS_UNIT_TEST(ExprProgram, compile_errors)
+{
+  TEST_THROW(Expr::compile("x && y"), Teuchos::ParserFail);
+  TEST_THROW(Expr::compile("x > 1"), Teuchos::ParserFail);
+  TEST_THROW(Expr::compile("x ? 1 : 2"), Teuchos::ParserFail);
+  TEST_THROW(Expr::compile("-(x > 1)"), Teuchos::ParserFail);
+  TEST_THROW(Expr::compile("erf(x)"), Teuchos::ParserFail);
+  TEST_THROW(Expr::compile("a = 1;"), Teuchos::ParserFail);
+  auto bytecode = Expr::compile("x * (y + 1)");
+  TEST_EQUALITY(bytecode.code.size(), std::size_t(5));
+  TEST_EQUALITY(bytecode.stack_size, 3);
+}
+
+}